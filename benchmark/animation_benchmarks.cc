@@ -0,0 +1,1051 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+// Benchmarks ozz animation runtime jobs and archives.
+
+#include <string>
+
+#include "benchmark.h"
+#include "benchmark_data.h"
+#include "ozz/animation/offline/raw_track.h"
+#include "ozz/animation/offline/streaming_animation_builder.h"
+#include "ozz/animation/offline/track_builder.h"
+#include "ozz/animation/runtime/batch_sampling_job.h"
+#include "ozz/animation/runtime/blending_job.h"
+#include "ozz/animation/runtime/character_update_job.h"
+#include "ozz/animation/runtime/event_query_job.h"
+#include "ozz/animation/runtime/ik_aim_soa_job.h"
+#include "ozz/animation/runtime/ik_chain_job.h"
+#include "ozz/animation/runtime/ik_two_bone_soa_job.h"
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/animation/runtime/streaming_animation.h"
+#include "ozz/animation/runtime/track.h"
+#include "ozz/animation/runtime/track_event_index.h"
+#include "ozz/animation/runtime/track_sampling_job.h"
+#include "ozz/animation/runtime/track_triggering_job.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/simd_quaternion.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/scheduler.h"
+
+namespace ozz {
+namespace benchmark {
+namespace {
+
+// Synthetic data settings, close to a typical game character.
+const int kNumJoints = 80;
+const float kDuration = 10.f;
+const float kKeyFrequency = 15.f;
+
+// Sampling direction/pattern. Still mode samples the same ratio every
+// iteration, so no key needs to be decompressed, which measures interpolation
+// only.
+enum SamplingMode { kForward, kBackward, kRandom, kStill };
+
+// Runs a sampling job benchmark, advancing 1/60s per iteration.
+void RunSampling(State& _state, const animation::Animation& _animation,
+                 SamplingMode _mode) {
+  animation::SamplingJob::Context context(_animation.num_tracks());
+  ozz::vector<math::SoaTransform> output(_animation.num_soa_tracks());
+  animation::SamplingJob job;
+  job.animation = &_animation;
+  job.context = &context;
+  job.output = make_span(output);
+
+  const float step = 1.f / (60.f * _animation.duration());
+  Random random;
+  float ratio = _mode == kBackward ? 1.f : 0.f;
+  while (_state.KeepRunning()) {
+    switch (_mode) {
+      case kForward:
+        ratio += step;
+        ratio = ratio > 1.f ? 0.f : ratio;
+        break;
+      case kBackward:
+        ratio -= step;
+        ratio = ratio < 0.f ? 1.f : ratio;
+        break;
+      case kRandom:
+        ratio = random.Next();
+        break;
+      case kStill:
+        ratio = .5f;
+        break;
+    }
+    job.ratio = ratio;
+    if (!job.Run()) {
+      _state.set_error("SamplingJob failed");
+      return;
+    }
+  }
+  _state.set_items_per_iteration(_animation.num_tracks());
+}
+
+void RegisterSampling() {
+  static const struct {
+    const char* name;
+    SamplingMode mode;
+  } modes[] = {{"forward", kForward},
+               {"backward", kBackward},
+               {"random", kRandom},
+               {"still", kStill}};
+  static const struct {
+    const char* name;
+    float interval;
+  } iframes[] = {{"no_iframe", 0.f}, {"iframe", 1.f}};
+
+  for (const auto& mode : modes) {
+    for (const auto& iframe : iframes) {
+      const std::string name = std::string("SamplingJob/synthetic/") +
+                               mode.name + "/" + iframe.name;
+      const SamplingMode sampling_mode = mode.mode;
+      const float interval = iframe.interval;
+      Register(name.c_str(), [sampling_mode, interval](State& _state) {
+        const animation::offline::RawAnimation raw =
+            BuildRawAnimation(kNumJoints, kDuration, kKeyFrequency);
+        const unique_ptr<animation::Animation> animation =
+            BuildAnimation(raw, interval);
+        RunSampling(_state, *animation, sampling_mode);
+      });
+    }
+    const std::string name = std::string("SamplingJob/media/") + mode.name;
+    const SamplingMode sampling_mode = mode.mode;
+    Register(name.c_str(), [sampling_mode](State& _state) {
+      animation::Animation animation;
+      if (!LoadMedia("pab_walk.ozz", &animation)) {
+        _state.skip();
+        return;
+      }
+      RunSampling(_state, animation, sampling_mode);
+    });
+  }
+}
+OZZ_BENCHMARK_REGISTER(RegisterSampling);
+
+// Samples _num_instances instances of the same animation, advancing each
+// instance 1/60s per iteration, either with a single BatchSamplingJob or with
+// one SamplingJob (and context) per instance. Clustered instances are close
+// in time, like a crowd playing the same loop with small offsets, where
+// spread ones are randomly distributed over the whole animation.
+void RunBatchSampling(State& _state, const animation::Animation& _animation,
+                      int _num_instances, bool _clustered, bool _batch) {
+  Random random;
+  ozz::vector<float> ratios(_num_instances);
+  for (float& ratio : ratios) {
+    ratio = _clustered ? .5f + random.Next() * .05f : random.Next();
+  }
+  ozz::vector<ozz::vector<math::SoaTransform>> locals(_num_instances);
+  ozz::vector<span<math::SoaTransform>> outputs(_num_instances);
+  for (int i = 0; i < _num_instances; ++i) {
+    locals[i].resize(_animation.num_soa_tracks());
+    outputs[i] = make_span(locals[i]);
+  }
+
+  animation::BatchSamplingJob::Context batch_context(_animation.num_tracks(),
+                                                     _num_instances);
+  animation::BatchSamplingJob batch_job;
+  batch_job.animation = &_animation;
+  batch_job.context = &batch_context;
+  batch_job.ratios = make_span(ratios);
+  batch_job.outputs = make_span(outputs);
+
+  ozz::vector<unique_ptr<animation::SamplingJob::Context>> contexts;
+  if (!_batch) {
+    for (int i = 0; i < _num_instances; ++i) {
+      contexts.push_back(make_unique<animation::SamplingJob::Context>(
+          _animation.num_tracks()));
+    }
+  }
+
+  const float step = 1.f / (60.f * _animation.duration());
+  while (_state.KeepRunning()) {
+    for (float& ratio : ratios) {
+      ratio += step;
+      ratio = ratio > 1.f ? 0.f : ratio;
+    }
+    if (_batch) {
+      if (!batch_job.Run()) {
+        _state.set_error("BatchSamplingJob failed");
+        return;
+      }
+      continue;
+    }
+    for (int i = 0; i < _num_instances; ++i) {
+      animation::SamplingJob job;
+      job.animation = &_animation;
+      job.context = contexts[i].get();
+      job.ratio = ratios[i];
+      job.output = outputs[i];
+      if (!job.Run()) {
+        _state.set_error("SamplingJob failed");
+        return;
+      }
+    }
+  }
+  _state.set_items_per_iteration(_animation.num_tracks() * _num_instances);
+}
+
+void RegisterBatchSampling() {
+  static const int instances[] = {8, 64};
+  for (const int num_instances : instances) {
+    for (const bool clustered : {true, false}) {
+      for (const bool batch : {true, false}) {
+        const std::string name =
+            std::string("BatchSamplingJob/synthetic/") +
+            std::to_string(num_instances) + "_instances/" +
+            (clustered ? "clustered/" : "spread/") +
+            (batch ? "batch" : "independent");
+        Register(name.c_str(), [num_instances, clustered,
+                                batch](State& _state) {
+          const animation::offline::RawAnimation raw =
+              BuildRawAnimation(kNumJoints, kDuration, kKeyFrequency);
+          const unique_ptr<animation::Animation> animation =
+              BuildAnimation(raw, 0.f);
+          RunBatchSampling(_state, *animation, num_instances, clustered,
+                           batch);
+        });
+      }
+    }
+  }
+}
+OZZ_BENCHMARK_REGISTER(RegisterBatchSampling);
+
+// Samples a StreamingAnimation forward, advancing 1/60s per iteration. Chunks
+// are loaded from a memory stream when playback reaches them, and evicted
+// according to _max_resident_chunks budget. Compares with
+// SamplingJob/synthetic/forward/no_iframe, which samples the whole animation.
+void RunStreamingSampling(State& _state, int _max_resident_chunks) {
+  const animation::offline::RawAnimation raw =
+      BuildRawAnimation(kNumJoints, kDuration, kKeyFrequency);
+  animation::offline::StreamingAnimationBuilder builder;
+  const unique_ptr<animation::StreamingAnimation> built = builder(raw);
+  if (!built) {
+    _state.set_error("StreamingAnimationBuilder failed");
+    return;
+  }
+  io::MemoryStream stream;
+  {
+    io::OArchive archive(&stream);
+    archive << *built;
+  }
+  stream.Seek(0, io::Stream::kSet);
+  io::IArchive archive(&stream);
+  animation::StreamingAnimation animation;
+  archive >> animation;
+  animation.set_max_resident_chunks(_max_resident_chunks);
+
+  animation::SamplingJob::Context context(animation.num_tracks());
+  ozz::vector<math::SoaTransform> output(animation.num_soa_tracks());
+  animation::SamplingJob job;
+  job.context = &context;
+  job.output = make_span(output);
+
+  const float step = 1.f / (60.f * animation.duration());
+  float ratio = 0.f;
+  while (_state.KeepRunning()) {
+    ratio += step;
+    ratio = ratio > 1.f ? 0.f : ratio;
+    job.animation = animation.Acquire(ratio, &job.ratio);
+    if (!job.animation || !job.Run()) {
+      _state.set_error("StreamingAnimation sampling failed");
+      return;
+    }
+  }
+  _state.set_items_per_iteration(animation.num_tracks());
+}
+
+void RegisterStreaming() {
+  // Default budget, chunks are loaded again every loop.
+  Register("StreamingAnimation/synthetic/forward", [](State& _state) {
+    RunStreamingSampling(_state, 2);
+  });
+  // All chunks stay resident after the first loop, which measures chunk
+  // acquisition overhead only.
+  Register("StreamingAnimation/synthetic/forward_resident",
+           [](State& _state) { RunStreamingSampling(_state, 1 << 16); });
+}
+OZZ_BENCHMARK_REGISTER(RegisterStreaming);
+
+// Fills _transforms with random local transforms.
+void RandomTransforms(Random* _random, span<math::SoaTransform> _transforms) {
+  for (math::SoaTransform& transform : _transforms) {
+    const math::SimdFloat4 x = math::simd_float4::Load(
+        _random->Next(), _random->Next(), _random->Next(), _random->Next());
+    transform.translation = {x, x, x};
+    transform.rotation = math::SoaQuaternion::identity();
+    transform.scale = math::SoaFloat3::one();
+  }
+}
+
+void RegisterBlending() {
+  static const int layers[] = {1, 2, 4, 8};
+  for (const int num_layers : layers) {
+    // Partial layers weight half of the joints, sparse ones also list them.
+    // Arm layers only weight an eighth of the joints (after a first full
+    // layer), as upper body or arm layers usually do.
+    static const char* kModes[] = {"full", "partial", "sparse", "arm_partial",
+                                   "arm_sparse"};
+    for (int mode = 0; mode < 5; ++mode) {
+      const bool partial = mode != 0;
+      const bool sparse = mode == 2 || mode == 4;
+      const bool arm = mode >= 3;
+      const std::string name = std::string("BlendingJob/") +
+                               std::to_string(num_layers) + "_layers/" +
+                               kModes[mode];
+      Register(name.c_str(), [num_layers, partial, sparse, arm](State& _state) {
+        const unique_ptr<animation::Skeleton> skeleton =
+            BuildSkeleton(kNumJoints);
+        const int num_soa_joints = skeleton->num_soa_joints();
+
+        ozz::vector<math::SimdFloat4> joint_weights(num_soa_joints);
+        const int num_weighted = num_soa_joints / (arm ? 8 : 2);
+        for (int i = 0; i < num_soa_joints; ++i) {
+          joint_weights[i] = math::simd_float4::Load1(i < num_weighted);
+        }
+        ozz::vector<uint16_t> soa_joints(num_soa_joints);
+        size_t num_layer_soa_joints = 0;
+        animation::ExtractLayerSoaJoints(make_span(joint_weights),
+                                         make_span(soa_joints),
+                                         &num_layer_soa_joints);
+        const span<const uint16_t> layer_soa_joints =
+            make_span(soa_joints).first(num_layer_soa_joints);
+
+        Random random;
+        ozz::vector<ozz::vector<math::SoaTransform>> locals(num_layers);
+        ozz::vector<animation::BlendingJob::Layer> blend_layers(num_layers);
+        for (int i = 0; i < num_layers; ++i) {
+          locals[i].resize(num_soa_joints);
+          RandomTransforms(&random, make_span(locals[i]));
+          blend_layers[i].transform = make_span(locals[i]);
+          blend_layers[i].weight = 1.f / (i + 1);
+          if (partial && !(arm && i == 0)) {
+            blend_layers[i].joint_weights = make_span(joint_weights);
+            if (sparse) {
+              blend_layers[i].soa_joints = layer_soa_joints;
+            }
+          }
+        }
+        ozz::vector<math::SoaTransform> output(num_soa_joints);
+
+        animation::BlendingJob job;
+        job.layers = make_span(blend_layers);
+        job.rest_pose = skeleton->joint_rest_poses();
+        job.output = make_span(output);
+        while (_state.KeepRunning()) {
+          if (!job.Run()) {
+            _state.set_error("BlendingJob failed");
+            return;
+          }
+        }
+        _state.set_items_per_iteration(skeleton->num_joints() * num_layers);
+      });
+    }
+  }
+}
+OZZ_BENCHMARK_REGISTER(RegisterBlending);
+
+// Updates _num_characters characters, each sampling and blending 2 layers,
+// computing model-space matrices and optionally skinning matrices, with a
+// single CharacterUpdateJob.
+void RunCharacterUpdate(State& _state, int _num_characters, bool _skinning,
+                        Scheduler* _scheduler) {
+  const unique_ptr<animation::Skeleton> skeleton = BuildSkeleton(kNumJoints);
+  const animation::offline::RawAnimation raw =
+      BuildRawAnimation(kNumJoints, kDuration, kKeyFrequency);
+  const unique_ptr<animation::Animation> animation = BuildAnimation(raw, 0.f);
+  const int num_joints = skeleton->num_joints();
+  const int kNumLayers = 2;
+
+  ozz::vector<math::Float4x4> inverse_bind_poses(num_joints,
+                                                 math::Float4x4::identity());
+  ozz::vector<uint16_t> joint_remaps(num_joints);
+  for (int i = 0; i < num_joints; ++i) {
+    joint_remaps[i] = static_cast<uint16_t>(i);
+  }
+
+  // Every layer of every character has its own sampling context.
+  Random random;
+  ozz::vector<unique_ptr<animation::SamplingJob::Context>> contexts;
+  ozz::vector<animation::CharacterUpdateJob::Layer> layers(_num_characters *
+                                                           kNumLayers);
+  for (animation::CharacterUpdateJob::Layer& layer : layers) {
+    contexts.push_back(
+        make_unique<animation::SamplingJob::Context>(num_joints));
+    layer.animation = animation.get();
+    layer.context = contexts.back().get();
+    layer.ratio = random.Next();
+    layer.weight = .5f;
+  }
+  ozz::vector<math::Float4x4> models(_num_characters * num_joints);
+  ozz::vector<math::Float4x4> skinning_matrices(_num_characters * num_joints);
+  ozz::vector<animation::CharacterUpdateJob::Character> characters(
+      _num_characters);
+  for (int i = 0; i < _num_characters; ++i) {
+    animation::CharacterUpdateJob::Character& character = characters[i];
+    character.skeleton = skeleton.get();
+    character.layers = make_span(layers).subspan(i * kNumLayers, kNumLayers);
+    character.models = make_span(models).subspan(i * num_joints, num_joints);
+    if (_skinning) {
+      character.inverse_bind_poses = make_span(inverse_bind_poses);
+      character.joint_remaps = make_span(joint_remaps);
+      character.skinning_matrices =
+          make_span(skinning_matrices).subspan(i * num_joints, num_joints);
+    }
+  }
+
+  const int num_workers = _scheduler ? _scheduler->num_workers() : 1;
+  animation::CharacterUpdateJob::Context context(num_joints, kNumLayers,
+                                                 num_workers);
+  animation::CharacterUpdateJob job;
+  job.characters = make_span(characters);
+  job.scheduler = _scheduler;
+  job.context = &context;
+
+  const float step = 1.f / (60.f * animation->duration());
+  while (_state.KeepRunning()) {
+    for (animation::CharacterUpdateJob::Layer& layer : layers) {
+      layer.ratio += step;
+      layer.ratio = layer.ratio > 1.f ? 0.f : layer.ratio;
+    }
+    if (!job.Run()) {
+      _state.set_error("CharacterUpdateJob failed");
+      return;
+    }
+  }
+  _state.set_items_per_iteration(_num_characters);
+}
+
+void RegisterCharacterUpdate() {
+  static const int counts[] = {16, 128};
+  for (const int num_characters : counts) {
+    for (const bool skinning : {false, true}) {
+      const std::string name = std::string("CharacterUpdateJob/synthetic/") +
+                               std::to_string(num_characters) +
+                               "_characters/" +
+                               (skinning ? "skinning" : "models");
+      Register(name.c_str(), [num_characters, skinning](State& _state) {
+        RunCharacterUpdate(_state, num_characters, skinning, nullptr);
+      });
+    }
+  }
+
+  // Updates characters concurrently, on all hardware threads.
+  Register("CharacterUpdateJob/synthetic/128_characters/skinning/scheduler",
+           [](State& _state) {
+             ThreadPoolScheduler scheduler;
+             RunCharacterUpdate(_state, 128, true, &scheduler);
+           });
+}
+OZZ_BENCHMARK_REGISTER(RegisterCharacterUpdate);
+
+void RunLocalToModel(State& _state, const animation::Skeleton& _skeleton,
+                     int _from, int _to, bool _from_excluded,
+                     bool _affine = false, Scheduler* _scheduler = nullptr) {
+  Random random;
+  ozz::vector<math::SoaTransform> locals(_skeleton.num_soa_joints());
+  RandomTransforms(&random, make_span(locals));
+  ozz::vector<math::Float4x4> models(_skeleton.num_joints(),
+                                     math::Float4x4::identity());
+  ozz::vector<math::Float3x4> affines(_skeleton.num_joints());
+
+  animation::LocalToModelJob job;
+  job.skeleton = &_skeleton;
+  job.input = make_span(locals);
+  if (_affine) {
+    job.output_affine = make_span(affines);
+  } else {
+    job.output = make_span(models);
+  }
+  job.scheduler = _scheduler;
+  job.from = _from;
+  job.to = _to;
+  job.from_excluded = _from_excluded;
+  while (_state.KeepRunning()) {
+    if (!job.Run()) {
+      _state.set_error("LocalToModelJob failed");
+      return;
+    }
+  }
+  _state.set_items_per_iteration(_skeleton.num_joints());
+}
+
+void RegisterLocalToModel() {
+  using animation::Skeleton;
+  Register("LocalToModelJob/synthetic/full", [](State& _state) {
+    const unique_ptr<Skeleton> skeleton = BuildSkeleton(kNumJoints);
+    RunLocalToModel(_state, *skeleton, Skeleton::kNoParent,
+                    Skeleton::kMaxJoints, false);
+  });
+  Register("LocalToModelJob/synthetic/from", [](State& _state) {
+    const unique_ptr<Skeleton> skeleton = BuildSkeleton(kNumJoints);
+    RunLocalToModel(_state, *skeleton, 1, Skeleton::kMaxJoints, false);
+  });
+  Register("LocalToModelJob/synthetic/from_excluded", [](State& _state) {
+    const unique_ptr<Skeleton> skeleton = BuildSkeleton(kNumJoints);
+    RunLocalToModel(_state, *skeleton, 1, Skeleton::kMaxJoints, true);
+  });
+  Register("LocalToModelJob/synthetic/to", [](State& _state) {
+    const unique_ptr<Skeleton> skeleton = BuildSkeleton(kNumJoints);
+    RunLocalToModel(_state, *skeleton, Skeleton::kNoParent, kNumJoints / 2,
+                    false);
+  });
+  Register("LocalToModelJob/synthetic/affine", [](State& _state) {
+    const unique_ptr<Skeleton> skeleton = BuildSkeleton(kNumJoints);
+    RunLocalToModel(_state, *skeleton, Skeleton::kNoParent,
+                    Skeleton::kMaxJoints, false, true);
+  });
+  Register("LocalToModelJob/synthetic_100/depth_first", [](State& _state) {
+    const unique_ptr<Skeleton> skeleton = BuildSkeleton(100);
+    RunLocalToModel(_state, *skeleton, Skeleton::kNoParent,
+                    Skeleton::kMaxJoints, false);
+  });
+  Register("LocalToModelJob/synthetic_100/breadth_first", [](State& _state) {
+    const unique_ptr<Skeleton> skeleton = BuildSkeleton(100, true);
+    RunLocalToModel(_state, *skeleton, Skeleton::kNoParent,
+                    Skeleton::kMaxJoints, false);
+  });
+  Register("LocalToModelJob/synthetic_1000/breadth_first", [](State& _state) {
+    const unique_ptr<Skeleton> skeleton = BuildSkeleton(1000, true);
+    RunLocalToModel(_state, *skeleton, Skeleton::kNoParent,
+                    Skeleton::kMaxJoints, false);
+  });
+  Register("LocalToModelJob/synthetic_1000/full", [](State& _state) {
+    const unique_ptr<Skeleton> skeleton = BuildSkeleton(1000);
+    RunLocalToModel(_state, *skeleton, Skeleton::kNoParent,
+                    Skeleton::kMaxJoints, false);
+  });
+  Register("LocalToModelJob/synthetic_1000/scheduler", [](State& _state) {
+    const unique_ptr<Skeleton> skeleton = BuildSkeleton(1000);
+    ThreadPoolScheduler scheduler;
+    RunLocalToModel(_state, *skeleton, Skeleton::kNoParent,
+                    Skeleton::kMaxJoints, false, false, &scheduler);
+  });
+  Register("LocalToModelJob/media/full", [](State& _state) {
+    Skeleton skeleton;
+    if (!LoadMedia("pab_skeleton.ozz", &skeleton)) {
+      _state.skip();
+      return;
+    }
+    RunLocalToModel(_state, skeleton, Skeleton::kNoParent,
+                    Skeleton::kMaxJoints, false);
+  });
+}
+OZZ_BENCHMARK_REGISTER(RegisterLocalToModel);
+
+void RegisterIK() {
+  // Number of IK chains solved per iteration, aka characters feet.
+  const int kNumChains = 1024;
+
+  // Builds random model-space matrices, kNumChains times 3 joints.
+  auto build_joints = []() {
+    Random random;
+    ozz::vector<math::Float4x4> joints(kNumChains * 3);
+    for (int i = 0; i < kNumChains; ++i) {
+      const math::SimdFloat4 position = math::simd_float4::Load(
+          random.Next(-10.f, 10.f), random.Next(0.f, 1.f),
+          random.Next(-10.f, 10.f), 0.f);
+      const math::SimdFloat4 thigh =
+          math::simd_float4::Load(random.Next(), -.5f, 0.f, 0.f);
+      const math::SimdFloat4 shin =
+          math::simd_float4::Load(0.f, -.5f, .1f, 0.f);
+      joints[i * 3] = math::Float4x4::Translation(position);
+      joints[i * 3 + 1] = joints[i * 3] * math::Float4x4::Translation(thigh);
+      joints[i * 3 + 2] = joints[i * 3 + 1] * math::Float4x4::Translation(shin);
+    }
+    return joints;
+  };
+
+  for (int batch = 0; batch < 2; ++batch) {
+    const std::string two_bone_name =
+        std::string("IKTwoBoneJob/") + (batch ? "batch" : "scalar");
+    Register(two_bone_name.c_str(), [batch, build_joints](State& _state) {
+      const ozz::vector<math::Float4x4> joints = build_joints();
+      ozz::vector<math::SimdQuaternion> corrections(kNumChains * 2);
+      ozz::vector<animation::IKTwoBoneJob> chains(kNumChains);
+      for (int i = 0; i < kNumChains; ++i) {
+        animation::IKTwoBoneJob& chain = chains[i];
+        chain.start_joint = &joints[i * 3];
+        chain.mid_joint = &joints[i * 3 + 1];
+        chain.end_joint = &joints[i * 3 + 2];
+        chain.target = joints[i * 3 + 2].cols[3] +
+                       math::simd_float4::Load(0.f, .2f, .1f, 0.f);
+        chain.pole_vector = math::simd_float4::z_axis();
+        chain.start_joint_correction = &corrections[i * 2];
+        chain.mid_joint_correction = &corrections[i * 2 + 1];
+      }
+      animation::IKTwoBoneBatchJob batch_job;
+      batch_job.chains = make_span(chains);
+      while (_state.KeepRunning()) {
+        if (batch) {
+          if (!batch_job.Run()) {
+            _state.set_error("IKTwoBoneBatchJob failed");
+            return;
+          }
+        } else {
+          for (const animation::IKTwoBoneJob& chain : chains) {
+            if (!chain.Run()) {
+              _state.set_error("IKTwoBoneJob failed");
+              return;
+            }
+          }
+        }
+        Escape(corrections.data());
+      }
+      _state.set_items_per_iteration(kNumChains);
+    });
+
+    const std::string aim_name =
+        std::string("IKAimJob/") + (batch ? "batch" : "scalar");
+    Register(aim_name.c_str(), [batch, build_joints](State& _state) {
+      const ozz::vector<math::Float4x4> joints = build_joints();
+      ozz::vector<math::SimdQuaternion> corrections(kNumChains);
+      ozz::vector<animation::IKAimJob> aims(kNumChains);
+      for (int i = 0; i < kNumChains; ++i) {
+        animation::IKAimJob& aim = aims[i];
+        aim.joint = &joints[i * 3];
+        aim.target = joints[i * 3 + 2].cols[3] +
+                     math::simd_float4::Load(2.f, 1.f, .5f, 0.f);
+        aim.joint_correction = &corrections[i];
+      }
+      animation::IKAimBatchJob batch_job;
+      batch_job.joints = make_span(aims);
+      while (_state.KeepRunning()) {
+        if (batch) {
+          if (!batch_job.Run()) {
+            _state.set_error("IKAimBatchJob failed");
+            return;
+          }
+        } else {
+          for (const animation::IKAimJob& aim : aims) {
+            if (!aim.Run()) {
+              _state.set_error("IKAimJob failed");
+              return;
+            }
+          }
+        }
+        Escape(corrections.data());
+      }
+      _state.set_items_per_iteration(kNumChains);
+    });
+  }
+
+  // Multi-joint chains, aka spines or tails. Iterations and distance to target
+  // counters allow to compare solvers accuracy for a given cost.
+  const int kNumJointChains = 64;
+  const int kChainLengths[] = {4, 16};
+  const int kMaxIterations[] = {4, 16};
+  const char* kSolverNames[] = {"ccd", "fabrik"};
+  for (int solver = 0; solver < 2; ++solver) {
+    for (const int length : kChainLengths) {
+      for (const int max_iterations : kMaxIterations) {
+        const std::string name = std::string("IKChainJob/") +
+                                 kSolverNames[solver] + "/" +
+                                 std::to_string(length) + "_joints/" +
+                                 std::to_string(max_iterations) + "_iterations";
+        Register(name.c_str(), [solver, length, max_iterations](State& _state) {
+          // Builds kNumJointChains random chains, whose joints are all
+          // .1 apart. Targets are within reach.
+          Random random;
+          ozz::vector<math::Float4x4> models(kNumJointChains * length);
+          ozz::vector<math::SimdFloat4> targets(kNumJointChains);
+          for (int i = 0; i < kNumJointChains; ++i) {
+            math::Float4x4* chain = &models[i * length];
+            chain[0] = math::Float4x4::Translation(math::simd_float4::Load(
+                random.Next(-10.f, 10.f), 0.f, random.Next(-10.f, 10.f), 0.f));
+            for (int j = 1; j < length; ++j) {
+              const math::SimdFloat4 bone = math::simd_float4::Load(
+                  .1f, random.Next(-.05f, .05f), random.Next(-.05f, .05f), 0.f);
+              chain[j] = chain[j - 1] *
+                         math::Float4x4::Translation(math::NormalizeEst3(bone) *
+                                                     math::simd_float4::Load1(
+                                                         .1f));
+            }
+            const math::SimdFloat4 direction =
+                math::NormalizeEst3(math::simd_float4::Load(
+                    random.Next(-1.f, 1.f), random.Next(-1.f, 1.f),
+                    random.Next(-1.f, 1.f), 0.f));
+            const float reach = random.Next(.2f, .8f) * (length - 1) * .1f;
+            targets[i] = chain[0].cols[3] +
+                         direction * math::simd_float4::Load1(reach);
+          }
+          ozz::vector<int> chain(length);
+          for (int j = 0; j < length; ++j) {
+            chain[j] = j;
+          }
+          ozz::vector<math::SimdQuaternion> corrections(length);
+          int iterations = 0;
+          float distance = 0.f;
+          animation::IKChainJob job;
+          job.solver = static_cast<animation::IKChainJob::Solver>(solver);
+          job.max_iterations = max_iterations;
+          job.chain = make_span(chain);
+          job.joint_corrections = make_span(corrections);
+          job.iterations = &iterations;
+          job.distance = &distance;
+          int64_t total_iterations = 0;
+          double total_distance = 0.;
+          while (_state.KeepRunning()) {
+            total_iterations = 0;
+            total_distance = 0.;
+            for (int i = 0; i < kNumJointChains; ++i) {
+              job.models = make_span(models).subspan(i * length, length);
+              job.target = targets[i];
+              if (!job.Run()) {
+                _state.set_error("IKChainJob failed");
+                return;
+              }
+              total_iterations += iterations;
+              total_distance += distance;
+            }
+            Escape(corrections.data());
+          }
+          _state.set_items_per_iteration(kNumJointChains);
+          _state.set_counter("iterations",
+                             static_cast<double>(total_iterations) /
+                                 kNumJointChains);
+          _state.set_counter("distance", total_distance / kNumJointChains);
+        });
+      }
+    }
+  }
+}
+OZZ_BENCHMARK_REGISTER(RegisterIK);
+
+void RegisterTracks() {
+  // Builds a float track with _num_keys random keys.
+  auto build_float_track = [](int _num_keys) {
+    Random random;
+    animation::offline::RawFloatTrack raw_track;
+    for (int i = 0; i < _num_keys; ++i) {
+      raw_track.keyframes.push_back(
+          {animation::offline::RawTrackInterpolation::kLinear,
+           static_cast<float>(i) / (_num_keys - 1), random.Next(-1.f, 1.f)});
+    }
+    animation::offline::TrackBuilder builder;
+    return builder(raw_track);
+  };
+
+  Register("TrackSamplingJob/float/random", [build_float_track](State& _state) {
+    const unique_ptr<animation::FloatTrack> track = build_float_track(256);
+    float result;
+    animation::FloatTrackSamplingJob job;
+    job.track = track.get();
+    job.result = &result;
+    Random random;
+    while (_state.KeepRunning()) {
+      job.ratio = random.Next();
+      if (!job.Run()) {
+        _state.set_error("FloatTrackSamplingJob failed");
+        return;
+      }
+    }
+    DoNotOptimize(result);
+    _state.set_items_per_iteration(1);
+  });
+
+  // Forward playback, with and without a context caching keys.
+  for (int context = 0; context < 2; ++context) {
+    const std::string name = std::string("TrackSamplingJob/float/forward") +
+                             (context ? "_context" : "");
+    Register(name.c_str(), [build_float_track, context](State& _state) {
+      const unique_ptr<animation::FloatTrack> track = build_float_track(256);
+      animation::TrackSamplingContext sampling_context;
+      float result;
+      animation::FloatTrackSamplingJob job;
+      job.track = track.get();
+      job.context = context ? &sampling_context : nullptr;
+      job.result = &result;
+      float ratio = 0.f;
+      while (_state.KeepRunning()) {
+        ratio += 1.f / 1024.f;
+        job.ratio = ratio - static_cast<int>(ratio);
+        if (!job.Run()) {
+          _state.set_error("FloatTrackSamplingJob failed");
+          return;
+        }
+        DoNotOptimize(result);
+      }
+      _state.set_items_per_iteration(1);
+    });
+  }
+
+  // Many user-channel tracks (kNumTracks), sampled forward one by one, or all
+  // at once with a batch job.
+  const int kNumTracks = 64;
+  for (int batch = 0; batch < 2; ++batch) {
+    const std::string name = std::string("TrackBatchSamplingJob/float/") +
+                             (batch ? "batch" : "scalar");
+    Register(name.c_str(), [build_float_track, batch](State& _state) {
+      ozz::vector<unique_ptr<animation::FloatTrack>> tracks;
+      ozz::vector<const animation::FloatTrack*> track_ptrs;
+      for (int i = 0; i < kNumTracks; ++i) {
+        tracks.push_back(build_float_track(32));
+        track_ptrs.push_back(tracks.back().get());
+      }
+      ozz::vector<animation::TrackSamplingContext> contexts(kNumTracks);
+      ozz::vector<float> ratios(kNumTracks);
+      ozz::vector<math::SimdFloat4> results((kNumTracks + 3) / 4);
+      animation::FloatTrackBatchSamplingJob batch_job;
+      batch_job.tracks = make_span(track_ptrs);
+      batch_job.ratios = make_span(ratios);
+      batch_job.contexts = make_span(contexts);
+      batch_job.results = make_span(results);
+      float time = 0.f;
+      while (_state.KeepRunning()) {
+        time += 1.f / 1024.f;
+        for (int i = 0; i < kNumTracks; ++i) {
+          const float ratio = time + i / static_cast<float>(kNumTracks);
+          ratios[i] = ratio - static_cast<int>(ratio);
+        }
+        if (batch) {
+          if (!batch_job.Run()) {
+            _state.set_error("FloatTrackBatchSamplingJob failed");
+            return;
+          }
+        } else {
+          float* scalar_results = reinterpret_cast<float*>(results.data());
+          for (int i = 0; i < kNumTracks; ++i) {
+            animation::FloatTrackSamplingJob job;
+            job.track = track_ptrs[i];
+            job.ratio = ratios[i];
+            job.result = &scalar_results[i];
+            if (!job.Run()) {
+              _state.set_error("FloatTrackSamplingJob failed");
+              return;
+            }
+          }
+        }
+        Escape(results.data());
+      }
+      _state.set_items_per_iteration(kNumTracks);
+    });
+  }
+
+  Register("TrackSamplingJob/quaternion/random", [](State& _state) {
+    Random random;
+    animation::offline::RawQuaternionTrack raw_track;
+    for (int i = 0; i < 256; ++i) {
+      raw_track.keyframes.push_back(
+          {animation::offline::RawTrackInterpolation::kLinear, i / 255.f,
+           math::Quaternion::FromAxisAngle(math::Float3::y_axis(),
+                                           random.Next(-1.f, 1.f))});
+    }
+    animation::offline::TrackBuilder builder;
+    const unique_ptr<animation::QuaternionTrack> track = builder(raw_track);
+    math::Quaternion result;
+    animation::QuaternionTrackSamplingJob job;
+    job.track = track.get();
+    job.result = &result;
+    while (_state.KeepRunning()) {
+      job.ratio = random.Next();
+      if (!job.Run()) {
+        _state.set_error("QuaternionTrackSamplingJob failed");
+        return;
+      }
+    }
+    DoNotOptimize(result);
+    _state.set_items_per_iteration(1);
+  });
+
+  Register("TrackTriggeringJob/float/full", [build_float_track](State& _state) {
+    const unique_ptr<animation::FloatTrack> track = build_float_track(256);
+    animation::TrackTriggeringJob::Iterator iterator;
+    animation::TrackTriggeringJob job;
+    job.track = track.get();
+    job.from = 0.f;
+    job.to = 1.f;
+    job.iterator = &iterator;
+    int edges = 0;
+    while (_state.KeepRunning()) {
+      if (!job.Run()) {
+        _state.set_error("TrackTriggeringJob failed");
+        return;
+      }
+      for (; iterator != job.end(); ++iterator) {
+        ++edges;
+      }
+    }
+    DoNotOptimize(edges);
+    _state.set_items_per_iteration(256);
+  });
+
+  // Many instances (kNumInstances) playing a set of event tracks
+  // (kNumEventTracks), querying events of the last frame, either with
+  // TrackTriggeringJob or from a precomputed TrackEventIndex.
+  const int kNumInstances = 1024;
+  const int kNumEventTracks = 16;
+  auto build_raw_event_tracks = []() {
+    Random random;
+    ozz::vector<animation::offline::RawFloatTrack> raw_tracks(
+        kNumEventTracks);
+    for (animation::offline::RawFloatTrack& raw_track : raw_tracks) {
+      for (int i = 0; i < 64; ++i) {
+        raw_track.keyframes.push_back(
+            {animation::offline::RawTrackInterpolation::kStep, i / 64.f,
+             static_cast<float>(i & 1)});
+      }
+    }
+    return raw_tracks;
+  };
+  for (int indexed = 0; indexed < 2; ++indexed) {
+    const std::string name =
+        indexed ? "EventQueryJob/float/instances"
+                : "TrackTriggeringJob/float/instances";
+    Register(name.c_str(), [build_raw_event_tracks, indexed](State& _state) {
+      const ozz::vector<animation::offline::RawFloatTrack> raw_tracks =
+          build_raw_event_tracks();
+      animation::offline::TrackBuilder builder;
+      ozz::vector<unique_ptr<animation::FloatTrack>> tracks;
+      for (const animation::offline::RawFloatTrack& raw_track : raw_tracks) {
+        tracks.push_back(builder(raw_track));
+      }
+      const unique_ptr<animation::TrackEventIndex> index =
+          builder(make_span(raw_tracks), .5f);
+
+      // Instances start at random ratios, and advance 1/60 per frame.
+      Random random;
+      ozz::vector<animation::EventQueryJob::Query> queries(kNumInstances);
+      for (int i = 0; i < kNumInstances; ++i) {
+        const float from = random.Next();
+        queries[i] = {i % kNumEventTracks, from, from + 1.f / 60.f};
+      }
+      ozz::vector<animation::EventQueryJob::Event> events(kNumInstances * 4);
+      size_t num_events = 0;
+      animation::EventQueryJob query_job;
+      query_job.index = index.get();
+      query_job.queries = make_span(queries);
+      query_job.events = make_span(events);
+      query_job.num_events = &num_events;
+      while (_state.KeepRunning()) {
+        if (indexed) {
+          if (!query_job.Run()) {
+            _state.set_error("EventQueryJob failed");
+            return;
+          }
+        } else {
+          num_events = 0;
+          for (const animation::EventQueryJob::Query& query : queries) {
+            animation::TrackTriggeringJob::Iterator iterator;
+            animation::TrackTriggeringJob job;
+            job.track = tracks[query.track].get();
+            job.threshold = .5f;
+            job.from = query.from;
+            job.to = query.to;
+            job.iterator = &iterator;
+            if (!job.Run()) {
+              _state.set_error("TrackTriggeringJob failed");
+              return;
+            }
+            for (; iterator != job.end(); ++iterator) {
+              events[num_events++] = {iterator->ratio, iterator->rising, 0};
+            }
+          }
+        }
+        DoNotOptimize(num_events);
+        Escape(events.data());
+      }
+      _state.set_items_per_iteration(kNumInstances);
+    });
+  }
+}
+OZZ_BENCHMARK_REGISTER(RegisterTracks);
+
+// Measures loading of an object of type _Ty from a memory stream.
+template <typename _Ty>
+void RunLoad(State& _state, const _Ty& _object) {
+  io::MemoryStream stream;
+  {
+    io::OArchive archive(&stream);
+    archive << _object;
+  }
+  while (_state.KeepRunning()) {
+    stream.Seek(0, io::Stream::kSet);
+    io::IArchive archive(&stream);
+    _Ty object;
+    archive >> object;
+  }
+  _state.set_items_per_iteration(stream.Size());
+}
+
+void RegisterArchives() {
+  Register("Archive/synthetic/skeleton", [](State& _state) {
+    const unique_ptr<animation::Skeleton> skeleton = BuildSkeleton(kNumJoints);
+    RunLoad(_state, *skeleton);
+  });
+  Register("Archive/synthetic/animation", [](State& _state) {
+    const animation::offline::RawAnimation raw =
+        BuildRawAnimation(kNumJoints, kDuration, kKeyFrequency);
+    const unique_ptr<animation::Animation> animation = BuildAnimation(raw, 1.f);
+    RunLoad(_state, *animation);
+  });
+  Register("Image/synthetic/animation", [](State& _state) {
+    // Measures mapping an animation image in place, to compare with
+    // Archive/synthetic/animation loading.
+    const animation::offline::RawAnimation raw =
+        BuildRawAnimation(kNumJoints, kDuration, kKeyFrequency);
+    const unique_ptr<animation::Animation> built = BuildAnimation(raw, 1.f);
+    io::MemoryStream stream;
+    if (!built->SaveImage(stream)) {
+      _state.set_error("Failed to save animation image");
+      return;
+    }
+    ozz::vector<byte> image(stream.Size());
+    stream.Seek(0, io::Stream::kSet);
+    stream.Read(image.data(), image.size());
+    while (_state.KeepRunning()) {
+      animation::Animation animation;
+      if (!animation.MapImage(make_span(image))) {
+        _state.set_error("Failed to map animation image");
+        return;
+      }
+      DoNotOptimize(animation);
+    }
+    _state.set_items_per_iteration(image.size());
+  });
+  Register("Archive/media/animation_file", [](State& _state) {
+    // Measures loading from file, including file system access.
+    animation::Animation animation;
+    if (!LoadMedia("pab_walk.ozz", &animation)) {
+      _state.skip();
+      return;
+    }
+    while (_state.KeepRunning()) {
+      if (!LoadMedia("pab_walk.ozz", &animation)) {
+        _state.set_error("Failed to load animation");
+        return;
+      }
+    }
+    _state.set_items_per_iteration(animation.size());
+  });
+}
+OZZ_BENCHMARK_REGISTER(RegisterArchives);
+}  // namespace
+}  // namespace benchmark
+}  // namespace ozz
@@ -0,0 +1,233 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "benchmark.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ozz/base/log.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/options/options.h"
+
+OZZ_OPTIONS_DECLARE_STRING(filter,
+                           "Runs only benchmarks whose name contains this "
+                           "string.",
+                           "", false)
+
+OZZ_OPTIONS_DECLARE_FLOAT(min_time,
+                          "Minimum measurement time per benchmark, in seconds. "
+                          "0 runs a single iteration.",
+                          .5f, false)
+
+OZZ_OPTIONS_DECLARE_STRING(json,
+                           "Path of the json file results are written to. "
+                           "Nothing is written if empty.",
+                           "", false)
+
+OZZ_OPTIONS_DECLARE_STRING(media, "Path to ozz media/bin directory.",
+                           "media/bin", false)
+
+namespace ozz {
+namespace benchmark {
+
+namespace {
+struct Entry {
+  std::string name;
+  Function function;
+};
+
+// Registry uses std containers, as benchmarks are registered during static
+// initialization, possibly before ozz default allocator.
+std::vector<Entry>& Registry() {
+  static std::vector<Entry> registry;
+  return registry;
+}
+
+struct Result {
+  std::string name;
+  int64_t iterations;
+  double time;            // Nanoseconds per iteration.
+  double items_per_second;
+  std::string error;
+  std::vector<std::pair<std::string, double>> counters;
+};
+
+// Escapes json string special characters.
+std::string JsonEscape(const std::string& _string) {
+  std::string escaped;
+  for (const char c : _string) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+// Writes _value with _format, or null if it isn't finite, as json doesn't
+// support nan nor inf.
+void WriteJsonNumber(FILE* _file, const char* _format, double _value) {
+  if (std::isfinite(_value)) {
+    std::fprintf(_file, _format, _value);
+  } else {
+    std::fputs("null", _file);
+  }
+}
+
+bool WriteJson(const char* _path, const std::vector<Result>& _results) {
+  FILE* file = std::fopen(_path, "w");
+  if (!file) {
+    return false;
+  }
+  std::fprintf(file, "{\n  \"context\": {\n");
+  std::fprintf(file, "    \"simd\": \"%s\",\n",
+               ozz::math::SimdImplementationName());
+  std::fprintf(file, "    \"min_time\": %g\n  },\n",
+               static_cast<float>(OPTIONS_min_time));
+  std::fprintf(file, "  \"benchmarks\": [");
+  for (size_t i = 0; i < _results.size(); ++i) {
+    const Result& result = _results[i];
+    std::fprintf(file, "%s\n    {\n", i == 0 ? "" : ",");
+    std::fprintf(file, "      \"name\": \"%s\",\n",
+                 JsonEscape(result.name).c_str());
+    if (!result.error.empty()) {
+      std::fprintf(file, "      \"error\": \"%s\"\n    }",
+                   JsonEscape(result.error).c_str());
+      continue;
+    }
+    std::fprintf(file, "      \"iterations\": %lld,\n",
+                 static_cast<long long>(result.iterations));
+    std::fprintf(file, "      \"time_ns\": ");
+    WriteJsonNumber(file, "%.3f", result.time);
+    std::fprintf(file, ",\n");
+    if (!result.counters.empty()) {
+      std::fprintf(file, "      \"counters\": {");
+      for (size_t j = 0; j < result.counters.size(); ++j) {
+        std::fprintf(file, "%s\"%s\": ", j == 0 ? "" : ", ",
+                     JsonEscape(result.counters[j].first).c_str());
+        WriteJsonNumber(file, "%g", result.counters[j].second);
+      }
+      std::fprintf(file, "},\n");
+    }
+    std::fprintf(file, "      \"items_per_second\": ");
+    WriteJsonNumber(file, "%.1f", result.items_per_second);
+    std::fprintf(file, "\n    }");
+  }
+  std::fprintf(file, "\n  ]\n}\n");
+  return std::fclose(file) == 0;
+}
+}  // namespace
+
+void Register(const char* _name, Function _function) {
+  Registry().push_back({_name, std::move(_function)});
+}
+
+const char* media_directory() { return OPTIONS_media; }
+
+#if defined(_MSC_VER) && !defined(__clang__)
+const void* volatile escape_sink = nullptr;
+#endif  // _MSC_VER
+
+}  // namespace benchmark
+}  // namespace ozz
+
+int main(int _argc, const char** _argv) {
+  const ozz::options::ParseResult parse_result = ozz::options::ParseCommandLine(
+      _argc, _argv, "1.0",
+      "Runs ozz runtime jobs benchmarks, and optionally outputs results to a "
+      "json file for regression comparison.");
+  if (parse_result != ozz::options::kSuccess) {
+    return parse_result == ozz::options::kExitSuccess ? EXIT_SUCCESS
+                                                      : EXIT_FAILURE;
+  }
+
+  using ozz::benchmark::Entry;
+  using ozz::benchmark::Result;
+  using ozz::benchmark::State;
+
+  const char* filter = OPTIONS_filter;
+  std::vector<Result> results;
+  bool success = true;
+  ozz::log::Out() << "Benchmark, iterations, time (ns), items/s" << std::endl;
+  for (const Entry& entry : ozz::benchmark::Registry()) {
+    if (*filter && !std::strstr(entry.name.c_str(), filter)) {
+      continue;
+    }
+    State state(OPTIONS_min_time);
+    entry.function(state);
+    if (state.skipped()) {
+      ozz::log::Out() << entry.name << ", skipped" << std::endl;
+      continue;
+    }
+
+    Result result = {entry.name, state.iterations(), 0., 0.,
+                     state.error().c_str(), {}};
+    for (const State::Counter& counter : state.counters()) {
+      result.counters.emplace_back(counter.name.c_str(), counter.value);
+    }
+    if (result.error.empty() && state.iterations() == 0) {
+      result.error = "No iteration";
+    }
+    if (!result.error.empty()) {
+      ozz::log::Err() << entry.name << ": " << result.error << std::endl;
+      success = false;
+    } else {
+      const double elapsed = state.elapsed();
+      result.time = elapsed * 1e9 / result.iterations;
+      result.items_per_second =
+          elapsed > 0. ? state.items_per_iteration() * result.iterations /
+                             elapsed
+                       : 0.;
+      char line[256];
+      std::snprintf(line, sizeof(line), "%s, %lld, %.1f, %.4g",
+                    entry.name.c_str(),
+                    static_cast<long long>(result.iterations), result.time,
+                    result.items_per_second);
+      ozz::log::Out() << line;
+      for (const auto& counter : result.counters) {
+        ozz::log::Out() << ", " << counter.first << "=" << counter.second;
+      }
+      ozz::log::Out() << std::endl;
+    }
+    results.push_back(result);
+  }
+
+  const char* json = OPTIONS_json;
+  if (*json && !ozz::benchmark::WriteJson(json, results)) {
+    ozz::log::Err() << "Failed to write json file \"" << json << "\"."
+                    << std::endl;
+    success = false;
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,164 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_BENCHMARK_BENCHMARK_H_
+#define OZZ_BENCHMARK_BENCHMARK_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif  // _MSC_VER
+
+#include "ozz/base/containers/string.h"
+#include "ozz/base/containers/vector.h"
+
+namespace ozz {
+namespace benchmark {
+
+// Benchmark state, used by benchmark functions to run their measurement loop:
+// void MyBenchmark(State& _state) {
+//   // Setup, not measured.
+//   while (_state.KeepRunning()) {
+//     // Measured code.
+//   }
+//   _state.set_items_per_iteration(...);
+// }
+class State {
+ public:
+  explicit State(double _min_time) : min_time_(_min_time) {}
+
+  // Returns true while the measured loop should continue. Timer starts on the
+  // first call, and clock is sampled with an increasing period to keep its
+  // overhead low.
+  bool KeepRunning() {
+    if (iterations_ == 0) {
+      start_ = std::chrono::steady_clock::now();
+    } else if (iterations_ >= next_check_) {
+      const std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start_;
+      if (elapsed.count() >= min_time_) {
+        elapsed_ = elapsed.count();
+        return false;
+      }
+      next_check_ = iterations_ * 2;
+    }
+    ++iterations_;
+    return true;
+  }
+
+  // Number of items (joints, vertices, keys...) processed per iteration, used
+  // to compute throughput.
+  void set_items_per_iteration(int64_t _items) { items_ = _items; }
+
+  // Reports a named value alongside timings, like an accuracy or an average
+  // number of solver iterations. Setting an existing counter overwrites it.
+  void set_counter(const char* _name, double _value) {
+    for (Counter& counter : counters_) {
+      if (counter.name == _name) {
+        counter.value = _value;
+        return;
+      }
+    }
+    counters_.push_back({_name, _value});
+  }
+
+  // Reports an error, the benchmark is then considered as failed.
+  void set_error(const char* _error) { error_ = _error; }
+
+  // Skips the benchmark, for example when optional data isn't available.
+  void skip() { skipped_ = true; }
+
+  int64_t iterations() const { return iterations_; }
+  int64_t items_per_iteration() const { return items_; }
+  double elapsed() const { return elapsed_; }
+  const ozz::string& error() const { return error_; }
+  bool skipped() const { return skipped_; }
+
+  struct Counter {
+    ozz::string name;
+    double value;
+  };
+  const ozz::vector<Counter>& counters() const { return counters_; }
+
+ private:
+  double min_time_;
+  std::chrono::steady_clock::time_point start_;
+  int64_t iterations_ = 0;
+  int64_t next_check_ = 1;
+  int64_t items_ = 0;
+  double elapsed_ = 0.;
+  ozz::string error_;
+  bool skipped_ = false;
+  ozz::vector<Counter> counters_;
+};
+
+// Benchmark function.
+typedef std::function<void(State&)> Function;
+
+// Registers a benchmark. Name is expected to follow
+// "Job/variant/parameter" pattern, which allows filtering.
+void Register(const char* _name, Function _function);
+
+// Path of the media directory, where ozz binary files (media/bin) are
+// located. Benchmarks using media files are skipped if they can't be
+// loaded.
+const char* media_directory();
+
+// Helper used to register benchmarks at static initialization time:
+// OZZ_BENCHMARK_REGISTER(MyRegistrationFunction).
+struct Registrar {
+  explicit Registrar(void (*_fn)()) { _fn(); }
+};
+#define OZZ_BENCHMARK_REGISTER(_fn) \
+  static ozz::benchmark::Registrar _fn##_registrar(&_fn)
+
+#if defined(_MSC_VER) && !defined(__clang__)
+// Volatile sink Escape writes addresses to, see Escape().
+extern const void* volatile escape_sink;
+#endif  // _MSC_VER
+
+// Prevents the compiler from optimizing out _address content computation. The
+// address is given to an empty asm statement (or a volatile sink with msvc)
+// that clobbers memory, so the compiler has to assume content is read.
+inline void Escape(const void* _address) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  escape_sink = _address;
+  _ReadWriteBarrier();
+#else
+  asm volatile("" : : "g"(_address) : "memory");
+#endif  // _MSC_VER
+}
+template <typename _Ty>
+inline void DoNotOptimize(const _Ty& _value) {
+  Escape(&_value);
+}
+}  // namespace benchmark
+}  // namespace ozz
+#endif  // OZZ_BENCHMARK_BENCHMARK_H_
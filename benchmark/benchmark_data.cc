@@ -0,0 +1,122 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "benchmark_data.h"
+
+#include <string>
+
+#include "benchmark.h"
+#include "ozz/animation/offline/animation_builder.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/base/maths/quaternion.h"
+
+namespace ozz {
+namespace benchmark {
+
+namespace {
+// Adds children of joint _index, as if joints were stored breadth-first with
+// 3 children per joint.
+void AddChildren(animation::offline::RawSkeleton::Joint* _joint, int _index,
+                 int _num_joints) {
+  for (int c = _index * 3 + 1; c <= _index * 3 + 3 && c < _num_joints; ++c) {
+    _joint->children.emplace_back();
+    animation::offline::RawSkeleton::Joint& child = _joint->children.back();
+    child.name = "joint";
+    child.name += std::to_string(c).c_str();
+    child.transform = math::Transform::identity();
+    child.transform.translation = math::Float3(0.f, 1.f, 0.f);
+  }
+  for (size_t i = 0; i < _joint->children.size(); ++i) {
+    AddChildren(&_joint->children[i], _index * 3 + 1 + static_cast<int>(i),
+                _num_joints);
+  }
+}
+}  // namespace
+
+unique_ptr<animation::Skeleton> BuildSkeleton(int _num_joints,
+                                              bool _breadth_first) {
+  animation::offline::RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  animation::offline::RawSkeleton::Joint& root = raw_skeleton.roots[0];
+  root.name = "joint0";
+  root.transform = math::Transform::identity();
+  AddChildren(&root, 0, _num_joints);
+
+  animation::offline::SkeletonBuilder builder;
+  builder.joint_order = _breadth_first
+                            ? animation::offline::SkeletonBuilder::kBreadthFirst
+                            : animation::offline::SkeletonBuilder::kDepthFirst;
+  return builder(raw_skeleton);
+}
+
+animation::offline::RawAnimation BuildRawAnimation(int _num_tracks,
+                                                   float _duration,
+                                                   float _frequency) {
+  Random random;
+  animation::offline::RawAnimation raw_animation;
+  raw_animation.duration = _duration;
+  raw_animation.tracks.resize(_num_tracks);
+  for (animation::offline::RawAnimation::JointTrack& track :
+       raw_animation.tracks) {
+    // Tracks have a varying number of keys, like optimized animations.
+    const int num_keys = static_cast<int>(_duration * _frequency *
+                                          random.Next(.2f, 1.f)) +
+                         2;
+    for (int k = 0; k < num_keys; ++k) {
+      const float time = _duration * k / (num_keys - 1);
+      track.translations.push_back(
+          {time, math::Float3(random.Next(-1.f, 1.f), random.Next(-1.f, 1.f),
+                              random.Next(-1.f, 1.f))});
+      const math::Float3 axis =
+          Normalize(math::Float3(random.Next(-1.f, 1.f), 1.f,
+                                 random.Next(-1.f, 1.f)));
+      const float angle = random.Next(-1.f, 1.f);
+      track.rotations.push_back(
+          {time, math::Quaternion::FromAxisAngle(axis, angle)});
+      track.scales.push_back({time, math::Float3(random.Next(.9f, 1.1f))});
+    }
+  }
+  return raw_animation;
+}
+
+unique_ptr<animation::Animation> BuildAnimation(
+    const animation::offline::RawAnimation& _raw_animation,
+    float _iframe_interval) {
+  animation::offline::AnimationBuilder builder;
+  builder.iframe_interval = _iframe_interval;
+  return builder(_raw_animation);
+}
+
+ozz::string MediaPath(const char* _filename) {
+  ozz::string path = media_directory();
+  path += "/";
+  path += _filename;
+  return path;
+}
+}  // namespace benchmark
+}  // namespace ozz
@@ -0,0 +1,102 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_BENCHMARK_BENCHMARK_DATA_H_
+#define OZZ_BENCHMARK_BENCHMARK_DATA_H_
+
+// Provides synthetic and media data used by benchmarks.
+
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/containers/string.h"
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+namespace ozz {
+namespace benchmark {
+
+// Deterministic pseudo random generator, so that runs are comparable.
+class Random {
+ public:
+  explicit Random(uint32_t _seed = 46) : state_(_seed) {}
+
+  // Returns a value in range [0,1[.
+  float Next() {
+    state_ = state_ * 1664525u + 1013904223u;
+    return (state_ >> 8) * (1.f / 16777216.f);
+  }
+
+  // Returns a value in range [_min,_max[.
+  float Next(float _min, float _max) { return _min + Next() * (_max - _min); }
+
+ private:
+  uint32_t state_;
+};
+
+// Builds a skeleton of _num_joints joints, where every joint has up to 3
+// children. Joints are sorted by depth if _breadth_first is true.
+unique_ptr<animation::Skeleton> BuildSkeleton(int _num_joints,
+                                              bool _breadth_first = false);
+
+// Builds a raw animation of _num_tracks tracks lasting _duration seconds, with
+// random keys sampled at about _frequency keys per second.
+animation::offline::RawAnimation BuildRawAnimation(int _num_tracks,
+                                                   float _duration,
+                                                   float _frequency);
+
+// Builds a runtime animation from _raw_animation, with iframes every
+// _iframe_interval seconds (0 disables iframes).
+unique_ptr<animation::Animation> BuildAnimation(
+    const animation::offline::RawAnimation& _raw_animation,
+    float _iframe_interval);
+
+// Loads _object from media directory file _filename. Returns false if file
+// can't be opened or doesn't contain an object of type _Ty.
+template <typename _Ty>
+bool LoadMedia(const char* _filename, _Ty* _object);
+
+// Gets full path of media file _filename.
+ozz::string MediaPath(const char* _filename);
+
+template <typename _Ty>
+inline bool LoadMedia(const char* _filename, _Ty* _object) {
+  io::File file(MediaPath(_filename).c_str(), "rb");
+  if (!file.opened()) {
+    return false;
+  }
+  io::IArchive archive(&file);
+  if (!archive.TestTag<_Ty>()) {
+    return false;
+  }
+  archive >> *_object;
+  return true;
+}
+}  // namespace benchmark
+}  // namespace ozz
+#endif  // OZZ_BENCHMARK_BENCHMARK_DATA_H_
@@ -0,0 +1,302 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+// Benchmarks ozz geometry runtime jobs.
+
+#include <string>
+
+#include "benchmark.h"
+#include "benchmark_data.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/maths/dual_quaternion.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/scheduler.h"
+#include "ozz/geometry/runtime/dual_quaternion_skinning_job.h"
+#include "ozz/geometry/runtime/quantized_skinning_job.h"
+#include "ozz/geometry/runtime/skinning_job.h"
+
+namespace ozz {
+namespace benchmark {
+namespace {
+
+const int kNumVertices = 10000;
+const int kNumJoints = 80;
+
+// Skinning input and output vertices, packed as struct-of-arrays.
+struct SkinningVertices {
+  explicit SkinningVertices(int _influences);
+
+  int influences;
+  ozz::vector<uint16_t> indices;
+  ozz::vector<float> weights;
+  ozz::vector<float> in_positions;
+  ozz::vector<float> in_vectors;
+  ozz::vector<float> out_positions;
+  ozz::vector<float> out_normals;
+  ozz::vector<float> out_tangents;
+};
+
+SkinningVertices::SkinningVertices(int _influences)
+    : influences(_influences),
+      indices(kNumVertices * _influences),
+      weights(kNumVertices * (_influences > 1 ? _influences - 1 : 1),
+              1.f / _influences),
+      in_positions(kNumVertices * 3),
+      in_vectors(kNumVertices * 3),
+      out_positions(kNumVertices * 3),
+      out_normals(kNumVertices * 3),
+      out_tangents(kNumVertices * 3) {
+  Random random;
+  for (uint16_t& index : indices) {
+    index = static_cast<uint16_t>(random.Next() * kNumJoints);
+  }
+  for (size_t i = 0; i < in_positions.size(); ++i) {
+    in_positions[i] = random.Next(-1.f, 1.f);
+    in_vectors[i] = random.Next(-1.f, 1.f);
+  }
+}
+
+// Setups _job vertices, which can be a SkinningJob or a
+// DualQuaternionSkinningJob, as they share the same vertex layout.
+template <typename _Job>
+void SetupSkinningVertices(SkinningVertices* _vertices, bool _normals,
+                           bool _tangents, _Job* _job) {
+  const int num_weights = _vertices->influences - 1;
+  _job->vertex_count = kNumVertices;
+  _job->influences_count = _vertices->influences;
+  _job->joint_indices = make_span(_vertices->indices);
+  _job->joint_indices_stride = sizeof(uint16_t) * _vertices->influences;
+  if (num_weights > 0) {
+    _job->joint_weights = make_span(_vertices->weights);
+    _job->joint_weights_stride = sizeof(float) * num_weights;
+  }
+  _job->in_positions = make_span(_vertices->in_positions);
+  _job->in_positions_stride = sizeof(float) * 3;
+  _job->out_positions = make_span(_vertices->out_positions);
+  _job->out_positions_stride = sizeof(float) * 3;
+  if (_normals) {
+    _job->in_normals = make_span(_vertices->in_vectors);
+    _job->in_normals_stride = sizeof(float) * 3;
+    _job->out_normals = make_span(_vertices->out_normals);
+    _job->out_normals_stride = sizeof(float) * 3;
+  }
+  if (_tangents) {
+    _job->in_tangents = make_span(_vertices->in_vectors);
+    _job->in_tangents_stride = sizeof(float) * 3;
+    _job->out_tangents = make_span(_vertices->out_tangents);
+    _job->out_tangents_stride = sizeof(float) * 3;
+  }
+}
+
+// Builds random rigid joint matrices.
+ozz::vector<math::Float4x4> BuildJointMatrices() {
+  Random random;
+  ozz::vector<math::Float4x4> matrices(kNumJoints);
+  for (math::Float4x4& matrix : matrices) {
+    const math::SimdFloat4 axis = math::NormalizeSafe3(
+        math::simd_float4::Load(random.Next(-1.f, 1.f), random.Next(-1.f, 1.f),
+                                random.Next(-1.f, 1.f), 0.f),
+        math::simd_float4::y_axis());
+    matrix = math::Float4x4::Translation(math::simd_float4::Load(
+                 random.Next(), random.Next(), random.Next(), 1.f)) *
+             math::Float4x4::FromAxisAngle(
+                 axis, math::simd_float4::Load1(random.Next(-3.f, 3.f)));
+  }
+  return matrices;
+}
+
+void RunSkinning(State& _state, int _influences, bool _normals,
+                 bool _tangents, Scheduler* _scheduler = nullptr) {
+  const ozz::vector<math::Float4x4> matrices = BuildJointMatrices();
+  SkinningVertices vertices(_influences);
+
+  geometry::SkinningJob job;
+  job.joint_matrices = make_span(matrices);
+  SetupSkinningVertices(&vertices, _normals, _tangents, &job);
+  job.scheduler = _scheduler;
+
+  while (_state.KeepRunning()) {
+    if (!job.Run()) {
+      _state.set_error("SkinningJob failed");
+      return;
+    }
+  }
+  _state.set_items_per_iteration(kNumVertices);
+}
+
+// Skins the same vertices as RunSkinning, blending joint transformations as
+// dual quaternions. Palette conversion from matrices is included, as it's
+// needed every frame.
+void RunDualQuaternionSkinning(State& _state, int _influences, bool _normals,
+                               bool _tangents) {
+  const ozz::vector<math::Float4x4> matrices = BuildJointMatrices();
+  ozz::vector<math::DualQuaternion> dual_quaternions(kNumJoints);
+  SkinningVertices vertices(_influences);
+
+  geometry::DualQuaternionSkinningJob job;
+  job.joint_dual_quaternions = make_span(dual_quaternions);
+  SetupSkinningVertices(&vertices, _normals, _tangents, &job);
+
+  while (_state.KeepRunning()) {
+    if (!geometry::ToDualQuaternions(make_span(matrices),
+                                     make_span(dual_quaternions))) {
+      _state.set_error("ToDualQuaternions failed");
+      return;
+    }
+    if (!job.Run()) {
+      _state.set_error("DualQuaternionSkinningJob failed");
+      return;
+    }
+  }
+  _state.set_items_per_iteration(kNumVertices);
+}
+
+// Skins half-float positions and tangent frame, uint8 indices and unorm8
+// weights, packed as array-of-structs. Compares with SkinningJob tangents
+// variant.
+void RunQuantizedSkinning(State& _state, int _influences) {
+  Random random;
+
+  // Joint matrices.
+  ozz::vector<math::Float4x4> matrices(kNumJoints);
+  for (math::Float4x4& matrix : matrices) {
+    matrix = math::Float4x4::Translation(math::simd_float4::Load(
+        random.Next(), random.Next(), random.Next(), 1.f));
+  }
+
+  // Vertices, packed as array-of-structs: 3 half attributes and indices.
+  const int num_weights = _influences - 1;
+  const size_t stride = sizeof(uint16_t) * 9 + _influences + num_weights;
+  const size_t aligned_stride = (stride + 1) & ~size_t(1);
+  ozz::vector<byte> vertices(kNumVertices * aligned_stride);
+  for (int i = 0; i < kNumVertices; ++i) {
+    byte* vertex = vertices.data() + i * aligned_stride;
+    uint16_t* attributes = reinterpret_cast<uint16_t*>(vertex);
+    for (int j = 0; j < 9; ++j) {
+      attributes[j] = math::FloatToHalf(random.Next(-1.f, 1.f));
+    }
+    byte* indices = vertex + sizeof(uint16_t) * 9;
+    for (int j = 0; j < _influences; ++j) {
+      indices[j] = static_cast<byte>(random.Next() * kNumJoints);
+    }
+    byte* weights = indices + _influences;
+    for (int j = 0; j < num_weights; ++j) {
+      weights[j] = static_cast<byte>(255 / _influences);
+    }
+  }
+  ozz::vector<float> out_positions(kNumVertices * 3);
+  ozz::vector<float> out_normals(kNumVertices * 3);
+  ozz::vector<float> out_tangents(kNumVertices * 3);
+
+  const span<const byte> all = make_span(vertices);
+  const size_t indices_offset = sizeof(uint16_t) * 9;
+  geometry::QuantizedSkinningJob job;
+  job.vertex_count = kNumVertices;
+  job.influences_count = _influences;
+  job.joint_matrices = make_span(matrices);
+  job.joint_indices = all.subspan(indices_offset, all.size() - indices_offset);
+  job.joint_indices_stride = aligned_stride;
+  job.joint_indices_format = geometry::QuantizedSkinningJob::kIndexUInt8;
+  if (num_weights > 0) {
+    const size_t weights_offset = indices_offset + _influences;
+    job.joint_weights =
+        all.subspan(weights_offset, all.size() - weights_offset);
+    job.joint_weights_stride = aligned_stride;
+    job.joint_weights_format = geometry::QuantizedSkinningJob::kWeightUNorm8;
+  }
+  job.in_positions = all;
+  job.in_positions_stride = aligned_stride;
+  job.in_positions_format = geometry::QuantizedSkinningJob::kAttributeHalf;
+  job.in_normals = all.subspan(6, all.size() - 6);
+  job.in_normals_stride = aligned_stride;
+  job.in_normals_format = geometry::QuantizedSkinningJob::kAttributeHalf;
+  job.in_tangents = all.subspan(12, all.size() - 12);
+  job.in_tangents_stride = aligned_stride;
+  job.in_tangents_format = geometry::QuantizedSkinningJob::kAttributeHalf;
+  job.out_positions = make_span(out_positions);
+  job.out_positions_stride = sizeof(float) * 3;
+  job.out_normals = make_span(out_normals);
+  job.out_normals_stride = sizeof(float) * 3;
+  job.out_tangents = make_span(out_tangents);
+  job.out_tangents_stride = sizeof(float) * 3;
+
+  while (_state.KeepRunning()) {
+    if (!job.Run()) {
+      _state.set_error("QuantizedSkinningJob failed");
+      return;
+    }
+  }
+  _state.set_items_per_iteration(kNumVertices);
+}
+
+void RegisterSkinning() {
+  static const int influences[] = {1, 2, 4, 8};
+  static const struct {
+    const char* name;
+    bool normals;
+    bool tangents;
+  } attributes[] = {{"positions", false, false},
+                    {"normals", true, false},
+                    {"tangents", true, true}};
+  for (const int num_influences : influences) {
+    for (const auto& attribute : attributes) {
+      const std::string name = std::string("SkinningJob/") +
+                               std::to_string(num_influences) +
+                               "_influences/" + attribute.name;
+      const bool normals = attribute.normals;
+      const bool tangents = attribute.tangents;
+      Register(name.c_str(),
+               [num_influences, normals, tangents](State& _state) {
+                 RunSkinning(_state, num_influences, normals, tangents);
+               });
+      const std::string dq_name = std::string("DualQuaternionSkinningJob/") +
+                                  std::to_string(num_influences) +
+                                  "_influences/" + attribute.name;
+      Register(dq_name.c_str(),
+               [num_influences, normals, tangents](State& _state) {
+                 RunDualQuaternionSkinning(_state, num_influences, normals,
+                                           tangents);
+               });
+    }
+    const std::string name = std::string("QuantizedSkinningJob/") +
+                             std::to_string(num_influences) +
+                             "_influences/tangents";
+    Register(name.c_str(), [num_influences](State& _state) {
+      RunQuantizedSkinning(_state, num_influences);
+    });
+  }
+
+  // Skins vertices concurrently, on all hardware threads.
+  Register("SkinningJob/4_influences/tangents/scheduler", [](State& _state) {
+    ThreadPoolScheduler scheduler;
+    RunSkinning(_state, 4, true, true, &scheduler);
+  });
+}
+OZZ_BENCHMARK_REGISTER(RegisterSkinning);
+}  // namespace
+}  // namespace benchmark
+}  // namespace ozz
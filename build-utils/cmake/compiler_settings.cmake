@@ -42,6 +42,15 @@ if(ozz_build_simd_ref)
   add_compile_definitions(OZZ_BUILD_SIMD_REF)
 endif()
 
+# Simd math AVX2 and FMA instruction sets
+if(ozz_build_simd_avx2 AND NOT ozz_build_simd_ref)
+  if(CMAKE_CXX_COMPILER_ID STREQUAL "MSVC")
+    add_compile_options(/arch:AVX2)
+  else()
+    add_compile_options(-mavx2 -mfma -mf16c)
+  endif()
+endif()
+
 # --------------------------------------
 # Modify default MSVC compilation flags
 if(CMAKE_CXX_COMPILER_ID STREQUAL "MSVC")
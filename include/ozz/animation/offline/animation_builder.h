@@ -34,8 +34,9 @@
 namespace ozz {
 namespace animation {
 
-// Forward declares the runtime animation type.
+// Forward declares the runtime animation and skeleton types.
 class Animation;
+class Skeleton;
 
 namespace offline {
 
@@ -44,7 +45,10 @@ struct RawAnimation;
 
 // Defines the class responsible of building runtime animation instances from
 // offline raw animations.
-// No optimization at all is performed on the raw animation.
+// No keyframe optimization at all is performed on the raw animation. When a
+// skeleton is provided though, keys of soa tracks whose range of values allows
+// it are quantized on fewer bits, as long as the error generated on the joint
+// hierarchy remains within quantization tolerance.
 class OZZ_ANIMOFFLINE_DLL AnimationBuilder {
  public:
   // Creates an Animation based on _raw_animation and *this builder parameters.
@@ -54,6 +58,14 @@ class OZZ_ANIMOFFLINE_DLL AnimationBuilder {
   // the caller.
   unique_ptr<Animation> operator()(const RawAnimation& _raw_animation) const;
 
+  // Creates an Animation based on _raw_animation, *this builder parameters and
+  // _skeleton, which is required to evaluate quantization error along joint
+  // hierarchy (see quantization setting).
+  // Returns nullptr if _raw_animation is invalid, or if _skeleton doesn't
+  // match _raw_animation number of tracks.
+  unique_ptr<Animation> operator()(const RawAnimation& _raw_animation,
+                                   const Skeleton& _skeleton) const;
+
   // IFrames allow the sampler to instantly seek to a point in time in the
   // animation. If no iframe is available, the sampler needs to read
   // sequentially forward or backward to reach a point. So that's useful for
@@ -62,6 +74,25 @@ class OZZ_ANIMOFFLINE_DLL AnimationBuilder {
   // the interval between iframes, with a guaranteed one at the end of the
   // animation (even if interval is smaller than animation duration).
   float iframe_interval = 0.f;
+
+  // Quantization settings, used when building with a skeleton. Error is
+  // evaluated the same way as AnimationOptimizer does.
+  struct QuantizationSetting {
+    // The maximum error that quantization is allowed to generate on a whole
+    // joint hierarchy.
+    float tolerance = 1e-3f;  // 1mm
+
+    // The distance (from the joint) at which error is measured (if bigger that
+    // joint hierarchy). This allows to emulate effect on skinning.
+    float distance = 1e-1f;  // 10cm
+  };
+  QuantizationSetting quantization;
+
+ private:
+  // Implements both operator(), _skeleton can be nullptr in which case no key
+  // is quantized.
+  unique_ptr<Animation> Build(const RawAnimation& _raw_animation,
+                              const Skeleton* _skeleton) const;
 };
 }  // namespace offline
 }  // namespace animation
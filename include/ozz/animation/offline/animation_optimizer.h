@@ -32,6 +32,10 @@
 #include "ozz/base/containers/map.h"
 
 namespace ozz {
+
+// Forward declare scheduler interface.
+class Scheduler;
+
 namespace animation {
 
 // Forward declare runtime skeleton type.
@@ -91,6 +95,25 @@ class OZZ_ANIMOFFLINE_DLL AnimationOptimizer {
   // Per joint override of optimization settings.
   typedef ozz::map<int, Setting> JointsSetting;
   JointsSetting joints_setting_override;
+
+  // Fits cubic Hermite splines to tracks, instead of decimating keys for
+  // linear interpolation. Output tracks have a tangent per key (see
+  // RawAnimation::JointTrack), estimated from input keys unless input already
+  // has tangents. Smooth tracks (like motion capture) then reach the same
+  // tolerance with far fewer keys, at the cost of storing tangents. Input
+  // tangents are dropped when false.
+  bool hermite = false;
+
+  // Number of threads used to optimize animation tracks. Tracks are optimized
+  // independently, so the output doesn't depend on the number of threads. 0
+  // uses as many threads as the hardware supports, 1 optimizes on the calling
+  // thread only.
+  int num_threads = 1;
+
+  // Optional scheduler used to optimize tracks concurrently, in which case
+  // num_threads is ignored. This allows to run optimization on application
+  // threads, instead of threads created by the optimizer.
+  Scheduler* scheduler = nullptr;
 };
 }  // namespace offline
 }  // namespace animation
@@ -49,11 +49,16 @@ namespace offline {
 // defined as a set of three different std::vectors (translation, rotation and
 // scales). Animation structure is then a vector of tracks, along with a
 // duration value.
+// Keyframes are linearly interpolated, unless tracks of a transformation type
+// define tangents, in which case they're interpolated with cubic Hermite
+// splines.
 // Finally the RawAnimation structure exposes Validate() function to check that
 // it is valid, meaning that all the following rules are respected:
 //  1. Animation duration is greater than 0.
 //  2. Keyframes' time are sorted in a strict ascending order.
 //  3. Keyframes' time are all within [0,animation duration] range.
+//  4. Tangents, if any, are specified for every keyframe of every track of a
+//  transformation type.
 // Animations that would fail this validation will fail to be converted by the
 // AnimationBuilder.
 struct OZZ_ANIMOFFLINE_DLL RawAnimation {
@@ -65,6 +70,8 @@ struct OZZ_ANIMOFFLINE_DLL RawAnimation {
   //  1. Animation duration is greater than 0.
   //  2. Keyframes' time are sorted in a strict ascending order.
   //  3. Keyframes' time are all within [0,animation duration] range.
+  //  4. Tangents, if any, are specified for every keyframe of every track of a
+  //  transformation type.
   bool Validate() const;
 
   // Get the estimated animation's size in bytes.
@@ -119,6 +126,20 @@ struct OZZ_ANIMOFFLINE_DLL RawAnimation {
     typedef ozz::vector<ScaleKey> Scales;
     Scales scales;
 
+    // Optional keyframes tangents, aka the derivative of keyframes value over
+    // time (per second). If not empty, there must be one tangent per keyframe,
+    // and keyframes are interpolated with cubic Hermite splines instead of
+    // linearly. Rotation tangents are the derivative of the quaternion
+    // components, which are normalized after interpolation.
+    // Values are held before the first and after the last keyframe, so tangents
+    // of these keyframes should be null if they're not at animation boundaries.
+    typedef ozz::vector<math::Float3> TranslationTangents;
+    TranslationTangents translation_tangents;
+    typedef ozz::vector<math::Float4> RotationTangents;
+    RotationTangents rotation_tangents;
+    typedef ozz::vector<math::Float3> ScaleTangents;
+    ScaleTangents scale_tangents;
+
     // Validates track. See RawAnimation::Validate for more details.
     // Use an infinite value for _duration if unknown. This will validate
     // keyframe orders, but not maximum duration.
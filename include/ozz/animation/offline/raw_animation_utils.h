@@ -53,6 +53,29 @@ OZZ_ANIMOFFLINE_DLL math::Float3 LerpScale(const math::Float3& _a,
                                            const math::Float3& _b,
                                            float _alpha);
 
+// Cubic Hermite interpolation methods, used for tracks with tangents.
+// _a_tangent and _b_tangent are the derivatives over time at _a and _b, and
+// _interval the time between _a and _b keys.
+// Translation Hermite interpolation method.
+OZZ_ANIMOFFLINE_DLL math::Float3 HermiteTranslation(
+    const math::Float3& _a, const math::Float3& _a_tangent,
+    const math::Float3& _b, const math::Float3& _b_tangent, float _interval,
+    float _alpha);
+
+// Rotation Hermite interpolation method. Quaternion components are interpolated
+// and then normalized.
+OZZ_ANIMOFFLINE_DLL math::Quaternion HermiteRotation(
+    const math::Quaternion& _a, const math::Float4& _a_tangent,
+    const math::Quaternion& _b, const math::Float4& _b_tangent,
+    float _interval, float _alpha);
+
+// Scale Hermite interpolation method.
+OZZ_ANIMOFFLINE_DLL math::Float3 HermiteScale(const math::Float3& _a,
+                                              const math::Float3& _a_tangent,
+                                              const math::Float3& _b,
+                                              const math::Float3& _b_tangent,
+                                              float _interval, float _alpha);
+
 // Samples a RawAnimation track. This function shall be used for offline
 // purpose. Use ozz::animation::Animation and ozz::animation::SamplingJob for
 // runtime purpose.
@@ -74,6 +97,17 @@ OZZ_ANIMOFFLINE_DLL bool SampleAnimation(
 OZZ_ANIMOFFLINE_DLL ozz::vector<float> ExtractTimePoints(
     const RawAnimation& _animation);
 
+// Extracts the [_from, _to] time range of a valid RawAnimation to _output.
+// Keyframes (and tangents) are sampled at both range boundaries, so that
+// _output matches _animation on the whole range. Output keyframe times are
+// offset such that _from becomes time 0, and _output duration is _to - _from.
+// Empty tracks remain empty.
+// Returns false if _animation is invalid or the range isn't included in
+// [0, _animation.duration].
+OZZ_ANIMOFFLINE_DLL bool ExtractAnimationRange(const RawAnimation& _animation,
+                                               float _from, float _to,
+                                               RawAnimation* _output);
+
 // Implement fixed rate keyframe time iteration. This utility purpose is to
 // ensure that sampling goes strictly from 0 to duration, and that period
 // between consecutive time samples have a fixed period.
@@ -29,6 +29,7 @@
 #define OZZ_OZZ_ANIMATION_OFFLINE_SKELETON_BUILDER_H_
 
 #include "ozz/animation/offline/export.h"
+#include "ozz/base/containers/vector.h"
 #include "ozz/base/maths/transform.h"
 #include "ozz/base/memory/unique_ptr.h"
 
@@ -53,6 +54,33 @@ class OZZ_ANIMOFFLINE_DLL SkeletonBuilder {
   // caller.
   ozz::unique_ptr<ozz::animation::Skeleton> operator()(
       const RawSkeleton& _raw_skeleton) const;
+
+  // Same as above, additionally outputs joints remapping table _joint_remap.
+  // _joint_remap[i] is the index in the built skeleton of the i-th joint of
+  // _raw_skeleton, in depth-first order. This is the identity for kDepthFirst
+  // joint order. This table allows to reorder data authored for a depth-first
+  // skeleton, like RawAnimation tracks.
+  ozz::unique_ptr<ozz::animation::Skeleton> operator()(
+      const RawSkeleton& _raw_skeleton,
+      ozz::vector<int16_t>* _joint_remap) const;
+
+  // Defines runtime skeleton joints order.
+  enum JointOrder {
+    // Joints are ordered depth-first, so every sub-hierarchy is a contiguous
+    // range of joints. This is the default order, that's required to use
+    // LocalToModelJob from/to parameters and skeleton_utils.h iteration
+    // functions.
+    kDepthFirst,
+
+    // Joints are sorted by depth (level in the hierarchy), joints of the same
+    // level remain in depth-first order. Children of a same parent are thus
+    // contiguous, allowing LocalToModelJob to update 4 joints of a level at
+    // once in soa format. Parents still come before their children.
+    kBreadthFirst,
+  };
+
+  // Runtime skeleton joints order.
+  JointOrder joint_order = kDepthFirst;
 };
 }  // namespace offline
 }  // namespace animation
@@ -0,0 +1,68 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_OFFLINE_STREAMING_ANIMATION_BUILDER_H_
+#define OZZ_OZZ_ANIMATION_OFFLINE_STREAMING_ANIMATION_BUILDER_H_
+
+#include "ozz/animation/offline/export.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+namespace ozz {
+namespace animation {
+
+class StreamingAnimation;
+
+namespace offline {
+
+struct RawAnimation;
+
+// Defines the class responsible of building streaming animations from offline
+// raw animations. The raw animation is split into chunks of chunk_duration
+// seconds, each of them being built as a standalone runtime Animation.
+class OZZ_ANIMOFFLINE_DLL StreamingAnimationBuilder {
+ public:
+  // Creates a StreamingAnimation based on _raw_animation and *this builder
+  // parameters. All chunks of the returned animation are loaded, so it can be
+  // serialized or sampled directly.
+  // Returns a valid StreamingAnimation on success.
+  // See RawAnimation::Validate() for more details about failure reasons. The
+  // build also fails if chunk_duration isn't greater than 0.
+  unique_ptr<StreamingAnimation> operator()(
+      const RawAnimation& _raw_animation) const;
+
+  // Duration of each chunk, in seconds. Chunk duration bounds the amount of
+  // animation data that is kept in memory at runtime.
+  float chunk_duration = 2.f;
+
+  // IFrame interval used to build chunks. See AnimationBuilder::iframe_interval
+  // for more details.
+  float iframe_interval = 0.f;
+};
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_OFFLINE_STREAMING_ANIMATION_BUILDER_H_
@@ -30,6 +30,7 @@
 
 #include "ozz/animation/offline/export.h"
 #include "ozz/base/memory/unique_ptr.h"
+#include "ozz/base/span.h"
 
 namespace ozz {
 namespace animation {
@@ -40,6 +41,7 @@ class Float2Track;
 class Float3Track;
 class Float4Track;
 class QuaternionTrack;
+class TrackEventIndex;
 
 namespace offline {
 
@@ -68,6 +70,14 @@ class OZZ_ANIMOFFLINE_DLL TrackBuilder {
   ozz::unique_ptr<QuaternionTrack> operator()(
       const RawQuaternionTrack& _input) const;
 
+  // Creates a TrackEventIndex of _inputs tracks edges, as detected by
+  // TrackTriggeringJob for _threshold value. Index track i refers to
+  // _inputs[i].
+  // Returns an index instance on success, an empty unique_ptr on failure, if
+  // any of the _inputs is invalid.
+  ozz::unique_ptr<TrackEventIndex> operator()(span<const RawFloatTrack> _inputs,
+                                              float _threshold) const;
+
  private:
   template <typename _RawTrack, typename _Track>
   ozz::unique_ptr<_Track> Build(const _RawTrack& _input) const;
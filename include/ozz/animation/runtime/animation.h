@@ -37,6 +37,7 @@ namespace ozz {
 namespace io {
 class IArchive;
 class OArchive;
+class Stream;
 }  // namespace io
 namespace animation {
 
@@ -48,7 +49,11 @@ class AnimationBuilder;
 // Forward declaration of key frame's type.
 namespace internal {
 struct Float3Key;
+struct Float4Key;
 struct QuaternionKey;
+struct QuantizedFloat3Key;
+struct QuantizedQuaternionKey;
+struct QuantizationRange;
 }  // namespace internal
 
 // Defines a runtime skeletal animation clip.
@@ -61,6 +66,17 @@ struct QuaternionKey;
 // joints order of the runtime skeleton structure. In order to optimize cache
 // coherency when sampling the animation, Keyframes in this array are sorted by
 // time, then by track number.
+// Soa tracks (4 consecutive joints) whose keyframes are all identical for a
+// transformation type are not stored in the keyframes array. Their value is
+// stored once in a separate constant array instead, so they neither take
+// memory nor sampling time.
+// Animated soa tracks whose range of values allows it (according to the error
+// tolerance given to the AnimationBuilder) are stored in a second keyframes
+// array, whose keys are normalized in their soa track range and quantized on
+// fewer bits.
+// Keyframes are linearly interpolated, unless tangents are stored for a
+// transformation type, in which case its keyframes are interpolated with cubic
+// Hermite splines.
 class OZZ_ANIMATION_DLL Animation {
  public:
   // Builds a default animation.
@@ -154,6 +170,76 @@ class OZZ_ANIMATION_DLL Animation {
     return scales_values_;
   }
 
+  // Gets the buffers of quantized translations, rotations and scales keys,
+  // along with the quantization range of each of their soa tracks.
+  KeyframesCtrlConst translations_quantized_ctrl() const {
+    return translations_quantized_ctrl_;
+  }
+  span<const internal::QuantizedFloat3Key> translations_quantized_values()
+      const {
+    return translations_quantized_values_;
+  }
+  span<const internal::QuantizationRange> translations_ranges() const {
+    return translations_ranges_;
+  }
+  KeyframesCtrlConst rotations_quantized_ctrl() const {
+    return rotations_quantized_ctrl_;
+  }
+  span<const internal::QuantizedQuaternionKey> rotations_quantized_values()
+      const {
+    return rotations_quantized_values_;
+  }
+  span<const internal::QuantizationRange> rotations_ranges() const {
+    return rotations_ranges_;
+  }
+  KeyframesCtrlConst scales_quantized_ctrl() const {
+    return scales_quantized_ctrl_;
+  }
+  span<const internal::QuantizedFloat3Key> scales_quantized_values() const {
+    return scales_quantized_values_;
+  }
+  span<const internal::QuantizationRange> scales_ranges() const {
+    return scales_ranges_;
+  }
+
+  // Gets the buffers of keyframes tangents, aka the derivative of keyframes
+  // value over animation ratio, matching (full precision) keyframes values
+  // buffers. A buffer is empty if keyframes of a transformation type are
+  // linearly interpolated, in which case they have no quantized keyframes.
+  span<const internal::Float3Key> translations_tangents() const {
+    return translations_tangents_;
+  }
+  span<const internal::Float4Key> rotations_tangents() const {
+    return rotations_tangents_;
+  }
+  span<const internal::Float3Key> scales_tangents() const {
+    return scales_tangents_;
+  }
+
+  // Gets soa tracks remapping, for each transformation type. It stores the
+  // soa track index of every animated soa track (in keyframes order), then of
+  // every quantized soa track (in quantized keyframes order), followed by the
+  // index of every constant soa track (in constants order).
+  span<const uint16_t> translations_soa_tracks() const {
+    return translations_soa_tracks_;
+  }
+  span<const uint16_t> rotations_soa_tracks() const {
+    return rotations_soa_tracks_;
+  }
+  span<const uint16_t> scales_soa_tracks() const { return scales_soa_tracks_; }
+
+  // Gets the buffer of constant keys, for each transformation type. There are
+  // 4 keys per constant soa track, one for each joint.
+  span<const internal::Float3Key> translations_constants() const {
+    return translations_constants_;
+  }
+  span<const internal::QuaternionKey> rotations_constants() const {
+    return rotations_constants_;
+  }
+  span<const internal::Float3Key> scales_constants() const {
+    return scales_constants_;
+  }
+
   // Get the estimated animation's size in bytes.
   size_t size() const;
 
@@ -162,6 +248,24 @@ class OZZ_ANIMATION_DLL Animation {
   void Save(ozz::io::OArchive& _archive) const;
   void Load(ozz::io::IArchive& _archive, uint32_t _version);
 
+  // Image functions.
+  // An image is a flat binary copy of the animation memory buffer, preceded by
+  // a header. Contrary to archives, images are neither endian swapped nor
+  // compatible across versions, but they can be used in place: MapImage()
+  // makes animation data point directly to image memory (like a MappedFile
+  // content), without any allocation or copy.
+
+  // Writes *this animation image to _stream.
+  // Returns true on success.
+  bool SaveImage(ozz::io::Stream& _stream) const;
+
+  // Initializes *this animation from _image, without copying animation data.
+  // _image memory must be aligned to 4 bytes, and remain valid and unchanged
+  // during *this animation lifetime.
+  // Returns false if _image isn't a valid image for this platform, in which
+  // case *this animation is left empty.
+  bool MapImage(span<const byte> _image);
+
  private:
   // AnimationBuilder class is allowed to instantiate an Animation.
   friend class offline::AnimationBuilder;
@@ -175,6 +279,14 @@ class OZZ_ANIMATION_DLL Animation {
     size_t rotations;
     size_t scales;
 
+    // Number of soa tracks, aka size of each soa tracks remapping.
+    size_t soa_tracks;
+
+    // Number of constant keys.
+    size_t translation_constants;
+    size_t rotation_constants;
+    size_t scale_constants;
+
     struct IFrames {
       size_t entries;
       size_t offsets;
@@ -183,10 +295,32 @@ class OZZ_ANIMATION_DLL Animation {
     IFrames translation_iframes;
     IFrames rotation_iframes;
     IFrames scale_iframes;
+
+    // Quantized keyframes series.
+    struct Quantized {
+      size_t keys;
+      size_t ranges;  // Number of quantized soa tracks.
+      IFrames iframes;
+    };
+
+    Quantized translation_quantized;
+    Quantized rotation_quantized;
+    Quantized scale_quantized;
+
+    // Number of keyframes tangents, either 0 or the number of keys.
+    size_t translation_tangents;
+    size_t rotation_tangents;
+    size_t scale_tangents;
   };
   void Allocate(const AllocateParams& _params);
   void Deallocate();
 
+  // Computes the size of the buffer required to store animation data.
+  static size_t BufferSize(const AllocateParams& _params);
+
+  // Distributes _buffer memory to animation data spans.
+  void Distribute(const AllocateParams& _params, span<byte> _buffer);
+
   // Duration of the animation clip.
   float duration_ = 0.f;
 
@@ -194,9 +328,13 @@ class OZZ_ANIMATION_DLL Animation {
   // rotation/scale buffers because of SoA requirements.
   int num_tracks_ = 0;
 
-  // Allocated buffer for the whole animation.
+  // Allocated buffer for the whole animation, nullptr if animation data is
+  // mapped from an image.
   void* allocation_ = nullptr;
 
+  // Buffer of the whole animation data, either allocated or mapped.
+  span<byte> buffer_;
+
   // Animation name.
   char* name_ = nullptr;
 
@@ -212,11 +350,39 @@ class OZZ_ANIMATION_DLL Animation {
   span<internal::Float3Key> translations_values_;
   span<internal::QuaternionKey> rotations_values_;
   span<internal::Float3Key> scales_values_;
+
+  // Quantized keyframes series.
+  KeyframesCtrl translations_quantized_ctrl_;
+  KeyframesCtrl rotations_quantized_ctrl_;
+  KeyframesCtrl scales_quantized_ctrl_;
+  span<internal::QuantizedFloat3Key> translations_quantized_values_;
+  span<internal::QuantizedQuaternionKey> rotations_quantized_values_;
+  span<internal::QuantizedFloat3Key> scales_quantized_values_;
+
+  // Keyframes series tangents, for hermite interpolation.
+  span<internal::Float3Key> translations_tangents_;
+  span<internal::Float4Key> rotations_tangents_;
+  span<internal::Float3Key> scales_tangents_;
+
+  // Quantization ranges of quantized soa tracks.
+  span<internal::QuantizationRange> translations_ranges_;
+  span<internal::QuantizationRange> rotations_ranges_;
+  span<internal::QuantizationRange> scales_ranges_;
+
+  // Soa tracks remapping, animated soa tracks first, then quantized ones.
+  span<uint16_t> translations_soa_tracks_;
+  span<uint16_t> rotations_soa_tracks_;
+  span<uint16_t> scales_soa_tracks_;
+
+  // Constant soa tracks values.
+  span<internal::Float3Key> translations_constants_;
+  span<internal::QuaternionKey> rotations_constants_;
+  span<internal::Float3Key> scales_constants_;
 };
 }  // namespace animation
 
 namespace io {
-OZZ_IO_TYPE_VERSION(7, animation::Animation)
+OZZ_IO_TYPE_VERSION(10, animation::Animation)
 OZZ_IO_TYPE_TAG("ozz-animation", animation::Animation)
 }  // namespace io
 }  // namespace ozz
@@ -35,7 +35,8 @@ namespace ozz {
 namespace animation {
 
 // Count translation, rotation or scale keyframes for a given track number. Use
-// a negative _track value to count all tracks.
+// a negative _track value to count all tracks. Constant tracks count as a
+// single keyframe.
 OZZ_ANIMATION_DLL int CountTranslationKeyframes(const Animation& _animation,
                                                 int _track = -1);
 OZZ_ANIMATION_DLL int CountRotationKeyframes(const Animation& _animation,
@@ -0,0 +1,169 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_BATCH_SAMPLING_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_BATCH_SAMPLING_JOB_H_
+
+#include "ozz/animation/runtime/export.h"
+#include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+
+// Forward declaration of math structures.
+namespace math {
+struct SoaTransform;
+}
+
+namespace animation {
+
+// Forward declares the animation type to sample.
+class Animation;
+
+// Samples the same animation for many instances (aka characters) at once, each
+// at its own time ratio, to output the corresponding postures in local-space.
+// Sampling many instances of the same animation with independent SamplingJob
+// and contexts means walking and decompressing the same keyframes for every
+// instance. BatchSamplingJob instead sorts instances by ratio and groups them
+// in clusters, whose instances are closer to each other than the time they
+// moved since the previous run. Each cluster is sampled with a single context,
+// whose keyframe cursors are stepped incrementally from one instance to the
+// next. Walking from an instance to the next then costs less than stepping the
+// instance from its previous ratio, and each keyframe is walked and
+// decompressed once per cluster, rather than once per instance. Instances with
+// the same ratio reuse the previously sampled posture.
+// Instances that aren't close enough to any other are sampled with their own
+// context, exactly like an independent SamplingJob would. Batching thus pays
+// off for dense crowds playing the same animation with small offsets, and
+// costs about the same as independent jobs otherwise.
+// The job does not own the buffers (in/output) and will thus not delete them
+// during job's destruction.
+struct OZZ_ANIMATION_DLL BatchSamplingJob {
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if any input pointer is nullptr
+  // -if ratios and outputs ranges don't have the same size.
+  // -if any output range is invalid.
+  // -if context is too small for the animation or the number of instances.
+  bool Validate() const;
+
+  // Runs job's sampling task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // The animation to sample.
+  const Animation* animation = nullptr;
+
+  // Time ratios in the unit interval [0,1], one per instance. See
+  // SamplingJob::ratio for more details. Ratios are clamped before job
+  // execution.
+  span<const float> ratios;
+
+  // Forward declares the context object used by the BatchSamplingJob.
+  class Context;
+
+  // A context object that must be big enough to sample *this animation, for
+  // the number of instances of the job.
+  Context* context = nullptr;
+
+  // Job output.
+  // The output ranges to be filled with sampled joints during job execution,
+  // one per instance (matching ratios order). See SamplingJob::output for
+  // more details about the behavior when output ranges and animation have
+  // a different number of joints.
+  span<const span<ozz::math::SoaTransform>> outputs;
+};
+
+// Declares the context object used by the BatchSamplingJob. It owns one
+// SamplingJob::Context per instance, plus instances previous ratios and the
+// scratch buffer used to sort instances by ratio. Instances are matched to
+// their context by index, so the same instance should use the same index from
+// one job run to the next.
+class OZZ_ANIMATION_DLL BatchSamplingJob::Context {
+ public:
+  // Constructs an empty context. The context needs to be resized with the
+  // appropriate number of tracks and instances before it can be used with a
+  // BatchSamplingJob.
+  Context();
+
+  // Constructs a context that can be used to sample any animation with at most
+  // _max_tracks tracks, for at most _max_instances instances.
+  Context(int _max_tracks, int _max_instances);
+
+  // Disables copy and assignation.
+  Context(const Context&) = delete;
+  Context& operator=(const Context&) = delete;
+  Context(Context&&) = delete;
+  Context& operator=(Context&&) = delete;
+
+  // Deallocates context.
+  ~Context();
+
+  // Resize the number of joints and instances that the context can support.
+  // This also implicitly invalidate the context.
+  void Resize(int _max_tracks, int _max_instances);
+
+  // Invalidate the context. See SamplingJob::Context::Invalidate().
+  void Invalidate();
+
+  // The maximum number of tracks that the context can handle.
+  int max_tracks() const { return max_soa_tracks_ * 4; }
+  int max_soa_tracks() const { return max_soa_tracks_; }
+
+  // The maximum number of instances that the context can handle.
+  int max_instances() const { return static_cast<int>(contexts_.size()); }
+
+ private:
+  friend struct BatchSamplingJob;
+
+  void Deallocate();
+
+  // The maximum number of soa tracks that the context can handle.
+  int max_soa_tracks_;
+
+  // Single allocation for the whole context.
+  void* allocation_ = nullptr;
+
+  // Sampling contexts, one per instance. Clusters are sampled with the context
+  // of their first instance.
+  span<SamplingJob::Context> contexts_;
+
+  // Ratio of every instance at the previous run, or a negative value if the
+  // instance wasn't sampled yet.
+  span<float> ratios_;
+
+  // Ratio of the last instance sampled with every context.
+  span<float> cursors_;
+
+  // Instances indices, sorted by ratio.
+  span<uint32_t> order_;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_BATCH_SAMPLING_JOB_H_
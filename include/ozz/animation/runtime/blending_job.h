@@ -51,6 +51,9 @@ namespace animation {
 // can be specified with layers joint_weights buffer. Unspecified joint weights
 // are considered as a unit weight of 1.f, allowing to mix full and partial
 // blend operations in a single pass.
+// Layers that only affect a few joints (an arm, the upper body...) can also
+// specify the list of soa joints they affect (see Layer::soa_joints), so that
+// other joints aren't processed at all.
 // The job does not owned any buffers (input/output) and will thus not delete
 // them during job's destruction.
 struct OZZ_ANIMATION_DLL BlendingJob {
@@ -63,6 +66,9 @@ struct OZZ_ANIMATION_DLL BlendingJob {
   // -if any buffer (including layers' content : transform, joint weights...) is
   // smaller than the rest pose buffer.
   // -if the threshold value is less than or equal to 0.f.
+  // -if min_layer_weight is negative.
+  // -if any layer soa_joints isn't strictly increasing, or is out of rest pose
+  // range.
   bool Validate() const;
 
   // Runs job's blending task.
@@ -99,6 +105,18 @@ struct OZZ_ANIMATION_DLL BlendingJob {
     // aren't clamped because they could exceed 1.f if all layers contains valid
     // joint weights.
     span<const math::SimdFloat4> joint_weights;
+
+    // Optional list of the soa joints (indices in transform and joint_weights
+    // buffers) this layer affects, sorted in strictly increasing order.
+    // Joints that aren't listed are considered to have a weight of 0, and
+    // aren't processed at all, which benefits layers that affect a small part
+    // of the skeleton. Listed joints are blended with the layer weight,
+    // multiplied by their joint_weights if specified. Such a list can be
+    // deduced from joint weights with ExtractLayerSoaJoints function.
+    // If empty (default case), all joints are processed. Note that if the
+    // first processed layer is sparse, the output must be cleared first, so
+    // sparse layers are best used on top of a full layer.
+    span<const uint16_t> soa_joints;
   };
 
   // The job blends the rest pose to the output when the accumulated weight of
@@ -106,6 +124,12 @@ struct OZZ_ANIMATION_DLL BlendingJob {
   // Must be greater than 0.f.
   float threshold = .1f;
 
+  // Layers whose weight (absolute weight for additive layers) is less than or
+  // equal to this value are skipped, as their contribution would be
+  // negligible. Must be greater or equal to 0.f, the default value only skips
+  // layers with a null (or negative for non additive layers) weight.
+  float min_layer_weight = 0.f;
+
   // Job input layers, can be empty or nullptr.
   // The range of layers that must be blended.
   span<const Layer> layers;
@@ -128,6 +152,19 @@ struct OZZ_ANIMATION_DLL BlendingJob {
   // transforms defined by the rest pose buffer size will be processed.
   span<ozz::math::SoaTransform> output;
 };
+
+// Fills _soa_joints with the indices of the soa joints whose _joint_weights
+// aren't all less or equal to 0, and outputs their number to _count. The
+// first _count elements of _soa_joints are the list of soa joints a partial
+// blending layer affects, see BlendingJob::Layer::soa_joints.
+// Returns false if _count is nullptr or _soa_joints is smaller than
+// _joint_weights, in which case _soa_joints and _count are left unchanged.
+// Note that _count is 0 if no joint is affected. Such a layer has no effect and
+// must be skipped, rather than given an empty soa_joints list which means all
+// joints are affected.
+OZZ_ANIMATION_DLL bool ExtractLayerSoaJoints(
+    span<const math::SimdFloat4> _joint_weights, span<uint16_t> _soa_joints,
+    size_t* _count);
 }  // namespace animation
 }  // namespace ozz
 #endif  // OZZ_OZZ_ANIMATION_RUNTIME_BLENDING_JOB_H_
@@ -0,0 +1,212 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_CHARACTER_UPDATE_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_CHARACTER_UPDATE_JOB_H_
+
+#include "ozz/animation/runtime/export.h"
+#include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/platform.h"
+#include "ozz/base/scheduler.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+
+// Forward declaration of math structures.
+namespace math {
+struct SoaTransform;
+}
+
+namespace animation {
+
+// Forward declares runtime structures.
+class Animation;
+class Skeleton;
+
+// Updates the posture of many characters at once, running for each of them
+// the usual chain of jobs: sampling of every animation layer, blending of the
+// layers, local-to-model conversion, and optionally skinning matrices
+// computation (model-space matrices multiplied by mesh inverse bind poses).
+// Characters are independent, so the job distributes them to a Scheduler,
+// where each character runs its whole chain of stages. Stages don't wait for
+// all characters to complete the previous one, which keeps character data hot
+// in cache from one stage to the next.
+// Intermediate local-space buffers (sampled layers and blended posture) are
+// scratch buffers owned by the context, one set per scheduler worker, so
+// their size depends on the number of workers rather than on the number of
+// characters.
+// The job does not own the buffers (in/output) and will thus not delete them
+// during job's destruction.
+struct OZZ_ANIMATION_DLL CharacterUpdateJob {
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if context is nullptr, or too small for any character skeleton, layers
+  // count or for the number of scheduler workers.
+  // -if any character skeleton or layer animation/context is nullptr.
+  // -if any character has no layer.
+  // -if any layer animation has fewer tracks than its character skeleton
+  // joints, or if its sampling context is too small.
+  // -if any model-space output is smaller than its skeleton number of joints.
+  // -if skinning matrices are requested but inverse bind poses and joint
+  // remaps don't match, or skinning_matrices output is too small.
+  bool Validate() const;
+
+  // Runs job's update task for all characters.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Defines an animation layer of a character.
+  struct OZZ_ANIMATION_DLL Layer {
+    // Animation to sample.
+    const Animation* animation = nullptr;
+
+    // Sampling context of this layer. Every layer of every character should
+    // use its own context, as contexts cache sampling state from one frame to
+    // the next.
+    SamplingJob::Context* context = nullptr;
+
+    // Time ratio used to sample the animation, see SamplingJob::ratio.
+    float ratio = 0.f;
+
+    // Blending weight and optional per-joint weights, see BlendingJob::Layer.
+    float weight = 1.f;
+    span<const math::SimdFloat4> joint_weights;
+  };
+
+  // Defines a character update.
+  struct OZZ_ANIMATION_DLL Character {
+    // Skeleton of the character.
+    const Skeleton* skeleton = nullptr;
+
+    // Normal and additive animation layers, see BlendingJob. Blending is
+    // skipped if there's a single normal layer, with no additive layer and no
+    // per-joint weight.
+    span<const Layer> layers;
+    span<const Layer> additive_layers;
+
+    // Output model-space matrices.
+    span<math::Float4x4> models;
+
+    // Optional skinning matrices computation. When skinning_matrices isn't
+    // empty, skinning_matrices[i] = models[joint_remaps[i]] *
+    // inverse_bind_poses[i].
+    span<const math::Float4x4> inverse_bind_poses;
+    span<const uint16_t> joint_remaps;
+    span<math::Float4x4> skinning_matrices;
+  };
+
+  // Enumerates update stages.
+  enum Stage {
+    kSampling,
+    kBlending,
+    kLocalToModel,
+    kSkinningMatrices,
+    kNumStages,
+  };
+
+  // Characters to update.
+  span<const Character> characters;
+
+  // Blending threshold, see BlendingJob::threshold.
+  float threshold = .1f;
+
+  // Scheduler used to run character updates concurrently. Runs on the calling
+  // thread if nullptr.
+  Scheduler* scheduler = nullptr;
+
+  // Minimum number of characters updated by a scheduler task.
+  int grain_size = 1;
+
+  // Forward declares the context object used by the CharacterUpdateJob.
+  class Context;
+
+  // A context object that must be big enough for all characters.
+  Context* context = nullptr;
+
+  // Optional output of the time spent in each stage, in seconds, summed over
+  // all characters (and thus over all workers). Timings are only measured
+  // when this pointer isn't nullptr.
+  struct Timings {
+    double stages[kNumStages];
+  };
+  Timings* timings = nullptr;
+};
+
+// Declares the context object used by the CharacterUpdateJob. It owns the
+// scratch buffers used by each scheduler worker to update characters.
+class OZZ_ANIMATION_DLL CharacterUpdateJob::Context {
+ public:
+  // Constructs an empty context. The context needs to be resized before it
+  // can be used with a CharacterUpdateJob.
+  Context();
+
+  // Constructs a context that can be used to update characters with at most
+  // _max_joints joints and _max_layers layers (normal and additive), with an
+  // scheduler of at most _max_workers workers.
+  Context(int _max_joints, int _max_layers, int _max_workers);
+
+  // Disables copy and assignation.
+  Context(const Context&) = delete;
+  Context& operator=(const Context&) = delete;
+  Context(Context&&) = delete;
+  Context& operator=(Context&&) = delete;
+
+  // Deallocates context.
+  ~Context();
+
+  // Resize the context capacity, see constructor.
+  void Resize(int _max_joints, int _max_layers, int _max_workers);
+
+  // Context capacity.
+  int max_soa_joints() const { return max_soa_joints_; }
+  int max_layers() const { return max_layers_; }
+  int max_workers() const { return max_workers_; }
+
+ private:
+  friend struct CharacterUpdateJob;
+
+  void Deallocate();
+
+  int max_soa_joints_ = 0;
+  int max_layers_ = 0;
+  int max_workers_ = 0;
+
+  // Single allocation for the whole context.
+  void* allocation_ = nullptr;
+
+  // Scratch buffers of all workers. Every worker has max_layers_ + 1
+  // buffers of max_soa_joints_ elements, the last one being blending output.
+  span<math::SoaTransform> locals_;
+
+  // Stages timings of all workers, kNumStages per worker.
+  span<double> timings_;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_CHARACTER_UPDATE_JOB_H_
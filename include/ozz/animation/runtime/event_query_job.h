@@ -0,0 +1,97 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_EVENT_QUERY_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_EVENT_QUERY_JOB_H_
+
+#include <cstddef>
+
+#include "ozz/animation/runtime/export.h"
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace animation {
+
+class TrackEventIndex;
+
+// Queries the edges (events) of many tracks at once from a precomputed
+// TrackEventIndex. Each query is a [from,to) range on one of the index tracks,
+// typically the ratios an instance (character, agent...) played since the
+// previous frame. Many queries can refer to the same track.
+// Edges are found with a binary search in the track sorted edges, and are
+// reported exactly as TrackTriggeringJob would for the same range:
+// - if difference between from and to is greater than 1, the track edges are
+// reported as many times as it loops.
+// - if from is greater than to, then the track is processed backward (rising
+// edges in forward become falling ones).
+// Events are written to a caller-provided buffer, in queries order, then in
+// playback order for each query.
+struct OZZ_ANIMATION_DLL EventQueryJob {
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if index or num_events is nullptr.
+  // -if a query track is out of index tracks range.
+  bool Validate() const;
+
+  // Validates and executes job.
+  bool Run() const;
+
+  // Job input.
+
+  // Precomputed events index.
+  const TrackEventIndex* index = nullptr;
+
+  // Query of the events of a track, in range [from,to). 0 is the beginning of
+  // the track, 1 is the end. from and to can be of any sign, any order, and
+  // any range, see TrackTriggeringJob.
+  struct Query {
+    int track;  // Index of the track in TrackEventIndex.
+    float from;
+    float to;
+  };
+  span<const Query> queries;
+
+  // Job output.
+
+  // Structure of an event as found by the job.
+  struct Event {
+    float ratio;  // Ratio of the edge, in queried from/to ratio space.
+    bool rising;  // true is edge is rising (getting higher than threshold).
+    int query;    // Index of the query this event was found for.
+  };
+
+  // Events output buffer. If it's too small, only the first events are
+  // written, which can be detected by comparing num_events to its size.
+  span<Event> events;
+
+  // Total number of events found, which can be greater than events size.
+  size_t* num_events = nullptr;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_EVENT_QUERY_JOB_H_
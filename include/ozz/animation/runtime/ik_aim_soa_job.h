@@ -0,0 +1,121 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_IK_AIM_SOA_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_IK_AIM_SOA_JOB_H_
+
+#include "ozz/animation/runtime/export.h"
+#include "ozz/animation/runtime/ik_aim_job.h"
+#include "ozz/base/maths/soa_float.h"
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+// Forward declaration of math structures.
+namespace math {
+struct SoaFloat4x4;
+struct SoaQuaternion;
+}  // namespace math
+
+namespace animation {
+
+// ozz::animation::IKAimSoaJob is the soa version of IKAimJob. It aims four
+// independent joints at once, one per soa lane, using the same algorithm as
+// IKAimJob. Every parameter that is a scalar or a vector in IKAimJob is thus a
+// SimdFloat4 or a SoaFloat3 here, where each component/lane is the value for
+// one of the four joints.
+struct OZZ_ANIMATION_DLL IKAimSoaJob {
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if any input or output pointer is nullptr
+  // -if any lane of forward isn't normalized.
+  bool Validate() const;
+
+  // Runs job's execution task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Job input. See IKAimJob for details about each parameter.
+
+  // Target positions to aim at, in model-space
+  math::SoaFloat3 target = math::SoaFloat3::zero();
+
+  // Normalized joint forward axes, in joint local-space.
+  math::SoaFloat3 forward = math::SoaFloat3::x_axis();
+
+  // Offset positions from the joints in local-space, that will aim at target.
+  math::SoaFloat3 offset = math::SoaFloat3::zero();
+
+  // Joint up axes, in joint local-space.
+  math::SoaFloat3 up = math::SoaFloat3::y_axis();
+
+  // Pole vectors, in model-space.
+  math::SoaFloat3 pole_vector = math::SoaFloat3::y_axis();
+
+  // Twist angles, in radian.
+  math::SimdFloat4 twist_angle = math::simd_float4::zero();
+
+  // Weights given to the IK correction clamped in range [0,1].
+  math::SimdFloat4 weight = math::simd_float4::one();
+
+  // Joints model-space matrices.
+  const math::SoaFloat4x4* joint = nullptr;
+
+  // Job output.
+
+  // Output local-space joints correction quaternions.
+  math::SoaQuaternion* joint_correction = nullptr;
+
+  // Optional output mask, set to true (0xffffffff) for the lanes whose target
+  // can be reached. See IKAimJob::reached.
+  math::SimdInt4* reached = nullptr;
+};
+
+// ozz::animation::IKAimBatchJob aims any number of joints, described as
+// IKAimJob, with IKAimSoaJob. Joints are transposed to soa four by four, so IK
+// cost scales with simd width rather than with the number of jobs. The last
+// batch is padded if the number of joints isn't a multiple of four.
+// Outputs are written to each IKAimJob output pointers, the same way
+// IKAimJob::Run() would.
+struct OZZ_ANIMATION_DLL IKAimBatchJob {
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if any of the joints isn't valid, see IKAimJob::Validate().
+  bool Validate() const;
+
+  // Runs job's execution task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Joints to aim, including their outputs.
+  span<const IKAimJob> joints;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_IK_AIM_SOA_JOB_H_
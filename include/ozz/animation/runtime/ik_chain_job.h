@@ -0,0 +1,147 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_IK_CHAIN_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_IK_CHAIN_JOB_H_
+
+#include "ozz/animation/runtime/export.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+// Forward declaration of math structures.
+namespace math {
+struct SimdQuaternion;
+}
+
+namespace animation {
+
+// ozz::animation::IKChainJob performs inverse kinematic on a chain of any
+// number of joints (spines, tails, tentacles...), such that the last joint of
+// the chain (named end) reaches the provided target position (if possible).
+// The job works directly on model-space matrices, as output by
+// LocalToModelJob, and outputs a local-space rotation correction for each joint
+// of the chain.
+// Chain joints must be ancestors, ordered from the root to the end of the
+// chain. They don't need to be direct ancestors though (joints in-between will
+// simply remain fixed).
+// The chain is solved iteratively, with either Cyclic Coordinate Descent (CCD)
+// or Forward And Backward Reaching Inverse Kinematic (FABRIK) algorithm. The
+// solver stops as soon as the end joint is within tolerance of the target, or
+// when the maximum number of iterations is reached. Corrections are then
+// deduced from the solved joint positions, as the shortest rotations that
+// align each joint with its child. Hence joints aren't twisted.
+struct OZZ_ANIMATION_DLL IKChainJob {
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if the chain has less than 2 joints.
+  // -if chain indices aren't strictly increasing, or are out of models range.
+  // -if joint_weights isn't empty and doesn't have the same size as chain.
+  // -if joint_corrections doesn't have the same size as chain.
+  // -if max_iterations or tolerance are negative.
+  bool Validate() const;
+
+  // Runs job's execution task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Job input.
+
+  // Chain solving algorithms.
+  enum Solver {
+    // Cyclic Coordinate Descent rotates each joint, from the end to the root,
+    // so the end joint points toward the target. It favors joints close to
+    // the end of the chain, and converges in few iterations for short chains.
+    kCCD,
+    // Forward And Backward Reaching Inverse Kinematic moves joints positions
+    // along the chain, alternatively from the end (placed at target) and from
+    // the root (placed back at its position), while preserving bones length.
+    // It distributes the bending along the whole chain, and usually converges
+    // faster than CCD on long chains.
+    kFABRIK,
+  };
+  Solver solver = kCCD;
+
+  // Target IK position, in model-space. This is the position the end of the
+  // joint chain will try to reach.
+  math::SimdFloat4 target = math::simd_float4::zero();
+
+  // Maximum number of solver iterations. An iteration is a complete pass over
+  // the chain.
+  int max_iterations = 10;
+
+  // Distance from the target under which the end joint is considered to have
+  // reached it, which stops the iterations.
+  float tolerance = 1e-3f;
+
+  // Weight given to the IK correction clamped in range [0,1]. This allows to
+  // blend / interpolate from no IK applied (0 weight) to full IK (1).
+  float weight = 1.f;
+
+  // Model-space matrices of the skeleton joints, as output by LocalToModelJob.
+  span<const math::Float4x4> models;
+
+  // Indices of the chain joints in models, from the root to the end of the
+  // chain. As joints must be ancestors, indices must be strictly increasing
+  // (see Skeleton joints order).
+  span<const int> chain;
+
+  // Optional per chain joint weights, in range [0,1]. Chain joints with a
+  // weight of 0 aren't rotated, the others are rotated with a ratio of their
+  // weight. With CCD, weights are applied at each iteration, so the remaining
+  // joints can still reach the target. With FABRIK, they're applied to the
+  // solved corrections. The end joint weight is unused, as the end joint
+  // isn't rotated.
+  span<const float> joint_weights;
+
+  // Job output.
+
+  // Local-space corrections to apply to chain joints, in chain order, in order
+  // for the end joint to reach target position. These quaternions must be
+  // multiplied to the local-space quaternion of their respective joints. The
+  // end joint correction is always identity.
+  // The buffer is also used to store joints positions while solving the chain,
+  // so the job doesn't require any allocation.
+  span<math::SimdQuaternion> joint_corrections;
+
+  // Optional boolean output value, set to true if target is reached once
+  // corrections are applied. Target is considered unreached if weight is less
+  // than 1.
+  bool* reached = nullptr;
+
+  // Optional output number of iterations that were run.
+  int* iterations = nullptr;
+
+  // Optional output distance from the end joint to the target, once
+  // corrections are applied.
+  float* distance = nullptr;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_IK_CHAIN_JOB_H_
@@ -0,0 +1,128 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_IK_TWO_BONE_SOA_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_IK_TWO_BONE_SOA_JOB_H_
+
+#include "ozz/animation/runtime/export.h"
+#include "ozz/animation/runtime/ik_two_bone_job.h"
+#include "ozz/base/maths/soa_float.h"
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+// Forward declaration of math structures.
+namespace math {
+struct SoaFloat4x4;
+struct SoaQuaternion;
+}  // namespace math
+
+namespace animation {
+
+// ozz::animation::IKTwoBoneSoaJob is the soa version of IKTwoBoneJob. It
+// solves four independent two bone chains at once, one per soa lane, using the
+// same algorithm as IKTwoBoneJob. Every parameter that is a scalar or a vector
+// in IKTwoBoneJob is thus a SimdFloat4 or a SoaFloat3 here, where each
+// component/lane is the value for one of the four chains. Chains don't need to
+// share anything, they can belong to different skeletons or characters.
+// Conditional parts of the algorithm (softening, twisting, weighting...) are
+// computed for all lanes and selected per lane, so the cost of a job doesn't
+// depend on the chains configuration.
+struct OZZ_ANIMATION_DLL IKTwoBoneSoaJob {
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if any input pointer is nullptr
+  // -if any lane of mid_axis isn't normalized.
+  bool Validate() const;
+
+  // Runs job's execution task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Job input. See IKTwoBoneJob for details about each parameter.
+
+  // Target IK positions, in model-space.
+  math::SoaFloat3 target = math::SoaFloat3::zero();
+
+  // Normalized middle joint rotation axes, in middle joint local-space.
+  math::SoaFloat3 mid_axis = math::SoaFloat3::z_axis();
+
+  // Pole vectors, in model-space.
+  math::SoaFloat3 pole_vector = math::SoaFloat3::y_axis();
+
+  // Twist angles, in radian.
+  math::SimdFloat4 twist_angle = math::simd_float4::zero();
+
+  // Soften ratios.
+  math::SimdFloat4 soften = math::simd_float4::one();
+
+  // Weights given to the IK correction clamped in range [0,1].
+  math::SimdFloat4 weight = math::simd_float4::one();
+
+  // Model-space matrices of the start, middle and end joints of the four
+  // chains.
+  const math::SoaFloat4x4* start_joint = nullptr;
+  const math::SoaFloat4x4* mid_joint = nullptr;
+  const math::SoaFloat4x4* end_joint = nullptr;
+
+  // Job output.
+
+  // Local-space corrections to apply to start and middle joints of the four
+  // chains.
+  math::SoaQuaternion* start_joint_correction = nullptr;
+  math::SoaQuaternion* mid_joint_correction = nullptr;
+
+  // Optional output mask, set to true (0xffffffff) for the lanes whose target
+  // can be reached. See IKTwoBoneJob::reached.
+  math::SimdInt4* reached = nullptr;
+};
+
+// ozz::animation::IKTwoBoneBatchJob solves any number of two bone chains,
+// described as IKTwoBoneJob, with IKTwoBoneSoaJob. Chains are transposed to soa
+// four by four, so IK cost scales with simd width rather than with the number
+// of jobs. The last batch is padded if the number of chains isn't a multiple of
+// four.
+// Outputs are written to each IKTwoBoneJob output pointers, the same way
+// IKTwoBoneJob::Run() would.
+struct OZZ_ANIMATION_DLL IKTwoBoneBatchJob {
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if any of the chains isn't valid, see IKTwoBoneJob::Validate().
+  bool Validate() const;
+
+  // Runs job's execution task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Chains to solve, including their outputs.
+  span<const IKTwoBoneJob> chains;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_IK_TWO_BONE_SOA_JOB_H_
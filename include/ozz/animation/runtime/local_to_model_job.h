@@ -41,8 +41,12 @@ struct SoaTransform;
 }
 namespace math {
 struct Float4x4;
+struct Float3x4;
 }
 
+// Forward declare scheduler interface.
+class Scheduler;
+
 namespace animation {
 
 // Forward declares the Skeleton object used to describe joint hierarchy.
@@ -57,13 +61,29 @@ class Skeleton;
 // ordered like skeleton's joints. Output are matrices, because the combination
 // of affine transformations can contain shearing or complex transformation
 // that cannot be represented as Transform object.
+// Model-space matrices can alternatively (or additionally) be output as 3x4
+// affine matrices, which are 25% smaller and are usually what gpu skinning
+// palettes expect. Affine output requires root matrix to be affine too.
+// Independent sub-hierarchies (multiple characters in one skeleton, limbs...)
+// can be updated concurrently by providing a scheduler. Skeleton joints being
+// ordered depth-first, every sub-hierarchy is a contiguous range of joints.
+// Joints that sub-hierarchies depend on are updated first, on the calling
+// thread. Skeletons that aren't ordered depth-first are updated on the calling
+// thread.
+// Groups of 4 joints whose parents are all outside of the group are multiplied
+// at once in soa format. This is mostly the case for skeletons sorted by depth,
+// see SkeletonBuilder::JointOrder.
 struct OZZ_ANIMATION_DLL LocalToModelJob {
   // Validates job parameters. Returns true for a valid job, or false otherwise:
   // -if any input pointer, including ranges, is nullptr.
   // -if the size of the input is smaller than the skeleton's number of joints.
   // Note that this input has a SoA format.
   // -if the size of of the output is smaller than the skeleton's number of
-  // joints.
+  // joints. output can be empty if output_affine is provided.
+  // -if output_affine is provided but its size is smaller than the skeleton's
+  // number of joints.
+  // -if grain_size isn't greater than 0.
+  // -if dirty is provided but is smaller than one bit per joint.
   bool Validate() const;
 
   // Runs job's local-to-model task.
@@ -84,6 +104,8 @@ struct OZZ_ANIMATION_DLL LocalToModelJob {
   const ozz::math::Float4x4* root = nullptr;
 
   // Defines "from" which joint the local-to-model conversion should start.
+  // "from" and "to" parameters require skeleton joints to be ordered
+  // depth-first.
   // Default value is ozz::Skeleton::kNoParent, meaning the whole hierarchy is
   // updated. This parameter can be used to optimize update by limiting
   // conversion to part of the joint hierarchy. Note that "from" parent should
@@ -109,10 +131,33 @@ struct OZZ_ANIMATION_DLL LocalToModelJob {
   // The input range that store local transforms.
   span<const ozz::math::SoaTransform> input;
 
+  // Optional set of dirty joints, one bit per joint: joint i is dirty if bit
+  // (i & 7) of byte i / 8 is set. If provided, only dirty joints and their
+  // descendants are updated, output matrices of other joints are left
+  // untouched. They must hence already store valid model-space matrices, from
+  // a previous update for example. Root joints must be flagged dirty if root
+  // matrix changes.
+  span<const byte> dirty;
+
   // Job output.
 
-  // The output range to be filled with model-space matrices.
+  // The output range to be filled with model-space matrices. Optional if
+  // output_affine is provided.
   span<ozz::math::Float4x4> output;
+
+  // The output range to be filled with model-space 3x4 affine matrices.
+  // Optional if output is provided. If both are provided, both are filled.
+  span<ozz::math::Float3x4> output_affine;
+
+  // Job execution settings.
+
+  // Optional scheduler used to update independent sub-hierarchies
+  // concurrently. Runs on the calling thread if nullptr.
+  Scheduler* scheduler = nullptr;
+
+  // Sub-hierarchies with less than grain_size joints aren't split further to
+  // be dispatched to the scheduler. Must be greater than 0.
+  int grain_size = 64;
 };
 }  // namespace animation
 }  // namespace ozz
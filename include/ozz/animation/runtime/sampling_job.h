@@ -57,6 +57,8 @@ struct OZZ_ANIMATION_DLL SamplingJob {
   // Validates job parameters. Returns true for a valid job, or false otherwise:
   // -if any input pointer is nullptr
   // -if output range is invalid.
+  // -if constant or changed ranges are not empty and too small to store one
+  // bit per sampled soa track.
   bool Validate() const;
 
   // Runs job's sampling task.
@@ -88,12 +90,37 @@ struct OZZ_ANIMATION_DLL SamplingJob {
   // If there are more joints in the animation, then the last joints are not
   // sampled.
   span<ozz::math::SoaTransform> output;
+
+  // Optional job output.
+  // Bitset of soa tracks whose translation, rotation and scale are constant
+  // over the current key interval (held keys, or identical left and right
+  // keys), meaning their sampled value doesn't depend on the ratio. Bit i & 7
+  // of byte i / 8 is set for soa track i (4 joints per bit). It is written for
+  // the min(output.size(), num_soa_tracks) first soa tracks, remaining bits of
+  // the last byte are cleared. A constant soa track can still change when its
+  // key interval changes, see changed output.
+  // If empty, constant flags are not written.
+  span<byte> constant;
+
+  // Optional job output.
+  // Bitset of soa tracks whose sampled value may differ from the one output by
+  // the previous run with the same context: soa tracks that aren't constant
+  // (see constant output), or whose keys were decompressed during this run
+  // (key interval changed, context invalidated or bound to a new animation).
+  // Soa tracks that aren't flagged are guaranteed to output the same value
+  // as the previous run. Bits layout is the same as constant output. Each bit
+  // covers 4 joints, so it must be expanded to one bit per joint to be used as
+  // LocalToModelJob::dirty.
+  // If empty, changed flags are not written.
+  span<byte> changed;
 };
 
 namespace internal {
 // Soa hot data to interpolate.
 struct InterpSoaFloat3;
 struct InterpSoaQuaternion;
+struct TangentSoaFloat3;
+struct TangentSoaQuaternion;
 }  // namespace internal
 
 // Declares the context object used by the workload to take advantage of the
@@ -145,6 +172,10 @@ class OZZ_ANIMATION_DLL SamplingJob::Context {
     // Outdated soa entries. One bit per soa entry (32 joints per byte).
     span<byte> outdated;
 
+    // Soa entries whose left and right keys are identical. One bit per soa
+    // entry, updated when an outdated entry is decompressed.
+    span<byte> constant;
+
     // Next key to process in the animation.
     uint32_t next;
   };
@@ -178,10 +209,22 @@ class OZZ_ANIMATION_DLL SamplingJob::Context {
   Cache rotations_cache_;
   Cache scales_cache_;
 
+  // Context cache instances for quantized keyframes of each component. Their
+  // constant flags are shared with the above caches, as they're indexed by
+  // output soa track.
+  Cache translations_quantized_cache_;
+  Cache rotations_quantized_cache_;
+  Cache scales_quantized_cache_;
+
   // SoA hot decompressed data to interpolate.
   span<internal::InterpSoaFloat3> translations_;
   span<internal::InterpSoaQuaternion> rotations_;
   span<internal::InterpSoaFloat3> scales_;
+
+  // SoA hot decompressed tangents, for hermite interpolated keyframes.
+  span<internal::TangentSoaFloat3> translations_tangents_;
+  span<internal::TangentSoaQuaternion> rotations_tangents_;
+  span<internal::TangentSoaFloat3> scales_tangents_;
 };
 }  // namespace animation
 }  // namespace ozz
@@ -37,6 +37,7 @@ namespace ozz {
 namespace io {
 class IArchive;
 class OArchive;
+class Stream;
 }  // namespace io
 namespace math {
 struct SoaTransform;
@@ -57,7 +58,8 @@ class SkeletonBuilder;
 // packed as an array of parent jont indices (16 bits), stored in depth-first
 // order. This is enough to traverse the whole joint hierarchy. See
 // IterateJointsDF() from skeleton_utils.h that implements a depth-first
-// traversal utility.
+// traversal utility. SkeletonBuilder can optionally sort joints by depth
+// instead, see SkeletonBuilder::JointOrder.
 class OZZ_ANIMATION_DLL Skeleton {
  public:
   // Defines Skeleton constant values.
@@ -118,6 +120,25 @@ class OZZ_ANIMATION_DLL Skeleton {
   void Save(ozz::io::OArchive& _archive) const;
   void Load(ozz::io::IArchive& _archive, uint32_t _version);
 
+  // Image functions.
+  // An image is a flat binary copy of the skeleton rest poses and parents,
+  // followed by joint names stored as offsets in a characters buffer, so that
+  // image content doesn't need relocation. Like animation images, skeleton
+  // images are neither endian swapped nor compatible across versions.
+  // MapImage() makes rest poses, parents and names point directly to image
+  // memory. Only the array of joint name pointers is allocated and fixed up.
+
+  // Writes *this skeleton image to _stream.
+  // Returns true on success.
+  bool SaveImage(ozz::io::Stream& _stream) const;
+
+  // Initializes *this skeleton from _image, without copying skeleton data.
+  // _image memory must be aligned to 16 bytes (alignof(math::SoaTransform)),
+  // and remain valid and unchanged during *this skeleton lifetime.
+  // Returns false if _image isn't a valid image for this platform, in which
+  // case *this skeleton is left empty.
+  bool MapImage(span<const byte> _image);
+
  private:
   // Internal allocation/deallocation function.
   // Allocate returns the beginning of the contiguous buffer of names.
@@ -127,7 +148,8 @@ class OZZ_ANIMATION_DLL Skeleton {
   // SkeletonBuilder class is allowed to instantiate an Skeleton.
   friend class offline::SkeletonBuilder;
 
-  // Allocation for the whole skeleton.
+  // Allocation for the whole skeleton, or only for joint_names_ array if
+  // skeleton data is mapped from an image.
   void* allocation_ = nullptr;
 
   // Buffers below store joint informations in joing depth first order. Their
@@ -0,0 +1,181 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_STREAMING_ANIMATION_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_STREAMING_ANIMATION_H_
+
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/export.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/io/archive_traits.h"
+#include "ozz/base/platform.h"
+
+namespace ozz {
+namespace io {
+class IArchive;
+class OArchive;
+class Stream;
+}  // namespace io
+namespace animation {
+
+// Forward declares the StreamingAnimationBuilder, used to instantiate a
+// StreamingAnimation.
+namespace offline {
+class StreamingAnimationBuilder;
+}
+
+// Defines a runtime animation clip split into consecutive chunks of fixed
+// duration, each chunk being a standalone Animation. Chunks are loaded on
+// demand from a stream, allowing to sample a long clip while keeping only
+// a bounded number of chunks in memory.
+// Loading a StreamingAnimation from an archive only reads its header. The
+// archive stream is retained, as chunks are read from it later on, when
+// they're acquired. It must thus remain opened during *this object lifetime.
+// Sampling is done by acquiring the chunk that covers a ratio, and using it
+// with a SamplingJob. Every chunk has its own Animation object, so a
+// SamplingJob::Context is automatically invalidated when playback moves to
+// another chunk. Acquired chunks must not be used once evicted, as their
+// animation is then emptied.
+class OZZ_ANIMATION_DLL StreamingAnimation {
+ public:
+  // Builds a default streaming animation.
+  StreamingAnimation();
+
+  // Allow moves.
+  StreamingAnimation(StreamingAnimation&&);
+  StreamingAnimation& operator=(StreamingAnimation&&);
+
+  // Delete copies.
+  StreamingAnimation(StreamingAnimation const&) = delete;
+  StreamingAnimation& operator=(StreamingAnimation const&) = delete;
+
+  // Declares the public non-virtual destructor.
+  ~StreamingAnimation();
+
+  // Gets the animation clip duration.
+  float duration() const { return duration_; }
+
+  // Gets the duration of each chunk. The last chunk can be shorter.
+  float chunk_duration() const { return chunk_duration_; }
+
+  // Gets the number of animated tracks.
+  int num_tracks() const { return num_tracks_; }
+
+  // Returns the number of SoA elements matching the number of tracks of *this
+  // animation. This value is useful to allocate SoA runtime data structures.
+  int num_soa_tracks() const { return (num_tracks_ + 3) / 4; }
+
+  // Gets the number of chunks.
+  int num_chunks() const { return static_cast<int>(chunks_.size()); }
+
+  // Gets the index of the chunk covering _ratio, clamped to [0,1] range.
+  int chunk_index(float _ratio) const;
+
+  // Gets and sets the maximum number of chunks kept loaded at the same time,
+  // which bounds memory usage. Least recently acquired chunks are evicted
+  // first. Default is 2, which allows to prefetch the next chunk while
+  // sampling the current one.
+  int max_resident_chunks() const { return max_resident_chunks_; }
+  void set_max_resident_chunks(int _max);
+
+  // Gets the number of chunks currently loaded.
+  int num_resident_chunks() const;
+
+  // Tests if chunk _index is loaded.
+  bool resident(int _index) const;
+
+  // Loads chunk _index if it isn't yet, evicting least recently acquired
+  // chunks to honor the budget. Can be used to prefetch the next chunk.
+  // Returns false if the chunk can't be read from the stream.
+  bool Load(int _index);
+
+  // Gets the chunk covering _ratio, loading it if needed. _chunk_ratio is set
+  // to the ratio to use to sample the returned chunk.
+  // Returns nullptr if the chunk can't be loaded.
+  const Animation* Acquire(float _ratio, float* _chunk_ratio);
+
+  // Serialization functions.
+  // Should not be called directly but through io::Archive << and >> operators.
+  // Saving requires all chunks to be loaded, which is the case of a streaming
+  // animation output by the StreamingAnimationBuilder.
+  void Save(ozz::io::OArchive& _archive) const;
+  void Load(ozz::io::IArchive& _archive, uint32_t _version);
+
+ private:
+  // StreamingAnimationBuilder class is allowed to instantiate an animation.
+  friend class offline::StreamingAnimationBuilder;
+
+  // Frees all chunks and resets members.
+  void Reset();
+
+  // Evicts least recently used chunks, but _keep, to fit within the budget.
+  void Evict(int _keep, int _budget);
+
+  struct Chunk {
+    // Chunk offset from stream base position.
+    uint32_t offset = 0;
+
+    // Chunk animation, empty if not loaded.
+    Animation animation;
+
+    // Last acquisition stamp, used to evict least recently used chunks.
+    uint32_t last_use = 0;
+
+    // Is chunk loaded.
+    bool loaded = false;
+  };
+
+  // Duration of the animation clip.
+  float duration_ = 0.f;
+
+  // Duration of each chunk.
+  float chunk_duration_ = 0.f;
+
+  // The number of joint tracks.
+  int num_tracks_ = 0;
+
+  // Maximum number of loaded chunks.
+  int max_resident_chunks_ = 2;
+
+  // Incremented on every acquisition.
+  uint32_t stamp_ = 0;
+
+  // Stream chunks are loaded from, and stream position of the first chunk.
+  ozz::io::Stream* stream_ = nullptr;
+  int base_ = 0;
+
+  // Chunks, in time order.
+  ozz::vector<Chunk> chunks_;
+};
+}  // namespace animation
+
+namespace io {
+OZZ_IO_TYPE_VERSION(1, animation::StreamingAnimation)
+OZZ_IO_TYPE_TAG("ozz-streaming_animation", animation::StreamingAnimation)
+}  // namespace io
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_STREAMING_ANIMATION_H_
@@ -0,0 +1,120 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_TRACK_EVENT_INDEX_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_TRACK_EVENT_INDEX_H_
+
+#include "ozz/animation/runtime/export.h"
+#include "ozz/base/io/archive_traits.h"
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace animation {
+
+// Forward declares the TrackBuilder, used to instantiate a TrackEventIndex.
+namespace offline {
+class TrackBuilder;
+}
+
+// Runtime precomputed table of the edges of a set of FloatTrack, aka the
+// events (footsteps, sounds, vfx...) TrackTriggeringJob would detect for a
+// given threshold.
+// Edges of each track are computed once by offline::TrackBuilder, for a single
+// loop of the track, and stored sorted by ratio. This allows EventQueryJob to
+// find the edges of any [from,to) range with a binary search, rather than
+// walking and un-lerping track keyframes every time.
+// Edges of all tracks are stored contiguously, track i edges are in range
+// [offsets()[i], offsets()[i + 1]) of ratios() and rising() buffers.
+class OZZ_ANIMATION_DLL TrackEventIndex {
+ public:
+  TrackEventIndex() = default;
+
+  // Allow move.
+  TrackEventIndex(TrackEventIndex&& _other);
+  TrackEventIndex& operator=(TrackEventIndex&& _other);
+
+  // Disables copy and assignation.
+  TrackEventIndex(TrackEventIndex const&) = delete;
+  void operator=(TrackEventIndex const&) = delete;
+
+  ~TrackEventIndex();
+
+  // Number of indexed tracks.
+  int num_tracks() const {
+    return offsets_.empty() ? 0 : static_cast<int>(offsets_.size() - 1);
+  }
+
+  // Threshold value edges were detected with, see TrackTriggeringJob.
+  float threshold() const { return threshold_; }
+
+  // Edges accessors.
+  span<const uint32_t> offsets() const { return offsets_; }
+  span<const float> ratios() const { return ratios_; }
+  span<const uint8_t> rising() const { return rising_; }
+
+  // Get the estimated index's size in bytes.
+  size_t size() const;
+
+  // Serialization functions.
+  // Should not be called directly but through io::Archive << and >> operators.
+  void Save(ozz::io::OArchive& _archive) const;
+  void Load(ozz::io::IArchive& _archive, uint32_t _version);
+
+ private:
+  // TrackBuilder class is allowed to allocate a TrackEventIndex.
+  friend class offline::TrackBuilder;
+
+  // Internal allocation / destruction functions.
+  void Allocate(size_t _num_tracks, size_t _num_edges);
+  void Deallocate();
+
+  // Allocation for the whole index.
+  void* allocation_ = nullptr;
+
+  // Edge detection threshold.
+  float threshold_ = 0.f;
+
+  // Offsets of each track first edge, plus the total number of edges.
+  span<uint32_t> offsets_;
+
+  // Edge ratios (0 is the beginning of the track, 1 is the end), sorted per
+  // track.
+  span<float> ratios_;
+
+  // Edge directions (1 bit per edge): 1 for rising, 0 for falling, in forward
+  // direction.
+  span<uint8_t> rising_;
+};
+}  // namespace animation
+namespace io {
+OZZ_IO_TYPE_VERSION(1, animation::TrackEventIndex)
+OZZ_IO_TYPE_TAG("ozz-track_event_index", animation::TrackEventIndex)
+}  // namespace io
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_TRACK_EVENT_INDEX_H_
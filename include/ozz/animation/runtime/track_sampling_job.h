@@ -30,12 +30,22 @@
 
 #include "ozz/animation/runtime/export.h"
 #include "ozz/animation/runtime/track.h"
+#include "ozz/base/maths/soa_float.h"
+#include "ozz/base/span.h"
 
 namespace ozz {
 namespace animation {
 
+class TrackSamplingContext;
+
 namespace internal {
 
+// Finds the index of the last key whose ratio is less or equal to _ratio, using
+// and updating _context cache if it isn't nullptr. _ratios must have at least 2
+// keys, and _ratio must be in range ]0,1[.
+size_t FindTrackKey(const void* _track, span<const float> _ratios,
+                    float _ratio, TrackSamplingContext* _context);
+
 // TrackSamplingJob internal implementation. See *TrackSamplingJob for more
 // details.
 template <typename _Track>
@@ -56,11 +66,81 @@ struct TrackSamplingJob {
   // Track to sample.
   const _Track* track = nullptr;
 
+  // Optional context, used to find keys in constant time when the track is
+  // sampled forward. See TrackSamplingContext.
+  TrackSamplingContext* context = nullptr;
+
   // Job output.
   typename _Track::ValueType* result = nullptr;
 };
+
+// TrackBatchSamplingJob internal implementation. See *TrackBatchSamplingJob
+// for more details.
+template <typename _Track, typename _SoaValue>
+struct TrackBatchSamplingJob {
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if any track is nullptr.
+  // -if ratios size is neither 1, nor tracks size.
+  // -if contexts isn't empty and doesn't have the same size as tracks.
+  // -if results is too small to store one soa lane per track.
+  bool Validate() const;
+
+  // Validates and executes sampling.
+  bool Run() const;
+
+  // Tracks to sample.
+  span<const _Track* const> tracks;
+
+  // Ratios used to sample tracks, clamped in range [0,1] before job execution.
+  // Either a single ratio, shared by all tracks, or one ratio per track.
+  span<const float> ratios;
+
+  // Optional contexts, one per track, used to find keys in constant time when
+  // tracks are sampled forward. See TrackSamplingContext.
+  span<TrackSamplingContext> contexts;
+
+  // Job output.
+  // Track i value is stored in lane i % 4 of soa result i / 4. Lanes that
+  // remain after the last track are set to 0.
+  span<_SoaValue> results;
+};
 }  // namespace internal
 
+// Declares the context object used by track sampling jobs to take advantage of
+// the frame coherency of track sampling. It caches the key interval of the last
+// sampled ratio, so that the next one is found in constant time when the track
+// is sampled forward, as keys are mostly played one after the other. Sampling
+// backward, or jumping far forward, falls back to a binary search in the keys
+// before or after the cached interval.
+// A context refers to a single track at a time. It's small and copyable, so
+// one context can be stored per sampled track instance.
+class OZZ_ANIMATION_DLL TrackSamplingContext {
+ public:
+  // Invalidate the context.
+  // Track sampling jobs automatically invalidate a context when it's used with
+  // a different track address. As for SamplingJob::Context, this can fail if
+  // the address of a track is used again with another track (could be the
+  // result of successive call to delete / new). Therefore it is recommended to
+  // manually invalidate a context in such cases.
+  void Invalidate() {
+    track_ = nullptr;
+    key_ = 0;
+  }
+
+ private:
+  friend size_t internal::FindTrackKey(const void* _track,
+                                       span<const float> _ratios, float _ratio,
+                                       TrackSamplingContext* _context);
+
+  // The track this context refers to. nullptr means that the context is
+  // invalid.
+  const void* track_ = nullptr;
+
+  // Index of the last key whose ratio is less or equal to the last sampled
+  // ratio.
+  size_t key_ = 0;
+};
+
 // Track sampling job implementation. Track sampling allows to query a track
 // value for a specified ratio. This is a ratio rather than a time because
 // tracks have no duration.
@@ -75,6 +155,15 @@ struct OZZ_ANIMATION_DLL Float4TrackSamplingJob
 struct OZZ_ANIMATION_DLL QuaternionTrackSamplingJob
     : public internal::TrackSamplingJob<QuaternionTrack> {};
 
+// Track batch sampling job implementation. It samples many tracks at once, each
+// one at its own ratio (or at a shared one), and stores values to SoA outputs
+// interpolated 4 tracks at a time. This suits the many user-channel tracks of
+// many characters that are sampled every frame.
+struct OZZ_ANIMATION_DLL FloatTrackBatchSamplingJob
+    : public internal::TrackBatchSamplingJob<FloatTrack, math::SimdFloat4> {};
+struct OZZ_ANIMATION_DLL Float3TrackBatchSamplingJob
+    : public internal::TrackBatchSamplingJob<Float3Track, math::SoaFloat3> {};
+
 }  // namespace animation
 }  // namespace ozz
 #endif  // OZZ_OZZ_ANIMATION_RUNTIME_TRACK_SAMPLING_JOB_H_
@@ -34,6 +34,7 @@
 #include <cstddef>
 
 #include "ozz/base/platform.h"
+#include "ozz/base/span.h"
 
 namespace ozz {
 namespace io {
@@ -184,6 +185,60 @@ class OZZ_BASE_DLL MemoryStream : public Stream {
   // The cursor position in the buffer of data.
   int tell_;
 };
+
+// Implements a read-only Stream over a memory mapped file.
+// Beyond Stream interface, mapped file content can be accessed directly with
+// data() function. This allows to use file content in place, without copying
+// it (see Animation::MapImage). Mapped memory pages are loaded on demand and
+// shared by all processes mapping the same file.
+class OZZ_BASE_DLL MappedFile : public Stream {
+ public:
+  // Maps file at path _filename, in read-only mode.
+  // Use opened() function to test mapping result.
+  explicit MappedFile(const char* _filename);
+
+  // Unmaps the file if it is mapped.
+  virtual ~MappedFile();
+
+  // Unmaps the file if it is mapped. Memory returned by data() is no longer
+  // valid after this call.
+  void Close();
+
+  // Returns the mapped file content. The returned span is valid until the file
+  // is closed.
+  span<const byte> data() const { return {data_, size_}; }
+
+  // See Stream::opened for details.
+  virtual bool opened() const;
+
+  // See Stream::Read for details.
+  virtual size_t Read(void* _buffer, size_t _size);
+
+  // Mapped file is read-only, Write always returns 0.
+  virtual size_t Write(const void* _buffer, size_t _size);
+
+  // See Stream::Seek for details.
+  virtual int Seek(int _offset, Origin _origin);
+
+  // See Stream::Tell for details.
+  virtual int Tell() const;
+
+  // See Stream::Tell for details.
+  virtual size_t Size() const;
+
+ private:
+  // Mapped file content.
+  const byte* data_;
+
+  // Size of the mapped file content.
+  size_t size_;
+
+  // The cursor position in the mapped content.
+  int tell_;
+
+  // Platform specific file mapping handle, or nullptr if not opened.
+  void* handle_;
+};
 }  // namespace io
 }  // namespace ozz
 #endif  // OZZ_OZZ_BASE_IO_STREAM_H_
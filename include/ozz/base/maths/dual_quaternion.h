@@ -0,0 +1,87 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_BASE_MATHS_DUAL_QUATERNION_H_
+#define OZZ_OZZ_BASE_MATHS_DUAL_QUATERNION_H_
+
+#include "ozz/base/maths/quaternion.h"
+#include "ozz/base/maths/vec_float.h"
+#include "ozz/base/platform.h"
+
+namespace ozz {
+namespace math {
+
+// Stores a rigid transformation (rotation followed by translation) as a unit
+// dual quaternion. It uses 8 floats, compared to the 16 floats of a matrix, and
+// can be blended without introducing any scale or shearing.
+struct OZZ_BASE_DLL DualQuaternion {
+  // Real part, the rotation quaternion.
+  Quaternion real;
+
+  // Dual part, which encodes translation t as .5 * t * real.
+  Quaternion dual;
+
+  // Builds an identity dual quaternion.
+  static OZZ_INLINE DualQuaternion identity() {
+    const DualQuaternion ret = {Quaternion::identity(),
+                                Quaternion(0.f, 0.f, 0.f, 0.f)};
+    return ret;
+  }
+
+  // Builds a dual quaternion from a rotation _rotation, followed by a
+  // translation _translation. _rotation must be normalized.
+  static OZZ_INLINE DualQuaternion FromAffine(const Float3& _translation,
+                                              const Quaternion& _rotation);
+};
+
+OZZ_INLINE DualQuaternion DualQuaternion::FromAffine(
+    const Float3& _translation, const Quaternion& _rotation) {
+  assert(IsNormalized(_rotation));
+  const Quaternion t(_translation.x, _translation.y, _translation.z, 0.f);
+  const DualQuaternion ret = {_rotation, t * _rotation * .5f};
+  return ret;
+}
+
+// Returns the translation of the rigid transformation represented by _dq.
+OZZ_INLINE Float3 ToTranslation(const DualQuaternion& _dq) {
+  const Quaternion t = _dq.dual * Conjugate(_dq.real) * 2.f;
+  return Float3(t.x, t.y, t.z);
+}
+
+// Computes the transformation of a DualQuaternion and a point _p.
+OZZ_INLINE Float3 TransformPoint(const DualQuaternion& _dq, const Float3& _p) {
+  return TransformVector(_dq.real, _p) + ToTranslation(_dq);
+}
+
+// Computes the transformation of a DualQuaternion and a vector _v. Only
+// rotation applies to vectors.
+OZZ_INLINE Float3 TransformVector(const DualQuaternion& _dq, const Float3& _v) {
+  return TransformVector(_dq.real, _v);
+}
+}  // namespace math
+}  // namespace ozz
+#endif  // OZZ_OZZ_BASE_MATHS_DUAL_QUATERNION_H_
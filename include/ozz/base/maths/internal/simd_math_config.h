@@ -41,10 +41,23 @@
 #define OZZ_SIMD_AVX  // avx is available if avx2 is.
 #endif
 
-#if defined(__FMA__) || defined(OZZ_SIMD_FMA)
+// MSVC doesn't define __FMA__ nor __F16C__, even though /arch:AVX2 enables
+// FMA and F16C instruction sets.
+#if defined(__FMA__) || defined(OZZ_SIMD_FMA) || \
+    (defined(_MSC_VER) && defined(__AVX2__))
 #include <immintrin.h>
+#ifndef OZZ_SIMD_FMA
 #define OZZ_SIMD_FMA
 #endif
+#endif
+
+#if defined(__F16C__) || defined(OZZ_SIMD_F16C) || \
+    (defined(_MSC_VER) && defined(__AVX2__))
+#include <immintrin.h>
+#ifndef OZZ_SIMD_F16C
+#define OZZ_SIMD_F16C
+#endif
+#endif
 
 #if defined(__AVX__) || defined(OZZ_SIMD_AVX)
 #include <immintrin.h>
@@ -85,6 +98,16 @@
 #define OZZ_SIMD_SSEx  // OZZ_SIMD_SSEx is the generic flag for SSE support
 #endif
 
+// AVX2 code paths can be selected at runtime when AVX2 isn't enabled at build
+// time. Functions using AVX2 are then compiled with OZZ_SIMD_AVX2_TARGET, and
+// must only be called if math::SupportsAvx2() returns true.
+#if !defined(OZZ_SIMD_AVX2) && defined(OZZ_SIMD_SSEx) &&            \
+    (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+     defined(_M_IX86))
+#include <immintrin.h>
+#define OZZ_SIMD_AVX2_DISPATCH
+#endif
+
 // Try to match a Arm NEON
 #if defined(__ARM_NEON) || defined(OZZ_SIMD_ARM_NEON)
 // #include <arm_neon.h>
@@ -94,6 +117,14 @@
 // End of SIMD instruction detection
 #endif  // !OZZ_BUILD_SIMD_REF
 
+// Enables AVX2 (and FMA) instruction sets for a function. MSVC doesn't need it,
+// as it allows using any instruction set intrinsics.
+#if defined(OZZ_SIMD_AVX2_DISPATCH) && (defined(__GNUC__) || defined(__clang__))
+#define OZZ_SIMD_AVX2_TARGET __attribute__((target("avx2,fma")))
+#else
+#define OZZ_SIMD_AVX2_TARGET
+#endif
+
 // SEE* intrinsics available
 #if defined(OZZ_SIMD_SSEx)
 
@@ -131,6 +131,15 @@ namespace simd_float4 {
 #define OZZ_NMSUBX(_a, _b, _c) (-_mm_add_ss(_mm_mul_ss(_a, _b), _c))
 #endif  // OZZ_SIMD_FMA
 
+// 256b (8 floats) FMA operations, used to process two SimdFloat4 at once.
+#ifdef OZZ_SIMD_AVX
+#ifdef OZZ_SIMD_FMA
+#define OZZ_MADD_256(_a, _b, _c) _mm256_fmadd_ps(_a, _b, _c)
+#else  //  OZZ_SIMD_FMA
+#define OZZ_MADD_256(_a, _b, _c) _mm256_add_ps(_mm256_mul_ps(_a, _b), _c)
+#endif  // OZZ_SIMD_FMA
+#endif  // OZZ_SIMD_AVX
+
 OZZ_INLINE SimdFloat4 DivX(_SimdFloat4 _a, _SimdFloat4 _b) {
   return _mm_div_ss(_a, _b);
 }
@@ -1933,6 +1942,47 @@ OZZ_INLINE ozz::math::SimdFloat4 operator*(const ozz::math::Float4x4& _m,
   return _mm_add_ps(a01, a23);
 }
 
+#ifdef OZZ_SIMD_AVX
+// AVX implementation computes 2 columns of the result at once, using 256b
+// registers. Each 128b lane of the registers holds a column.
+inline ozz::math::Float4x4 operator*(const ozz::math::Float4x4& _a,
+                                     const ozz::math::Float4x4& _b) {
+  const __m256 a0 = _mm256_broadcast_ps(&_a.cols[0]);
+  const __m256 a1 = _mm256_broadcast_ps(&_a.cols[1]);
+  const __m256 a2 = _mm256_broadcast_ps(&_a.cols[2]);
+  const __m256 a3 = _mm256_broadcast_ps(&_a.cols[3]);
+  ozz::math::Float4x4 ret;
+  {
+    const __m256 b01 = _mm256_set_m128(_b.cols[1], _b.cols[0]);
+    const __m256 xxxx =
+        _mm256_mul_ps(_mm256_permute_ps(b01, _MM_SHUFFLE(0, 0, 0, 0)), a0);
+    const __m256 zzzz =
+        _mm256_mul_ps(_mm256_permute_ps(b01, _MM_SHUFFLE(2, 2, 2, 2)), a2);
+    const __m256 a01 = OZZ_MADD_256(
+        _mm256_permute_ps(b01, _MM_SHUFFLE(1, 1, 1, 1)), a1, xxxx);
+    const __m256 a23 = OZZ_MADD_256(
+        _mm256_permute_ps(b01, _MM_SHUFFLE(3, 3, 3, 3)), a3, zzzz);
+    const __m256 r01 = _mm256_add_ps(a01, a23);
+    ret.cols[0] = _mm256_castps256_ps128(r01);
+    ret.cols[1] = _mm256_extractf128_ps(r01, 1);
+  }
+  {
+    const __m256 b23 = _mm256_set_m128(_b.cols[3], _b.cols[2]);
+    const __m256 xxxx =
+        _mm256_mul_ps(_mm256_permute_ps(b23, _MM_SHUFFLE(0, 0, 0, 0)), a0);
+    const __m256 zzzz =
+        _mm256_mul_ps(_mm256_permute_ps(b23, _MM_SHUFFLE(2, 2, 2, 2)), a2);
+    const __m256 a01 = OZZ_MADD_256(
+        _mm256_permute_ps(b23, _MM_SHUFFLE(1, 1, 1, 1)), a1, xxxx);
+    const __m256 a23 = OZZ_MADD_256(
+        _mm256_permute_ps(b23, _MM_SHUFFLE(3, 3, 3, 3)), a3, zzzz);
+    const __m256 r23 = _mm256_add_ps(a01, a23);
+    ret.cols[2] = _mm256_castps256_ps128(r23);
+    ret.cols[3] = _mm256_extractf128_ps(r23, 1);
+  }
+  return ret;
+}
+#else   // OZZ_SIMD_AVX
 inline ozz::math::Float4x4 operator*(const ozz::math::Float4x4& _a,
                                      const ozz::math::Float4x4& _b) {
   ozz::math::Float4x4 ret;
@@ -1974,6 +2024,7 @@ inline ozz::math::Float4x4 operator*(const ozz::math::Float4x4& _a,
   }
   return ret;
 }
+#endif  // OZZ_SIMD_AVX
 
 OZZ_INLINE ozz::math::Float4x4 operator+(const ozz::math::Float4x4& _a,
                                          const ozz::math::Float4x4& _b) {
@@ -2066,6 +2117,12 @@ inline SimdInt4 FloatToHalf(_SimdFloat4 _f) {
 }
 
 OZZ_INLINE SimdFloat4 HalfToFloat(_SimdInt4 _h) {
+#if defined(OZZ_SIMD_F16C)
+  // Halves are packed to the 4 lower 16b lanes, ignoring upper bits like the
+  // software implementation below does.
+  const __m128i h = _mm_and_si128(_h, _mm_set1_epi32(0xffff));
+  return _mm_cvtph_ps(_mm_packus_epi32(h, h));
+#else  // OZZ_SIMD_F16C
   const __m128i mask_nosign = _mm_set1_epi32(0x7fff);
   const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));
   const __m128i was_infnan = _mm_set1_epi32(0x7bff);
@@ -2080,6 +2137,7 @@ OZZ_INLINE SimdFloat4 HalfToFloat(_SimdInt4 _h) {
       _mm_and_ps(_mm_castsi128_ps(b_wasinfnan), exp_infnan);
   const __m128 sign_inf = _mm_or_ps(_mm_castsi128_ps(sign), infnanexp);
   return _mm_or_ps(scaled, sign_inf);
+#endif  // OZZ_SIMD_F16C
 }
 }  // namespace math
 }  // namespace ozz
@@ -2100,6 +2158,7 @@ OZZ_INLINE SimdFloat4 HalfToFloat(_SimdInt4 _h) {
 #undef OZZ_MSUBX
 #undef OZZ_NMADDX
 #undef OZZ_NMSUBX
+#undef OZZ_MADD_256
 #undef OZZ_SSE_SELECT_F
 #undef OZZ_SSE_SPLAT_I
 #undef OZZ_SSE_SELECT_I
@@ -0,0 +1,198 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_BASE_MATHS_SIMD_FLOAT8_H_
+#define OZZ_OZZ_BASE_MATHS_SIMD_FLOAT8_H_
+
+// Declares 8 lanes simd math, available when AVX2 instruction set is enabled
+// (see ozz_build_simd_avx2 CMake option), or can be selected at runtime (see
+// OZZ_SIMD_AVX2_DISPATCH). In the latter case, 8 lanes functions are compiled
+// for AVX2 whatever the build options, so they must only be called from
+// functions declared with OZZ_SIMD_AVX2_TARGET, and only if
+// math::SupportsAvx2() is true.
+// SoA runtime buffers are laid out in blocks of 4 lanes (SoaFloat3,
+// SoaQuaternion...). 8 lanes types are loaded from and stored to two
+// consecutive blocks, so that hot loops can process 8 joints per iteration
+// without changing runtime data layout.
+
+#include "ozz/base/maths/soa_float.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/soa_quaternion.h"
+#include "ozz/base/platform.h"
+
+#if defined(OZZ_SIMD_AVX2) || defined(OZZ_SIMD_AVX2_DISPATCH)
+
+// Inlines 8 lanes functions, enabling AVX2 instruction set for them.
+#define OZZ_INLINE8 OZZ_SIMD_AVX2_TARGET OZZ_INLINE
+
+namespace ozz {
+namespace math {
+
+// Vector of eight floating point values.
+typedef __m256 SimdFloat8;
+
+// Argument type for SimdFloat8.
+typedef const __m256 _SimdFloat8;
+
+namespace simd_float8 {
+// Returns a SimdFloat8 vector with all components set to _x.
+OZZ_INLINE8 SimdFloat8 Load1(float _x) { return _mm256_set1_ps(_x); }
+
+// Returns a SimdFloat8 vector whose 4 first lanes are loaded from _lo, and 4
+// last ones from _hi.
+OZZ_INLINE8 SimdFloat8 Load(_SimdFloat4 _lo, _SimdFloat4 _hi) {
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(_lo), _hi, 1);
+}
+
+// Stores the 4 first lanes of _v to _lo, and the 4 last ones to _hi.
+OZZ_INLINE8 void Store(_SimdFloat8 _v, SimdFloat4* _lo, SimdFloat4* _hi) {
+  *_lo = _mm256_castps256_ps128(_v);
+  *_hi = _mm256_extractf128_ps(_v, 1);
+}
+}  // namespace simd_float8
+
+// Returns per element _a * _b + _c.
+OZZ_INLINE8 SimdFloat8 MAdd(_SimdFloat8 _a, _SimdFloat8 _b, _SimdFloat8 _c) {
+#ifdef OZZ_SIMD_FMA
+  return _mm256_fmadd_ps(_a, _b, _c);
+#else   // OZZ_SIMD_FMA
+  return _mm256_add_ps(_mm256_mul_ps(_a, _b), _c);
+#endif  // OZZ_SIMD_FMA
+}
+
+// Returns per element _c - _a * _b.
+OZZ_INLINE8 SimdFloat8 NMAdd(_SimdFloat8 _a, _SimdFloat8 _b, _SimdFloat8 _c) {
+#ifdef OZZ_SIMD_FMA
+  return _mm256_fnmadd_ps(_a, _b, _c);
+#else   // OZZ_SIMD_FMA
+  return _mm256_sub_ps(_c, _mm256_mul_ps(_a, _b));
+#endif  // OZZ_SIMD_FMA
+}
+
+// Returns the per element estimated reciprocal of _v.
+OZZ_INLINE8 SimdFloat8 RcpEst(_SimdFloat8 _v) { return _mm256_rcp_ps(_v); }
+
+// Returns the per element estimated reciprocal square root of _v, refined with
+// a Newton-Raphson step.
+OZZ_INLINE8 SimdFloat8 RSqrtEstNR(_SimdFloat8 _v) {
+  const __m256 nr = _mm256_rsqrt_ps(_v);
+  // Do one more Newton-Raphson step to improve precision.
+  return _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(.5f), nr),
+                       NMAdd(_mm256_mul_ps(_v, nr), nr, _mm256_set1_ps(3.f)));
+}
+}  // namespace math
+}  // namespace ozz
+
+#if !defined(OZZ_DISABLE_SSE_NATIVE_OPERATORS)
+OZZ_INLINE8 ozz::math::SimdFloat8 operator+(ozz::math::_SimdFloat8 _a,
+                                            ozz::math::_SimdFloat8 _b) {
+  return _mm256_add_ps(_a, _b);
+}
+
+OZZ_INLINE8 ozz::math::SimdFloat8 operator-(ozz::math::_SimdFloat8 _a,
+                                            ozz::math::_SimdFloat8 _b) {
+  return _mm256_sub_ps(_a, _b);
+}
+
+OZZ_INLINE8 ozz::math::SimdFloat8 operator*(ozz::math::_SimdFloat8 _a,
+                                            ozz::math::_SimdFloat8 _b) {
+  return _mm256_mul_ps(_a, _b);
+}
+#endif  // !defined(OZZ_DISABLE_SSE_NATIVE_OPERATORS)
+
+namespace ozz {
+namespace math {
+
+// 8 lanes version of SoaFloat3, loaded from two consecutive SoaFloat3.
+struct Soa8Float3 {
+  SimdFloat8 x, y, z;
+
+  static OZZ_INLINE8 Soa8Float3 Load(const SoaFloat3& _lo,
+                                     const SoaFloat3& _hi) {
+    const Soa8Float3 r = {simd_float8::Load(_lo.x, _hi.x),
+                          simd_float8::Load(_lo.y, _hi.y),
+                          simd_float8::Load(_lo.z, _hi.z)};
+    return r;
+  }
+
+  OZZ_INLINE8 void Store(SoaFloat3* _lo, SoaFloat3* _hi) const {
+    simd_float8::Store(x, &_lo->x, &_hi->x);
+    simd_float8::Store(y, &_lo->y, &_hi->y);
+    simd_float8::Store(z, &_lo->z, &_hi->z);
+  }
+};
+
+// 8 lanes version of SoaQuaternion, loaded from two consecutive SoaQuaternion.
+struct Soa8Quaternion {
+  SimdFloat8 x, y, z, w;
+
+  static OZZ_INLINE8 Soa8Quaternion Load(const SoaQuaternion& _lo,
+                                         const SoaQuaternion& _hi) {
+    const Soa8Quaternion r = {
+        simd_float8::Load(_lo.x, _hi.x), simd_float8::Load(_lo.y, _hi.y),
+        simd_float8::Load(_lo.z, _hi.z), simd_float8::Load(_lo.w, _hi.w)};
+    return r;
+  }
+
+  OZZ_INLINE8 void Store(SoaQuaternion* _lo, SoaQuaternion* _hi) const {
+    simd_float8::Store(x, &_lo->x, &_hi->x);
+    simd_float8::Store(y, &_lo->y, &_hi->y);
+    simd_float8::Store(z, &_lo->z, &_hi->z);
+    simd_float8::Store(w, &_lo->w, &_hi->w);
+  }
+};
+
+// Returns the linear interpolation of _a and _b with coefficient _f.
+OZZ_INLINE8 Soa8Float3 Lerp(const Soa8Float3& _a, const Soa8Float3& _b,
+                            _SimdFloat8 _f) {
+  const Soa8Float3 r = {MAdd(_b.x - _a.x, _f, _a.x),
+                        MAdd(_b.y - _a.y, _f, _a.y),
+                        MAdd(_b.z - _a.z, _f, _a.z)};
+  return r;
+}
+
+// Returns the 4D dot product of quaternions _a and _b.
+OZZ_INLINE8 SimdFloat8 Dot(const Soa8Quaternion& _a, const Soa8Quaternion& _b) {
+  return MAdd(_a.x, _b.x, MAdd(_a.y, _b.y, MAdd(_a.z, _b.z, _a.w * _b.w)));
+}
+
+// Returns the estimated normalized linear interpolation of quaternions _a and
+// _b with coefficient _f. See SoaQuaternion NLerpEst.
+OZZ_INLINE8 Soa8Quaternion NLerpEst(const Soa8Quaternion& _a,
+                                    const Soa8Quaternion& _b, _SimdFloat8 _f) {
+  const Soa8Quaternion lerp = {
+      MAdd(_b.x - _a.x, _f, _a.x), MAdd(_b.y - _a.y, _f, _a.y),
+      MAdd(_b.z - _a.z, _f, _a.z), MAdd(_b.w - _a.w, _f, _a.w)};
+  const SimdFloat8 inv_len = RSqrtEstNR(Dot(lerp, lerp));
+  const Soa8Quaternion r = {lerp.x * inv_len, lerp.y * inv_len,
+                            lerp.z * inv_len, lerp.w * inv_len};
+  return r;
+}
+}  // namespace math
+}  // namespace ozz
+#endif  // OZZ_SIMD_AVX2 || OZZ_SIMD_AVX2_DISPATCH
+#endif  // OZZ_OZZ_BASE_MATHS_SIMD_FLOAT8_H_
@@ -40,6 +40,11 @@ namespace math {
 // Returns SIMDimplementation name has decided at library build time.
 OZZ_BASE_DLL const char* SimdImplementationName();
 
+// Tests if the CPU supports AVX2 and FMA instruction sets, allowing to select
+// AVX2 code paths at runtime (see OZZ_SIMD_AVX2_DISPATCH). Always true if AVX2
+// is enabled at build time, always false if it can't be selected at runtime.
+OZZ_BASE_DLL bool SupportsAvx2();
+
 namespace simd_float4 {
 // Returns a SimdFloat4 vector with all components set to 0.
 OZZ_INLINE SimdFloat4 zero();
@@ -1245,6 +1250,31 @@ OZZ_INLINE ozz::math::Float4x4 operator+(const ozz::math::Float4x4& _a,
 // Computes the per element subtraction of two matrices _a and _b.
 OZZ_INLINE ozz::math::Float4x4 operator-(const ozz::math::Float4x4& _a,
                                          const ozz::math::Float4x4& _b);
+
+// Declares a 3x4 affine matrix, stored as 3 rows. The w component of each row
+// stores the translation, while the last row of the matrix is implicitly
+// (0, 0, 0, 1). This is the layout usually expected by gpu skinning palettes,
+// 25% smaller than a Float4x4.
+struct Float3x4 {
+  // Matrix rows.
+  SimdFloat4 rows[3];
+
+  // Returns the 3x4 affine part of matrix _m. Last row of _m is discarded.
+  static OZZ_INLINE Float3x4 FromFloat4x4(const Float4x4& _m) {
+    Float3x4 ret;
+    Transpose4x3(_m.cols, ret.rows);
+    return ret;
+  }
+};
+
+// Returns the Float4x4 matrix of affine matrix _m, whose last row is
+// (0, 0, 0, 1).
+OZZ_INLINE Float4x4 ToFloat4x4(const Float3x4& _m) {
+  Float4x4 ret;
+  Transpose3x4(_m.rows, ret.cols);
+  ret.cols[3] = SetW(ret.cols[3], simd_float4::one());
+  return ret;
+}
 }  // namespace math
 }  // namespace ozz
 
@@ -671,6 +671,29 @@ OZZ_INLINE SoaFloat2 Clamp(const SoaFloat2& _a, const SoaFloat2& _v,
                            const SoaFloat2& _b) {
   return Max(_a, Min(_v, _b));
 }
+
+// Returns per element _true if the corresponding lane of _b is set, or _false
+// otherwise. _b must be a mask, as returned by comparison functions.
+OZZ_INLINE SoaFloat4 Select(_SimdInt4 _b, const SoaFloat4& _true,
+                            const SoaFloat4& _false) {
+  const SoaFloat4 r = {
+      Select(_b, _true.x, _false.x), Select(_b, _true.y, _false.y),
+      Select(_b, _true.z, _false.z), Select(_b, _true.w, _false.w)};
+  return r;
+}
+OZZ_INLINE SoaFloat3 Select(_SimdInt4 _b, const SoaFloat3& _true,
+                            const SoaFloat3& _false) {
+  const SoaFloat3 r = {Select(_b, _true.x, _false.x),
+                       Select(_b, _true.y, _false.y),
+                       Select(_b, _true.z, _false.z)};
+  return r;
+}
+OZZ_INLINE SoaFloat2 Select(_SimdInt4 _b, const SoaFloat2& _true,
+                            const SoaFloat2& _false) {
+  const SoaFloat2 r = {Select(_b, _true.x, _false.x),
+                       Select(_b, _true.y, _false.y)};
+  return r;
+}
 }  // namespace math
 }  // namespace ozz
 #endif  // OZZ_OZZ_BASE_MATHS_SOA_FLOAT_H_
@@ -218,6 +218,31 @@ OZZ_INLINE SoaFloat4x4 Scale(const SoaFloat4x4& _m, const SoaFloat4& _v) {
                             _m.cols[3]}};
   return ret;
 }
+
+// Computes the transformation of matrices _m and points _p.
+// This is equivalent to multiplying _m by _p, with _p.w = 1.
+OZZ_INLINE SoaFloat3 TransformPoint(const SoaFloat4x4& _m,
+                                    const SoaFloat3& _p) {
+  const SoaFloat3 ret = {
+      _m.cols[0].x * _p.x + _m.cols[1].x * _p.y + _m.cols[2].x * _p.z +
+          _m.cols[3].x,
+      _m.cols[0].y * _p.x + _m.cols[1].y * _p.y + _m.cols[2].y * _p.z +
+          _m.cols[3].y,
+      _m.cols[0].z * _p.x + _m.cols[1].z * _p.y + _m.cols[2].z * _p.z +
+          _m.cols[3].z};
+  return ret;
+}
+
+// Computes the transformation of matrices _m and vectors _v.
+// This is equivalent to multiplying _m by _v, with _v.w = 0.
+OZZ_INLINE SoaFloat3 TransformVector(const SoaFloat4x4& _m,
+                                     const SoaFloat3& _v) {
+  const SoaFloat3 ret = {
+      _m.cols[0].x * _v.x + _m.cols[1].x * _v.y + _m.cols[2].x * _v.z,
+      _m.cols[0].y * _v.x + _m.cols[1].y * _v.y + _m.cols[2].y * _v.z,
+      _m.cols[0].z * _v.x + _m.cols[1].z * _v.y + _m.cols[2].z * _v.z};
+  return ret;
+}
 }  // namespace math
 }  // namespace ozz
 
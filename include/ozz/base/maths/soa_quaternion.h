@@ -52,6 +52,24 @@ struct SoaQuaternion {
     const SoaQuaternion r = {zero, zero, zero, simd_float4::one()};
     return r;
   }
+
+  // Returns normalized quaternions initialized from axes and angles (in
+  // radian) representation.
+  // Assumes the axes are normalized.
+  static OZZ_INLINE SoaQuaternion FromAxisAngle(const SoaFloat3& _axis,
+                                                _SimdFloat4 _angle);
+
+  // Returns normalized quaternions initialized from axes and angles cosine
+  // representation.
+  // Assumes the axes are normalized, and that cosines are within [-1,1] range.
+  static OZZ_INLINE SoaQuaternion FromAxisCosAngle(const SoaFloat3& _axis,
+                                                   _SimdFloat4 _cos);
+
+  // Returns the quaternions that will rotate vectors _from into vectors _to,
+  // around their plan perpendicular axis. The input vectors don't need to be
+  // normalized, they can be null also. See SimdQuaternion::FromVectors.
+  static OZZ_INLINE SoaQuaternion FromVectors(const SoaFloat3& _from,
+                                              const SoaFloat3& _to);
 };
 
 // Returns the conjugate of _q. This is the same as the inverse if _q is
@@ -116,6 +134,83 @@ OZZ_INLINE SimdInt4 IsNormalizedEst(const SoaQuaternion& _q) {
                simd_float4::Load1(kNormalizationToleranceEstSq));
 }
 
+OZZ_INLINE SoaQuaternion SoaQuaternion::FromAxisAngle(const SoaFloat3& _axis,
+                                                      _SimdFloat4 _angle) {
+  assert(AreAllTrue(IsNormalizedEst(_axis)) && "axis is not normalized.");
+  const SimdFloat4 half_angle = _angle * simd_float4::Load1(.5f);
+  const SimdFloat4 half_sin = Sin(half_angle);
+  const SoaQuaternion r = {_axis.x * half_sin, _axis.y * half_sin,
+                           _axis.z * half_sin, Cos(half_angle)};
+  return r;
+}
+
+OZZ_INLINE SoaQuaternion
+SoaQuaternion::FromAxisCosAngle(const SoaFloat3& _axis, _SimdFloat4 _cos) {
+  const SimdFloat4 one = simd_float4::one();
+  const SimdFloat4 half = simd_float4::Load1(.5f);
+
+  assert(AreAllTrue(IsNormalizedEst(_axis)) && "axis is not normalized.");
+  assert(AreAllTrue(And(CmpGe(_cos, -one), CmpLe(_cos, one))) &&
+         "cos is not in [-1,1] range.");
+
+  const SimdFloat4 half_cos2 = (one + _cos) * half;
+  const SimdFloat4 half_sin2 = one - half_cos2;
+  const SimdFloat4 half_sin = Sqrt(half_sin2);
+  const SoaQuaternion r = {_axis.x * half_sin, _axis.y * half_sin,
+                           _axis.z * half_sin, Sqrt(half_cos2)};
+  return r;
+}
+
+OZZ_INLINE SoaQuaternion SoaQuaternion::FromVectors(const SoaFloat3& _from,
+                                                    const SoaFloat3& _to) {
+  // http://lolengine.net/blog/2014/02/24/quaternion-from-two-vectors-final
+  const SimdFloat4 zero = simd_float4::zero();
+  const SimdFloat4 eps = simd_float4::Load1(1.e-6f);
+  const SimdFloat4 norm_from_norm_to =
+      Sqrt(LengthSqr(_from) * LengthSqr(_to));
+  const SimdFloat4 real_part = norm_from_norm_to + Dot(_from, _to);
+
+  // If _from and _to are exactly opposite, rotate 180 degrees around an
+  // arbitrary orthogonal axis. Axis normalization happens later, when the
+  // quaternion is normalized.
+  const SimdInt4 opposite = CmpLt(real_part, eps * norm_from_norm_to);
+  const SimdInt4 x_major = CmpGt(Abs(_from.x), Abs(_from.z));
+  const SimdFloat4 ox = Select(x_major, -_from.y, zero);
+  const SimdFloat4 oy = Select(x_major, _from.x, -_from.z);
+  const SimdFloat4 oz = Select(x_major, zero, _from.y);
+
+  // This is the general code path.
+  const SoaFloat3 cross = Cross(_from, _to);
+  const SoaQuaternion quat = {
+      Select(opposite, ox, cross.x), Select(opposite, oy, cross.y),
+      Select(opposite, oz, cross.z), Select(opposite, zero, real_part)};
+
+  // Null vectors produce an identity quaternion.
+  const SimdFloat4 one = simd_float4::one();
+  const SimdInt4 degenerate = CmpLt(norm_from_norm_to, eps);
+  const SimdFloat4 len2 = Dot(quat, quat);
+  const SimdFloat4 inv_len = Select(degenerate, zero, one / Sqrt(len2));
+  const SoaQuaternion r = {quat.x * inv_len, quat.y * inv_len,
+                           quat.z * inv_len,
+                           Select(degenerate, one, quat.w * inv_len)};
+  return r;
+}
+
+// Computes the transformation of quaternions _q and vectors _v.
+// This is equivalent to carrying out the quaternion multiplications:
+// _q.conjugate() * (*this) * _q
+OZZ_INLINE SoaFloat3 TransformVector(const SoaQuaternion& _q,
+                                     const SoaFloat3& _v) {
+  // _v + 2.f * cross(_q.xyz, cross(_q.xyz, _v) + _q.w * _v)
+  const SoaFloat3 a = {_q.y * _v.z - _q.z * _v.y + _v.x * _q.w,
+                       _q.z * _v.x - _q.x * _v.z + _v.y * _q.w,
+                       _q.x * _v.y - _q.y * _v.x + _v.z * _q.w};
+  const SoaFloat3 b = {_q.y * a.z - _q.z * a.y, _q.z * a.x - _q.x * a.z,
+                       _q.x * a.y - _q.y * a.x};
+  const SoaFloat3 r = {_v.x + b.x + b.x, _v.y + b.y + b.y, _v.z + b.z + b.z};
+  return r;
+}
+
 // Returns the linear interpolation of SoaQuaternion _a and _b with coefficient
 // _f.
 OZZ_INLINE SoaQuaternion Lerp(const SoaQuaternion& _a, const SoaQuaternion& _b,
@@ -155,6 +250,16 @@ OZZ_INLINE SoaQuaternion NLerpEst(const SoaQuaternion& _a,
                            lerp.w * inv_len};
   return r;
 }
+
+// Returns per lane _true if the corresponding lane of _b is set, or _false
+// otherwise. _b must be a mask, as returned by comparison functions.
+OZZ_INLINE SoaQuaternion Select(_SimdInt4 _b, const SoaQuaternion& _true,
+                                const SoaQuaternion& _false) {
+  const SoaQuaternion r = {
+      Select(_b, _true.x, _false.x), Select(_b, _true.y, _false.y),
+      Select(_b, _true.z, _false.z), Select(_b, _true.w, _false.w)};
+  return r;
+}
 }  // namespace math
 }  // namespace ozz
 
@@ -40,13 +40,67 @@ namespace memory {
 // Forwards declare Allocator class.
 class Allocator;
 
-// Defines the default allocator accessor.
+// Defines the default allocator accessor. Returns the calling thread scoped
+// allocator if any (see ScopedAllocator), or the global default allocator
+// otherwise.
 OZZ_BASE_DLL Allocator* default_allocator();
 
 // Set the default allocator, used for all dynamic allocation inside ozz.
 // Returns current memory allocator, such that in can be restored if needed.
 OZZ_BASE_DLL Allocator* SetDefaulAllocator(Allocator* _allocator);
 
+// Defines allocation statistics counters.
+struct Stats {
+  // Number of Allocate and Deallocate calls (excluding nullptr blocks).
+  size_t allocations = 0;
+  size_t deallocations = 0;
+
+  // Number of allocations and deallocations that went down to the system heap
+  // or to a backing allocator. This is the traffic that arena, pool and cache
+  // allocators aim to cut.
+  size_t backing_allocations = 0;
+  size_t backing_deallocations = 0;
+
+  // Sum of all requested allocation sizes, in bytes.
+  size_t allocated_bytes = 0;
+};
+
+// Gets statistics of the built-in heap allocator, since program start.
+OZZ_BASE_DLL Stats heap_stats();
+
+// Overrides the default allocator for the calling thread only, during the
+// lifetime of the ScopedAllocator object. Scopes can be nested.
+// Within the scope, default_allocator() returns an internal allocator that
+// forwards allocations to the scoped allocator, and records it in a header
+// before each block. Every block is thus released to the allocator it comes
+// from, whichever default allocator is used for deallocation: blocks allocated
+// in the scope can be released after it (like containers resized in the
+// scope), and blocks allocated before the scope can be released within it.
+// Allocations the scoped allocator requests from default_allocator() (like
+// arena chunks) are served by the enclosing scope, or by the global default
+// allocator.
+// Owner headers are shared with the built-in heap allocator, so the global
+// default allocator must be the built-in one while scopes are used.
+class OZZ_BASE_DLL ScopedAllocator {
+ public:
+  explicit ScopedAllocator(Allocator* _allocator);
+  ~ScopedAllocator();
+
+  // Disables copy and assignation.
+  ScopedAllocator(const ScopedAllocator&) = delete;
+  ScopedAllocator& operator=(const ScopedAllocator&) = delete;
+
+ private:
+  friend class ScopeRouter;
+
+  // Scoped allocator.
+  Allocator* allocator_;
+
+  // Enclosing scope of the calling thread when *this was constructed, nullptr
+  // if none.
+  ScopedAllocator* previous_;
+};
+
 // Defines an abstract allocator class.
 // Implements helper methods to allocate/deallocate POD typed objects instead of
 // raw memory.
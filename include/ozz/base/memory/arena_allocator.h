@@ -0,0 +1,93 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_BASE_MEMORY_ARENA_ALLOCATOR_H_
+#define OZZ_OZZ_BASE_MEMORY_ARENA_ALLOCATOR_H_
+
+#include "ozz/base/memory/allocator.h"
+
+namespace ozz {
+namespace memory {
+
+// Implements a linear arena allocator.
+// Allocations are carved sequentially from big chunks of memory, requested to
+// a backing allocator. Deallocating a block does nothing, memory is only
+// reclaimed all at once by Reset(), which makes allocation and deallocation
+// almost free. This suits per-frame or per-task allocations, like temporary
+// job contexts, that are all released together.
+// Arena allocator isn't thread safe, it's meant to be used by a single
+// thread, typically through a ScopedAllocator.
+class OZZ_BASE_DLL ArenaAllocator : public Allocator {
+ public:
+  // Constructs an arena that allocates chunks of at least _chunk_size bytes
+  // from _backing allocator. Allocations bigger than a chunk get a dedicated
+  // chunk.
+  explicit ArenaAllocator(size_t _chunk_size = 64 << 10,
+                          Allocator* _backing = default_allocator());
+
+  // Disables copy and assignation.
+  ArenaAllocator(const ArenaAllocator&) = delete;
+  ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+  // Releases all chunks to the backing allocator.
+  virtual ~ArenaAllocator();
+
+  // See Allocator::Allocate for details.
+  virtual void* Allocate(size_t _size, size_t _alignment);
+
+  // Does nothing, see class documentation.
+  virtual void Deallocate(void* _block);
+
+  // Rewinds the arena, invalidating all blocks allocated so far. The oldest
+  // chunk is kept for future allocations, others are released.
+  void Reset();
+
+  // Gets allocation statistics.
+  const Stats& stats() const { return stats_; }
+
+  // Number of bytes currently allocated from the arena chunks.
+  size_t used() const;
+
+ private:
+  // Chunk header, chunk memory follows it.
+  struct Chunk;
+
+  // Size of the chunks requested to the backing allocator.
+  size_t chunk_size_;
+
+  // Backing allocator.
+  Allocator* backing_;
+
+  // List of chunks, the current (last) one first.
+  Chunk* chunks_ = nullptr;
+
+  // Allocation statistics.
+  Stats stats_;
+};
+}  // namespace memory
+}  // namespace ozz
+#endif  // OZZ_OZZ_BASE_MEMORY_ARENA_ALLOCATOR_H_
@@ -0,0 +1,101 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_BASE_MEMORY_POOL_ALLOCATOR_H_
+#define OZZ_OZZ_BASE_MEMORY_POOL_ALLOCATOR_H_
+
+#include "ozz/base/memory/allocator.h"
+
+namespace ozz {
+namespace memory {
+
+// Implements a fixed-size block pool allocator.
+// Blocks are carved from slabs requested to a backing allocator, and recycled
+// through a free list when deallocated. Allocation and deallocation are thus
+// constant time and don't hit the backing allocator once the pool is warm.
+// This suits objects that are repeatedly created and destroyed with the same
+// size, like job contexts.
+// Allocations that don't fit a block (size or alignment) are forwarded to the
+// backing allocator. Note that within a ScopedAllocator, requested sizes
+// include the scope block header (2 pointers).
+// Pool allocator isn't thread safe, it's meant to be used by a single thread,
+// typically through a ScopedAllocator.
+class OZZ_BASE_DLL PoolAllocator : public Allocator {
+ public:
+  // Alignment of pool blocks.
+  static const size_t kBlockAlignment = 16;
+
+  // Constructs a pool of blocks of _block_size bytes, allocated by slabs of
+  // _blocks_per_slab blocks from _backing allocator.
+  explicit PoolAllocator(size_t _block_size, size_t _blocks_per_slab = 64,
+                         Allocator* _backing = default_allocator());
+
+  // Disables copy and assignation.
+  PoolAllocator(const PoolAllocator&) = delete;
+  PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+  // Releases all slabs to the backing allocator.
+  virtual ~PoolAllocator();
+
+  // See Allocator::Allocate for details.
+  virtual void* Allocate(size_t _size, size_t _alignment);
+
+  // See Allocator::Deallocate for details.
+  virtual void Deallocate(void* _block);
+
+  // Gets the size of pool blocks, which can be bigger than the size requested
+  // at construction because of alignment.
+  size_t block_size() const { return block_size_; }
+
+  // Gets allocation statistics.
+  const Stats& stats() const { return stats_; }
+
+ private:
+  // Slab header, slab blocks follow it.
+  struct Slab;
+
+  // Size of each block.
+  size_t block_size_;
+
+  // Number of blocks in a slab.
+  size_t blocks_per_slab_;
+
+  // Backing allocator.
+  Allocator* backing_;
+
+  // List of slabs.
+  Slab* slabs_ = nullptr;
+
+  // Free list of blocks, linked through the first bytes of each block.
+  void* free_ = nullptr;
+
+  // Allocation statistics.
+  Stats stats_;
+};
+}  // namespace memory
+}  // namespace ozz
+#endif  // OZZ_OZZ_BASE_MEMORY_POOL_ALLOCATOR_H_
@@ -0,0 +1,101 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_BASE_MEMORY_THREAD_CACHE_ALLOCATOR_H_
+#define OZZ_OZZ_BASE_MEMORY_THREAD_CACHE_ALLOCATOR_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "ozz/base/memory/allocator.h"
+
+namespace ozz {
+namespace memory {
+
+// Implements a thread safe allocator that caches small blocks per thread.
+// Blocks are rounded up to power of two size classes. Deallocated blocks are
+// kept in the deallocating thread cache, from where they are reused by next
+// allocations of the same class on that thread, without any lock nor call to
+// the backing allocator. This cuts heap traffic and contention when many
+// threads repeatedly allocate and release similar blocks.
+// Every instance has its own cache per thread. Cached blocks are released to
+// the backing allocator when the thread exits, or when Flush() is called from
+// that thread. Backing allocator must thus outlive all threads using the
+// cache.
+class OZZ_BASE_DLL ThreadCacheAllocator : public Allocator {
+ public:
+  // Smallest and biggest cached size classes. Bigger allocations are always
+  // forwarded to the backing allocator.
+  static const size_t kMinClassSize = 16;
+  static const size_t kMaxClassSize = 4096;
+
+  // Constructs a cache that keeps at most _max_cached_blocks blocks per size
+  // class and per thread, allocated from _backing allocator.
+  explicit ThreadCacheAllocator(int _max_cached_blocks = 64,
+                                Allocator* _backing = default_allocator());
+
+  // Disables copy and assignation.
+  ThreadCacheAllocator(const ThreadCacheAllocator&) = delete;
+  ThreadCacheAllocator& operator=(const ThreadCacheAllocator&) = delete;
+
+  // Releases calling thread cached blocks.
+  virtual ~ThreadCacheAllocator();
+
+  // See Allocator::Allocate for details.
+  virtual void* Allocate(size_t _size, size_t _alignment);
+
+  // See Allocator::Deallocate for details.
+  virtual void Deallocate(void* _block);
+
+  // Releases all blocks cached by the calling thread for this instance to the
+  // backing allocator.
+  void Flush();
+
+  // Gets allocation statistics, for all threads.
+  Stats stats() const;
+
+ private:
+  // Unique identifier of this instance, used to find its thread caches. It's
+  // never reused, unlike instance address.
+  uint64_t id_;
+
+  // Maximum number of blocks cached per size class and per thread.
+  int max_cached_blocks_;
+
+  // Backing allocator.
+  Allocator* backing_;
+
+  // Allocation statistics.
+  std::atomic<size_t> allocations_{0};
+  std::atomic<size_t> deallocations_{0};
+  std::atomic<size_t> backing_allocations_{0};
+  std::atomic<size_t> backing_deallocations_{0};
+  std::atomic<size_t> allocated_bytes_{0};
+};
+}  // namespace memory
+}  // namespace ozz
+#endif  // OZZ_OZZ_BASE_MEMORY_THREAD_CACHE_ALLOCATOR_H_
@@ -0,0 +1,126 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_BASE_SCHEDULER_H_
+#define OZZ_OZZ_BASE_SCHEDULER_H_
+
+#include "ozz/base/platform.h"
+
+// Proposes a scheduler interface used by ozz jobs and builders to run loops in
+// parallel, without depending on a specific threading library.
+// The interface can be implemented by an adapter to an engine own scheduler
+// (thread pool, fibers...), so that ozz never spawns threads on its own.
+// ThreadPoolScheduler is a built-in work-stealing implementation, for
+// applications that don't have a scheduler.
+
+namespace ozz {
+
+// Declares the scheduler interface.
+class OZZ_BASE_DLL Scheduler {
+ public:
+  // Required virtual destructor.
+  virtual ~Scheduler() {}
+
+  // Returns the maximum number of workers that can run tasks concurrently.
+  // Worker indices passed to tasks are in range [0,num_workers()[.
+  virtual int num_workers() const = 0;
+
+  // Task function, executed for a range [_begin,_end[ of loop indices, by
+  // worker _worker.
+  typedef void (*Task)(int _begin, int _end, int _worker, void* _user_data);
+
+  // Executes _task for all loop indices in range [0,_count[, and returns once
+  // they are all processed. Indices are split into ranges of at least
+  // _grain_size indices (except the last one), that can be executed
+  // concurrently.
+  // Implementations must guarantee that a worker index is never used by two
+  // tasks concurrently, allowing tasks to use per worker data without any
+  // synchronization. Calling thread can participate to the loop.
+  virtual void ParallelFor(int _count, int _grain_size, Task _task,
+                           void* _user_data) = 0;
+};
+
+// Runs _fn(begin, end, worker) for all loop indices in range [0,_count[,
+// using _scheduler. The loop runs on the calling thread if _scheduler is
+// nullptr.
+template <typename _Fn>
+inline void ParallelFor(Scheduler* _scheduler, int _count, int _grain_size,
+                        const _Fn& _fn) {
+  if (_count <= 0) {
+    return;
+  }
+  if (!_scheduler) {
+    _fn(0, _count, 0);
+    return;
+  }
+  struct Wrapper {
+    static void Run(int _begin, int _end, int _worker, void* _user_data) {
+      (*static_cast<const _Fn*>(_user_data))(_begin, _end, _worker);
+    }
+  };
+  _scheduler->ParallelFor(_count, _grain_size, &Wrapper::Run,
+                          const_cast<_Fn*>(&_fn));
+}
+
+// Implements a work-stealing thread pool scheduler.
+// Loop indices are initially distributed evenly to all workers. Every worker
+// processes its own range, _grain_size indices at a time, and steals half of
+// another worker remaining range when it runs out of work. Ranges are updated
+// lock-free, locks are only used to wake up and synchronize pool threads at
+// the beginning and the end of a loop.
+// The calling thread is worker 0. Nested ParallelFor calls (from a task of the
+// same scheduler) run serially on the calling worker. Concurrent calls from
+// different threads are serialized.
+class OZZ_BASE_DLL ThreadPoolScheduler : public Scheduler {
+ public:
+  // Creates a pool of _num_threads threads, in addition to the calling thread.
+  // A negative value creates one thread per hardware thread, minus the calling
+  // one. With no thread, loops run on the calling thread.
+  explicit ThreadPoolScheduler(int _num_threads = -1);
+
+  // Disables copy and assignation.
+  ThreadPoolScheduler(const ThreadPoolScheduler&) = delete;
+  ThreadPoolScheduler& operator=(const ThreadPoolScheduler&) = delete;
+
+  // Stops and joins pool threads.
+  virtual ~ThreadPoolScheduler();
+
+  // See Scheduler::num_workers for details. This is the number of pool threads
+  // plus the calling thread.
+  virtual int num_workers() const;
+
+  // See Scheduler::ParallelFor for details.
+  virtual void ParallelFor(int _count, int _grain_size, Task _task,
+                           void* _user_data);
+
+ private:
+  // Hides threading implementation.
+  struct Impl;
+  Impl* impl_;
+};
+}  // namespace ozz
+#endif  // OZZ_OZZ_BASE_SCHEDULER_H_
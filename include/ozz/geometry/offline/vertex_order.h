@@ -0,0 +1,60 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_GEOMETRY_OFFLINE_VERTEX_ORDER_H_
+#define OZZ_OZZ_GEOMETRY_OFFLINE_VERTEX_ORDER_H_
+
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+#include "ozz/geometry/offline/export.h"
+
+namespace ozz {
+namespace geometry {
+namespace offline {
+
+// Computes a vertex order that groups vertices by joint set, aka the set of
+// joints influencing a vertex. Skinning consecutive vertices that share the
+// same joints reuses the same joint matrices, which improves matrix palette
+// cache locality, and lets SkinningJob chunks (see SkinningJob::scheduler)
+// touch fewer matrices.
+// Vertices are sorted by their joint set (joint indices sorted in ascending
+// order, regardless of their weight), compared lexicographically. Sorting is
+// stable, so vertices that share the same joint set keep their original
+// relative order.
+// _joint_indices stores _influences_count indices per vertex, contiguously.
+// _order receives the computed order: _order[i] is the index of the original
+// vertex that should be stored at position i. Its size must match the number
+// of vertices.
+// Returns false if _influences_count isn't greater than 0, or if _joint_indices
+// and _order sizes don't match.
+OZZ_GEOMETRYOFFLINE_DLL bool ComputeJointSetOrder(
+    span<const uint16_t> _joint_indices, int _influences_count,
+    span<uint32_t> _order);
+}  // namespace offline
+}  // namespace geometry
+}  // namespace ozz
+#endif  // OZZ_OZZ_GEOMETRY_OFFLINE_VERTEX_ORDER_H_
@@ -0,0 +1,148 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_GEOMETRY_RUNTIME_DUAL_QUATERNION_SKINNING_JOB_H_
+#define OZZ_OZZ_GEOMETRY_RUNTIME_DUAL_QUATERNION_SKINNING_JOB_H_
+
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+#include "ozz/geometry/runtime/export.h"
+
+namespace ozz {
+namespace math {
+struct DualQuaternion;
+struct Float4x4;
+}  // namespace math
+namespace geometry {
+
+// Provides per-vertex dual quaternion skinning job implementation.
+// Contrary to SkinningJob linear blending of matrices, this job blends joint
+// transformations as unit dual quaternions. Blended transformations remain
+// rigid, which avoids the volume loss ("candy wrapper" effect) of linear blend
+// skinning around twisted joints. Joint transformations must hence be rigid
+// too: scale isn't supported.
+// A dual quaternion is 8 floats instead of 16 for a matrix, which halves
+// palette memory and bandwidth. Normals and tangents are transformed by the
+// blended rotation only, so there's no need for inverse transpose matrices.
+// Palette can be built from skinning matrices (model-space matrices multiplied
+// by inverse bind-pose matrices) with ToDualQuaternions function.
+// Input and output buffers follow the same contract as SkinningJob ones: any
+// number of influences per vertex, positions, optional normals and tangents,
+// and stride values (number of bytes from a vertex to the next), supporting
+// both array-of-structs and struct-of-arrays vertex layouts.
+// The job does not owned the buffers (in/output) and will thus not delete them
+// during job's destruction.
+struct OZZ_GEOMETRY_DLL DualQuaternionSkinningJob {
+  // Default constructor, initializes default values.
+  DualQuaternionSkinningJob();
+
+  // Validates job parameters.
+  // Returns true for a valid job, false otherwise:
+  // - if any range is invalid. See each range description.
+  // - if normals are provided but positions aren't.
+  // - if tangents are provided but normals aren't.
+  // - if no output is provided while an input is. For example, if input normals
+  // are provided, then output normals must also.
+  bool Validate() const;
+
+  // Runs job's skinning task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Number of vertices to transform. All input and output arrays must store at
+  // least this number of vertices.
+  int vertex_count;
+
+  // Maximum number of joints influencing each vertex. Must be greater than 0.
+  // See SkinningJob::influences_count for details.
+  int influences_count;
+
+  // Array of unit dual quaternions for each joint. Joint are indexed through
+  // indices array.
+  span<const math::DualQuaternion> joint_dual_quaternions;
+
+  // Array of joints indices, influences_count per vertex. See
+  // SkinningJob::joint_indices for details.
+  span<const uint16_t> joint_indices;
+  size_t joint_indices_stride;
+
+  // Array of joints weights, influences_count - 1 per vertex. The weight of the
+  // last joint is restored at runtime. See SkinningJob::joint_weights for
+  // details.
+  span<const float> joint_weights;
+  size_t joint_weights_stride;
+
+  // Input vertex positions array (3 float values per vertex) and stride (number
+  // of bytes between each position).
+  // Array length must be at least vertex_count * in_positions_stride.
+  span<const float> in_positions;
+  size_t in_positions_stride;
+
+  // Input vertex normals (3 float values per vertex) array and stride (number
+  // of bytes between each normal).
+  // Array length must be at least vertex_count * in_normals_stride.
+  span<const float> in_normals;
+  size_t in_normals_stride;
+
+  // Input vertex tangents (3 float values per vertex) array and stride (number
+  // of bytes between each tangent).
+  // Array length must be at least vertex_count * in_tangents_stride.
+  span<const float> in_tangents;
+  size_t in_tangents_stride;
+
+  // Output vertex positions (3 float values per vertex) array and stride
+  // (number of bytes between each position).
+  // Array length must be at least vertex_count * out_positions_stride.
+  span<float> out_positions;
+  size_t out_positions_stride;
+
+  // Output vertex normals (3 float values per vertex) array and stride (number
+  // of bytes between each normal). Rotation being rigid, output normals remain
+  // normalized if input normals are.
+  // Array length must be at least vertex_count * out_normals_stride.
+  span<float> out_normals;
+  size_t out_normals_stride;
+
+  // Output vertex tangents (3 float values per vertex) array and stride
+  // (number of bytes between each tangent).
+  // Array length must be at least vertex_count * out_tangents_stride.
+  span<float> out_tangents;
+  size_t out_tangents_stride;
+};
+
+// Converts skinning matrices _matrices to unit dual quaternions, stored in
+// _dual_quaternions. Matrices scale is discarded, and a matrix that can't be
+// decomposed is converted to identity.
+// Returns false if _dual_quaternions is smaller than _matrices.
+OZZ_GEOMETRY_DLL bool ToDualQuaternions(
+    span<const math::Float4x4> _matrices,
+    span<math::DualQuaternion> _dual_quaternions);
+}  // namespace geometry
+}  // namespace ozz
+#endif  // OZZ_OZZ_GEOMETRY_RUNTIME_DUAL_QUATERNION_SKINNING_JOB_H_
@@ -0,0 +1,179 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_GEOMETRY_RUNTIME_QUANTIZED_SKINNING_JOB_H_
+#define OZZ_OZZ_GEOMETRY_RUNTIME_QUANTIZED_SKINNING_JOB_H_
+
+#include "ozz/base/maths/vec_float.h"
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+#include "ozz/geometry/runtime/export.h"
+
+namespace ozz {
+namespace math {
+struct Float4x4;
+}
+namespace geometry {
+
+// Provides per-vertex matrix palette skinning job implementation, for
+// quantized/compressed vertex inputs.
+// This job implements the same algorithm as SkinningJob (see skinning_job.h),
+// but reads vertex attributes, joint indices and weights from compressed
+// streams. This reduces the memory footprint of skinned meshes inputs: A 4
+// influences vertex with position, normal and tangent uses 56 bytes with float
+// attributes and weights, and uint16 indices. It uses 25 bytes with half
+// attributes, uint8 indices and unorm8 weights.
+// Decoding comes at a cost though: when inputs are in cache, this job is about
+// twice slower than SkinningJob with float inputs. Outputs are the same size
+// in both cases, so the job is a memory footprint trade-off, not a speed up.
+// Vertices are processed by blocks: a block of compressed inputs is decoded
+// to floats, using SIMD conversions, to buffers that remain in L1 cache. The
+// block is then transformed by SkinningJob optimized loops. Float inputs aren't
+// decoded, they are used in place. Outputs are always floats.
+// Every input buffer is provided as a span of bytes, whose content type is
+// described by the corresponding format enumeration. Buffers and strides must
+// be aligned to their format element size.
+struct OZZ_GEOMETRY_DLL QuantizedSkinningJob {
+  // Default constructor, initializes default values.
+  QuantizedSkinningJob();
+
+  // Defines job constants.
+  enum Constants {
+    // Maximum number of joints influencing each vertex.
+    kMaxInfluences = 64,
+  };
+
+  // Joint indices storage formats.
+  enum IndexFormat {
+    kIndexUInt8,   // uint8_t indices, up to 256 joints.
+    kIndexUInt16,  // uint16_t indices.
+  };
+
+  // Joint weights storage formats.
+  enum WeightFormat {
+    kWeightUNorm8,   // uint8_t normalized weights, 0 to 255 maps to [0,1].
+    kWeightUNorm16,  // uint16_t normalized weights, 0 to 65535 maps to [0,1].
+    kWeightFloat,    // float weights.
+  };
+
+  // Vertex attributes (positions, normals and tangents) storage formats. Each
+  // attribute has 3 components.
+  enum AttributeFormat {
+    kAttributeHalf,     // IEEE 754 half-float components.
+    kAttributeSNorm16,  // int16_t normalized components, mapping to [-1,1].
+    kAttributeFloat,    // float components.
+  };
+
+  // Validates job parameters.
+  // Returns true for a valid job, false otherwise:
+  // - if influences_count is 0 or greater than kMaxInfluences.
+  // - if any range is invalid, or not large enough for its format and stride.
+  // - if any buffer or stride isn't aligned to its format element size.
+  // - if normals are provided but positions aren't.
+  // - if tangents are provided but normals aren't.
+  // - if no output is provided while an input is. For example, if input normals
+  // are provided, then output normals must also.
+  bool Validate() const;
+
+  // Runs job's skinning task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Number of vertices to transform. All input and output arrays must store at
+  // least this number of vertices.
+  int vertex_count;
+
+  // Maximum number of joints influencing each vertex. Must be greater than 0,
+  // and lower or equal to kMaxInfluences. See SkinningJob::influences_count
+  // for details.
+  int influences_count;
+
+  // Array of matrices for each joint. Joint are indexed through indices array.
+  span<const math::Float4x4> joint_matrices;
+
+  // Optional array of inverse transposed matrices for each joint. See
+  // SkinningJob::joint_inverse_transpose_matrices for details.
+  span<const math::Float4x4> joint_inverse_transpose_matrices;
+
+  // Array of joints indices, influences_count indices per vertex, stored with
+  // joint_indices_format.
+  span<const byte> joint_indices;
+  size_t joint_indices_stride;
+  IndexFormat joint_indices_format;
+
+  // Array of joints weights, influences_count - 1 weights per vertex, stored
+  // with joint_weights_format. The weight of the last joint is restored at
+  // runtime. Normalized weights quantization error is thus accumulated on the
+  // last joint, and the sum of the weights remains 1.
+  span<const byte> joint_weights;
+  size_t joint_weights_stride;
+  WeightFormat joint_weights_format;
+
+  // Input vertex positions array, stored with in_positions_format, and stride
+  // (number of bytes between each position).
+  // Decoded positions are scaled by in_positions_scale and offset by
+  // in_positions_offset, before being transformed. This allows to use
+  // normalized formats, whose range is [-1,1], to store positions of any size.
+  span<const byte> in_positions;
+  size_t in_positions_stride;
+  AttributeFormat in_positions_format;
+  math::Float3 in_positions_scale;
+  math::Float3 in_positions_offset;
+
+  // Input vertex normals array, stored with in_normals_format, and stride
+  // (number of bytes between each normal).
+  span<const byte> in_normals;
+  size_t in_normals_stride;
+  AttributeFormat in_normals_format;
+
+  // Input vertex tangents array, stored with in_tangents_format, and stride
+  // (number of bytes between each tangent).
+  span<const byte> in_tangents;
+  size_t in_tangents_stride;
+  AttributeFormat in_tangents_format;
+
+  // Output vertex positions (3 float values per vertex) array and stride
+  // (number of bytes between each position).
+  span<float> out_positions;
+  size_t out_positions_stride;
+
+  // Output vertex normals (3 float values per vertex) array and stride (number
+  // of bytes between each normal). Output normals are not normalized.
+  span<float> out_normals;
+  size_t out_normals_stride;
+
+  // Output vertex tangents (3 float values per vertex) array and stride
+  // (number of bytes between each tangent). Output tangents are not
+  // normalized.
+  span<float> out_tangents;
+  size_t out_tangents_stride;
+};
+}  // namespace geometry
+}  // namespace ozz
+#endif  // OZZ_OZZ_GEOMETRY_RUNTIME_QUANTIZED_SKINNING_JOB_H_
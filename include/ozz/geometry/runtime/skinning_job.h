@@ -33,6 +33,10 @@
 #include "ozz/geometry/runtime/export.h"
 
 namespace ozz {
+
+// Forward declare scheduler interface.
+class Scheduler;
+
 namespace math {
 struct Float4x4;
 }
@@ -72,6 +76,11 @@ namespace geometry {
 // joints matrices (see http://www.glprogramming.com/red/appendixf.html). This
 // code path is less efficient than the one without this matrices set, and
 // should only be used when input matrices have non uniform scaling or shearing.
+// A big mesh can be skinned on multiple cores by providing a scheduler, in
+// which case vertices are split into chunks of consecutive vertices. Grouping
+// vertices that share the same joints (see
+// ozz::geometry::offline::ComputeJointSetOrder) improves matrix palette
+// locality within a chunk.
 // The job does not owned the buffers (in/output) and will thus not delete them
 // during job's destruction.
 struct OZZ_GEOMETRY_DLL SkinningJob {
@@ -85,6 +94,7 @@ struct OZZ_GEOMETRY_DLL SkinningJob {
   // - if tangents are provided but normals aren't.
   // - if no output is provided while an input is. For example, if input normals
   // are provided, then output normals must also.
+  // - if grain_size isn't greater than 0.
   bool Validate() const;
 
   // Runs job's skinning task.
@@ -179,6 +189,13 @@ struct OZZ_GEOMETRY_DLL SkinningJob {
   // Array length must be at least vertex_count * out_tangents_stride.
   span<float> out_tangents;
   size_t out_tangents_stride;
+
+  // Optional scheduler used to skin vertex chunks concurrently. Runs on the
+  // calling thread if nullptr.
+  Scheduler* scheduler;
+
+  // Number of vertices skinned by a scheduler task. Must be greater than 0.
+  int grain_size;
 };
 }  // namespace geometry
 }  // namespace ozz
@@ -39,6 +39,7 @@
 #include "ozz/base/maths/math_ex.h"
 #include "ozz/base/maths/simd_math.h"
 #include "ozz/base/memory/allocator.h"
+#include "ozz/geometry/offline/vertex_order.h"
 #include "ozz/options/options.h"
 
 // Declares command line options.
@@ -51,6 +52,10 @@ OZZ_OPTIONS_DECLARE_BOOL(split,
                          "Split the skinned mesh into parts (number of joint "
                          "influences per vertex).",
                          true, false)
+OZZ_OPTIONS_DECLARE_BOOL(sort,
+                         "Sorts vertices of each part by joint set, to improve "
+                         "skinning matrix palette locality.",
+                         true, false)
 OZZ_OPTIONS_DECLARE_INT(
     max_influences,
     "Maximum number of joint influences per vertex (0 means no limitation).", 0,
@@ -720,6 +725,32 @@ bool SplitParts(const ozz::sample::Mesh& _skinned_mesh,
     }
   }
 
+  // Sorts bucket vertices by joint set, so that consecutive vertices use the
+  // same joint matrices when skinned.
+  if (OPTIONS_sort) {
+    for (size_t i = 0; i < bucked_vertices.size(); ++i) {
+      BuckedVertices::reference bucket = bucked_vertices[i];
+      const size_t influences = i + 1;
+      ozz::vector<uint16_t> indices(bucket.size() * influences);
+      for (size_t j = 0; j < bucket.size(); ++j) {
+        const uint16_t* in_indices =
+            &in_part.joint_indices[bucket[j] * max_influences];
+        std::copy(in_indices, in_indices + influences,
+                  &indices[j * influences]);
+      }
+      ozz::vector<uint32_t> order(bucket.size());
+      if (!ozz::geometry::offline::ComputeJointSetOrder(
+              ozz::make_span(indices), static_cast<int>(influences),
+              ozz::make_span(order))) {
+        return false;
+      }
+      const ozz::vector<size_t> unsorted = bucket;
+      for (size_t j = 0; j < bucket.size(); ++j) {
+        bucket[j] = unsorted[order[j]];
+      }
+    }
+  }
+
   // Fills mesh parts.
   _partitionned_mesh->parts.reserve(max_influences);
   for (int i = 0; i < max_influences; ++i) {
@@ -28,7 +28,7 @@
 #include <algorithm>
 #include <atomic>
 #include <cstdlib>
-#include <future>
+#include <thread>
 
 #include "framework/application.h"
 #include "framework/imgui.h"
@@ -45,6 +45,7 @@
 #include "ozz/base/maths/simd_math.h"
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/maths/vec_float.h"
+#include "ozz/base/scheduler.h"
 #include "ozz/options/options.h"
 
 #if EMSCRIPTEN
@@ -72,8 +73,9 @@ const int kDepth = 16;
 // The maximum number of characters.
 const int kMaxCharacters = 4096;
 
-// The minimum number of characters per task.
-const int kMinGrainSize = 32;
+// The minimum number of characters per task. Scheduler balances workload by
+// stealing work, so tasks can be small.
+const int kMinGrainSize = 1;
 
 // Checks if platform has threading support.
 bool HasThreadingSupport() {
@@ -128,15 +130,6 @@ class MultithreadSampleApplication : public ozz::sample::Application {
     return true;
   }
 
-  // Data structure used to pass const arguments to parallel tasks.
-  struct ParallelArgs {
-    const ozz::animation::Animation* animation;
-    const ozz::animation::Skeleton* skeleton;
-    float dt;
-    int grain_size;  // Maximum number of characters that can be processed by a
-                     // task.
-  };
-
   // Data used to monitor and analyze threading.
   // Every task will push its thread id to an array. We can then process it to
   // find how many threads were used.
@@ -145,10 +138,8 @@ class MultithreadSampleApplication : public ozz::sample::Application {
     ParallelMonitor() {
       // Finds the maximum possible number of tasks considering kMinGrain grain
       // size for kMaxCharacters characters.
-      int max_tasks = 1;
-      for (int processed = kMinGrainSize; processed < kMaxCharacters;
-           processed *= 2, max_tasks *= 2) {
-      }
+      const int max_tasks =
+          (kMaxCharacters + kMinGrainSize - 1) / kMinGrainSize;
       thread_ids_.resize(max_tasks);
       num_async_tasks_.store(0);
     }
@@ -178,31 +169,6 @@ class MultithreadSampleApplication : public ozz::sample::Application {
     std::atomic_uint num_async_tasks_;
   };
 
-  static bool ParallelUpdate(const ParallelArgs& _args, Character* _characters,
-                             int _num, ParallelMonitor* _monitor) {
-    bool success = true;
-    if (_num <= _args.grain_size) {
-      _monitor->PushTask();
-
-      for (int i = 0; i < _num; ++i) {
-        success &= UpdateCharacter(*_args.animation, *_args.skeleton, _args.dt,
-                                   &_characters[i]);
-      }
-    } else {
-      // Run half the job on an async task, possibly another thread.
-      const int half = _num / 2;
-      auto handle = std::async(std::launch::async, ParallelUpdate, _args,
-                               _characters + half, _num - half, _monitor);
-
-      // The other half is processed by this thread.
-      success &= ParallelUpdate(_args, _characters, half, _monitor);
-
-      // Get result of the async task or process it if it's not started yet.
-      success &= handle.get();
-    }
-    return success;
-  }
-
   // Updates current animation time.
   virtual bool OnUpdate(float _dt, float) {
     bool success = true;
@@ -210,9 +176,23 @@ class MultithreadSampleApplication : public ozz::sample::Application {
       // Initialize task counter. It's only used to monitor threading behavior.
       monitor_.Reset();
 
-      const ParallelArgs args = {&animation_, &skeleton_, _dt, grain_size_};
-      success = ParallelUpdate(args, array_begin(characters_), num_characters_,
-                               &monitor_);
+      // Characters are distributed to scheduler workers, by tasks of at most
+      // grain_size_ characters.
+      std::atomic_bool parallel_success(true);
+      ozz::ParallelFor(
+          &scheduler_, num_characters_, grain_size_,
+          [&](int _begin, int _end, int) {
+            monitor_.PushTask();
+            bool task_success = true;
+            for (int i = _begin; i < _end; ++i) {
+              task_success &= UpdateCharacter(animation_, skeleton_, _dt,
+                                              array_begin(characters_) + i);
+            }
+            if (!task_success) {
+              parallel_success = false;
+            }
+          });
+      success = parallel_success;
     } else {
       for (int i = 0; i < num_characters_; ++i) {
         success &= UpdateCharacter(animation_, skeleton_, _dt,
@@ -358,7 +338,10 @@ class MultithreadSampleApplication : public ozz::sample::Application {
   bool enable_theading_ = has_threading_support_;
 
   // Define the number of characters that a task can handle.
-  int grain_size_ = 128;
+  int grain_size_ = 16;
+
+  // Scheduler used to update characters, with a thread per hardware thread.
+  ozz::ThreadPoolScheduler scheduler_{has_threading_support_ ? -1 : 0};
 
   // Data used to monitor and analyze threading.
   ParallelMonitor monitor_;
@@ -93,18 +93,28 @@ class PartialBlendSampleApplication : public ozz::sample::Application {
 
     // Prepares blending layers.
     ozz::animation::BlendingJob::Layer layers[kNumLayers];
-    for (size_t i = 0; i < kNumLayers; ++i) {
-      layers[i].transform = make_span(samplers_[i].locals);
-      layers[i].weight = samplers_[i].weight_setting;
+    size_t num_layers = 0;
+    for (const Sampler& sampler : samplers_) {
+      // Skips layers that don't affect any joint, as an empty soa_joints list
+      // would mean all joints are affected.
+      if (sampler.soa_joints.empty()) {
+        continue;
+      }
+      ozz::animation::BlendingJob::Layer& layer = layers[num_layers++];
+      layer.transform = make_span(sampler.locals);
+      layer.weight = sampler.weight_setting;
 
       // Set per-joint weights for the partially blended layer.
-      layers[i].joint_weights = make_span(samplers_[i].joint_weights);
+      layer.joint_weights = make_span(sampler.joint_weights);
+
+      // Only blends joints that are affected by the layer.
+      layer.soa_joints = sampler.soa_joints;
     }
 
     // Setups blending job.
     ozz::animation::BlendingJob blend_job;
     blend_job.threshold = threshold_;
-    blend_job.layers = layers;
+    blend_job.layers = ozz::make_span(layers).first(num_layers);
     blend_job.rest_pose = skeleton_.joint_rest_poses();
     blend_job.output = make_span(locals_);
 
@@ -159,6 +169,7 @@ class PartialBlendSampleApplication : public ozz::sample::Application {
       // Allocates per-joint weights used for the partial animation. Note that
       // this is a Soa structure.
       sampler.joint_weights.resize(num_soa_joints);
+      sampler.soa_joints_buffer.resize(num_soa_joints);
 
       // Allocates a context that matches animation requirements.
       sampler.context.Resize(num_joints);
@@ -229,6 +240,16 @@ class PartialBlendSampleApplication : public ozz::sample::Application {
     WeightSetupIterator upper_it(&upper_body_sampler.joint_weights,
                                  upper_body_sampler.joint_weight_setting);
     ozz::animation::IterateJointsDF(skeleton_, upper_it, upper_body_root_);
+
+    // Lists soa joints with a non-zero weight, so that blending job skips the
+    // others.
+    for (Sampler& sampler : samplers_) {
+      size_t count = 0;
+      ozz::animation::ExtractLayerSoaJoints(
+          make_span(sampler.joint_weights),
+          make_span(sampler.soa_joints_buffer), &count);
+      sampler.soa_joints = make_span(sampler.soa_joints_buffer).first(count);
+    }
   }
 
   virtual bool OnGui(ozz::sample::ImGui* _im_gui) {
@@ -367,6 +388,11 @@ class PartialBlendSampleApplication : public ozz::sample::Application {
     // select which joints are considered during blending, and their individual
     // weight_setting.
     ozz::vector<ozz::math::SimdFloat4> joint_weights;
+
+    // List of the soa joints affected by joint_weights, stored in
+    // soa_joints_buffer. The layer is skipped if it's empty.
+    ozz::vector<uint16_t> soa_joints_buffer;
+    ozz::span<const uint16_t> soa_joints;
   } samplers_[kNumLayers];  // kNumLayers animations to blend.
 
   // Index of the joint at the base of the upper body hierarchy.
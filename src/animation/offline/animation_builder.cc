@@ -31,12 +31,14 @@
 #include <cassert>
 #include <cstddef>
 #include <cstring>
+#include <iterator>
 #include <limits>
 #include <numeric>
 
 #include "ozz/animation/offline/raw_animation.h"
 #include "ozz/animation/offline/raw_animation_utils.h"
 #include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/skeleton.h"
 #include "ozz/base/containers/vector.h"
 #include "ozz/base/encode/group_varint.h"
 #include "ozz/base/maths/math_ex.h"
@@ -45,6 +47,7 @@
 
 // Internal include file
 #define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "animation/offline/hierarchy.h"
 #include "animation/runtime/animation_keyframe.h"
 
 namespace ozz {
@@ -52,16 +55,21 @@ namespace animation {
 namespace offline {
 namespace {
 
-template <typename _Key>
+template <typename _Key, typename _Tangent>
 struct SortingKey {
+  typedef _Tangent Tangent;
   uint16_t track;
   float prev_key_time;
   _Key key;
+  // Hermite tangent of the key, null if the track is linearly interpolated.
+  _Tangent tangent;
 };
 
-typedef SortingKey<RawAnimation::TranslationKey> SortingTranslationKey;
-typedef SortingKey<RawAnimation::RotationKey> SortingQuaternionKey;
-typedef SortingKey<RawAnimation::ScaleKey> SortingScaleKey;
+typedef SortingKey<RawAnimation::TranslationKey, math::Float3>
+    SortingTranslationKey;
+typedef SortingKey<RawAnimation::RotationKey, math::Float4>
+    SortingQuaternionKey;
+typedef SortingKey<RawAnimation::ScaleKey, math::Float3> SortingScaleKey;
 
 // Keyframe sorting. Stores first by time and then track number.
 template <typename _Key>
@@ -77,17 +85,23 @@ void PushBackIdentityKey(uint16_t _track, float _time, _DestTrack* _dest) {
   if (!_dest->empty() && _dest->back().track == _track) {
     prev_time = _dest->back().key.time;
   }
-  const DestKey key = {_track, prev_time, {_time, _SrcKey::identity()}};
+  const DestKey key = {_track, prev_time, {_time, _SrcKey::identity()},
+                       DestKey::Tangent::zero()};
   _dest->push_back(key);
 }
 
 // Copies a track from a RawAnimation to an Animation.
-// Also fixes up the front (t = 0) and back keys (t = duration).
-template <typename _SrcTrack, typename _DestTrack>
-void CopyRaw(const _SrcTrack& _src, uint16_t _track, float _duration,
-             _DestTrack* _dest) {
+// Also fixes up the front (t = 0) and back keys (t = duration). Added keys hold
+// the value, so their tangent is null. _tangents is either empty or has one
+// tangent per key.
+template <typename _SrcTrack, typename _Tangents, typename _DestTrack>
+void CopyRaw(const _SrcTrack& _src, const _Tangents& _tangents,
+             uint16_t _track, float _duration, _DestTrack* _dest) {
   typedef typename _SrcTrack::value_type SrcKey;
   typedef typename _DestTrack::value_type DestKey;
+  typedef typename DestKey::Tangent Tangent;
+  assert(_tangents.empty() || _tangents.size() == _src.size());
+  const Tangent zero = Tangent::zero();
 
   if (_src.size() == 0) {  // Adds 2 new keys.
     PushBackIdentityKey<SrcKey, _DestTrack>(_track, 0.f, _dest);
@@ -95,26 +109,29 @@ void CopyRaw(const _SrcTrack& _src, uint16_t _track, float _duration,
   } else if (_src.size() == 1) {  // Adds 1 new key.
     const SrcKey& raw_key = _src.front();
     assert(raw_key.time >= 0 && raw_key.time <= _duration);
-    const DestKey first = {_track, -1.f, {0.f, raw_key.value}};
+    const DestKey first = {_track, -1.f, {0.f, raw_key.value}, zero};
     _dest->push_back(first);
-    const DestKey last = {_track, 0.f, {_duration, raw_key.value}};
+    const DestKey last = {_track, 0.f, {_duration, raw_key.value}, zero};
     _dest->push_back(last);
   } else {  // Copies all keys, and fixes up first and last keys.
     float prev_time = -1.f;
     if (_src.front().time != 0.f) {  // Needs a key at t = 0.f.
-      const DestKey first = {_track, prev_time, {0.f, _src.front().value}};
+      const DestKey first = {_track, prev_time, {0.f, _src.front().value},
+                             zero};
       _dest->push_back(first);
       prev_time = 0.f;
     }
     for (size_t k = 0; k < _src.size(); ++k) {  // Copies all keys.
       const SrcKey& raw_key = _src[k];
       assert(raw_key.time >= 0 && raw_key.time <= _duration);
-      const DestKey key = {_track, prev_time, {raw_key.time, raw_key.value}};
+      const DestKey key = {_track, prev_time, {raw_key.time, raw_key.value},
+                           _tangents.empty() ? zero : _tangents[k]};
       _dest->push_back(key);
       prev_time = raw_key.time;
     }
     if (_src.back().time - _duration != 0.f) {  // Needs a key at t = _duration.
-      const DestKey last = {_track, prev_time, {_duration, _src.back().value}};
+      const DestKey last = {_track, prev_time, {_duration, _src.back().value},
+                            zero};
       _dest->push_back(last);
     }
   }
@@ -122,9 +139,41 @@ void CopyRaw(const _SrcTrack& _src, uint16_t _track, float _duration,
          _dest->back().key.time - _duration == 0.f);
 }
 
-template <typename _SortingKey, class _Lerp, class _Compare>
+// Computes the tangent half way between _a and _b hermite keys, _interval
+// apart.
+math::Float3 HalfTangent(const math::Float3& _a, const math::Float3& _a_tangent,
+                         const math::Float3& _b, const math::Float3& _b_tangent,
+                         float _interval) {
+  return (_b - _a) * (1.5f / _interval) - (_a_tangent + _b_tangent) * .25f;
+}
+
+// Rotation keys are normalized, so the tangent is the derivative of the
+// normalized interpolated quaternion.
+math::Float4 HalfTangent(const math::Quaternion& _a,
+                         const math::Float4& _a_tangent,
+                         const math::Quaternion& _b,
+                         const math::Float4& _b_tangent, float _interval) {
+  const math::Float4 a(_a.x, _a.y, _a.z, _a.w);
+  const math::Float4 b(_b.x, _b.y, _b.z, _b.w);
+  const math::Float4 value =
+      (a + b) * .5f + (_a_tangent - _b_tangent) * (_interval * .125f);
+  const math::Float4 derivative =
+      (b - a) * (1.5f / _interval) - (_a_tangent + _b_tangent) * .25f;
+  const float length = Length(value);
+  if (length == 0.f) {
+    return math::Float4::zero();
+  }
+  const math::Float4 normalized = value / length;
+  return (derivative - normalized * Dot(normalized, derivative)) / length;
+}
+
+// Sorts keys, and inserts keys half way between keys that would be too far
+// apart. Inserted keys are interpolated with _hermite if _is_hermite, with
+// _lerp otherwise.
+template <typename _SortingKey, class _Lerp, class _Hermite, class _Compare>
 void Sort(ozz::vector<_SortingKey>& _src, size_t _num_tracks,
-          const _Lerp& _lerp, const _Compare& _comp) {
+          bool _is_hermite, const _Lerp& _lerp, const _Hermite& _hermite,
+          const _Compare& _comp) {
   // Sorts whole vector
   std::sort(_src.begin(), _src.end(), _comp);
 
@@ -154,11 +203,22 @@ void Sort(ozz::vector<_SortingKey>& _src, size_t _num_tracks,
         const _SortingKey penultimate = _src[previous.second];
 
         // Prepares new key to insert.
-        const _SortingKey insert = {
-            track,
-            penultimate.key.time,
-            {(penultimate.key.time + last.key.time) * .5f,
-             _lerp(penultimate.key.value, last.key.value, .5f)}};
+        _SortingKey insert;
+        insert.track = track;
+        insert.prev_key_time = penultimate.key.time;
+        insert.key.time = (penultimate.key.time + last.key.time) * .5f;
+        if (_is_hermite) {
+          const float interval = last.key.time - penultimate.key.time;
+          insert.key.value =
+              _hermite(penultimate.key.value, penultimate.tangent,
+                       last.key.value, last.tangent, interval, .5f);
+          insert.tangent =
+              HalfTangent(penultimate.key.value, penultimate.tangent,
+                          last.key.value, last.tangent, interval);
+        } else {
+          insert.key.value = _lerp(penultimate.key.value, last.key.value, .5f);
+          insert.tangent = _SortingKey::Tangent::zero();
+        }
 
         // Removes previous.first key that is changing and needs to be resorted.
         _src.erase(_src.begin() + previous.first);
@@ -231,7 +291,7 @@ void Compress(const span<const float>& _timepoints,
     _base.previouses[i] = static_cast<uint16_t>(diff);
 
     // Value
-    _compressor(src.key.value, &dest_key);
+    _compressor(src, &dest_key);
 
     // Stores track position
     previouses[src.track] = &dest_key;
@@ -245,11 +305,36 @@ void CompressFloat3(const ozz::math::Float3& _src,
   _dest->values[2] = ozz::math::FloatToHalf(_src.z);
 }
 
+void CompressFloat4(const ozz::math::Float4& _src,
+                    ozz::animation::internal::Float4Key* _dest) {
+  _dest->values[0] = ozz::math::FloatToHalf(_src.x);
+  _dest->values[1] = ozz::math::FloatToHalf(_src.y);
+  _dest->values[2] = ozz::math::FloatToHalf(_src.z);
+  _dest->values[3] = ozz::math::FloatToHalf(_src.w);
+}
+
+// Compresses tangents of sorted keys. They're stored as derivatives over the
+// animation ratio rather than time, hence scaled by _duration.
+template <typename _SortingKey, typename _DestKey, typename _Compressor>
+void CompressTangents(const span<_SortingKey>& _src, float _duration,
+                      const span<_DestKey> _dest,
+                      const _Compressor& _compressor) {
+  assert(_dest.empty() || _dest.size() == _src.size());
+  for (size_t i = 0; i < _dest.size(); ++i) {
+    _compressor(_src[i].tangent * _duration, &_dest[i]);
+  }
+}
+
 // Compares float absolute values.
 bool LessAbs(float _left, float _right) {
   return std::abs(_left) < std::abs(_right);
 }
 
+// Indices of the 3 smallest quaternion components, according to the largest
+// one.
+const int kSmallestMapping[4][3] = {
+    {1, 2, 3}, {0, 2, 3}, {0, 1, 3}, {0, 1, 2}};
+
 // Compresses quaternion to ozz::animation::RotationKey format.
 // The 3 smallest components of the quaternion are quantized to x bits
 // integers, while the largest is recomputed thanks to quaternion
@@ -267,8 +352,7 @@ void CompressQuaternion(const ozz::math::Quaternion& _src,
   // Quantize the 3 smallest components on x bits signed integers.
   const float kScale = internal::QuaternionKey::kfScale / math::kSqrt2;
   const float kOffset = -math::kSqrt2_2;
-  const int kMapping[4][3] = {{1, 2, 3}, {0, 2, 3}, {0, 1, 3}, {0, 1, 2}};
-  const int* map = kMapping[largest];
+  const int* map = kSmallestMapping[largest];
   const int cpnt[3] = {
       math::Min(static_cast<int>((quat[map[0]] - kOffset) * kScale + .5f),
                 internal::QuaternionKey::kiScale),
@@ -283,16 +367,21 @@ void CompressQuaternion(const ozz::math::Quaternion& _src,
 // Normalize quaternions. Fixes-up successive opposite quaternions that would
 // fail to take the shortest path during the normalized-lerp. Note that keys
 // are still sorted per-track at that point, which allows this algorithm to
-// process all consecutive keys.
+// process all consecutive keys. Tangents follow their quaternion.
 void FixupQuaternions(ozz::vector<SortingQuaternionKey>* _src) {
   size_t track = std::numeric_limits<size_t>::max();
   const math::Quaternion identity = math::Quaternion::identity();
   for (size_t i = 0; i < _src->size(); ++i) {
     SortingQuaternionKey& src = _src->at(i);
     math::Quaternion normalized = NormalizeSafe(src.key.value, identity);
+    const float length = Length(math::Float4(src.key.value.x, src.key.value.y,
+                                             src.key.value.z, src.key.value.w));
+    math::Float4 tangent =
+        length != 0.f ? src.tangent / length : math::Float4::zero();
     if (track != _src->at(i).track) {  // First key of the track.
       if (normalized.w < 0.f) {    // .w eq to a dot with identity quaternion.
         normalized = -normalized;  // Q an -Q are the same rotation.
+        tangent = -tangent;
       }
     } else {  // Still on the same track: so fixes-up quaternion.
       const SortingQuaternionKey& prev_src = _src->at(i - 1);
@@ -302,14 +391,306 @@ void FixupQuaternions(ozz::vector<SortingQuaternionKey>* _src) {
                               normalized.w);
       if (Dot(prev, curr) < 0.f) {
         normalized = -normalized;  // Q an -Q are the same rotation.
+        tangent = -tangent;
       }
     }
     // Stores fixed-up quaternion.
     src.key.value = normalized;
+    src.tangent = tangent;
     track = src.track;
   }
 }
 
+// Gets the 3 components of a value that are quantized: x, y and z for float3,
+// and the 3 smallest components for quaternions. Returns the index of the
+// largest quaternion component.
+void QuantizedComponents(const math::Float3& _value, float _cpnts[3]) {
+  _cpnts[0] = _value.x;
+  _cpnts[1] = _value.y;
+  _cpnts[2] = _value.z;
+}
+
+int QuantizedComponents(const math::Quaternion& _value, float _cpnts[3]) {
+  const float quat[4] = {_value.x, _value.y, _value.z, _value.w};
+  const int largest =
+      static_cast<int>(std::max_element(quat, quat + 4, LessAbs) - quat);
+  const int* map = kSmallestMapping[largest];
+  _cpnts[0] = quat[map[0]];
+  _cpnts[1] = quat[map[1]];
+  _cpnts[2] = quat[map[2]];
+  return largest;
+}
+
+// Quantizes _value in range [_min,_min+_scale*_iscale].
+int Quantize(float _value, float _min, float _scale, int _iscale) {
+  if (_scale == 0.f) {
+    return 0;
+  }
+  return math::Clamp(0, static_cast<int>((_value - _min) / _scale + .5f),
+                     _iscale);
+}
+
+void CompressQuantized(const math::Float3& _src,
+                       const internal::QuantizationRange& _range, int _lane,
+                       internal::QuantizedFloat3Key* _dest) {
+  float cpnts[3];
+  QuantizedComponents(_src, cpnts);
+  for (int i = 0; i < 3; ++i) {
+    _dest->values[i] = static_cast<uint8_t>(
+        Quantize(cpnts[i], _range.min[i][_lane], _range.scale[i][_lane],
+                 internal::QuantizedFloat3Key::kiScale));
+  }
+}
+
+void CompressQuantized(const math::Quaternion& _src,
+                       const internal::QuantizationRange& _range, int _lane,
+                       internal::QuantizedQuaternionKey* _dest) {
+  float cpnts[3];
+  const int largest = QuantizedComponents(_src, cpnts);
+  const float quat[4] = {_src.x, _src.y, _src.z, _src.w};
+  int quantized[3];
+  for (int i = 0; i < 3; ++i) {
+    quantized[i] =
+        Quantize(cpnts[i], _range.min[i][_lane], _range.scale[i][_lane],
+                 internal::QuantizedQuaternionKey::kiScale);
+  }
+  pack(largest, quat[largest] < 0.f, quantized, _dest);
+}
+
+// Decompresses quantized keys the same way SamplingJob does, in order to
+// evaluate quantization error.
+math::Float3 DecompressQuantized(const internal::QuantizedFloat3Key& _key,
+                                 const internal::QuantizationRange& _range,
+                                 int _lane) {
+  float cpnts[3];
+  for (int i = 0; i < 3; ++i) {
+    cpnts[i] = _range.min[i][_lane] + _range.scale[i][_lane] * _key.values[i];
+  }
+  return math::Float3(cpnts[0], cpnts[1], cpnts[2]);
+}
+
+math::Quaternion DecompressQuantized(
+    const internal::QuantizedQuaternionKey& _key,
+    const internal::QuantizationRange& _range, int _lane) {
+  int largest, sign, values[3];
+  unpack(_key, largest, sign, values);
+  float quat[4];
+  float dot = 0.f;
+  const int* map = kSmallestMapping[largest];
+  for (int i = 0; i < 3; ++i) {
+    const float cpnt =
+        _range.min[i][_lane] + _range.scale[i][_lane] * values[i];
+    quat[map[i]] = cpnt;
+    dot += cpnt * cpnt;
+  }
+  const float restored = std::sqrt(math::Max(0.f, 1.f - dot));
+  quat[largest] = sign ? -restored : restored;
+  return math::Quaternion(quat[0], quat[1], quat[2], quat[3]);
+}
+
+template <typename _DestKey>
+struct BuilderConstants {
+  // Number of animated tracks, a multiple of 4.
+  uint16_t num_tracks = 0;
+
+  // Soa tracks remapping, animated soa tracks first (then quantized ones if
+  // any, see ExtractQuantized).
+  ozz::vector<uint16_t> soa_tracks;
+
+  // Compressed keys of constant soa tracks, 4 per soa track.
+  ozz::vector<_DestKey> keys;
+};
+
+// Extracts soa tracks whose 4 tracks are constant, meaning all their keys
+// compress to the same value, with null tangents. Keys of constant soa tracks
+// are removed from _src, while remaining tracks are renumbered so that animated
+// soa tracks are consecutive. Note that keys are still sorted per-track at that
+// point.
+template <typename _DestKey, typename _SortingKey, typename _Compressor>
+BuilderConstants<_DestKey> ExtractConstants(ozz::vector<_SortingKey>* _src,
+                                            uint16_t _num_tracks,
+                                            const _Compressor& _compressor) {
+  BuilderConstants<_DestKey> constants;
+
+  // Compares all keys of a track with its first one.
+  ozz::vector<_DestKey> firsts(_num_tracks);
+  ozz::vector<bool> constant_tracks(_num_tracks, true);
+  int track = -1;
+  for (const _SortingKey& src : *_src) {
+    _DestKey key;
+    _compressor(src.key.value, &key);
+    if (track != src.track) {  // First key of the track.
+      track = src.track;
+      firsts[track] = key;
+    } else if (!std::equal(std::begin(key.values), std::end(key.values),
+                           std::begin(firsts[track].values))) {
+      constant_tracks[track] = false;
+    }
+    if (!(src.tangent == _SortingKey::Tangent::zero())) {
+      constant_tracks[track] = false;
+    }
+  }
+
+  // Builds soa tracks remapping, animated soa tracks first.
+  const uint16_t num_soa_tracks = _num_tracks / 4;
+  ozz::vector<bool> constant_soa_tracks(num_soa_tracks);
+  ozz::vector<uint16_t> animated_soa_tracks(num_soa_tracks);
+  for (uint16_t i = 0; i < num_soa_tracks; ++i) {
+    constant_soa_tracks[i] =
+        constant_tracks[i * 4 + 0] && constant_tracks[i * 4 + 1] &&
+        constant_tracks[i * 4 + 2] && constant_tracks[i * 4 + 3];
+    if (!constant_soa_tracks[i]) {
+      animated_soa_tracks[i] =
+          static_cast<uint16_t>(constants.soa_tracks.size());
+      constants.soa_tracks.push_back(i);
+    }
+  }
+  constants.num_tracks = static_cast<uint16_t>(constants.soa_tracks.size() * 4);
+  for (uint16_t i = 0; i < num_soa_tracks; ++i) {
+    if (constant_soa_tracks[i]) {
+      constants.soa_tracks.push_back(i);
+      constants.keys.insert(constants.keys.end(), firsts.begin() + i * 4,
+                            firsts.begin() + i * 4 + 4);
+    }
+  }
+
+  // Removes constant soa tracks keys, and renumbers animated ones.
+  _src->erase(std::remove_if(_src->begin(), _src->end(),
+                             [&constant_soa_tracks](const _SortingKey& _key) {
+                               return constant_soa_tracks[_key.track / 4];
+                             }),
+              _src->end());
+  for (_SortingKey& src : *_src) {
+    src.track = static_cast<uint16_t>(animated_soa_tracks[src.track / 4] * 4 +
+                                      src.track % 4);
+  }
+
+  return constants;
+}
+
+template <typename _DestKey>
+void CopyConstants(const BuilderConstants<_DestKey>& _src,
+                   const span<uint16_t>& _soa_tracks,
+                   const span<_DestKey>& _keys) {
+  assert(_soa_tracks.size() == _src.soa_tracks.size());
+  std::copy(_src.soa_tracks.begin(), _src.soa_tracks.end(),
+            _soa_tracks.begin());
+  assert(_keys.size() == _src.keys.size());
+  std::copy(_src.keys.begin(), _src.keys.end(), _keys.begin());
+}
+
+template <typename _SortingKey>
+struct BuilderQuantized {
+  // Number of quantized tracks, a multiple of 4.
+  uint16_t num_tracks = 0;
+
+  // Keys of quantized soa tracks, still sorted.
+  ozz::vector<_SortingKey> keys;
+
+  // Quantization range of each quantized soa track.
+  ozz::vector<internal::QuantizationRange> ranges;
+};
+
+// Extracts animated soa tracks whose keys can be quantized within their range,
+// as long as _accept(joint, value, quantized value) accepts the error of all
+// their keys, and quantization actually saves memory. Keys are already sorted,
+// they're moved to the quantized series while keeping their order. Tracks of
+// both series are renumbered so that soa tracks are consecutive, which doesn't
+// change sorting order. _constants soa tracks remapping is updated
+// accordingly.
+template <typename _QuantizedKey, typename _DestKey, typename _SortingKey,
+          typename _Accept>
+BuilderQuantized<_SortingKey> ExtractQuantized(
+    ozz::vector<_SortingKey>* _src, BuilderConstants<_DestKey>* _constants,
+    const _Accept& _accept) {
+  BuilderQuantized<_SortingKey> quantized;
+  const uint16_t num_tracks = _constants->num_tracks;
+  const uint16_t num_soa_tracks = num_tracks / 4;
+
+  // Computes quantization range of every animated track.
+  const float kMax = std::numeric_limits<float>::max();
+  ozz::vector<float> mins(num_tracks * 3, kMax);
+  ozz::vector<float> maxs(num_tracks * 3, -kMax);
+  for (const _SortingKey& src : *_src) {
+    float cpnts[3];
+    QuantizedComponents(src.key.value, cpnts);
+    for (int i = 0; i < 3; ++i) {
+      mins[src.track * 3 + i] = math::Min(mins[src.track * 3 + i], cpnts[i]);
+      maxs[src.track * 3 + i] = math::Max(maxs[src.track * 3 + i], cpnts[i]);
+    }
+  }
+  ozz::vector<internal::QuantizationRange> ranges(num_soa_tracks);
+  for (uint16_t track = 0; track < num_tracks; ++track) {
+    internal::QuantizationRange& range = ranges[track / 4];
+    for (int i = 0; i < 3; ++i) {
+      const float min = mins[track * 3 + i];
+      range.min[i][track % 4] = min;
+      range.scale[i][track % 4] =
+          (maxs[track * 3 + i] - min) / _QuantizedKey::kfScale;
+    }
+  }
+
+  // Evaluates quantization error of every key.
+  ozz::vector<bool> accepted(num_soa_tracks, true);
+  ozz::vector<size_t> counts(num_soa_tracks, 0);
+  for (const _SortingKey& src : *_src) {
+    const uint16_t soa_track = src.track / 4;
+    const int lane = src.track % 4;
+    ++counts[soa_track];
+    if (!accepted[soa_track]) {
+      continue;
+    }
+    _QuantizedKey key;
+    CompressQuantized(src.key.value, ranges[soa_track], lane, &key);
+    const int joint = _constants->soa_tracks[soa_track] * 4 + lane;
+    accepted[soa_track] = _accept(
+        joint, src.key.value, DecompressQuantized(key, ranges[soa_track], lane));
+  }
+
+  // Selects quantized soa tracks and builds their new index in their series.
+  ozz::vector<bool> quantize(num_soa_tracks);
+  ozz::vector<uint16_t> renumber(num_soa_tracks);
+  ozz::vector<uint16_t> animated_soa_tracks, quantized_soa_tracks;
+  for (uint16_t i = 0; i < num_soa_tracks; ++i) {
+    const size_t gain =
+        counts[i] * (sizeof(_DestKey) - sizeof(_QuantizedKey));
+    quantize[i] =
+        accepted[i] && gain > sizeof(internal::QuantizationRange);
+    auto& soa_tracks = quantize[i] ? quantized_soa_tracks : animated_soa_tracks;
+    renumber[i] = static_cast<uint16_t>(soa_tracks.size());
+    soa_tracks.push_back(_constants->soa_tracks[i]);
+    if (quantize[i]) {
+      quantized.ranges.push_back(ranges[i]);
+    }
+  }
+
+  // Updates soa tracks remapping: animated, quantized, then constants.
+  std::copy(animated_soa_tracks.begin(), animated_soa_tracks.end(),
+            _constants->soa_tracks.begin());
+  std::copy(quantized_soa_tracks.begin(), quantized_soa_tracks.end(),
+            _constants->soa_tracks.begin() + animated_soa_tracks.size());
+  _constants->num_tracks =
+      static_cast<uint16_t>(animated_soa_tracks.size() * 4);
+  quantized.num_tracks = static_cast<uint16_t>(quantized_soa_tracks.size() * 4);
+
+  // Moves quantized keys to their series, and renumbers all tracks.
+  auto quantized_key = [&quantize](const _SortingKey& _key) {
+    return quantize[_key.track / 4];
+  };
+  std::copy_if(_src->begin(), _src->end(), std::back_inserter(quantized.keys),
+               quantized_key);
+  _src->erase(std::remove_if(_src->begin(), _src->end(), quantized_key),
+              _src->end());
+  auto renumber_key = [&renumber](_SortingKey& _key) {
+    _key.track =
+        static_cast<uint16_t>(renumber[_key.track / 4] * 4 + _key.track % 4);
+  };
+  std::for_each(_src->begin(), _src->end(), renumber_key);
+  std::for_each(quantized.keys.begin(), quantized.keys.end(), renumber_key);
+
+  return quantized;
+}
+
 ozz::vector<float> BuildTimePoints(
     ozz::vector<SortingTranslationKey>& _translations,
     ozz::vector<SortingQuaternionKey>& _rotations,
@@ -432,14 +813,33 @@ void CopyIFrames(const BuilderIFrames& _src, Animation::KeyframesCtrl& _dest) {
 // Ensures _input's validity and allocates _animation.
 // An animation needs to have at least two key frames per joint, the first at
 // t = 0 and the last at t = duration. If at least one of those keys are not
-// in the RawAnimation then the builder creates it.
+// in the RawAnimation then the builder creates it. Soa tracks that are constant
+// are then extracted from keyframes, and stored once. If a skeleton is
+// provided, animated soa tracks that can be quantized are finally moved to
+// quantized keyframes series. Transformation types with tangents are hermite
+// interpolated, and never quantized.
 unique_ptr<Animation> AnimationBuilder::operator()(
     const RawAnimation& _input) const {
+  return Build(_input, nullptr);
+}
+
+unique_ptr<Animation> AnimationBuilder::operator()(
+    const RawAnimation& _input, const Skeleton& _skeleton) const {
+  return Build(_input, &_skeleton);
+}
+
+unique_ptr<Animation> AnimationBuilder::Build(const RawAnimation& _input,
+                                              const Skeleton* _skeleton) const {
   // Tests _raw_animation validity.
   if (!_input.Validate()) {
     return nullptr;
   }
 
+  // Tests _skeleton matches _raw_animation.
+  if (_skeleton && _skeleton->num_joints() != _input.num_tracks()) {
+    return nullptr;
+  }
+
   // Everything is fine, allocates and fills the animation.
   // Nothing can fail now.
   unique_ptr<Animation> animation = make_unique<Animation>();
@@ -474,13 +874,26 @@ unique_ptr<Animation> AnimationBuilder::operator()(
   ozz::vector<SortingScaleKey> sorting_scales;
   sorting_scales.reserve(scales);
 
+  // Transformation types are hermite interpolated if their tracks have
+  // tangents. Validation ensures all tracks with keys have some then.
+  bool translations_hermite = false, rotations_hermite = false,
+       scales_hermite = false;
+  for (const RawAnimation::JointTrack& raw_track : _input.tracks) {
+    translations_hermite |= !raw_track.translation_tangents.empty();
+    rotations_hermite |= !raw_track.rotation_tangents.empty();
+    scales_hermite |= !raw_track.scale_tangents.empty();
+  }
+
   // Filters RawAnimation keys and copies them to the output sorting structure.
   uint16_t i = 0;
   for (; i < num_tracks; ++i) {
     const RawAnimation::JointTrack& raw_track = _input.tracks[i];
-    CopyRaw(raw_track.translations, i, duration, &sorting_translations);
-    CopyRaw(raw_track.rotations, i, duration, &sorting_rotations);
-    CopyRaw(raw_track.scales, i, duration, &sorting_scales);
+    CopyRaw(raw_track.translations, raw_track.translation_tangents, i,
+            duration, &sorting_translations);
+    CopyRaw(raw_track.rotations, raw_track.rotation_tangents, i, duration,
+            &sorting_rotations);
+    CopyRaw(raw_track.scales, raw_track.scale_tangents, i, duration,
+            &sorting_scales);
   }
 
   // Add enough identity keys to match soa requirements.
@@ -500,13 +913,22 @@ unique_ptr<Animation> AnimationBuilder::operator()(
 
   FixupQuaternions(&sorting_rotations);
 
+  // Extracts constant soa tracks, so they are stored once and not sampled.
+  auto translation_constants = ExtractConstants<internal::Float3Key>(
+      &sorting_translations, num_soa_tracks, &CompressFloat3);
+  auto rotation_constants = ExtractConstants<internal::QuaternionKey>(
+      &sorting_rotations, num_soa_tracks, &CompressQuaternion);
+  auto scale_constants = ExtractConstants<internal::Float3Key>(
+      &sorting_scales, num_soa_tracks, &CompressFloat3);
+
   // Sort animation keys to favor cache coherency.
-  Sort(sorting_translations, num_soa_tracks, &LerpTranslation,
+  Sort(sorting_translations, translation_constants.num_tracks,
+       translations_hermite, &LerpTranslation, &HermiteTranslation,
        &SortingKeyLess<SortingTranslationKey>);
-  Sort(sorting_rotations, num_soa_tracks, &LerpRotation,
-       &SortingKeyLess<SortingQuaternionKey>);
-  Sort(sorting_scales, num_soa_tracks, &LerpScale,
-       &SortingKeyLess<SortingScaleKey>);
+  Sort(sorting_rotations, rotation_constants.num_tracks, rotations_hermite,
+       &LerpRotation, &HermiteRotation, &SortingKeyLess<SortingQuaternionKey>);
+  Sort(sorting_scales, scale_constants.num_tracks, scales_hermite, &LerpScale,
+       &HermiteScale, &SortingKeyLess<SortingScaleKey>);
 
   // Get all timepoints. Shall be done on sorting keys as time points might have
   // been added during the process.
@@ -525,14 +947,87 @@ unique_ptr<Animation> AnimationBuilder::operator()(
     return nullptr;
   }
 
+  // Extracts soa tracks that can be quantized within tolerance, evaluated on
+  // the skeleton hierarchy the same way AnimationOptimizer does. Padding soa
+  // tracks have no error constraint. Hermite transformation types aren't
+  // quantized, as tangents would be quantized too.
+  BuilderQuantized<SortingTranslationKey> translation_quantized;
+  BuilderQuantized<SortingQuaternionKey> rotation_quantized;
+  BuilderQuantized<SortingScaleKey> scale_quantized;
+  if (_skeleton) {
+    const ozz::vector<HierarchySpec> specs = BuildHierarchySpecs(
+        _input, *_skeleton, [this](int) { return quantization; });
+    const span<const int16_t> parents = _skeleton->joint_parents();
+
+    // Translation error is affected by parent scale.
+    auto translation_accept = [&](int _joint, const math::Float3& _value,
+                                  const math::Float3& _quantized) {
+      if (_joint >= num_tracks) {
+        return true;
+      }
+      const int parent = parents[_joint];
+      const float parent_scale =
+          parent != Skeleton::kNoParent ? specs[parent].scale : 1.f;
+      return Length(_value - _quantized) * parent_scale <=
+             specs[_joint].tolerance;
+    };
+    // Rotation error affects children translations/length.
+    auto rotation_accept = [&](int _joint, const math::Quaternion& _value,
+                               const math::Quaternion& _quantized) {
+      if (_joint >= num_tracks) {
+        return true;
+      }
+      const float cos_half_angle = Dot(_value, _quantized);
+      const float sine_half_angle =
+          std::sqrt(1.f - math::Min(1.f, cos_half_angle * cos_half_angle));
+      return 2.f * sine_half_angle * specs[_joint].length <=
+             specs[_joint].tolerance;
+    };
+    // Scale error affects children translations/length.
+    auto scale_accept = [&](int _joint, const math::Float3& _value,
+                            const math::Float3& _quantized) {
+      if (_joint >= num_tracks) {
+        return true;
+      }
+      return Length(_value - _quantized) * specs[_joint].length <=
+             specs[_joint].tolerance;
+    };
+
+    if (!translations_hermite) {
+      translation_quantized = ExtractQuantized<internal::QuantizedFloat3Key>(
+          &sorting_translations, &translation_constants, translation_accept);
+    }
+    if (!rotations_hermite) {
+      rotation_quantized = ExtractQuantized<internal::QuantizedQuaternionKey>(
+          &sorting_rotations, &rotation_constants, rotation_accept);
+    }
+    if (!scales_hermite) {
+      scale_quantized = ExtractQuantized<internal::QuantizedFloat3Key>(
+          &sorting_scales, &scale_constants, scale_accept);
+    }
+  }
+  const uint16_t num_translation_tracks = translation_constants.num_tracks;
+  const uint16_t num_rotation_tracks = rotation_constants.num_tracks;
+  const uint16_t num_scale_tracks = scale_constants.num_tracks;
+
   // Build cache snaphots/iframes.
   const auto& translation_ss =
-      BuildIFrames(make_span(sorting_translations), num_soa_tracks,
+      BuildIFrames(make_span(sorting_translations), num_translation_tracks,
+                   iframe_interval, duration);
+  const auto& rotation_ss =
+      BuildIFrames(make_span(sorting_rotations), num_rotation_tracks,
+                   iframe_interval, duration);
+  const auto& scale_ss = BuildIFrames(
+      make_span(sorting_scales), num_scale_tracks, iframe_interval, duration);
+  const auto& translation_quantized_ss =
+      BuildIFrames(make_span(translation_quantized.keys),
+                   translation_quantized.num_tracks, iframe_interval, duration);
+  const auto& rotation_quantized_ss =
+      BuildIFrames(make_span(rotation_quantized.keys),
+                   rotation_quantized.num_tracks, iframe_interval, duration);
+  const auto& scale_quantized_ss =
+      BuildIFrames(make_span(scale_quantized.keys), scale_quantized.num_tracks,
                    iframe_interval, duration);
-  const auto& rotation_ss = BuildIFrames(
-      make_span(sorting_rotations), num_soa_tracks, iframe_interval, duration);
-  const auto& scale_ss = BuildIFrames(make_span(sorting_scales), num_soa_tracks,
-                                      iframe_interval, duration);
 
   // Allocate animation members.
   const Animation::AllocateParams params{
@@ -541,25 +1036,101 @@ unique_ptr<Animation> AnimationBuilder::operator()(
       sorting_translations.size(),
       sorting_rotations.size(),
       sorting_scales.size(),
+      static_cast<size_t>(num_soa_tracks / 4),
+      translation_constants.keys.size(),
+      rotation_constants.keys.size(),
+      scale_constants.keys.size(),
       {translation_ss.entries.size(), translation_ss.desc.size()},
       {rotation_ss.entries.size(), rotation_ss.desc.size()},
-      {scale_ss.entries.size(), scale_ss.desc.size()}};
+      {scale_ss.entries.size(), scale_ss.desc.size()},
+      {translation_quantized.keys.size(),
+       translation_quantized.ranges.size(),
+       {translation_quantized_ss.entries.size(),
+        translation_quantized_ss.desc.size()}},
+      {rotation_quantized.keys.size(),
+       rotation_quantized.ranges.size(),
+       {rotation_quantized_ss.entries.size(),
+        rotation_quantized_ss.desc.size()}},
+      {scale_quantized.keys.size(),
+       scale_quantized.ranges.size(),
+       {scale_quantized_ss.entries.size(), scale_quantized_ss.desc.size()}},
+      translations_hermite ? sorting_translations.size() : 0,
+      rotations_hermite ? sorting_rotations.size() : 0,
+      scales_hermite ? sorting_scales.size() : 0};
   animation->Allocate(params);
 
   CopyIFrames(translation_ss, animation->translations_ctrl_);
   CopyIFrames(rotation_ss, animation->rotations_ctrl_);
   CopyIFrames(scale_ss, animation->scales_ctrl_);
+  CopyIFrames(translation_quantized_ss,
+              animation->translations_quantized_ctrl_);
+  CopyIFrames(rotation_quantized_ss, animation->rotations_quantized_ctrl_);
+  CopyIFrames(scale_quantized_ss, animation->scales_quantized_ctrl_);
+
+  CopyConstants(translation_constants, animation->translations_soa_tracks_,
+                animation->translations_constants_);
+  CopyConstants(rotation_constants, animation->rotations_soa_tracks_,
+                animation->rotations_constants_);
+  CopyConstants(scale_constants, animation->scales_soa_tracks_,
+                animation->scales_constants_);
+
+  std::copy(translation_quantized.ranges.begin(),
+            translation_quantized.ranges.end(),
+            animation->translations_ranges_.begin());
+  std::copy(rotation_quantized.ranges.begin(), rotation_quantized.ranges.end(),
+            animation->rotations_ranges_.begin());
+  std::copy(scale_quantized.ranges.begin(), scale_quantized.ranges.end(),
+            animation->scales_ranges_.begin());
 
   // Copy sorted keys to final animation.
+  auto compress_float3 = [](const auto& _src, internal::Float3Key* _dest) {
+    CompressFloat3(_src.key.value, _dest);
+  };
+  auto compress_quaternion = [](const SortingQuaternionKey& _src,
+                                internal::QuaternionKey* _dest) {
+    CompressQuaternion(_src.key.value, _dest);
+  };
   Compress(make_span(time_points), make_span(sorting_translations),
-           num_soa_tracks, make_span(animation->translations_values_),
-           animation->translations_ctrl_, &CompressFloat3);
-  Compress(make_span(time_points), make_span(sorting_rotations), num_soa_tracks,
-           make_span(animation->rotations_values_), animation->rotations_ctrl_,
-           &CompressQuaternion);
-  Compress(make_span(time_points), make_span(sorting_scales), num_soa_tracks,
+           num_translation_tracks, make_span(animation->translations_values_),
+           animation->translations_ctrl_, compress_float3);
+  Compress(make_span(time_points), make_span(sorting_rotations),
+           num_rotation_tracks, make_span(animation->rotations_values_),
+           animation->rotations_ctrl_, compress_quaternion);
+  Compress(make_span(time_points), make_span(sorting_scales), num_scale_tracks,
            make_span(animation->scales_values_), animation->scales_ctrl_,
-           &CompressFloat3);
+           compress_float3);
+
+  // Copy tangents of hermite keys, in the same order.
+  CompressTangents(make_span(sorting_translations), duration,
+                   animation->translations_tangents_, &CompressFloat3);
+  CompressTangents(make_span(sorting_rotations), duration,
+                   animation->rotations_tangents_, &CompressFloat4);
+  CompressTangents(make_span(sorting_scales), duration,
+                   animation->scales_tangents_, &CompressFloat3);
+
+  // Copy sorted quantized keys, using their soa track range.
+  auto compress_quantized = [](const span<const internal::QuantizationRange>&
+                                   _ranges) {
+    return [_ranges](const auto& _src, auto* _dest) {
+      CompressQuantized(_src.key.value, _ranges[_src.track / 4],
+                        _src.track % 4, _dest);
+    };
+  };
+  Compress(make_span(time_points), make_span(translation_quantized.keys),
+           translation_quantized.num_tracks,
+           make_span(animation->translations_quantized_values_),
+           animation->translations_quantized_ctrl_,
+           compress_quantized(animation->translations_ranges_));
+  Compress(make_span(time_points), make_span(rotation_quantized.keys),
+           rotation_quantized.num_tracks,
+           make_span(animation->rotations_quantized_values_),
+           animation->rotations_quantized_ctrl_,
+           compress_quantized(animation->rotations_ranges_));
+  Compress(make_span(time_points), make_span(scale_quantized.keys),
+           scale_quantized.num_tracks,
+           make_span(animation->scales_quantized_values_),
+           animation->scales_quantized_ctrl_,
+           compress_quantized(animation->scales_ranges_));
 
   // Converts timepoints to ratio and copy to animation. Must be done once
   // indices have been set.
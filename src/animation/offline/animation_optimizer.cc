@@ -29,11 +29,12 @@
 
 #include <cassert>
 #include <cstddef>
-#include <functional>
+#include <thread>
 
 // Internal include file
 #define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
 #include "animation/offline/decimate.h"
+#include "animation/offline/hierarchy.h"
 #include "ozz/animation/offline/raw_animation.h"
 #include "ozz/animation/offline/raw_animation_utils.h"
 #include "ozz/animation/runtime/skeleton.h"
@@ -42,6 +43,7 @@
 #include "ozz/base/containers/vector.h"
 #include "ozz/base/maths/math_constant.h"
 #include "ozz/base/maths/math_ex.h"
+#include "ozz/base/scheduler.h"
 
 namespace ozz {
 namespace animation {
@@ -60,106 +62,66 @@ AnimationOptimizer::Setting GetJointSetting(
   return setting;
 }
 
-struct HierarchyBuilder {
-  HierarchyBuilder(const RawAnimation* _animation, const Skeleton* _skeleton,
-                   const AnimationOptimizer* _optimizer)
-      : specs(_animation->tracks.size()),
-        animation(_animation),
-        optimizer(_optimizer) {
-    assert(_animation->num_tracks() == _skeleton->num_joints());
-
-    // Computes hierarchical scale, iterating skeleton forward (root to
-    // leaf).
-    IterateJointsDF(*_skeleton,
-                    std::bind(&HierarchyBuilder::ComputeScaleForward, this,
-                              std::placeholders::_1, std::placeholders::_2));
-
-    // Computes hierarchical length, iterating skeleton backward (leaf to root).
-    IterateJointsDFReverse(
-        *_skeleton, std::bind(&HierarchyBuilder::ComputeLengthBackward, this,
-                              std::placeholders::_1, std::placeholders::_2));
+// Estimates the derivative over time at _value from its neighbours, using a
+// three-point formula that handles uneven spacing. The estimation is
+// one-sided at track ends, where _prev or _next is _value itself.
+template <typename _Value>
+_Value ThreePointDerivative(float _prev_time, const _Value& _prev, float _time,
+                            const _Value& _value, float _next_time,
+                            const _Value& _next) {
+  const float h0 = _time - _prev_time;
+  const float h1 = _next_time - _time;
+  if (h0 == 0.f) {
+    return (_next - _value) * (1.f / h1);
+  } else if (h1 == 0.f) {
+    return (_value - _prev) * (1.f / h0);
   }
+  return ((_value - _prev) * (h1 / h0) + (_next - _value) * (h0 / h1)) *
+         (1.f / (h0 + h1));
+}
 
-  struct Spec {
-    float length;  // Length of a joint hierarchy (max of all child).
-    float scale;   // Scale of a joint hierarchy (accumulated from all parents).
-    float tolerance;  // Tolerance of a joint hierarchy (min of all child).
-  };
-
-  // Defines the length of a joint hierarchy (of all child).
-  ozz::vector<Spec> specs;
-
- private:
-  // Extracts maximum translations and scales for each track/joint.
-  void ComputeScaleForward(int _joint, int _parent) {
-    Spec& joint_spec = specs[_joint];
-
-    // Compute joint maximum animated scale.
-    float max_scale = 0.f;
-    const RawAnimation::JointTrack& track = animation->tracks[_joint];
-    if (track.scales.size() != 0) {
-      for (size_t j = 0; j < track.scales.size(); ++j) {
-        const math::Float3& scale = track.scales[j].value;
-        const float max_element = math::Max(
-            math::Max(std::abs(scale.x), std::abs(scale.y)), std::abs(scale.z));
-        max_scale = math::Max(max_scale, max_element);
-      }
-    } else {
-      max_scale = 1.f;  // Default scale.
-    }
-
-    // Accumulate with parent scale.
-    joint_spec.scale = max_scale;
-    if (_parent != Skeleton::kNoParent) {
-      const Spec& parent_spec = specs[_parent];
-      joint_spec.scale *= parent_spec.scale;
+// Estimates tangents of all _track keys, used to fit Hermite splines. Values
+// are held beyond first and last keys, so their tangent is null if they're
+// not at animation boundaries.
+template <typename _Track, typename _Tangents, typename _Adapter>
+void EstimateTangents(const _Track& _track, const _Adapter& _adapter,
+                      float _duration, _Tangents* _tangents) {
+  typedef typename _Tangents::value_type Tangent;
+  const size_t count = _track.size();
+  _tangents->resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    if (count < 2) {
+      (*_tangents)[i] = Tangent::zero();
+      continue;
     }
-
-    // Computes self setting distance and tolerance.
-    // Distance is now scaled with accumulated parent scale.
-    const AnimationOptimizer::Setting setting =
-        GetJointSetting(*optimizer, _joint);
-    joint_spec.length = setting.distance * specs[_joint].scale;
-    joint_spec.tolerance = setting.tolerance;
+    const size_t prev = i > 0 ? i - 1 : i;
+    const size_t next = i < count - 1 ? i + 1 : i;
+    (*_tangents)[i] =
+        _adapter.Derivative(_track[prev], _track[i], _track[next]);
   }
-
-  // Propagate child translations back to the root.
-  void ComputeLengthBackward(int _joint, int _parent) {
-    // Self translation doesn't matter if joint has no parent.
-    if (_parent == Skeleton::kNoParent) {
-      return;
-    }
-
-    // Compute joint maximum animated length.
-    float max_length_sq = 0.f;
-    const RawAnimation::JointTrack& track = animation->tracks[_joint];
-    for (size_t j = 0; j < track.translations.size(); ++j) {
-      max_length_sq =
-          math::Max(max_length_sq, LengthSqr(track.translations[j].value));
-    }
-    const float max_length = std::sqrt(max_length_sq);
-
-    const Spec& joint_spec = specs[_joint];
-    Spec& parent_spec = specs[_parent];
-
-    // Set parent hierarchical spec to its most impacting child, aka max
-    // length and min tolerance.
-    parent_spec.length = math::Max(
-        parent_spec.length, joint_spec.length + max_length * parent_spec.scale);
-    parent_spec.tolerance =
-        math::Min(parent_spec.tolerance, joint_spec.tolerance);
+  if (count != 0 && _track.front().time != 0.f) {
+    _tangents->front() = Tangent::zero();
   }
+  if (count != 0 && _track.back().time != _duration) {
+    _tangents->back() = Tangent::zero();
+  }
+}
 
-  // Disables copy and assignment.
-  HierarchyBuilder(const HierarchyBuilder&);
-  void operator=(const HierarchyBuilder&);
-
-  // Targeted animation.
-  const RawAnimation* animation;
-
-  // Usefull to access settings and compute hierarchy length.
-  const AnimationOptimizer* optimizer;
-};
+// Fits a Hermite spline to _keys, using _tangents if specified, or estimated
+// tangents otherwise.
+template <typename _Track, typename _Tangents, typename _Adapter>
+_Track FitHermite(const _Track& _keys, const _Tangents& _tangents,
+                  const _Adapter& _adapter, float _tolerance, float _duration,
+                  _Tangents* _output_tangents) {
+  if (!_tangents.empty()) {
+    return DecimateHermite(_keys, _tangents, _adapter, _tolerance,
+                           _output_tangents);
+  }
+  _Tangents estimated;
+  EstimateTangents(_keys, _adapter, _duration, &estimated);
+  return DecimateHermite(_keys, estimated, _adapter, _tolerance,
+                         _output_tangents);
+}
 
 class PositionAdapter {
  public:
@@ -175,6 +137,24 @@ class PositionAdapter {
         _ref.time, LerpTranslation(_left.value, _right.value, alpha)};
     return key;
   }
+  RawAnimation::TranslationKey Hermite(
+      const RawAnimation::TranslationKey& _left, const math::Float3& _left_t,
+      const RawAnimation::TranslationKey& _right, const math::Float3& _right_t,
+      const RawAnimation::TranslationKey& _ref) const {
+    const float interval = _right.time - _left.time;
+    const float alpha = (_ref.time - _left.time) / interval;
+    assert(alpha >= 0.f && alpha <= 1.f);
+    const RawAnimation::TranslationKey key = {
+        _ref.time, HermiteTranslation(_left.value, _left_t, _right.value,
+                                      _right_t, interval, alpha)};
+    return key;
+  }
+  math::Float3 Derivative(const RawAnimation::TranslationKey& _prev,
+                          const RawAnimation::TranslationKey& _key,
+                          const RawAnimation::TranslationKey& _next) const {
+    return ThreePointDerivative(_prev.time, _prev.value, _key.time, _key.value,
+                                _next.time, _next.value);
+  }
   float Distance(const RawAnimation::TranslationKey::Value& _a,
                  const RawAnimation::TranslationKey::Value& _b) const {
     return Length(_a - _b) * scale_;
@@ -200,6 +180,34 @@ class RotationAdapter {
         _ref.time, LerpRotation(_left.value, _right.value, alpha)};
     return key;
   }
+  RawAnimation::RotationKey Hermite(
+      const RawAnimation::RotationKey& _left, const math::Float4& _left_t,
+      const RawAnimation::RotationKey& _right, const math::Float4& _right_t,
+      const RawAnimation::RotationKey& _ref) const {
+    const float interval = _right.time - _left.time;
+    const float alpha = (_ref.time - _left.time) / interval;
+    assert(alpha >= 0.f && alpha <= 1.f);
+    const RawAnimation::RotationKey key = {
+        _ref.time, HermiteRotation(_left.value, _left_t, _right.value, _right_t,
+                                   interval, alpha)};
+    return key;
+  }
+  math::Float4 Derivative(const RawAnimation::RotationKey& _prev,
+                          const RawAnimation::RotationKey& _key,
+                          const RawAnimation::RotationKey& _next) const {
+    // Neighbours are moved to _key hemisphere, as interpolation takes the
+    // shortest path.
+    const math::Float4 key(_key.value.x, _key.value.y, _key.value.z,
+                           _key.value.w);
+    math::Float4 prev(_prev.value.x, _prev.value.y, _prev.value.z,
+                      _prev.value.w);
+    prev = Dot(prev, key) < 0.f ? -prev : prev;
+    math::Float4 next(_next.value.x, _next.value.y, _next.value.z,
+                      _next.value.w);
+    next = Dot(next, key) < 0.f ? -next : next;
+    return ThreePointDerivative(_prev.time, prev, _key.time, key, _next.time,
+                                next);
+  }
   float Distance(const RawAnimation::RotationKey::Value& _left,
                  const RawAnimation::RotationKey::Value& _right) const {
     // Compute the shortest unsigned angle between the 2 quaternions.
@@ -234,6 +242,25 @@ class ScaleAdapter {
         _ref.time, LerpScale(_left.value, _right.value, alpha)};
     return key;
   }
+  RawAnimation::ScaleKey Hermite(const RawAnimation::ScaleKey& _left,
+                                 const math::Float3& _left_t,
+                                 const RawAnimation::ScaleKey& _right,
+                                 const math::Float3& _right_t,
+                                 const RawAnimation::ScaleKey& _ref) const {
+    const float interval = _right.time - _left.time;
+    const float alpha = (_ref.time - _left.time) / interval;
+    assert(alpha >= 0.f && alpha <= 1.f);
+    const RawAnimation::ScaleKey key = {
+        _ref.time, HermiteScale(_left.value, _left_t, _right.value, _right_t,
+                                interval, alpha)};
+    return key;
+  }
+  math::Float3 Derivative(const RawAnimation::ScaleKey& _prev,
+                          const RawAnimation::ScaleKey& _key,
+                          const RawAnimation::ScaleKey& _next) const {
+    return ThreePointDerivative(_prev.time, _prev.value, _key.time, _key.value,
+                                _next.time, _next.value);
+  }
   float Distance(const RawAnimation::ScaleKey::Value& _left,
                  const RawAnimation::ScaleKey::Value& _right) const {
     return Length(_left - _right) * length_;
@@ -274,34 +301,73 @@ bool AnimationOptimizer::operator()(const RawAnimation& _input,
   }
 
   // First computes bone lengths, that will be used when filtering.
-  const HierarchyBuilder hierarchy(&_input, &_skeleton, this);
+  const ozz::vector<HierarchySpec> specs =
+      BuildHierarchySpecs(_input, _skeleton, [this](int _joint) {
+        return GetJointSetting(*this, _joint);
+      });
 
   // Rebuilds output animation.
   _output->name = _input.name;
   _output->duration = _input.duration;
   _output->tracks.resize(num_tracks);
 
-  for (int i = 0; i < num_tracks; ++i) {
-    const RawAnimation::JointTrack& input = _input.tracks[i];
-    RawAnimation::JointTrack& output = _output->tracks[i];
+  // Optimizes a single track. Tracks only share read-only data, so they can be
+  // optimized concurrently.
+  auto optimize_track = [&](int _track) {
+    const RawAnimation::JointTrack& input = _input.tracks[_track];
+    RawAnimation::JointTrack& output = _output->tracks[_track];
 
     // Gets joint specs back.
-    const float joint_length = hierarchy.specs[i].length;
-    const int parent = _skeleton.joint_parents()[i];
+    const float joint_length = specs[_track].length;
+    const int parent = _skeleton.joint_parents()[_track];
     const float parent_scale =
-        (parent != Skeleton::kNoParent) ? hierarchy.specs[parent].scale : 1.f;
-    const float tolerance = hierarchy.specs[i].tolerance;
+        (parent != Skeleton::kNoParent) ? specs[parent].scale : 1.f;
+    const float tolerance = specs[_track].tolerance;
 
     // Filters independently T, R and S tracks.
     // This joint translation is affected by parent scale.
     const PositionAdapter tadap(parent_scale);
-    output.translations = Decimate(input.translations, tadap, tolerance);
     // This joint rotation affects children translations/length.
     const RotationAdapter radap(joint_length);
-    output.rotations = Decimate(input.rotations, radap, tolerance);
     // This joint scale affects children translations/length.
     const ScaleAdapter sadap(joint_length);
-    output.scales = Decimate(input.scales, sadap, tolerance);
+    if (hermite) {
+      const float duration = _input.duration;
+      output.translations =
+          FitHermite(input.translations, input.translation_tangents, tadap,
+                     tolerance, duration, &output.translation_tangents);
+      output.rotations =
+          FitHermite(input.rotations, input.rotation_tangents, radap, tolerance,
+                     duration, &output.rotation_tangents);
+      output.scales = FitHermite(input.scales, input.scale_tangents, sadap,
+                                 tolerance, duration, &output.scale_tangents);
+    } else {
+      output.translations = Decimate(input.translations, tadap, tolerance);
+      output.rotations = Decimate(input.rotations, radap, tolerance);
+      output.scales = Decimate(input.scales, sadap, tolerance);
+    }
+  };
+
+  // Distributes tracks to workers. Tracks are picked one by one, as their
+  // number of keys varies a lot.
+  auto optimize_tracks = [&](int _begin, int _end, int) {
+    for (int i = _begin; i < _end; ++i) {
+      optimize_track(i);
+    }
+  };
+  if (scheduler) {
+    ParallelFor(scheduler, num_tracks, 1, optimize_tracks);
+  } else {
+    // The calling thread is one of the workers.
+    const int num_workers =
+        num_threads > 0 ? num_threads
+                        : static_cast<int>(std::thread::hardware_concurrency());
+    if (math::Min(num_workers, num_tracks) <= 1) {
+      optimize_tracks(0, num_tracks, 0);
+    } else {
+      ThreadPoolScheduler pool(math::Min(num_workers, num_tracks) - 1);
+      ParallelFor(&pool, num_tracks, 1, optimize_tracks);
+    }
   }
 
   // Output animation is always valid though.
@@ -138,6 +138,111 @@ _Track Decimate(const _Track& _src, const _Adapter& _adapter,
 
   return output;
 }
+
+// Decimation algorithm based on Ramer-Douglas-Peucker, like Decimate, but
+// whose remaining keys are interpolated with cubic Hermite splines, using
+// _src_tangents (one per _src key). Output tangents are pushed to _tangents.
+// Because tangents hold curvature, far fewer keys are needed to approximate
+// smooth tracks within _tolerance.
+// Contrary to Decimate, last keys aren't removed unless the whole track is
+// constant, as tangents of the penultimate key would then be lost.
+// Adapter must have the following interface:
+// struct Adapter {
+//  bool Decimable(const Key&) const;
+//  Key Hermite(const Key& _left, const Tangent& _left_tangent,
+//              const Key& _right, const Tangent& _right_tangent,
+//              const Key& _ref) const;
+//  float Distance(const Value& _a, const Value& _b) const;
+// };
+template <typename _Track, typename _Tangents, typename _Adapter>
+_Track DecimateHermite(const _Track& _src, const _Tangents& _src_tangents,
+                       const _Adapter& _adapter, float _tolerance,
+                       _Tangents* _tangents) {
+  assert(_src.size() == _src_tangents.size());
+  _Track output;
+  _tangents->clear();
+
+  // Constant tracks are reduced to a single key, or none if it's identity.
+  bool constant = true;
+  for (size_t i = 0; constant && i < _src.size(); ++i) {
+    constant = _adapter.Decimable(_src[i]) &&
+               _adapter.Distance(_src[0].value, _src[i].value) <= _tolerance;
+  }
+  if (constant) {
+    if (!_src.empty() &&
+        _adapter.Distance(_Adapter::identity(), _src[0].value) > _tolerance) {
+      output.push_back(_src[0]);
+      _tangents->push_back(_Tangents::value_type::zero());
+    }
+    return output;
+  }
+
+  // Stack of segments to process.
+  typedef std::pair<size_t, size_t> Segment;
+  ozz::stack<Segment> segments;
+
+  // Bit vector of all points to included.
+  ozz::vector<bool> included(_src.size(), false);
+
+  // Pushes segment made from first and last points.
+  segments.push(Segment(0, _src.size() - 1));
+  included[0] = true;
+  included[_src.size() - 1] = true;
+
+  // Empties segments stack.
+  while (!segments.empty()) {
+    // Pops next segment to process.
+    const Segment segment = segments.top();
+    segments.pop();
+
+    // Looks for the furthest point from the spline segment.
+    float max = -1.f;
+    size_t candidate = segment.first;
+    typename _Track::const_reference left = _src[segment.first];
+    typename _Track::const_reference right = _src[segment.second];
+    for (size_t i = segment.first + 1; i < segment.second; ++i) {
+      assert(!included[i] && "Included points should be processed once only.");
+      typename _Track::const_reference test = _src[i];
+      if (!_adapter.Decimable(test)) {
+        candidate = i;
+        break;
+      } else {
+        const float distance = _adapter.Distance(
+            _adapter
+                .Hermite(left, _src_tangents[segment.first], right,
+                         _src_tangents[segment.second], test)
+                .value,
+            test.value);
+        if (distance > _tolerance && distance > max) {
+          max = distance;
+          candidate = i;
+        }
+      }
+    }
+
+    // If found, include the point and pushes the 2 new segments (before and
+    // after the new point).
+    if (candidate != segment.first) {
+      included[candidate] = true;
+      if (candidate - segment.first > 1) {
+        segments.push(Segment(segment.first, candidate));
+      }
+      if (segment.second - candidate > 1) {
+        segments.push(Segment(candidate, segment.second));
+      }
+    }
+  }
+
+  // Copy all included points, along with their tangent.
+  for (size_t i = 0; i < _src.size(); ++i) {
+    if (included[i]) {
+      output.push_back(_src[i]);
+      _tangents->push_back(_src_tangents[i]);
+    }
+  }
+
+  return output;
+}
 }  // namespace offline
 }  // namespace animation
 }  // namespace ozz
@@ -0,0 +1,131 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_ANIMATION_OFFLINE_HIERARCHY_H_
+#define OZZ_ANIMATION_OFFLINE_HIERARCHY_H_
+
+#ifndef OZZ_INCLUDE_PRIVATE_HEADER
+#error "This header is private, it cannot be included from public headers."
+#endif  // OZZ_INCLUDE_PRIVATE_HEADER
+
+#include <cassert>
+#include <cmath>
+
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/animation/runtime/skeleton_utils.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/maths/math_ex.h"
+
+namespace ozz {
+namespace animation {
+namespace offline {
+
+// Defines the error specification of a joint hierarchy, used to evaluate the
+// error generated on a whole joint hierarchy by an error on a single joint.
+struct HierarchySpec {
+  float length;     // Length of a joint hierarchy (max of all child).
+  float scale;      // Scale of a joint hierarchy (accumulated from all parents).
+  float tolerance;  // Tolerance of a joint hierarchy (min of all child).
+};
+
+// Computes hierarchical specs of all _animation joints.
+// _setting(joint) must return joint's setting, which exposes the tolerance and
+// distance (at which error is measured) members.
+template <typename _Setting>
+ozz::vector<HierarchySpec> BuildHierarchySpecs(const RawAnimation& _animation,
+                                               const Skeleton& _skeleton,
+                                               const _Setting& _setting) {
+  assert(_animation.num_tracks() == _skeleton.num_joints());
+  ozz::vector<HierarchySpec> specs(_animation.tracks.size());
+
+  // Computes hierarchical scale, iterating skeleton forward (root to leaf).
+  IterateJointsDF(_skeleton, [&](int _joint, int _parent) {
+    HierarchySpec& joint_spec = specs[_joint];
+
+    // Compute joint maximum animated scale.
+    float max_scale = 0.f;
+    const RawAnimation::JointTrack& track = _animation.tracks[_joint];
+    if (track.scales.size() != 0) {
+      for (size_t j = 0; j < track.scales.size(); ++j) {
+        const math::Float3& scale = track.scales[j].value;
+        const float max_element = math::Max(
+            math::Max(std::abs(scale.x), std::abs(scale.y)), std::abs(scale.z));
+        max_scale = math::Max(max_scale, max_element);
+      }
+    } else {
+      max_scale = 1.f;  // Default scale.
+    }
+
+    // Accumulate with parent scale.
+    joint_spec.scale = max_scale;
+    if (_parent != Skeleton::kNoParent) {
+      const HierarchySpec& parent_spec = specs[_parent];
+      joint_spec.scale *= parent_spec.scale;
+    }
+
+    // Computes self setting distance and tolerance.
+    // Distance is now scaled with accumulated parent scale.
+    const auto& setting = _setting(_joint);
+    joint_spec.length = setting.distance * specs[_joint].scale;
+    joint_spec.tolerance = setting.tolerance;
+  });
+
+  // Propagate child translations back to the root, iterating skeleton backward
+  // (leaf to root).
+  IterateJointsDFReverse(_skeleton, [&](int _joint, int _parent) {
+    // Self translation doesn't matter if joint has no parent.
+    if (_parent == Skeleton::kNoParent) {
+      return;
+    }
+
+    // Compute joint maximum animated length.
+    float max_length_sq = 0.f;
+    const RawAnimation::JointTrack& track = _animation.tracks[_joint];
+    for (size_t j = 0; j < track.translations.size(); ++j) {
+      max_length_sq =
+          math::Max(max_length_sq, LengthSqr(track.translations[j].value));
+    }
+    const float max_length = std::sqrt(max_length_sq);
+
+    const HierarchySpec& joint_spec = specs[_joint];
+    HierarchySpec& parent_spec = specs[_parent];
+
+    // Set parent hierarchical spec to its most impacting child, aka max
+    // length and min tolerance.
+    parent_spec.length = math::Max(
+        parent_spec.length, joint_spec.length + max_length * parent_spec.scale);
+    parent_spec.tolerance =
+        math::Min(parent_spec.tolerance, joint_spec.tolerance);
+  });
+
+  return specs;
+}
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_ANIMATION_OFFLINE_HIERARCHY_H_
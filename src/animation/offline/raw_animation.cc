@@ -56,11 +56,37 @@ static bool ValidateTrack(const typename ozz::vector<_Key>& _track,
   }
   return true;  // Validated.
 }
+
+// Tangents are optional, but there must be one per key if specified.
+template <typename _Track, typename _Tangents>
+static bool ValidateTangents(const _Track& _track, const _Tangents& _tangents) {
+  return _tangents.empty() || _tangents.size() == _track.size();
+}
+
+// Tangents of a transformation type must be specified for all tracks or none.
+// Tracks without keys don't matter.
+template <typename _Track, typename _Tangents>
+static bool ValidateTangents(
+    const ozz::vector<RawAnimation::JointTrack>& _tracks,
+    _Track RawAnimation::JointTrack::*_keys,
+    _Tangents RawAnimation::JointTrack::*_tangents) {
+  bool with = false, without = false;
+  for (const RawAnimation::JointTrack& track : _tracks) {
+    if (!(track.*_keys).empty()) {
+      with |= !(track.*_tangents).empty();
+      without |= (track.*_tangents).empty();
+    }
+  }
+  return !(with && without);
+}
 }  // namespace
 bool RawAnimation::JointTrack::Validate(float _duration) const {
   return ValidateTrack<TranslationKey>(translations, _duration) &&
          ValidateTrack<RotationKey>(rotations, _duration) &&
-         ValidateTrack<ScaleKey>(scales, _duration);
+         ValidateTrack<ScaleKey>(scales, _duration) &&
+         ValidateTangents(translations, translation_tangents) &&
+         ValidateTangents(rotations, rotation_tangents) &&
+         ValidateTangents(scales, scale_tangents);
 }
 
 bool RawAnimation::Validate() const {
@@ -76,6 +102,14 @@ bool RawAnimation::Validate() const {
   for (size_t i = 0; valid && i < tracks.size(); ++i) {
     valid = tracks[i].Validate(duration);
   }
+  // Ensures tangents are specified for all tracks, or none.
+  valid = valid &&
+          ValidateTangents(tracks, &JointTrack::translations,
+                           &JointTrack::translation_tangents) &&
+          ValidateTangents(tracks, &JointTrack::rotations,
+                           &JointTrack::rotation_tangents) &&
+          ValidateTangents(tracks, &JointTrack::scales,
+                           &JointTrack::scale_tangents);
   return valid;  // *this is valid.
 }
 
@@ -88,6 +122,9 @@ size_t RawAnimation::size() const {
     size += tracks[i].translations.size() * sizeof(TranslationKey);
     size += tracks[i].rotations.size() * sizeof(RotationKey);
     size += tracks[i].scales.size() * sizeof(ScaleKey);
+    size += tracks[i].translation_tangents.size() * sizeof(math::Float3);
+    size += tracks[i].rotation_tangents.size() * sizeof(math::Float4);
+    size += tracks[i].scale_tangents.size() * sizeof(math::Float3);
   }
 
   // Accumulates tracks.
@@ -67,7 +67,7 @@ void Extern<animation::offline::RawAnimation>::Load(
 // RawAnimation::*Keys' version can be declared locally as it will be saved from
 // this cpp file only.
 
-OZZ_IO_TYPE_VERSION(1, animation::offline::RawAnimation::JointTrack)
+OZZ_IO_TYPE_VERSION(2, animation::offline::RawAnimation::JointTrack)
 
 template <>
 struct Extern<animation::offline::RawAnimation::JointTrack> {
@@ -79,17 +79,25 @@ struct Extern<animation::offline::RawAnimation::JointTrack> {
       _archive << track.translations;
       _archive << track.rotations;
       _archive << track.scales;
+      _archive << track.translation_tangents;
+      _archive << track.rotation_tangents;
+      _archive << track.scale_tangents;
     }
   }
   static void Load(IArchive& _archive,
                    animation::offline::RawAnimation::JointTrack* _tracks,
                    size_t _count, uint32_t _version) {
-    (void)_version;
     for (size_t i = 0; i < _count; ++i) {
       animation::offline::RawAnimation::JointTrack& track = _tracks[i];
       _archive >> track.translations;
       _archive >> track.rotations;
       _archive >> track.scales;
+      // Tangents were introduced with version 2.
+      if (_version >= 2) {
+        _archive >> track.translation_tangents;
+        _archive >> track.rotation_tangents;
+        _archive >> track.scale_tangents;
+      }
     }
   }
 };
@@ -64,6 +64,118 @@ math::Float3 LerpScale(const math::Float3& _a, const math::Float3& _b,
 
 namespace {
 
+// Cubic Hermite interpolation of _a and _b values, whose tangents are
+// derivatives over time and _interval the time between the two values.
+template <typename _Value>
+_Value Hermite(const _Value& _a, const _Value& _a_tangent, const _Value& _b,
+               const _Value& _b_tangent, float _interval, float _alpha) {
+  const float alpha2 = _alpha * _alpha;
+  const float alpha3 = alpha2 * _alpha;
+  const float h01 = 3.f * alpha2 - 2.f * alpha3;
+  const float h11 = alpha3 - alpha2;
+  const float h10 = h11 - alpha2 + _alpha;
+  return _a * (1.f - h01) + _b * h01 +
+         (_a_tangent * h10 + _b_tangent * h11) * _interval;
+}
+
+// Derivative over time of the Hermite interpolation of _a and _b.
+template <typename _Value>
+_Value HermiteDerivative(const _Value& _a, const _Value& _a_tangent,
+                         const _Value& _b, const _Value& _b_tangent,
+                         float _interval, float _alpha) {
+  const float alpha2 = _alpha * _alpha;
+  const float d01 = 6.f * (_alpha - alpha2);
+  const float d11 = 3.f * alpha2 - 2.f * _alpha;
+  const float d10 = d11 - 2.f * _alpha + 1.f;
+  return (_b - _a) * (d01 / _interval) + _a_tangent * d10 + _b_tangent * d11;
+}
+
+math::Float4 ToFloat4(const math::Quaternion& _q) {
+  return math::Float4(_q.x, _q.y, _q.z, _q.w);
+}
+
+// Finds the shortest path from _a to _b, like LerpRotation does.
+float ShortestPathSign(const math::Quaternion& _a, const math::Quaternion& _b) {
+  return Dot(ToFloat4(_a), ToFloat4(_b)) < 0.f ? -1.f : 1.f;
+}
+}  // namespace
+
+// Translation hermite interpolation method.
+// This must be the same interpolation as the one used by the sampling job.
+math::Float3 HermiteTranslation(const math::Float3& _a,
+                                const math::Float3& _a_tangent,
+                                const math::Float3& _b,
+                                const math::Float3& _b_tangent, float _interval,
+                                float _alpha) {
+  return Hermite(_a, _a_tangent, _b, _b_tangent, _interval, _alpha);
+}
+
+// Rotation hermite interpolation method.
+// This must be the same interpolation as the one used by the sampling job.
+math::Quaternion HermiteRotation(const math::Quaternion& _a,
+                                 const math::Float4& _a_tangent,
+                                 const math::Quaternion& _b,
+                                 const math::Float4& _b_tangent,
+                                 float _interval, float _alpha) {
+  // _b and -_b are the same rotation, as long as _b tangent is negated too.
+  const float sign = ShortestPathSign(_a, _b);
+  const math::Float4 interp =
+      NormalizeSafe(Hermite(ToFloat4(_a), _a_tangent, ToFloat4(_b) * sign,
+                            _b_tangent * sign, _interval, _alpha),
+                    math::Float4::w_axis());
+  return math::Quaternion(interp.x, interp.y, interp.z, interp.w);
+}
+
+// Scale hermite interpolation method.
+// This must be the same interpolation as the one used by the sampling job.
+math::Float3 HermiteScale(const math::Float3& _a,
+                          const math::Float3& _a_tangent,
+                          const math::Float3& _b,
+                          const math::Float3& _b_tangent, float _interval,
+                          float _alpha) {
+  return Hermite(_a, _a_tangent, _b, _b_tangent, _interval, _alpha);
+}
+
+namespace {
+
+// Tangents of interpolated translations, rotations and scales. Rotation
+// tangent is the derivative of the normalized quaternion.
+math::Float3 HermiteTranslationTangent(const math::Float3& _a,
+                                       const math::Float3& _a_tangent,
+                                       const math::Float3& _b,
+                                       const math::Float3& _b_tangent,
+                                       float _interval, float _alpha) {
+  return HermiteDerivative(_a, _a_tangent, _b, _b_tangent, _interval, _alpha);
+}
+
+math::Float4 HermiteRotationTangent(const math::Quaternion& _a,
+                                    const math::Float4& _a_tangent,
+                                    const math::Quaternion& _b,
+                                    const math::Float4& _b_tangent,
+                                    float _interval, float _alpha) {
+  const float sign = ShortestPathSign(_a, _b);
+  const math::Float4 interp =
+      Hermite(ToFloat4(_a), _a_tangent, ToFloat4(_b) * sign, _b_tangent * sign,
+              _interval, _alpha);
+  const math::Float4 derivative =
+      HermiteDerivative(ToFloat4(_a), _a_tangent, ToFloat4(_b) * sign,
+                        _b_tangent * sign, _interval, _alpha);
+  const float length = Length(interp);
+  if (length == 0.f) {
+    return math::Float4::zero();
+  }
+  const math::Float4 normalized = interp / length;
+  return (derivative - normalized * Dot(normalized, derivative)) / length;
+}
+
+math::Float3 HermiteScaleTangent(const math::Float3& _a,
+                                 const math::Float3& _a_tangent,
+                                 const math::Float3& _b,
+                                 const math::Float3& _b_tangent,
+                                 float _interval, float _alpha) {
+  return HermiteDerivative(_a, _a_tangent, _b, _b_tangent, _interval, _alpha);
+}
+
 // The next functions are used to sample a RawAnimation. This feature is not
 // part of ozz sdk, as RawAnimation is a intermediate format used to build the
 // runtime animation.
@@ -75,10 +187,29 @@ bool Less(const _Key& _left, const _Key& _right) {
   return _left.time < _right.time;
 }
 
-// Samples a component (translation, rotation or scale) of a track.
-template <typename _Track, typename _Lerp>
+// Finds the index of the key after _time, which must be strictly between
+// the first and last keys of _track.
+template <typename _Track>
+size_t FindRightKey(const _Track& _track, float _time) {
+  assert(_track.size() >= 2);
+  const typename _Track::value_type cmp = {_time,
+                                           _Track::value_type::identity()};
+  typename _Track::const_pointer it =
+      std::lower_bound(array_begin(_track), array_end(_track), cmp,
+                       Less<typename _Track::value_type>);
+  assert(it > array_begin(_track) && it < array_end(_track));
+  return static_cast<size_t>(it - array_begin(_track));
+}
+
+// Samples a component (translation, rotation or scale) of a track. Keys are
+// interpolated with _hermite if the component has tangents, with _lerp
+// otherwise.
+template <typename _Track, typename _Tangents, typename _Lerp,
+          typename _Hermite>
 typename _Track::value_type::Value SampleComponent(const _Track& _track,
+                                                   const _Tangents& _tangents,
                                                    const _Lerp& _lerp,
+                                                   const _Hermite& _hermite,
                                                    float _time) {
   if (_track.size() == 0) {
     // Return identity if there's no key for this track.
@@ -91,29 +222,58 @@ typename _Track::value_type::Value SampleComponent(const _Track& _track,
     return _track.back().value;
   } else {
     // Needs to interpolate the 2 keyframes before and after _time.
-    assert(_track.size() >= 2);
-    // First find the 2 keys.
-    const typename _Track::value_type cmp = {_time,
-                                             _Track::value_type::identity()};
-    typename _Track::const_pointer it =
-        std::lower_bound(array_begin(_track), array_end(_track), cmp,
-                         Less<typename _Track::value_type>);
-    assert(it > array_begin(_track) && it < array_end(_track));
+    const size_t right = FindRightKey(_track, _time);
 
     // Then interpolate them at t = _time.
-    const typename _Track::const_reference right = it[0];
-    const typename _Track::const_reference left = it[-1];
-    const float alpha = (_time - left.time) / (right.time - left.time);
-    return _lerp(left.value, right.value, alpha);
+    const typename _Track::const_reference right_key = _track[right];
+    const typename _Track::const_reference left_key = _track[right - 1];
+    const float interval = right_key.time - left_key.time;
+    const float alpha = (_time - left_key.time) / interval;
+    if (_tangents.empty()) {
+      return _lerp(left_key.value, right_key.value, alpha);
+    }
+    return _hermite(left_key.value, _tangents[right - 1], right_key.value,
+                    _tangents[right], interval, alpha);
+  }
+}
+
+// Samples the tangent of a component with tangents. Tangent is null outside of
+// keys range, as values are held.
+template <typename _Track, typename _Tangents, typename _HermiteTangent>
+typename _Tangents::value_type SampleComponentTangent(
+    const _Track& _track, const _Tangents& _tangents,
+    const _HermiteTangent& _hermite_tangent, float _time) {
+  assert(_track.size() == _tangents.size());
+  typedef typename _Tangents::value_type Tangent;
+  if (_track.size() == 0 || _time < _track.front().time ||
+      _time > _track.back().time) {
+    return Tangent::zero();
+  } else if (_time == _track.front().time) {
+    return _tangents.front();
+  } else if (_time == _track.back().time) {
+    return _tangents.back();
+  } else {
+    const size_t right = FindRightKey(_track, _time);
+    const typename _Track::const_reference right_key = _track[right];
+    const typename _Track::const_reference left_key = _track[right - 1];
+    const float interval = right_key.time - left_key.time;
+    const float alpha = (_time - left_key.time) / interval;
+    return _hermite_tangent(left_key.value, _tangents[right - 1],
+                            right_key.value, _tangents[right], interval,
+                            alpha);
   }
 }
 
 void SampleTrack_NoValidate(const RawAnimation::JointTrack& _track, float _time,
                             ozz::math::Transform* _transform) {
   _transform->translation =
-      SampleComponent(_track.translations, LerpTranslation, _time);
-  _transform->rotation = SampleComponent(_track.rotations, LerpRotation, _time);
-  _transform->scale = SampleComponent(_track.scales, LerpScale, _time);
+      SampleComponent(_track.translations, _track.translation_tangents,
+                      LerpTranslation, HermiteTranslation, _time);
+  _transform->rotation =
+      SampleComponent(_track.rotations, _track.rotation_tangents, LerpRotation,
+                      HermiteRotation, _time);
+  _transform->scale = SampleComponent(_track.scales, _track.scale_tangents,
+                                      LerpScale, HermiteScale, _time);
 }
 }  // namespace
 
@@ -173,6 +333,83 @@ ozz::vector<float> ExtractTimePoints(const RawAnimation& _animation) {
   return times;
 }
 
+namespace {
+template <typename _Track, typename _Tangents, typename _Lerp,
+          typename _Hermite, typename _HermiteTangent>
+void ExtractComponentRange(const _Track& _track, const _Tangents& _tangents,
+                           const _Lerp& _lerp, const _Hermite& _hermite,
+                           const _HermiteTangent& _hermite_tangent, float _from,
+                           float _to, _Track* _output,
+                           _Tangents* _output_tangents) {
+  _output->clear();
+  _output_tangents->clear();
+  if (_track.empty()) {
+    return;
+  }
+  typedef typename _Track::value_type Key;
+  const bool hermite = !_tangents.empty();
+
+  // Boundary keys are sampled, inner ones are copied.
+  const Key first = {
+      0.f, SampleComponent(_track, _tangents, _lerp, _hermite, _from)};
+  _output->push_back(first);
+  if (hermite) {
+    _output_tangents->push_back(
+        SampleComponentTangent(_track, _tangents, _hermite_tangent, _from));
+  }
+  for (size_t i = 0; i < _track.size(); ++i) {
+    const Key& key = _track[i];
+    if (key.time > _from && key.time < _to) {
+      const Key inner = {key.time - _from, key.value};
+      _output->push_back(inner);
+      if (hermite) {
+        _output_tangents->push_back(_tangents[i]);
+      }
+    }
+  }
+  if (_to > _from) {
+    const Key last = {_to - _from,
+                      SampleComponent(_track, _tangents, _lerp, _hermite, _to)};
+    _output->push_back(last);
+    if (hermite) {
+      _output_tangents->push_back(
+          SampleComponentTangent(_track, _tangents, _hermite_tangent, _to));
+    }
+  }
+}
+}  // namespace
+
+bool ExtractAnimationRange(const RawAnimation& _animation, float _from,
+                           float _to, RawAnimation* _output) {
+  if (!_output) {
+    return false;
+  }
+  if (!_animation.Validate() || _from < 0.f || _from > _to ||
+      _to > _animation.duration) {
+    return false;
+  }
+
+  _output->name = _animation.name;
+  _output->duration = _to - _from;
+  _output->tracks.resize(_animation.tracks.size());
+  for (size_t i = 0; i < _animation.tracks.size(); ++i) {
+    const RawAnimation::JointTrack& track = _animation.tracks[i];
+    RawAnimation::JointTrack& output = _output->tracks[i];
+    ExtractComponentRange(track.translations, track.translation_tangents,
+                          LerpTranslation, HermiteTranslation,
+                          HermiteTranslationTangent, _from, _to,
+                          &output.translations, &output.translation_tangents);
+    ExtractComponentRange(track.rotations, track.rotation_tangents,
+                          LerpRotation, HermiteRotation, HermiteRotationTangent,
+                          _from, _to, &output.rotations,
+                          &output.rotation_tangents);
+    ExtractComponentRange(track.scales, track.scale_tangents, LerpScale,
+                          HermiteScale, HermiteScaleTangent, _from, _to,
+                          &output.scales, &output.scale_tangents);
+  }
+  return true;
+}
+
 FixedRateSamplingTime::FixedRateSamplingTime(float _duration, float _frequency)
     : duration_(_duration),
       period_(1.f / _frequency),
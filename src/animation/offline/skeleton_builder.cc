@@ -27,6 +27,7 @@
 
 #include "ozz/animation/offline/skeleton_builder.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include "ozz/animation/offline/raw_skeleton.h"
@@ -58,24 +59,67 @@ struct JointLister {
       }
       assert(parent >= 0);
     }
-    const Joint listed = {&_current, parent};
+    const int16_t depth =
+        parent == Skeleton::kNoParent ? 0 : linear_joints[parent].depth + 1;
+    const Joint listed = {&_current, parent, depth};
     linear_joints.push_back(listed);
   }
   struct Joint {
     const RawSkeleton::Joint* joint;
     int16_t parent;
+    int16_t depth;
   };
   // Array of joints in the traversed DAG order.
   ozz::vector<Joint> linear_joints;
 };
+
+// Sorts _joints by depth, preserving depth-first order for joints of the same
+// depth. Outputs the new index of every joint to _remap and updates parents
+// indices accordingly.
+void SortByDepth(ozz::vector<JointLister::Joint>* _joints,
+                 ozz::vector<int16_t>* _remap) {
+  const size_t num_joints = _joints->size();
+  ozz::vector<int16_t> order(num_joints);
+  for (size_t i = 0; i < num_joints; ++i) {
+    order[i] = static_cast<int16_t>(i);
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [_joints](int16_t _a, int16_t _b) {
+                     return (*_joints)[_a].depth < (*_joints)[_b].depth;
+                   });
+
+  _remap->resize(num_joints);
+  for (size_t i = 0; i < num_joints; ++i) {
+    (*_remap)[order[i]] = static_cast<int16_t>(i);
+  }
+
+  ozz::vector<JointLister::Joint> sorted(num_joints);
+  for (size_t i = 0; i < num_joints; ++i) {
+    sorted[i] = (*_joints)[order[i]];
+    if (sorted[i].parent != Skeleton::kNoParent) {
+      sorted[i].parent = (*_remap)[sorted[i].parent];
+    }
+  }
+  _joints->swap(sorted);
+}
 }  // namespace
 
+unique_ptr<ozz::animation::Skeleton> SkeletonBuilder::operator()(
+    const RawSkeleton& _raw_skeleton) const {
+  ozz::vector<int16_t> joint_remap;
+  return (*this)(_raw_skeleton, &joint_remap);
+}
+
 // Validates the RawSkeleton and fills a Skeleton.
 // Uses RawSkeleton::IterateJointsDF to traverse in DAG depth-first order.
 // Building skeleton hierarchy in depth first order make it easier to iterate a
-// skeleton sub-hierarchy.
+// skeleton sub-hierarchy. Joints are then optionally sorted by depth, see
+// JointOrder.
 unique_ptr<ozz::animation::Skeleton> SkeletonBuilder::operator()(
-    const RawSkeleton& _raw_skeleton) const {
+    const RawSkeleton& _raw_skeleton,
+    ozz::vector<int16_t>* _joint_remap) const {
+  assert(_joint_remap);
+
   // Tests _raw_skeleton validity.
   if (!_raw_skeleton.Validate()) {
     return nullptr;
@@ -93,6 +137,16 @@ unique_ptr<ozz::animation::Skeleton> SkeletonBuilder::operator()(
   IterateJointsDF<JointLister&>(_raw_skeleton, lister);
   assert(static_cast<int>(lister.linear_joints.size()) == num_joints);
 
+  // Reorders joints if required.
+  if (joint_order == kBreadthFirst) {
+    SortByDepth(&lister.linear_joints, _joint_remap);
+  } else {
+    _joint_remap->resize(num_joints);
+    for (int i = 0; i < num_joints; ++i) {
+      (*_joint_remap)[i] = static_cast<int16_t>(i);
+    }
+  }
+
   // Computes name's buffer size.
   size_t chars_size = 0;
   for (int i = 0; i < num_joints; ++i) {
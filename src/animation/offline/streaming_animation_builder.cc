@@ -0,0 +1,95 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/offline/streaming_animation_builder.h"
+
+#include <cmath>
+
+#include "ozz/animation/offline/animation_builder.h"
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/raw_animation_utils.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/streaming_animation.h"
+#include "ozz/base/maths/math_ex.h"
+#include "ozz/base/memory/allocator.h"
+
+namespace ozz {
+namespace animation {
+namespace offline {
+
+unique_ptr<StreamingAnimation> StreamingAnimationBuilder::operator()(
+    const RawAnimation& _input) const {
+  // Tests _raw_animation validity.
+  if (!_input.Validate() || !(chunk_duration > 0.f)) {
+    return nullptr;
+  }
+
+  // Computes the number of chunks, making sure the last one isn't empty
+  // because of floating point rounding.
+  int num_chunks = math::Max(
+      1, static_cast<int>(std::ceil(_input.duration / chunk_duration)));
+  while (num_chunks > 1 &&
+         (num_chunks - 1) * chunk_duration >= _input.duration) {
+    --num_chunks;
+  }
+
+  // Everything is fine, allocates and fills the animation.
+  unique_ptr<StreamingAnimation> animation = make_unique<StreamingAnimation>();
+  animation->duration_ = _input.duration;
+  animation->chunk_duration_ = chunk_duration;
+  animation->num_tracks_ = _input.num_tracks();
+  animation->chunks_.resize(num_chunks);
+
+  AnimationBuilder builder;
+  builder.iframe_interval = iframe_interval;
+  RawAnimation raw_chunk;
+  for (int i = 0; i < num_chunks; ++i) {
+    const float from = i * chunk_duration;
+    const float to = i == num_chunks - 1
+                         ? _input.duration
+                         : math::Min((i + 1) * chunk_duration, _input.duration);
+    if (!ExtractAnimationRange(_input, from, to, &raw_chunk)) {
+      return nullptr;
+    }
+    unique_ptr<Animation> chunk = builder(raw_chunk);
+    if (!chunk) {
+      return nullptr;
+    }
+    StreamingAnimation::Chunk& output = animation->chunks_[i];
+    output.animation = std::move(*chunk);
+    output.loaded = true;
+  }
+
+  // All chunks are loaded, so budget must allow it.
+  animation->max_resident_chunks_ =
+      math::Max(animation->max_resident_chunks_, num_chunks);
+
+  return animation;
+}
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
@@ -30,10 +30,12 @@
 #include <json/json.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 
 #include "animation/offline/tools/import2ozz_anim.h"
+#include "animation/offline/tools/import2ozz_batch.h"
 #include "animation/offline/tools/import2ozz_config.h"
 #include "animation/offline/tools/import2ozz_skel.h"
 #include "ozz/base/io/stream.h"
@@ -41,7 +43,44 @@
 #include "ozz/options/options.h"
 
 // Declares command line options.
-OZZ_OPTIONS_DECLARE_STRING(file, "Specifies input file", "", true)
+static bool ValidateExclusiveInputOption(const ozz::options::Option& _option,
+                                         int _argc);
+OZZ_OPTIONS_DECLARE_STRING_FN(file, "Specifies input file", "", false,
+                              &ValidateExclusiveInputOption)
+OZZ_OPTIONS_DECLARE_STRING_FN(
+    manifest,
+    "Specifies a manifest file listing input files to import, one per line. "
+    "Skeleton is imported from the first file only.",
+    "", false, &ValidateExclusiveInputOption)
+
+static bool ValidateExclusiveInputOption(const ozz::options::Option& _option,
+                                         int /*_argc*/) {
+  (void)_option;
+  const bool not_exclusive =
+      OPTIONS_file.value()[0] != 0 && OPTIONS_manifest.value()[0] != 0;
+  if (not_exclusive) {
+    ozz::log::Err() << "--file and --manifest are exclusive options."
+                    << std::endl;
+  }
+  return !not_exclusive;
+}
+
+OZZ_OPTIONS_DECLARE_STRING(
+    cache,
+    "Specifies an import cache file. Input files that are unchanged (same "
+    "content and configuration) since their last successful import are "
+    "skipped.",
+    "", false)
+
+OZZ_OPTIONS_DECLARE_STRING(
+    report,
+    "Specifies a json file to output import status and timings of every input "
+    "file.",
+    "", false)
+
+OZZ_OPTIONS_DECLARE_INT(
+    jobs, "Number of animations optimized, built and written concurrently.", 1,
+    false)
 
 static bool ValidateEndianness(const ozz::options::Option& _option,
                                int /*_argc*/) {
@@ -111,6 +150,71 @@ void InitializeLogLevel() {
 namespace ozz {
 namespace animation {
 namespace offline {
+namespace {
+
+// Measures time spent since construction or last call, in seconds.
+class Timer {
+ public:
+  Timer() : last_(std::chrono::steady_clock::now()) {}
+  double Lap() {
+    const std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    const std::chrono::duration<double> elapsed = now - last_;
+    last_ = now;
+    return elapsed.count();
+  }
+
+ private:
+  std::chrono::steady_clock::time_point last_;
+};
+
+// Imports skeleton and animations from file _filename. Time spent in each
+// import step is stored in _timings.
+bool ImportFile(OzzImporter* _importer, const char* _filename,
+                const Json::Value& _config, ozz::Endianness _endianness,
+                Json::Value* _timings) {
+  // Ensures file to import actually exist.
+  if (!ozz::io::File::Exist(_filename)) {
+    ozz::log::Err() << "File \"" << _filename << "\" doesn't exist."
+                    << std::endl;
+    return false;
+  }
+
+  // Imports animations from the document.
+  Timer timer;
+  ozz::log::Log() << "Importing file \"" << _filename << "\"" << std::endl;
+  if (!_importer->Load(_filename)) {
+    ozz::log::Err() << "Failed to import file \"" << _filename << "\"."
+                    << std::endl;
+    return false;
+  }
+  (*_timings)["load"] = timer.Lap();
+
+  // Handles skeleton import processing
+  if (!ImportSkeleton(_config, _importer, _endianness)) {
+    ozz::log::Err() << "Importing skeleton failed, exiting with failure code."
+                    << std::endl;
+    return false;
+  }
+  (*_timings)["skeleton"] = timer.Lap();
+
+  // Handles animations import processing
+  if (!ImportAnimations(_config, _importer, _endianness, OPTIONS_jobs)) {
+    ozz::log::Err() << "Importing animations failed, exiting with failure code."
+                    << std::endl;
+    return false;
+  }
+  (*_timings)["animations"] = timer.Lap();
+  const double total = (*_timings)["load"].asDouble() +
+                       (*_timings)["skeleton"].asDouble() +
+                       (*_timings)["animations"].asDouble();
+  (*_timings)["total"] = total;
+
+  ozz::log::Log() << "File \"" << _filename << "\" imported in " << total
+                  << "s." << std::endl;
+  return true;
+}
+}  // namespace
 
 int OzzImporter::operator()(int _argc, const char** _argv) {
   // Parses arguments.
@@ -133,32 +237,79 @@ int OzzImporter::operator()(int _argc, const char** _argv) {
     return EXIT_FAILURE;
   }
 
-  // Ensures file to import actually exist.
-  if (!ozz::io::File::Exist(OPTIONS_file)) {
-    ozz::log::Err() << "File \"" << OPTIONS_file << "\" doesn't exist."
+  // Lists files to import.
+  ozz::vector<ozz::string> files;
+  if (OPTIONS_manifest.value()[0] != 0) {
+    if (!ReadManifest(OPTIONS_manifest, &files)) {
+      return EXIT_FAILURE;
+    }
+    if (files.empty()) {
+      ozz::log::Err() << "Manifest \"" << OPTIONS_manifest.value()
+                      << "\" doesn't list any file to import." << std::endl;
+      return EXIT_FAILURE;
+    }
+  } else if (OPTIONS_file.value()[0] != 0) {
+    files.push_back(OPTIONS_file.value());
+  } else {
+    ozz::log::Err() << "One of --file or --manifest options must be specified."
                     << std::endl;
     return EXIT_FAILURE;
   }
 
-  // Imports animations from the document.
-  ozz::log::Log() << "Importing file \"" << OPTIONS_file << "\"" << std::endl;
-  if (!Load(OPTIONS_file)) {
-    ozz::log::Err() << "Failed to import file \"" << OPTIONS_file << "\"."
-                    << std::endl;
-    return EXIT_FAILURE;
+  // Files are skipped if content and configuration are unchanged. Hashes are
+  // only computed when the cache is enabled, as it requires reading files.
+  ImportCache cache(OPTIONS_cache);
+  uint64_t config_hash = 0;
+  if (cache.enabled()) {
+    config_hash = HashConfig(config, static_cast<uint64_t>(endianness));
+
+    // Animations are built against the skeleton, imported from the first
+    // file, or loaded from skeleton filename if skeleton import is disabled.
+    // Skeleton source content is thus part of all files hash, so that
+    // animations are imported again when the skeleton changes.
+    const char* skeleton_source =
+        config["skeleton"]["import"]["enable"].asBool()
+            ? files[0].c_str()
+            : config["skeleton"]["filename"].asCString();
+    HashFile(skeleton_source, config_hash, &config_hash);
   }
 
-  // Handles skeleton import processing
-  if (!ImportSkeleton(config, this, endianness)) {
-    ozz::log::Err() << "Importing skeleton failed, exiting with failure code."
-                    << std::endl;
-    return EXIT_FAILURE;
+  ImportReport report;
+  bool success = true;
+  for (size_t i = 0; i < files.size(); ++i) {
+    const char* filename = files[i].c_str();
+    uint64_t hash = 0;
+    if (cache.enabled() && HashFile(filename, config_hash, &hash) &&
+        cache.UpToDate(filename, hash)) {
+      ozz::log::Log() << "File \"" << filename
+                      << "\" is up to date, import is skipped." << std::endl;
+      report.Add(filename, ImportReport::kSkipped,
+                 Json::Value(Json::objectValue));
+      continue;
+    }
+
+    // Skeleton is shared by all files, so it's imported once.
+    Json::Value file_config = config;
+    if (i != 0) {
+      file_config["skeleton"]["import"]["enable"] = false;
+    }
+
+    Json::Value timings(Json::objectValue);
+    const bool imported =
+        ImportFile(this, filename, file_config, endianness, &timings);
+    report.Add(filename,
+               imported ? ImportReport::kImported : ImportReport::kFailed,
+               timings);
+    if (imported) {
+      cache.Update(filename, hash);
+    }
+    success &= imported;
   }
 
-  // Handles animations import processing
-  if (!ImportAnimations(config, this, endianness)) {
-    ozz::log::Err() << "Importing animations failed, exiting with failure code."
-                    << std::endl;
+  success &= cache.Save();
+  success &= report.Save(OPTIONS_report);
+
+  if (!success) {
     return EXIT_FAILURE;
   }
   ozz::log::Log() << "Exiting importer successfully." << std::endl;
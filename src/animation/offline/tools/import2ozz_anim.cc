@@ -46,8 +46,10 @@
 #include "ozz/base/io/archive.h"
 #include "ozz/base/io/stream.h"
 #include "ozz/base/log.h"
+#include "ozz/base/maths/math_ex.h"
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/memory/unique_ptr.h"
+#include "ozz/base/scheduler.h"
 #include "ozz/options/options.h"
 
 namespace ozz {
@@ -173,6 +175,8 @@ bool Export(OzzImporter& _importer, const RawAnimation& _input_animation,
     const Json::Value& tolerances = _config["optimization_settings"];
     optimizer.setting.tolerance = tolerances["tolerance"].asFloat();
     optimizer.setting.distance = tolerances["distance"].asFloat();
+    optimizer.num_threads = tolerances["threads"].asInt();
+    optimizer.hermite = tolerances["hermite"].asBool();
 
     // Builds per joint settings.
     for (auto& joint_config : tolerances["override"]) {
@@ -265,7 +269,16 @@ bool Export(OzzImporter& _importer, const RawAnimation& _input_animation,
     ozz::log::Log() << "Builds runtime animation." << std::endl;
     AnimationBuilder builder;
     builder.iframe_interval = _config["iframe_interval"].asFloat();
-    animation = builder(raw_animation);
+    if (_config["quantize"].asBool()) {
+      // Quantization has its own error budget, which adds up to optimization
+      // error.
+      const Json::Value& tolerances = _config["quantization_settings"];
+      builder.quantization.tolerance = tolerances["tolerance"].asFloat();
+      builder.quantization.distance = tolerances["distance"].asFloat();
+      animation = builder(raw_animation, _skeleton);
+    } else {
+      animation = builder(raw_animation);
+    }
     if (!animation) {
       ozz::log::Err() << "Failed to build runtime animation." << std::endl;
       return false;
@@ -335,7 +348,7 @@ AdditiveReference::EnumNames AdditiveReference::GetNames() {
 }
 
 bool ImportAnimations(const Json::Value& _config, OzzImporter* _importer,
-                      const ozz::Endianness _endianness) {
+                      const ozz::Endianness _endianness, int _jobs) {
   const Json::Value& skeleton_config = _config["skeleton"];
   const Json::Value& animations_config = _config["animations"];
 
@@ -368,6 +381,14 @@ bool ImportAnimations(const Json::Value& _config, OzzImporter* _importer,
     return false;
   }
 
+  // Animations are imported sequentially, as importers aren't thread safe.
+  // Then they are optimized, built and written concurrently.
+  struct ExportJob {
+    RawAnimation animation;
+    const Json::Value* config;
+  };
+  ozz::vector<ExportJob> exports;
+
   // Loop though all existing animations, and export those who match
   // configuration.
   for (auto& animation_config : animations_config) {
@@ -414,11 +435,10 @@ bool ImportAnimations(const Json::Value& _config, OzzImporter* _importer,
         animation = std::move(baked_animation);
       }
 
-      // Writes animation last, as it can have been modified by track
+      // Animation is exported last, as it can have been modified by track
       // processing.
       if (success) {
-        success = Export(*_importer, animation, *skeleton, animation_config,
-                         _endianness);
+        exports.push_back({std::move(animation), &animation_config});
       }
     }
     // Don't display any message if no animation is supposed to be imported.
@@ -434,6 +454,29 @@ bool ImportAnimations(const Json::Value& _config, OzzImporter* _importer,
     }
   }
 
+  // Exports animations, using up to _jobs threads. Animations are picked one
+  // by one, as their export time varies a lot.
+  const int num_exports = static_cast<int>(exports.size());
+  ozz::vector<char> exported(num_exports, 0);
+  auto export_animations = [&](int _begin, int _end, int) {
+    for (int i = _begin; i < _end; ++i) {
+      const ExportJob& job = exports[i];
+      exported[i] = Export(*_importer, job.animation, *skeleton, *job.config,
+                           _endianness);
+    }
+  };
+  const int num_workers = math::Min(math::Max(_jobs, 1), num_exports);
+  if (num_workers <= 1) {
+    export_animations(0, num_exports, 0);
+  } else {
+    // The calling thread is one of the workers.
+    ThreadPoolScheduler pool(num_workers - 1);
+    ParallelFor(&pool, num_exports, 1, export_animations);
+  }
+  for (const char success_export : exported) {
+    success &= success_export != 0;
+  }
+
   return success;
 }
 }  // namespace offline
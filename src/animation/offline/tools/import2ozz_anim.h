@@ -44,9 +44,14 @@ namespace animation {
 namespace offline {
 
 class OzzImporter;
+
+// Imports animations, as specified by _config. Animations are imported
+// sequentially from _importer, then optimized, built and written using up to
+// _jobs threads.
 OZZ_ANIMTOOLS_DLL bool ImportAnimations(const Json::Value& _config,
                                         OzzImporter* _importer,
-                      const ozz::Endianness _endianness);
+                                        const ozz::Endianness _endianness,
+                                        int _jobs);
 
 // Additive reference enum to config string conversions.
 struct AdditiveReferenceEnum {
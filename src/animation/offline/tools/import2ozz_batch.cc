@@ -0,0 +1,174 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "animation/offline/tools/import2ozz_batch.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "ozz/base/io/stream.h"
+#include "ozz/base/log.h"
+
+namespace ozz {
+namespace animation {
+namespace offline {
+
+namespace {
+// FNV-1a 64 bits hash, which is good enough to detect content changes.
+uint64_t Hash(const void* _data, size_t _size, uint64_t _hash) {
+  const byte* data = static_cast<const byte*>(_data);
+  for (size_t i = 0; i < _size; ++i) {
+    _hash = (_hash ^ data[i]) * 0x100000001b3ull;
+  }
+  return _hash;
+}
+const uint64_t kHashSeed = 0xcbf29ce484222325ull;
+
+std::string ToHex(uint64_t _value) {
+  char buffer[17];
+  std::snprintf(buffer, sizeof(buffer), "%016llx",
+                static_cast<unsigned long long>(_value));
+  return buffer;
+}
+}  // namespace
+
+bool ReadManifest(const char* _filename, ozz::vector<ozz::string>* _files) {
+  std::ifstream file(_filename);
+  if (!file.is_open()) {
+    ozz::log::Err() << "Failed to open manifest file: \"" << _filename
+                    << "\"." << std::endl;
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(file, line)) {
+    // Trims spaces and line endings.
+    const size_t begin = line.find_first_not_of(" \t\r\n");
+    const size_t end = line.find_last_not_of(" \t\r\n");
+    if (begin == std::string::npos || line[begin] == '#') {
+      continue;
+    }
+    _files->push_back(line.substr(begin, end - begin + 1).c_str());
+  }
+  return true;
+}
+
+bool HashFile(const char* _filename, uint64_t _seed, uint64_t* _hash) {
+  ozz::io::File file(_filename, "rb");
+  if (!file.opened()) {
+    return false;
+  }
+  uint64_t hash = Hash(&_seed, sizeof(_seed), kHashSeed);
+  byte buffer[4096];
+  for (size_t read = file.Read(buffer, sizeof(buffer)); read != 0;
+       read = file.Read(buffer, sizeof(buffer))) {
+    hash = Hash(buffer, read, hash);
+  }
+  *_hash = hash;
+  return true;
+}
+
+uint64_t HashConfig(const Json::Value& _config, uint64_t _seed) {
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  const std::string document = Json::writeString(builder, _config);
+  const uint64_t hash = Hash(&_seed, sizeof(_seed), kHashSeed);
+  return Hash(document.data(), document.size(), hash);
+}
+
+ImportCache::ImportCache(const char* _filename)
+    : filename_(_filename), entries_(Json::objectValue) {
+  if (filename_.empty()) {
+    return;
+  }
+  std::ifstream file(_filename);
+  if (!file.is_open()) {
+    ozz::log::LogV() << "No import cache found at \"" << _filename << "\"."
+                     << std::endl;
+    return;
+  }
+  Json::Reader reader;
+  if (!reader.parse(file, entries_, false) || !entries_.isObject()) {
+    ozz::log::Log() << "Invalid import cache \"" << _filename
+                    << "\", cache is reset." << std::endl;
+    entries_ = Json::Value(Json::objectValue);
+  }
+}
+
+bool ImportCache::UpToDate(const char* _file, uint64_t _hash) const {
+  if (filename_.empty()) {
+    return false;
+  }
+  const Json::Value& entry = entries_[_file];
+  return entry.isString() && entry.asString() == ToHex(_hash);
+}
+
+void ImportCache::Update(const char* _file, uint64_t _hash) {
+  entries_[_file] = ToHex(_hash);
+}
+
+bool ImportCache::Save() const {
+  if (filename_.empty()) {
+    return true;
+  }
+  std::ofstream file(filename_.c_str());
+  if (!file.is_open()) {
+    ozz::log::Err() << "Failed to write import cache \"" << filename_ << "\"."
+                    << std::endl;
+    return false;
+  }
+  file << entries_;
+  return true;
+}
+
+void ImportReport::Add(const char* _file, Status _status,
+                       const Json::Value& _timings) {
+  static const char* kStatusNames[] = {"imported", "skipped", "failed"};
+  Json::Value entry(Json::objectValue);
+  entry["file"] = _file;
+  entry["status"] = kStatusNames[_status];
+  entry["timings"] = _timings;
+  entries_.append(entry);
+}
+
+bool ImportReport::Save(const char* _filename) const {
+  if (_filename[0] == 0) {
+    return true;
+  }
+  std::ofstream file(_filename);
+  if (!file.is_open()) {
+    ozz::log::Err() << "Failed to write import report \"" << _filename
+                    << "\"." << std::endl;
+    return false;
+  }
+  file << entries_;
+  return true;
+}
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
@@ -0,0 +1,101 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_ANIMATION_OFFLINE_TOOLS_IMPORT2OZZ_BATCH_H_
+#define OZZ_ANIMATION_OFFLINE_TOOLS_IMPORT2OZZ_BATCH_H_
+
+#include <json/json.h>
+
+#include "ozz/animation/offline/tools/export.h"
+#include "ozz/base/containers/string.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/platform.h"
+
+namespace ozz {
+namespace animation {
+namespace offline {
+
+// Reads the list of files to import from manifest _filename. The manifest is a
+// text file with one input filename per line. Empty lines and lines starting
+// with '#' are ignored.
+OZZ_ANIMTOOLS_DLL bool ReadManifest(const char* _filename,
+                                    ozz::vector<ozz::string>* _files);
+
+// Computes a hash of file _filename content, combined with _seed.
+// Returns false if file can't be read.
+OZZ_ANIMTOOLS_DLL bool HashFile(const char* _filename, uint64_t _seed,
+                                uint64_t* _hash);
+
+// Computes a hash of _config json content, combined with _seed.
+OZZ_ANIMTOOLS_DLL uint64_t HashConfig(const Json::Value& _config,
+                                      uint64_t _seed);
+
+// Stores the hash of successfully imported files, in order to skip them if
+// they are unchanged (same content and configuration) on next import.
+// Cache is saved as a json file that maps input filenames to their hash.
+class OZZ_ANIMTOOLS_DLL ImportCache {
+ public:
+  // Loads cache from _filename, which can be empty to disable the cache.
+  // A missing cache file isn't an error, cache is then empty.
+  explicit ImportCache(const char* _filename);
+
+  // Tests if cache is enabled, aka a cache filename was specified.
+  bool enabled() const { return !filename_.empty(); }
+
+  // Tests if _file was already imported with this _hash.
+  bool UpToDate(const char* _file, uint64_t _hash) const;
+
+  // Sets _file _hash.
+  void Update(const char* _file, uint64_t _hash);
+
+  // Writes cache back to its file, if it's enabled.
+  bool Save() const;
+
+ private:
+  ozz::string filename_;
+  Json::Value entries_;
+};
+
+// Collects import timings and status for every input file, and outputs them
+// as a json report.
+class OZZ_ANIMTOOLS_DLL ImportReport {
+ public:
+  enum Status { kImported, kSkipped, kFailed };
+
+  // Adds an entry for _file. _timings are in seconds, mapped by import step.
+  void Add(const char* _file, Status _status, const Json::Value& _timings);
+
+  // Writes report to _filename. Nothing is written if _filename is empty.
+  bool Save(const char* _filename) const;
+
+ private:
+  Json::Value entries_ = Json::Value(Json::arrayValue);
+};
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_ANIMATION_OFFLINE_TOOLS_IMPORT2OZZ_BATCH_H_
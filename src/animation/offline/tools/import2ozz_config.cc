@@ -35,6 +35,7 @@
 
 #include "animation/offline/tools/import2ozz_anim.h"
 #include "animation/offline/tools/import2ozz_track.h"
+#include "ozz/animation/offline/animation_builder.h"
 #include "ozz/animation/offline/animation_optimizer.h"
 #include "ozz/animation/offline/motion_extractor.h"
 #include "ozz/animation/offline/tools/import2ozz.h"
@@ -70,6 +71,12 @@ OZZ_OPTIONS_DECLARE_STRING(
     config_dump_reference,
     "Dumps reference json configuration to specified file.", "", false)
 
+OZZ_OPTIONS_DECLARE_INT(
+    threads,
+    "Number of threads used to optimize animations. When greater than 0, "
+    "overrides animations \"optimization_settings.threads\" configuration.",
+    0, false)
+
 namespace ozz {
 namespace animation {
 namespace offline {
@@ -257,6 +264,17 @@ bool SanitizeOptimizationSetting(Json::Value& _root) {
   return true;
 }
 
+bool SanitizeQuantizationSettings(Json::Value& _root) {
+  const AnimationBuilder::QuantizationSetting default_setting;
+  MakeDefault(_root, "tolerance", default_setting.tolerance,
+              "The maximum error that quantization is allowed to generate on "
+              "a whole joint hierarchy. It adds up to optimization error.");
+  MakeDefault(_root, "distance", default_setting.distance,
+              "The distance (from the joint) at which quantization error is "
+              "measured. This allows to emulate effect on skinning.");
+  return true;
+}
+
 bool SanitizeJointsSetting(Json::Value& _root) {
   MakeDefault(_root, "name", "*",
               "Joint name. Wildcard characters \'*\' and \'?\' are supported");
@@ -267,6 +285,16 @@ bool SanitizeJointsSetting(Json::Value& _root) {
 bool SanitizeOptimizationSettings(Json::Value& _root, bool _all_options) {
   SanitizeOptimizationSetting(_root);
 
+  MakeDefault(_root, "threads", AnimationOptimizer().num_threads,
+              "Number of threads used to optimize animation tracks. 0 uses as "
+              "many threads as the hardware supports. Optimized animation "
+              "doesn't depend on the number of threads.");
+
+  MakeDefault(_root, "hermite", AnimationOptimizer().hermite,
+              "Fits cubic Hermite splines to tracks instead of decimating "
+              "keyframes for linear interpolation. Smooth tracks need fewer "
+              "keyframes, at the cost of storing their tangents.");
+
   MakeDefaultArray(_root, "override", "Per joint optimization setting override",
                    !_all_options);
   Json::Value& joints = _root["override"];
@@ -440,8 +468,16 @@ bool SanitizeAnimation(Json::Value& _root, bool _all_options) {
   MakeDefault(_root, "optimize", true,
               "Activates keyframes reduction optimization.");
 
+  MakeDefault(_root, "quantize", false,
+              "Quantizes keyframes of tracks whose range of values allows it, "
+              "within quantization_settings tolerance and distance.");
+
   SanitizeOptimizationSettings(_root["optimization_settings"], _all_options);
 
+  MakeDefaultObject(_root, "quantization_settings",
+                    "Quantization settings, used if quantize is true.");
+  SanitizeQuantizationSettings(_root["quantization_settings"]);
+
   MakeDefaultObject(_root, "tracks", "Tracks to build.");
   if (!SanitizeTracks(_root["tracks"], _all_options)) {
     return false;
@@ -588,6 +624,13 @@ bool ProcessConfiguration(Json::Value* _config) {
     return false;
   }
 
+  // Command line threads option overrides configuration.
+  if (OPTIONS_threads > 0) {
+    for (Json::Value& animation : (*_config)["animations"]) {
+      animation["optimization_settings"]["threads"] = OPTIONS_threads.value();
+    }
+  }
+
   // Dumps the config to LogV now it's sanitized.
   if (ozz::log::GetLevel() >= ozz::log::kVerbose) {
     const std::string& document = ToString(*_config);
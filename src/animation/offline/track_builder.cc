@@ -27,6 +27,7 @@
 
 #include "ozz/animation/offline/track_builder.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstring>
@@ -34,6 +35,9 @@
 
 #include "ozz/animation/offline/raw_track.h"
 #include "ozz/animation/runtime/track.h"
+#include "ozz/animation/runtime/track_event_index.h"
+#include "ozz/animation/runtime/track_triggering_job.h"
+#include "ozz/base/containers/vector.h"
 #include "ozz/base/memory/allocator.h"
 
 namespace ozz {
@@ -187,6 +191,57 @@ unique_ptr<QuaternionTrack> TrackBuilder::operator()(
     const RawQuaternionTrack& _input) const {
   return Build<RawQuaternionTrack, QuaternionTrack>(_input);
 }
+
+unique_ptr<TrackEventIndex> TrackBuilder::operator()(
+    span<const RawFloatTrack> _inputs, float _threshold) const {
+  // Edges are detected on runtime tracks, with TrackTriggeringJob over a
+  // single loop, so that index content is exactly what the job would output.
+  ozz::vector<uint32_t> offsets;
+  offsets.reserve(_inputs.size() + 1);
+  ozz::vector<TrackTriggeringJob::Edge> edges;
+  for (const RawFloatTrack& input : _inputs) {
+    const unique_ptr<FloatTrack> track = (*this)(input);
+    if (!track) {
+      return unique_ptr<TrackEventIndex>();
+    }
+
+    offsets.push_back(static_cast<uint32_t>(edges.size()));
+
+    TrackTriggeringJob::Iterator iterator;
+    TrackTriggeringJob job;
+    job.track = track.get();
+    job.threshold = _threshold;
+    job.from = 0.f;
+    job.to = 1.f;
+    job.iterator = &iterator;
+    if (!job.Run()) {
+      return unique_ptr<TrackEventIndex>();
+    }
+    for (; iterator != job.end(); ++iterator) {
+      assert((edges.size() == offsets.back() ||
+              iterator->ratio >= edges.back().ratio) &&
+             "Edges must be sorted");
+      edges.push_back(*iterator);
+    }
+  }
+  offsets.push_back(static_cast<uint32_t>(edges.size()));
+
+  // Everything is fine, allocates and fills the index.
+  unique_ptr<TrackEventIndex> index = make_unique<TrackEventIndex>();
+  index->threshold_ = _threshold;
+  if (_inputs.empty()) {
+    return index;  // No track, no offset.
+  }
+  index->Allocate(_inputs.size(), edges.size());
+  std::copy(offsets.begin(), offsets.end(), index->offsets_.begin());
+  memset(index->rising_.data(), 0, index->rising_.size_bytes());
+  for (size_t i = 0; i < edges.size(); ++i) {
+    index->ratios_[i] = edges[i].ratio;
+    index->rising_[i / 8] |= edges[i].rising << (i & 7);
+  }
+
+  return index;  // Success.
+}
 }  // namespace offline
 }  // namespace animation
 }  // namespace ozz
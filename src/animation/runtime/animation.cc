@@ -31,7 +31,9 @@
 #include <cstring>
 #include <limits>
 
+#include "ozz/base/endianness.h"
 #include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
 #include "ozz/base/log.h"
 #include "ozz/base/maths/math_archive.h"
 #include "ozz/base/maths/math_ex.h"
@@ -48,6 +50,7 @@ Animation::Animation(Animation&& _other) { *this = std::move(_other); }
 
 Animation& Animation::operator=(Animation&& _other) {
   std::swap(allocation_, _other.allocation_);
+  std::swap(buffer_, _other.buffer_);
   std::swap(duration_, _other.duration_);
   std::swap(num_tracks_, _other.num_tracks_);
   std::swap(name_, _other.name_);
@@ -58,52 +61,116 @@ Animation& Animation::operator=(Animation&& _other) {
   std::swap(translations_values_, _other.translations_values_);
   std::swap(rotations_values_, _other.rotations_values_);
   std::swap(scales_values_, _other.scales_values_);
+  std::swap(translations_quantized_ctrl_, _other.translations_quantized_ctrl_);
+  std::swap(rotations_quantized_ctrl_, _other.rotations_quantized_ctrl_);
+  std::swap(scales_quantized_ctrl_, _other.scales_quantized_ctrl_);
+  std::swap(translations_quantized_values_,
+            _other.translations_quantized_values_);
+  std::swap(rotations_quantized_values_, _other.rotations_quantized_values_);
+  std::swap(scales_quantized_values_, _other.scales_quantized_values_);
+  std::swap(translations_ranges_, _other.translations_ranges_);
+  std::swap(rotations_ranges_, _other.rotations_ranges_);
+  std::swap(scales_ranges_, _other.scales_ranges_);
+  std::swap(translations_tangents_, _other.translations_tangents_);
+  std::swap(rotations_tangents_, _other.rotations_tangents_);
+  std::swap(scales_tangents_, _other.scales_tangents_);
+  std::swap(translations_soa_tracks_, _other.translations_soa_tracks_);
+  std::swap(rotations_soa_tracks_, _other.rotations_soa_tracks_);
+  std::swap(scales_soa_tracks_, _other.scales_soa_tracks_);
+  std::swap(translations_constants_, _other.translations_constants_);
+  std::swap(rotations_constants_, _other.rotations_constants_);
+  std::swap(scales_constants_, _other.scales_constants_);
 
   return *this;
 }
 
 Animation::~Animation() { Deallocate(); }
 
+size_t Animation::BufferSize(const AllocateParams& _params) {
+  assert(_params.timepoints <= std::numeric_limits<uint16_t>::max());
+  const size_t sizeof_ratio =
+      _params.timepoints <= std::numeric_limits<uint8_t>::max()
+          ? sizeof(uint8_t)
+          : sizeof(uint16_t);
+  const size_t sizeof_previous = sizeof(uint16_t);
+  return (_params.name_len > 0 ? _params.name_len + 1 : 0) +
+         _params.timepoints * sizeof(float) +
+         _params.translations *
+             (sizeof(internal::Float3Key) + sizeof_ratio + sizeof_previous) +
+         _params.rotations *
+             (sizeof(internal::QuaternionKey) + sizeof_ratio +
+              sizeof_previous) +
+         _params.scales *
+             (sizeof(internal::Float3Key) + sizeof_ratio + sizeof_previous) +
+         _params.translation_iframes.entries * sizeof(byte) +
+         _params.translation_iframes.offsets * sizeof(uint32_t) +
+         _params.rotation_iframes.entries * sizeof(byte) +
+         _params.rotation_iframes.offsets * sizeof(uint32_t) +
+         _params.scale_iframes.entries * sizeof(byte) +
+         _params.scale_iframes.offsets * sizeof(uint32_t) +
+         _params.soa_tracks * 3 * sizeof(uint16_t) +
+         _params.translation_constants * sizeof(internal::Float3Key) +
+         _params.rotation_constants * sizeof(internal::QuaternionKey) +
+         _params.scale_constants * sizeof(internal::Float3Key) +
+         _params.translation_quantized.keys *
+             (sizeof(internal::QuantizedFloat3Key) + sizeof_ratio +
+              sizeof_previous) +
+         _params.rotation_quantized.keys *
+             (sizeof(internal::QuantizedQuaternionKey) + sizeof_ratio +
+              sizeof_previous) +
+         _params.scale_quantized.keys *
+             (sizeof(internal::QuantizedFloat3Key) + sizeof_ratio +
+              sizeof_previous) +
+         _params.translation_quantized.iframes.entries * sizeof(byte) +
+         _params.translation_quantized.iframes.offsets * sizeof(uint32_t) +
+         _params.rotation_quantized.iframes.entries * sizeof(byte) +
+         _params.rotation_quantized.iframes.offsets * sizeof(uint32_t) +
+         _params.scale_quantized.iframes.entries * sizeof(byte) +
+         _params.scale_quantized.iframes.offsets * sizeof(uint32_t) +
+         (_params.translation_quantized.ranges +
+          _params.rotation_quantized.ranges + _params.scale_quantized.ranges) *
+             sizeof(internal::QuantizationRange) +
+         _params.translation_tangents * sizeof(internal::Float3Key) +
+         _params.rotation_tangents * sizeof(internal::Float4Key) +
+         _params.scale_tangents * sizeof(internal::Float3Key);
+}
+
 void Animation::Allocate(const AllocateParams& _params) {
+  assert(allocation_ == nullptr && "Already allocated");
+
+  // Compute overall size and allocate a single buffer for all the data.
+  const size_t buffer_size = BufferSize(_params);
+
+  // Allocate whole buffer
+  auto* allocator = memory::default_allocator();
+  allocation_ = allocator->Allocate(buffer_size, alignof(float));
+  Distribute(_params, {static_cast<byte*>(allocation_), buffer_size});
+}
+
+void Animation::Distribute(const AllocateParams& _params, span<byte> _buffer) {
   // Distributes buffer memory while ensuring proper alignment (serves larger
   // alignment values first).
   static_assert(
-      alignof(float) >= alignof(uint32_t) &&
+      alignof(float) >= alignof(internal::QuantizationRange) &&
+          alignof(internal::QuantizationRange) >= alignof(uint32_t) &&
           alignof(uint32_t) >= alignof(uint16_t) &&
           alignof(uint16_t) >= alignof(internal::Float3Key) &&
-          alignof(internal::Float3Key) >= alignof(internal::QuaternionKey) &&
-          alignof(internal::QuaternionKey) >= alignof(char),
+          alignof(internal::Float3Key) >= alignof(internal::Float4Key) &&
+          alignof(internal::Float4Key) >= alignof(internal::QuaternionKey) &&
+          alignof(internal::QuaternionKey) >=
+              alignof(internal::QuantizedQuaternionKey) &&
+          alignof(internal::QuantizedQuaternionKey) >= alignof(byte) &&
+          alignof(byte) >= alignof(internal::QuantizedFloat3Key) &&
+          alignof(internal::QuantizedFloat3Key) >= alignof(char),
       "Must serve larger alignment values first)");
 
-  assert(allocation_ == nullptr && "Already allocated");
-
-  // Compute overall size and allocate a single buffer for all the data.
-  assert(_params.timepoints <= std::numeric_limits<uint16_t>::max());
+  assert(_buffer.size_bytes() == BufferSize(_params) && "Invalid buffer size");
   const size_t sizeof_ratio =
       _params.timepoints <= std::numeric_limits<uint8_t>::max()
           ? sizeof(uint8_t)
           : sizeof(uint16_t);
-  const size_t sizeof_previous = sizeof(uint16_t);
-  const size_t buffer_size =
-      (_params.name_len > 0 ? _params.name_len + 1 : 0) +
-      _params.timepoints * sizeof(float) +
-      _params.translations *
-          (sizeof(internal::Float3Key) + sizeof_ratio + sizeof_previous) +
-      _params.rotations *
-          (sizeof(internal::QuaternionKey) + sizeof_ratio + sizeof_previous) +
-      _params.scales *
-          (sizeof(internal::Float3Key) + sizeof_ratio + sizeof_previous) +
-      _params.translation_iframes.entries * sizeof(byte) +
-      _params.translation_iframes.offsets * sizeof(uint32_t) +
-      _params.rotation_iframes.entries * sizeof(byte) +
-      _params.rotation_iframes.offsets * sizeof(uint32_t) +
-      _params.scale_iframes.entries * sizeof(byte) +
-      _params.scale_iframes.offsets * sizeof(uint32_t);
-
-  // Allocate whole buffer
-  auto* allocator = memory::default_allocator();
-  allocation_ = allocator->Allocate(buffer_size, alignof(float));
-  span<byte> buffer = {static_cast<byte*>(allocation_), buffer_size};
+  buffer_ = _buffer;
+  span<byte> buffer = _buffer;
 
   // Fix up pointers. Serves larger alignment values first.
 
@@ -115,6 +182,18 @@ void Animation::Allocate(const AllocateParams& _params) {
       fill_span<uint32_t>(buffer, _params.rotation_iframes.offsets);
   scales_ctrl_.iframe_desc =
       fill_span<uint32_t>(buffer, _params.scale_iframes.offsets);
+  translations_quantized_ctrl_.iframe_desc = fill_span<uint32_t>(
+      buffer, _params.translation_quantized.iframes.offsets);
+  rotations_quantized_ctrl_.iframe_desc =
+      fill_span<uint32_t>(buffer, _params.rotation_quantized.iframes.offsets);
+  scales_quantized_ctrl_.iframe_desc =
+      fill_span<uint32_t>(buffer, _params.scale_quantized.iframes.offsets);
+  translations_ranges_ = fill_span<internal::QuantizationRange>(
+      buffer, _params.translation_quantized.ranges);
+  rotations_ranges_ = fill_span<internal::QuantizationRange>(
+      buffer, _params.rotation_quantized.ranges);
+  scales_ranges_ = fill_span<internal::QuantizationRange>(
+      buffer, _params.scale_quantized.ranges);
 
   // 16b alignment
   translations_ctrl_.previouses =
@@ -126,6 +205,29 @@ void Animation::Allocate(const AllocateParams& _params) {
   rotations_values_ =
       fill_span<internal::QuaternionKey>(buffer, _params.rotations);
   scales_values_ = fill_span<internal::Float3Key>(buffer, _params.scales);
+  translations_soa_tracks_ = fill_span<uint16_t>(buffer, _params.soa_tracks);
+  rotations_soa_tracks_ = fill_span<uint16_t>(buffer, _params.soa_tracks);
+  scales_soa_tracks_ = fill_span<uint16_t>(buffer, _params.soa_tracks);
+  translations_constants_ =
+      fill_span<internal::Float3Key>(buffer, _params.translation_constants);
+  rotations_constants_ =
+      fill_span<internal::QuaternionKey>(buffer, _params.rotation_constants);
+  scales_constants_ =
+      fill_span<internal::Float3Key>(buffer, _params.scale_constants);
+  translations_quantized_ctrl_.previouses =
+      fill_span<uint16_t>(buffer, _params.translation_quantized.keys);
+  rotations_quantized_ctrl_.previouses =
+      fill_span<uint16_t>(buffer, _params.rotation_quantized.keys);
+  scales_quantized_ctrl_.previouses =
+      fill_span<uint16_t>(buffer, _params.scale_quantized.keys);
+  rotations_quantized_values_ = fill_span<internal::QuantizedQuaternionKey>(
+      buffer, _params.rotation_quantized.keys);
+  translations_tangents_ =
+      fill_span<internal::Float3Key>(buffer, _params.translation_tangents);
+  rotations_tangents_ =
+      fill_span<internal::Float4Key>(buffer, _params.rotation_tangents);
+  scales_tangents_ =
+      fill_span<internal::Float3Key>(buffer, _params.scale_tangents);
 
   // 16b / 8b alignment
   translations_ctrl_.ratios =
@@ -133,8 +235,18 @@ void Animation::Allocate(const AllocateParams& _params) {
   rotations_ctrl_.ratios =
       fill_span<byte>(buffer, _params.rotations * sizeof_ratio);
   scales_ctrl_.ratios = fill_span<byte>(buffer, _params.scales * sizeof_ratio);
+  translations_quantized_ctrl_.ratios = fill_span<byte>(
+      buffer, _params.translation_quantized.keys * sizeof_ratio);
+  rotations_quantized_ctrl_.ratios =
+      fill_span<byte>(buffer, _params.rotation_quantized.keys * sizeof_ratio);
+  scales_quantized_ctrl_.ratios =
+      fill_span<byte>(buffer, _params.scale_quantized.keys * sizeof_ratio);
 
   // 8b alignment
+  translations_quantized_values_ = fill_span<internal::QuantizedFloat3Key>(
+      buffer, _params.translation_quantized.keys);
+  scales_quantized_values_ = fill_span<internal::QuantizedFloat3Key>(
+      buffer, _params.scale_quantized.keys);
 
   // iframe_entries are compressed with gv4, they must not be at the end of the
   // buffer, as gv4 will access 3 bytes further than compressed entries.
@@ -144,6 +256,12 @@ void Animation::Allocate(const AllocateParams& _params) {
       fill_span<byte>(buffer, _params.rotation_iframes.entries);
   scales_ctrl_.iframe_entries =
       fill_span<byte>(buffer, _params.scale_iframes.entries);
+  translations_quantized_ctrl_.iframe_entries = fill_span<byte>(
+      buffer, _params.translation_quantized.iframes.entries);
+  rotations_quantized_ctrl_.iframe_entries =
+      fill_span<byte>(buffer, _params.rotation_quantized.iframes.entries);
+  scales_quantized_ctrl_.iframe_entries =
+      fill_span<byte>(buffer, _params.scale_quantized.iframes.entries);
 
   // Let name be nullptr if animation has no name. Allows to avoid allocating
   // this buffer in the constructor of empty animations.
@@ -157,6 +275,7 @@ void Animation::Allocate(const AllocateParams& _params) {
 void Animation::Deallocate() {
   memory::default_allocator()->Deallocate(allocation_);
   allocation_ = nullptr;
+  buffer_ = {};
 }
 
 size_t Animation::size() const {
@@ -164,7 +283,20 @@ size_t Animation::size() const {
       sizeof(*this) + timepoints_.size_bytes() +
       translations_ctrl_.size_bytes() + rotations_ctrl_.size_bytes() +
       scales_ctrl_.size_bytes() + translations_values_.size_bytes() +
-      rotations_values_.size_bytes() + scales_values_.size_bytes();
+      rotations_values_.size_bytes() + scales_values_.size_bytes() +
+      translations_soa_tracks_.size_bytes() +
+      rotations_soa_tracks_.size_bytes() + scales_soa_tracks_.size_bytes() +
+      translations_constants_.size_bytes() +
+      rotations_constants_.size_bytes() + scales_constants_.size_bytes() +
+      translations_quantized_ctrl_.size_bytes() +
+      rotations_quantized_ctrl_.size_bytes() +
+      scales_quantized_ctrl_.size_bytes() +
+      translations_quantized_values_.size_bytes() +
+      rotations_quantized_values_.size_bytes() +
+      scales_quantized_values_.size_bytes() +
+      translations_ranges_.size_bytes() + rotations_ranges_.size_bytes() +
+      scales_ranges_.size_bytes() + translations_tangents_.size_bytes() +
+      rotations_tangents_.size_bytes() + scales_tangents_.size_bytes();
   return size;
 }
 }  // namespace animation
@@ -215,6 +347,21 @@ struct Extern<animation::internal::Float3Key> {
                                    OZZ_ARRAY_SIZE(_keys->values) * _count);
   }
 };
+OZZ_IO_TYPE_NOT_VERSIONABLE(animation::internal::Float4Key)
+template <>
+struct Extern<animation::internal::Float4Key> {
+  static void Save(OArchive& _archive,
+                   const animation::internal::Float4Key* _keys, size_t _count) {
+    _archive << ozz::io::MakeArray(_keys->values,
+                                   OZZ_ARRAY_SIZE(_keys->values) * _count);
+  }
+  static void Load(IArchive& _archive, animation::internal::Float4Key* _keys,
+                   size_t _count, uint32_t _version) {
+    (void)_version;
+    _archive >> ozz::io::MakeArray(_keys->values,
+                                   OZZ_ARRAY_SIZE(_keys->values) * _count);
+  }
+};
 OZZ_IO_TYPE_NOT_VERSIONABLE(animation::internal::QuaternionKey)
 template <>
 struct Extern<animation::internal::QuaternionKey> {
@@ -232,6 +379,61 @@ struct Extern<animation::internal::QuaternionKey> {
                                    OZZ_ARRAY_SIZE(_keys->values) * _count);
   }
 };
+OZZ_IO_TYPE_NOT_VERSIONABLE(animation::internal::QuantizedFloat3Key)
+template <>
+struct Extern<animation::internal::QuantizedFloat3Key> {
+  static void Save(OArchive& _archive,
+                   const animation::internal::QuantizedFloat3Key* _keys,
+                   size_t _count) {
+    _archive << ozz::io::MakeArray(_keys->values,
+                                   OZZ_ARRAY_SIZE(_keys->values) * _count);
+  }
+  static void Load(IArchive& _archive,
+                   animation::internal::QuantizedFloat3Key* _keys,
+                   size_t _count, uint32_t _version) {
+    (void)_version;
+    _archive >> ozz::io::MakeArray(_keys->values,
+                                   OZZ_ARRAY_SIZE(_keys->values) * _count);
+  }
+};
+OZZ_IO_TYPE_NOT_VERSIONABLE(animation::internal::QuantizedQuaternionKey)
+template <>
+struct Extern<animation::internal::QuantizedQuaternionKey> {
+  static void Save(OArchive& _archive,
+                   const animation::internal::QuantizedQuaternionKey* _keys,
+                   size_t _count) {
+    _archive << ozz::io::MakeArray(_keys->values,
+                                   OZZ_ARRAY_SIZE(_keys->values) * _count);
+  }
+  static void Load(IArchive& _archive,
+                   animation::internal::QuantizedQuaternionKey* _keys,
+                   size_t _count, uint32_t _version) {
+    (void)_version;
+    _archive >> ozz::io::MakeArray(_keys->values,
+                                   OZZ_ARRAY_SIZE(_keys->values) * _count);
+  }
+};
+OZZ_IO_TYPE_NOT_VERSIONABLE(animation::internal::QuantizationRange)
+template <>
+struct Extern<animation::internal::QuantizationRange> {
+  static void Save(OArchive& _archive,
+                   const animation::internal::QuantizationRange* _ranges,
+                   size_t _count) {
+    for (size_t i = 0; i < _count; ++i) {
+      _archive << ozz::io::MakeArray(_ranges[i].min[0], 12);
+      _archive << ozz::io::MakeArray(_ranges[i].scale[0], 12);
+    }
+  }
+  static void Load(IArchive& _archive,
+                   animation::internal::QuantizationRange* _ranges,
+                   size_t _count, uint32_t _version) {
+    (void)_version;
+    for (size_t i = 0; i < _count; ++i) {
+      _archive >> ozz::io::MakeArray(_ranges[i].min[0], 12);
+      _archive >> ozz::io::MakeArray(_ranges[i].scale[0], 12);
+    }
+  }
+};
 }  // namespace io
 namespace animation {
 void Animation::Save(ozz::io::OArchive& _archive) const {
@@ -262,6 +464,32 @@ void Animation::Save(ozz::io::OArchive& _archive) const {
   _archive << static_cast<uint32_t>(s_iframe_entries_count);
   const size_t s_iframe_desc_count = scales_ctrl_.iframe_desc.size();
   _archive << static_cast<uint32_t>(s_iframe_desc_count);
+  const size_t t_constants_count = translations_constants_.size();
+  _archive << static_cast<uint32_t>(t_constants_count);
+  const size_t r_constants_count = rotations_constants_.size();
+  _archive << static_cast<uint32_t>(r_constants_count);
+  const size_t s_constants_count = scales_constants_.size();
+  _archive << static_cast<uint32_t>(s_constants_count);
+
+  // Quantized keyframes series counts: keys, soa tracks and iframes.
+  const KeyframesCtrl* quantized_ctrls[] = {&translations_quantized_ctrl_,
+                                            &rotations_quantized_ctrl_,
+                                            &scales_quantized_ctrl_};
+  const size_t quantized_ranges[] = {translations_ranges_.size(),
+                                     rotations_ranges_.size(),
+                                     scales_ranges_.size()};
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(quantized_ctrls); ++i) {
+    const KeyframesCtrl& ctrl = *quantized_ctrls[i];
+    _archive << static_cast<uint32_t>(ctrl.previouses.size());
+    _archive << static_cast<uint32_t>(quantized_ranges[i]);
+    _archive << static_cast<uint32_t>(ctrl.iframe_entries.size());
+    _archive << static_cast<uint32_t>(ctrl.iframe_desc.size());
+  }
+
+  // Tangents counts.
+  _archive << static_cast<uint32_t>(translations_tangents_.size());
+  _archive << static_cast<uint32_t>(rotations_tangents_.size());
+  _archive << static_cast<uint32_t>(scales_tangents_.size());
 
   _archive << ozz::io::MakeArray(name_, name_len);
   _archive << ozz::io::MakeArray(timepoints_);
@@ -272,6 +500,27 @@ void Animation::Save(ozz::io::OArchive& _archive) const {
   _archive << io::MakeArray(rotations_values_);
   _archive << scales_ctrl_;
   _archive << io::MakeArray(scales_values_);
+
+  _archive << io::MakeArray(translations_soa_tracks_);
+  _archive << io::MakeArray(translations_constants_);
+  _archive << io::MakeArray(rotations_soa_tracks_);
+  _archive << io::MakeArray(rotations_constants_);
+  _archive << io::MakeArray(scales_soa_tracks_);
+  _archive << io::MakeArray(scales_constants_);
+
+  _archive << translations_quantized_ctrl_;
+  _archive << io::MakeArray(translations_quantized_values_);
+  _archive << io::MakeArray(translations_ranges_);
+  _archive << rotations_quantized_ctrl_;
+  _archive << io::MakeArray(rotations_quantized_values_);
+  _archive << io::MakeArray(rotations_ranges_);
+  _archive << scales_quantized_ctrl_;
+  _archive << io::MakeArray(scales_quantized_values_);
+  _archive << io::MakeArray(scales_ranges_);
+
+  _archive << io::MakeArray(translations_tangents_);
+  _archive << io::MakeArray(rotations_tangents_);
+  _archive << io::MakeArray(scales_tangents_);
 }
 
 void Animation::Load(ozz::io::IArchive& _archive, uint32_t _version) {
@@ -280,8 +529,9 @@ void Animation::Load(ozz::io::IArchive& _archive, uint32_t _version) {
   duration_ = 0.f;
   num_tracks_ = 0;
 
-  // No retro-compatibility with anterior versions.
-  if (_version != 7) {
+  // Versions 7 to 9 are still supported, they only miss constant tracks,
+  // quantized keys and/or tangents.
+  if (_version < 7 || _version > 10) {
     log::Err() << "Unsupported animation version " << _version << "."
                << std::endl;
     return;
@@ -315,15 +565,48 @@ void Animation::Load(ozz::io::IArchive& _archive, uint32_t _version) {
   _archive >> s_iframe_entries_count;
   uint32_t s_iframe_desc_count;
   _archive >> s_iframe_desc_count;
+  uint32_t t_constants_count = 0, r_constants_count = 0, s_constants_count = 0;
+  if (_version >= 8) {
+    _archive >> t_constants_count;
+    _archive >> r_constants_count;
+    _archive >> s_constants_count;
+  }
+  AllocateParams::Quantized quantized[3] = {};
+  if (_version >= 9) {
+    for (AllocateParams::Quantized& q : quantized) {
+      uint32_t keys, ranges, entries, offsets;
+      _archive >> keys;
+      _archive >> ranges;
+      _archive >> entries;
+      _archive >> offsets;
+      q = {keys, ranges, {entries, offsets}};
+    }
+  }
+  uint32_t t_tangents_count = 0, r_tangents_count = 0, s_tangents_count = 0;
+  if (_version >= 10) {
+    _archive >> t_tangents_count;
+    _archive >> r_tangents_count;
+    _archive >> s_tangents_count;
+  }
 
   const AllocateParams params{name_len,
                               timepoints_count,
                               translation_count,
                               rotation_count,
                               scale_count,
+                              static_cast<size_t>(num_soa_tracks()),
+                              t_constants_count,
+                              r_constants_count,
+                              s_constants_count,
                               {t_iframe_entries_count, t_iframe_desc_count},
                               {r_iframe_entries_count, r_iframe_desc_count},
-                              {s_iframe_entries_count, s_iframe_desc_count}};
+                              {s_iframe_entries_count, s_iframe_desc_count},
+                              quantized[0],
+                              quantized[1],
+                              quantized[2],
+                              t_tangents_count,
+                              r_tangents_count,
+                              s_tangents_count};
   Allocate(params);
 
   if (name_) {  // nullptr name_ is supported.
@@ -339,6 +622,198 @@ void Animation::Load(ozz::io::IArchive& _archive, uint32_t _version) {
   _archive >> io::MakeArray(rotations_values_);
   _archive >> scales_ctrl_;
   _archive >> io::MakeArray(scales_values_);
+
+  if (_version >= 8) {
+    _archive >> io::MakeArray(translations_soa_tracks_);
+    _archive >> io::MakeArray(translations_constants_);
+    _archive >> io::MakeArray(rotations_soa_tracks_);
+    _archive >> io::MakeArray(rotations_constants_);
+    _archive >> io::MakeArray(scales_soa_tracks_);
+    _archive >> io::MakeArray(scales_constants_);
+  }
+  if (_version >= 9) {
+    _archive >> translations_quantized_ctrl_;
+    _archive >> io::MakeArray(translations_quantized_values_);
+    _archive >> io::MakeArray(translations_ranges_);
+    _archive >> rotations_quantized_ctrl_;
+    _archive >> io::MakeArray(rotations_quantized_values_);
+    _archive >> io::MakeArray(rotations_ranges_);
+    _archive >> scales_quantized_ctrl_;
+    _archive >> io::MakeArray(scales_quantized_values_);
+    _archive >> io::MakeArray(scales_ranges_);
+  }
+  if (_version >= 10) {
+    _archive >> io::MakeArray(translations_tangents_);
+    _archive >> io::MakeArray(rotations_tangents_);
+    _archive >> io::MakeArray(scales_tangents_);
+  }
+  if (_version < 8) {
+    // All soa tracks are animated.
+    for (size_t i = 0; i < translations_soa_tracks_.size(); ++i) {
+      const uint16_t soa_track = static_cast<uint16_t>(i);
+      translations_soa_tracks_[i] = soa_track;
+      rotations_soa_tracks_[i] = soa_track;
+      scales_soa_tracks_[i] = soa_track;
+    }
+  }
+}
+
+namespace {
+// Animation image header. All members are 32b, so that animation buffer,
+// following the header, is aligned to 4 bytes.
+struct ImageHeader {
+  char tag[16];
+  uint32_t version;
+  uint32_t endianness;
+  float duration;
+  uint32_t num_tracks;
+  uint32_t name_len;
+  uint32_t timepoints;
+  uint32_t translations;
+  uint32_t rotations;
+  uint32_t scales;
+  uint32_t constants[3];   // Constant keys, for each component.
+  uint32_t iframes[3][2];  // Entries and offsets, for each component.
+  float iframe_intervals[3];
+  uint32_t quantized[3][4];  // Keys, soa tracks, iframes entries and offsets.
+  float quantized_iframe_intervals[3];
+  uint32_t tangents[3];  // Tangents, for each component.
+  uint32_t buffer_size;
+};
+
+const char kImageTag[sizeof(ImageHeader::tag)] = "ozz-anim-image";
+const uint32_t kImageVersion = 4;
+
+// Images are padded as gv4 decoding of iframe entries reads up to 3 bytes
+// further than the end of the entries, which could be the end of the buffer.
+const size_t kImagePadding = 4;
+}  // namespace
+
+bool Animation::SaveImage(ozz::io::Stream& _stream) const {
+  ImageHeader header = {};
+  std::memcpy(header.tag, kImageTag, sizeof(header.tag));
+  header.version = kImageVersion;
+  header.endianness = GetNativeEndianness();
+  header.duration = duration_;
+  header.num_tracks = static_cast<uint32_t>(num_tracks_);
+  header.name_len = static_cast<uint32_t>(name_ ? std::strlen(name_) : 0);
+  header.timepoints = static_cast<uint32_t>(timepoints_.size());
+  header.translations = static_cast<uint32_t>(translations_values_.size());
+  header.rotations = static_cast<uint32_t>(rotations_values_.size());
+  header.scales = static_cast<uint32_t>(scales_values_.size());
+  header.constants[0] = static_cast<uint32_t>(translations_constants_.size());
+  header.constants[1] = static_cast<uint32_t>(rotations_constants_.size());
+  header.constants[2] = static_cast<uint32_t>(scales_constants_.size());
+  const KeyframesCtrl* ctrls[] = {&translations_ctrl_, &rotations_ctrl_,
+                                  &scales_ctrl_};
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(ctrls); ++i) {
+    const KeyframesCtrl& ctrl = *ctrls[i];
+    header.iframes[i][0] = static_cast<uint32_t>(ctrl.iframe_entries.size());
+    header.iframes[i][1] = static_cast<uint32_t>(ctrl.iframe_desc.size());
+    header.iframe_intervals[i] = ctrl.iframe_interval;
+  }
+  const KeyframesCtrl* quantized_ctrls[] = {&translations_quantized_ctrl_,
+                                            &rotations_quantized_ctrl_,
+                                            &scales_quantized_ctrl_};
+  const size_t quantized_ranges[] = {translations_ranges_.size(),
+                                     rotations_ranges_.size(),
+                                     scales_ranges_.size()};
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(quantized_ctrls); ++i) {
+    const KeyframesCtrl& ctrl = *quantized_ctrls[i];
+    header.quantized[i][0] = static_cast<uint32_t>(ctrl.previouses.size());
+    header.quantized[i][1] = static_cast<uint32_t>(quantized_ranges[i]);
+    header.quantized[i][2] = static_cast<uint32_t>(ctrl.iframe_entries.size());
+    header.quantized[i][3] = static_cast<uint32_t>(ctrl.iframe_desc.size());
+    header.quantized_iframe_intervals[i] = ctrl.iframe_interval;
+  }
+  header.tangents[0] = static_cast<uint32_t>(translations_tangents_.size());
+  header.tangents[1] = static_cast<uint32_t>(rotations_tangents_.size());
+  header.tangents[2] = static_cast<uint32_t>(scales_tangents_.size());
+  header.buffer_size = static_cast<uint32_t>(buffer_.size_bytes());
+
+  bool success = _stream.Write(&header, sizeof(header)) == sizeof(header);
+  if (!buffer_.empty()) {
+    success &= _stream.Write(buffer_.data(), buffer_.size_bytes()) ==
+               buffer_.size_bytes();
+  }
+  const byte padding[kImagePadding] = {};
+  success &= _stream.Write(padding, sizeof(padding)) == sizeof(padding);
+  return success;
+}
+
+bool Animation::MapImage(span<const byte> _image) {
+  // Destroy animation in case it was already used before.
+  *this = Animation();
+
+  ImageHeader header;
+  if (_image.size_bytes() < sizeof(header) ||
+      !IsAligned(_image.data(), alignof(float))) {
+    log::Err() << "Invalid animation image." << std::endl;
+    return false;
+  }
+  std::memcpy(&header, _image.data(), sizeof(header));
+
+  if (std::memcmp(header.tag, kImageTag, sizeof(header.tag)) != 0 ||
+      header.version != kImageVersion) {
+    log::Err() << "Unsupported animation image version." << std::endl;
+    return false;
+  }
+  if (header.endianness != static_cast<uint32_t>(GetNativeEndianness())) {
+    log::Err() << "Animation image endianness doesn't match platform."
+               << std::endl;
+    return false;
+  }
+
+  AllocateParams::Quantized quantized[3];
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(quantized); ++i) {
+    quantized[i] = {header.quantized[i][0],
+                    header.quantized[i][1],
+                    {header.quantized[i][2], header.quantized[i][3]}};
+  }
+  const AllocateParams params{header.name_len,
+                              header.timepoints,
+                              header.translations,
+                              header.rotations,
+                              header.scales,
+                              (header.num_tracks + 3) / 4,
+                              header.constants[0],
+                              header.constants[1],
+                              header.constants[2],
+                              {header.iframes[0][0], header.iframes[0][1]},
+                              {header.iframes[1][0], header.iframes[1][1]},
+                              {header.iframes[2][0], header.iframes[2][1]},
+                              quantized[0],
+                              quantized[1],
+                              quantized[2],
+                              header.tangents[0],
+                              header.tangents[1],
+                              header.tangents[2]};
+  if (header.timepoints > std::numeric_limits<uint16_t>::max() ||
+      BufferSize(params) != header.buffer_size ||
+      _image.size_bytes() <
+          sizeof(header) + header.buffer_size + kImagePadding) {
+    log::Err() << "Invalid animation image." << std::endl;
+    return false;
+  }
+
+  duration_ = header.duration;
+  num_tracks_ = static_cast<int>(header.num_tracks);
+
+  // Animation data is never written at runtime, so it's safe to point to
+  // constant image memory.
+  byte* buffer = const_cast<byte*>(_image.data()) + sizeof(header);
+  Distribute(params, {buffer, header.buffer_size});
+
+  translations_ctrl_.iframe_interval = header.iframe_intervals[0];
+  rotations_ctrl_.iframe_interval = header.iframe_intervals[1];
+  scales_ctrl_.iframe_interval = header.iframe_intervals[2];
+  translations_quantized_ctrl_.iframe_interval =
+      header.quantized_iframe_intervals[0];
+  rotations_quantized_ctrl_.iframe_interval =
+      header.quantized_iframe_intervals[1];
+  scales_quantized_ctrl_.iframe_interval = header.quantized_iframe_intervals[2];
+
+  return true;
 }
 }  // namespace animation
 }  // namespace ozz
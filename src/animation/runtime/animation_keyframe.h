@@ -56,6 +56,14 @@ struct OZZ_ANIMATION_DLL Float3Key {
   uint16_t values[3];
 };
 
+// Defines the tangent type of hermite interpolated rotation key frames.
+// Tangent is the derivative of the 4 quaternion components over animation
+// ratio, stored as half precision floats. Float3 key frames tangents are stored
+// as Float3Key.
+struct Float4Key {
+  uint16_t values[4];
+};
+
 // Defines the rotation key frame type.
 // Rotation value is a quaternion. Quaternion are normalized, which means each
 // component is in range [-1:1]. This property allows to quantize the 3
@@ -102,6 +110,67 @@ inline void unpack(const QuaternionKey& _key, int& _biggest, int& _sign,
   _cpnt[2] = _key.values[2] >> 1;
 }
 
+// Defines the quantized float3 key frame type, used for translations and scales
+// of soa tracks whose range of values is small enough (see AnimationBuilder).
+// Each component is normalized in its track range (see QuantizationRange) and
+// quantized to an 8 bits unsigned integer.
+struct QuantizedFloat3Key {
+  uint8_t values[3];
+
+  // Quantization scale, depends on number of bits.
+  static constexpr int kBits = 8;
+  static constexpr int kiScale = (1 << kBits) - 1;
+  static constexpr float kfScale = 1.f * kiScale;
+};
+
+// Defines the quantized rotation key frame type. As for QuaternionKey, the 3
+// smallest components of the quaternion are stored, and the largest one is
+// restored at runtime. Each of the 3 smallest components is normalized in its
+// track range (see QuantizationRange) and quantized to 9 bits, so the whole key
+// fits in 32 bits.
+struct QuantizedQuaternionKey {
+  // 2b for the largest component index of the quaternion.
+  // 1b for the sign of the largest component. 1 for negative.
+  // 9b for each component
+  uint16_t values[2];
+
+  // Quantization scale, depends on number of bits.
+  static constexpr int kBits = 9;
+  static constexpr int kiScale = (1 << kBits) - 1;
+  static constexpr float kfScale = 1.f * kiScale;
+};
+
+// Defines the quantization range of a soa track, aka 4 tracks. Values are
+// stored in soa layout, for each of the 3 quantized components, so that
+// decompression is done on soa data: value = min + scale * quantized.
+// For rotations, the 3 components are the 3 smallest components of the
+// quaternion, in the order they are stored in the key.
+struct QuantizationRange {
+  float min[3][4];
+  float scale[3][4];
+};
+
+// Endianness independent load and store
+inline void pack(int _largest, int _sign, const int _cpnt[3],
+                 QuantizedQuaternionKey* _key) {
+  const uint32_t packed = (_largest & 0x3) | ((_sign & 0x1) << 2) |
+                          (_cpnt[0] & 0x1ff) << 3 | (_cpnt[1] & 0x1ff) << 12 |
+                          (_cpnt[2] & 0x1ff) << 21;
+  _key->values[0] = packed & 0xffff;
+  _key->values[1] = (packed >> 16) & 0xffff;
+}
+
+inline void unpack(const QuantizedQuaternionKey& _key, int& _biggest,
+                   int& _sign, int _cpnt[3]) {
+  const uint32_t packed =
+      uint32_t(_key.values[0]) | uint32_t(_key.values[1]) << 16;
+  _biggest = packed & 0x3;
+  _sign = (packed >> 2) & 0x1;
+  _cpnt[0] = (packed >> 3) & 0x1ff;
+  _cpnt[1] = (packed >> 12) & 0x1ff;
+  _cpnt[2] = (packed >> 21) & 0x1ff;
+}
+
 }  // namespace internal
 }  // namespace animation
 }  // namespace ozz
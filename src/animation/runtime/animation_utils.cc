@@ -27,6 +27,8 @@
 
 #include "ozz/animation/runtime/animation_utils.h"
 
+#include <algorithm>
+
 // Internal include file
 #define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
 #include "animation/runtime/animation_keyframe.h"
@@ -34,16 +36,39 @@
 namespace ozz {
 namespace animation {
 
+template <typename _Key>
 inline int CountKeyframesImpl(const Animation::KeyframesCtrlConst& _ctrl,
-                              int _track) {
+                              const Animation::KeyframesCtrlConst& _quantized,
+                              size_t _num_quantized_soa_tracks,
+                              const span<const uint16_t>& _soa_tracks,
+                              const span<const _Key>& _constants, int _track) {
   if (_track < 0) {
-    return static_cast<int>(_ctrl.previouses.size());
+    return static_cast<int>(_ctrl.previouses.size() +
+                            _quantized.previouses.size() + _constants.size());
+  }
+
+  // Constant tracks are stored as a single key.
+  const size_t num_animated_soa_tracks =
+      _soa_tracks.size() - _num_quantized_soa_tracks - _constants.size() / 4;
+  size_t soa_track = static_cast<size_t>(
+      std::find(_soa_tracks.begin(), _soa_tracks.end(), _track / 4) -
+      _soa_tracks.begin());
+  if (soa_track >= num_animated_soa_tracks + _num_quantized_soa_tracks) {
+    return 1;
+  }
+
+  // Quantized soa tracks are stored in their own keyframes series.
+  const auto& previouses = soa_track < num_animated_soa_tracks
+                               ? _ctrl.previouses
+                               : _quantized.previouses;
+  if (soa_track >= num_animated_soa_tracks) {
+    soa_track -= num_animated_soa_tracks;
   }
 
   int count = 1;
-  size_t previous = static_cast<size_t>(_track);
-  for (size_t i = previous + 1; i < _ctrl.previouses.size(); ++i) {
-    if (i - _ctrl.previouses[i] == previous) {
+  size_t previous = soa_track * 4 + _track % 4;
+  for (size_t i = previous + 1; i < previouses.size(); ++i) {
+    if (i - previouses[i] == previous) {
       ++count;
       previous = i;
     }
@@ -52,13 +77,23 @@ inline int CountKeyframesImpl(const Animation::KeyframesCtrlConst& _ctrl,
 }
 
 int CountTranslationKeyframes(const Animation& _animation, int _track) {
-  return CountKeyframesImpl(_animation.translations_ctrl(), _track);
+  return CountKeyframesImpl(
+      _animation.translations_ctrl(), _animation.translations_quantized_ctrl(),
+      _animation.translations_ranges().size(),
+      _animation.translations_soa_tracks(),
+      _animation.translations_constants(), _track);
 }
 int CountRotationKeyframes(const Animation& _animation, int _track) {
-  return CountKeyframesImpl(_animation.rotations_ctrl(), _track);
+  return CountKeyframesImpl(
+      _animation.rotations_ctrl(), _animation.rotations_quantized_ctrl(),
+      _animation.rotations_ranges().size(), _animation.rotations_soa_tracks(),
+      _animation.rotations_constants(), _track);
 }
 int CountScaleKeyframes(const Animation& _animation, int _track) {
-  return CountKeyframesImpl(_animation.scales_ctrl(), _track);
+  return CountKeyframesImpl(
+      _animation.scales_ctrl(), _animation.scales_quantized_ctrl(),
+      _animation.scales_ranges().size(), _animation.scales_soa_tracks(),
+      _animation.scales_constants(), _track);
 }
 }  // namespace animation
 }  // namespace ozz
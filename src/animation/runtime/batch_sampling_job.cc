@@ -0,0 +1,237 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/batch_sampling_job.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <new>
+
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/base/maths/math_ex.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/memory/allocator.h"
+
+namespace ozz {
+namespace animation {
+
+bool BatchSamplingJob::Validate() const {
+  // Don't need any early out, as jobs are valid in most of the performance
+  // critical cases.
+  // Tests are written in multiple lines in order to avoid branches.
+  bool valid = true;
+
+  // Test for nullptr pointers.
+  if (!animation || !context) {
+    return false;
+  }
+
+  // Tests ranges.
+  valid &= ratios.size() == outputs.size();
+  for (const span<ozz::math::SoaTransform>& output : outputs) {
+    valid &= !output.empty();
+  }
+
+  // Tests context size.
+  valid &= context->max_soa_tracks() >= animation->num_soa_tracks();
+  valid &= static_cast<size_t>(context->max_instances()) >= ratios.size();
+
+  return valid;
+}
+
+namespace {
+// Samples a cluster of instances, sorted by ratio, with a single context.
+// _cursor is the ratio last sampled with _context, which is updated.
+void SampleCluster(const Animation& _animation,
+                   const span<const uint32_t>& _cluster,
+                   const span<const float>& _ratios,
+                   const span<const span<ozz::math::SoaTransform>>& _outputs,
+                   SamplingJob::Context* _context, float* _cursor) {
+  // Walks the cluster from the end that is the closest to the last ratio
+  // sampled by the context. Frame after frame, the context thus walks the
+  // cluster back and forth, rather than seeking back to its first instance.
+  const size_t num_instances = _cluster.size();
+  const float first_ratio = math::Clamp(0.f, _ratios[_cluster.front()], 1.f);
+  const float last_ratio = math::Clamp(0.f, _ratios[_cluster.back()], 1.f);
+  const bool backward =
+      std::abs(*_cursor - last_ratio) < std::abs(*_cursor - first_ratio);
+
+  // Only copies as much as is sampled.
+  const size_t num_soa_tracks =
+      static_cast<size_t>(_animation.num_soa_tracks());
+
+  SamplingJob job;
+  job.animation = &_animation;
+  job.context = _context;
+
+  const span<ozz::math::SoaTransform>* previous = nullptr;
+  for (size_t i = 0; i < num_instances; ++i) {
+    const uint32_t instance = _cluster[backward ? num_instances - i - 1 : i];
+    const span<ozz::math::SoaTransform>& output = _outputs[instance];
+    const float ratio = math::Clamp(0.f, _ratios[instance], 1.f);
+
+    // Instances at the same ratio as the previous one share the same posture,
+    // which can be copied rather than sampled again.
+    const size_t count = math::Min(output.size(), num_soa_tracks);
+    if (previous && job.ratio == ratio && previous->size() >= count) {
+      if (previous->data() != output.data()) {
+        std::copy(previous->begin(), previous->begin() + count, output.begin());
+      }
+      continue;
+    }
+
+    job.ratio = ratio;
+    job.output = output;
+    const bool success = job.Run();
+    (void)success;
+    assert(success && "Job was validated, sampling cannot fail.");
+
+    previous = &output;
+  }
+
+  *_cursor = job.ratio;
+}
+}  // namespace
+
+bool BatchSamplingJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  const size_t num_instances = ratios.size();
+  if (num_instances == 0) {
+    return true;
+  }
+
+  // Sorts instances by clamped ratio, so that close instances are neighbors.
+  const span<uint32_t> order = context->order_.first(num_instances);
+  for (size_t i = 0; i < num_instances; ++i) {
+    order[i] = static_cast<uint32_t>(i);
+  }
+  const span<const float> instance_ratios = ratios;
+  std::sort(order.begin(), order.end(),
+            [&instance_ratios](uint32_t _a, uint32_t _b) {
+              return math::Clamp(0.f, instance_ratios[_a], 1.f) <
+                     math::Clamp(0.f, instance_ratios[_b], 1.f);
+            });
+
+  // Splits sorted instances in clusters. An instance joins the cluster of the
+  // previous one if it's closer to it than the time it moved since the
+  // previous run, as walking from the previous instance then costs less than
+  // stepping its own context. Instances that were never sampled only join
+  // clusters at the same ratio.
+  const span<float> previous_ratios = context->ratios_;
+  for (size_t begin = 0, end = 1; begin < num_instances; begin = end++) {
+    for (; end < num_instances; ++end) {
+      const uint32_t instance = order[end];
+      const float ratio = math::Clamp(0.f, ratios[instance], 1.f);
+      const float gap = ratio - math::Clamp(0.f, ratios[order[end - 1]], 1.f);
+      const float previous = previous_ratios[instance];
+      const float moved = previous < 0.f ? 0.f : std::abs(ratio - previous);
+      if (gap > moved) {
+        break;
+      }
+    }
+
+    // Clusters are sampled with the context of their first instance, which
+    // remains the first one as long as instances move at the same pace.
+    const uint32_t leader = order[begin];
+    SampleCluster(*animation, order.subspan(begin, end - begin), ratios,
+                  outputs, &context->contexts_[leader],
+                  &context->cursors_[leader]);
+  }
+
+  // Stores instances ratios for the next run.
+  for (size_t i = 0; i < num_instances; ++i) {
+    previous_ratios[i] = math::Clamp(0.f, ratios[i], 1.f);
+  }
+
+  return true;
+}
+
+BatchSamplingJob::Context::Context() : max_soa_tracks_(0) {}
+
+BatchSamplingJob::Context::Context(int _max_tracks, int _max_instances)
+    : max_soa_tracks_(0) {
+  Resize(_max_tracks, _max_instances);
+}
+
+BatchSamplingJob::Context::~Context() { Deallocate(); }
+
+void BatchSamplingJob::Context::Deallocate() {
+  for (SamplingJob::Context& context : contexts_) {
+    context.~Context();
+  }
+  memory::default_allocator()->Deallocate(allocation_);
+  allocation_ = nullptr;
+  contexts_ = {};
+  ratios_ = {};
+  cursors_ = {};
+  order_ = {};
+}
+
+void BatchSamplingJob::Context::Resize(int _max_tracks, int _max_instances) {
+  // Reset existing data.
+  Deallocate();
+
+  max_soa_tracks_ = (math::Max(0, _max_tracks) + 3) / 4;
+
+  // Allocates all instances data at once, serving larger alignment first.
+  static_assert(alignof(SamplingJob::Context) >= alignof(float) &&
+                    alignof(float) >= alignof(uint32_t),
+                "Must serve larger alignment values first)");
+  const size_t max_instances =
+      static_cast<size_t>(math::Max(0, _max_instances));
+  const size_t size = sizeof(SamplingJob::Context) * max_instances +
+                      sizeof(float) * max_instances * 2 +
+                      sizeof(uint32_t) * max_instances;
+  auto* allocator = memory::default_allocator();
+  allocation_ = allocator->Allocate(size, alignof(SamplingJob::Context));
+  span<byte> buffer = {static_cast<byte*>(allocation_), size};
+  contexts_ = fill_span<SamplingJob::Context>(buffer, max_instances);
+  ratios_ = fill_span<float>(buffer, max_instances);
+  cursors_ = fill_span<float>(buffer, max_instances);
+  order_ = fill_span<uint32_t>(buffer, max_instances);
+  assert(buffer.empty());
+
+  for (SamplingJob::Context& context : contexts_) {
+    new (&context) SamplingJob::Context(_max_tracks);
+  }
+
+  Invalidate();
+}
+
+void BatchSamplingJob::Context::Invalidate() {
+  for (SamplingJob::Context& context : contexts_) {
+    context.Invalidate();
+  }
+  std::fill(ratios_.begin(), ratios_.end(), -1.f);
+  std::fill(cursors_.begin(), cursors_.end(), 0.f);
+}
+}  // namespace animation
+}  // namespace ozz
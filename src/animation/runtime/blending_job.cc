@@ -50,6 +50,13 @@ bool ValidateLayer(const BlendingJob::Layer& _layer, size_t _min_range) {
   } else {
     valid &= _layer.joint_weights.empty();
   }
+
+  // Soa joints list is optional, but must be sorted and in range.
+  int previous = -1;
+  for (const uint16_t soa_joint : _layer.soa_joints) {
+    valid &= soa_joint > previous && soa_joint < _min_range;
+    previous = soa_joint;
+  }
   return valid;
 }
 }  // namespace
@@ -62,6 +69,7 @@ bool BlendingJob::Validate() const {
 
   // Test for valid threshold).
   valid &= threshold > 0.f;
+  valid &= min_layer_weight >= 0.f;
 
   // Test for nullptr begin pointers.
   // Blending layers are mandatory, additive aren't.
@@ -203,6 +211,22 @@ struct ProcessArgs {
   void operator=(const ProcessArgs&);
 };
 
+// Calls _fn for each soa joint processed by _layer, aka all soa joints or only
+// the ones listed by _layer.soa_joints.
+template <typename _Fn>
+OZZ_INLINE void ForEachSoaJoint(const BlendingJob::Layer& _layer,
+                                size_t _num_soa_joints, _Fn _fn) {
+  if (_layer.soa_joints.empty()) {
+    for (size_t i = 0; i < _num_soa_joints; ++i) {
+      _fn(i);
+    }
+  } else {
+    for (const uint16_t i : _layer.soa_joints) {
+      _fn(i);
+    }
+  }
+}
+
 // Blends all layers of the job to its output.
 void BlendLayers(ProcessArgs* _args) {
   assert(_args);
@@ -215,7 +239,7 @@ void BlendLayers(ProcessArgs* _args) {
            (layer.joint_weights.size() >= _args->num_soa_joints));
 
     // Skip irrelevant layers.
-    if (layer.weight <= 0.f) {
+    if (layer.weight <= _args->job.min_layer_weight) {
       continue;
     }
 
@@ -224,21 +248,39 @@ void BlendLayers(ProcessArgs* _args) {
     const math::SimdFloat4 layer_weight =
         math::simd_float4::Load1(layer.weight);
 
-    if (!layer.joint_weights.empty()) {
+    // A sparse layer doesn't process all joints, so the 1st pass can't be used
+    // to initialize output and accumulated weights. They are cleared instead,
+    // as if joints were blended with a 0 weight.
+    const bool sparse = !layer.soa_joints.empty();
+    if (sparse && _args->num_passes == 0) {
+      const math::SimdFloat4 zero = math::simd_float4::zero();
+      const math::SoaTransform identity = {{zero, zero, zero},
+                                           {zero, zero, zero, zero},
+                                           {zero, zero, zero}};
+      for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        _args->job.output[i] = identity;
+        _args->accumulated_weights[i] = zero;
+      }
+    }
+    const bool first_pass = _args->num_passes == 0 && !sparse;
+
+    if (!layer.joint_weights.empty() || sparse) {
       // This layer has per-joint weights.
       ++_args->num_partial_passes;
+    }
 
-      if (_args->num_passes == 0) {
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+    if (!layer.joint_weights.empty()) {
+      if (first_pass) {
+        ForEachSoaJoint(layer, _args->num_soa_joints, [&](size_t i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform& dest = _args->job.output[i];
           const math::SimdFloat4 weight =
               layer_weight * math::Max0(layer.joint_weights[i]);
           _args->accumulated_weights[i] = weight;
           OZZ_BLEND_1ST_PASS(src, weight, dest);
-        }
+        });
       } else {
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        ForEachSoaJoint(layer, _args->num_soa_joints, [&](size_t i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform& dest = _args->job.output[i];
           const math::SimdFloat4 weight =
@@ -246,25 +288,25 @@ void BlendLayers(ProcessArgs* _args) {
           _args->accumulated_weights[i] =
               _args->accumulated_weights[i] + weight;
           OZZ_BLEND_N_PASS(src, weight, dest);
-        }
+        });
       }
     } else {
-      // This is a full layer.
-      if (_args->num_passes == 0) {
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+      // This is a full layer (or a sparse layer with no joint weights).
+      if (first_pass) {
+        ForEachSoaJoint(layer, _args->num_soa_joints, [&](size_t i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform& dest = _args->job.output[i];
           _args->accumulated_weights[i] = layer_weight;
           OZZ_BLEND_1ST_PASS(src, layer_weight, dest);
-        }
+        });
       } else {
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        ForEachSoaJoint(layer, _args->num_soa_joints, [&](size_t i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform& dest = _args->job.output[i];
           _args->accumulated_weights[i] =
               _args->accumulated_weights[i] + layer_weight;
           OZZ_BLEND_N_PASS(src, layer_weight, dest);
-        }
+        });
       }
     }
     // One more pass blended.
@@ -316,12 +358,18 @@ void BlendRestPose(ProcessArgs* _args) {
     assert(_args->num_passes != 0);
 
     for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+      // Early out if all joints already reached the threshold, as rest pose
+      // weight would be 0.
+      const math::SimdFloat4 accumulated_weight =
+          _args->accumulated_weights[i];
+      if (math::AreAllFalse(math::CmpLt(accumulated_weight, threshold))) {
+        continue;
+      }
       const math::SoaTransform& src = _args->job.rest_pose[i];
       math::SoaTransform& dest = _args->job.output[i];
       const math::SimdFloat4 bp_weight =
-          math::Max0(threshold - _args->accumulated_weights[i]);
-      _args->accumulated_weights[i] =
-          math::Max(threshold, _args->accumulated_weights[i]);
+          math::Max0(threshold - accumulated_weight);
+      _args->accumulated_weights[i] = math::Max(threshold, accumulated_weight);
       OZZ_BLEND_N_PASS(src, bp_weight, dest);
     }
   }
@@ -372,57 +420,57 @@ void AddLayers(ProcessArgs* _args) {
     // Prepares constants.
     const math::SimdFloat4 one = math::simd_float4::one();
 
-    if (layer.weight > 0.f) {
+    if (layer.weight > _args->job.min_layer_weight) {
       // Weight is positive, need to perform additive blending.
       const math::SimdFloat4 layer_weight =
           math::simd_float4::Load1(layer.weight);
 
       if (!layer.joint_weights.empty()) {
         // This layer has per-joint weights.
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        ForEachSoaJoint(layer, _args->num_soa_joints, [&](size_t i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform& dest = _args->job.output[i];
           const math::SimdFloat4 weight =
               layer_weight * math::Max0(layer.joint_weights[i]);
           const math::SimdFloat4 one_minus_weight = one - weight;
           OZZ_ADD_PASS(src, weight, dest);
-        }
+        });
       } else {
         // This is a full layer.
         const math::SimdFloat4 one_minus_weight = one - layer_weight;
 
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        ForEachSoaJoint(layer, _args->num_soa_joints, [&](size_t i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform& dest = _args->job.output[i];
           OZZ_ADD_PASS(src, layer_weight, dest);
-        }
+        });
       }
-    } else if (layer.weight < 0.f) {
+    } else if (layer.weight < -_args->job.min_layer_weight) {
       // Weight is negative, need to perform subtractive blending.
       const math::SimdFloat4 layer_weight =
           math::simd_float4::Load1(-layer.weight);
 
       if (!layer.joint_weights.empty()) {
         // This layer has per-joint weights.
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        ForEachSoaJoint(layer, _args->num_soa_joints, [&](size_t i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform& dest = _args->job.output[i];
           const math::SimdFloat4 weight =
               layer_weight * math::Max0(layer.joint_weights[i]);
           const math::SimdFloat4 one_minus_weight = one - weight;
           OZZ_SUB_PASS(src, weight, dest);
-        }
+        });
       } else {
         // This is a full layer.
         const math::SimdFloat4 one_minus_weight = one - layer_weight;
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        ForEachSoaJoint(layer, _args->num_soa_joints, [&](size_t i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform& dest = _args->job.output[i];
           OZZ_SUB_PASS(src, layer_weight, dest);
-        }
+        });
       }
     } else {
-      // Skip layer as its weight is 0.
+      // Skip layer as its weight is 0, or negligible.
     }
   }
 }
@@ -450,5 +498,21 @@ bool BlendingJob::Run() const {
 
   return true;
 }
+
+bool ExtractLayerSoaJoints(span<const math::SimdFloat4> _joint_weights,
+                           span<uint16_t> _soa_joints, size_t* _count) {
+  if (!_count || _soa_joints.size() < _joint_weights.size()) {
+    return false;
+  }
+  const math::SimdFloat4 zero = math::simd_float4::zero();
+  size_t count = 0;
+  for (size_t i = 0; i < _joint_weights.size(); ++i) {
+    if (!math::AreAllFalse(math::CmpGt(_joint_weights[i], zero))) {
+      _soa_joints[count++] = static_cast<uint16_t>(i);
+    }
+  }
+  *_count = count;
+  return true;
+}
 }  // namespace animation
 }  // namespace ozz
@@ -0,0 +1,325 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/character_update_job.h"
+
+#include <cassert>
+#include <chrono>
+
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/blending_job.h"
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/maths/math_ex.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/memory/allocator.h"
+
+namespace ozz {
+namespace animation {
+
+namespace {
+bool ValidateLayers(span<const CharacterUpdateJob::Layer> _layers,
+                    int _num_soa_joints) {
+  bool valid = true;
+  for (const CharacterUpdateJob::Layer& layer : _layers) {
+    if (!layer.animation || !layer.context) {
+      return false;
+    }
+    valid &= layer.animation->num_soa_tracks() >= _num_soa_joints;
+    valid &= layer.context->max_soa_tracks() >=
+             layer.animation->num_soa_tracks();
+  }
+  return valid;
+}
+
+// Measures time spent in each stage, if requested.
+class StageTimer {
+ public:
+  explicit StageTimer(double* _timings) : timings_(_timings) {
+    if (timings_) {
+      last_ = std::chrono::steady_clock::now();
+    }
+  }
+  void End(CharacterUpdateJob::Stage _stage) {
+    if (timings_) {
+      const std::chrono::steady_clock::time_point now =
+          std::chrono::steady_clock::now();
+      const std::chrono::duration<double> elapsed = now - last_;
+      timings_[_stage] += elapsed.count();
+      last_ = now;
+    }
+  }
+
+ private:
+  double* timings_;
+  std::chrono::steady_clock::time_point last_;
+};
+
+// Arguments of the update task, shared by all characters.
+struct UpdateArgs {
+  const CharacterUpdateJob* job;
+
+  // Context scratch buffers.
+  span<math::SoaTransform> locals;
+  size_t max_soa_joints;
+  int max_layers;
+  span<double> timings;
+
+  // Gets scratch local-space buffer _index of worker _worker, truncated to
+  // _num_soa_joints. Index max_layers is the blending output.
+  span<math::SoaTransform> worker_locals(int _worker, int _index,
+                                         size_t _num_soa_joints) const {
+    const size_t offset =
+        (static_cast<size_t>(_worker) * (max_layers + 1) + _index) *
+        max_soa_joints;
+    return locals.subspan(offset, _num_soa_joints);
+  }
+
+  // Gets timings of worker _worker.
+  double* worker_timings(int _worker) const {
+    return timings.data() + _worker * CharacterUpdateJob::kNumStages;
+  }
+};
+
+// Blending layers, built on the stack.
+enum { kMaxBlendingLayers = 64 };
+
+// Runs the whole chain of stages for a character.
+void UpdateCharacter(const UpdateArgs& _args, int _index, int _worker) {
+  const CharacterUpdateJob& job = *_args.job;
+  const CharacterUpdateJob::Character& character = job.characters[_index];
+  const Skeleton& skeleton = *character.skeleton;
+  const size_t num_soa_joints =
+      static_cast<size_t>(skeleton.num_soa_joints());
+  const int num_layers = static_cast<int>(character.layers.size());
+  const int num_additive_layers =
+      static_cast<int>(character.additive_layers.size());
+  const bool profile = job.timings != nullptr;
+  StageTimer timer(profile ? _args.worker_timings(_worker) : nullptr);
+
+  // Samples all layers to worker scratch buffers.
+  SamplingJob sampling_job;
+  for (int i = 0; i < num_layers + num_additive_layers; ++i) {
+    const CharacterUpdateJob::Layer& layer =
+        i < num_layers ? character.layers[i]
+                       : character.additive_layers[i - num_layers];
+    sampling_job.animation = layer.animation;
+    sampling_job.context = layer.context;
+    sampling_job.ratio = layer.ratio;
+    sampling_job.output = _args.worker_locals(_worker, i, num_soa_joints);
+    const bool success = sampling_job.Run();
+    (void)success;
+    assert(success && "Job was validated, sampling cannot fail.");
+  }
+  timer.End(CharacterUpdateJob::kSampling);
+
+  // Blends layers, unless a single layer would be copied as is.
+  const CharacterUpdateJob::Layer& first = character.layers[0];
+  span<const math::SoaTransform> locals;
+  if (num_layers == 1 && num_additive_layers == 0 &&
+      first.joint_weights.empty() && first.weight >= job.threshold) {
+    locals = _args.worker_locals(_worker, 0, num_soa_joints);
+  } else {
+    BlendingJob::Layer blend_layers[kMaxBlendingLayers];
+    for (int i = 0; i < num_layers + num_additive_layers; ++i) {
+      const CharacterUpdateJob::Layer& layer =
+          i < num_layers ? character.layers[i]
+                         : character.additive_layers[i - num_layers];
+      blend_layers[i].transform =
+          _args.worker_locals(_worker, i, num_soa_joints);
+      blend_layers[i].weight = layer.weight;
+      blend_layers[i].joint_weights = layer.joint_weights;
+    }
+    const span<math::SoaTransform> blended =
+        _args.worker_locals(_worker, _args.max_layers, num_soa_joints);
+
+    BlendingJob blending_job;
+    blending_job.threshold = job.threshold;
+    blending_job.layers = {blend_layers, static_cast<size_t>(num_layers)};
+    blending_job.additive_layers = {blend_layers + num_layers,
+                                    static_cast<size_t>(num_additive_layers)};
+    blending_job.rest_pose = skeleton.joint_rest_poses();
+    blending_job.output = blended;
+    const bool success = blending_job.Run();
+    (void)success;
+    assert(success && "Job was validated, blending cannot fail.");
+    locals = blended;
+  }
+  timer.End(CharacterUpdateJob::kBlending);
+
+  // Converts from local to model-space.
+  LocalToModelJob ltm_job;
+  ltm_job.skeleton = &skeleton;
+  ltm_job.input = locals;
+  ltm_job.output = character.models;
+  const bool success = ltm_job.Run();
+  (void)success;
+  assert(success && "Job was validated, local-to-model cannot fail.");
+  timer.End(CharacterUpdateJob::kLocalToModel);
+
+  // Computes skinning matrices.
+  if (!character.skinning_matrices.empty()) {
+    for (size_t i = 0; i < character.joint_remaps.size(); ++i) {
+      character.skinning_matrices[i] =
+          character.models[character.joint_remaps[i]] *
+          character.inverse_bind_poses[i];
+    }
+    timer.End(CharacterUpdateJob::kSkinningMatrices);
+  }
+}
+}  // namespace
+
+bool CharacterUpdateJob::Validate() const {
+  // Don't need any early out, as jobs are valid in most of the performance
+  // critical cases.
+  // Tests are written in multiple lines in order to avoid branches.
+  bool valid = true;
+
+  // Test for nullptr pointers.
+  if (!context) {
+    return false;
+  }
+
+  // Tests scheduler.
+  if (scheduler) {
+    valid &= scheduler->num_workers() <= context->max_workers();
+  }
+  valid &= context->max_workers() > 0;
+
+  for (const Character& character : characters) {
+    if (!character.skeleton) {
+      return false;
+    }
+    const int num_joints = character.skeleton->num_joints();
+    const int num_soa_joints = character.skeleton->num_soa_joints();
+    valid &= num_soa_joints <= context->max_soa_joints();
+
+    // Tests layers.
+    const size_t num_layers =
+        character.layers.size() + character.additive_layers.size();
+    valid &= !character.layers.empty();
+    valid &= num_layers <= static_cast<size_t>(context->max_layers());
+    valid &= num_layers <= kMaxBlendingLayers;
+    valid &= ValidateLayers(character.layers, num_soa_joints);
+    valid &= ValidateLayers(character.additive_layers, num_soa_joints);
+
+    // Tests outputs.
+    valid &= character.models.size() >= static_cast<size_t>(num_joints);
+    if (!character.skinning_matrices.empty()) {
+      valid &=
+          character.joint_remaps.size() == character.inverse_bind_poses.size();
+      valid &= character.skinning_matrices.size() >=
+               character.joint_remaps.size();
+      for (const uint16_t remap : character.joint_remaps) {
+        valid &= remap < num_joints;
+      }
+    }
+  }
+
+  return valid;
+}
+
+bool CharacterUpdateJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  const UpdateArgs args = {this, context->locals_,
+                           static_cast<size_t>(context->max_soa_joints_),
+                           context->max_layers_, context->timings_};
+
+  const int num_workers = scheduler ? scheduler->num_workers() : 1;
+  if (timings) {
+    for (int w = 0; w < num_workers; ++w) {
+      double* worker_timings = args.worker_timings(w);
+      for (int s = 0; s < kNumStages; ++s) {
+        worker_timings[s] = 0.;
+      }
+    }
+  }
+
+  const int num_characters = static_cast<int>(characters.size());
+  ParallelFor(scheduler, num_characters, grain_size,
+              [&args](int _begin, int _end, int _worker) {
+                for (int i = _begin; i < _end; ++i) {
+                  UpdateCharacter(args, i, _worker);
+                }
+              });
+
+  // Sums up workers timings.
+  if (timings) {
+    for (int s = 0; s < kNumStages; ++s) {
+      timings->stages[s] = 0.;
+      for (int w = 0; w < num_workers; ++w) {
+        timings->stages[s] += args.worker_timings(w)[s];
+      }
+    }
+  }
+
+  return true;
+}
+
+CharacterUpdateJob::Context::Context() {}
+
+CharacterUpdateJob::Context::Context(int _max_joints, int _max_layers,
+                                     int _max_workers) {
+  Resize(_max_joints, _max_layers, _max_workers);
+}
+
+CharacterUpdateJob::Context::~Context() { Deallocate(); }
+
+void CharacterUpdateJob::Context::Deallocate() {
+  memory::default_allocator()->Deallocate(allocation_);
+  allocation_ = nullptr;
+  locals_ = {};
+  timings_ = {};
+}
+
+void CharacterUpdateJob::Context::Resize(int _max_joints, int _max_layers,
+                                         int _max_workers) {
+  Deallocate();
+
+  max_soa_joints_ = (math::Max(0, _max_joints) + 3) / 4;
+  max_layers_ = math::Max(0, _max_layers);
+  max_workers_ = math::Max(0, _max_workers);
+
+  // Every worker has one buffer per layer, plus blending output.
+  const size_t num_locals = static_cast<size_t>(max_soa_joints_) *
+                            (max_layers_ + 1) * max_workers_;
+  const size_t num_timings = static_cast<size_t>(kNumStages) * max_workers_;
+  const size_t size = sizeof(math::SoaTransform) * num_locals +
+                      sizeof(double) * num_timings;
+  auto* allocator = memory::default_allocator();
+  allocation_ = allocator->Allocate(size, alignof(math::SoaTransform));
+  span<byte> buffer = {static_cast<byte*>(allocation_), size};
+  locals_ = fill_span<math::SoaTransform>(buffer, num_locals);
+  timings_ = fill_span<double>(buffer, num_timings);
+  assert(buffer.empty());
+}
+
+}  // namespace animation
+}  // namespace ozz
@@ -0,0 +1,145 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/runtime/event_query_job.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "ozz/animation/runtime/track_event_index.h"
+
+namespace ozz {
+namespace animation {
+
+bool EventQueryJob::Validate() const {
+  bool valid = true;
+  valid &= index != nullptr;
+  valid &= num_events != nullptr;
+  if (!valid) {
+    return false;
+  }
+  const int num_tracks = index->num_tracks();
+  for (const Query& query : queries) {
+    valid &= query.track >= 0 && query.track < num_tracks;
+  }
+  return valid;
+}
+
+namespace {
+// Writes an event if there's room left in output buffer, and counts it anyway.
+inline void Push(float _ratio, bool _rising, int _query,
+                 span<EventQueryJob::Event> _events, size_t* _count) {
+  if (*_count < _events.size()) {
+    EventQueryJob::Event& event = _events[*_count];
+    event.ratio = _ratio;
+    event.rising = _rising;
+    event.query = _query;
+  }
+  ++*_count;
+}
+}  // namespace
+
+bool EventQueryJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  const span<const uint32_t> offsets = index->offsets();
+  const span<const float> ratios = index->ratios();
+  const span<const uint8_t> rising = index->rising();
+
+  size_t count = 0;
+  for (size_t q = 0; q < queries.size(); ++q) {
+    const Query& query = queries[q];
+    const int query_index = static_cast<int>(q);
+    const float from = query.from;
+    const float to = query.to;
+
+    // Edges of this track, sorted by ratio.
+    const uint32_t begin = offsets[query.track];
+    const uint32_t end = offsets[query.track + 1];
+    if (begin == end || from == to) {
+      continue;
+    }
+    const float* first_edge = ratios.begin() + begin;
+    const float* last_edge = ratios.begin() + end;
+
+    // Loops over the track as many times as required, edges are included using
+    // the same (global ratio space) conditions as TrackTriggeringJob, so
+    // results are identical.
+    if (to > from) {
+      for (float outer = std::floor(from); outer < to; outer += 1.f) {
+        // Edges are included if they're in range [from,to[, or to the end of
+        // the track if to is beyond this loop.
+        const float* first = std::partition_point(
+            first_edge, last_edge,
+            [outer, from](float _ratio) { return _ratio + outer < from; });
+        const float* last =
+            to >= 1.f + outer
+                ? last_edge
+                : std::partition_point(first, last_edge,
+                                       [outer, to](float _ratio) {
+                                         return _ratio + outer < to;
+                                       });
+        for (const float* edge = first; edge < last; ++edge) {
+          const size_t e = edge - ratios.begin();
+          const bool edge_rising = (rising[e / 8] & (1 << (e & 7))) != 0;
+          Push(*edge + outer, edge_rising, query_index, events, &count);
+        }
+      }
+    } else {
+      for (float outer = std::floor(from); outer + 1.f > to; outer -= 1.f) {
+        // Edges are included if they're in range [to,from[, or to the end of
+        // the track if from is beyond this loop. They're traversed backward.
+        const float* first = std::partition_point(
+            first_edge, last_edge,
+            [outer, to](float _ratio) { return _ratio + outer < to; });
+        const float* last =
+            from >= 1.f + outer
+                ? last_edge
+                : std::partition_point(first, last_edge,
+                                       [outer, from](float _ratio) {
+                                         return _ratio + outer < from;
+                                       });
+        for (const float* edge = last; edge > first;) {
+          --edge;
+          const size_t e = edge - ratios.begin();
+          const bool edge_rising = (rising[e / 8] & (1 << (e & 7))) != 0;
+          Push(*edge + outer, !edge_rising, query_index, events, &count);
+        }
+      }
+    }
+  }
+
+  *num_events = count;
+
+  return true;
+}
+}  // namespace animation
+}  // namespace ozz
@@ -0,0 +1,283 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/runtime/ik_aim_soa_job.h"
+
+#include <cassert>
+
+#include "ozz/base/maths/simd_quaternion.h"
+#include "ozz/base/maths/soa_float4x4.h"
+#include "ozz/base/maths/soa_quaternion.h"
+
+using namespace ozz::math;
+
+namespace ozz {
+namespace animation {
+
+bool IKAimSoaJob::Validate() const {
+  bool valid = true;
+  valid &= joint != nullptr;
+  valid &= joint_correction != nullptr;
+  valid &= AreAllTrue(IsNormalizedEst(forward));
+  return valid;
+}
+
+namespace {
+
+// When there's an offset, the forward vector needs to be recomputed. See
+// IKAimJob ComputeOffsettedForward. Returns the mask of the lanes where an
+// offsetted forward vector exists.
+SimdInt4 ComputeOffsettedForward(const SoaFloat3& _forward,
+                                 const SoaFloat3& _offset,
+                                 const SoaFloat3& _target,
+                                 SoaFloat3* _offsetted_forward) {
+  // AO is projected offset vector onto the normalized forward vector.
+  assert(AreAllTrue(IsNormalizedEst(_forward)));
+  const SimdFloat4 AOl = Dot(_forward, _offset);
+
+  // Compute square length of ac using Pythagorean theorem.
+  const SimdFloat4 ACl2 = LengthSqr(_offset) - AOl * AOl;
+
+  // Square length of target vector, aka circle radius.
+  const SimdFloat4 r2 = LengthSqr(_target);
+
+  // If offset is outside of the sphere defined by target length, the target
+  // isn't reachable.
+  const SimdInt4 reachable = Not(CmpGt(ACl2, r2));
+
+  // AIl is the length of the vector from offset to sphere intersection.
+  const SimdFloat4 AIl = Sqrt(Max(r2 - ACl2, simd_float4::zero()));
+
+  // The distance from offset position to the intersection with the sphere is
+  // (AIl - AOl) Intersection point on the sphere can thus be computed.
+  *_offsetted_forward = _offset + _forward * (AIl - AOl);
+
+  return reachable;
+}
+}  // namespace
+
+bool IKAimSoaJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  const SimdFloat4 zero = simd_float4::zero();
+  const SimdFloat4 one = simd_float4::one();
+  const SoaQuaternion identity = SoaQuaternion::identity();
+
+  // If matrices aren't invertible, they'll be all 0 (ozz::math
+  // implementation), which will result in identity correction quaternions.
+  SimdInt4 invertible;
+  const SoaFloat4x4 inv_joint = Invert(*joint, &invertible);
+
+  // Computes joint to target vector, in joint local-space (_js).
+  const SoaFloat3 joint_to_target_js = TransformPoint(inv_joint, target);
+  const SimdFloat4 joint_to_target_js_len2 = LengthSqr(joint_to_target_js);
+
+  // Recomputes forward vector to account for offset.
+  // If the offset is further than target, it won't be reachable.
+  SoaFloat3 offsetted_forward;
+  const SimdInt4 lreached = ComputeOffsettedForward(
+      forward, offset, joint_to_target_js, &offsetted_forward);
+  // Copies reachability result.
+  // If offsetted forward vector doesn't exists, target position cannot be
+  // aimed.
+  if (reached != nullptr) {
+    *reached = lreached;
+  }
+
+  // Target can't be reached or is too close to joint position to find a
+  // direction.
+  const SimdInt4 valid =
+      AndNot(lreached, CmpEq(joint_to_target_js_len2, zero));
+  if (AreAllFalse(valid)) {
+    *joint_correction = identity;
+    return true;
+  }
+
+  // Calculates joint_to_target_rot_ss quaternion which solves for
+  // offsetted_forward vector rotating onto the target.
+  const SoaQuaternion joint_to_target_rot_js =
+      SoaQuaternion::FromVectors(offsetted_forward, joint_to_target_js);
+
+  // Calculates rotate_plane_js quaternion which aligns joint up to the pole
+  // vector.
+  const SoaFloat3 corrected_up_js =
+      TransformVector(joint_to_target_rot_js, up);
+
+  // Compute (and normalize) reference and pole planes normals.
+  const SoaFloat3 pole_vector_js = TransformVector(inv_joint, pole_vector);
+  const SoaFloat3 ref_joint_normal_js =
+      Cross(pole_vector_js, joint_to_target_js);
+  const SoaFloat3 joint_normal_js = Cross(corrected_up_js, joint_to_target_js);
+  const SimdFloat4 ref_joint_normal_js_len2 = LengthSqr(ref_joint_normal_js);
+  const SimdFloat4 joint_normal_js_len2 = LengthSqr(joint_normal_js);
+
+  // Computes rotation axis, which is either joint_to_target_js or
+  // -joint_to_target_js depending on rotation direction.
+  const SoaFloat3 rotate_plane_axis_js = Select(
+      valid, joint_to_target_js * RSqrtEstNR(joint_to_target_js_len2),
+      SoaFloat3::x_axis());
+
+  // Computing rotation axis and plane requires valid normals.
+  const SimdInt4 valid_normals =
+      And(valid, And(CmpNe(joint_normal_js_len2, zero),
+                     CmpNe(ref_joint_normal_js_len2, zero)));
+
+  // Computes angle cosine between the 2 normalized plane normals.
+  const SimdFloat4 rotate_plane_cos_angle =
+      Dot(joint_normal_js * RSqrtEstNR(joint_normal_js_len2),
+          ref_joint_normal_js * RSqrtEstNR(ref_joint_normal_js_len2));
+  const SimdFloat4 axis_flip =
+      And(Dot(ref_joint_normal_js, corrected_up_js), simd_int4::mask_sign());
+  const SoaFloat3 rotate_plane_axis_flipped_js = {
+      Xor(rotate_plane_axis_js.x, axis_flip),
+      Xor(rotate_plane_axis_js.y, axis_flip),
+      Xor(rotate_plane_axis_js.z, axis_flip)};
+
+  // Builds quaternion along rotation axis. Lanes without valid normals are
+  // replaced with an identity rotation.
+  const SoaQuaternion rotate_plane_js = SoaQuaternion::FromAxisCosAngle(
+      Select(valid_normals, rotate_plane_axis_flipped_js, SoaFloat3::x_axis()),
+      Select(valid_normals, Clamp(-one, rotate_plane_cos_angle, one), one));
+
+  // Twists rotation plane.
+  SoaQuaternion twisted = rotate_plane_js * joint_to_target_rot_js;
+  const SimdInt4 twist = CmpNe(twist_angle, zero);
+  if (!AreAllFalse(twist)) {
+    // If a twist angle is provided, rotation angle is rotated around joint to
+    // target vector.
+    const SoaQuaternion twist_ss =
+        SoaQuaternion::FromAxisAngle(rotate_plane_axis_js, twist_angle);
+    twisted = Select(twist, twist_ss * twisted, twisted);
+  }
+
+  // Weights output quaternion.
+
+  // Fix up quaternions so w is always positive, which is required for NLerp
+  // (with identity quaternion) to lerp the shortest path.
+  const SimdInt4 sign = And(simd_int4::mask_sign(), CmpLt(twisted.w, zero));
+  const SoaQuaternion twisted_fu = {Xor(twisted.x, sign), Xor(twisted.y, sign),
+                                    Xor(twisted.z, sign), Xor(twisted.w, sign)};
+
+  SoaQuaternion correction = twisted_fu;
+  const SimdInt4 partial = CmpLt(weight, one);
+  if (!AreAllFalse(partial)) {
+    // NLerp start and mid joint rotations.
+    correction = Select(partial, NLerpEst(identity, twisted, Max0(weight)),
+                         twisted_fu);
+  }
+  *joint_correction = Select(valid, correction, identity);
+
+  return true;
+}
+
+bool IKAimBatchJob::Validate() const {
+  bool valid = true;
+  for (const IKAimJob& job : joints) {
+    valid &= job.Validate();
+  }
+  return valid;
+}
+
+bool IKAimBatchJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  const size_t count = joints.size();
+  for (size_t i = 0; i < count; i += 4) {
+    // Gathers the four joints of this batch. The last batch is padded with the
+    // last joint, whose outputs are written only once.
+    const IKAimJob* lanes[4];
+    for (size_t l = 0; l < 4; ++l) {
+      lanes[l] = &joints[i + l < count ? i + l : count - 1];
+    }
+
+    // Transposes joints to soa.
+    SimdFloat4 aos[4];
+    IKAimSoaJob job;
+    SoaFloat4x4 joint;
+    for (int c = 0; c < 4; ++c) {
+      for (int l = 0; l < 4; ++l) {
+        aos[l] = lanes[l]->joint->cols[c];
+      }
+      Transpose4x4(aos, &joint.cols[c].x);
+    }
+    for (int l = 0; l < 4; ++l) {
+      aos[l] = lanes[l]->target;
+    }
+    Transpose4x3(aos, &job.target.x);
+    for (int l = 0; l < 4; ++l) {
+      aos[l] = lanes[l]->forward;
+    }
+    Transpose4x3(aos, &job.forward.x);
+    for (int l = 0; l < 4; ++l) {
+      aos[l] = lanes[l]->offset;
+    }
+    Transpose4x3(aos, &job.offset.x);
+    for (int l = 0; l < 4; ++l) {
+      aos[l] = lanes[l]->up;
+    }
+    Transpose4x3(aos, &job.up.x);
+    for (int l = 0; l < 4; ++l) {
+      aos[l] = lanes[l]->pole_vector;
+    }
+    Transpose4x3(aos, &job.pole_vector.x);
+    job.twist_angle =
+        simd_float4::Load(lanes[0]->twist_angle, lanes[1]->twist_angle,
+                          lanes[2]->twist_angle, lanes[3]->twist_angle);
+    job.weight = simd_float4::Load(lanes[0]->weight, lanes[1]->weight,
+                                   lanes[2]->weight, lanes[3]->weight);
+    job.joint = &joint;
+
+    SoaQuaternion correction;
+    SimdInt4 reached;
+    job.joint_correction = &correction;
+    job.reached = &reached;
+    if (!job.Run()) {
+      return false;
+    }
+
+    // Scatters soa outputs back to each joint.
+    SimdFloat4 correction_aos[4];
+    Transpose4x4(&correction.x, correction_aos);
+    int reached_aos[4];
+    StorePtrU(reached, reached_aos);
+    for (size_t l = 0; l < 4 && i + l < count; ++l) {
+      const IKAimJob& lane = *lanes[l];
+      lane.joint_correction->xyzw = correction_aos[l];
+      if (lane.reached) {
+        *lane.reached = reached_aos[l] != 0;
+      }
+    }
+  }
+  return true;
+}
+}  // namespace animation
+}  // namespace ozz
@@ -0,0 +1,283 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/ik_chain_job.h"
+
+#include <cassert>
+
+#include "ozz/base/maths/simd_quaternion.h"
+
+using namespace ozz::math;
+
+namespace ozz {
+namespace animation {
+
+bool IKChainJob::Validate() const {
+  bool valid = true;
+  valid &= chain.size() >= 2;
+  valid &= joint_corrections.size() == chain.size();
+  valid &= joint_weights.empty() || joint_weights.size() == chain.size();
+  valid &= max_iterations >= 0;
+  valid &= tolerance >= 0.f;
+  int previous = -1;
+  for (const int joint : chain) {
+    valid &= joint > previous && joint < static_cast<int>(models.size());
+    previous = joint;
+  }
+  return valid;
+}
+
+namespace {
+
+// Joints positions are stored in corrections output buffer while solving.
+SimdFloat4& Position(const IKChainJob& _job, size_t _i) {
+  return _job.joint_corrections[_i].xyzw;
+}
+
+// Returns initial model-space position of chain joint _i.
+SimdFloat4 InitialPosition(const IKChainJob& _job, size_t _i) {
+  return _job.models[_job.chain[_i]].cols[3];
+}
+
+// Returns true if end joint is within tolerance of the target.
+bool Converged(const IKChainJob& _job, _SimdFloat4 _tolerance2) {
+  const SimdFloat4 end = Position(_job, _job.chain.size() - 1);
+  return AreAllTrue1(CmpLe(Length3Sqr(_job.target - end), _tolerance2));
+}
+
+// Blends quaternion _q with identity, according to _weight. _q must have a
+// positive w, so the shortest path is used.
+SimdQuaternion Weight(const SimdQuaternion& _q, float _weight) {
+  const SimdFloat4 identity = simd_float4::w_axis();
+  const SimdFloat4 simd_weight = Max0(simd_float4::Load1(_weight));
+  const SimdQuaternion weighted = {
+      NormalizeEst4(Lerp(identity, _q.xyzw, simd_weight))};
+  return weighted;
+}
+
+int SolveCCD(const IKChainJob& _job, _SimdFloat4 _tolerance2) {
+  const size_t end = _job.chain.size() - 1;
+  int iteration = 0;
+  for (; iteration < _job.max_iterations; ++iteration) {
+    if (Converged(_job, _tolerance2)) {
+      break;
+    }
+
+    // Rotates each joint, from the end to the root, so that the end joint
+    // points toward the target.
+    for (size_t i = end; i-- > 0;) {
+      const SimdFloat4 pivot = Position(_job, i);
+      SimdQuaternion rotation = SimdQuaternion::FromVectors(
+          Position(_job, end) - pivot, _job.target - pivot);
+      if (!_job.joint_weights.empty() && _job.joint_weights[i] < 1.f) {
+        rotation = Weight(rotation, _job.joint_weights[i]);
+      }
+
+      // Children joints are rotated around the pivot.
+      for (size_t j = i + 1; j <= end; ++j) {
+        Position(_job, j) =
+            pivot + TransformVector(rotation, Position(_job, j) - pivot);
+      }
+    }
+  }
+  return iteration;
+}
+
+int SolveFABRIK(const IKChainJob& _job, _SimdFloat4 _tolerance2) {
+  const size_t end = _job.chain.size() - 1;
+  const SimdFloat4 root = Position(_job, 0);
+
+  // If the target is further than the chain length, then the chain is simply
+  // stretched toward the target.
+  SimdFloat4 chain_length = simd_float4::zero();
+  for (size_t i = 0; i < end; ++i) {
+    chain_length = chain_length + Length3(InitialPosition(_job, i + 1) -
+                                          InitialPosition(_job, i));
+  }
+  const SimdFloat4 root_target = _job.target - root;
+  if (AreAllTrue1(CmpGt(Length3(root_target), chain_length))) {
+    if (_job.max_iterations == 0) {
+      return 0;
+    }
+    const SimdFloat4 direction =
+        NormalizeSafe3(root_target, simd_float4::zero());
+    for (size_t i = 0; i < end; ++i) {
+      const SimdFloat4 length = SplatX(Length3(InitialPosition(_job, i + 1) -
+                                               InitialPosition(_job, i)));
+      Position(_job, i + 1) = Position(_job, i) + direction * length;
+    }
+    return 1;
+  }
+
+  int iteration = 0;
+  for (; iteration < _job.max_iterations; ++iteration) {
+    if (Converged(_job, _tolerance2)) {
+      break;
+    }
+
+    // Forward reaching, end joint is placed at the target and its ancestors
+    // follow. Bone initial direction is used if joints overlap.
+    Position(_job, end) = _job.target;
+    for (size_t i = end; i-- > 0;) {
+      const SimdFloat4 bone =
+          InitialPosition(_job, i) - InitialPosition(_job, i + 1);
+      const SimdFloat4 length = SplatX(Length3(bone));
+      const SimdFloat4 direction =
+          NormalizeSafe3(Position(_job, i) - Position(_job, i + 1),
+                         NormalizeSafe3(bone, simd_float4::zero()));
+      Position(_job, i) = Position(_job, i + 1) + direction * length;
+    }
+
+    // Backward reaching, root joint is placed back to its position and its
+    // children follow.
+    Position(_job, 0) = root;
+    for (size_t i = 0; i < end; ++i) {
+      const SimdFloat4 bone =
+          InitialPosition(_job, i + 1) - InitialPosition(_job, i);
+      const SimdFloat4 length = SplatX(Length3(bone));
+      const SimdFloat4 direction =
+          NormalizeSafe3(Position(_job, i + 1) - Position(_job, i),
+                         NormalizeSafe3(bone, simd_float4::zero()));
+      Position(_job, i + 1) = Position(_job, i) + direction * length;
+    }
+  }
+  return iteration;
+}
+
+// Deduces joints local-space corrections from solved positions, from the root
+// to the end of the chain. Each joint is rotated so that its child reaches its
+// solved position, considering corrections already applied to its ancestors.
+// Returns the model-space position of the end joint once corrections are
+// applied.
+SimdFloat4 ComputeCorrections(const IKChainJob& _job) {
+  const size_t end = _job.chain.size() - 1;
+  const bool fabrik_weights =
+      _job.solver == IKChainJob::kFABRIK && !_job.joint_weights.empty();
+
+  // Model-space matrix of the previous chain joint, before (inverse) and after
+  // correction.
+  Float4x4 parent_inv = Float4x4::identity();
+  Float4x4 parent_corrected = Float4x4::identity();
+  for (size_t i = 0; i < end; ++i) {
+    const Float4x4& model = _job.models[_job.chain[i]];
+
+    // Joint model-space matrix, once corrections of its ancestors are applied.
+    const Float4x4 corrected =
+        i == 0 ? model : parent_corrected * (parent_inv * model);
+
+    // If matrices aren't invertible, they'll be all 0 (ozz::math
+    // implementation), which will result in identity correction quaternions.
+    SimdInt4 invertible;
+    const Float4x4 inv_model = Invert(model, &invertible);
+    const Float4x4 inv_corrected = Invert(corrected, &invertible);
+
+    // Child joint initial and solved positions, in joint local-space.
+    const SimdFloat4 initial_ls = TransformVector(
+        inv_model, InitialPosition(_job, i + 1) - model.cols[3]);
+    const SimdFloat4 solved_ls = TransformVector(
+        inv_corrected, Position(_job, i + 1) - corrected.cols[3]);
+    SimdQuaternion correction =
+        SimdQuaternion::FromVectors(initial_ls, solved_ls);
+
+    // Applies weights.
+    float weight = _job.weight;
+    if (fabrik_weights) {
+      weight *= _job.joint_weights[i];
+    }
+    if (weight < 1.f) {
+      correction = Weight(correction, weight);
+    }
+
+    // Position i isn't needed anymore, correction can overwrite it.
+    _job.joint_corrections[i] = correction;
+
+    parent_inv = inv_model;
+    parent_corrected = corrected * Float4x4::FromQuaternion(correction.xyzw);
+  }
+
+  // End joint isn't rotated.
+  _job.joint_corrections[end] = SimdQuaternion::identity();
+  const Float4x4 end_corrected =
+      parent_corrected * (parent_inv * _job.models[_job.chain[end]]);
+  return end_corrected.cols[3];
+}
+}  // namespace
+
+bool IKChainJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  // Early out if weight is 0.
+  if (weight <= 0.f) {
+    // No correction.
+    for (SimdQuaternion& correction : joint_corrections) {
+      correction = SimdQuaternion::identity();
+    }
+    // Target isn't reached.
+    if (reached) {
+      *reached = false;
+    }
+    if (iterations) {
+      *iterations = 0;
+    }
+    if (distance) {
+      const SimdFloat4 end = InitialPosition(*this, chain.size() - 1);
+      *distance = GetX(Length3(target - end));
+    }
+    return true;
+  }
+
+  // Initializes joints positions.
+  for (size_t i = 0; i < chain.size(); ++i) {
+    Position(*this, i) = InitialPosition(*this, i);
+  }
+
+  // Solves joints positions.
+  const SimdFloat4 tolerance2 = simd_float4::Load1(tolerance * tolerance);
+  const int literations = solver == kFABRIK ? SolveFABRIK(*this, tolerance2)
+                                            : SolveCCD(*this, tolerance2);
+  if (iterations) {
+    *iterations = literations;
+  }
+
+  // Converts positions to local-space corrections.
+  const SimdFloat4 end = ComputeCorrections(*this);
+
+  // Target is reached if corrected end joint is within tolerance.
+  const SimdFloat4 ldistance = Length3(target - end);
+  if (reached) {
+    *reached = GetX(ldistance) <= tolerance && weight >= 1.f;
+  }
+  if (distance) {
+    *distance = GetX(ldistance);
+  }
+
+  return true;
+}
+}  // namespace animation
+}  // namespace ozz
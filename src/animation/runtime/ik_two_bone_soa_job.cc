@@ -0,0 +1,481 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/ik_two_bone_soa_job.h"
+
+#include <cassert>
+
+#include "ozz/base/maths/simd_quaternion.h"
+#include "ozz/base/maths/soa_float4x4.h"
+#include "ozz/base/maths/soa_quaternion.h"
+
+using namespace ozz::math;
+
+namespace ozz {
+namespace animation {
+
+bool IKTwoBoneSoaJob::Validate() const {
+  bool valid = true;
+  valid &= start_joint && mid_joint && end_joint;
+  valid &= start_joint_correction && mid_joint_correction;
+  valid &= AreAllTrue(IsNormalizedEst(mid_axis));
+  return valid;
+}
+
+namespace {
+
+// Returns the translation of model-space matrices _m.
+SoaFloat3 Translation(const SoaFloat4x4& _m) {
+  const SoaFloat3 ret = {_m.cols[3].x, _m.cols[3].y, _m.cols[3].z};
+  return ret;
+}
+
+// Local data structure used to share constant data accross ik stages. This is
+// the soa version of IKTwoBoneJob IKConstantSetup.
+struct IKSoaConstantSetup {
+  IKSoaConstantSetup(const IKTwoBoneSoaJob& _job) {
+    // Prepares constants
+    one = simd_float4::one();
+    m_one = -one;
+    mask_sign = simd_int4::mask_sign();
+
+    // Computes inverse matrices required to change to start and mid spaces.
+    // If matrices aren't invertible, they'll be all 0 (ozz::math
+    // implementation), which will result in identity correction quaternions.
+    SimdInt4 invertible;
+    inv_start_joint = Invert(*_job.start_joint, &invertible);
+    const SoaFloat4x4 inv_mid_joint = Invert(*_job.mid_joint, &invertible);
+
+    const SoaFloat3 start = Translation(*_job.start_joint);
+    const SoaFloat3 mid = Translation(*_job.mid_joint);
+    const SoaFloat3 end = Translation(*_job.end_joint);
+
+    // Transform some positions to mid joint space (_ms)
+    const SoaFloat3 start_ms = TransformPoint(inv_mid_joint, start);
+    const SoaFloat3 end_ms = TransformPoint(inv_mid_joint, end);
+
+    // Transform some positions to start joint space (_ss)
+    const SoaFloat3 mid_ss = TransformPoint(inv_start_joint, mid);
+    const SoaFloat3 end_ss = TransformPoint(inv_start_joint, end);
+
+    // Computes bones vectors and length in mid and start spaces.
+    // Start joint position will be treated as 0 because all joints are
+    // expressed in start joint space.
+    start_mid_ms = -start_ms;
+    mid_end_ms = end_ms;
+    start_mid_ss = mid_ss;
+    const SoaFloat3 mid_end_ss = end_ss - mid_ss;
+    const SoaFloat3 start_end_ss = end_ss;
+    start_mid_ss_len2 = LengthSqr(start_mid_ss);
+    mid_end_ss_len2 = LengthSqr(mid_end_ss);
+    start_end_ss_len2 = LengthSqr(start_end_ss);
+  }
+
+  // Constants
+  SimdFloat4 one;
+  SimdFloat4 m_one;
+  SimdInt4 mask_sign;
+
+  // Inverse matrices
+  SoaFloat4x4 inv_start_joint;
+
+  // Bones vectors and length in mid and start spaces (_ms and _ss).
+  SoaFloat3 start_mid_ms;
+  SoaFloat3 mid_end_ms;
+  SoaFloat3 start_mid_ss;
+  SimdFloat4 start_mid_ss_len2;
+  SimdFloat4 mid_end_ss_len2;
+  SimdFloat4 start_end_ss_len2;
+};
+
+// Smoothen target positions when they're further that a ratio of the joint
+// chain length, and start to target length isn't 0. Returns the mask of the
+// lanes whose target is reachable.
+SimdInt4 SoftenTarget(const IKTwoBoneSoaJob& _job,
+                      const IKSoaConstantSetup& _setup,
+                      SoaFloat3* _start_target_ss,
+                      SimdFloat4* _start_target_ss_len2) {
+  // Hanlde position in start joint space (_ss)
+  const SoaFloat3 start_target_original_ss =
+      TransformPoint(_setup.inv_start_joint, _job.target);
+  const SimdFloat4 start_target_original_ss_len2 =
+      LengthSqr(start_target_original_ss);
+  const SimdFloat4 start_mid_ss_len = Sqrt(_setup.start_mid_ss_len2);
+  const SimdFloat4 mid_end_ss_len = Sqrt(_setup.mid_end_ss_len2);
+  const SimdFloat4 start_target_original_ss_len =
+      Sqrt(start_target_original_ss_len2);
+  const SimdFloat4 bone_len_diff_abs = Abs(start_mid_ss_len - mid_end_ss_len);
+  const SimdFloat4 bones_chain_len = start_mid_ss_len + mid_end_ss_len;
+  const SimdFloat4 da =
+      bones_chain_len * Clamp(simd_float4::zero(), _job.soften, _setup.one);
+  const SimdFloat4 ds = bones_chain_len - da;
+
+  // Sotftens target position if it is further than a ratio (_soften) of the
+  // whole bone chain length. Needs to check also that ds and
+  // start_target_original_ss_len2 are != 0, because they're used as a
+  // denominator.
+  const SimdInt4 further = CmpGt(start_target_original_ss_len, da);
+  const SimdInt4 not_null =
+      CmpGt(start_target_original_ss_len, simd_float4::zero());
+  const SimdInt4 not_rigid = CmpGt(ds, simd_float4::zero());
+  const SimdInt4 soften = And(And(further, not_null), not_rigid);
+
+  // Finds interpolation ratio (aka alpha). Lanes that aren't softened may
+  // compute invalid values, which are discarded by the final selection.
+  const SimdFloat4 alpha = (start_target_original_ss_len - da) * RcpEst(ds);
+  // Approximate an exponential function with : 1-(3^4)/(alpha+3)^4
+  // The derivative must be 1 for x = 0, and y must never exceeds 1.
+  // Negative x aren't used.
+  const SimdFloat4 op = alpha + simd_float4::Load1(3.f);
+  const SimdFloat4 op2 = op * op;
+  const SimdFloat4 op4 = op2 * op2;
+  const SimdFloat4 ratio = simd_float4::Load1(81.f) * RcpEst(op4);
+
+  // Recomputes start_target_ss vector and length.
+  const SimdFloat4 start_target_ss_len = da + ds - ds * ratio;
+  const SoaFloat3 start_target_softened_ss =
+      start_target_original_ss *
+      (start_target_ss_len * RcpEst(start_target_original_ss_len));
+
+  *_start_target_ss_len2 =
+      Select(soften, start_target_ss_len * start_target_ss_len,
+             start_target_original_ss_len2);
+  *_start_target_ss =
+      Select(soften, start_target_softened_ss, start_target_original_ss);
+
+  // The maximum distance we can reach is the soften bone chain length: da.
+  // The minimum distance we can reach is the absolute value of the difference
+  // of the 2 bone lengths, |d1-d2|.
+  return AndNot(CmpGt(start_target_original_ss_len, bone_len_diff_abs),
+                further);
+}
+
+SoaQuaternion ComputeMidJoint(const IKTwoBoneSoaJob& _job,
+                              const IKSoaConstantSetup& _setup,
+                              _SimdFloat4 _start_target_ss_len2) {
+  // Computes expected angle at mid_ss joint, using law of cosine (generalized
+  // Pythagorean).
+  // c^2 = a^2 + b^2 - 2ab cosC
+  // cosC = (a^2 + b^2 - c^2) / 2ab
+  // Computes both corrected and initial mid joint angles cosine.
+  const SimdFloat4 start_mid_end_sum_ss_len2 =
+      _setup.start_mid_ss_len2 + _setup.mid_end_ss_len2;
+  const SimdFloat4 start_mid_end_ss_half_rlen =
+      simd_float4::Load1(.5f) *
+      RSqrtEstNR(_setup.start_mid_ss_len2 * _setup.mid_end_ss_len2);
+  // Cos value needs to be clamped, as it will exit expected range if
+  // start_target_ss_len2 is longer than the triangle can be (start_mid_ss +
+  // mid_end_ss).
+  const SimdFloat4 mid_cos_corrected_angle =
+      Clamp(_setup.m_one,
+            (start_mid_end_sum_ss_len2 - _start_target_ss_len2) *
+                start_mid_end_ss_half_rlen,
+            _setup.one);
+  const SimdFloat4 mid_cos_initial_angle =
+      Clamp(_setup.m_one,
+            (start_mid_end_sum_ss_len2 - _setup.start_end_ss_len2) *
+                start_mid_end_ss_half_rlen,
+            _setup.one);
+
+  // Computes corrected angle
+  const SimdFloat4 mid_corrected_angle = ACos(mid_cos_corrected_angle);
+
+  // Computes initial angle.
+  // The sign of this angle needs to be decided. It's considered negative if
+  // mid-to-end joint is bent backward (mid_axis direction dictates valid
+  // bent direction).
+  const SoaFloat3 bent_side_ref = Cross(_setup.start_mid_ms, _job.mid_axis);
+  const SimdInt4 bent_side_flip =
+      CmpLt(Dot(bent_side_ref, _setup.mid_end_ms), simd_float4::zero());
+  const SimdFloat4 mid_initial_angle =
+      Xor(ACos(mid_cos_initial_angle), And(bent_side_flip, _setup.mask_sign));
+
+  // Finally deduces initial to corrected angle difference.
+  const SimdFloat4 mid_angles_diff = mid_corrected_angle - mid_initial_angle;
+
+  // Builds queternion.
+  return SoaQuaternion::FromAxisAngle(_job.mid_axis, mid_angles_diff);
+}
+
+SoaQuaternion ComputeStartJoint(const IKTwoBoneSoaJob& _job,
+                                const IKSoaConstantSetup& _setup,
+                                const SoaQuaternion& _mid_rot_ms,
+                                const SoaFloat3& _start_target_ss,
+                                _SimdFloat4 _start_target_ss_len2) {
+  // Pole vector in start joint space (_ss)
+  const SoaFloat3 pole_ss =
+      TransformVector(_setup.inv_start_joint, _job.pole_vector);
+
+  // start_mid_ss with quaternion mid_rot_ms applied.
+  const SoaFloat3 mid_end_ss_final = TransformVector(
+      _setup.inv_start_joint,
+      TransformVector(*_job.mid_joint,
+                      TransformVector(_mid_rot_ms, _setup.mid_end_ms)));
+  const SoaFloat3 start_end_ss_final = _setup.start_mid_ss + mid_end_ss_final;
+
+  // Quaternion for rotating the effector onto the target
+  const SoaQuaternion end_to_target_rot_ss =
+      SoaQuaternion::FromVectors(start_end_ss_final, _start_target_ss);
+
+  // Calculates rotate_plane_ss quaternion which aligns joint chain plane to
+  // the reference plane (pole vector). This can only be computed if start
+  // target axis is valid (not 0 length)
+  // -------------------------------------------------
+  const SimdInt4 valid_target =
+      CmpGt(_start_target_ss_len2, simd_float4::zero());
+  if (AreAllFalse(valid_target)) {
+    return end_to_target_rot_ss;
+  }
+
+  // Computes each plane normal.
+  const SoaFloat3 ref_plane_normal_ss = Cross(_start_target_ss, pole_ss);
+  const SimdFloat4 ref_plane_normal_ss_len2 = LengthSqr(ref_plane_normal_ss);
+  // Computes joint chain plane normal, which is the same as mid joint axis
+  // (same triangle).
+  const SoaFloat3 mid_axis_ss = TransformVector(
+      _setup.inv_start_joint, TransformVector(*_job.mid_joint, _job.mid_axis));
+  const SoaFloat3 joint_plane_normal_ss =
+      TransformVector(end_to_target_rot_ss, mid_axis_ss);
+  const SimdFloat4 joint_plane_normal_ss_len2 =
+      LengthSqr(joint_plane_normal_ss);
+
+  // Computes angle cosine between the 2 normalized normals.
+  const SimdFloat4 rotate_plane_cos_angle =
+      Dot(ref_plane_normal_ss * RSqrtEstNR(ref_plane_normal_ss_len2),
+          joint_plane_normal_ss * RSqrtEstNR(joint_plane_normal_ss_len2));
+
+  // Computes rotation axis, which is either start_target_ss or
+  // -start_target_ss depending on rotation direction.
+  const SoaFloat3 rotate_plane_axis_ss =
+      _start_target_ss * RSqrtEstNR(_start_target_ss_len2);
+  const SimdFloat4 start_axis_flip =
+      And(Dot(joint_plane_normal_ss, pole_ss), _setup.mask_sign);
+  const SoaFloat3 rotate_plane_axis_flipped_ss = {
+      Xor(rotate_plane_axis_ss.x, start_axis_flip),
+      Xor(rotate_plane_axis_ss.y, start_axis_flip),
+      Xor(rotate_plane_axis_ss.z, start_axis_flip)};
+
+  // Builds quaternion along rotation axis. Invalid lanes (null target) are
+  // selected out, they are replaced with identity to keep computation valid.
+  const SoaFloat3 safe_axis = Select(
+      valid_target, rotate_plane_axis_flipped_ss, SoaFloat3::x_axis());
+  const SoaQuaternion rotate_plane_ss = SoaQuaternion::FromAxisCosAngle(
+      safe_axis, Select(valid_target,
+                        Clamp(_setup.m_one, rotate_plane_cos_angle, _setup.one),
+                        _setup.one));
+
+  SoaQuaternion start_rot_ss = rotate_plane_ss * end_to_target_rot_ss;
+  const SimdInt4 twisted = CmpNe(_job.twist_angle, simd_float4::zero());
+  if (!AreAllFalse(twisted)) {
+    // If a twist angle is provided, rotation angle is rotated along
+    // rotation plane axis.
+    const SoaFloat3 safe_twist_axis =
+        Select(valid_target, rotate_plane_axis_ss, SoaFloat3::x_axis());
+    const SoaQuaternion twist_ss =
+        SoaQuaternion::FromAxisAngle(safe_twist_axis, _job.twist_angle);
+    start_rot_ss = Select(twisted, twist_ss * start_rot_ss, start_rot_ss);
+  }
+  return Select(valid_target, start_rot_ss, end_to_target_rot_ss);
+}
+
+// Fix up quaternions so w is always positive, which is required for NLerp
+// (with identity quaternion) to lerp the shortest path.
+SoaQuaternion FixUp(const SoaQuaternion& _q, _SimdInt4 _mask_sign) {
+  const SimdInt4 sign = And(_mask_sign, CmpLt(_q.w, simd_float4::zero()));
+  const SoaQuaternion ret = {Xor(_q.x, sign), Xor(_q.y, sign),
+                             Xor(_q.z, sign), Xor(_q.w, sign)};
+  return ret;
+}
+
+void WeightOutput(const IKTwoBoneSoaJob& _job, const IKSoaConstantSetup& _setup,
+                  const SoaQuaternion& _start_rot,
+                  const SoaQuaternion& _mid_rot) {
+  const SimdFloat4 zero = simd_float4::zero();
+  const SoaQuaternion identity = SoaQuaternion::identity();
+
+  const SoaQuaternion start_rot_fu = FixUp(_start_rot, _setup.mask_sign);
+  const SoaQuaternion mid_rot_fu = FixUp(_mid_rot, _setup.mask_sign);
+
+  // Lanes with a null (or negative) weight have no correction.
+  const SimdInt4 active = CmpGt(_job.weight, zero);
+  const SimdInt4 partial = CmpLt(_job.weight, _setup.one);
+  if (AreAllFalse(partial)) {
+    // Quatenions don't need interpolation
+    *_job.start_joint_correction = start_rot_fu;
+    *_job.mid_joint_correction = mid_rot_fu;
+  } else {
+    // NLerp start and mid joint rotations.
+    const SimdFloat4 simd_weight = Max(zero, _job.weight);
+    *_job.start_joint_correction =
+        Select(partial, NLerpEst(identity, start_rot_fu, simd_weight),
+                start_rot_fu);
+    *_job.mid_joint_correction = Select(
+        partial, NLerpEst(identity, mid_rot_fu, simd_weight), mid_rot_fu);
+    *_job.start_joint_correction =
+        Select(active, *_job.start_joint_correction, identity);
+    *_job.mid_joint_correction =
+        Select(active, *_job.mid_joint_correction, identity);
+  }
+}
+}  // namespace
+
+bool IKTwoBoneSoaJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  // Early out if all weights are 0.
+  if (AreAllFalse(CmpGt(weight, simd_float4::zero()))) {
+    // No correction.
+    *start_joint_correction = *mid_joint_correction =
+        SoaQuaternion::identity();
+    // Target isn't reached.
+    if (reached) {
+      *reached = simd_int4::zero();
+    }
+    return true;
+  }
+
+  // Prepares constant ik data.
+  const IKSoaConstantSetup setup(*this);
+
+  // Finds soften target position.
+  SoaFloat3 start_target_ss;
+  SimdFloat4 start_target_ss_len2;
+  const SimdInt4 lreached =
+      SoftenTarget(*this, setup, &start_target_ss, &start_target_ss_len2);
+  if (reached) {
+    *reached = And(lreached, CmpGe(weight, setup.one));
+  }
+
+  // Calculate mid_rot_local quaternion which solves for the mid_ss joint
+  // rotation.
+  const SoaQuaternion mid_rot_ms =
+      ComputeMidJoint(*this, setup, start_target_ss_len2);
+
+  // Calculates end_to_target_rot_ss quaternion which solves for effector
+  // rotating onto the target.
+  const SoaQuaternion start_rot_ss = ComputeStartJoint(
+      *this, setup, mid_rot_ms, start_target_ss, start_target_ss_len2);
+
+  // Finally apply weight and output quaternions.
+  WeightOutput(*this, setup, start_rot_ss, mid_rot_ms);
+
+  return true;
+}
+
+bool IKTwoBoneBatchJob::Validate() const {
+  bool valid = true;
+  for (const IKTwoBoneJob& chain : chains) {
+    valid &= chain.Validate();
+  }
+  return valid;
+}
+
+bool IKTwoBoneBatchJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  const size_t count = chains.size();
+  for (size_t i = 0; i < count; i += 4) {
+    // Gathers the four chains of this batch. The last batch is padded with the
+    // last chain, whose outputs are written only once.
+    const IKTwoBoneJob* lanes[4];
+    for (size_t l = 0; l < 4; ++l) {
+      lanes[l] = &chains[i + l < count ? i + l : count - 1];
+    }
+
+    // Transposes chains to soa.
+    SimdFloat4 aos[4];
+    IKTwoBoneSoaJob job;
+    SoaFloat4x4 start_joint, mid_joint, end_joint;
+    for (int c = 0; c < 4; ++c) {
+      for (int l = 0; l < 4; ++l) {
+        aos[l] = lanes[l]->start_joint->cols[c];
+      }
+      Transpose4x4(aos, &start_joint.cols[c].x);
+      for (int l = 0; l < 4; ++l) {
+        aos[l] = lanes[l]->mid_joint->cols[c];
+      }
+      Transpose4x4(aos, &mid_joint.cols[c].x);
+      for (int l = 0; l < 4; ++l) {
+        aos[l] = lanes[l]->end_joint->cols[c];
+      }
+      Transpose4x4(aos, &end_joint.cols[c].x);
+    }
+    for (int l = 0; l < 4; ++l) {
+      aos[l] = lanes[l]->target;
+    }
+    Transpose4x3(aos, &job.target.x);
+    for (int l = 0; l < 4; ++l) {
+      aos[l] = lanes[l]->mid_axis;
+    }
+    Transpose4x3(aos, &job.mid_axis.x);
+    for (int l = 0; l < 4; ++l) {
+      aos[l] = lanes[l]->pole_vector;
+    }
+    Transpose4x3(aos, &job.pole_vector.x);
+    job.twist_angle =
+        simd_float4::Load(lanes[0]->twist_angle, lanes[1]->twist_angle,
+                          lanes[2]->twist_angle, lanes[3]->twist_angle);
+    job.soften = simd_float4::Load(lanes[0]->soften, lanes[1]->soften,
+                                   lanes[2]->soften, lanes[3]->soften);
+    job.weight = simd_float4::Load(lanes[0]->weight, lanes[1]->weight,
+                                   lanes[2]->weight, lanes[3]->weight);
+    job.start_joint = &start_joint;
+    job.mid_joint = &mid_joint;
+    job.end_joint = &end_joint;
+
+    SoaQuaternion start_correction, mid_correction;
+    SimdInt4 reached;
+    job.start_joint_correction = &start_correction;
+    job.mid_joint_correction = &mid_correction;
+    job.reached = &reached;
+    if (!job.Run()) {
+      return false;
+    }
+
+    // Scatters soa outputs back to each chain.
+    SimdFloat4 start_aos[4], mid_aos[4];
+    Transpose4x4(&start_correction.x, start_aos);
+    Transpose4x4(&mid_correction.x, mid_aos);
+    int reached_aos[4];
+    StorePtrU(reached, reached_aos);
+    for (size_t l = 0; l < 4 && i + l < count; ++l) {
+      const IKTwoBoneJob& chain = *lanes[l];
+      chain.start_joint_correction->xyzw = start_aos[l];
+      chain.mid_joint_correction->xyzw = mid_aos[l];
+      if (chain.reached) {
+        *chain.reached = reached_aos[l] != 0;
+      }
+    }
+  }
+  return true;
+}
+}  // namespace animation
+}  // namespace ozz
@@ -33,6 +33,7 @@
 #include "ozz/base/maths/simd_math.h"
 #include "ozz/base/maths/soa_float4x4.h"
 #include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/scheduler.h"
 
 namespace ozz {
 namespace animation {
@@ -52,52 +53,367 @@ bool LocalToModelJob::Validate() const {
   const size_t num_soa_joints = (num_joints + 3) / 4;
 
   // Test input and output ranges, implicitly tests for nullptr end pointers.
+  // Matrix output is optional if affine output is provided.
   valid &= input.size() >= num_soa_joints;
-  valid &= output.size() >= num_joints;
+  if (output_affine.empty()) {
+    valid &= output.size() >= num_joints;
+  } else {
+    valid &= output_affine.size() >= num_joints;
+    valid &= output.empty() || output.size() >= num_joints;
+  }
+
+  // Checks grain size.
+  valid &= grain_size > 0;
+
+  // Checks dirty joints set, optional.
+  valid &= dirty.empty() || dirty.size() >= (num_joints + 7) / 8;
 
   return valid;
 }
 
-bool LocalToModelJob::Run() const {
-  if (!Validate()) {
-    return false;
+namespace {
+
+// Output policies, specializing the update loop for each output type. Parent
+// returns model-space matrix of an already updated joint, Store outputs
+// model-space matrix of a joint.
+struct MatrixOutput {
+  OZZ_INLINE const math::Float4x4& Parent(int _joint) const {
+    return matrices[_joint];
+  }
+  OZZ_INLINE void Store(int _joint, const math::Float4x4& _matrix) const {
+    matrices[_joint] = _matrix;
   }
+  span<math::Float4x4> matrices;
+};
 
-  const span<const int16_t>& parents = skeleton->joint_parents();
+struct AffineOutput {
+  OZZ_INLINE math::Float4x4 Parent(int _joint) const {
+    return math::ToFloat4x4(affines[_joint]);
+  }
+  OZZ_INLINE void Store(int _joint, const math::Float4x4& _matrix) const {
+    affines[_joint] = math::Float3x4::FromFloat4x4(_matrix);
+  }
+  span<math::Float3x4> affines;
+};
+
+struct MatrixAndAffineOutput {
+  OZZ_INLINE const math::Float4x4& Parent(int _joint) const {
+    return matrices[_joint];
+  }
+  OZZ_INLINE void Store(int _joint, const math::Float4x4& _matrix) const {
+    matrices[_joint] = _matrix;
+    affines[_joint] = math::Float3x4::FromFloat4x4(_matrix);
+  }
+  span<math::Float4x4> matrices;
+  span<math::Float3x4> affines;
+};
+
+// Multiplies soa matrices _a and _b, where _b is affine: its last row is
+// (0, 0, 0, 1), which saves a quarter of the multiplications.
+OZZ_INLINE math::SoaFloat4x4 MultiplyAffine(const math::SoaFloat4x4& _a,
+                                            const math::SoaFloat4x4& _b) {
+  math::SoaFloat4x4 ret;
+  for (int c = 0; c < 4; ++c) {
+    const math::SoaFloat4& b = _b.cols[c];
+    ret.cols[c] = _a.cols[0] * b.x + _a.cols[1] * b.y + _a.cols[2] * b.z;
+  }
+  ret.cols[3] = ret.cols[3] + _a.cols[3];
+  return ret;
+}
+
+// Updates joints of range [_begin,_end[. Parents of range joints must be
+// either updated already, or part of the range. Only joints flagged in _update
+// are updated, unless _update is nullptr.
+template <typename _Output>
+void UpdateRange(const LocalToModelJob& _job, const _Output& _output,
+                 const math::Float4x4& _root, const bool* _update, int _begin,
+                 int _end) {
+  const span<const int16_t>& parents = _job.skeleton->joint_parents();
+  for (int i = _begin; i < _end;) {
+    const int soa_end = math::Min((i + 4) & ~3, _end);
+
+    // Skips groups of joints that don't need to be updated.
+    if (_update) {
+      bool any = false;
+      for (int j = i; j < soa_end; ++j) {
+        any |= _update[j];
+      }
+      if (!any) {
+        i = soa_end;
+        continue;
+      }
+    }
 
-  // Initializes an identity matrix that will be used to compute roots model
-  // matrices without requiring a branch.
-  const math::Float4x4 identity = math::Float4x4::identity();
-  const math::Float4x4* root_matrix = (root == nullptr) ? &identity : root;
-
-  // Applies hierarchical transformation.
-  // Loop ends after "to".
-  const int end = math::Min(to + 1, skeleton->num_joints());
-  // Begins iteration from "from", or the next joint if "from" is excluded.
-  // Process next joint if end is not reach. parents[begin] >= from is true as
-  // long as "begin" is a child of "from".
-  for (int i = math::Max(from + from_excluded, 0),
-           process = i < end && (!from_excluded || parents[i] >= from);
-       process;) {
     // Builds soa matrices from soa transforms.
-    const math::SoaTransform& transform = input[i / 4];
+    const math::SoaTransform& transform = _job.input[i / 4];
     const math::SoaFloat4x4 local_soa_matrices = math::SoaFloat4x4::FromAffine(
         transform.translation, transform.rotation, transform.scale);
 
+    // If none of the 4 joints is the parent of another one, which is common
+    // for skeletons sorted by depth, they're all multiplied at once in soa
+    // format.
+    if ((i & 3) == 0 && i + 4 <= _end && parents[i] < i &&
+        parents[i + 1] < i && parents[i + 2] < i && parents[i + 3] < i &&
+        (!_update ||
+         (_update[i] && _update[i + 1] && _update[i + 2] && _update[i + 3]))) {
+      math::Float4x4 aos_matrices[4];
+      for (int j = 0; j < 4; ++j) {
+        const int parent = parents[i + j];
+        aos_matrices[j] =
+            parent == Skeleton::kNoParent ? _root : _output.Parent(parent);
+      }
+
+      // Converts parent matrices to soa, one column at a time.
+      math::SoaFloat4x4 parent_soa_matrices;
+      for (int c = 0; c < 4; ++c) {
+        const math::SimdFloat4 cols[4] = {
+            aos_matrices[0].cols[c], aos_matrices[1].cols[c],
+            aos_matrices[2].cols[c], aos_matrices[3].cols[c]};
+        math::Transpose4x4(cols, &parent_soa_matrices.cols[c].x);
+      }
+
+      const math::SoaFloat4x4 model_soa_matrices =
+          MultiplyAffine(parent_soa_matrices, local_soa_matrices);
+
+      // Converts back to aos.
+      for (int c = 0; c < 4; ++c) {
+        math::SimdFloat4 cols[4];
+        math::Transpose4x4(&model_soa_matrices.cols[c].x, cols);
+        for (int j = 0; j < 4; ++j) {
+          aos_matrices[j].cols[c] = cols[j];
+        }
+      }
+      for (int j = 0; j < 4; ++j, ++i) {
+        _output.Store(i, aos_matrices[j]);
+      }
+      continue;
+    }
+
     // Converts to aos matrices.
     math::Float4x4 local_aos_matrices[4];
     math::Transpose16x16(&local_soa_matrices.cols[0].x,
                          local_aos_matrices->cols);
 
-    // parents[i] >= from is true as long as "i" is a child of "from".
-    for (const int soa_end = (i + 4) & ~3; i < soa_end && process;
-         ++i, process = i < end && parents[i] >= from) {
+    for (; i < soa_end; ++i) {
+      if (_update && !_update[i]) {
+        continue;
+      }
       const int parent = parents[i];
-      const math::Float4x4* parent_matrix =
-          parent == Skeleton::kNoParent ? root_matrix : &output[parent];
-      output[i] = *parent_matrix * local_aos_matrices[i & 3];
+      const math::Float4x4& parent_matrix =
+          parent == Skeleton::kNoParent ? _root : _output.Parent(parent);
+      _output.Store(i, parent_matrix * local_aos_matrices[i & 3]);
     }
   }
+}
+
+// Defines a range of joints [begin,end[.
+struct JointRange {
+  int begin;
+  int end;
+};
+
+// Maximum number of sub-hierarchy ranges dispatched to the scheduler.
+const int kMaxTasks = 64;
+
+// Outputs to _ranges the sub-hierarchies of joints range [_begin,_end[, merged
+// into at most _max contiguous ranges of similar sizes. A sub-hierarchy starts
+// with a joint whose parent is outside of the range.
+// Returns the number of ranges.
+int SplitSubHierarchies(span<const int16_t> _parents, int _begin, int _end,
+                        int _max, JointRange* _ranges) {
+  assert(_max > 0 && _begin < _end);
+  const int min_size = (_end - _begin + _max - 1) / _max;
+  int count = 0;
+  for (int i = _begin + 1, range_begin = _begin; i <= _end; ++i) {
+    if ((i == _end || _parents[i] < _begin) && i - range_begin >= min_size) {
+      _ranges[count++] = {range_begin, i};
+      range_begin = i;
+    } else if (i == _end) {
+      _ranges[count++] = {range_begin, i};
+    }
+  }
+  assert(count <= _max);
+  return count;
+}
+
+// Tests whether joints of _parents are ordered depth-first, meaning that every
+// joint parent is the previous joint, or one of its ancestors.
+bool IsDepthFirst(span<const int16_t> _parents) {
+  int16_t ancestors[Skeleton::kMaxJoints];
+  int depth = 0;
+  for (size_t i = 0; i < _parents.size(); ++i) {
+    const int parent = _parents[i];
+    while (depth > 0 && ancestors[depth - 1] != parent) {
+      --depth;
+    }
+    if (depth == 0 && parent != Skeleton::kNoParent) {
+      return false;
+    }
+    ancestors[depth++] = static_cast<int16_t>(i);
+  }
+  return true;
+}
+
+// Finds the root of a sub-hierarchy of range [_begin,_end[ (a joint whose
+// parent is outside of the range) that is the closest to the middle of the
+// range. Returns _begin if the range contains a single sub-hierarchy.
+int MiddleRoot(span<const int16_t> _parents, int _begin, int _end) {
+  const int middle = (_begin + _end) / 2;
+  int root = _begin;
+  int root_distance = _end - _begin;
+  for (int i = _begin + 1; i < _end; ++i) {
+    const int distance = i < middle ? middle - i : i - middle;
+    if (_parents[i] < _begin && distance < root_distance) {
+      root = i;
+      root_distance = distance;
+    }
+  }
+  return root;
+}
+
+// Finds the first joint of sub-hierarchy [_begin,_end[ that doesn't have
+// exactly one child. Joints before this one form a chain that can't be split.
+// A joint whose parent isn't the previous joint is a sibling of its parent
+// first child, so this parent has more than one child. The range must contain
+// a single sub-hierarchy, rooted at _begin.
+int ChainEnd(span<const int16_t> _parents, int _begin, int _end) {
+  int chain_end = _end - 1;
+  for (int i = _begin + 2; i < _end; ++i) {
+    const int parent = _parents[i];
+    if (parent != i - 1 && parent < chain_end) {
+      chain_end = parent;
+    }
+  }
+  return math::Max(chain_end, _begin);
+}
+
+template <typename _Output>
+void Update(const LocalToModelJob& _job, const _Output& _output) {
+  const span<const int16_t>& parents = _job.skeleton->joint_parents();
+
+  // Initializes an identity matrix that will be used to compute roots model
+  // matrices without requiring a branch.
+  const math::Float4x4 identity = math::Float4x4::identity();
+  const math::Float4x4& root = (_job.root == nullptr) ? identity : *_job.root;
+
+  // Finds the range of joints to update. Update ends after "to", or when a
+  // joint isn't a child of "from" anymore. Begins iteration from "from", or
+  // the next joint if "from" is excluded.
+  const int end = math::Min(_job.to + 1, _job.skeleton->num_joints());
+  const int begin = math::Max(_job.from + _job.from_excluded, 0);
+  int last = begin;
+  if (_job.from == Skeleton::kNoParent) {
+    last = end;
+  } else if (last < end &&
+             (!_job.from_excluded || parents[last] >= _job.from)) {
+    // parents[last] >= from is true as long as "last" is a child of "from".
+    for (++last; last < end && parents[last] >= _job.from; ++last) {
+    }
+  }
+  if (last <= begin) {
+    return;
+  }
+
+  // Flags joints to update if a dirty set is provided: dirty joints and their
+  // descendants. Parents come before their children, whatever skeleton joint
+  // order, so flags are propagated in a single pass.
+  bool update_flags[Skeleton::kMaxJoints];
+  const bool* update = nullptr;
+  if (!_job.dirty.empty()) {
+    for (int i = 0; i < last; ++i) {
+      const int parent = parents[i];
+      update_flags[i] =
+          (_job.dirty[i / 8] & (1 << (i & 7))) != 0 ||
+          (parent != Skeleton::kNoParent && update_flags[parent]);
+    }
+    update = update_flags;
+  }
+
+  // Updates all joints on the calling thread if there's no scheduler.
+  // Splitting the hierarchy into sub-hierarchies requires joints to be ordered
+  // depth-first.
+  if (!_job.scheduler || _job.scheduler->num_workers() < 2 ||
+      last - begin <= _job.grain_size || !IsDepthFirst(parents)) {
+    UpdateRange(_job, _output, root, update, begin, last);
+    return;
+  }
+
+  // Splits the hierarchy into independent ranges of joints. The biggest range
+  // is split until there are enough ranges to feed all workers, or ranges are
+  // smaller than grain size. Splitting a range requires to update its root
+  // joint first, along with the chain of joints that have a single child.
+  const int max_tasks = math::Min(kMaxTasks, _job.scheduler->num_workers() * 4);
+  JointRange tasks[kMaxTasks];
+  int num_tasks = SplitSubHierarchies(parents, begin, last, max_tasks, tasks);
+  while (num_tasks < max_tasks) {
+    int biggest = 0;
+    for (int i = 1; i < num_tasks; ++i) {
+      if (tasks[i].end - tasks[i].begin >
+          tasks[biggest].end - tasks[biggest].begin) {
+        biggest = i;
+      }
+    }
+    const JointRange range = tasks[biggest];
+    if (range.end - range.begin <= _job.grain_size) {
+      break;
+    }
+    // Ranges can contain multiple sibling sub-hierarchies, merged by
+    // SplitSubHierarchies. Such ranges are split at their roots first, as
+    // joints of a sub-hierarchy only depend on their own root.
+    const int middle_root = MiddleRoot(parents, range.begin, range.end);
+    if (middle_root != range.begin) {
+      tasks[biggest].end = middle_root;
+      tasks[num_tasks++] = {middle_root, range.end};
+      continue;
+    }
+    const int chain_end = ChainEnd(parents, range.begin, range.end);
+    UpdateRange(_job, _output, root, update, range.begin, chain_end + 1);
+    tasks[biggest] = tasks[--num_tasks];
+    if (chain_end + 1 < range.end) {
+      num_tasks += SplitSubHierarchies(parents, chain_end + 1, range.end,
+                                       max_tasks - num_tasks,
+                                       tasks + num_tasks);
+    }
+    if (num_tasks == 0) {
+      return;
+    }
+  }
+
+#ifndef NDEBUG
+  // Ranges are updated concurrently, so they must not overlap.
+  bool assigned[Skeleton::kMaxJoints] = {};
+  for (int i = 0; i < num_tasks; ++i) {
+    for (int j = tasks[i].begin; j < tasks[i].end; ++j) {
+      assert(!assigned[j] && "Overlapping joint ranges");
+      assigned[j] = true;
+    }
+  }
+#endif  // NDEBUG
+
+  ParallelFor(_job.scheduler, num_tasks, 1, [&](int _begin, int _end, int) {
+    for (int i = _begin; i < _end; ++i) {
+      UpdateRange(_job, _output, root, update, tasks[i].begin, tasks[i].end);
+    }
+  });
+}
+}  // namespace
+
+bool LocalToModelJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  // Dispatches to the update loop specialized for job outputs.
+  if (output_affine.empty()) {
+    const MatrixOutput matrix_output = {output};
+    Update(*this, matrix_output);
+  } else if (output.empty()) {
+    const AffineOutput affine_output = {output_affine};
+    Update(*this, affine_output);
+  } else {
+    const MatrixAndAffineOutput both_output = {output, output_affine};
+    Update(*this, both_output);
+  }
   return true;
 }
 }  // namespace animation
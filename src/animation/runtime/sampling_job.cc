@@ -35,6 +35,7 @@
 #include "ozz/base/encode/group_varint.h"
 #include "ozz/base/maths/math_constant.h"
 #include "ozz/base/maths/math_ex.h"
+#include "ozz/base/maths/simd_float8.h"
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/memory/allocator.h"
 
@@ -54,6 +55,12 @@ struct InterpSoaQuaternion {
   math::SimdFloat4 ratio[2];
   math::SoaQuaternion value[2];
 };
+struct TangentSoaFloat3 {
+  math::SoaFloat3 value[2];
+};
+struct TangentSoaQuaternion {
+  math::SoaQuaternion value[2];
+};
 }  // namespace internal
 
 bool SamplingJob::Validate() const {
@@ -73,6 +80,14 @@ bool SamplingJob::Validate() const {
   // Tests context size.
   valid &= context->max_soa_tracks() >= num_soa_tracks;
 
+  // Tests constant flags size, one bit per sampled soa track.
+  const size_t num_soa_interp_tracks =
+      math::Min(output.size(), static_cast<size_t>(num_soa_tracks));
+  valid &=
+      constant.empty() || constant.size() >= (num_soa_interp_tracks + 7) / 8;
+  valid &=
+      changed.empty() || changed.size() >= (num_soa_interp_tracks + 7) / 8;
+
   return valid;
 }
 
@@ -273,15 +288,89 @@ void UpdateCache(float _ratio, float _previous_ratio, size_t _num_soa_tracks,
   _cache.next = next;
 }
 
+// Hermite tangents of a keyframes series, along with their soa hot
+// decompressed storage. Both are empty for linearly interpolated series.
+template <typename _CompressedTangent, typename _DecompressedTangent>
+struct Tangents {
+  ozz::span<const _CompressedTangent> compressed;
+  ozz::span<_DecompressedTangent> decompressed;
+};
+
+// Full precision keys don't need their soa track index.
+inline void DecompressFloat3(size_t, const internal::Float3Key& _k0,
+                             const internal::Float3Key& _k1,
+                             const internal::Float3Key& _k2,
+                             const internal::Float3Key& _k3,
+                             math::SoaFloat3* _soa_float3) {
+  _soa_float3->x = math::HalfToFloat(math::simd_int4::Load(
+      _k0.values[0], _k1.values[0], _k2.values[0], _k3.values[0]));
+  _soa_float3->y = math::HalfToFloat(math::simd_int4::Load(
+      _k0.values[1], _k1.values[1], _k2.values[1], _k3.values[1]));
+  _soa_float3->z = math::HalfToFloat(math::simd_int4::Load(
+      _k0.values[2], _k1.values[2], _k2.values[2], _k3.values[2]));
+}
+
+// Float3 tangents are stored as half floats, like full precision keys.
+inline void DecompressTangent(const internal::Float3Key& _k0,
+                              const internal::Float3Key& _k1,
+                              const internal::Float3Key& _k2,
+                              const internal::Float3Key& _k3,
+                              math::SoaFloat3* _soa_float3) {
+  DecompressFloat3(0, _k0, _k1, _k2, _k3, _soa_float3);
+}
+
+// Quaternion tangents are not unit length, so all 4 components are stored as
+// half floats.
+inline void DecompressTangent(const internal::Float4Key& _k0,
+                              const internal::Float4Key& _k1,
+                              const internal::Float4Key& _k2,
+                              const internal::Float4Key& _k3,
+                              math::SoaQuaternion* _quaternion) {
+  _quaternion->x = math::HalfToFloat(math::simd_int4::Load(
+      _k0.values[0], _k1.values[0], _k2.values[0], _k3.values[0]));
+  _quaternion->y = math::HalfToFloat(math::simd_int4::Load(
+      _k0.values[1], _k1.values[1], _k2.values[1], _k3.values[1]));
+  _quaternion->z = math::HalfToFloat(math::simd_int4::Load(
+      _k0.values[2], _k1.values[2], _k2.values[2], _k3.values[2]));
+  _quaternion->w = math::HalfToFloat(math::simd_int4::Load(
+      _k0.values[3], _k1.values[3], _k2.values[3], _k3.values[3]));
+}
+
+// Flags _soa_track as changed, if _changed bitset is big enough to store it.
+inline void FlagChanged(const ozz::span<byte>& _changed, size_t _soa_track) {
+  if (_soa_track / 8 < _changed.size()) {
+    _changed[_soa_track / 8] |= static_cast<byte>(1 << (_soa_track & 7));
+  }
+}
+
+inline math::SimdInt4 IsZero(const math::SoaFloat3& _v) {
+  return _v == math::SoaFloat3::zero();
+}
+
+inline math::SimdInt4 IsZero(const math::SoaQuaternion& _q) {
+  const math::SimdFloat4 zero = math::simd_float4::zero();
+  return _q == math::SoaQuaternion::Load(zero, zero, zero, zero);
+}
+
+// Decompresses outdated animated soa tracks. _num_soa_tracks is the number of
+// animated soa tracks, whose output index is found in _soa_tracks. _decompress
+// is given the index of the soa track in the keyframes series, so quantized
+// keys can find their range. Hermite tangents are decompressed alongside
+// values, if the series has some. Decompressed soa tracks are flagged in
+// _changed.
 template <typename _CompressedKey, typename _DecompressedKey,
-          typename _Decompress>
-inline void Decompress(size_t _num_soa_tracks,
-                       const ozz::span<const float>& _timepoints,
-                       const Animation::KeyframesCtrlConst& _ctrl,
-                       const ozz::span<const _CompressedKey>& _compressed,
-                       const SamplingJob::Context::Cache& _cache,
-                       const ozz::span<_DecompressedKey>& _decompressed,
-                       const _Decompress& _decompress) {
+          typename _Decompress, typename _CompressedTangent,
+          typename _DecompressedTangent>
+inline void Decompress(
+    size_t _num_soa_tracks, const ozz::span<const float>& _timepoints,
+    const Animation::KeyframesCtrlConst& _ctrl,
+    const ozz::span<const _CompressedKey>& _compressed,
+    const ozz::span<const uint16_t>& _soa_tracks,
+    const SamplingJob::Context::Cache& _cache,
+    const ozz::span<_DecompressedKey>& _decompressed,
+    const _Decompress& _decompress,
+    const Tangents<_CompressedTangent, _DecompressedTangent>& _tangents,
+    const ozz::span<byte>& _changed) {
   const size_t num_outdated_flags = (_num_soa_tracks + 7) / 8;
   for (size_t j = 0; j < num_outdated_flags; ++j) {
     byte outdated = _cache.outdated[j];  // Copy outdated flag
@@ -293,6 +382,9 @@ inline void Decompress(size_t _num_soa_tracks,
 
       // Get cache sub part matching this outdated soa entry.
       const auto& rights = _cache.entries.subspan(i * 4, 4);
+      const size_t soa_track = _soa_tracks[i];
+      _DecompressedKey& decompressed = _decompressed[soa_track];
+      FlagChanged(_changed, soa_track);
 
       // Left side keys can be found from right ones as we know the offset from
       // right to left (_previouses).
@@ -306,39 +398,210 @@ inline void Decompress(size_t _num_soa_tracks,
       const _CompressedKey& k10 = _compressed[lefts[1]];
       const _CompressedKey& k20 = _compressed[lefts[2]];
       const _CompressedKey& k30 = _compressed[lefts[3]];
-      _decompressed[i].ratio[0] = KeysRatio(_timepoints, _ctrl.ratios, lefts);
-      _decompress(k00, k10, k20, k30, &_decompressed[i].value[0]);
+      decompressed.ratio[0] = KeysRatio(_timepoints, _ctrl.ratios, lefts);
+      _decompress(i, k00, k10, k20, k30, &decompressed.value[0]);
 
       // Decompress right side keyframes and store them in soa structures.
       const _CompressedKey& k01 = _compressed[rights[0]];
       const _CompressedKey& k11 = _compressed[rights[1]];
       const _CompressedKey& k21 = _compressed[rights[2]];
       const _CompressedKey& k31 = _compressed[rights[3]];
-      _decompressed[i].ratio[1] = KeysRatio(_timepoints, _ctrl.ratios, rights);
-      _decompress(k01, k11, k21, k31, &_decompressed[i].value[1]);
+      decompressed.ratio[1] = KeysRatio(_timepoints, _ctrl.ratios, rights);
+      _decompress(i, k01, k11, k21, k31, &decompressed.value[1]);
+
+      // Decompress tangents, of left and right keys.
+      bool flat = true;
+      if (!_tangents.compressed.empty()) {
+        _DecompressedTangent& tangent = _tangents.decompressed[soa_track];
+        DecompressTangent(
+            _tangents.compressed[lefts[0]], _tangents.compressed[lefts[1]],
+            _tangents.compressed[lefts[2]], _tangents.compressed[lefts[3]],
+            &tangent.value[0]);
+        DecompressTangent(
+            _tangents.compressed[rights[0]], _tangents.compressed[rights[1]],
+            _tangents.compressed[rights[2]], _tangents.compressed[rights[3]],
+            &tangent.value[1]);
+        flat = math::AreAllTrue(
+            math::And(IsZero(tangent.value[0]), IsZero(tangent.value[1])));
+      }
+
+      // Flags soa entries whose value is constant over the key interval.
+      const byte mask = static_cast<byte>(1 << (soa_track & 7));
+      if (flat &&
+          math::AreAllTrue(decompressed.value[0] == decompressed.value[1])) {
+        _cache.constant[soa_track / 8] |= mask;
+      } else {
+        _cache.constant[soa_track / 8] &= ~mask;
+      }
     }
   }
 }
 
-inline void DecompressFloat3(const internal::Float3Key& _k0,
-                             const internal::Float3Key& _k1,
-                             const internal::Float3Key& _k2,
-                             const internal::Float3Key& _k3,
-                             math::SoaFloat3* _soa_float3) {
-  _soa_float3->x = math::HalfToFloat(math::simd_int4::Load(
-      _k0.values[0], _k1.values[0], _k2.values[0], _k3.values[0]));
-  _soa_float3->y = math::HalfToFloat(math::simd_int4::Load(
-      _k0.values[1], _k1.values[1], _k2.values[1], _k3.values[1]));
-  _soa_float3->z = math::HalfToFloat(math::simd_int4::Load(
-      _k0.values[2], _k1.values[2], _k2.values[2], _k3.values[2]));
+// Decompresses constant soa tracks. Their left and right keys are the same,
+// which makes them independent of the sampling ratio. Their tangents are zero
+// if the transformation type is hermite interpolated. They are all flagged in
+// _changed.
+template <typename _CompressedKey, typename _DecompressedKey,
+          typename _Decompress, typename _CompressedTangent,
+          typename _DecompressedTangent>
+inline void DecompressConstants(
+    const ozz::span<const _CompressedKey>& _constants,
+    const ozz::span<const uint16_t>& _soa_tracks,
+    const SamplingJob::Context::Cache& _cache,
+    const ozz::span<_DecompressedKey>& _decompressed,
+    const _Decompress& _decompress,
+    const Tangents<_CompressedTangent, _DecompressedTangent>& _tangents,
+    const ozz::span<byte>& _changed) {
+  assert(_constants.size() == _soa_tracks.size() * 4);
+  for (size_t i = 0; i < _soa_tracks.size(); ++i) {
+    const size_t soa_track = _soa_tracks[i];
+    _DecompressedKey& decompressed = _decompressed[soa_track];
+    FlagChanged(_changed, soa_track);
+    decompressed.ratio[0] = math::simd_float4::zero();
+    decompressed.ratio[1] = math::simd_float4::one();
+    _decompress(i, _constants[i * 4 + 0], _constants[i * 4 + 1],
+                _constants[i * 4 + 2], _constants[i * 4 + 3],
+                &decompressed.value[0]);
+    decompressed.value[1] = decompressed.value[0];
+    if (!_tangents.compressed.empty()) {
+      _DecompressedTangent& tangent = _tangents.decompressed[soa_track];
+      tangent.value[0] = tangent.value[1] =
+          decompressed.value[0] * math::simd_float4::zero();
+    }
+    _cache.constant[soa_track / 8] |= static_cast<byte>(1 << (soa_track & 7));
+  }
+}
+
+// Samples one keyframes series (full precision or quantized) of a
+// transformation type. Its animated soa tracks are updated according to the
+// cache.
+template <typename _CompressedKey, typename _DecompressedKey,
+          typename _Decompress, typename _CompressedTangent,
+          typename _DecompressedTangent>
+inline void Sample(
+    float _ratio, float _previous_ratio,
+    const ozz::span<const float>& _timepoints,
+    const Animation::KeyframesCtrlConst& _ctrl,
+    const ozz::span<const _CompressedKey>& _compressed,
+    const ozz::span<const uint16_t>& _soa_tracks,
+    SamplingJob::Context::Cache& _cache,
+    const ozz::span<_DecompressedKey>& _decompressed,
+    const _Decompress& _decompress,
+    const Tangents<_CompressedTangent, _DecompressedTangent>& _tangents,
+    const ozz::span<byte>& _changed) {
+  if (_soa_tracks.empty()) {
+    return;
+  }
+
+  // Update cache with animation keyframe indexes for t = ratio.
+  // Decompresses outdated soa hot values.
+  UpdateCache(_ratio, _previous_ratio, _soa_tracks.size(), _timepoints, _ctrl,
+              _cache);
+  Decompress(_soa_tracks.size(), _timepoints, _ctrl, _compressed, _soa_tracks,
+             _cache, _decompressed, _decompress, _tangents, _changed);
 }
 
+// Splits soa tracks remapping of a transformation type, according to the
+// keyframes series they're stored in.
+struct SoaTracks {
+  ozz::span<const uint16_t> animated;
+  ozz::span<const uint16_t> quantized;
+  ozz::span<const uint16_t> constants;
+};
+
+inline SoaTracks SplitSoaTracks(const ozz::span<const uint16_t>& _soa_tracks,
+                                size_t _num_quantized, size_t _num_constants) {
+  assert(_soa_tracks.size() >= _num_quantized + _num_constants);
+  const size_t num_animated =
+      _soa_tracks.size() - _num_quantized - _num_constants;
+  return {_soa_tracks.first(num_animated),
+          _soa_tracks.subspan(num_animated, _num_quantized),
+          _soa_tracks.last(_num_constants)};
+}
+
+// Decompresses quantized float3 keys, which are normalized in their soa track
+// range.
+struct DecompressQuantizedFloat3 {
+  void operator()(size_t _soa_track, const internal::QuantizedFloat3Key& _k0,
+                  const internal::QuantizedFloat3Key& _k1,
+                  const internal::QuantizedFloat3Key& _k2,
+                  const internal::QuantizedFloat3Key& _k3,
+                  math::SoaFloat3* _soa_float3) const {
+    const internal::QuantizationRange& range = ranges[_soa_track];
+    _soa_float3->x =
+        math::simd_float4::LoadPtrU(range.min[0]) +
+        math::simd_float4::LoadPtrU(range.scale[0]) *
+            math::simd_float4::FromInt(math::simd_int4::Load(
+                _k0.values[0], _k1.values[0], _k2.values[0], _k3.values[0]));
+    _soa_float3->y =
+        math::simd_float4::LoadPtrU(range.min[1]) +
+        math::simd_float4::LoadPtrU(range.scale[1]) *
+            math::simd_float4::FromInt(math::simd_int4::Load(
+                _k0.values[1], _k1.values[1], _k2.values[1], _k3.values[1]));
+    _soa_float3->z =
+        math::simd_float4::LoadPtrU(range.min[2]) +
+        math::simd_float4::LoadPtrU(range.scale[2]) *
+            math::simd_float4::FromInt(math::simd_int4::Load(
+                _k0.values[2], _k1.values[2], _k2.values[2], _k3.values[2]));
+  }
+
+  ozz::span<const internal::QuantizationRange> ranges;
+};
+
 // Defines a mapping table that defines components assignation in the output
 // quaternion.
 static constexpr uint8_t kCpntMapping[4][4] = {
     {0, 0, 1, 2}, {0, 0, 1, 2}, {0, 1, 0, 2}, {0, 1, 2, 0}};
 
-inline void DecompressQuaternion(const internal::QuaternionKey& _k0,
+// Restores the largest component of 4 quaternions from the 3 smallest ones,
+// which _cpnt already stores in their output component. Largest components of
+// _cpnt are ignored.
+inline void RestoreLargest(math::SimdFloat4 _cpnt[4], const int _largests[4],
+                           const int _signs[4],
+                           math::SoaQuaternion* _quaternion) {
+  // Zeroed largest components so they're not part of the dot.
+  const math::SimdInt4 mask_f000 = math::simd_int4::mask_f000();
+  const math::SimdInt4 mask_0f00 = math::simd_int4::mask_0f00();
+  const math::SimdInt4 mask_00f0 = math::simd_int4::mask_00f0();
+  const math::SimdInt4 mask_000f = math::simd_int4::mask_000f();
+  _cpnt[_largests[0]] = math::AndNot(_cpnt[_largests[0]], mask_f000);
+  _cpnt[_largests[1]] = math::AndNot(_cpnt[_largests[1]], mask_0f00);
+  _cpnt[_largests[2]] = math::AndNot(_cpnt[_largests[2]], mask_00f0);
+  _cpnt[_largests[3]] = math::AndNot(_cpnt[_largests[3]], mask_000f);
+
+  // Get back length of 4th component. Favors performance over accuracy by using
+  // x * RSqrtEst(x) instead of Sqrt(x).
+  // ww0 cannot be 0 because we 're recomputing the largest component.
+  const math::SimdFloat4 dot = _cpnt[0] * _cpnt[0] + _cpnt[1] * _cpnt[1] +
+                               _cpnt[2] * _cpnt[2] + _cpnt[3] * _cpnt[3];
+  // dot cannot be >= 1, because it does not include the largest component.
+  const math::SimdFloat4 ww0 = math::simd_float4::one() - dot;
+  const math::SimdFloat4 w0 = ww0 * math::RSqrtEst(ww0);
+
+  // Re-applies 4th component's sign.
+  const math::SimdInt4 sign = math::ShiftL(
+      math::simd_int4::Load(_signs[0], _signs[1], _signs[2], _signs[3]), 31);
+  const math::SimdFloat4 restored = math::Or(w0, sign);
+
+  // Re-injects the largest component inside the SoA structure.
+  // Note that largest component is already 0.
+  _cpnt[_largests[0]] =
+      math::Or(_cpnt[_largests[0]], math::And(restored, mask_f000));
+  _cpnt[_largests[1]] =
+      math::Or(_cpnt[_largests[1]], math::And(restored, mask_0f00));
+  _cpnt[_largests[2]] =
+      math::Or(_cpnt[_largests[2]], math::And(restored, mask_00f0));
+  _cpnt[_largests[3]] =
+      math::Or(_cpnt[_largests[3]], math::And(restored, mask_000f));
+
+  // Stores result.
+  _quaternion->x = _cpnt[0];
+  _quaternion->y = _cpnt[1];
+  _quaternion->z = _cpnt[2];
+  _quaternion->w = _cpnt[3];
+}
+
+inline void DecompressQuaternion(size_t, const internal::QuaternionKey& _k0,
                                  const internal::QuaternionKey& _k1,
                                  const internal::QuaternionKey& _k2,
                                  const internal::QuaternionKey& _k3,
@@ -382,55 +645,160 @@ inline void DecompressQuaternion(const internal::QuaternionKey& _k0,
                    math::simd_int4::LoadPtr(cmp_keys[3])) +
           kOffset};
 
-  // Zeroed largest components so they're not part of the dot.
-  const math::SimdInt4 mask_f000 = math::simd_int4::mask_f000();
-  const math::SimdInt4 mask_0f00 = math::simd_int4::mask_0f00();
-  const math::SimdInt4 mask_00f0 = math::simd_int4::mask_00f0();
-  const math::SimdInt4 mask_000f = math::simd_int4::mask_000f();
-  cpnt[largests[0]] = math::AndNot(cpnt[largests[0]], mask_f000);
-  cpnt[largests[1]] = math::AndNot(cpnt[largests[1]], mask_0f00);
-  cpnt[largests[2]] = math::AndNot(cpnt[largests[2]], mask_00f0);
-  cpnt[largests[3]] = math::AndNot(cpnt[largests[3]], mask_000f);
 
-  // Get back length of 4th component. Favors performance over accuracy by using
-  // x * RSqrtEst(x) instead of Sqrt(x).
-  // ww0 cannot be 0 because we 're recomputing the largest component.
-  const math::SimdFloat4 dot = cpnt[0] * cpnt[0] + cpnt[1] * cpnt[1] +
-                               cpnt[2] * cpnt[2] + cpnt[3] * cpnt[3];
-  // dot cannot be >= 1, because it does not include the largest component.
-  const math::SimdFloat4 ww0 = math::simd_float4::one() - dot;
-  const math::SimdFloat4 w0 = ww0 * math::RSqrtEst(ww0);
+  RestoreLargest(cpnt, largests, signs, _quaternion);
+}
 
-  // Re-applies 4th component's sign.
-  const math::SimdInt4 sign = math::ShiftL(
-      math::simd_int4::Load(signs[0], signs[1], signs[2], signs[3]), 31);
-  const math::SimdFloat4 restored = math::Or(w0, sign);
+// Decompresses quantized quaternion keys, whose 3 smallest components are
+// normalized in their soa track range.
+struct DecompressQuantizedQuaternion {
+  void operator()(size_t _soa_track,
+                  const internal::QuantizedQuaternionKey& _k0,
+                  const internal::QuantizedQuaternionKey& _k1,
+                  const internal::QuantizedQuaternionKey& _k2,
+                  const internal::QuantizedQuaternionKey& _k3,
+                  math::SoaQuaternion* _quaternion) const {
+    int largests[4], signs[4], values[4][3];
+    internal::unpack(_k0, largests[0], signs[0], values[0]);
+    internal::unpack(_k1, largests[1], signs[1], values[1]);
+    internal::unpack(_k2, largests[2], signs[2], values[2]);
+    internal::unpack(_k3, largests[3], signs[3], values[3]);
+
+    // Dequantizes the 3 smallest components of the 4 keys, using soa track
+    // range.
+    const internal::QuantizationRange& range = ranges[_soa_track];
+    alignas(16) float smallests[3][4];
+    for (int i = 0; i < 3; ++i) {
+      math::StorePtr(
+          math::simd_float4::LoadPtrU(range.min[i]) +
+              math::simd_float4::LoadPtrU(range.scale[i]) *
+                  math::simd_float4::FromInt(math::simd_int4::Load(
+                      values[0][i], values[1][i], values[2][i], values[3][i])),
+          smallests[i]);
+    }
 
-  // Re-injects the largest component inside the SoA structure.
-  // Note that largest component is already 0.
-  cpnt[largests[0]] =
-      math::Or(cpnt[largests[0]], math::And(restored, mask_f000));
-  cpnt[largests[1]] =
-      math::Or(cpnt[largests[1]], math::And(restored, mask_0f00));
-  cpnt[largests[2]] =
-      math::Or(cpnt[largests[2]], math::And(restored, mask_00f0));
-  cpnt[largests[3]] =
-      math::Or(cpnt[largests[3]], math::And(restored, mask_000f));
+    // Selects proper mapping for each key.
+    const uint8_t* m0 = kCpntMapping[largests[0]];
+    const uint8_t* m1 = kCpntMapping[largests[1]];
+    const uint8_t* m2 = kCpntMapping[largests[2]];
+    const uint8_t* m3 = kCpntMapping[largests[3]];
+
+    // Prepares an array of input values, according to the mapping required to
+    // restore quaternion largest component.
+    alignas(16) float cmp_keys[4][4] = {
+        {smallests[m0[0]][0], smallests[m1[0]][1], smallests[m2[0]][2],
+         smallests[m3[0]][3]},
+        {smallests[m0[1]][0], smallests[m1[1]][1], smallests[m2[1]][2],
+         smallests[m3[1]][3]},
+        {smallests[m0[2]][0], smallests[m1[2]][1], smallests[m2[2]][2],
+         smallests[m3[2]][3]},
+        {smallests[m0[3]][0], smallests[m1[3]][1], smallests[m2[3]][2],
+         smallests[m3[3]][3]},
+    };
+    math::SimdFloat4 cpnt[4] = {math::simd_float4::LoadPtr(cmp_keys[0]),
+                                math::simd_float4::LoadPtr(cmp_keys[1]),
+                                math::simd_float4::LoadPtr(cmp_keys[2]),
+                                math::simd_float4::LoadPtr(cmp_keys[3])};
+
+    RestoreLargest(cpnt, largests, signs, _quaternion);
+  }
 
-  // Stores result.
-  _quaternion->x = cpnt[0];
-  _quaternion->y = cpnt[1];
-  _quaternion->z = cpnt[2];
-  _quaternion->w = cpnt[3];
+  ozz::span<const internal::QuantizationRange> ranges;
+};
+
+// Computes cubic hermite interpolation of soa values. Tangents are derivatives
+// over the animation ratio, hence scaled by the ratio _interval between the
+// keys. _alpha is the interpolation coefficient in range [0,1].
+template <typename _Value>
+inline _Value Hermite(const _Value& _v0, const _Value& _v1, const _Value& _t0,
+                      const _Value& _t1, math::_SimdFloat4 _interval,
+                      math::_SimdFloat4 _alpha) {
+  const math::SimdFloat4 alpha2 = _alpha * _alpha;
+  const math::SimdFloat4 alpha3 = alpha2 * _alpha;
+  const math::SimdFloat4 h01 =
+      math::simd_float4::Load1(3.f) * alpha2 - alpha3 - alpha3;
+  const math::SimdFloat4 h00 = math::simd_float4::one() - h01;
+  const math::SimdFloat4 h11 = alpha3 - alpha2;
+  const math::SimdFloat4 h10 = h11 - alpha2 + _alpha;
+  return _v0 * h00 + _v1 * h01 + (_t0 * h10 + _t1 * h11) * _interval;
 }
 
-void Interpolates(float _anim_ratio, size_t _num_soa_tracks,
-                  const span<const internal::InterpSoaFloat3>& _translations,
-                  const span<const internal::InterpSoaQuaternion>& _rotations,
-                  const span<const internal::InterpSoaFloat3>& _scales,
-                  const span<math::SoaTransform>& _output) {
+#if defined(OZZ_SIMD_AVX2) || defined(OZZ_SIMD_AVX2_DISPATCH)
+// Interpolates pairs of linearly interpolated soa tracks at once, using 8 lanes
+// registers. Returns the number of interpolated soa tracks, the remaining one
+// (if _num_soa_tracks is odd) is left to the 4 lanes loop.
+OZZ_SIMD_AVX2_TARGET size_t
+Interpolates8(float _anim_ratio, size_t _num_soa_tracks,
+              const span<const internal::InterpSoaFloat3>& _translations,
+              const span<const internal::InterpSoaQuaternion>& _rotations,
+              const span<const internal::InterpSoaFloat3>& _scales,
+              const span<math::SoaTransform>& _output) {
+  size_t i = 0;
+  const math::SimdFloat8 anim_ratio8 = math::simd_float8::Load1(_anim_ratio);
+  for (; i + 2 <= _num_soa_tracks; i += 2) {
+    const internal::InterpSoaFloat3* t = &_translations[i];
+    const math::SimdFloat8 t_ratio0 =
+        math::simd_float8::Load(t[0].ratio[0], t[1].ratio[0]);
+    const math::SimdFloat8 t_ratio =
+        (anim_ratio8 - t_ratio0) *
+        math::RcpEst(math::simd_float8::Load(t[0].ratio[1], t[1].ratio[1]) -
+                     t_ratio0);
+    math::Lerp(math::Soa8Float3::Load(t[0].value[0], t[1].value[0]),
+               math::Soa8Float3::Load(t[0].value[1], t[1].value[1]), t_ratio)
+        .Store(&_output[i].translation, &_output[i + 1].translation);
+
+    const internal::InterpSoaQuaternion* r = &_rotations[i];
+    const math::SimdFloat8 r_ratio0 =
+        math::simd_float8::Load(r[0].ratio[0], r[1].ratio[0]);
+    const math::SimdFloat8 r_ratio =
+        (anim_ratio8 - r_ratio0) *
+        math::RcpEst(math::simd_float8::Load(r[0].ratio[1], r[1].ratio[1]) -
+                     r_ratio0);
+    math::NLerpEst(math::Soa8Quaternion::Load(r[0].value[0], r[1].value[0]),
+                   math::Soa8Quaternion::Load(r[0].value[1], r[1].value[1]),
+                   r_ratio)
+        .Store(&_output[i].rotation, &_output[i + 1].rotation);
+
+    const internal::InterpSoaFloat3* s = &_scales[i];
+    const math::SimdFloat8 s_ratio0 =
+        math::simd_float8::Load(s[0].ratio[0], s[1].ratio[0]);
+    const math::SimdFloat8 s_ratio =
+        (anim_ratio8 - s_ratio0) *
+        math::RcpEst(math::simd_float8::Load(s[0].ratio[1], s[1].ratio[1]) -
+                     s_ratio0);
+    math::Lerp(math::Soa8Float3::Load(s[0].value[0], s[1].value[0]),
+               math::Soa8Float3::Load(s[0].value[1], s[1].value[1]), s_ratio)
+        .Store(&_output[i].scale, &_output[i + 1].scale);
+  }
+  return i;
+}
+#endif  // OZZ_SIMD_AVX2 || OZZ_SIMD_AVX2_DISPATCH
+
+// Interpolates soa hot data. Tangents spans are empty for transformation types
+// that are linearly interpolated.
+void Interpolates(
+    float _anim_ratio, size_t _num_soa_tracks,
+    const span<const internal::InterpSoaFloat3>& _translations,
+    const span<const internal::InterpSoaQuaternion>& _rotations,
+    const span<const internal::InterpSoaFloat3>& _scales,
+    const span<const internal::TangentSoaFloat3>& _translations_tangents,
+    const span<const internal::TangentSoaQuaternion>& _rotations_tangents,
+    const span<const internal::TangentSoaFloat3>& _scales_tangents,
+    const span<math::SoaTransform>& _output) {
+  size_t i = 0;
+#if defined(OZZ_SIMD_AVX2) || defined(OZZ_SIMD_AVX2_DISPATCH)
+  // Interpolates pairs of soa tracks at once using 8 lanes registers, when all
+  // transformations are linearly interpolated and the CPU supports AVX2.
+  // Remaining tracks are processed by the 4 lanes loop below.
+  if (_translations_tangents.empty() && _rotations_tangents.empty() &&
+      _scales_tangents.empty() && math::SupportsAvx2()) {
+    i = Interpolates8(_anim_ratio, _num_soa_tracks, _translations, _rotations,
+                      _scales, _output);
+  }
+#endif  // OZZ_SIMD_AVX2 || OZZ_SIMD_AVX2_DISPATCH
+
   const math::SimdFloat4 anim_ratio = math::simd_float4::Load1(_anim_ratio);
-  for (size_t i = 0; i < _num_soa_tracks; ++i) {
+  for (; i < _num_soa_tracks; ++i) {
     // Prepares interpolation coefficients.
     const internal::InterpSoaFloat3& t = _translations[i];
     const math::SimdFloat4 t_ratio =
@@ -445,10 +813,31 @@ void Interpolates(float _anim_ratio, size_t _num_soa_tracks,
     // Processes interpolations.
     // The lerp of the rotation uses the shortest path, because opposed
     // quaternions were negated during animation build stage (see
-    // AnimationBuilder).
-    _output[i].translation = Lerp(t.value[0], t.value[1], t_ratio);
-    _output[i].rotation = NLerpEst(r.value[0], r.value[1], r_ratio);
-    _output[i].scale = Lerp(s.value[0], s.value[1], s_ratio);
+    // AnimationBuilder). Hermite rotations are interpolated per component,
+    // then normalized.
+    if (_translations_tangents.empty()) {
+      _output[i].translation = Lerp(t.value[0], t.value[1], t_ratio);
+    } else {
+      const internal::TangentSoaFloat3& tt = _translations_tangents[i];
+      _output[i].translation = Hermite(t.value[0], t.value[1], tt.value[0],
+                                       tt.value[1], t.ratio[1] - t.ratio[0],
+                                       t_ratio);
+    }
+    if (_rotations_tangents.empty()) {
+      _output[i].rotation = NLerpEst(r.value[0], r.value[1], r_ratio);
+    } else {
+      const internal::TangentSoaQuaternion& rt = _rotations_tangents[i];
+      _output[i].rotation = NormalizeEst(
+          Hermite(r.value[0], r.value[1], rt.value[0], rt.value[1],
+                  r.ratio[1] - r.ratio[0], r_ratio));
+    }
+    if (_scales_tangents.empty()) {
+      _output[i].scale = Lerp(s.value[0], s.value[1], s_ratio);
+    } else {
+      const internal::TangentSoaFloat3& st = _scales_tangents[i];
+      _output[i].scale = Hermite(s.value[0], s.value[1], st.value[0],
+                                 st.value[1], s.ratio[1] - s.ratio[0], s_ratio);
+    }
   }
 }
 }  // namespace
@@ -471,46 +860,128 @@ bool SamplingJob::Run() const {
   // Clamps ratio in range [0,duration].
   const float clamped_ratio = math::Clamp(0.f, ratio, 1.f);
 
-  // Step the context to this potentially new animation and ratio.
+  // Only interp as much as we have output for.
+  const size_t num_soa_interp_tracks = math::Min(output.size(), num_soa_tracks);
+  const size_t num_flags = (num_soa_interp_tracks + 7) / 8;
+
+  // Changed flags are set while decompressing soa tracks.
+  const span<byte> changed_flags =
+      changed.empty() ? changed : changed.first(num_flags);
+  std::fill(changed_flags.begin(), changed_flags.end(), 0);
+
+  // Step the context to this potentially new animation and ratio. Constant
+  // soa tracks only need to be decompressed when the context is bound to a new
+  // animation.
+  const bool rebound = context->animation_ != animation;
   const float previous_ratio = context->Step(*animation, clamped_ratio);
 
-  // Update cache with animation keyframe indexes for t = ratio.
-  // Decompresses outdated soa hot values.
+  using TangentsFloat3 =
+      Tangents<internal::Float3Key, internal::TangentSoaFloat3>;
+  using TangentsQuaternion =
+      Tangents<internal::Float4Key, internal::TangentSoaQuaternion>;
 
   // Translations
-  const Animation::KeyframesCtrlConst& translations_ctrl =
-      animation->translations_ctrl();
-  UpdateCache(clamped_ratio, previous_ratio, num_soa_tracks,
-              animation->timepoints(), translations_ctrl,
-              context->translations_cache_);
-  Decompress(num_soa_tracks, animation->timepoints(), translations_ctrl,
-             animation->translations_values(), context->translations_cache_,
-             context->translations_, &DecompressFloat3);
+  const TangentsFloat3 t_tangents = {animation->translations_tangents(),
+                                     context->translations_tangents_};
+  const SoaTracks t_soa_tracks =
+      SplitSoaTracks(animation->translations_soa_tracks(),
+                     animation->translations_ranges().size(),
+                     animation->translations_constants().size() / 4);
+  if (rebound) {
+    DecompressConstants(animation->translations_constants(),
+                        t_soa_tracks.constants, context->translations_cache_,
+                        context->translations_, &DecompressFloat3,
+                        t_tangents, changed_flags);
+  }
+  Sample(clamped_ratio, previous_ratio, animation->timepoints(),
+         animation->translations_ctrl(), animation->translations_values(),
+         t_soa_tracks.animated, context->translations_cache_,
+         context->translations_, &DecompressFloat3, t_tangents, changed_flags);
+  Sample(clamped_ratio, previous_ratio, animation->timepoints(),
+         animation->translations_quantized_ctrl(),
+         animation->translations_quantized_values(), t_soa_tracks.quantized,
+         context->translations_quantized_cache_, context->translations_,
+         DecompressQuantizedFloat3{animation->translations_ranges()},
+         TangentsFloat3{}, changed_flags);
 
   // Rotations
-  const Animation::KeyframesCtrlConst& rotations_ctrl =
-      animation->rotations_ctrl();
-  UpdateCache(clamped_ratio, previous_ratio, num_soa_tracks,
-              animation->timepoints(), rotations_ctrl,
-              context->rotations_cache_);
-  Decompress(num_soa_tracks, animation->timepoints(), rotations_ctrl,
-             animation->rotations_values(), context->rotations_cache_,
-             context->rotations_, &DecompressQuaternion);
+  const TangentsQuaternion r_tangents = {animation->rotations_tangents(),
+                                         context->rotations_tangents_};
+  const SoaTracks r_soa_tracks =
+      SplitSoaTracks(animation->rotations_soa_tracks(),
+                     animation->rotations_ranges().size(),
+                     animation->rotations_constants().size() / 4);
+  if (rebound) {
+    DecompressConstants(animation->rotations_constants(),
+                        r_soa_tracks.constants, context->rotations_cache_,
+                        context->rotations_, &DecompressQuaternion,
+                        r_tangents, changed_flags);
+  }
+  Sample(clamped_ratio, previous_ratio, animation->timepoints(),
+         animation->rotations_ctrl(), animation->rotations_values(),
+         r_soa_tracks.animated, context->rotations_cache_, context->rotations_,
+         &DecompressQuaternion, r_tangents, changed_flags);
+  Sample(clamped_ratio, previous_ratio, animation->timepoints(),
+         animation->rotations_quantized_ctrl(),
+         animation->rotations_quantized_values(), r_soa_tracks.quantized,
+         context->rotations_quantized_cache_, context->rotations_,
+         DecompressQuantizedQuaternion{animation->rotations_ranges()},
+         TangentsQuaternion{}, changed_flags);
 
   // Scales
-  const Animation::KeyframesCtrlConst& scales_ctrl = animation->scales_ctrl();
-  UpdateCache(clamped_ratio, previous_ratio, num_soa_tracks,
-              animation->timepoints(), scales_ctrl, context->scales_cache_);
-  Decompress(num_soa_tracks, animation->timepoints(), scales_ctrl,
-             animation->scales_values(), context->scales_cache_,
-             context->scales_, &DecompressFloat3);
-
-  // Only interp as much as we have output for.
-  const size_t num_soa_interp_tracks = math::Min(output.size(), num_soa_tracks);
-
-  // Interpolates soa hot data.
-  Interpolates(clamped_ratio, num_soa_interp_tracks, context->translations_,
-               context->rotations_, context->scales_, output);
+  const TangentsFloat3 s_tangents = {animation->scales_tangents(),
+                                     context->scales_tangents_};
+  const SoaTracks s_soa_tracks =
+      SplitSoaTracks(animation->scales_soa_tracks(),
+                     animation->scales_ranges().size(),
+                     animation->scales_constants().size() / 4);
+  if (rebound) {
+    DecompressConstants(animation->scales_constants(), s_soa_tracks.constants,
+                        context->scales_cache_, context->scales_,
+                        &DecompressFloat3, s_tangents, changed_flags);
+  }
+  Sample(clamped_ratio, previous_ratio, animation->timepoints(),
+         animation->scales_ctrl(), animation->scales_values(),
+         s_soa_tracks.animated, context->scales_cache_, context->scales_,
+         &DecompressFloat3, s_tangents, changed_flags);
+  Sample(clamped_ratio, previous_ratio, animation->timepoints(),
+         animation->scales_quantized_ctrl(),
+         animation->scales_quantized_values(), s_soa_tracks.quantized,
+         context->scales_quantized_cache_, context->scales_,
+         DecompressQuantizedFloat3{animation->scales_ranges()},
+         TangentsFloat3{}, changed_flags);
+
+  // Interpolates soa hot data, using tangents of hermite transformation types
+  // only.
+  Interpolates(
+      clamped_ratio, num_soa_interp_tracks, context->translations_,
+      context->rotations_, context->scales_,
+      t_tangents.compressed.empty() ? span<internal::TangentSoaFloat3>()
+                                    : t_tangents.decompressed,
+      r_tangents.compressed.empty() ? span<internal::TangentSoaQuaternion>()
+                                    : r_tangents.decompressed,
+      s_tangents.compressed.empty() ? span<internal::TangentSoaFloat3>()
+                                    : s_tangents.decompressed,
+      output);
+
+  // Outputs soa tracks that are constant for all channels, and the ones that
+  // changed since the previous run. Non constant soa tracks always change.
+  if (num_flags != 0 && (!constant.empty() || !changed.empty())) {
+    const byte last_mask =
+        static_cast<byte>(0xff >> (num_flags * 8 - num_soa_interp_tracks));
+    for (size_t i = 0; i < num_flags; ++i) {
+      const byte mask = i == num_flags - 1 ? last_mask : byte(0xff);
+      const byte constants = context->translations_cache_.constant[i] &
+                             context->rotations_cache_.constant[i] &
+                             context->scales_cache_.constant[i] & mask;
+      if (!constant.empty()) {
+        constant[i] = constants;
+      }
+      if (!changed.empty()) {
+        changed[i] = (changed[i] | ~constants) & mask;
+      }
+    }
+  }
 
   return true;
 }
@@ -531,6 +1002,8 @@ void SamplingJob::Context::Deallocate() {
 void SamplingJob::Context::Resize(int _max_tracks) {
   using internal::InterpSoaFloat3;
   using internal::InterpSoaQuaternion;
+  using internal::TangentSoaFloat3;
+  using internal::TangentSoaQuaternion;
 
   // Reset existing data.
   Invalidate();
@@ -552,8 +1025,12 @@ void SamplingJob::Context::Resize(int _max_tracks) {
       sizeof(InterpSoaFloat3) * max_soa_tracks +
       sizeof(InterpSoaQuaternion) * max_soa_tracks +
       sizeof(InterpSoaFloat3) * max_soa_tracks +
-      sizeof(uint32_t) * max_tracks * 3 +  // trans + rot + scale.
-      sizeof(uint8_t) * 3 * num_outdated;
+      sizeof(TangentSoaFloat3) * max_soa_tracks +
+      sizeof(TangentSoaQuaternion) * max_soa_tracks +
+      sizeof(TangentSoaFloat3) * max_soa_tracks +
+      sizeof(uint32_t) * max_tracks * 6 +   // (trans + rot + scale) * 2.
+      sizeof(uint8_t) * 6 * num_outdated +  // outdated flags.
+      sizeof(uint8_t) * 3 * num_outdated;   // constant flags.
 
   // Allocates all at once.
   auto* allocator = memory::default_allocator();
@@ -564,21 +1041,42 @@ void SamplingJob::Context::Resize(int _max_tracks) {
   // alignment values first).
   static_assert(alignof(InterpSoaFloat3) >= alignof(InterpSoaQuaternion) &&
                     alignof(InterpSoaQuaternion) >= alignof(InterpSoaFloat3) &&
-                    alignof(InterpSoaFloat3) >= alignof(uint32_t) &&
+                    alignof(InterpSoaFloat3) >= alignof(TangentSoaFloat3) &&
+                    alignof(TangentSoaFloat3) >=
+                        alignof(TangentSoaQuaternion) &&
+                    alignof(TangentSoaQuaternion) >= alignof(uint32_t) &&
                     alignof(uint32_t) >= alignof(byte),
                 "Must serve larger alignment values first)");
 
   translations_ = fill_span<InterpSoaFloat3>(buffer, max_soa_tracks);
   rotations_ = fill_span<InterpSoaQuaternion>(buffer, max_soa_tracks);
   scales_ = fill_span<InterpSoaFloat3>(buffer, max_soa_tracks);
+  translations_tangents_ = fill_span<TangentSoaFloat3>(buffer, max_soa_tracks);
+  rotations_tangents_ = fill_span<TangentSoaQuaternion>(buffer, max_soa_tracks);
+  scales_tangents_ = fill_span<TangentSoaFloat3>(buffer, max_soa_tracks);
 
   translations_cache_.entries = fill_span<uint32_t>(buffer, max_tracks);
   rotations_cache_.entries = fill_span<uint32_t>(buffer, max_tracks);
   scales_cache_.entries = fill_span<uint32_t>(buffer, max_tracks);
+  translations_quantized_cache_.entries =
+      fill_span<uint32_t>(buffer, max_tracks);
+  rotations_quantized_cache_.entries = fill_span<uint32_t>(buffer, max_tracks);
+  scales_quantized_cache_.entries = fill_span<uint32_t>(buffer, max_tracks);
 
   translations_cache_.outdated = fill_span<byte>(buffer, num_outdated);
   rotations_cache_.outdated = fill_span<byte>(buffer, num_outdated);
   scales_cache_.outdated = fill_span<byte>(buffer, num_outdated);
+  translations_quantized_cache_.outdated =
+      fill_span<byte>(buffer, num_outdated);
+  rotations_quantized_cache_.outdated = fill_span<byte>(buffer, num_outdated);
+  scales_quantized_cache_.outdated = fill_span<byte>(buffer, num_outdated);
+
+  translations_cache_.constant = fill_span<byte>(buffer, num_outdated);
+  rotations_cache_.constant = fill_span<byte>(buffer, num_outdated);
+  scales_cache_.constant = fill_span<byte>(buffer, num_outdated);
+  translations_quantized_cache_.constant = translations_cache_.constant;
+  rotations_quantized_cache_.constant = rotations_cache_.constant;
+  scales_quantized_cache_.constant = scales_cache_.constant;
 
   assert(buffer.empty());
 }
@@ -600,6 +1098,9 @@ void SamplingJob::Context::Invalidate() {
   translations_cache_.next = 0;
   rotations_cache_.next = 0;
   scales_cache_.next = 0;
+  translations_quantized_cache_.next = 0;
+  rotations_quantized_cache_.next = 0;
+  scales_quantized_cache_.next = 0;
 }
 }  // namespace animation
 }  // namespace ozz
@@ -29,7 +29,10 @@
 
 #include <cstring>
 
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/endianness.h"
 #include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
 #include "ozz/base/log.h"
 #include "ozz/base/maths/math_ex.h"
 #include "ozz/base/maths/soa_math_archive.h"
@@ -159,5 +162,139 @@ void Skeleton::Load(ozz::io::IArchive& _archive, uint32_t _version) {
   _archive >> ozz::io::MakeArray(joint_parents_);
   _archive >> ozz::io::MakeArray(joint_rest_poses_);
 }
+
+namespace {
+// Skeleton image header. Its size is a multiple of 16 bytes, so that rest
+// poses, following the header, are aligned.
+struct SkeletonImageHeader {
+  char tag[16];
+  uint32_t version;
+  uint32_t endianness;
+  uint32_t num_joints;
+  uint32_t chars_size;  // Size of joint names characters buffer.
+  uint32_t buffer_size;
+  uint32_t padding[3];
+};
+static_assert(sizeof(SkeletonImageHeader) % alignof(math::SoaTransform) == 0,
+              "Image header must preserve rest poses alignment");
+
+const char kSkeletonImageTag[sizeof(SkeletonImageHeader::tag)] =
+    "ozz-skel-image";
+const uint32_t kSkeletonImageVersion = 1;
+
+// Image buffer stores rest poses, joint names offsets, parents and joint names
+// characters, in this order, which serves larger alignment values first.
+size_t SkeletonImageBufferSize(size_t _num_joints, size_t _chars_size) {
+  return (_num_joints + 3) / 4 * sizeof(math::SoaTransform) +
+         _num_joints * (sizeof(uint32_t) + sizeof(int16_t)) + _chars_size;
+}
+}  // namespace
+
+bool Skeleton::SaveImage(ozz::io::Stream& _stream) const {
+  const size_t num_joints = joint_parents_.size();
+
+  // Computes joint names offsets in the characters buffer.
+  ozz::vector<uint32_t> offsets(num_joints);
+  size_t chars_size = 0;
+  for (size_t i = 0; i < num_joints; ++i) {
+    offsets[i] = static_cast<uint32_t>(chars_size);
+    chars_size += std::strlen(joint_names_[i]) + 1;
+  }
+
+  SkeletonImageHeader header = {};
+  std::memcpy(header.tag, kSkeletonImageTag, sizeof(header.tag));
+  header.version = kSkeletonImageVersion;
+  header.endianness = GetNativeEndianness();
+  header.num_joints = static_cast<uint32_t>(num_joints);
+  header.chars_size = static_cast<uint32_t>(chars_size);
+  header.buffer_size =
+      static_cast<uint32_t>(SkeletonImageBufferSize(num_joints, chars_size));
+
+  bool success = _stream.Write(&header, sizeof(header)) == sizeof(header);
+  if (num_joints) {
+    success &= _stream.Write(joint_rest_poses_.data(),
+                             joint_rest_poses_.size_bytes()) ==
+               joint_rest_poses_.size_bytes();
+    success &= _stream.Write(offsets.data(), num_joints * sizeof(uint32_t)) ==
+               num_joints * sizeof(uint32_t);
+    success &= _stream.Write(joint_parents_.data(),
+                             joint_parents_.size_bytes()) ==
+               joint_parents_.size_bytes();
+    for (size_t i = 0; i < num_joints; ++i) {
+      const size_t size = std::strlen(joint_names_[i]) + 1;
+      success &= _stream.Write(joint_names_[i], size) == size;
+    }
+  }
+  return success;
+}
+
+bool Skeleton::MapImage(span<const byte> _image) {
+  // Destroy skeleton in case it was already used before.
+  *this = Skeleton();
+
+  SkeletonImageHeader header;
+  if (_image.size_bytes() < sizeof(header) ||
+      !IsAligned(_image.data(), alignof(math::SoaTransform))) {
+    log::Err() << "Invalid skeleton image." << std::endl;
+    return false;
+  }
+  std::memcpy(&header, _image.data(), sizeof(header));
+
+  if (std::memcmp(header.tag, kSkeletonImageTag, sizeof(header.tag)) != 0 ||
+      header.version != kSkeletonImageVersion) {
+    log::Err() << "Unsupported skeleton image version." << std::endl;
+    return false;
+  }
+  if (header.endianness != static_cast<uint32_t>(GetNativeEndianness())) {
+    log::Err() << "Skeleton image endianness doesn't match platform."
+               << std::endl;
+    return false;
+  }
+  if (header.num_joints > kMaxJoints ||
+      SkeletonImageBufferSize(header.num_joints, header.chars_size) !=
+          header.buffer_size ||
+      _image.size_bytes() < sizeof(header) + header.buffer_size) {
+    log::Err() << "Invalid skeleton image." << std::endl;
+    return false;
+  }
+
+  // Early out if skeleton's empty.
+  const size_t num_joints = header.num_joints;
+  if (!num_joints) {
+    return true;
+  }
+
+  // Skeleton data is never written at runtime, so it's safe to point to
+  // constant image memory.
+  span<byte> buffer = {const_cast<byte*>(_image.data()) + sizeof(header),
+                       header.buffer_size};
+  const span<math::SoaTransform> rest_poses =
+      fill_span<math::SoaTransform>(buffer, (num_joints + 3) / 4);
+  const span<uint32_t> offsets = fill_span<uint32_t>(buffer, num_joints);
+  const span<int16_t> parents = fill_span<int16_t>(buffer, num_joints);
+  char* chars = reinterpret_cast<char*>(buffer.data());
+
+  // Every name must start and be null terminated within characters buffer.
+  bool valid = header.chars_size && !chars[header.chars_size - 1];
+  for (size_t i = 0; valid && i < num_joints; ++i) {
+    valid = offsets[i] < header.chars_size;
+  }
+  if (!valid) {
+    log::Err() << "Invalid skeleton image joint names." << std::endl;
+    return false;
+  }
+
+  // Only joint names array needs to be allocated, to relocate names offsets.
+  auto* allocator = memory::default_allocator();
+  allocation_ = allocator->Allocate(num_joints * sizeof(char*), alignof(char*));
+  joint_names_ = {static_cast<char**>(allocation_), num_joints};
+  for (size_t i = 0; i < num_joints; ++i) {
+    joint_names_[i] = chars + offsets[i];
+  }
+  joint_rest_poses_ = rest_poses;
+  joint_parents_ = parents;
+
+  return true;
+}
 }  // namespace animation
 }  // namespace ozz
@@ -0,0 +1,230 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/streaming_animation.h"
+
+#include <cassert>
+
+#include "ozz/base/endianness.h"
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/log.h"
+#include "ozz/base/maths/math_ex.h"
+
+namespace ozz {
+namespace animation {
+
+StreamingAnimation::StreamingAnimation() = default;
+
+StreamingAnimation::StreamingAnimation(StreamingAnimation&&) = default;
+
+StreamingAnimation& StreamingAnimation::operator=(StreamingAnimation&&) =
+    default;
+
+StreamingAnimation::~StreamingAnimation() = default;
+
+void StreamingAnimation::Reset() {
+  duration_ = 0.f;
+  chunk_duration_ = 0.f;
+  num_tracks_ = 0;
+  stamp_ = 0;
+  stream_ = nullptr;
+  base_ = 0;
+  chunks_.clear();
+}
+
+int StreamingAnimation::chunk_index(float _ratio) const {
+  if (chunks_.empty() || chunk_duration_ <= 0.f) {
+    return 0;
+  }
+  const float time = math::Clamp(0.f, _ratio, 1.f) * duration_;
+  const int index = static_cast<int>(time / chunk_duration_);
+  return math::Min(index, num_chunks() - 1);
+}
+
+void StreamingAnimation::set_max_resident_chunks(int _max) {
+  max_resident_chunks_ = math::Max(_max, 1);
+  Evict(-1, max_resident_chunks_);
+}
+
+int StreamingAnimation::num_resident_chunks() const {
+  int count = 0;
+  for (const Chunk& chunk : chunks_) {
+    count += chunk.loaded;
+  }
+  return count;
+}
+
+bool StreamingAnimation::resident(int _index) const {
+  assert(_index >= 0 && _index < num_chunks() && "Invalid chunk index.");
+  return chunks_[_index].loaded;
+}
+
+void StreamingAnimation::Evict(int _keep, int _budget) {
+  for (int resident = num_resident_chunks(); resident > _budget; --resident) {
+    Chunk* lru = nullptr;
+    for (int i = 0; i < num_chunks(); ++i) {
+      Chunk& chunk = chunks_[i];
+      if (chunk.loaded && i != _keep &&
+          (!lru || chunk.last_use < lru->last_use)) {
+        lru = &chunk;
+      }
+    }
+    if (!lru) {
+      break;
+    }
+    lru->animation = Animation();
+    lru->loaded = false;
+  }
+}
+
+bool StreamingAnimation::Load(int _index) {
+  assert(_index >= 0 && _index < num_chunks() && "Invalid chunk index.");
+  Chunk& chunk = chunks_[_index];
+  chunk.last_use = ++stamp_;
+  if (chunk.loaded) {
+    return true;
+  }
+  if (!stream_) {
+    return false;
+  }
+
+  // Makes room for the new chunk.
+  Evict(_index, max_resident_chunks_ - 1);
+
+  // Stream position is restored after reading, so chunk loading doesn't
+  // interfere with other users of the stream.
+  const int position = stream_->Tell();
+  bool success = stream_->Seek(base_ + static_cast<int>(chunk.offset),
+                               ozz::io::Stream::kSet) == 0;
+  if (success) {
+    ozz::io::IArchive archive(stream_);
+    success = archive.TestTag<Animation>();
+    if (success) {
+      archive >> chunk.animation;
+      success = chunk.animation.num_tracks() == num_tracks_;
+    }
+  }
+  stream_->Seek(position, ozz::io::Stream::kSet);
+
+  if (!success) {
+    log::Err() << "Failed to load streaming animation chunk " << _index << "."
+               << std::endl;
+    chunk.animation = Animation();
+    return false;
+  }
+  chunk.loaded = true;
+  return true;
+}
+
+const Animation* StreamingAnimation::Acquire(float _ratio,
+                                             float* _chunk_ratio) {
+  assert(_chunk_ratio);
+  if (chunks_.empty()) {
+    return nullptr;
+  }
+  const int index = chunk_index(_ratio);
+  if (!Load(index)) {
+    return nullptr;
+  }
+
+  // Remaps ratio to chunk range.
+  const Animation& animation = chunks_[index].animation;
+  const float time = math::Clamp(0.f, _ratio, 1.f) * duration_;
+  const float chunk_time = time - index * chunk_duration_;
+  const float duration = animation.duration();
+  *_chunk_ratio =
+      duration > 0.f ? math::Clamp(0.f, chunk_time / duration, 1.f) : 0.f;
+
+  return &animation;
+}
+
+void StreamingAnimation::Save(ozz::io::OArchive& _archive) const {
+  _archive << duration_;
+  _archive << chunk_duration_;
+  _archive << static_cast<uint32_t>(num_tracks_);
+
+  // Chunks are serialized to a memory stream first, in order to know their
+  // offsets. Each of them is a standalone archive, with the same endianness
+  // as _archive.
+  const Endianness native = GetNativeEndianness();
+  const Endianness endianness =
+      _archive.endian_swap()
+          ? (native == kLittleEndian ? kBigEndian : kLittleEndian)
+          : native;
+  ozz::io::MemoryStream stream;
+  ozz::vector<uint32_t> offsets;
+  for (const Chunk& chunk : chunks_) {
+    assert(chunk.loaded && "All chunks must be loaded to be saved.");
+    offsets.push_back(static_cast<uint32_t>(stream.Tell()));
+    ozz::io::OArchive archive(&stream, endianness);
+    archive << chunk.animation;
+  }
+
+  ozz::vector<byte> buffer(stream.Size());
+  stream.Seek(0, ozz::io::Stream::kSet);
+  stream.Read(buffer.data(), buffer.size());
+
+  _archive << static_cast<uint32_t>(offsets.size());
+  _archive << ozz::io::MakeArray(offsets.data(), offsets.size());
+  _archive << static_cast<uint32_t>(buffer.size());
+  _archive << ozz::io::MakeArray(buffer.data(), buffer.size());
+}
+
+void StreamingAnimation::Load(ozz::io::IArchive& _archive,
+                              uint32_t _version) {
+  // Destroy animation in case it was already used before.
+  Reset();
+
+  if (_version != 1) {
+    log::Err() << "Unsupported streaming animation version " << _version
+               << "." << std::endl;
+    return;
+  }
+
+  _archive >> duration_;
+  _archive >> chunk_duration_;
+  uint32_t num_tracks;
+  _archive >> num_tracks;
+  num_tracks_ = num_tracks;
+
+  uint32_t num_chunks;
+  _archive >> num_chunks;
+  chunks_.resize(num_chunks);
+  for (Chunk& chunk : chunks_) {
+    _archive >> chunk.offset;
+  }
+
+  // Only retains chunks location, and skips them.
+  uint32_t chunks_size;
+  _archive >> chunks_size;
+  stream_ = _archive.stream();
+  base_ = stream_->Tell();
+  stream_->Seek(static_cast<int>(chunks_size), ozz::io::Stream::kCurrent);
+}
+}  // namespace animation
+}  // namespace ozz
@@ -0,0 +1,138 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/runtime/track_event_index.h"
+
+#include <cassert>
+#include <utility>
+
+#include "ozz/base/io/archive.h"
+#include "ozz/base/log.h"
+#include "ozz/base/memory/allocator.h"
+
+namespace ozz {
+namespace animation {
+
+TrackEventIndex::TrackEventIndex(TrackEventIndex&& _other) {
+  *this = std::move(_other);
+}
+
+TrackEventIndex& TrackEventIndex::operator=(TrackEventIndex&& _other) {
+  std::swap(allocation_, _other.allocation_);
+  std::swap(threshold_, _other.threshold_);
+  std::swap(offsets_, _other.offsets_);
+  std::swap(ratios_, _other.ratios_);
+  std::swap(rising_, _other.rising_);
+  return *this;
+}
+
+TrackEventIndex::~TrackEventIndex() { Deallocate(); }
+
+void TrackEventIndex::Allocate(size_t _num_tracks, size_t _num_edges) {
+  assert(allocation_ == nullptr && "Already allocated");
+
+  // Distributes buffer memory while ensuring proper alignment (serves larger
+  // alignment values first).
+  static_assert(alignof(uint32_t) >= alignof(float) &&
+                    alignof(float) >= alignof(uint8_t),
+                "Must serve larger alignment values first)");
+
+  // Compute overall size and allocate a single buffer for all the data.
+  const size_t num_offsets = _num_tracks + 1;
+  const size_t buffer_size = num_offsets * sizeof(uint32_t) +  // offsets
+                             _num_edges * sizeof(float) +       // ratios
+                             (_num_edges + 7) * sizeof(uint8_t) / 8;  // rising
+
+  auto* allocator = memory::default_allocator();
+  allocation_ = allocator->Allocate(buffer_size, alignof(uint32_t));
+  span<byte> buffer = {static_cast<byte*>(allocation_), buffer_size};
+
+  // Fix up pointers. Serves larger alignment values first.
+  offsets_ = fill_span<uint32_t>(buffer, num_offsets);
+  ratios_ = fill_span<float>(buffer, _num_edges);
+  rising_ = fill_span<uint8_t>(buffer, (_num_edges + 7) / 8);
+
+  assert(buffer.empty() && "Whole buffer should be consumed");
+}
+
+void TrackEventIndex::Deallocate() {
+  // Deallocate everything at once.
+  memory::default_allocator()->Deallocate(allocation_);
+  allocation_ = nullptr;
+  offsets_ = {};
+  ratios_ = {};
+  rising_ = {};
+}
+
+size_t TrackEventIndex::size() const {
+  const size_t size = sizeof(*this) + offsets_.size_bytes() +
+                      ratios_.size_bytes() + rising_.size_bytes();
+  return size;
+}
+
+void TrackEventIndex::Save(ozz::io::OArchive& _archive) const {
+  const uint32_t num_tracks = static_cast<uint32_t>(this->num_tracks());
+  _archive << num_tracks;
+  const uint32_t num_edges = static_cast<uint32_t>(ratios_.size());
+  _archive << num_edges;
+  _archive << threshold_;
+
+  _archive << ozz::io::MakeArray(offsets_);
+  _archive << ozz::io::MakeArray(ratios_);
+  _archive << ozz::io::MakeArray(rising_);
+}
+
+void TrackEventIndex::Load(ozz::io::IArchive& _archive, uint32_t _version) {
+  // Destroy index in case it was already used before.
+  Deallocate();
+
+  if (_version > 1) {
+    log::Err() << "Unsupported TrackEventIndex version " << _version << "."
+               << std::endl;
+    return;
+  }
+
+  uint32_t num_tracks;
+  _archive >> num_tracks;
+  uint32_t num_edges;
+  _archive >> num_edges;
+  _archive >> threshold_;
+
+  // An index with no track has no offset.
+  if (num_tracks == 0) {
+    return;
+  }
+
+  Allocate(num_tracks, num_edges);
+
+  _archive >> ozz::io::MakeArray(offsets_);
+  _archive >> ozz::io::MakeArray(ratios_);
+  _archive >> ozz::io::MakeArray(rising_);
+}
+}  // namespace animation
+}  // namespace ozz
@@ -37,6 +37,100 @@ namespace ozz {
 namespace animation {
 namespace internal {
 
+size_t FindTrackKey(const void* _track, span<const float> _ratios,
+                    float _ratio, TrackSamplingContext* _context) {
+  assert(_ratios.size() >= 2 && _ratio > 0.f && _ratio < 1.f);
+  const float* begin = _ratios.begin();
+  const float* end = _ratios.end();
+
+  // Search for the first key frame with a ratio value greater than input
+  // ratio. Our ratio is between this one and the previous one.
+  const float* ptk1;
+  if (!_context || _context->track_ != _track ||
+      _context->key_ >= _ratios.size()) {
+    ptk1 = std::upper_bound(begin, end, _ratio);
+  } else {
+    const float* ptk0 = begin + _context->key_;
+    if (_ratio < *ptk0) {  // Backward, searches previous keys.
+      ptk1 = std::upper_bound(begin, ptk0, _ratio);
+    } else if (ptk0 + 1 == end || _ratio < ptk0[1]) {  // Same interval.
+      ptk1 = ptk0 + 1;
+    } else if (ptk0 + 2 == end || _ratio < ptk0[2]) {  // Next interval.
+      ptk1 = ptk0 + 2;
+    } else {  // Jumps forward, searches next keys.
+      ptk1 = std::upper_bound(ptk0 + 2, end, _ratio);
+    }
+  }
+
+  // Track first key ratio is 0, so ptk1 can't be the first key.
+  assert(ptk1 != begin);
+  const size_t key = ptk1 - begin - 1;
+  if (_context) {
+    _context->track_ = _track;
+    _context->key_ = key;
+  }
+  return key;
+}
+
+namespace {
+
+// Finds the keys to interpolate to sample _track at _ratio. Returns the
+// interpolation coefficient between keys _id0 and _id1, which are identical if
+// no interpolation is required. _track must have at least one key.
+template <typename _Track>
+float FindKeys(const _Track& _track, float _ratio,
+               TrackSamplingContext* _context, size_t* _id0, size_t* _id1) {
+  const span<const float> ratios = _track.ratios();
+  assert(ratios.size() != 0);
+  if (ratios.size() == 1 || _ratio <= 0.f) {
+    *_id0 = *_id1 = 0;
+    return 0.f;
+  }
+  if (_ratio >= 1.f) {
+    *_id0 = *_id1 = ratios.size() - 1;
+    return 0.f;
+  }
+
+  const size_t id0 = FindTrackKey(&_track, ratios, _ratio, _context);
+  const size_t id1 = id0 + 1;
+  *_id0 = id0;
+
+  const bool id0step = (_track.steps()[id0 / 8] & (1 << (id0 & 7))) != 0;
+  if (id0step || id1 == ratios.size()) {
+    *_id1 = id0;
+    return 0.f;
+  }
+
+  // Lerp relevant keys.
+  *_id1 = id1;
+  const float tk0 = ratios[id0];
+  const float tk1 = ratios[id1];
+  assert(_ratio >= tk0 && _ratio < tk1 && tk0 != tk1);
+  return (_ratio - tk0) / (tk1 - tk0);
+}
+
+// Interpolates 4 keys pairs at once, to soa outputs.
+void SoaLerp(const float* _k0, const float* _k1, const float* _alpha,
+             math::SimdFloat4* _result) {
+  *_result = math::Lerp(math::simd_float4::LoadPtrU(_k0),
+                        math::simd_float4::LoadPtrU(_k1),
+                        math::simd_float4::LoadPtrU(_alpha));
+}
+
+void SoaLerp(const math::Float3* _k0, const math::Float3* _k1,
+             const float* _alpha, math::SoaFloat3* _result) {
+  const math::SoaFloat3 k0 = {
+      math::simd_float4::Load(_k0[0].x, _k0[1].x, _k0[2].x, _k0[3].x),
+      math::simd_float4::Load(_k0[0].y, _k0[1].y, _k0[2].y, _k0[3].y),
+      math::simd_float4::Load(_k0[0].z, _k0[1].z, _k0[2].z, _k0[3].z)};
+  const math::SoaFloat3 k1 = {
+      math::simd_float4::Load(_k1[0].x, _k1[1].x, _k1[2].x, _k1[3].x),
+      math::simd_float4::Load(_k1[0].y, _k1[1].y, _k1[2].y, _k1[3].y),
+      math::simd_float4::Load(_k1[0].z, _k1[1].z, _k1[2].z, _k1[3].z)};
+  *_result = math::Lerp(k0, k1, math::simd_float4::LoadPtrU(_alpha));
+}
+}  // namespace
+
 template <typename _Track>
 bool TrackSamplingJob<_Track>::Validate() const {
   bool success = true;
@@ -51,40 +145,69 @@ bool TrackSamplingJob<_Track>::Run() const {
     return false;
   }
 
-  // Search keyframes to interpolate.
-  const span<const float> ratios = track->ratios();
   const span<const ValueType> values = track->values();
-  assert(ratios.size() == values.size() &&
+  assert(track->ratios().size() == values.size() &&
          track->steps().size() * 8 >= values.size());
 
-  if (ratios.size() == 0) {  // Default (empty) track returns identity.
+  if (values.size() == 0) {  // Default (empty) track returns identity.
     *result = internal::TrackPolicy<ValueType>::identity();
-  } else if (ratios.size() == 1 || ratio <= 0.f) {
-    *result = values.front();
-  } else if (ratio >= 1.f) {
-    *result = values.back();
+    return true;
+  }
+
+  size_t id0, id1;
+  const float alpha = FindKeys(*track, ratio, context, &id0, &id1);
+  if (id0 == id1) {
+    *result = values[id0];
   } else {
-    // Search for the first key frame with a ratio value greater than input
-    // ratio. Our ratio is between this one and the previous one.
-    const float* ptk1 = std::upper_bound(ratios.begin(), ratios.end(), ratio);
-
-    // Deduce keys indices.
-    const size_t id1 = ptk1 - ratios.begin();
-    const size_t id0 = id1 - 1;
-
-    const bool id0step = (track->steps()[id0 / 8] & (1 << (id0 & 7))) != 0;
-    if (id0step || ptk1 == ratios.end()) {
-      *result = values[id0];
-    } else {
-      // Lerp relevant keys.
-      const float tk0 = ratios[id0];
-      const float tk1 = ratios[id1];
-      assert(ratio >= tk0 && ratio < tk1 && tk0 != tk1);
-      const float alpha = (ratio - tk0) / (tk1 - tk0);
-      const ValueType& vk0 = values[id0];
-      const ValueType& vk1 = values[id1];
-      *result = internal::TrackPolicy<ValueType>::Lerp(vk0, vk1, alpha);
+    *result =
+        internal::TrackPolicy<ValueType>::Lerp(values[id0], values[id1], alpha);
+  }
+  return true;
+}
+
+template <typename _Track, typename _SoaValue>
+bool TrackBatchSamplingJob<_Track, _SoaValue>::Validate() const {
+  bool success = true;
+  success &= ratios.size() == 1 || ratios.size() == tracks.size();
+  success &= contexts.empty() || contexts.size() == tracks.size();
+  success &= results.size() >= (tracks.size() + 3) / 4;
+  for (const _Track* track : tracks) {
+    success &= track != nullptr;
+  }
+  return success;
+}
+
+template <typename _Track, typename _SoaValue>
+bool TrackBatchSamplingJob<_Track, _SoaValue>::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  typedef typename _Track::ValueType ValueType;
+  const size_t num_tracks = tracks.size();
+  for (size_t i = 0; i < num_tracks; i += 4) {
+    // Gathers keys to interpolate and their coefficients, 4 tracks at a time.
+    // Lanes after the last track interpolates identity values.
+    ValueType k0[4], k1[4];
+    float alpha[4];
+    for (size_t j = 0; j < 4; ++j) {
+      const size_t t = i + j;
+      if (t >= num_tracks || tracks[t]->values().size() == 0) {
+        k0[j] = k1[j] = internal::TrackPolicy<ValueType>::identity();
+        alpha[j] = 0.f;
+        continue;
+      }
+      const _Track& track = *tracks[t];
+      const float ratio = ratios.size() == 1 ? ratios[0] : ratios[t];
+      TrackSamplingContext* context = contexts.empty() ? nullptr : &contexts[t];
+      size_t id0, id1;
+      alpha[j] = FindKeys(track, ratio, context, &id0, &id1);
+      const span<const ValueType> values = track.values();
+      k0[j] = values[id0];
+      k1[j] = values[id1];
     }
+
+    SoaLerp(k0, k1, alpha, &results[i / 4]);
   }
   return true;
 }
@@ -95,6 +218,8 @@ template struct TrackSamplingJob<Float2Track>;
 template struct TrackSamplingJob<Float3Track>;
 template struct TrackSamplingJob<Float4Track>;
 template struct TrackSamplingJob<QuaternionTrack>;
+template struct TrackBatchSamplingJob<FloatTrack, math::SimdFloat4>;
+template struct TrackBatchSamplingJob<Float3Track, math::SoaFloat3>;
 }  // namespace internal
 }  // namespace animation
 }  // namespace ozz
@@ -32,6 +32,21 @@
 #include <cstring>
 #include <limits>
 
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif  // NOMINMAX
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif  // WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else  // _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // _WIN32
+
 #include "ozz/base/maths/math_ex.h"
 #include "ozz/base/memory/allocator.h"
 
@@ -215,5 +230,135 @@ bool MemoryStream::Resize(size_t _size) {
   }
   return _size == 0 || buffer_ != nullptr;
 }
+
+// Starts MappedFile implementation.
+
+// Empty files can't be mapped, but are still considered opened. handle_ is set
+// to this sentinel value in that case.
+static byte kEmptyMapping;
+
+MappedFile::MappedFile(const char* _filename)
+    : data_(nullptr), size_(0), tell_(0), handle_(nullptr) {
+#ifdef _WIN32
+  const HANDLE file =
+      CreateFileA(_filename, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  LARGE_INTEGER size;
+  if (GetFileSizeEx(file, &size) &&
+      static_cast<uint64_t>(size.QuadPart) <= std::numeric_limits<int>::max()) {
+    if (size.QuadPart == 0) {
+      handle_ = &kEmptyMapping;
+    } else {
+      const HANDLE mapping =
+          CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (mapping != nullptr) {
+        data_ = static_cast<const byte*>(
+            MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (data_) {
+          size_ = static_cast<size_t>(size.QuadPart);
+          handle_ = mapping;
+        } else {
+          CloseHandle(mapping);
+        }
+      }
+    }
+  }
+  // Mapping keeps a reference to the file.
+  CloseHandle(file);
+#else   // _WIN32
+  const int file = open(_filename, O_RDONLY);
+  if (file == -1) {
+    return;
+  }
+  struct stat status;
+  if (fstat(file, &status) == 0 &&
+      static_cast<uint64_t>(status.st_size) <=
+          static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+    if (status.st_size == 0) {
+      handle_ = &kEmptyMapping;
+    } else {
+      void* mapping = mmap(nullptr, static_cast<size_t>(status.st_size),
+                           PROT_READ, MAP_PRIVATE, file, 0);
+      if (mapping != MAP_FAILED) {
+        data_ = static_cast<const byte*>(mapping);
+        size_ = static_cast<size_t>(status.st_size);
+        handle_ = mapping;
+      }
+    }
+  }
+  // Mapping keeps a reference to the file.
+  close(file);
+#endif  // _WIN32
+}
+
+MappedFile::~MappedFile() { Close(); }
+
+void MappedFile::Close() {
+  if (handle_ != nullptr && handle_ != &kEmptyMapping) {
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(handle_);
+#else   // _WIN32
+    munmap(handle_, size_);
+#endif  // _WIN32
+  }
+  handle_ = nullptr;
+  data_ = nullptr;
+  size_ = 0;
+  tell_ = 0;
+}
+
+bool MappedFile::opened() const { return handle_ != nullptr; }
+
+size_t MappedFile::Read(void* _buffer, size_t _size) {
+  // A read cannot set file position beyond the end of the file.
+  const int end = static_cast<int>(size_);
+  if (tell_ >= end) {
+    return 0;
+  }
+  const size_t read_size = math::Min(static_cast<size_t>(end - tell_), _size);
+  std::memcpy(_buffer, data_ + tell_, read_size);
+  tell_ += static_cast<int>(read_size);
+  return read_size;
+}
+
+size_t MappedFile::Write(const void* _buffer, size_t _size) {
+  (void)_buffer;
+  (void)_size;
+  return 0;
+}
+
+int MappedFile::Seek(int _offset, Origin _origin) {
+  int origin;
+  switch (_origin) {
+    case kCurrent:
+      origin = tell_;
+      break;
+    case kEnd:
+      origin = static_cast<int>(size_);
+      break;
+    case kSet:
+      origin = 0;
+      break;
+    default:
+      return -1;
+  }
+
+  // Exit if seeking before file begin or beyond max file size.
+  if (origin < -_offset ||
+      (_offset > 0 && origin > std::numeric_limits<int>::max() - _offset)) {
+    return -1;
+  }
+
+  tell_ = origin + _offset;
+  return 0;
+}
+
+int MappedFile::Tell() const { return tell_; }
+
+size_t MappedFile::Size() const { return size_; }
 }  // namespace io
 }  // namespace ozz
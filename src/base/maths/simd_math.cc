@@ -27,6 +27,10 @@
 
 #include "ozz/base/maths/simd_math.h"
 
+#if defined(OZZ_SIMD_AVX2_DISPATCH) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace ozz {
 namespace math {
 
@@ -59,5 +63,45 @@ namespace math {
                 " math implementation")
 
 const char* SimdImplementationName() { return _OZZ_SIMD_IMPLEMENTATION; }
+
+#if defined(OZZ_SIMD_AVX2_DISPATCH) && defined(_MSC_VER)
+namespace {
+bool DetectAvx2() {
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+
+  // Requires AVX and FMA support, and OS support for AVX registers (XSAVE
+  // enabled, and xmm and ymm states saved).
+  __cpuid(info, 1);
+  const int kFma = 1 << 12, kOsXSave = 1 << 27, kAvx = 1 << 28;
+  if ((info[2] & (kFma | kOsXSave | kAvx)) != (kFma | kOsXSave | kAvx) ||
+      (_xgetbv(0) & 6) != 6) {
+    return false;
+  }
+
+  __cpuidex(info, 7, 0);
+  const int kAvx2 = 1 << 5;
+  return (info[1] & kAvx2) != 0;
+}
+}  // namespace
+#endif  // OZZ_SIMD_AVX2_DISPATCH && _MSC_VER
+
+bool SupportsAvx2() {
+#if defined(OZZ_SIMD_AVX2)
+  return true;
+#elif defined(OZZ_SIMD_AVX2_DISPATCH) && defined(_MSC_VER)
+  static const bool supported = DetectAvx2();
+  return supported;
+#elif defined(OZZ_SIMD_AVX2_DISPATCH)
+  static const bool supported =
+      __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  return supported;
+#else
+  return false;
+#endif
+}
 }  // namespace math
 }  // namespace ozz
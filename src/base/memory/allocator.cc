@@ -39,10 +39,20 @@ namespace ozz {
 namespace memory {
 
 namespace {
+// Header stored before every block of the heap allocator and of the scope
+// router. It's used to release blocks to the allocator they come from.
 struct Header {
+  // Address returned by malloc, or by owner allocator.
   void* unaligned;
-  size_t size;
+
+  // Allocator the block comes from.
+  Allocator* owner;
 };
+
+Header* GetHeader(void* _block) {
+  return reinterpret_cast<Header*>(static_cast<char*>(_block) -
+                                   sizeof(Header));
+}
 }  // namespace
 
 // Implements the basic heap allocator.
@@ -54,6 +64,16 @@ class HeapAllocator : public Allocator {
     assert(allocation_count_.load() == 0 && "Memory leak detected");
   }
 
+  Stats stats() const {
+    Stats stats;
+    stats.allocations = allocations_.load(std::memory_order_relaxed);
+    stats.deallocations = deallocations_.load(std::memory_order_relaxed);
+    stats.backing_allocations = stats.allocations;
+    stats.backing_deallocations = stats.deallocations;
+    stats.allocated_bytes = allocated_bytes_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
  protected:
   void* Allocate(size_t _size, size_t _alignment) {
     // Allocates enough memory to store the header + required alignment space.
@@ -65,22 +85,29 @@ class HeapAllocator : public Allocator {
     char* aligned = ozz::Align(unaligned + sizeof(Header), _alignment);
     assert(aligned + _size <= unaligned + to_allocate);  // Don't overrun.
     // Set the header
-    Header* header = reinterpret_cast<Header*>(aligned - sizeof(Header));
+    Header* header = GetHeader(aligned);
     assert(reinterpret_cast<char*>(header) >= unaligned);
     header->unaligned = unaligned;
-    header->size = _size;
+    header->owner = this;
     // Allocation's succeeded.
     ++allocation_count_;
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes_.fetch_add(_size, std::memory_order_relaxed);
     return aligned;
   }
 
   void Deallocate(void* _block) {
     if (_block) {
-      Header* header = reinterpret_cast<Header*>(
-          reinterpret_cast<char*>(_block) - sizeof(Header));
+      Header* header = GetHeader(_block);
+      // Block was allocated within a ScopedAllocator scope.
+      if (header->owner != this) {
+        header->owner->Deallocate(header->unaligned);
+        return;
+      }
       free(header->unaligned);
       // Deallocation completed.
       --allocation_count_;
+      deallocations_.fetch_add(1, std::memory_order_relaxed);
     }
   }
 
@@ -88,6 +115,11 @@ class HeapAllocator : public Allocator {
   // Internal allocation count used to track memory leaks.
   // Should equals 0 at destruction time.
   std::atomic_int allocation_count_;
+
+  // Statistics counters.
+  std::atomic<size_t> allocations_{0};
+  std::atomic<size_t> deallocations_{0};
+  std::atomic<size_t> allocated_bytes_{0};
 };
 
 namespace {
@@ -96,10 +128,70 @@ HeapAllocator g_heap_allocator;
 
 // Instantiates the default heap allocator pointer.
 Allocator* g_default_allocator = &g_heap_allocator;
+
+// Calling thread innermost scope, nullptr if none.
+thread_local ScopedAllocator* t_scope = nullptr;
+}  // namespace
+
+// Implements the allocator returned by default_allocator() within a scope.
+// Allocations are forwarded to the innermost scope allocator, which is
+// recorded in the block header. While the scope allocator runs, the enclosing
+// scope becomes the innermost one, so that the scope allocator own
+// allocations (like arena chunks) are served by the enclosing scope.
+class ScopeRouter : public Allocator {
+ public:
+  void* Allocate(size_t _size, size_t _alignment) {
+    ScopedAllocator* scope = t_scope;
+    Allocator* owner = scope ? scope->allocator_ : g_default_allocator;
+
+    // Heap allocator blocks already have a header.
+    if (owner == &g_heap_allocator) {
+      return owner->Allocate(_size, _alignment);
+    }
+
+    const size_t alignment =
+        _alignment > alignof(Header) ? _alignment : alignof(Header);
+    const size_t offset = Align(sizeof(Header), alignment);
+    t_scope = scope ? scope->previous_ : nullptr;
+    void* unaligned = owner->Allocate(offset + _size, alignment);
+    t_scope = scope;
+    if (!unaligned) {
+      return nullptr;
+    }
+    void* block = static_cast<char*>(unaligned) + offset;
+    Header* header = GetHeader(block);
+    header->unaligned = unaligned;
+    header->owner = owner;
+    return block;
+  }
+
+  void Deallocate(void* _block) {
+    if (!_block) {
+      return;
+    }
+    // Heap allocator blocks are released by the heap allocator itself.
+    Header* header = GetHeader(_block);
+    Allocator* heap = &g_heap_allocator;
+    if (header->owner == heap) {
+      heap->Deallocate(_block);
+      return;
+    }
+    ScopedAllocator* scope = t_scope;
+    t_scope = scope ? scope->previous_ : nullptr;
+    header->owner->Deallocate(header->unaligned);
+    t_scope = scope;
+  }
+};
+
+namespace {
+// Instantiates the scope router.
+ScopeRouter g_scope_router;
 }  // namespace
 
 // Implements default allocator accessor.
-Allocator* default_allocator() { return g_default_allocator; }
+Allocator* default_allocator() {
+  return t_scope ? &g_scope_router : g_default_allocator;
+}
 
 // Implements default allocator setter.
 Allocator* SetDefaulAllocator(Allocator* _allocator) {
@@ -107,5 +199,19 @@ Allocator* SetDefaulAllocator(Allocator* _allocator) {
   g_default_allocator = _allocator;
   return previous;
 }
+
+Stats heap_stats() { return g_heap_allocator.stats(); }
+
+ScopedAllocator::ScopedAllocator(Allocator* _allocator)
+    : allocator_(_allocator), previous_(t_scope) {
+  assert(g_default_allocator == &g_heap_allocator &&
+         "Scoped allocators require the built-in default allocator.");
+  t_scope = this;
+}
+
+ScopedAllocator::~ScopedAllocator() {
+  assert(t_scope == this && "Scopes must be destroyed in reverse order.");
+  t_scope = previous_;
+}
 }  // namespace memory
 }  // namespace ozz
@@ -0,0 +1,126 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/base/memory/arena_allocator.h"
+
+#include <cassert>
+
+namespace ozz {
+namespace memory {
+
+struct ArenaAllocator::Chunk {
+  // Previously allocated chunk.
+  Chunk* next;
+
+  // Chunk memory range, following the header.
+  char* begin;
+  char* end;
+
+  // Allocation cursor.
+  char* cursor;
+};
+
+ArenaAllocator::ArenaAllocator(size_t _chunk_size, Allocator* _backing)
+    : chunk_size_(_chunk_size), backing_(_backing) {
+  assert(backing_ && backing_ != this);
+}
+
+ArenaAllocator::~ArenaAllocator() {
+  for (Chunk* chunk = chunks_; chunk;) {
+    Chunk* next = chunk->next;
+    backing_->Deallocate(chunk);
+    chunk = next;
+  }
+}
+
+void* ArenaAllocator::Allocate(size_t _size, size_t _alignment) {
+  ++stats_.allocations;
+  stats_.allocated_bytes += _size;
+
+  // Fits in current chunk.
+  if (chunks_) {
+    char* aligned = Align(chunks_->cursor, _alignment);
+    if (aligned + _size <= chunks_->end) {
+      chunks_->cursor = aligned + _size;
+      return aligned;
+    }
+  }
+
+  // Needs a new chunk, big enough for this allocation.
+  const size_t required = _size + _alignment - 1;
+  const size_t size = required > chunk_size_ ? required : chunk_size_;
+  void* memory = backing_->Allocate(sizeof(Chunk) + size, alignof(Chunk));
+  if (!memory) {
+    return nullptr;
+  }
+  ++stats_.backing_allocations;
+  Chunk* chunk = static_cast<Chunk*>(memory);
+  chunk->next = chunks_;
+  chunk->begin = reinterpret_cast<char*>(chunk + 1);
+  chunk->end = chunk->begin + size;
+  char* aligned = Align(chunk->begin, _alignment);
+  chunk->cursor = aligned + _size;
+  chunks_ = chunk;
+  return aligned;
+}
+
+void ArenaAllocator::Deallocate(void* _block) {
+  if (!_block) {
+    return;
+  }
+  ++stats_.deallocations;
+}
+
+void ArenaAllocator::Reset() {
+  if (!chunks_) {
+    return;
+  }
+  // Keeps the oldest chunk, which is at least chunk_size_ bytes (more if it
+  // was allocated for a bigger block).
+  Chunk* first = chunks_;
+  while (first->next) {
+    first = first->next;
+  }
+  for (Chunk* chunk = chunks_; chunk != first;) {
+    Chunk* next = chunk->next;
+    backing_->Deallocate(chunk);
+    ++stats_.backing_deallocations;
+    chunk = next;
+  }
+  first->cursor = first->begin;
+  chunks_ = first;
+}
+
+size_t ArenaAllocator::used() const {
+  size_t used = 0;
+  for (const Chunk* chunk = chunks_; chunk; chunk = chunk->next) {
+    used += chunk->cursor - chunk->begin;
+  }
+  return used;
+}
+}  // namespace memory
+}  // namespace ozz
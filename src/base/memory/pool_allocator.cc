@@ -0,0 +1,128 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/base/memory/pool_allocator.h"
+
+#include <cassert>
+
+namespace ozz {
+namespace memory {
+
+struct alignas(PoolAllocator::kBlockAlignment) PoolAllocator::Slab {
+  // Previously allocated slab.
+  Slab* next;
+};
+
+namespace {
+// Every block is preceded by a prefix that stores the address returned by the
+// backing allocator for blocks that don't fit in the pool, or nullptr for
+// slab blocks. Prefix space keeps blocks aligned.
+const size_t kPrefixSpace = PoolAllocator::kBlockAlignment;
+static_assert(sizeof(void*) <= kPrefixSpace,
+              "Block prefix doesn't fit in reserved space");
+
+void*& BlockPrefix(void* _block) { return static_cast<void**>(_block)[-1]; }
+}  // namespace
+
+PoolAllocator::PoolAllocator(size_t _block_size, size_t _blocks_per_slab,
+                             Allocator* _backing)
+    : block_size_(Align(_block_size > sizeof(void*) ? _block_size
+                                                    : sizeof(void*),
+                        kBlockAlignment)),
+      blocks_per_slab_(_blocks_per_slab > 0 ? _blocks_per_slab : 1),
+      backing_(_backing) {
+  assert(backing_ && backing_ != this);
+}
+
+PoolAllocator::~PoolAllocator() {
+  for (Slab* slab = slabs_; slab;) {
+    Slab* next = slab->next;
+    backing_->Deallocate(slab);
+    slab = next;
+  }
+}
+
+void* PoolAllocator::Allocate(size_t _size, size_t _alignment) {
+  ++stats_.allocations;
+  stats_.allocated_bytes += _size;
+
+  // Doesn't fit in a block.
+  if (_size > block_size_ || _alignment > kBlockAlignment) {
+    const size_t alignment =
+        _alignment > kBlockAlignment ? _alignment : kBlockAlignment;
+    const size_t offset = Align(kPrefixSpace, alignment);
+    void* unaligned = backing_->Allocate(offset + _size, alignment);
+    if (!unaligned) {
+      return nullptr;
+    }
+    ++stats_.backing_allocations;
+    void* block = static_cast<char*>(unaligned) + offset;
+    BlockPrefix(block) = unaligned;
+    return block;
+  }
+
+  // Allocates a new slab and pushes all its blocks to the free list.
+  if (!free_) {
+    const size_t stride = kPrefixSpace + block_size_;
+    const size_t size = sizeof(Slab) + stride * blocks_per_slab_;
+    void* memory = backing_->Allocate(size, alignof(Slab));
+    if (!memory) {
+      return nullptr;
+    }
+    ++stats_.backing_allocations;
+    Slab* slab = static_cast<Slab*>(memory);
+    slab->next = slabs_;
+    slabs_ = slab;
+    char* begin = reinterpret_cast<char*>(slab + 1) + kPrefixSpace;
+    for (size_t i = blocks_per_slab_; i > 0; --i) {
+      char* block = begin + (i - 1) * stride;
+      BlockPrefix(block) = nullptr;
+      *reinterpret_cast<void**>(block) = free_;
+      free_ = block;
+    }
+  }
+
+  void* block = free_;
+  free_ = *reinterpret_cast<void**>(block);
+  return block;
+}
+
+void PoolAllocator::Deallocate(void* _block) {
+  if (!_block) {
+    return;
+  }
+  ++stats_.deallocations;
+  if (void* unaligned = BlockPrefix(_block)) {
+    backing_->Deallocate(unaligned);
+    ++stats_.backing_deallocations;
+  } else {
+    *reinterpret_cast<void**>(_block) = free_;
+    free_ = _block;
+  }
+}
+}  // namespace memory
+}  // namespace ozz
@@ -0,0 +1,249 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/base/memory/thread_cache_allocator.h"
+
+#include <cassert>
+
+namespace ozz {
+namespace memory {
+
+namespace {
+// Number of cached size classes, from kMinClassSize to kMaxClassSize.
+const int kNumClasses = 9;
+static_assert(ThreadCacheAllocator::kMinClassSize << (kNumClasses - 1) ==
+                  ThreadCacheAllocator::kMaxClassSize,
+              "Inconsistent number of size classes");
+
+// Header stored before every block.
+struct CacheHeader {
+  // Address returned by the backing allocator.
+  void* unaligned;
+
+  // Backing allocator of the block.
+  Allocator* backing;
+
+  // Size class of the block, kNumClasses if it isn't cacheable.
+  int size_class;
+};
+
+// Finds size class of _size, kNumClasses if it's too big.
+int SizeClass(size_t _size) {
+  int size_class = 0;
+  for (size_t class_size = ThreadCacheAllocator::kMinClassSize;
+       class_size < _size && size_class < kNumClasses; class_size <<= 1) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+CacheHeader* GetCacheHeader(void* _block) {
+  return reinterpret_cast<CacheHeader*>(static_cast<char*>(_block) -
+                                        sizeof(CacheHeader));
+}
+
+// Calling thread cache of blocks, for a single ThreadCacheAllocator instance.
+struct ThreadCache {
+  // Releases cached blocks to their backing allocator. Returns the number of
+  // released blocks.
+  size_t Flush() {
+    size_t released = 0;
+    for (int i = 0; i < kNumClasses; ++i) {
+      while (void* block = lists[i]) {
+        lists[i] = *static_cast<void**>(block);
+        CacheHeader* header = GetCacheHeader(block);
+        header->backing->Deallocate(header->unaligned);
+        ++released;
+      }
+      counts[i] = 0;
+    }
+    return released;
+  }
+
+  // Identifier of the ThreadCacheAllocator instance.
+  uint64_t owner;
+
+  // Allocator of this ThreadCache object.
+  Allocator* backing;
+
+  // Next cache of the calling thread.
+  ThreadCache* next;
+
+  // Free lists, linked through the first bytes of each block.
+  void* lists[kNumClasses];
+  int counts[kNumClasses];
+};
+
+// All caches of the calling thread, one per ThreadCacheAllocator instance
+// used by the thread.
+struct ThreadCaches {
+  ~ThreadCaches() {
+    while (head) {
+      Remove(head);
+    }
+  }
+
+  // Finds _owner cache, moving it to the front so that the cache of the
+  // instance in use is found first. Returns nullptr if there's none.
+  ThreadCache* Find(uint64_t _owner) {
+    for (ThreadCache** link = &head; *link; link = &(*link)->next) {
+      ThreadCache* cache = *link;
+      if (cache->owner == _owner) {
+        *link = cache->next;
+        cache->next = head;
+        head = cache;
+        return cache;
+      }
+    }
+    return nullptr;
+  }
+
+  // Creates _owner cache, allocated from _backing.
+  ThreadCache* Create(uint64_t _owner, Allocator* _backing) {
+    void* memory =
+        _backing->Allocate(sizeof(ThreadCache), alignof(ThreadCache));
+    if (!memory) {
+      return nullptr;
+    }
+    ThreadCache* cache = new (memory) ThreadCache();
+    cache->owner = _owner;
+    cache->backing = _backing;
+    cache->next = head;
+    head = cache;
+    return cache;
+  }
+
+  // Flushes and destroys _cache, which must be the head of the list (as
+  // returned by Find). Returns the number of released blocks.
+  size_t Remove(ThreadCache* _cache) {
+    assert(_cache == head);
+    head = _cache->next;
+    const size_t released = _cache->Flush();
+    _cache->backing->Deallocate(_cache);
+    return released;
+  }
+
+  ThreadCache* head = nullptr;
+};
+
+thread_local ThreadCaches t_caches;
+
+// Source of instance unique identifiers.
+std::atomic<uint64_t> g_next_id{0};
+}  // namespace
+
+ThreadCacheAllocator::ThreadCacheAllocator(int _max_cached_blocks,
+                                           Allocator* _backing)
+    : id_(g_next_id.fetch_add(1, std::memory_order_relaxed)),
+      max_cached_blocks_(_max_cached_blocks),
+      backing_(_backing) {
+  assert(backing_ && backing_ != this);
+}
+
+ThreadCacheAllocator::~ThreadCacheAllocator() { Flush(); }
+
+void* ThreadCacheAllocator::Allocate(size_t _size, size_t _alignment) {
+  allocations_.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes_.fetch_add(_size, std::memory_order_relaxed);
+
+  const int size_class =
+      _alignment <= kMinClassSize ? SizeClass(_size) : kNumClasses;
+
+  // Reuses a block from this instance cache.
+  if (size_class < kNumClasses) {
+    ThreadCache* cache = t_caches.Find(id_);
+    if (cache && cache->lists[size_class]) {
+      void* block = cache->lists[size_class];
+      cache->lists[size_class] = *static_cast<void**>(block);
+      --cache->counts[size_class];
+      return block;
+    }
+  }
+
+  // Allocates a new block, with enough space for the header before it.
+  const size_t alignment =
+      _alignment > kMinClassSize ? _alignment : kMinClassSize;
+  const size_t offset = Align(sizeof(CacheHeader), alignment);
+  const size_t size =
+      size_class < kNumClasses ? kMinClassSize << size_class : _size;
+  void* unaligned = backing_->Allocate(offset + size, alignment);
+  if (!unaligned) {
+    return nullptr;
+  }
+  backing_allocations_.fetch_add(1, std::memory_order_relaxed);
+  void* block = static_cast<char*>(unaligned) + offset;
+  CacheHeader* header = GetCacheHeader(block);
+  header->unaligned = unaligned;
+  header->backing = backing_;
+  header->size_class = size_class;
+  return block;
+}
+
+void ThreadCacheAllocator::Deallocate(void* _block) {
+  if (!_block) {
+    return;
+  }
+  deallocations_.fetch_add(1, std::memory_order_relaxed);
+  CacheHeader* header = GetCacheHeader(_block);
+  const int size_class = header->size_class;
+  ThreadCache* cache = nullptr;
+  if (size_class < kNumClasses) {
+    cache = t_caches.Find(id_);
+    if (!cache) {
+      cache = t_caches.Create(id_, backing_);
+    }
+  }
+  if (cache && cache->counts[size_class] < max_cached_blocks_) {
+    *static_cast<void**>(_block) = cache->lists[size_class];
+    cache->lists[size_class] = _block;
+    ++cache->counts[size_class];
+  } else {
+    header->backing->Deallocate(header->unaligned);
+    backing_deallocations_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void ThreadCacheAllocator::Flush() {
+  if (ThreadCache* cache = t_caches.Find(id_)) {
+    backing_deallocations_.fetch_add(t_caches.Remove(cache),
+                                     std::memory_order_relaxed);
+  }
+}
+
+Stats ThreadCacheAllocator::stats() const {
+  Stats stats;
+  stats.allocations = allocations_.load(std::memory_order_relaxed);
+  stats.deallocations = deallocations_.load(std::memory_order_relaxed);
+  stats.backing_allocations =
+      backing_allocations_.load(std::memory_order_relaxed);
+  stats.backing_deallocations =
+      backing_deallocations_.load(std::memory_order_relaxed);
+  stats.allocated_bytes = allocated_bytes_.load(std::memory_order_relaxed);
+  return stats;
+}
+}  // namespace memory
+}  // namespace ozz
@@ -0,0 +1,278 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/base/scheduler.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/memory/allocator.h"
+
+namespace ozz {
+
+namespace {
+// Packs a range of loop indices in a single 64b integer, so it can be updated
+// atomically.
+uint64_t PackRange(int _begin, int _end) {
+  return static_cast<uint64_t>(static_cast<uint32_t>(_begin)) |
+         (static_cast<uint64_t>(static_cast<uint32_t>(_end)) << 32);
+}
+int RangeBegin(uint64_t _range) {
+  return static_cast<int>(static_cast<uint32_t>(_range));
+}
+int RangeEnd(uint64_t _range) {
+  return static_cast<int>(static_cast<uint32_t>(_range >> 32));
+}
+}  // namespace
+
+struct ThreadPoolScheduler::Impl {
+  explicit Impl(int _num_workers) : ranges(_num_workers) {}
+
+  // Remaining range of a worker. Padded to avoid false sharing between
+  // workers.
+  struct Range {
+    std::atomic<uint64_t> value{0};
+    char padding[64 - sizeof(std::atomic<uint64_t>)];
+  };
+
+  // Pops up to _grain indices from the front of worker _worker range.
+  bool Pop(int _worker, int _grain, int* _begin, int* _end) {
+    std::atomic<uint64_t>& range = ranges[_worker].value;
+    uint64_t current = range.load(std::memory_order_relaxed);
+    for (;;) {
+      const int begin = RangeBegin(current);
+      const int end = RangeEnd(current);
+      if (begin >= end) {
+        return false;
+      }
+      const int split = end - begin > _grain ? begin + _grain : end;
+      if (range.compare_exchange_weak(current, PackRange(split, end),
+                                      std::memory_order_acq_rel)) {
+        *_begin = begin;
+        *_end = split;
+        return true;
+      }
+    }
+  }
+
+  // Steals the back half of worker _victim range.
+  bool Steal(int _victim, int _grain, int* _begin, int* _end) {
+    std::atomic<uint64_t>& range = ranges[_victim].value;
+    uint64_t current = range.load(std::memory_order_relaxed);
+    for (;;) {
+      const int begin = RangeBegin(current);
+      const int end = RangeEnd(current);
+      if (begin >= end) {
+        return false;
+      }
+      const int split =
+          end - begin > _grain ? begin + (end - begin) / 2 : begin;
+      if (range.compare_exchange_weak(current, PackRange(begin, split),
+                                      std::memory_order_acq_rel)) {
+        *_begin = split;
+        *_end = end;
+        return true;
+      }
+    }
+  }
+
+  // Processes loop indices until all ranges are empty.
+  void Work(int _worker, Task _task, void* _user_data, int _grain) {
+    const int num_workers = static_cast<int>(ranges.size());
+    for (;;) {
+      int begin, end;
+      while (Pop(_worker, _grain, &begin, &end)) {
+        _task(begin, end, _worker, _user_data);
+      }
+
+      // Own range is empty, so stolen indices can be stored there, where
+      // they can be stolen again.
+      bool stolen = false;
+      for (int i = 1; i < num_workers && !stolen; ++i) {
+        stolen = Steal((_worker + i) % num_workers, _grain, &begin, &end);
+      }
+      if (!stolen) {
+        return;
+      }
+      ranges[_worker].value.store(PackRange(begin, end),
+                                  std::memory_order_release);
+    }
+  }
+
+  // Pool thread main loop.
+  void ThreadMain(int _worker) {
+    current_pool = this;
+    current_worker = _worker;
+    uint64_t generation_done = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+      wake.wait(lock, [&] {
+        return exit || (task && generation != generation_done);
+      });
+      if (exit) {
+        return;
+      }
+      generation_done = generation;
+      const Task loop_task = task;
+      void* const loop_user_data = user_data;
+      const int loop_grain = grain;
+      ++active;
+      lock.unlock();
+
+      Work(_worker, loop_task, loop_user_data, loop_grain);
+
+      lock.lock();
+      if (--active == 0) {
+        done.notify_all();
+      }
+    }
+  }
+
+  // Workers ranges, indexed by worker.
+  ozz::vector<Range> ranges;
+
+  // Pool threads, which are workers 1 to n.
+  ozz::vector<std::thread> threads;
+
+  // Serializes ParallelFor calls from different threads.
+  std::mutex submit_mutex;
+
+  // Protects below loop states.
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+
+  // Current loop, task is nullptr when no loop is running.
+  Task task = nullptr;
+  void* user_data = nullptr;
+  int grain = 1;
+
+  // Incremented for every loop, so threads join each loop once.
+  uint64_t generation = 0;
+
+  // Number of threads working on the current loop.
+  int active = 0;
+
+  // Requests threads to exit.
+  bool exit = false;
+
+  // Pool and worker of the current thread, used to detect nested loops.
+  static thread_local Impl* current_pool;
+  static thread_local int current_worker;
+};
+
+thread_local ThreadPoolScheduler::Impl*
+    ThreadPoolScheduler::Impl::current_pool = nullptr;
+thread_local int ThreadPoolScheduler::Impl::current_worker = 0;
+
+ThreadPoolScheduler::ThreadPoolScheduler(int _num_threads)
+    : impl_(nullptr) {
+  if (_num_threads < 0) {
+    _num_threads = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+    _num_threads = _num_threads < 0 ? 0 : _num_threads;
+  }
+  impl_ = New<Impl>(_num_threads + 1);
+  impl_->threads.reserve(_num_threads);
+  for (int i = 0; i < _num_threads; ++i) {
+    impl_->threads.emplace_back(&Impl::ThreadMain, impl_, i + 1);
+  }
+}
+
+ThreadPoolScheduler::~ThreadPoolScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->exit = true;
+  }
+  impl_->wake.notify_all();
+  for (std::thread& thread : impl_->threads) {
+    thread.join();
+  }
+  Delete(impl_);
+}
+
+int ThreadPoolScheduler::num_workers() const {
+  return static_cast<int>(impl_->ranges.size());
+}
+
+void ThreadPoolScheduler::ParallelFor(int _count, int _grain_size, Task _task,
+                                      void* _user_data) {
+  if (_count <= 0) {
+    return;
+  }
+  const int grain = _grain_size > 1 ? _grain_size : 1;
+
+  // Nested loops run serially on the calling worker, which guarantees worker
+  // uniqueness. So do small loops.
+  if (Impl::current_pool == impl_) {
+    _task(0, _count, Impl::current_worker, _user_data);
+    return;
+  }
+  if (impl_->threads.empty() || _count <= grain) {
+    std::lock_guard<std::mutex> submit_lock(impl_->submit_mutex);
+    _task(0, _count, 0, _user_data);
+    return;
+  }
+
+  std::lock_guard<std::mutex> submit_lock(impl_->submit_mutex);
+
+  // Distributes indices evenly to all workers.
+  const int num_workers = static_cast<int>(impl_->ranges.size());
+  for (int i = 0; i < num_workers; ++i) {
+    const int begin = static_cast<int>(int64_t(_count) * i / num_workers);
+    const int end = static_cast<int>(int64_t(_count) * (i + 1) / num_workers);
+    impl_->ranges[i].value.store(PackRange(begin, end),
+                                 std::memory_order_relaxed);
+  }
+
+  // Wakes up pool threads.
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->task = _task;
+    impl_->user_data = _user_data;
+    impl_->grain = grain;
+    ++impl_->generation;
+  }
+  impl_->wake.notify_all();
+
+  // Calling thread is worker 0. It might itself be a worker of another pool.
+  Impl* const previous_pool = Impl::current_pool;
+  const int previous_worker = Impl::current_worker;
+  Impl::current_pool = impl_;
+  Impl::current_worker = 0;
+  impl_->Work(0, _task, _user_data, grain);
+  Impl::current_pool = previous_pool;
+  Impl::current_worker = previous_worker;
+
+  // All indices are claimed, waits for threads to complete.
+  std::unique_lock<std::mutex> lock(impl_->mutex);
+  impl_->task = nullptr;
+  impl_->done.wait(lock, [this] { return impl_->active == 0; });
+}
+}  // namespace ozz
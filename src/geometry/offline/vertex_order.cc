@@ -0,0 +1,71 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/geometry/offline/vertex_order.h"
+
+#include <algorithm>
+
+#include "ozz/base/containers/vector.h"
+
+namespace ozz {
+namespace geometry {
+namespace offline {
+
+bool ComputeJointSetOrder(span<const uint16_t> _joint_indices,
+                          int _influences_count, span<uint32_t> _order) {
+  if (_influences_count <= 0) {
+    return false;
+  }
+  const size_t influences = static_cast<size_t>(_influences_count);
+  const size_t vertex_count = _order.size();
+  if (_joint_indices.size() != vertex_count * influences) {
+    return false;
+  }
+
+  // Builds sort keys, which are vertices joint indices sorted in ascending
+  // order.
+  ozz::vector<uint16_t> keys(_joint_indices.begin(), _joint_indices.end());
+  for (size_t i = 0; i < keys.size(); i += influences) {
+    std::sort(keys.begin() + i, keys.begin() + i + influences);
+  }
+
+  // Sorts vertices by joint set.
+  for (size_t i = 0; i < vertex_count; ++i) {
+    _order[i] = static_cast<uint32_t>(i);
+  }
+  const uint16_t* key = keys.data();
+  std::stable_sort(_order.begin(), _order.end(),
+                   [key, influences](uint32_t _a, uint32_t _b) {
+                     return std::lexicographical_compare(
+                         key + _a * influences, key + (_a + 1) * influences,
+                         key + _b * influences, key + (_b + 1) * influences);
+                   });
+  return true;
+}
+}  // namespace offline
+}  // namespace geometry
+}  // namespace ozz
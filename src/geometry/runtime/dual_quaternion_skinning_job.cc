@@ -0,0 +1,257 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/geometry/runtime/dual_quaternion_skinning_job.h"
+
+#include <cassert>
+
+#include "ozz/base/maths/dual_quaternion.h"
+#include "ozz/base/maths/simd_math.h"
+
+namespace ozz {
+namespace geometry {
+
+DualQuaternionSkinningJob::DualQuaternionSkinningJob()
+    : vertex_count(0),
+      influences_count(0),
+      joint_indices_stride(0),
+      joint_weights_stride(0),
+      in_positions_stride(0),
+      in_normals_stride(0),
+      in_tangents_stride(0),
+      out_positions_stride(0),
+      out_normals_stride(0),
+      out_tangents_stride(0) {}
+
+bool DualQuaternionSkinningJob::Validate() const {
+  // Start validation of all parameters.
+  bool valid = true;
+
+  // Checks influences bounds.
+  valid &= influences_count > 0;
+
+  // Checks joints dual quaternions, required.
+  valid &= !joint_dual_quaternions.empty();
+
+  // Prepares local variables used to compute buffer size.
+  const int vertex_count_minus_1 = vertex_count > 0 ? vertex_count - 1 : 0;
+  const int vertex_count_at_least_1 = vertex_count > 0;
+
+  // Checks indices, required.
+  valid &= joint_indices.size_bytes() >=
+           joint_indices_stride * vertex_count_minus_1 +
+               sizeof(uint16_t) * influences_count * vertex_count_at_least_1;
+
+  // Checks weights, required if influences_count > 1.
+  if (influences_count != 1) {
+    valid &=
+        joint_weights.size_bytes() >=
+        joint_weights_stride * vertex_count_minus_1 +
+            sizeof(float) * (influences_count - 1) * vertex_count_at_least_1;
+  }
+
+  // Checks positions, mandatory.
+  valid &= in_positions.size_bytes() >=
+           in_positions_stride * vertex_count_minus_1 +
+               sizeof(float) * 3 * vertex_count_at_least_1;
+  valid &= !out_positions.empty();
+  valid &= out_positions.size_bytes() >=
+           out_positions_stride * vertex_count_minus_1 +
+               sizeof(float) * 3 * vertex_count_at_least_1;
+
+  // Checks normals, optional.
+  if (!in_normals.empty()) {
+    valid &= in_normals.size_bytes() >=
+             in_normals_stride * vertex_count_minus_1 +
+                 sizeof(float) * 3 * vertex_count_at_least_1;
+    valid &= !out_normals.empty();
+    valid &= out_normals.size_bytes() >=
+             out_normals_stride * vertex_count_minus_1 +
+                 sizeof(float) * 3 * vertex_count_at_least_1;
+
+    // Checks tangents, optional but requires normals.
+    if (!in_tangents.empty()) {
+      valid &= in_tangents.size_bytes() >=
+               in_tangents_stride * vertex_count_minus_1 +
+                   sizeof(float) * 3 * vertex_count_at_least_1;
+      valid &= !out_tangents.empty();
+      valid &= out_tangents.size_bytes() >=
+               out_tangents_stride * vertex_count_minus_1 +
+                   sizeof(float) * 3 * vertex_count_at_least_1;
+    }
+  } else {
+    // Tangents are not supported if normals are not there.
+    valid &= in_tangents.empty();
+  }
+
+  return valid;
+}
+
+namespace {
+
+// Loads real and dual parts of joint _index dual quaternion.
+OZZ_INLINE void LoadDualQuaternion(const DualQuaternionSkinningJob& _job,
+                                   uint16_t _index, math::SimdFloat4* _real,
+                                   math::SimdFloat4* _dual) {
+  assert(_index < _job.joint_dual_quaternions.size() &&
+         "Joint index out of range.");
+  const math::DualQuaternion& dq = _job.joint_dual_quaternions[_index];
+  *_real = math::simd_float4::LoadPtrU(&dq.real.x);
+  *_dual = math::simd_float4::LoadPtrU(&dq.dual.x);
+}
+
+// Rotates vector _v by unit quaternion _q.
+// _v + 2 * cross(_q.xyz, cross(_q.xyz, _v) + _q.w * _v)
+OZZ_INLINE math::SimdFloat4 Rotate(math::SimdFloat4 _q, math::SimdFloat4 _v) {
+  const math::SimdFloat4 a =
+      math::MAdd(math::SplatW(_q), _v, math::Cross3(_q, _v));
+  const math::SimdFloat4 b = math::Cross3(_q, a);
+  return _v + b + b;
+}
+}  // namespace
+
+// Implements job Run function.
+// Per vertex dual quaternions are blended with a weighted sum, whose real part
+// sign is aligned with the first influence one, as q and -q represent the same
+// rotation. The sum is then normalized by the norm of its real part (dual
+// quaternion linear blending, aka DLB).
+bool DualQuaternionSkinningJob::Run() const {
+  // Exit with an error if job is invalid.
+  if (!Validate()) {
+    return false;
+  }
+
+  const bool normals = !in_normals.empty();
+  const bool tangents = !in_tangents.empty();
+  const int num_weights = influences_count - 1;
+
+  const byte* indices = as_bytes(joint_indices).data();
+  const byte* weights = as_bytes(joint_weights).data();
+  const byte* in_p = as_bytes(in_positions).data();
+  const byte* in_n = as_bytes(in_normals).data();
+  const byte* in_t = as_bytes(in_tangents).data();
+  byte* out_p = as_writable_bytes(out_positions).data();
+  byte* out_n = as_writable_bytes(out_normals).data();
+  byte* out_t = as_writable_bytes(out_tangents).data();
+
+  const math::SimdFloat4 one = math::simd_float4::one();
+
+  for (int i = 0; i < vertex_count; ++i) {
+    const uint16_t* vindices = reinterpret_cast<const uint16_t*>(indices);
+    const float* vweights = reinterpret_cast<const float*>(weights);
+
+    // Blends dual quaternions.
+    math::SimdFloat4 real, dual;
+    if (num_weights == 0) {
+      LoadDualQuaternion(*this, vindices[0], &real, &dual);
+    } else {
+      math::SimdFloat4 pivot, pivot_dual;
+      LoadDualQuaternion(*this, vindices[0], &pivot, &pivot_dual);
+      math::SimdFloat4 w = math::simd_float4::Load1(vweights[0]);
+      math::SimdFloat4 wsum = w;
+      real = pivot * w;
+      dual = pivot_dual * w;
+      for (int j = 1; j < influences_count; ++j) {
+        math::SimdFloat4 r, d;
+        LoadDualQuaternion(*this, vindices[j], &r, &d);
+        if (j < num_weights) {
+          w = math::simd_float4::Load1(vweights[j]);
+          wsum = wsum + w;
+        } else {
+          // Last weight is restored from the others.
+          w = one - wsum;
+        }
+        // Flips weight sign if r is in the opposite hemisphere of pivot.
+        const math::SimdFloat4 sw =
+            math::Xor(w, math::Sign(math::SplatX(math::Dot4(pivot, r))));
+        real = math::MAdd(r, sw, real);
+        dual = math::MAdd(d, sw, dual);
+      }
+    }
+
+    // Normalizes blended dual quaternion.
+    const math::SimdFloat4 rlen =
+        one / math::SplatX(math::Sqrt(math::Dot4(real, real)));
+    real = real * rlen;
+    dual = dual * rlen;
+
+    // Extracts translation: 2 * (r.w * d.xyz - d.w * r.xyz + cross(r, d)).
+    const math::SimdFloat4 t =
+        math::MAdd(math::SplatW(real), dual,
+                   math::NMAdd(math::SplatW(dual), real,
+                               math::Cross3(real, dual)));
+
+    // Transforms position.
+    const math::SimdFloat4 p = math::simd_float4::Load3PtrU(
+        reinterpret_cast<const float*>(in_p));
+    math::Store3PtrU(Rotate(real, p) + t + t, reinterpret_cast<float*>(out_p));
+
+    // Normals and tangents are only rotated.
+    if (normals) {
+      const math::SimdFloat4 n = math::simd_float4::Load3PtrU(
+          reinterpret_cast<const float*>(in_n));
+      math::Store3PtrU(Rotate(real, n), reinterpret_cast<float*>(out_n));
+      in_n += in_normals_stride;
+      out_n += out_normals_stride;
+
+      if (tangents) {
+        const math::SimdFloat4 tg = math::simd_float4::Load3PtrU(
+            reinterpret_cast<const float*>(in_t));
+        math::Store3PtrU(Rotate(real, tg), reinterpret_cast<float*>(out_t));
+        in_t += in_tangents_stride;
+        out_t += out_tangents_stride;
+      }
+    }
+
+    indices += joint_indices_stride;
+    weights += joint_weights_stride;
+    in_p += in_positions_stride;
+    out_p += out_positions_stride;
+  }
+
+  return true;
+}
+
+bool ToDualQuaternions(span<const math::Float4x4> _matrices,
+                       span<math::DualQuaternion> _dual_quaternions) {
+  if (_dual_quaternions.size() < _matrices.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < _matrices.size(); ++i) {
+    math::Float3 translation, scale;
+    math::Quaternion rotation;
+    if (math::ToAffine(_matrices[i], &translation, &rotation, &scale)) {
+      _dual_quaternions[i] = math::DualQuaternion::FromAffine(
+          translation, math::Normalize(rotation));
+    } else {
+      _dual_quaternions[i] = math::DualQuaternion::identity();
+    }
+  }
+  return true;
+}
+}  // namespace geometry
+}  // namespace ozz
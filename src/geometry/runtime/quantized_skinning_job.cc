@@ -0,0 +1,465 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/geometry/runtime/quantized_skinning_job.h"
+
+#include <cassert>
+
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/geometry/runtime/skinning_job.h"
+
+namespace ozz {
+namespace geometry {
+
+QuantizedSkinningJob::QuantizedSkinningJob()
+    : vertex_count(0),
+      influences_count(0),
+      joint_indices_stride(0),
+      joint_indices_format(kIndexUInt16),
+      joint_weights_stride(0),
+      joint_weights_format(kWeightFloat),
+      in_positions_stride(0),
+      in_positions_format(kAttributeFloat),
+      in_positions_scale(math::Float3::one()),
+      in_positions_offset(math::Float3::zero()),
+      in_normals_stride(0),
+      in_normals_format(kAttributeFloat),
+      in_tangents_stride(0),
+      in_tangents_format(kAttributeFloat),
+      out_positions_stride(0),
+      out_normals_stride(0),
+      out_tangents_stride(0) {}
+
+namespace {
+
+typedef QuantizedSkinningJob Job;
+
+size_t IndexSize(Job::IndexFormat _format) {
+  return _format == Job::kIndexUInt8 ? sizeof(uint8_t) : sizeof(uint16_t);
+}
+
+size_t WeightSize(Job::WeightFormat _format) {
+  switch (_format) {
+    case Job::kWeightUNorm8:
+      return sizeof(uint8_t);
+    case Job::kWeightUNorm16:
+      return sizeof(uint16_t);
+    default:
+      return sizeof(float);
+  }
+}
+
+size_t AttributeSize(Job::AttributeFormat _format) {
+  return _format == Job::kAttributeFloat ? sizeof(float) : sizeof(uint16_t);
+}
+
+// Validates a buffer of _vertex_count elements of _count components, whose
+// size is _size bytes.
+bool ValidateBuffer(span<const byte> _buffer, size_t _stride, int _vertex_count,
+                    size_t _size, int _count) {
+  // Prepares local variables used to compute buffer size.
+  const int vertex_count_minus_1 = _vertex_count > 0 ? _vertex_count - 1 : 0;
+  const int vertex_count_at_least_1 = _vertex_count > 0;
+
+  bool valid = true;
+  valid &= _buffer.size_bytes() >= _stride * vertex_count_minus_1 +
+                                       _size * _count * vertex_count_at_least_1;
+  valid &= IsAligned(_buffer.data(), _size);
+  valid &= IsAligned(_stride, _size);
+  return valid;
+}
+
+bool ValidateBuffer(span<float> _buffer, size_t _stride, int _vertex_count) {
+  return ValidateBuffer(as_bytes(_buffer), _stride, _vertex_count,
+                        sizeof(float), 3);
+}
+}  // namespace
+
+bool QuantizedSkinningJob::Validate() const {
+  // Start validation of all parameters.
+  bool valid = true;
+
+  // Checks influences bounds.
+  valid &= influences_count > 0 && influences_count <= kMaxInfluences;
+
+  // Checks joints matrices, required.
+  valid &= !joint_matrices.empty();
+
+  // Checks indices, required.
+  valid &=
+      ValidateBuffer(joint_indices, joint_indices_stride, vertex_count,
+                     IndexSize(joint_indices_format), influences_count);
+
+  // Checks weights, required if influences_count > 1.
+  if (influences_count != 1) {
+    valid &=
+        ValidateBuffer(joint_weights, joint_weights_stride, vertex_count,
+                       WeightSize(joint_weights_format), influences_count - 1);
+  }
+
+  // Checks positions, mandatory.
+  valid &= !in_positions.empty();
+  valid &= ValidateBuffer(in_positions, in_positions_stride, vertex_count,
+                          AttributeSize(in_positions_format), 3);
+  valid &= !out_positions.empty();
+  valid &= ValidateBuffer(out_positions, out_positions_stride, vertex_count);
+
+  // Checks normals, optional.
+  if (!in_normals.empty()) {
+    valid &= ValidateBuffer(in_normals, in_normals_stride, vertex_count,
+                            AttributeSize(in_normals_format), 3);
+    valid &= !out_normals.empty();
+    valid &= ValidateBuffer(out_normals, out_normals_stride, vertex_count);
+
+    // Checks tangents, optional but requires normals.
+    if (!in_tangents.empty()) {
+      valid &= ValidateBuffer(in_tangents, in_tangents_stride, vertex_count,
+                              AttributeSize(in_tangents_format), 3);
+      valid &= !out_tangents.empty();
+      valid &= ValidateBuffer(out_tangents, out_tangents_stride, vertex_count);
+    }
+  } else {
+    // Tangents are not supported if normals are not there.
+    valid &= in_tangents.empty();
+  }
+
+  return valid;
+}
+
+namespace {
+
+// Number of vertices decoded and skinned per block. Decoded data of a block
+// remains in L1 cache, so uncompressed inputs never need to be stored to
+// memory.
+const int kBlockSize = 64;
+
+// Maximum number of decoded indices (or weights) per block. This number drives
+// the number of vertices per block, according to the number of influences.
+const int kBlockInfluences = kBlockSize * 4;
+static_assert(kBlockInfluences >= QuantizedSkinningJob::kMaxInfluences,
+              "Decoding buffers must fit at least one vertex");
+
+// Decodes 3 components half attributes.
+struct HalfDecoder {
+  OZZ_INLINE math::SimdFloat4 operator()(const byte* _src) const {
+    const uint16_t* h = reinterpret_cast<const uint16_t*>(_src);
+    return math::HalfToFloat(math::simd_int4::Load(h[0], h[1], h[2], 0));
+  }
+};
+
+// Decodes 3 components snorm16 attributes. -32768 maps to a value slightly
+// lower than -1, so it's clamped.
+struct SNorm16Decoder {
+  OZZ_INLINE math::SimdFloat4 operator()(const byte* _src) const {
+    const int16_t* s = reinterpret_cast<const int16_t*>(_src);
+    const math::SimdFloat4 f = math::simd_float4::FromInt(
+        math::simd_int4::Load(s[0], s[1], s[2], 0));
+    return math::Max(f * scale, minus_one);
+  }
+  const math::SimdFloat4 scale = math::simd_float4::Load1(1.f / 32767.f);
+  const math::SimdFloat4 minus_one = math::simd_float4::Load1(-1.f);
+};
+
+// Decodes 3 components float attributes.
+struct FloatDecoder {
+  OZZ_INLINE math::SimdFloat4 operator()(const byte* _src) const {
+    return math::simd_float4::Load3PtrU(reinterpret_cast<const float*>(_src));
+  }
+};
+
+// Scales and offsets values decoded by _Decoder.
+template <typename _Decoder>
+struct ScaledDecoder {
+  OZZ_INLINE math::SimdFloat4 operator()(const byte* _src) const {
+    return decoder(_src) * scale + offset;
+  }
+  _Decoder decoder;
+  math::SimdFloat4 scale;
+  math::SimdFloat4 offset;
+};
+
+// Decodes _count attributes from _src to _dest, packed as 3 floats per
+// attribute. _dest must be able to store _count * 3 + 1 floats, as the 4th
+// component of each attribute is written (and overwritten by the next one).
+template <typename _Decoder>
+void DecodeAttributes(const byte* _src, size_t _stride, int _count,
+                      const _Decoder& _decoder, float* _dest) {
+  for (int i = 0; i < _count; ++i, _src += _stride, _dest += 3) {
+    math::StorePtrU(_decoder(_src), _dest);
+  }
+}
+
+// Decodes _count attributes stored with _format from _src to _dest.
+void DecodeAttributes(const byte* _src, size_t _stride, int _count,
+                      Job::AttributeFormat _format, float* _dest) {
+  switch (_format) {
+    case Job::kAttributeHalf: {
+      DecodeAttributes(_src, _stride, _count, HalfDecoder(), _dest);
+      break;
+    }
+    case Job::kAttributeSNorm16: {
+      DecodeAttributes(_src, _stride, _count, SNorm16Decoder(), _dest);
+      break;
+    }
+    default: {
+      DecodeAttributes(_src, _stride, _count, FloatDecoder(), _dest);
+      break;
+    }
+  }
+}
+
+// Decodes _count positions from _src to _dest, applying job's positions scale
+// and offset.
+template <typename _Decoder>
+void DecodePositions(const byte* _src, size_t _stride, int _count,
+                     const Job& _job, float* _dest) {
+  const ScaledDecoder<_Decoder> decoder = {
+      _Decoder(), math::simd_float4::Load3PtrU(&_job.in_positions_scale.x),
+      math::simd_float4::Load3PtrU(&_job.in_positions_offset.x)};
+  DecodeAttributes(_src, _stride, _count, decoder, _dest);
+}
+
+void DecodePositions(const byte* _src, size_t _stride, int _count,
+                     const Job& _job, float* _dest) {
+  switch (_job.in_positions_format) {
+    case Job::kAttributeHalf: {
+      DecodePositions<HalfDecoder>(_src, _stride, _count, _job, _dest);
+      break;
+    }
+    case Job::kAttributeSNorm16: {
+      DecodePositions<SNorm16Decoder>(_src, _stride, _count, _job, _dest);
+      break;
+    }
+    default: {
+      DecodePositions<FloatDecoder>(_src, _stride, _count, _job, _dest);
+      break;
+    }
+  }
+}
+
+// Decodes _count vertices of _num normalized weights of type _Ty, from _src to
+// _dest, packed as _num floats per vertex. Weights are decoded 4 by 4, so _dest
+// must be able to store 3 more floats.
+template <typename _Ty>
+void DecodeWeights(const byte* _src, size_t _stride, int _count, int _num,
+                   float* _dest) {
+  // Packed weights are decoded as a single vertex.
+  if (_stride == sizeof(_Ty) * _num) {
+    _num *= _count;
+    _count = 1;
+  }
+  const math::SimdFloat4 scale =
+      math::simd_float4::Load1(1.f / static_cast<_Ty>(~_Ty(0)));
+  for (int i = 0; i < _count; ++i, _src += _stride, _dest += _num) {
+    const _Ty* weights = reinterpret_cast<const _Ty*>(_src);
+    for (int j = 0; j < _num; j += 4) {
+      const int left = _num - j;
+      const math::SimdInt4 w = math::simd_int4::Load(
+          weights[j], left > 1 ? weights[j + 1] : 0,
+          left > 2 ? weights[j + 2] : 0, left > 3 ? weights[j + 3] : 0);
+      math::StorePtrU(math::simd_float4::FromInt(w) * scale, _dest + j);
+    }
+  }
+}
+
+// Decodes _count vertices of _num uint8_t indices, from _src to _dest, packed
+// as _num uint16_t per vertex.
+void DecodeIndices(const byte* _src, size_t _stride, int _count, int _num,
+                   uint16_t* _dest) {
+  // Packed indices are decoded as a single vertex.
+  if (_stride == sizeof(uint8_t) * _num) {
+    _num *= _count;
+    _count = 1;
+  }
+  for (int i = 0; i < _count; ++i, _src += _stride, _dest += _num) {
+    for (int j = 0; j < _num; ++j) {
+      _dest[j] = _src[j];
+    }
+  }
+}
+
+// Gets the range of _buffer that contains _count vertices of _size bytes,
+// starting at vertex _begin. _Byte is either byte or const byte.
+template <typename _Ty, typename _Byte>
+span<_Ty> VertexRange(span<_Byte> _buffer, size_t _stride, int _begin,
+                      int _count, size_t _size) {
+  _Byte* begin = _buffer.data() + _stride * _begin;
+  const size_t size = _stride * (_count - 1) + _size;
+  assert(begin + size <= _buffer.end());
+  return {reinterpret_cast<_Ty*>(begin), size / sizeof(_Ty)};
+}
+}  // namespace
+
+// Implements job Run function.
+bool QuantizedSkinningJob::Run() const {
+  // Exit with an error if job is invalid.
+  if (!Validate()) {
+    return false;
+  }
+
+  // Early out if no vertex. This isn't an error.
+  if (vertex_count == 0) {
+    return true;
+  }
+
+  // Decoding buffers.
+  // Float attributes, indices and weights aren't decoded, skinning job uses
+  // them in place.
+  float positions[kBlockSize * 3 + 1];
+  float normals[kBlockSize * 3 + 1];
+  float tangents[kBlockSize * 3 + 1];
+  uint16_t indices[kBlockInfluences];
+  float weights[kBlockInfluences + 3];
+
+  const bool decode_indices = joint_indices_format != kIndexUInt16;
+  const bool decode_weights = joint_weights_format != kWeightFloat;
+  const bool decode_positions =
+      in_positions_format != kAttributeFloat ||
+      in_positions_scale.x != 1.f || in_positions_scale.y != 1.f ||
+      in_positions_scale.z != 1.f || in_positions_offset.x != 0.f ||
+      in_positions_offset.y != 0.f || in_positions_offset.z != 0.f;
+  const bool decode_normals = in_normals_format != kAttributeFloat;
+  const bool decode_tangents = in_tangents_format != kAttributeFloat;
+
+  // Number of vertices per block, so that indices and weights fit in decoding
+  // buffers.
+  const int max_block_size = kBlockInfluences / influences_count;
+  const int block_size =
+      max_block_size < kBlockSize ? max_block_size : kBlockSize;
+  const int num_weights = influences_count - 1;
+
+  // Prepares skinning job parameters that are the same for all blocks.
+  SkinningJob job;
+  job.influences_count = influences_count;
+  job.joint_matrices = joint_matrices;
+  job.joint_inverse_transpose_matrices = joint_inverse_transpose_matrices;
+  job.out_positions_stride = out_positions_stride;
+  job.out_normals_stride = out_normals_stride;
+  job.out_tangents_stride = out_tangents_stride;
+
+  for (int begin = 0; begin < vertex_count; begin += block_size) {
+    const int count =
+        vertex_count - begin < block_size ? vertex_count - begin : block_size;
+    job.vertex_count = count;
+
+    // Indices.
+    if (decode_indices) {
+      DecodeIndices(joint_indices.data() + joint_indices_stride * begin,
+                    joint_indices_stride, count, influences_count, indices);
+      job.joint_indices = {indices, static_cast<size_t>(count) *
+                                        influences_count};
+      job.joint_indices_stride = sizeof(uint16_t) * influences_count;
+    } else {
+      job.joint_indices = VertexRange<const uint16_t>(
+          joint_indices, joint_indices_stride, begin, count,
+          sizeof(uint16_t) * influences_count);
+      job.joint_indices_stride = joint_indices_stride;
+    }
+
+    // Weights.
+    if (num_weights > 0) {
+      if (decode_weights) {
+        const byte* src = joint_weights.data() + joint_weights_stride * begin;
+        if (joint_weights_format == kWeightUNorm8) {
+          DecodeWeights<uint8_t>(src, joint_weights_stride, count,
+                                 num_weights, weights);
+        } else {
+          DecodeWeights<uint16_t>(src, joint_weights_stride, count,
+                                  num_weights, weights);
+        }
+        job.joint_weights = {weights,
+                             static_cast<size_t>(count) * num_weights};
+        job.joint_weights_stride = sizeof(float) * num_weights;
+      } else {
+        job.joint_weights = VertexRange<const float>(
+            joint_weights, joint_weights_stride, begin, count,
+            sizeof(float) * num_weights);
+        job.joint_weights_stride = joint_weights_stride;
+      }
+    }
+
+    // Positions.
+    if (decode_positions) {
+      DecodePositions(in_positions.data() + in_positions_stride * begin,
+                      in_positions_stride, count, *this, positions);
+      job.in_positions = {positions, static_cast<size_t>(count) * 3};
+      job.in_positions_stride = sizeof(float) * 3;
+    } else {
+      job.in_positions = VertexRange<const float>(
+          in_positions, in_positions_stride, begin, count, sizeof(float) * 3);
+      job.in_positions_stride = in_positions_stride;
+    }
+    job.out_positions = VertexRange<float>(as_writable_bytes(out_positions),
+                                           out_positions_stride, begin, count,
+                                           sizeof(float) * 3);
+
+    // Normals.
+    if (!in_normals.empty()) {
+      if (decode_normals) {
+        DecodeAttributes(in_normals.data() + in_normals_stride * begin,
+                         in_normals_stride, count, in_normals_format,
+                         normals);
+        job.in_normals = {normals, static_cast<size_t>(count) * 3};
+        job.in_normals_stride = sizeof(float) * 3;
+      } else {
+        job.in_normals = VertexRange<const float>(
+            in_normals, in_normals_stride, begin, count, sizeof(float) * 3);
+        job.in_normals_stride = in_normals_stride;
+      }
+      job.out_normals =
+          VertexRange<float>(as_writable_bytes(out_normals), out_normals_stride,
+                             begin, count, sizeof(float) * 3);
+    }
+
+    // Tangents.
+    if (!in_tangents.empty()) {
+      if (decode_tangents) {
+        DecodeAttributes(in_tangents.data() + in_tangents_stride * begin,
+                         in_tangents_stride, count, in_tangents_format,
+                         tangents);
+        job.in_tangents = {tangents, static_cast<size_t>(count) * 3};
+        job.in_tangents_stride = sizeof(float) * 3;
+      } else {
+        job.in_tangents = VertexRange<const float>(
+            in_tangents, in_tangents_stride, begin, count, sizeof(float) * 3);
+        job.in_tangents_stride = in_tangents_stride;
+      }
+      job.out_tangents = VertexRange<float>(as_writable_bytes(out_tangents),
+                                            out_tangents_stride, begin, count,
+                                            sizeof(float) * 3);
+    }
+
+    // Skins the block. Cannot fail because job is valid.
+    const bool success = job.Run();
+    assert(success);
+    (void)success;
+  }
+
+  return true;
+}
+}  // namespace geometry
+}  // namespace ozz
@@ -27,9 +27,11 @@
 
 #include "ozz/geometry/runtime/skinning_job.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "ozz/base/maths/simd_math.h"
+#include "ozz/base/scheduler.h"
 
 namespace ozz {
 namespace geometry {
@@ -44,7 +46,9 @@ SkinningJob::SkinningJob()
       in_tangents_stride(0),
       out_positions_stride(0),
       out_normals_stride(0),
-      out_tangents_stride(0) {}
+      out_tangents_stride(0),
+      scheduler(nullptr),
+      grain_size(1024) {}
 
 bool SkinningJob::Validate() const {
   // Start validation of all parameters.
@@ -53,6 +57,9 @@ bool SkinningJob::Validate() const {
   // Checks influences bounds.
   valid &= influences_count > 0;
 
+  // Checks grain size.
+  valid &= grain_size > 0;
+
   // Checks joints matrices, required.
   valid &= !joint_matrices.empty();
 
@@ -467,6 +474,41 @@ static const SkiningFct kSkinningFct[2][5][3] = {
          &SKINNING_FN_NAME(PNT, IT, N)},
     }};
 
+namespace {
+// Offsets _span begin to vertex _begin, for a vertex _stride in bytes. Empty
+// spans remain empty.
+template <typename _Ty>
+span<_Ty> OffsetVertices(const span<_Ty>& _span, size_t _stride, int _begin) {
+  if (_span.empty()) {
+    return _span;
+  }
+  return {PointerStride(_span.begin(), _stride * _begin), _span.end()};
+}
+
+// Builds a job that skins _count vertices of _job, starting at vertex _begin.
+SkinningJob MakeChunkJob(const SkinningJob& _job, int _begin, int _count) {
+  SkinningJob chunk = _job;
+  chunk.vertex_count = _count;
+  chunk.joint_indices =
+      OffsetVertices(_job.joint_indices, _job.joint_indices_stride, _begin);
+  chunk.joint_weights =
+      OffsetVertices(_job.joint_weights, _job.joint_weights_stride, _begin);
+  chunk.in_positions =
+      OffsetVertices(_job.in_positions, _job.in_positions_stride, _begin);
+  chunk.in_normals =
+      OffsetVertices(_job.in_normals, _job.in_normals_stride, _begin);
+  chunk.in_tangents =
+      OffsetVertices(_job.in_tangents, _job.in_tangents_stride, _begin);
+  chunk.out_positions =
+      OffsetVertices(_job.out_positions, _job.out_positions_stride, _begin);
+  chunk.out_normals =
+      OffsetVertices(_job.out_normals, _job.out_normals_stride, _begin);
+  chunk.out_tangents =
+      OffsetVertices(_job.out_tangents, _job.out_tangents_stride, _begin);
+  return chunk;
+}
+}  // namespace
+
 // Implements job Run function.
 bool SkinningJob::Run() const {
   // Exit with an error if job is invalid.
@@ -491,8 +533,23 @@ bool SkinningJob::Run() const {
   const size_t fct = !in_normals.empty() + !in_tangents.empty();
   assert(fct < OZZ_ARRAY_SIZE(kSkinningFct[0][0]));
 
-  // Calls skinning function. Cannot fail because job is valid.
-  kSkinningFct[it][inf][fct](*this);
+  const SkiningFct fn = kSkinningFct[it][inf][fct];
+
+  // Skins all vertices at once if there's no scheduler.
+  if (!scheduler || vertex_count <= grain_size) {
+    // Calls skinning function. Cannot fail because job is valid.
+    fn(*this);
+    return true;
+  }
+
+  // Otherwise splits vertices in chunks of grain_size vertices, dispatched to
+  // the scheduler.
+  const int chunks = (vertex_count + grain_size - 1) / grain_size;
+  ParallelFor(scheduler, chunks, 1, [&](int _begin, int _end, int) {
+    const int begin = _begin * grain_size;
+    const int end = std::min(_end * grain_size, vertex_count);
+    fn(MakeChunkJob(*this, begin, end - begin));
+  });
 
   return true;
 }
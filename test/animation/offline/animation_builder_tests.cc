@@ -28,6 +28,9 @@
 #include "gtest/gtest.h"
 #include "ozz/animation/offline/animation_builder.h"
 #include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/raw_animation_utils.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/skeleton_builder.h"
 #include "ozz/animation/runtime/animation.h"
 #include "ozz/animation/runtime/sampling_job.h"
 #include "ozz/animation/runtime/skeleton.h"
@@ -36,8 +39,11 @@
 #include "ozz/base/memory/unique_ptr.h"
 
 using ozz::animation::Animation;
+using ozz::animation::Skeleton;
 using ozz::animation::offline::AnimationBuilder;
 using ozz::animation::offline::RawAnimation;
+using ozz::animation::offline::RawSkeleton;
+using ozz::animation::offline::SkeletonBuilder;
 
 TEST(Error, AnimationBuilder) {
   // Instantiates a builder objects with default parameters.
@@ -383,6 +389,332 @@ TEST(Sort, AnimationBuilder) {
   }
 }
 
+TEST(Constants, AnimationBuilder) {
+  RawAnimation raw_animation;
+  raw_animation.duration = 1.f;
+  raw_animation.tracks.resize(10);
+
+  // First soa track translations are constant, with a single key or identical
+  // keys.
+  for (int i = 0; i < 4; ++i) {
+    const RawAnimation::TranslationKey key = {
+        .5f, ozz::math::Float3(i * 1.f, 2.f, 3.f)};
+    raw_animation.tracks[i].translations.push_back(key);
+    if (i & 1) {
+      const RawAnimation::TranslationKey same = {.8f, key.value};
+      raw_animation.tracks[i].translations.push_back(same);
+    }
+  }
+
+  // Second soa track translations are animated by track 5.
+  const RawAnimation::TranslationKey t_key0 = {
+      .2f, ozz::math::Float3(0.f, 0.f, 0.f)};
+  raw_animation.tracks[5].translations.push_back(t_key0);
+  const RawAnimation::TranslationKey t_key1 = {
+      .6f, ozz::math::Float3(4.f, 0.f, 0.f)};
+  raw_animation.tracks[5].translations.push_back(t_key1);
+
+  // Third soa track is only made of a partially filled constant track.
+  const RawAnimation::ScaleKey s_key = {0.f, ozz::math::Float3(2.f, 2.f, 2.f)};
+  raw_animation.tracks[9].scales.push_back(s_key);
+
+  AnimationBuilder builder;
+  ozz::unique_ptr<Animation> animation(builder(raw_animation));
+  ASSERT_TRUE(animation);
+
+  // Animated soa tracks are remapped first.
+  ASSERT_EQ(animation->translations_soa_tracks().size(), 3u);
+  EXPECT_EQ(animation->translations_soa_tracks()[0], 1);
+  EXPECT_EQ(animation->translations_soa_tracks()[1], 0);
+  EXPECT_EQ(animation->translations_soa_tracks()[2], 2);
+  EXPECT_EQ(animation->translations_constants().size(), 8u);
+  EXPECT_EQ(animation->translations_values().size(), 10u);
+
+  // All rotations are constant.
+  EXPECT_EQ(animation->rotations_constants().size(), 12u);
+  EXPECT_EQ(animation->rotations_values().size(), 0u);
+
+  // All scales are constant.
+  ASSERT_EQ(animation->scales_soa_tracks().size(), 3u);
+  EXPECT_EQ(animation->scales_soa_tracks()[2], 2);
+  EXPECT_EQ(animation->scales_constants().size(), 12u);
+  EXPECT_EQ(animation->scales_values().size(), 0u);
+
+  // Samples to test the animation.
+  ozz::animation::SamplingJob job;
+  ozz::animation::SamplingJob::Context context(10);
+  ozz::math::SoaTransform output[3];
+  job.animation = animation.get();
+  job.context = &context;
+  job.output = output;
+
+  const float ratios[] = {0.f, .4f, 1.f};
+  const float expected[] = {0.f, 2.f, 4.f};
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(ratios); ++i) {
+    const float x = expected[i];
+    job.ratio = ratios[i];
+    ASSERT_TRUE(job.Run());
+    EXPECT_SOAFLOAT3_EQ_EST(output[0].translation, 0.f, 1.f, 2.f, 3.f, 2.f,
+                            2.f, 2.f, 2.f, 3.f, 3.f, 3.f, 3.f);
+    EXPECT_SOAFLOAT3_EQ_EST(output[1].translation, 0.f, x, 0.f, 0.f,
+                            0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+    EXPECT_SOAQUATERNION_EQ_EST(output[1].rotation, 0.f, 0.f, 0.f, 0.f, 0.f,
+                                0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 1.f, 1.f,
+                                1.f, 1.f);
+    EXPECT_SOAFLOAT3_EQ_EST(output[2].scale, 1.f, 2.f, 1.f, 1.f, 1.f, 2.f, 1.f,
+                            1.f, 1.f, 2.f, 1.f, 1.f);
+  }
+}
+
+TEST(Quantization, AnimationBuilder) {
+  // Prepares a skeleton made of a chain of 8 joints.
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint* joint = &raw_skeleton.roots[0];
+  for (int i = 1; i < 8; ++i) {
+    joint->children.resize(1);
+    joint = &joint->children[0];
+  }
+  SkeletonBuilder skeleton_builder;
+  ozz::unique_ptr<Skeleton> skeleton(skeleton_builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 8);
+
+  RawAnimation raw_animation;
+  raw_animation.duration = 1.f;
+  raw_animation.tracks.resize(8);
+  for (int i = 0; i <= 30; ++i) {
+    const float time = i / 30.f;
+
+    // Root translation range is too big to be quantized.
+    const RawAnimation::TranslationKey root = {
+        time, ozz::math::Float3(10.f * time, 0.f, 0.f)};
+    raw_animation.tracks[0].translations.push_back(root);
+
+    // Second soa track translations and rotations ranges are small.
+    for (int j = 4; j < 8; ++j) {
+      const RawAnimation::TranslationKey translation = {
+          time, ozz::math::Float3(.01f * time * (j - 3), .1f, 0.f)};
+      raw_animation.tracks[j].translations.push_back(translation);
+      const RawAnimation::RotationKey rotation = {
+          time, ozz::math::Quaternion::FromAxisAngle(
+                    ozz::math::Float3::x_axis(), .2f * time * (j - 3))};
+      raw_animation.tracks[j].rotations.push_back(rotation);
+    }
+  }
+
+  AnimationBuilder builder;
+
+  // Skeleton doesn't match animation.
+  {
+    RawAnimation invalid = raw_animation;
+    invalid.tracks.resize(7);
+    EXPECT_FALSE(builder(invalid, *skeleton));
+  }
+
+  // Builds a full precision reference animation.
+  ozz::unique_ptr<Animation> reference(builder(raw_animation));
+  ASSERT_TRUE(reference);
+  EXPECT_EQ(reference->translations_ranges().size(), 0u);
+  EXPECT_EQ(reference->translations_quantized_values().size(), 0u);
+  EXPECT_EQ(reference->rotations_ranges().size(), 0u);
+  EXPECT_EQ(reference->rotations_quantized_values().size(), 0u);
+
+  // Nothing can be quantized with a tiny tolerance.
+  {
+    AnimationBuilder precise_builder;
+    precise_builder.quantization.tolerance = 1e-7f;
+    ozz::unique_ptr<Animation> precise(
+        precise_builder(raw_animation, *skeleton));
+    ASSERT_TRUE(precise);
+    EXPECT_EQ(precise->translations_ranges().size(), 0u);
+    EXPECT_EQ(precise->rotations_ranges().size(), 0u);
+    EXPECT_EQ(precise->size(), reference->size());
+  }
+
+  ozz::unique_ptr<Animation> animation(builder(raw_animation, *skeleton));
+  ASSERT_TRUE(animation);
+  EXPECT_LT(animation->size(), reference->size());
+
+  // Second soa track translations are quantized, after animated ones.
+  EXPECT_EQ(animation->translations_ranges().size(), 1u);
+  EXPECT_EQ(animation->translations_values().size() +
+                animation->translations_quantized_values().size(),
+            reference->translations_values().size());
+  ASSERT_EQ(animation->translations_soa_tracks().size(), 2u);
+  EXPECT_EQ(animation->translations_soa_tracks()[0], 0);
+  EXPECT_EQ(animation->translations_soa_tracks()[1], 1);
+
+  // Second soa track rotations are quantized, before constant ones.
+  EXPECT_EQ(animation->rotations_ranges().size(), 1u);
+  EXPECT_EQ(animation->rotations_values().size(), 0u);
+  EXPECT_EQ(animation->rotations_constants().size(), 4u);
+  ASSERT_EQ(animation->rotations_soa_tracks().size(), 2u);
+  EXPECT_EQ(animation->rotations_soa_tracks()[0], 1);
+  EXPECT_EQ(animation->rotations_soa_tracks()[1], 0);
+
+  // Samples both animations, which must match within tolerance.
+  ozz::animation::SamplingJob job;
+  ozz::animation::SamplingJob::Context context(8);
+  ozz::math::SoaTransform output[2];
+  job.context = &context;
+  job.output = output;
+  ozz::animation::SamplingJob reference_job;
+  ozz::animation::SamplingJob::Context reference_context(8);
+  ozz::math::SoaTransform reference_output[2];
+  reference_job.animation = reference.get();
+  reference_job.context = &reference_context;
+  reference_job.output = reference_output;
+
+  for (float ratio = 0.f; ratio <= 1.f; ratio += .05f) {
+    job.animation = animation.get();
+    job.ratio = ratio;
+    ASSERT_TRUE(job.Run());
+    reference_job.ratio = ratio;
+    ASSERT_TRUE(reference_job.Run());
+
+    for (int i = 0; i < 2; ++i) {
+      const ozz::math::SimdFloat4 values[] = {
+          output[i].translation.x, output[i].translation.y,
+          output[i].translation.z, output[i].rotation.x,
+          output[i].rotation.y,    output[i].rotation.z,
+          output[i].rotation.w};
+      const ozz::math::SimdFloat4 expected[] = {
+          reference_output[i].translation.x,
+          reference_output[i].translation.y,
+          reference_output[i].translation.z,
+          reference_output[i].rotation.x,
+          reference_output[i].rotation.y,
+          reference_output[i].rotation.z,
+          reference_output[i].rotation.w};
+      for (size_t j = 0; j < OZZ_ARRAY_SIZE(values); ++j) {
+        float value[4], expected_value[4];
+        ozz::math::StorePtrU(values[j], value);
+        ozz::math::StorePtrU(expected[j], expected_value);
+        for (int k = 0; k < 4; ++k) {
+          EXPECT_NEAR(value[k], expected_value[k], 1e-3f);
+        }
+      }
+    }
+  }
+}
+
+TEST(Hermite, AnimationBuilder) {
+  // Prepares a skeleton made of a chain of 5 joints.
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint* joint = &raw_skeleton.roots[0];
+  for (int i = 1; i < 5; ++i) {
+    joint->children.resize(1);
+    joint = &joint->children[0];
+  }
+  SkeletonBuilder skeleton_builder;
+  ozz::unique_ptr<Skeleton> skeleton(skeleton_builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+
+  // Translations and rotations are smooth curves, defined with their
+  // derivatives. Scales remain linear.
+  RawAnimation raw_animation;
+  raw_animation.duration = 2.f;
+  raw_animation.tracks.resize(5);
+  for (int i = 0; i <= 8; ++i) {
+    const float time = i / 4.f;
+    for (int j = 0; j < 4; ++j) {
+      RawAnimation::JointTrack& track = raw_animation.tracks[j];
+      const float w = 1.f + j;
+      const RawAnimation::TranslationKey translation = {
+          time, ozz::math::Float3(std::sin(w * time), 1.f, time * j)};
+      track.translations.push_back(translation);
+      track.translation_tangents.push_back(
+          ozz::math::Float3(w * std::cos(w * time), 0.f, 1.f * j));
+
+      const float half_angle = .5f * w * time;
+      const RawAnimation::RotationKey rotation = {
+          time, ozz::math::Quaternion(0.f, std::sin(half_angle), 0.f,
+                                      std::cos(half_angle))};
+      track.rotations.push_back(rotation);
+      track.rotation_tangents.push_back(
+          ozz::math::Float4(0.f, .5f * w * std::cos(half_angle), 0.f,
+                            -.5f * w * std::sin(half_angle)));
+
+      const RawAnimation::ScaleKey scale = {
+          time, ozz::math::Float3(1.f + time * j)};
+      track.scales.push_back(scale);
+    }
+  }
+  // Last joint translation is constant, its tangent is null.
+  const RawAnimation::TranslationKey constant = {
+      0.f, ozz::math::Float3(0.f, 2.f, 0.f)};
+  raw_animation.tracks[4].translations.push_back(constant);
+  raw_animation.tracks[4].translation_tangents.push_back(
+      ozz::math::Float3::zero());
+  ASSERT_TRUE(raw_animation.Validate());
+
+  AnimationBuilder builder;
+
+  // All tracks with keys must have tangents.
+  {
+    RawAnimation invalid = raw_animation;
+    invalid.tracks[4].translation_tangents.clear();
+    EXPECT_FALSE(builder(invalid));
+  }
+
+  ozz::unique_ptr<Animation> animation(builder(raw_animation, *skeleton));
+  ASSERT_TRUE(animation);
+
+  // Hermite transformation types aren't quantized.
+  EXPECT_EQ(animation->translations_ranges().size(), 0u);
+  EXPECT_EQ(animation->translations_tangents().size(),
+            animation->translations_values().size());
+  EXPECT_EQ(animation->translations_constants().size(), 4u);
+  EXPECT_EQ(animation->rotations_ranges().size(), 0u);
+  EXPECT_EQ(animation->rotations_tangents().size(),
+            animation->rotations_values().size());
+  EXPECT_EQ(animation->scales_tangents().size(), 0u);
+
+  // Samples animation, which must match raw animation.
+  ozz::animation::SamplingJob job;
+  ozz::animation::SamplingJob::Context context(5);
+  ozz::math::SoaTransform output[2];
+  job.animation = animation.get();
+  job.context = &context;
+  job.output = output;
+
+  for (float time = 0.f; time <= 2.f; time += .05f) {
+    job.ratio = time / raw_animation.duration;
+    ASSERT_TRUE(job.Run());
+
+    ozz::math::Transform expected[5];
+    ASSERT_TRUE(ozz::animation::offline::SampleAnimation(raw_animation, time,
+                                                         expected));
+
+    for (int i = 0; i < 5; ++i) {
+      const ozz::math::SoaTransform& soa = output[i / 4];
+      const int lane = i % 4;
+      float values[10][4];
+      ozz::math::StorePtrU(soa.translation.x, values[0]);
+      ozz::math::StorePtrU(soa.translation.y, values[1]);
+      ozz::math::StorePtrU(soa.translation.z, values[2]);
+      ozz::math::StorePtrU(soa.rotation.x, values[3]);
+      ozz::math::StorePtrU(soa.rotation.y, values[4]);
+      ozz::math::StorePtrU(soa.rotation.z, values[5]);
+      ozz::math::StorePtrU(soa.rotation.w, values[6]);
+      ozz::math::StorePtrU(soa.scale.x, values[7]);
+      ozz::math::StorePtrU(soa.scale.y, values[8]);
+      ozz::math::StorePtrU(soa.scale.z, values[9]);
+      const float expected_values[10] = {
+          expected[i].translation.x, expected[i].translation.y,
+          expected[i].translation.z, expected[i].rotation.x,
+          expected[i].rotation.y,    expected[i].rotation.z,
+          expected[i].rotation.w,    expected[i].scale.x,
+          expected[i].scale.y,       expected[i].scale.z};
+      for (int j = 0; j < 10; ++j) {
+        EXPECT_NEAR(values[j][lane], expected_values[j], 1e-2f);
+      }
+    }
+  }
+}
+
 TEST(ManyKeys, SamplingJob) {
   const size_t kMaxKey = 65500;
 
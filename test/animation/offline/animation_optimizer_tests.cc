@@ -25,9 +25,12 @@
 //                                                                            //
 //----------------------------------------------------------------------------//
 
+#include <cmath>
+
 #include "gtest/gtest.h"
 #include "ozz/animation/offline/animation_optimizer.h"
 #include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/raw_animation_utils.h"
 #include "ozz/animation/offline/raw_skeleton.h"
 #include "ozz/animation/offline/skeleton_builder.h"
 #include "ozz/animation/runtime/skeleton.h"
@@ -672,3 +675,144 @@ TEST(OptimizeOverride, AnimationOptimizer) {
     input.tracks[4].scales.clear();
   }
 }
+
+TEST(Threads, AnimationOptimizer) {
+  // Prepares a skeleton with a few chains.
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  raw_skeleton.roots[0].children.resize(4);
+  for (RawSkeleton::Joint& chain : raw_skeleton.roots[0].children) {
+    chain.children.resize(1);
+    chain.children[0].children.resize(1);
+    chain.children[0].children[0].children.resize(1);
+  }
+  SkeletonBuilder skeleton_builder;
+  ozz::unique_ptr<Skeleton> skeleton(skeleton_builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+
+  // Builds a noisy animation, so optimization keeps a fair amount of keys.
+  RawAnimation input;
+  input.duration = 1.f;
+  input.tracks.resize(skeleton->num_joints());
+  for (int i = 0; i < input.num_tracks(); ++i) {
+    RawAnimation::JointTrack& track = input.tracks[i];
+    for (int k = 0; k <= 60; ++k) {
+      const float time = k / 60.f;
+      const float value = std::sin(time * 13.f * (i + 1)) * .1f;
+      const RawAnimation::TranslationKey tkey = {
+          time, ozz::math::Float3(1.f, value, 0.f)};
+      track.translations.push_back(tkey);
+      const RawAnimation::RotationKey rkey = {
+          time, ozz::math::Quaternion::FromAxisAngle(
+                    ozz::math::Float3::x_axis(), value * 3.f)};
+      track.rotations.push_back(rkey);
+      const RawAnimation::ScaleKey skey = {
+          time, ozz::math::Float3(1.f + value * (k % 2))};
+      track.scales.push_back(skey);
+    }
+  }
+  ASSERT_TRUE(input.Validate());
+
+  AnimationOptimizer optimizer;
+  RawAnimation reference;
+  ASSERT_TRUE(optimizer(input, *skeleton, &reference));
+
+  // Output is the same, whatever the number of threads.
+  const int num_threads[] = {0, 2, 3, 64};
+  for (int threads : num_threads) {
+    optimizer.num_threads = threads;
+    RawAnimation output;
+    ASSERT_TRUE(optimizer(input, *skeleton, &output));
+    ASSERT_EQ(output.num_tracks(), reference.num_tracks());
+    for (int i = 0; i < output.num_tracks(); ++i) {
+      const RawAnimation::JointTrack& track = output.tracks[i];
+      const RawAnimation::JointTrack& expected = reference.tracks[i];
+      ASSERT_EQ(track.translations.size(), expected.translations.size());
+      ASSERT_EQ(track.rotations.size(), expected.rotations.size());
+      ASSERT_EQ(track.scales.size(), expected.scales.size());
+      for (size_t k = 0; k < track.rotations.size(); ++k) {
+        EXPECT_EQ(track.rotations[k].time, expected.rotations[k].time);
+        EXPECT_EQ(track.rotations[k].value.x, expected.rotations[k].value.x);
+      }
+    }
+  }
+}
+
+TEST(Hermite, AnimationOptimizer) {
+  // Prepares a skeleton made of a chain of 3 joints.
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  raw_skeleton.roots[0].children.resize(1);
+  raw_skeleton.roots[0].children[0].children.resize(1);
+  SkeletonBuilder skeleton_builder;
+  ozz::unique_ptr<Skeleton> skeleton(skeleton_builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+
+  // Builds a smooth animation, like motion capture.
+  RawAnimation input;
+  input.duration = 2.f;
+  input.tracks.resize(3);
+  for (int i = 0; i < 3; ++i) {
+    RawAnimation::JointTrack& track = input.tracks[i];
+    for (int k = 0; k <= 120; ++k) {
+      const float time = k / 60.f;
+      const float value = std::sin(time * (i + 2.f));
+      const RawAnimation::TranslationKey tkey = {
+          time, ozz::math::Float3(value, 1.f, 0.f)};
+      track.translations.push_back(tkey);
+      const RawAnimation::RotationKey rkey = {
+          time, ozz::math::Quaternion::FromAxisAngle(
+                    ozz::math::Float3::x_axis(), value)};
+      track.rotations.push_back(rkey);
+    }
+  }
+  ASSERT_TRUE(input.Validate());
+
+  AnimationOptimizer optimizer;
+  RawAnimation linear;
+  ASSERT_TRUE(optimizer(input, *skeleton, &linear));
+  EXPECT_TRUE(linear.tracks[0].translation_tangents.empty());
+
+  optimizer.hermite = true;
+  RawAnimation hermite;
+  ASSERT_TRUE(optimizer(input, *skeleton, &hermite));
+  EXPECT_TRUE(hermite.Validate());
+
+  // Far fewer keys are needed to reach the same tolerance.
+  for (int i = 0; i < 3; ++i) {
+    const RawAnimation::JointTrack& track = hermite.tracks[i];
+    EXPECT_LT(track.translations.size(),
+              linear.tracks[i].translations.size());
+    EXPECT_EQ(track.translation_tangents.size(), track.translations.size());
+    EXPECT_LT(track.rotations.size(), linear.tracks[i].rotations.size());
+    EXPECT_EQ(track.rotation_tangents.size(), track.rotations.size());
+    EXPECT_TRUE(track.scales.empty());
+    EXPECT_TRUE(track.scale_tangents.empty());
+  }
+
+  // Root translation matches input within tolerance.
+  for (float time = 0.f; time <= 2.f; time += 1.f / 60.f) {
+    ozz::math::Transform expected[3];
+    ASSERT_TRUE(
+        ozz::animation::offline::SampleAnimation(input, time, expected));
+    ozz::math::Transform output[3];
+    ASSERT_TRUE(
+        ozz::animation::offline::SampleAnimation(hermite, time, output));
+    EXPECT_NEAR(output[0].translation.x, expected[0].translation.x,
+                optimizer.setting.tolerance);
+  }
+
+  // Hermite output can be optimized again, reusing its tangents.
+  RawAnimation again;
+  ASSERT_TRUE(optimizer(hermite, *skeleton, &again));
+  EXPECT_LE(again.tracks[0].translations.size(),
+            hermite.tracks[0].translations.size());
+
+  // Tangents are dropped when optimizing for linear interpolation.
+  optimizer.hermite = false;
+  RawAnimation dropped;
+  ASSERT_TRUE(optimizer(hermite, *skeleton, &dropped));
+  EXPECT_TRUE(dropped.Validate());
+  EXPECT_TRUE(dropped.tracks[0].translation_tangents.empty());
+  EXPECT_TRUE(dropped.tracks[0].rotation_tangents.empty());
+}
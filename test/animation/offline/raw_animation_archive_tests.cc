@@ -67,6 +67,8 @@ TEST(Filled, RawAnimationSerialize) {
   const RawAnimation::ScaleKey s_key = {1.f,
                                         ozz::math::Float3(93.f, 46.f, 99.f)};
   o_animation.tracks[2].scales.push_back(s_key);
+  o_animation.tracks[2].scale_tangents.push_back(
+      ozz::math::Float3(1.f, 2.f, 3.f));
 
   EXPECT_TRUE(o_animation.Validate());
   EXPECT_EQ(o_animation.num_tracks(), 3);
@@ -111,6 +113,15 @@ TEST(Filled, RawAnimationSerialize) {
         EXPECT_FLOAT_EQ(o_key.time, i_key.time);
         EXPECT_TRUE(Compare(o_key.value, i_key.value, 0.f));
       }
+      EXPECT_EQ(o_track.translation_tangents.size(),
+                i_track.translation_tangents.size());
+      EXPECT_EQ(o_track.rotation_tangents.size(),
+                i_track.rotation_tangents.size());
+      ASSERT_EQ(o_track.scale_tangents.size(), i_track.scale_tangents.size());
+      for (size_t j = 0; j < o_track.scale_tangents.size(); ++j) {
+        EXPECT_TRUE(
+            Compare(o_track.scale_tangents[j], i_track.scale_tangents[j], 0.f));
+      }
     }
   }
 }
@@ -152,6 +152,71 @@ TEST(SamplingTrack, Utils) {
   EXPECT_FLOAT3_EQ(output.scale, -1.f, -2.f, -4.f);
 }
 
+TEST(SamplingTrackHermite, Utils) {
+  RawAnimation::JointTrack track;
+
+  RawAnimation::TranslationKey t0 = {0.f, ozz::math::Float3(0.f, 1.f, 0.f)};
+  track.translations.push_back(t0);
+  RawAnimation::TranslationKey t1 = {2.f, ozz::math::Float3(4.f, 1.f, 0.f)};
+  track.translations.push_back(t1);
+
+  RawAnimation::RotationKey r0 = {0.f, ozz::math::Quaternion::identity()};
+  track.rotations.push_back(r0);
+  RawAnimation::RotationKey r1 = {
+      2.f, ozz::math::Quaternion(0.f, .70710677f, 0.f, .70710677f)};
+  track.rotations.push_back(r1);
+
+  RawAnimation::ScaleKey s0 = {.5f, ozz::math::Float3(-1.f, -2.f, -4.f)};
+  track.scales.push_back(s0);
+
+  ozz::math::Transform output;
+
+  // Tangents count must match keys count.
+  track.translation_tangents.push_back(ozz::math::Float3(2.f, 0.f, 0.f));
+  EXPECT_FALSE(track.Validate(2.f));
+  EXPECT_FALSE(ozz::animation::offline::SampleTrack(track, 0.f, &output));
+
+  track.translation_tangents.push_back(ozz::math::Float3::zero());
+  track.rotation_tangents.push_back(ozz::math::Float4::zero());
+  track.rotation_tangents.push_back(ozz::math::Float4::zero());
+  track.scale_tangents.push_back(ozz::math::Float3(1.f, 1.f, 1.f));
+  EXPECT_TRUE(track.Validate(2.f));
+
+  // t = 0
+  ASSERT_TRUE(ozz::animation::offline::SampleTrack(track, 0.f, &output));
+  EXPECT_FLOAT3_EQ(output.translation, 0.f, 1.f, 0.f);
+  EXPECT_QUATERNION_EQ(output.rotation, 0.f, 0.f, 0.f, 1.f);
+  EXPECT_FLOAT3_EQ(output.scale, -1.f, -2.f, -4.f);
+
+  // t = .5
+  ASSERT_TRUE(ozz::animation::offline::SampleTrack(track, .5f, &output));
+  EXPECT_FLOAT3_EQ(output.translation, 1.1875f, 1.f, 0.f);
+
+  // t = 1, rotation tangents are null, so it matches lerp.
+  ASSERT_TRUE(ozz::animation::offline::SampleTrack(track, 1.f, &output));
+  EXPECT_FLOAT3_EQ(output.translation, 2.5f, 1.f, 0.f);
+  EXPECT_QUATERNION_EQ(output.rotation, 0.f, .38268343f, 0.f, .92387953f);
+  EXPECT_FLOAT3_EQ(output.scale, -1.f, -2.f, -4.f);
+
+  // t = 2
+  ASSERT_TRUE(ozz::animation::offline::SampleTrack(track, 2.f, &output));
+  EXPECT_FLOAT3_EQ(output.translation, 4.f, 1.f, 0.f);
+  EXPECT_QUATERNION_EQ(output.rotation, 0.f, .70710677f, 0.f, .70710677f);
+  EXPECT_FLOAT3_EQ(output.scale, -1.f, -2.f, -4.f);
+
+  // Tangents must be specified for all tracks with keys, or none.
+  RawAnimation raw_animation;
+  raw_animation.duration = 2.f;
+  raw_animation.tracks.resize(3);
+  raw_animation.tracks[0] = track;
+  EXPECT_TRUE(raw_animation.Validate());
+  raw_animation.tracks[1].translations.push_back(t0);
+  EXPECT_FALSE(raw_animation.Validate());
+  raw_animation.tracks[1].translation_tangents.push_back(
+      ozz::math::Float3::zero());
+  EXPECT_TRUE(raw_animation.Validate());
+}
+
 TEST(SamplingAnimation, Utils) {
   // Building an Animation with unsorted keys fails.
   RawAnimation raw_animation;
@@ -307,4 +372,95 @@ TEST(TimePoints, Utils) {
   EXPECT_FLOAT_EQ(time_points[4], .4f);
   EXPECT_FLOAT_EQ(time_points[5], 1.f);
   EXPECT_FLOAT_EQ(time_points[6], 2.f);
-}
\ No newline at end of file
+}
+TEST(ExtractAnimationRange, Utils) {
+  RawAnimation raw_animation;
+  raw_animation.duration = 2.f;
+  raw_animation.tracks.resize(2);
+
+  RawAnimation::TranslationKey a = {0.f, ozz::math::Float3(0.f, 0.f, 0.f)};
+  raw_animation.tracks[0].translations.push_back(a);
+  RawAnimation::TranslationKey b = {.5f, ozz::math::Float3(5.f, 0.f, 0.f)};
+  raw_animation.tracks[0].translations.push_back(b);
+  RawAnimation::TranslationKey c = {2.f, ozz::math::Float3(20.f, 0.f, 0.f)};
+  raw_animation.tracks[0].translations.push_back(c);
+
+  RawAnimation output;
+
+  // Invalid ranges
+  EXPECT_FALSE(ozz::animation::offline::ExtractAnimationRange(
+      raw_animation, -1.f, 1.f, &output));
+  EXPECT_FALSE(ozz::animation::offline::ExtractAnimationRange(
+      raw_animation, 1.f, .5f, &output));
+  EXPECT_FALSE(ozz::animation::offline::ExtractAnimationRange(
+      raw_animation, 0.f, 3.f, &output));
+  EXPECT_FALSE(ozz::animation::offline::ExtractAnimationRange(
+      raw_animation, 0.f, 1.f, nullptr));
+
+  ASSERT_TRUE(ozz::animation::offline::ExtractAnimationRange(
+      raw_animation, .25f, 1.f, &output));
+  EXPECT_TRUE(output.Validate());
+  EXPECT_FLOAT_EQ(output.duration, .75f);
+  ASSERT_EQ(output.num_tracks(), 2);
+
+  const RawAnimation::JointTrack::Translations& translations =
+      output.tracks[0].translations;
+  ASSERT_EQ(translations.size(), 3u);
+  EXPECT_FLOAT_EQ(translations[0].time, 0.f);
+  EXPECT_FLOAT3_EQ(translations[0].value, 2.5f, 0.f, 0.f);
+  EXPECT_FLOAT_EQ(translations[1].time, .25f);
+  EXPECT_FLOAT3_EQ(translations[1].value, 5.f, 0.f, 0.f);
+  EXPECT_FLOAT_EQ(translations[2].time, .75f);
+  EXPECT_FLOAT3_EQ(translations[2].value, 10.f, 0.f, 0.f);
+  EXPECT_TRUE(output.tracks[0].rotations.empty());
+  EXPECT_TRUE(output.tracks[1].translations.empty());
+
+  // Output matches input on the whole range.
+  for (float t = 0.f; t <= .75f; t += .05f) {
+    ozz::math::Transform expected[2];
+    ozz::math::Transform extracted[2];
+    ASSERT_TRUE(ozz::animation::offline::SampleAnimation(raw_animation,
+                                                         .25f + t, expected));
+    ASSERT_TRUE(
+        ozz::animation::offline::SampleAnimation(output, t, extracted));
+    EXPECT_NEAR(extracted[0].translation.x, expected[0].translation.x, 1e-5f);
+  }
+}
+
+TEST(ExtractAnimationRangeHermite, Utils) {
+  RawAnimation raw_animation;
+  raw_animation.duration = 2.f;
+  raw_animation.tracks.resize(1);
+
+  RawAnimation::JointTrack& track = raw_animation.tracks[0];
+  RawAnimation::TranslationKey a = {0.f, ozz::math::Float3(0.f, 0.f, 0.f)};
+  track.translations.push_back(a);
+  track.translation_tangents.push_back(ozz::math::Float3(10.f, 0.f, 0.f));
+  RawAnimation::TranslationKey b = {.5f, ozz::math::Float3(5.f, 0.f, 0.f)};
+  track.translations.push_back(b);
+  track.translation_tangents.push_back(ozz::math::Float3(-4.f, 0.f, 0.f));
+  RawAnimation::TranslationKey c = {2.f, ozz::math::Float3(20.f, 0.f, 0.f)};
+  track.translations.push_back(c);
+  track.translation_tangents.push_back(ozz::math::Float3(3.f, 0.f, 0.f));
+
+  RawAnimation output;
+  ASSERT_TRUE(ozz::animation::offline::ExtractAnimationRange(
+      raw_animation, .25f, 1.f, &output));
+  EXPECT_TRUE(output.Validate());
+  ASSERT_EQ(output.tracks[0].translations.size(), 3u);
+  ASSERT_EQ(output.tracks[0].translation_tangents.size(), 3u);
+  EXPECT_FLOAT3_EQ(output.tracks[0].translation_tangents[1], -4.f, 0.f, 0.f);
+  EXPECT_TRUE(output.tracks[0].rotation_tangents.empty());
+
+  // Cubic segments are split exactly, so output matches input on the whole
+  // range.
+  for (float t = 0.f; t <= .75f; t += .05f) {
+    ozz::math::Transform expected[1];
+    ozz::math::Transform extracted[1];
+    ASSERT_TRUE(ozz::animation::offline::SampleAnimation(raw_animation,
+                                                         .25f + t, expected));
+    ASSERT_TRUE(
+        ozz::animation::offline::SampleAnimation(output, t, extracted));
+    EXPECT_NEAR(extracted[0].translation.x, expected[0].translation.x, 1e-4f);
+  }
+}
@@ -31,6 +31,7 @@
 #include "ozz/animation/offline/raw_skeleton.h"
 #include "ozz/animation/offline/skeleton_builder.h"
 #include "ozz/animation/runtime/skeleton.h"
+#include "ozz/animation/runtime/skeleton_utils.h"
 #include "ozz/base/maths/gtest_math_helper.h"
 #include "ozz/base/maths/simd_math.h"
 #include "ozz/base/maths/soa_transform.h"
@@ -554,6 +555,85 @@ TEST(JointOrder, SkeletonBuilder) {
   EXPECT_STREQ(skeleton->joint_names()[6], "j6");
 }
 
+TEST(JointOrderBreadthFirst, SkeletonBuilder) {
+  /*
+   8 joints, same hierarchy as JointOrder test.
+
+        *
+        |
+        j0
+     /  |  \
+   j1   j3  j7
+    |  / \
+   j2 j4 j5
+         |
+         j6
+  */
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint& root = raw_skeleton.roots[0];
+  root.name = "j0";
+
+  root.children.resize(3);
+  root.children[0].name = "j1";
+  root.children[1].name = "j3";
+  root.children[2].name = "j7";
+
+  root.children[0].children.resize(1);
+  root.children[0].children[0].name = "j2";
+
+  root.children[1].children.resize(2);
+  root.children[1].children[0].name = "j4";
+  root.children[1].children[1].name = "j5";
+
+  root.children[1].children[1].children.resize(1);
+  root.children[1].children[1].children[0].name = "j6";
+  root.children[1].children[1].children[0].transform.translation =
+      ozz::math::Float3(6.f, 7.f, 8.f);
+
+  EXPECT_TRUE(raw_skeleton.Validate());
+
+  SkeletonBuilder builder;
+  ozz::vector<int16_t> remap;
+
+  {  // Default order remap is the identity.
+    ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton, &remap));
+    ASSERT_TRUE(skeleton);
+    ASSERT_EQ(remap.size(), 8u);
+    for (int16_t i = 0; i < 8; ++i) {
+      EXPECT_EQ(remap[i], i);
+    }
+  }
+
+  builder.joint_order = SkeletonBuilder::kBreadthFirst;
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton, &remap));
+  ASSERT_TRUE(skeleton);
+  EXPECT_EQ(skeleton->num_joints(), 8);
+
+  // Joints are sorted by depth, and maintain depth-first order within a level.
+  const char* names[] = {"j0", "j1", "j3", "j7", "j2", "j4", "j5", "j6"};
+  const int16_t parents[] = {Skeleton::kNoParent, 0, 0, 0, 1, 2, 2, 6};
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_STREQ(skeleton->joint_names()[i], names[i]);
+    EXPECT_EQ(skeleton->joint_parents()[i], parents[i]);
+  }
+
+  // Remap table maps depth-first indices to breadth-first ones.
+  const int16_t expected_remap[] = {0, 1, 4, 2, 5, 6, 7, 3};
+  ASSERT_EQ(remap.size(), 8u);
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(remap[i], expected_remap[i]);
+  }
+
+  // Rest poses follow joints.
+  EXPECT_FLOAT3_EQ(
+      ozz::animation::GetJointLocalRestPose(*skeleton, 7).translation, 6.f,
+      7.f, 8.f);
+  EXPECT_FLOAT3_EQ(
+      ozz::animation::GetJointLocalRestPose(*skeleton, 6).translation, 0.f,
+      0.f, 0.f);
+}
+
 TEST(MultiRoots, SkeletonBuilder) {
   // Instantiates a builder objects with default parameters.
   SkeletonBuilder builder;
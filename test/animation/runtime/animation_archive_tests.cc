@@ -25,11 +25,17 @@
 //                                                                            //
 //----------------------------------------------------------------------------//
 
+#include <cstring>
+
 #include "gtest/gtest.h"
 #include "ozz/animation/offline/animation_builder.h"
 #include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/skeleton_builder.h"
 #include "ozz/animation/runtime/animation.h"
 #include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/containers/vector.h"
 #include "ozz/base/io/archive.h"
 #include "ozz/base/io/stream.h"
 #include "ozz/base/maths/gtest_math_helper.h"
@@ -37,8 +43,11 @@
 #include "ozz/base/memory/unique_ptr.h"
 
 using ozz::animation::Animation;
+using ozz::animation::Skeleton;
 using ozz::animation::offline::AnimationBuilder;
 using ozz::animation::offline::RawAnimation;
+using ozz::animation::offline::RawSkeleton;
+using ozz::animation::offline::SkeletonBuilder;
 
 TEST(Empty, AnimationSerialize) {
   ozz::io::MemoryStream stream;
@@ -178,3 +187,320 @@ TEST(AlreadyInitialized, AnimationSerialize) {
     ASSERT_EQ(i_animation.num_tracks(), 2);
   }
 }
+
+namespace {
+// Samples two animations at the same ratios and expects identical outputs.
+void ExpectSameSampling(const Animation& _a, const Animation& _b) {
+  ASSERT_EQ(_a.num_tracks(), _b.num_tracks());
+  const int num_soa_tracks = _a.num_soa_tracks();
+  ozz::animation::SamplingJob::Context context_a(_a.num_tracks());
+  ozz::animation::SamplingJob::Context context_b(_b.num_tracks());
+  ozz::vector<ozz::math::SoaTransform> output_a(num_soa_tracks);
+  ozz::vector<ozz::math::SoaTransform> output_b(num_soa_tracks);
+
+  const float ratios[] = {0.f, .1f, .5f, .46f, .99f, 1.f, .3f};
+  for (float ratio : ratios) {
+    ozz::animation::SamplingJob job_a;
+    job_a.animation = &_a;
+    job_a.context = &context_a;
+    job_a.ratio = ratio;
+    job_a.output = make_span(output_a);
+    ASSERT_TRUE(job_a.Run());
+
+    ozz::animation::SamplingJob job_b;
+    job_b.animation = &_b;
+    job_b.context = &context_b;
+    job_b.ratio = ratio;
+    job_b.output = make_span(output_b);
+    ASSERT_TRUE(job_b.Run());
+
+    EXPECT_EQ(std::memcmp(output_a.data(), output_b.data(),
+                          output_a.size() * sizeof(ozz::math::SoaTransform)),
+              0);
+  }
+}
+
+// Builds an animation whose small range tracks are quantized, with iframes.
+ozz::unique_ptr<Animation> BuildQuantizedAnimation() {
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  raw_skeleton.roots[0].children.resize(4);
+  const ozz::unique_ptr<Skeleton> skeleton = SkeletonBuilder()(raw_skeleton);
+  if (!skeleton) {
+    return nullptr;
+  }
+
+  RawAnimation raw_animation;
+  raw_animation.duration = 2.f;
+  raw_animation.name = "quantized";
+  raw_animation.tracks.resize(5);
+  for (size_t i = 0; i < raw_animation.tracks.size(); ++i) {
+    for (int k = 0; k < 30 + static_cast<int>(i); ++k) {
+      const float time = k * raw_animation.duration / (30 + i);
+      const RawAnimation::TranslationKey t_key = {
+          time, ozz::math::Float3(k * .001f, i * .1f, k * -.002f)};
+      raw_animation.tracks[i].translations.push_back(t_key);
+      const RawAnimation::RotationKey r_key = {
+          time, ozz::math::Quaternion::FromAxisAngle(
+                    ozz::math::Float3::x_axis(), k * .02f)};
+      raw_animation.tracks[i].rotations.push_back(r_key);
+      const RawAnimation::ScaleKey s_key = {
+          time, ozz::math::Float3(1.f + k * .001f, 1.f, 1.f)};
+      raw_animation.tracks[i].scales.push_back(s_key);
+    }
+  }
+  AnimationBuilder builder;
+  builder.iframe_interval = .5f;
+  return builder(raw_animation, *skeleton);
+}
+
+// Builds an animation whose translations and rotations are hermite
+// interpolated.
+ozz::unique_ptr<Animation> BuildHermiteAnimation() {
+  RawAnimation raw_animation;
+  raw_animation.duration = 2.f;
+  raw_animation.name = "hermite";
+  raw_animation.tracks.resize(5);
+  for (size_t i = 0; i < raw_animation.tracks.size(); ++i) {
+    RawAnimation::JointTrack& track = raw_animation.tracks[i];
+    for (int k = 0; k < 5 + static_cast<int>(i); ++k) {
+      const float time = k * raw_animation.duration / (5 + i);
+      const RawAnimation::TranslationKey t_key = {
+          time, ozz::math::Float3(k * 1.f, i * 2.f, k * -3.f)};
+      track.translations.push_back(t_key);
+      track.translation_tangents.push_back(
+          ozz::math::Float3(1.f, k * .5f, 0.f));
+      const RawAnimation::RotationKey r_key = {
+          time, ozz::math::Quaternion::FromAxisAngle(
+                    ozz::math::Float3::x_axis(), k * .2f)};
+      track.rotations.push_back(r_key);
+      track.rotation_tangents.push_back(
+          ozz::math::Float4(.1f * i, 0.f, 0.f, 0.f));
+    }
+  }
+  AnimationBuilder builder;
+  builder.iframe_interval = .5f;
+  return builder(raw_animation);
+}
+}  // namespace
+
+TEST(Empty, AnimationImage) {
+  ozz::io::MemoryStream stream;
+
+  Animation o_animation;
+  EXPECT_TRUE(o_animation.SaveImage(stream));
+
+  ozz::vector<float> image((stream.Size() + 3) / 4);
+  stream.Seek(0, ozz::io::Stream::kSet);
+  ASSERT_EQ(stream.Read(image.data(), stream.Size()), stream.Size());
+
+  Animation i_animation;
+  EXPECT_TRUE(i_animation.MapImage(
+      ozz::as_bytes(make_span(image)).first(stream.Size())));
+  EXPECT_EQ(i_animation.num_tracks(), 0);
+  EXPECT_FLOAT_EQ(i_animation.duration(), 0.f);
+  EXPECT_STREQ(i_animation.name(), "");
+}
+
+TEST(Filled, AnimationImage) {
+  // Builds a valid animation, with iframes.
+  RawAnimation raw_animation;
+  raw_animation.duration = 2.f;
+  raw_animation.name = "image";
+  raw_animation.tracks.resize(5);
+  for (size_t i = 0; i < raw_animation.tracks.size(); ++i) {
+    for (int k = 0; k < 10 + static_cast<int>(i); ++k) {
+      const float time = k * raw_animation.duration / (10 + i);
+      const RawAnimation::TranslationKey t_key = {
+          time, ozz::math::Float3(k * 1.f, i * 2.f, k * -3.f)};
+      raw_animation.tracks[i].translations.push_back(t_key);
+      const RawAnimation::RotationKey r_key = {
+          time, ozz::math::Quaternion::FromAxisAngle(
+                    ozz::math::Float3::x_axis(), k * .2f)};
+      raw_animation.tracks[i].rotations.push_back(r_key);
+    }
+  }
+  AnimationBuilder builder;
+  builder.iframe_interval = .5f;
+  const ozz::unique_ptr<Animation> o_animation = builder(raw_animation);
+  ASSERT_TRUE(o_animation);
+
+  {
+    ozz::io::File file("test_animation.img", "wb");
+    ASSERT_TRUE(file.opened());
+    EXPECT_TRUE(o_animation->SaveImage(file));
+  }
+
+  ozz::io::MappedFile file("test_animation.img");
+  ASSERT_TRUE(file.opened());
+
+  Animation i_animation;
+  ASSERT_TRUE(i_animation.MapImage(file.data()));
+  EXPECT_FLOAT_EQ(i_animation.duration(), o_animation->duration());
+  EXPECT_STREQ(i_animation.name(), "image");
+  EXPECT_EQ(i_animation.size(), o_animation->size());
+
+  // Mapped animation data points to file memory.
+  EXPECT_GE(reinterpret_cast<const ozz::byte*>(
+                i_animation.timepoints().data()),
+            file.data().data());
+  EXPECT_LT(reinterpret_cast<const ozz::byte*>(
+                i_animation.timepoints().data()),
+            file.data().data() + file.data().size());
+
+  ExpectSameSampling(*o_animation, i_animation);
+
+  // Animation can be moved.
+  Animation m_animation = std::move(i_animation);
+  ExpectSameSampling(*o_animation, m_animation);
+}
+
+TEST(Quantized, AnimationSerialize) {
+  const ozz::unique_ptr<Animation> o_animation = BuildQuantizedAnimation();
+  ASSERT_TRUE(o_animation);
+  ASSERT_FALSE(o_animation->translations_ranges().empty());
+  ASSERT_FALSE(o_animation->rotations_ranges().empty());
+  ASSERT_FALSE(o_animation->scales_ranges().empty());
+  ASSERT_FALSE(o_animation->rotations_quantized_ctrl().iframe_desc.empty());
+
+  for (int e = 0; e < 2; ++e) {
+    ozz::Endianness endianess = e == 0 ? ozz::kBigEndian : ozz::kLittleEndian;
+    ozz::io::MemoryStream stream;
+
+    // Streams out.
+    ozz::io::OArchive o(&stream, endianess);
+    o << *o_animation;
+
+    // Streams in.
+    stream.Seek(0, ozz::io::Stream::kSet);
+    ozz::io::IArchive i(&stream);
+
+    Animation i_animation;
+    i >> i_animation;
+
+    EXPECT_STREQ(i_animation.name(), "quantized");
+    EXPECT_EQ(i_animation.size(), o_animation->size());
+    EXPECT_EQ(i_animation.translations_ranges().size(),
+              o_animation->translations_ranges().size());
+    EXPECT_EQ(i_animation.rotations_ranges().size(),
+              o_animation->rotations_ranges().size());
+    EXPECT_EQ(i_animation.scales_ranges().size(),
+              o_animation->scales_ranges().size());
+
+    ExpectSameSampling(*o_animation, i_animation);
+  }
+}
+
+TEST(Quantized, AnimationImage) {
+  const ozz::unique_ptr<Animation> o_animation = BuildQuantizedAnimation();
+  ASSERT_TRUE(o_animation);
+
+  ozz::io::MemoryStream stream;
+  ASSERT_TRUE(o_animation->SaveImage(stream));
+  ozz::vector<float> image((stream.Size() + 3) / 4);
+  stream.Seek(0, ozz::io::Stream::kSet);
+  ASSERT_EQ(stream.Read(image.data(), stream.Size()), stream.Size());
+
+  Animation i_animation;
+  ASSERT_TRUE(i_animation.MapImage(
+      ozz::as_bytes(make_span(image)).first(stream.Size())));
+  EXPECT_EQ(i_animation.size(), o_animation->size());
+  EXPECT_FLOAT_EQ(i_animation.rotations_quantized_ctrl().iframe_interval,
+                  o_animation->rotations_quantized_ctrl().iframe_interval);
+
+  ExpectSameSampling(*o_animation, i_animation);
+}
+
+TEST(Hermite, AnimationSerialize) {
+  const ozz::unique_ptr<Animation> o_animation = BuildHermiteAnimation();
+  ASSERT_TRUE(o_animation);
+  ASSERT_FALSE(o_animation->translations_tangents().empty());
+  ASSERT_FALSE(o_animation->rotations_tangents().empty());
+  ASSERT_TRUE(o_animation->scales_tangents().empty());
+
+  for (int e = 0; e < 2; ++e) {
+    ozz::Endianness endianess = e == 0 ? ozz::kBigEndian : ozz::kLittleEndian;
+    ozz::io::MemoryStream stream;
+
+    // Streams out.
+    ozz::io::OArchive o(&stream, endianess);
+    o << *o_animation;
+
+    // Streams in.
+    stream.Seek(0, ozz::io::Stream::kSet);
+    ozz::io::IArchive i(&stream);
+
+    Animation i_animation;
+    i >> i_animation;
+
+    EXPECT_STREQ(i_animation.name(), "hermite");
+    EXPECT_EQ(i_animation.size(), o_animation->size());
+    EXPECT_EQ(i_animation.translations_tangents().size(),
+              o_animation->translations_tangents().size());
+    EXPECT_EQ(i_animation.rotations_tangents().size(),
+              o_animation->rotations_tangents().size());
+    EXPECT_EQ(i_animation.scales_tangents().size(), 0u);
+
+    ExpectSameSampling(*o_animation, i_animation);
+  }
+}
+
+TEST(Hermite, AnimationImage) {
+  const ozz::unique_ptr<Animation> o_animation = BuildHermiteAnimation();
+  ASSERT_TRUE(o_animation);
+
+  ozz::io::MemoryStream stream;
+  ASSERT_TRUE(o_animation->SaveImage(stream));
+  ozz::vector<float> image((stream.Size() + 3) / 4);
+  stream.Seek(0, ozz::io::Stream::kSet);
+  ASSERT_EQ(stream.Read(image.data(), stream.Size()), stream.Size());
+
+  Animation i_animation;
+  ASSERT_TRUE(i_animation.MapImage(
+      ozz::as_bytes(make_span(image)).first(stream.Size())));
+  EXPECT_EQ(i_animation.size(), o_animation->size());
+  EXPECT_EQ(i_animation.rotations_tangents().size(),
+            o_animation->rotations_tangents().size());
+
+  ExpectSameSampling(*o_animation, i_animation);
+}
+
+TEST(Invalid, AnimationImage) {
+  RawAnimation raw_animation;
+  raw_animation.duration = 1.f;
+  raw_animation.tracks.resize(1);
+  AnimationBuilder builder;
+  const ozz::unique_ptr<Animation> o_animation = builder(raw_animation);
+  ASSERT_TRUE(o_animation);
+
+  ozz::io::MemoryStream stream;
+  ASSERT_TRUE(o_animation->SaveImage(stream));
+  const size_t size = stream.Size();
+  ozz::vector<float> buffer((size + 4) / 4 + 1);
+  stream.Seek(0, ozz::io::Stream::kSet);
+  ASSERT_EQ(stream.Read(buffer.data(), size), size);
+  const ozz::span<const ozz::byte> image =
+      ozz::as_bytes(make_span(buffer)).first(size);
+
+  Animation animation;
+  ASSERT_TRUE(animation.MapImage(image));
+  EXPECT_EQ(animation.num_tracks(), 1);
+
+  // Empty image.
+  EXPECT_FALSE(animation.MapImage({}));
+  EXPECT_EQ(animation.num_tracks(), 0);
+
+  // Truncated image.
+  EXPECT_FALSE(animation.MapImage(image.first(size - 1)));
+  EXPECT_EQ(animation.num_tracks(), 0);
+
+  // Unaligned image.
+  std::memmove(reinterpret_cast<ozz::byte*>(buffer.data()) + 1, buffer.data(),
+               size);
+  EXPECT_FALSE(animation.MapImage(
+      ozz::as_bytes(make_span(buffer)).subspan(1, size)));
+
+  // Corrupted tag.
+  std::memset(buffer.data(), 0, size);
+  EXPECT_FALSE(animation.MapImage(image));
+}
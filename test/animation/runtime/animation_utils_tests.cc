@@ -75,11 +75,12 @@ TEST(CountKeyframes, AnimationUtils) {
   EXPECT_EQ(ozz::animation::CountTranslationKeyframes(*animation, 0), 3);
   EXPECT_EQ(ozz::animation::CountTranslationKeyframes(*animation, 1), 2);
 
-  EXPECT_EQ(ozz::animation::CountRotationKeyframes(*animation, -1), 8);
-  EXPECT_EQ(ozz::animation::CountRotationKeyframes(*animation, 0), 2);
-  EXPECT_EQ(ozz::animation::CountRotationKeyframes(*animation, 1), 2);
+  // Rotation and scale soa tracks are constant, stored as a single key.
+  EXPECT_EQ(ozz::animation::CountRotationKeyframes(*animation, -1), 4);
+  EXPECT_EQ(ozz::animation::CountRotationKeyframes(*animation, 0), 1);
+  EXPECT_EQ(ozz::animation::CountRotationKeyframes(*animation, 1), 1);
 
-  EXPECT_EQ(ozz::animation::CountScaleKeyframes(*animation, -1), 8);
-  EXPECT_EQ(ozz::animation::CountScaleKeyframes(*animation, 0), 2);
-  EXPECT_EQ(ozz::animation::CountScaleKeyframes(*animation, 1), 2);
+  EXPECT_EQ(ozz::animation::CountScaleKeyframes(*animation, -1), 4);
+  EXPECT_EQ(ozz::animation::CountScaleKeyframes(*animation, 0), 1);
+  EXPECT_EQ(ozz::animation::CountScaleKeyframes(*animation, 1), 1);
 }
@@ -0,0 +1,320 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/batch_sampling_job.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "ozz/animation/offline/animation_builder.h"
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::animation::Animation;
+using ozz::animation::BatchSamplingJob;
+using ozz::animation::SamplingJob;
+using ozz::animation::offline::AnimationBuilder;
+using ozz::animation::offline::RawAnimation;
+
+namespace {
+// Builds an animation with 7 tracks, with a different number of keys per
+// track.
+ozz::unique_ptr<Animation> BuildAnimation() {
+  RawAnimation raw_animation;
+  raw_animation.duration = 2.f;
+  raw_animation.tracks.resize(7);
+  for (size_t i = 0; i < raw_animation.tracks.size(); ++i) {
+    RawAnimation::JointTrack& track = raw_animation.tracks[i];
+    const size_t num_keys = i * 3 + 1;
+    for (size_t k = 0; k < num_keys; ++k) {
+      const float time = raw_animation.duration * k / num_keys;
+      const float value = static_cast<float>(i * 10 + k);
+      const RawAnimation::TranslationKey tkey = {
+          time, ozz::math::Float3(value, -value, value * .5f)};
+      track.translations.push_back(tkey);
+      const RawAnimation::RotationKey rkey = {
+          time, ozz::math::Quaternion::FromAxisAngle(
+                    ozz::math::Float3::y_axis(), value * .1f)};
+      track.rotations.push_back(rkey);
+      const RawAnimation::ScaleKey skey = {
+          time, ozz::math::Float3(1.f + value * .01f)};
+      track.scales.push_back(skey);
+    }
+  }
+  AnimationBuilder builder;
+  return builder(raw_animation);
+}
+}  // namespace
+
+TEST(JobValidity, BatchSamplingJob) {
+  const ozz::unique_ptr<Animation> animation = BuildAnimation();
+  ASSERT_TRUE(animation);
+
+  BatchSamplingJob::Context context(7, 2);
+  ozz::math::SoaTransform output0[2];
+  ozz::math::SoaTransform output1[2];
+  const ozz::span<ozz::math::SoaTransform> outputs[] = {output0, output1};
+  const float ratios[] = {.2f, .7f};
+
+  {  // Empty/default job
+    BatchSamplingJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid animation.
+    BatchSamplingJob job;
+    job.context = &context;
+    job.ratios = ratios;
+    job.outputs = outputs;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid context.
+    BatchSamplingJob job;
+    job.animation = animation.get();
+    job.ratios = ratios;
+    job.outputs = outputs;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid context tracks size.
+    BatchSamplingJob::Context small_context(4, 2);
+    BatchSamplingJob job;
+    job.animation = animation.get();
+    job.context = &small_context;
+    job.ratios = ratios;
+    job.outputs = outputs;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid context instances size.
+    BatchSamplingJob::Context small_context(7, 1);
+    BatchSamplingJob job;
+    job.animation = animation.get();
+    job.context = &small_context;
+    job.ratios = ratios;
+    job.outputs = outputs;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid ratios / outputs size mismatch.
+    BatchSamplingJob job;
+    job.animation = animation.get();
+    job.context = &context;
+    job.ratios = ozz::make_span(ratios).first(1);
+    job.outputs = outputs;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid empty output.
+    const ozz::span<ozz::math::SoaTransform> empty_outputs[] = {output0, {}};
+    BatchSamplingJob job;
+    job.animation = animation.get();
+    job.context = &context;
+    job.ratios = ratios;
+    job.outputs = empty_outputs;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid empty batch.
+    BatchSamplingJob job;
+    job.animation = animation.get();
+    job.context = &context;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Valid job.
+    BatchSamplingJob job;
+    job.animation = animation.get();
+    job.context = &context;
+    job.ratios = ratios;
+    job.outputs = outputs;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Valid job with smaller outputs.
+    const ozz::span<ozz::math::SoaTransform> small_outputs[] = {
+        ozz::make_span(output0).first(1), output1};
+    BatchSamplingJob job;
+    job.animation = animation.get();
+    job.context = &context;
+    job.ratios = ratios;
+    job.outputs = small_outputs;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+}
+
+TEST(Sampling, BatchSamplingJob) {
+  const ozz::unique_ptr<Animation> animation = BuildAnimation();
+  ASSERT_TRUE(animation);
+
+  // Unsorted ratios, with duplicates and out of range values.
+  const float frames[][8] = {
+      {.5f, .1f, .9f, .1f, -.2f, 1.2f, .33f, .5f},
+      {.55f, .15f, .95f, .15f, 0.f, 1.f, .38f, .55f},
+      {.05f, .75f, .95f, .0f, .3f, .6f, .6f, .2f},
+      {.9f, .8f, .7f, .6f, .5f, .4f, .3f, .2f}};
+  const size_t kInstances = OZZ_ARRAY_SIZE(frames[0]);
+
+  BatchSamplingJob::Context batch_context(animation->num_tracks(),
+                                          kInstances);
+  SamplingJob::Context context(animation->num_tracks());
+
+  ozz::math::SoaTransform batch_output[kInstances][2];
+  ozz::math::SoaTransform expected[2];
+  ozz::span<ozz::math::SoaTransform> outputs[kInstances];
+  for (size_t i = 0; i < kInstances; ++i) {
+    outputs[i] = batch_output[i];
+  }
+
+  for (const auto& ratios : frames) {
+    memset(batch_output, 0xde, sizeof(batch_output));
+
+    BatchSamplingJob batch_job;
+    batch_job.animation = animation.get();
+    batch_job.context = &batch_context;
+    batch_job.ratios = ratios;
+    batch_job.outputs = outputs;
+    ASSERT_TRUE(batch_job.Run());
+
+    // Compares with independent sampling jobs.
+    for (size_t i = 0; i < kInstances; ++i) {
+      context.Invalidate();
+      SamplingJob job;
+      job.animation = animation.get();
+      job.context = &context;
+      job.ratio = ratios[i];
+      job.output = expected;
+      ASSERT_TRUE(job.Run());
+
+      for (size_t j = 0; j < OZZ_ARRAY_SIZE(expected); ++j) {
+        EXPECT_EQ(
+            memcmp(&batch_output[i][j], &expected[j], sizeof(expected[j])), 0);
+      }
+    }
+  }
+}
+
+TEST(SamplingClusters, BatchSamplingJob) {
+  const ozz::unique_ptr<Animation> animation = BuildAnimation();
+  ASSERT_TRUE(animation);
+
+  const size_t kInstances = 16;
+  BatchSamplingJob::Context batch_context(animation->num_tracks(),
+                                          kInstances);
+  SamplingJob::Context context(animation->num_tracks());
+
+  ozz::math::SoaTransform batch_output[kInstances][2];
+  ozz::math::SoaTransform expected[2];
+  ozz::span<ozz::math::SoaTransform> outputs[kInstances];
+  for (size_t i = 0; i < kInstances; ++i) {
+    outputs[i] = batch_output[i];
+  }
+
+  // Instances move forward together, packed in a dense crowd (sampled as a
+  // cluster) first, then spread over the animation (sampled independently),
+  // then packed again.
+  float ratios[kInstances];
+  for (int frame = 0; frame < 60; ++frame) {
+    const bool dense = frame < 20 || frame >= 40;
+    for (size_t i = 0; i < kInstances; ++i) {
+      const float offset = dense ? i * .001f : i * .06f;
+      ratios[i] = frame * .01f + offset;
+    }
+
+    BatchSamplingJob batch_job;
+    batch_job.animation = animation.get();
+    batch_job.context = &batch_context;
+    batch_job.ratios = ratios;
+    batch_job.outputs = outputs;
+    ASSERT_TRUE(batch_job.Run());
+
+    // Compares with independent sampling jobs.
+    for (size_t i = 0; i < kInstances; ++i) {
+      context.Invalidate();
+      SamplingJob job;
+      job.animation = animation.get();
+      job.context = &context;
+      job.ratio = ratios[i];
+      job.output = expected;
+      ASSERT_TRUE(job.Run());
+
+      for (size_t j = 0; j < OZZ_ARRAY_SIZE(expected); ++j) {
+        EXPECT_EQ(
+            memcmp(&batch_output[i][j], &expected[j], sizeof(expected[j])), 0);
+      }
+    }
+  }
+}
+
+TEST(SamplingSmallOutput, BatchSamplingJob) {
+  const ozz::unique_ptr<Animation> animation = BuildAnimation();
+  ASSERT_TRUE(animation);
+
+  BatchSamplingJob::Context context(animation->num_tracks(), 2);
+
+  // Same ratios, but the first output is smaller than the second one, so the
+  // second one can't be copied from the first one.
+  ozz::math::SoaTransform output0[1];
+  ozz::math::SoaTransform output1[2];
+  memset(output1, 0xde, sizeof(output1));
+  const ozz::span<ozz::math::SoaTransform> outputs[] = {output0, output1};
+  const float ratios[] = {.4f, .4f};
+
+  BatchSamplingJob job;
+  job.animation = animation.get();
+  job.context = &context;
+  job.ratios = ratios;
+  job.outputs = outputs;
+  ASSERT_TRUE(job.Run());
+
+  SamplingJob::Context sampling_context(animation->num_tracks());
+  ozz::math::SoaTransform expected[2];
+  SamplingJob sampling_job;
+  sampling_job.animation = animation.get();
+  sampling_job.context = &sampling_context;
+  sampling_job.ratio = .4f;
+  sampling_job.output = expected;
+  ASSERT_TRUE(sampling_job.Run());
+
+  EXPECT_EQ(memcmp(output0, expected, sizeof(output0)), 0);
+  EXPECT_EQ(memcmp(output1, expected, sizeof(output1)), 0);
+}
@@ -25,6 +25,9 @@
 //                                                                            //
 //----------------------------------------------------------------------------//
 
+#include <algorithm>
+#include <cstdlib>
+
 #include "gtest/gtest.h"
 #include "ozz/animation/runtime/blending_job.h"
 #include "ozz/base/log.h"
@@ -889,3 +892,283 @@ TEST(AdditiveJointWeight, BlendingJob) {
                             1.f / 20.f, 1.f / 11.f, 1.f, 1.f);
   }
 }
+
+TEST(JobValiditySparse, BlendingJob) {
+  const ozz::math::SoaTransform identity = ozz::math::SoaTransform::identity();
+  const ozz::math::SoaTransform rest_poses[3] = {identity, identity, identity};
+  const ozz::math::SoaTransform input_transforms[3] = {identity, identity,
+                                                       identity};
+  ozz::math::SoaTransform output_transforms[3];
+
+  BlendingJob::Layer layers[1];
+  layers[0].transform = input_transforms;
+
+  BlendingJob job;
+  job.layers = layers;
+  job.additive_layers = layers;
+  job.rest_pose = rest_poses;
+  job.output = output_transforms;
+  EXPECT_TRUE(job.Validate());
+
+  {  // Valid list
+    const uint16_t soa_joints[] = {0, 2};
+    layers[0].soa_joints = soa_joints;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Unsorted list
+    const uint16_t soa_joints[] = {2, 0};
+    layers[0].soa_joints = soa_joints;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Duplicated joints
+    const uint16_t soa_joints[] = {1, 1};
+    layers[0].soa_joints = soa_joints;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Out of range
+    const uint16_t soa_joints[] = {0, 3};
+    layers[0].soa_joints = soa_joints;
+    EXPECT_FALSE(job.Validate());
+  }
+  layers[0].soa_joints = {};
+
+  {  // Min layer weight
+    job.min_layer_weight = .1f;
+    EXPECT_TRUE(job.Validate());
+    job.min_layer_weight = -.1f;
+    EXPECT_FALSE(job.Validate());
+  }
+}
+
+TEST(ExtractLayerSoaJoints, BlendingJob) {
+  const ozz::math::SimdFloat4 joint_weights[5] = {
+      ozz::math::simd_float4::zero(),
+      ozz::math::simd_float4::Load(0.f, 0.f, .1f, 0.f),
+      ozz::math::simd_float4::Load(-1.f, 0.f, 0.f, 0.f),
+      ozz::math::simd_float4::one(),
+      ozz::math::simd_float4::Load(0.f, -1.f, -2.f, -3.f)};
+
+  uint16_t soa_joints[5];
+  size_t count = 46;
+  ASSERT_TRUE(
+      ozz::animation::ExtractLayerSoaJoints(joint_weights, soa_joints, &count));
+  ASSERT_EQ(count, 2u);
+  EXPECT_EQ(soa_joints[0], 1);
+  EXPECT_EQ(soa_joints[1], 3);
+
+  // Output is too small.
+  count = 46;
+  EXPECT_FALSE(ozz::animation::ExtractLayerSoaJoints(
+      joint_weights, ozz::make_span(soa_joints).first(4), &count));
+  EXPECT_EQ(count, 46u);
+
+  // No count.
+  EXPECT_FALSE(ozz::animation::ExtractLayerSoaJoints(joint_weights,
+                                                     soa_joints, nullptr));
+
+  // No joint affected, which is distinguished from a failure.
+  EXPECT_TRUE(ozz::animation::ExtractLayerSoaJoints(
+      ozz::make_span(joint_weights).first(1), soa_joints, &count));
+  EXPECT_EQ(count, 0u);
+
+  // Empty input.
+  count = 46;
+  EXPECT_TRUE(ozz::animation::ExtractLayerSoaJoints(
+      ozz::span<const ozz::math::SimdFloat4>(), soa_joints, &count));
+  EXPECT_EQ(count, 0u);
+}
+
+namespace {
+// Compares soa transforms, rotations being compared regardless of their sign
+// as q and -q are the same rotation.
+void ExpectSoaTransformNear(const ozz::math::SoaTransform& _a,
+                            const ozz::math::SoaTransform& _b, float _tol) {
+  float a[10][4], b[10][4];
+  const ozz::math::SimdFloat4* simd_a = &_a.translation.x;
+  const ozz::math::SimdFloat4* simd_b = &_b.translation.x;
+  for (int i = 0; i < 10; ++i) {
+    ozz::math::StorePtrU(simd_a[i], a[i]);
+    ozz::math::StorePtrU(simd_b[i], b[i]);
+  }
+  for (int j = 0; j < 4; ++j) {
+    const float dot =
+        a[3][j] * b[3][j] + a[4][j] * b[4][j] + a[5][j] * b[5][j] +
+        a[6][j] * b[6][j];
+    const float sign = dot < 0.f ? -1.f : 1.f;
+    for (int i = 0; i < 10; ++i) {
+      const bool rotation = i >= 3 && i < 7;
+      EXPECT_NEAR(a[i][j], (rotation ? sign : 1.f) * b[i][j], _tol);
+    }
+  }
+}
+
+float Random(float _min, float _max) {
+  return _min + (_max - _min) * static_cast<float>(rand()) / RAND_MAX;
+}
+}  // namespace
+
+TEST(Sparse, BlendingJob) {
+  const int kNumSoaJoints = 8;
+
+  // Random inputs.
+  ozz::math::SoaTransform rest_poses[kNumSoaJoints];
+  ozz::math::SoaTransform input_transforms[3][kNumSoaJoints];
+  for (int i = 0; i < 4; ++i) {
+    ozz::math::SoaTransform* transforms =
+        i == 0 ? rest_poses : input_transforms[i - 1];
+    for (int j = 0; j < kNumSoaJoints; ++j) {
+      ozz::math::SimdFloat4 t[4], r[4], s[4];
+      for (int k = 0; k < 4; ++k) {
+        t[k] = ozz::math::simd_float4::Load(
+            Random(-1.f, 1.f), Random(-1.f, 1.f), Random(-1.f, 1.f), 0.f);
+        r[k] = ozz::math::NormalizeSafe4(
+            ozz::math::simd_float4::Load(Random(-1.f, 1.f), Random(-1.f, 1.f),
+                                         Random(-1.f, 1.f), Random(-1.f, 1.f)),
+            ozz::math::simd_float4::w_axis());
+        s[k] = ozz::math::simd_float4::Load(
+            Random(.5f, 2.f), Random(.5f, 2.f), Random(.5f, 2.f), 0.f);
+      }
+      ozz::math::SimdFloat4 soa[4];
+      ozz::math::Transpose4x3(t, soa);
+      transforms[j].translation = {soa[0], soa[1], soa[2]};
+      ozz::math::Transpose4x4(r, soa);
+      transforms[j].rotation = {soa[0], soa[1], soa[2], soa[3]};
+      ozz::math::Transpose4x3(s, soa);
+      transforms[j].scale = {soa[0], soa[1], soa[2]};
+    }
+  }
+
+  // Joint weights, each layer only affects a few joints.
+  ozz::math::SimdFloat4 joint_weights[3][kNumSoaJoints];
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < kNumSoaJoints; ++j) {
+      joint_weights[i][j] = ozz::math::simd_float4::zero();
+    }
+  }
+  joint_weights[0][2] = ozz::math::simd_float4::Load(1.f, .5f, 0.f, .2f);
+  joint_weights[0][5] = ozz::math::simd_float4::one();
+  joint_weights[1][1] = ozz::math::simd_float4::Load(0.f, .3f, 0.f, .7f);
+  joint_weights[1][2] = ozz::math::simd_float4::one();
+  joint_weights[1][3] = ozz::math::simd_float4::one();
+  joint_weights[2][6] = ozz::math::simd_float4::Load(.5f, .5f, 0.f, 1.f);
+
+  uint16_t soa_joints_buffer[3][kNumSoaJoints];
+  ozz::span<uint16_t> soa_joints[3];
+  for (int i = 0; i < 3; ++i) {
+    size_t count = 0;
+    ASSERT_TRUE(ozz::animation::ExtractLayerSoaJoints(
+        joint_weights[i], soa_joints_buffer[i], &count));
+    ASSERT_NE(count, 0u);
+    soa_joints[i] = ozz::make_span(soa_joints_buffer[i]).first(count);
+  }
+
+  // Tests dense and sparse layers match, with a full layer or a sparse layer
+  // first, with or without joint weights.
+  for (int first_full = 0; first_full < 2; ++first_full) {
+    for (int with_weights = 0; with_weights < 2; ++with_weights) {
+      BlendingJob::Layer layers[3];
+      BlendingJob::Layer additive_layers[1];
+      for (int i = 0; i < 2; ++i) {
+        layers[i].weight = .4f + i * .3f;
+        layers[i].transform = input_transforms[i];
+        layers[i].joint_weights = joint_weights[i];
+      }
+      layers[2].weight = first_full ? .5f : 0.f;
+      layers[2].transform = input_transforms[2];
+      additive_layers[0].weight = .6f;
+      additive_layers[0].transform = input_transforms[2];
+      additive_layers[0].joint_weights = joint_weights[2];
+
+      BlendingJob job;
+      job.layers = layers;
+      job.additive_layers = additive_layers;
+      job.rest_pose = rest_poses;
+
+      // Without joints list. Without joint weights, sparse joints have a
+      // weight of 1, which is also what dense joint weights must be then.
+      ozz::math::SimdFloat4 unit_weights[2][kNumSoaJoints];
+      if (!with_weights) {
+        for (int i = 0; i < 2; ++i) {
+          for (int j = 0; j < kNumSoaJoints; ++j) {
+            const bool listed =
+                std::find(soa_joints[i].begin(), soa_joints[i].end(), j) !=
+                soa_joints[i].end();
+            unit_weights[i][j] = ozz::math::simd_float4::Load1(listed);
+          }
+          layers[i].joint_weights = unit_weights[i];
+        }
+      }
+      ozz::math::SoaTransform expected[kNumSoaJoints];
+      job.output = expected;
+      ASSERT_TRUE(job.Run());
+
+      // With joints lists.
+      for (int i = 0; i < 2; ++i) {
+        layers[i].soa_joints = soa_joints[i];
+        if (!with_weights) {
+          layers[i].joint_weights = {};
+        }
+      }
+      additive_layers[0].soa_joints = soa_joints[2];
+      ozz::math::SoaTransform output[kNumSoaJoints];
+      job.output = output;
+      ASSERT_TRUE(job.Run());
+
+      // Additive layer dense pass applies estimated identity to joints that
+      // aren't listed, hence the tolerance.
+      for (int j = 0; j < kNumSoaJoints; ++j) {
+        ExpectSoaTransformNear(output[j], expected[j], 1e-3f);
+      }
+    }
+  }
+}
+
+TEST(MinLayerWeight, BlendingJob) {
+  const ozz::math::SoaTransform identity = ozz::math::SoaTransform::identity();
+  ozz::math::SoaTransform input_transforms[2][1] = {{identity}, {identity}};
+  input_transforms[0][0].translation = ozz::math::SoaFloat3::Load(
+      ozz::math::simd_float4::Load(2.f, 3.f, 4.f, 5.f),
+      ozz::math::simd_float4::Load(6.f, 7.f, 8.f, 9.f),
+      ozz::math::simd_float4::Load(10.f, 11.f, 12.f, 13.f));
+  input_transforms[1][0].translation = ozz::math::SoaFloat3::Load(
+      ozz::math::simd_float4::Load(3.f, 4.f, 5.f, 6.f),
+      ozz::math::simd_float4::Load(7.f, 8.f, 9.f, 10.f),
+      ozz::math::simd_float4::Load(11.f, 12.f, 13.f, 14.f));
+  const ozz::math::SoaTransform rest_poses[1] = {identity};
+
+  BlendingJob::Layer layers[2];
+  layers[0].weight = 1.f;
+  layers[0].transform = input_transforms[0];
+  layers[1].weight = .05f;
+  layers[1].transform = input_transforms[1];
+  BlendingJob::Layer additive_layers[1];
+  additive_layers[0].weight = -.05f;
+  additive_layers[0].transform = input_transforms[1];
+
+  ozz::math::SoaTransform output_transforms[1];
+  BlendingJob job;
+  job.layers = layers;
+  job.additive_layers = additive_layers;
+  job.rest_pose = rest_poses;
+  job.output = output_transforms;
+
+  {  // Second layer is skipped, as well as additive one.
+    job.min_layer_weight = .05f;
+    EXPECT_TRUE(job.Run());
+    EXPECT_SOAFLOAT3_EQ(output_transforms[0].translation, 2.f, 3.f, 4.f, 5.f,
+                        6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f, 13.f);
+  }
+
+  {  // Layers are blended, and additive layer subtracted.
+    job.min_layer_weight = 0.f;
+    EXPECT_TRUE(job.Run());
+    EXPECT_SOAFLOAT3_EQ(output_transforms[0].translation, 1.897619f,
+                        2.847619f, 3.797619f, 4.747619f, 5.697619f, 6.647619f,
+                        7.597619f, 8.547619f, 9.497619f, 10.44762f, 11.39762f,
+                        12.34762f);
+  }
+}
@@ -0,0 +1,439 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/character_update_job.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ozz/animation/offline/animation_builder.h"
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/blending_job.h"
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/memory/unique_ptr.h"
+#include "ozz/base/scheduler.h"
+
+using ozz::animation::Animation;
+using ozz::animation::BlendingJob;
+using ozz::animation::CharacterUpdateJob;
+using ozz::animation::LocalToModelJob;
+using ozz::animation::SamplingJob;
+using ozz::animation::Skeleton;
+using ozz::animation::offline::AnimationBuilder;
+using ozz::animation::offline::RawAnimation;
+using ozz::animation::offline::RawSkeleton;
+using ozz::animation::offline::SkeletonBuilder;
+
+namespace {
+const int kNumJoints = 7;
+
+// Builds a skeleton made of a chain of 7 joints.
+ozz::unique_ptr<Skeleton> BuildSkeleton() {
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint* joint = &raw_skeleton.roots[0];
+  for (int i = 0; i < kNumJoints; ++i) {
+    const char name[] = {'j', static_cast<char>('0' + i), 0};
+    joint->name = name;
+    joint->transform = ozz::math::Transform::identity();
+    joint->transform.translation = ozz::math::Float3(0.f, 1.f, 0.f);
+    if (i != kNumJoints - 1) {
+      joint->children.resize(1);
+      joint = &joint->children[0];
+    }
+  }
+  SkeletonBuilder builder;
+  return builder(raw_skeleton);
+}
+
+// Builds an animation with 7 tracks, with values offset by _offset.
+ozz::unique_ptr<Animation> BuildAnimation(float _offset) {
+  RawAnimation raw_animation;
+  raw_animation.duration = 2.f;
+  raw_animation.tracks.resize(kNumJoints);
+  for (size_t i = 0; i < raw_animation.tracks.size(); ++i) {
+    RawAnimation::JointTrack& track = raw_animation.tracks[i];
+    for (size_t k = 0; k < 4; ++k) {
+      const float time = raw_animation.duration * k / 4;
+      const float value = _offset + static_cast<float>(i + k) * .1f;
+      const RawAnimation::TranslationKey tkey = {
+          time, ozz::math::Float3(value, 1.f, -value)};
+      track.translations.push_back(tkey);
+      const RawAnimation::RotationKey rkey = {
+          time, ozz::math::Quaternion::FromAxisAngle(
+                    ozz::math::Float3::z_axis(), value)};
+      track.rotations.push_back(rkey);
+      const RawAnimation::ScaleKey skey = {time, ozz::math::Float3(1.f)};
+      track.scales.push_back(skey);
+    }
+  }
+  AnimationBuilder builder;
+  return builder(raw_animation);
+}
+
+void ExpectMatricesNear(ozz::span<const ozz::math::Float4x4> _expected,
+                        ozz::span<const ozz::math::Float4x4> _actual) {
+  ASSERT_EQ(_expected.size(), _actual.size());
+  for (size_t i = 0; i < _expected.size(); ++i) {
+    for (int c = 0; c < 4; ++c) {
+      float expected[4];
+      float actual[4];
+      ozz::math::StorePtrU(_expected[i].cols[c], expected);
+      ozz::math::StorePtrU(_actual[i].cols[c], actual);
+      for (int r = 0; r < 4; ++r) {
+        EXPECT_NEAR(expected[r], actual[r], 1e-5f);
+      }
+    }
+  }
+}
+
+// Computes expected model-space matrices, running jobs one by one.
+void UpdateReference(const Skeleton& _skeleton,
+                     ozz::span<const CharacterUpdateJob::Layer> _layers,
+                     ozz::span<ozz::math::Float4x4> _models) {
+  std::vector<std::vector<ozz::math::SoaTransform>> locals(_layers.size());
+  std::vector<BlendingJob::Layer> blend_layers(_layers.size());
+  for (size_t i = 0; i < _layers.size(); ++i) {
+    SamplingJob::Context context(_skeleton.num_joints());
+    locals[i].resize(_skeleton.num_soa_joints());
+    SamplingJob sampling_job;
+    sampling_job.animation = _layers[i].animation;
+    sampling_job.context = &context;
+    sampling_job.ratio = _layers[i].ratio;
+    sampling_job.output = ozz::make_span(locals[i]);
+    ASSERT_TRUE(sampling_job.Run());
+    blend_layers[i].transform = ozz::make_span(locals[i]);
+    blend_layers[i].weight = _layers[i].weight;
+    blend_layers[i].joint_weights = _layers[i].joint_weights;
+  }
+
+  std::vector<ozz::math::SoaTransform> blended(_skeleton.num_soa_joints());
+  BlendingJob blending_job;
+  blending_job.layers = ozz::make_span(blend_layers);
+  blending_job.rest_pose = _skeleton.joint_rest_poses();
+  blending_job.output = ozz::make_span(blended);
+  ASSERT_TRUE(blending_job.Run());
+
+  LocalToModelJob ltm_job;
+  ltm_job.skeleton = &_skeleton;
+  ltm_job.input = ozz::make_span(blended);
+  ltm_job.output = _models;
+  ASSERT_TRUE(ltm_job.Run());
+}
+
+}  // namespace
+
+TEST(JobValidity, CharacterUpdateJob) {
+  const ozz::unique_ptr<Skeleton> skeleton = BuildSkeleton();
+  ASSERT_TRUE(skeleton);
+  const ozz::unique_ptr<Animation> animation = BuildAnimation(0.f);
+  ASSERT_TRUE(animation);
+
+  SamplingJob::Context sampling_context(kNumJoints);
+  CharacterUpdateJob::Context context(kNumJoints, 2, 2);
+  ozz::math::Float4x4 models[kNumJoints];
+
+  CharacterUpdateJob::Layer layers[3];
+  for (CharacterUpdateJob::Layer& layer : layers) {
+    layer.animation = animation.get();
+    layer.context = &sampling_context;
+  }
+  CharacterUpdateJob::Character character;
+  character.skeleton = skeleton.get();
+  character.layers = ozz::make_span(layers).first(1);
+  character.models = models;
+
+  {  // Empty/default job
+    CharacterUpdateJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // No character is valid.
+    CharacterUpdateJob job;
+    job.context = &context;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Valid job.
+    CharacterUpdateJob job;
+    job.context = &context;
+    job.characters = {&character, 1};
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Invalid skeleton.
+    CharacterUpdateJob::Character invalid = character;
+    invalid.skeleton = nullptr;
+    CharacterUpdateJob job;
+    job.context = &context;
+    job.characters = {&invalid, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // No layer.
+    CharacterUpdateJob::Character invalid = character;
+    invalid.layers = {};
+    CharacterUpdateJob job;
+    job.context = &context;
+    job.characters = {&invalid, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Too many layers for the context.
+    CharacterUpdateJob::Character invalid = character;
+    invalid.layers = ozz::make_span(layers).first(2);
+    invalid.additive_layers = ozz::make_span(layers).first(1);
+    CharacterUpdateJob job;
+    job.context = &context;
+    job.characters = {&invalid, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid layer animation.
+    CharacterUpdateJob::Layer invalid_layer = layers[0];
+    invalid_layer.animation = nullptr;
+    CharacterUpdateJob::Character invalid = character;
+    invalid.layers = {&invalid_layer, 1};
+    CharacterUpdateJob job;
+    job.context = &context;
+    job.characters = {&invalid, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid layer sampling context.
+    SamplingJob::Context small_context(3);
+    CharacterUpdateJob::Layer invalid_layer = layers[0];
+    invalid_layer.context = &small_context;
+    CharacterUpdateJob::Character invalid = character;
+    invalid.layers = {&invalid_layer, 1};
+    CharacterUpdateJob job;
+    job.context = &context;
+    job.characters = {&invalid, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Context too small for skeleton.
+    CharacterUpdateJob::Context small_context(3, 2, 2);
+    CharacterUpdateJob job;
+    job.context = &small_context;
+    job.characters = {&character, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Context too small for scheduler.
+    ozz::ThreadPoolScheduler scheduler(2);
+    CharacterUpdateJob job;
+    job.context = &context;
+    job.scheduler = &scheduler;
+    job.characters = {&character, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid models output.
+    CharacterUpdateJob::Character invalid = character;
+    invalid.models = ozz::make_span(models).first(kNumJoints - 1);
+    CharacterUpdateJob job;
+    job.context = &context;
+    job.characters = {&invalid, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  const ozz::math::Float4x4 inverse_bind_poses[2] = {
+      ozz::math::Float4x4::identity(), ozz::math::Float4x4::identity()};
+  ozz::math::Float4x4 skinning_matrices[2];
+  {  // Skinning matrices, remaps and inverse bind poses mismatch.
+    const uint16_t remaps[] = {0};
+    CharacterUpdateJob::Character invalid = character;
+    invalid.inverse_bind_poses = inverse_bind_poses;
+    invalid.joint_remaps = remaps;
+    invalid.skinning_matrices = skinning_matrices;
+    CharacterUpdateJob job;
+    job.context = &context;
+    job.characters = {&invalid, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Skinning matrices, invalid remap.
+    const uint16_t remaps[] = {0, kNumJoints};
+    CharacterUpdateJob::Character invalid = character;
+    invalid.inverse_bind_poses = inverse_bind_poses;
+    invalid.joint_remaps = remaps;
+    invalid.skinning_matrices = skinning_matrices;
+    CharacterUpdateJob job;
+    job.context = &context;
+    job.characters = {&invalid, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid skinning matrices.
+    const uint16_t remaps[] = {0, kNumJoints - 1};
+    CharacterUpdateJob::Character valid = character;
+    valid.inverse_bind_poses = inverse_bind_poses;
+    valid.joint_remaps = remaps;
+    valid.skinning_matrices = skinning_matrices;
+    CharacterUpdateJob job;
+    job.context = &context;
+    job.characters = {&valid, 1};
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+}
+
+TEST(Update, CharacterUpdateJob) {
+  const ozz::unique_ptr<Skeleton> skeleton = BuildSkeleton();
+  ASSERT_TRUE(skeleton);
+  const ozz::unique_ptr<Animation> animation0 = BuildAnimation(0.f);
+  ASSERT_TRUE(animation0);
+  const ozz::unique_ptr<Animation> animation1 = BuildAnimation(.5f);
+  ASSERT_TRUE(animation1);
+
+  // Builds characters with one or two layers, at different times.
+  const int kNumCharacters = 9;
+  std::vector<SamplingJob::Context> sampling_contexts(kNumCharacters * 2);
+  std::vector<CharacterUpdateJob::Layer> layers(kNumCharacters * 2);
+  std::vector<CharacterUpdateJob::Character> characters(kNumCharacters);
+  std::vector<ozz::math::Float4x4> models(kNumCharacters * kNumJoints);
+  for (int c = 0; c < kNumCharacters; ++c) {
+    for (int l = 0; l < 2; ++l) {
+      CharacterUpdateJob::Layer& layer = layers[c * 2 + l];
+      sampling_contexts[c * 2 + l].Resize(kNumJoints);
+      layer.context = &sampling_contexts[c * 2 + l];
+      layer.animation = l == 0 ? animation0.get() : animation1.get();
+      layer.ratio = c / (kNumCharacters - 1.f);
+      layer.weight = l == 0 ? .7f : .3f;
+    }
+    CharacterUpdateJob::Character& character = characters[c];
+    character.skeleton = skeleton.get();
+    character.layers = {&layers[c * 2], static_cast<size_t>(1 + c % 2)};
+    character.models = {&models[c * kNumJoints], kNumJoints};
+  }
+
+  // Computes reference.
+  std::vector<ozz::math::Float4x4> expected(kNumCharacters * kNumJoints);
+  for (int c = 0; c < kNumCharacters; ++c) {
+    UpdateReference(*skeleton, characters[c].layers,
+                    {&expected[c * kNumJoints], kNumJoints});
+  }
+
+  {  // Runs on the calling thread.
+    CharacterUpdateJob::Context context(kNumJoints, 2, 1);
+    CharacterUpdateJob job;
+    job.characters = ozz::make_span(characters);
+    job.context = &context;
+    ASSERT_TRUE(job.Run());
+    ExpectMatricesNear(ozz::make_span(expected), ozz::make_span(models));
+  }
+
+  {  // Runs with a scheduler.
+    std::fill(models.begin(), models.end(), ozz::math::Float4x4::identity());
+    ozz::ThreadPoolScheduler scheduler(2);
+    CharacterUpdateJob::Context context(kNumJoints, 2,
+                                        scheduler.num_workers());
+    CharacterUpdateJob::Timings timings;
+    CharacterUpdateJob job;
+    job.characters = ozz::make_span(characters);
+    job.context = &context;
+    job.scheduler = &scheduler;
+    job.timings = &timings;
+    ASSERT_TRUE(job.Run());
+    ExpectMatricesNear(ozz::make_span(expected), ozz::make_span(models));
+
+    for (int s = 0; s < CharacterUpdateJob::kNumStages; ++s) {
+      EXPECT_GE(timings.stages[s], 0.);
+    }
+    EXPECT_GT(timings.stages[CharacterUpdateJob::kSampling], 0.);
+  }
+}
+
+TEST(SkinningMatrices, CharacterUpdateJob) {
+  const ozz::unique_ptr<Skeleton> skeleton = BuildSkeleton();
+  ASSERT_TRUE(skeleton);
+  const ozz::unique_ptr<Animation> animation = BuildAnimation(0.f);
+  ASSERT_TRUE(animation);
+
+  SamplingJob::Context sampling_context(kNumJoints);
+  CharacterUpdateJob::Layer layer;
+  layer.animation = animation.get();
+  layer.context = &sampling_context;
+  layer.ratio = .3f;
+
+  ozz::math::Float4x4 models[kNumJoints];
+  const ozz::math::Float4x4 inverse_bind_poses[] = {
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(0.f, -1.f, 0.f, 0.f)),
+      ozz::math::Float4x4::Scaling(
+          ozz::math::simd_float4::Load(2.f, 2.f, 2.f, 0.f)),
+      ozz::math::Float4x4::identity()};
+  const uint16_t remaps[] = {1, 6, 3};
+  ozz::math::Float4x4 skinning_matrices[3];
+
+  CharacterUpdateJob::Character character;
+  character.skeleton = skeleton.get();
+  character.layers = {&layer, 1};
+  character.models = models;
+  character.inverse_bind_poses = inverse_bind_poses;
+  character.joint_remaps = remaps;
+  character.skinning_matrices = skinning_matrices;
+
+  CharacterUpdateJob::Context context(kNumJoints, 1, 1);
+  CharacterUpdateJob job;
+  job.characters = {&character, 1};
+  job.context = &context;
+  ASSERT_TRUE(job.Run());
+
+  ozz::math::Float4x4 expected[3];
+  for (int i = 0; i < 3; ++i) {
+    expected[i] = models[remaps[i]] * inverse_bind_poses[i];
+  }
+  ExpectMatricesNear(expected, skinning_matrices);
+
+  // Single layer skips blending, but matches a blended update.
+  ozz::math::Float4x4 reference[kNumJoints];
+  UpdateReference(*skeleton, character.layers, reference);
+  ExpectMatricesNear(reference, models);
+}
@@ -0,0 +1,280 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/runtime/event_query_job.h"
+
+#include <cstdlib>
+
+#include "gtest/gtest.h"
+#include "ozz/animation/offline/raw_track.h"
+#include "ozz/animation/offline/track_builder.h"
+#include "ozz/animation/runtime/track.h"
+#include "ozz/animation/runtime/track_event_index.h"
+#include "ozz/animation/runtime/track_triggering_job.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::animation::EventQueryJob;
+using ozz::animation::FloatTrack;
+using ozz::animation::TrackEventIndex;
+using ozz::animation::TrackTriggeringJob;
+using ozz::animation::offline::RawFloatTrack;
+using ozz::animation::offline::RawTrackInterpolation;
+using ozz::animation::offline::TrackBuilder;
+
+namespace {
+float Random(float _min, float _max) {
+  return _min + (_max - _min) * static_cast<float>(rand()) / RAND_MAX;
+}
+
+// Builds a track with _num_keys random and randomly stepped keys.
+RawFloatTrack BuildRandomRawTrack(int _num_keys) {
+  RawFloatTrack raw_track;
+  for (int i = 0; i < _num_keys; ++i) {
+    const RawFloatTrack::Keyframe key = {
+        rand() % 3 == 0 ? RawTrackInterpolation::kStep
+                        : RawTrackInterpolation::kLinear,
+        static_cast<float>(i) / _num_keys, Random(-1.f, 1.f)};
+    raw_track.keyframes.push_back(key);
+  }
+  return raw_track;
+}
+}  // namespace
+
+TEST(Builder, TrackEventIndex) {
+  TrackBuilder builder;
+
+  {  // No track
+    const ozz::unique_ptr<TrackEventIndex> index =
+        builder(ozz::span<const RawFloatTrack>(), .5f);
+    ASSERT_TRUE(index);
+    EXPECT_EQ(index->num_tracks(), 0);
+    EXPECT_FLOAT_EQ(index->threshold(), .5f);
+  }
+
+  {  // Invalid track
+    RawFloatTrack raw_tracks[2];
+    const RawFloatTrack::Keyframe key = {RawTrackInterpolation::kLinear, 2.f,
+                                         0.f};
+    raw_tracks[1].keyframes.push_back(key);
+    EXPECT_FALSE(builder(ozz::make_span(raw_tracks), 0.f));
+  }
+
+  {  // Edges
+    RawFloatTrack raw_tracks[3];
+    const RawFloatTrack::Keyframe keys[] = {
+        {RawTrackInterpolation::kLinear, 0.f, 0.f},
+        {RawTrackInterpolation::kStep, .5f, 2.f},
+        {RawTrackInterpolation::kLinear, .7f, 0.f}};
+    raw_tracks[0].keyframes.assign(std::begin(keys), std::end(keys));
+    // raw_tracks[1] is empty.
+    raw_tracks[2].keyframes.push_back(keys[1]);
+
+    const ozz::unique_ptr<TrackEventIndex> index =
+        builder(ozz::make_span(raw_tracks), 1.f);
+    ASSERT_TRUE(index);
+    EXPECT_EQ(index->num_tracks(), 3);
+    ASSERT_EQ(index->offsets().size(), 4u);
+    EXPECT_EQ(index->offsets()[0], 0u);
+    EXPECT_EQ(index->offsets()[1], 2u);
+    EXPECT_EQ(index->offsets()[2], 2u);
+    EXPECT_EQ(index->offsets()[3], 2u);
+    ASSERT_EQ(index->ratios().size(), 2u);
+    EXPECT_FLOAT_EQ(index->ratios()[0], .25f);
+    EXPECT_FLOAT_EQ(index->ratios()[1], .7f);
+    EXPECT_EQ(index->rising()[0], 1);
+  }
+}
+
+TEST(JobValidity, EventQueryJob) {
+  TrackBuilder builder;
+  RawFloatTrack raw_tracks[2];
+  const ozz::unique_ptr<TrackEventIndex> index =
+      builder(ozz::make_span(raw_tracks), 0.f);
+  ASSERT_TRUE(index);
+
+  size_t num_events;
+  EventQueryJob::Event events[4];
+  const EventQueryJob::Query queries[] = {{0, 0.f, 1.f}, {1, 0.f, 1.f}};
+
+  {  // Default job
+    EventQueryJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // No index
+    EventQueryJob job;
+    job.num_events = &num_events;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // No output
+    EventQueryJob job;
+    job.index = index.get();
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Valid, no query
+    EventQueryJob job;
+    job.index = index.get();
+    job.num_events = &num_events;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+    EXPECT_EQ(num_events, 0u);
+  }
+
+  {  // Valid
+    EventQueryJob job;
+    job.index = index.get();
+    job.queries = queries;
+    job.events = events;
+    job.num_events = &num_events;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Invalid track
+    const EventQueryJob::Query invalid_queries[] = {{2, 0.f, 1.f}};
+    EventQueryJob job;
+    job.index = index.get();
+    job.queries = invalid_queries;
+    job.num_events = &num_events;
+    EXPECT_FALSE(job.Validate());
+
+    const EventQueryJob::Query negative_queries[] = {{-1, 0.f, 1.f}};
+    job.queries = negative_queries;
+    EXPECT_FALSE(job.Validate());
+  }
+}
+
+TEST(MatchTriggering, EventQueryJob) {
+  TrackBuilder builder;
+
+  // Builds random tracks, and the index of their edges.
+  const int num_keys[] = {0, 1, 2, 5, 16, 64};
+  const int kNumTracks = OZZ_ARRAY_SIZE(num_keys);
+  RawFloatTrack raw_tracks[kNumTracks];
+  ozz::unique_ptr<FloatTrack> tracks[kNumTracks];
+  for (int i = 0; i < kNumTracks; ++i) {
+    raw_tracks[i] = BuildRandomRawTrack(num_keys[i]);
+    tracks[i] = builder(raw_tracks[i]);
+    ASSERT_TRUE(tracks[i]);
+  }
+  const float threshold = .1f;
+  const ozz::unique_ptr<TrackEventIndex> index =
+      builder(ozz::make_span(raw_tracks), threshold);
+  ASSERT_TRUE(index);
+
+  // Random queries, including loops, backward and empty ranges.
+  ozz::vector<EventQueryJob::Query> queries;
+  for (int i = 0; i < 1000; ++i) {
+    const float from = Random(-3.f, 3.f);
+    const float to = i % 10 == 0 ? from : from + Random(-2.5f, 2.5f);
+    const EventQueryJob::Query query = {i % kNumTracks, from, to};
+    queries.push_back(query);
+  }
+  // Integer bounds.
+  for (int i = 0; i < kNumTracks; ++i) {
+    const EventQueryJob::Query bounds[] = {
+        {i, 0.f, 1.f}, {i, 1.f, 0.f}, {i, -1.f, 2.f}, {i, 1.f, -2.f}};
+    queries.insert(queries.end(), std::begin(bounds), std::end(bounds));
+  }
+
+  ozz::vector<EventQueryJob::Event> events(1);
+  size_t num_events = 0;
+  EventQueryJob job;
+  job.index = index.get();
+  job.queries = make_span(queries);
+  job.num_events = &num_events;
+
+  // Runs once to get the number of events.
+  job.events = make_span(events);
+  ASSERT_TRUE(job.Run());
+  ASSERT_GT(num_events, events.size());
+
+  // Then with a big enough buffer.
+  const size_t total_events = num_events;
+  events.resize(total_events);
+  job.events = make_span(events);
+  ASSERT_TRUE(job.Run());
+  ASSERT_EQ(num_events, total_events);
+
+  // Compares with triggering job.
+  size_t e = 0;
+  for (size_t q = 0; q < queries.size(); ++q) {
+    const EventQueryJob::Query& query = queries[q];
+    TrackTriggeringJob::Iterator iterator;
+    TrackTriggeringJob triggering;
+    triggering.track = tracks[query.track].get();
+    triggering.threshold = threshold;
+    triggering.from = query.from;
+    triggering.to = query.to;
+    triggering.iterator = &iterator;
+    ASSERT_TRUE(triggering.Run());
+    for (; iterator != triggering.end(); ++iterator, ++e) {
+      ASSERT_LT(e, num_events);
+      EXPECT_EQ(events[e].query, static_cast<int>(q));
+      EXPECT_EQ(events[e].ratio, iterator->ratio);
+      EXPECT_EQ(events[e].rising, iterator->rising);
+    }
+  }
+  EXPECT_EQ(e, num_events);
+}
+
+TEST(Overflow, EventQueryJob) {
+  TrackBuilder builder;
+  RawFloatTrack raw_track;
+  const RawFloatTrack::Keyframe keys[] = {
+      {RawTrackInterpolation::kStep, 0.f, 0.f},
+      {RawTrackInterpolation::kStep, .5f, 1.f}};
+  raw_track.keyframes.assign(std::begin(keys), std::end(keys));
+  const ozz::unique_ptr<TrackEventIndex> index =
+      builder(ozz::span<const RawFloatTrack>(&raw_track, 1), .5f);
+  ASSERT_TRUE(index);
+
+  // 2 edges per loop, 3 loops.
+  const EventQueryJob::Query queries[] = {{0, 0.f, 3.f}};
+  EventQueryJob::Event events[4] = {};
+  size_t num_events = 0;
+  EventQueryJob job;
+  job.index = index.get();
+  job.queries = queries;
+  job.events = events;
+  job.num_events = &num_events;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(num_events, 6u);
+
+  // Only the first events are written.
+  const float ratios[4] = {0.f, .5f, 1.f, 1.5f};
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_FLOAT_EQ(events[i].ratio, ratios[i]);
+    EXPECT_EQ(events[i].rising, i % 2 == 1);
+    EXPECT_EQ(events[i].query, 0);
+  }
+}
@@ -0,0 +1,211 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/runtime/ik_aim_soa_job.h"
+
+#include <cstdlib>
+
+#include "gtest/gtest.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/simd_quaternion.h"
+#include "ozz/base/maths/soa_float4x4.h"
+#include "ozz/base/maths/soa_quaternion.h"
+
+namespace {
+float Random(float _min, float _max) {
+  return _min + (_max - _min) * static_cast<float>(rand()) / RAND_MAX;
+}
+
+ozz::math::SimdFloat4 RandomVector(float _range) {
+  return ozz::math::simd_float4::Load(Random(-_range, _range),
+                                      Random(-_range, _range),
+                                      Random(-_range, _range), 0.f);
+}
+
+ozz::math::SimdFloat4 RandomAxis() {
+  return ozz::math::NormalizeSafe3(RandomVector(1.f),
+                                   ozz::math::simd_float4::z_axis());
+}
+
+ozz::math::Float4x4 RandomTransform(float _range) {
+  const ozz::math::SimdQuaternion rotation = ozz::math::SimdQuaternion::
+      FromAxisAngle(RandomAxis(), ozz::math::simd_float4::Load1(
+                                      Random(-3.14f, 3.14f)));
+  return ozz::math::Float4x4::FromAffine(
+      RandomVector(_range), rotation.xyzw,
+      ozz::math::simd_float4::Load1(Random(.5f, 2.f)));
+}
+}  // namespace
+
+TEST(JobValidity, IKAimSoaJob) {
+  const ozz::math::SoaFloat4x4 joint = ozz::math::SoaFloat4x4::identity();
+  ozz::math::SoaQuaternion quat;
+
+  {  // Default is invalid
+    ozz::animation::IKAimSoaJob job;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Missing joint matrix
+    ozz::animation::IKAimSoaJob job;
+    job.joint_correction = &quat;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Missing output
+    ozz::animation::IKAimSoaJob job;
+    job.joint = &joint;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Unnormalized forward lane
+    ozz::animation::IKAimSoaJob job;
+    job.joint = &joint;
+    job.joint_correction = &quat;
+    job.forward.x = ozz::math::simd_float4::Load(1.f, .5f, 1.f, 1.f);
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Valid
+    ozz::animation::IKAimSoaJob job;
+    job.joint = &joint;
+    job.joint_correction = &quat;
+    EXPECT_TRUE(job.Validate());
+  }
+}
+
+TEST(JobValidity, IKAimBatchJob) {
+  const ozz::math::Float4x4 joint = ozz::math::Float4x4::identity();
+  ozz::math::SimdQuaternion quat;
+
+  ozz::animation::IKAimJob joints[2];
+  for (ozz::animation::IKAimJob& aim : joints) {
+    aim.joint = &joint;
+    aim.joint_correction = &quat;
+  }
+
+  {  // Empty is valid
+    ozz::animation::IKAimBatchJob job;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Valid
+    ozz::animation::IKAimBatchJob job;
+    job.joints = joints;
+    EXPECT_TRUE(job.Validate());
+  }
+
+  {  // One invalid joint
+    joints[1].forward = ozz::math::simd_float4::one();
+    ozz::animation::IKAimBatchJob job;
+    job.joints = joints;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+}
+
+TEST(Correction, IKAimSoaJob) {
+  const ozz::math::SimdFloat4 zero = ozz::math::simd_float4::zero();
+  const ozz::math::SoaFloat4x4 joint = ozz::math::SoaFloat4x4::identity();
+
+  ozz::animation::IKAimSoaJob job;
+  job.joint = &joint;
+  ozz::math::SoaQuaternion quat;
+  job.joint_correction = &quat;
+  ozz::math::SimdInt4 reached;
+  job.reached = &reached;
+
+  // Lanes aim at x (no correction), y, -x, and at the joint itself (too close).
+  job.target = ozz::math::SoaFloat3::Load(
+      ozz::math::simd_float4::Load(1.f, 0.f, -1.f, 0.f),
+      ozz::math::simd_float4::Load(0.f, 1.f, 0.f, 0.f), zero);
+  job.pole_vector = ozz::math::SoaFloat3::Load(
+      ozz::math::simd_float4::Load(0.f, -1.f, 0.f, 0.f),
+      ozz::math::simd_float4::Load(1.f, 0.f, 1.f, 1.f), zero);
+  ASSERT_TRUE(job.Run());
+
+  const float k = .7071067f;
+  EXPECT_SOAQUATERNION_EQ_EST(quat, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f,
+                              0.f, k, 0.f, 0.f, 1.f, k, 0.f, 1.f);
+  EXPECT_SIMDINT_EQ(reached, -1, -1, -1, -1);
+}
+
+TEST(MatchScalar, IKAimBatchJob) {
+  srand(0);
+
+  // Number of joints isn't a multiple of 4, to test batch padding.
+  const int kJoints = 43;
+  ozz::math::Float4x4 transforms[kJoints];
+  ozz::animation::IKAimJob joints[kJoints];
+  ozz::math::SimdQuaternion scalar_corrections[kJoints];
+  ozz::math::SimdQuaternion batch_corrections[kJoints];
+  bool scalar_reached[kJoints];
+  bool batch_reached[kJoints];
+
+  for (int i = 0; i < kJoints; ++i) {
+    transforms[i] = RandomTransform(10.f);
+    if (i == 7) {  // Zero scale joint
+      transforms[i] =
+          ozz::math::Float4x4::Scaling(ozz::math::simd_float4::zero());
+    }
+
+    ozz::animation::IKAimJob& aim = joints[i];
+    aim.joint = &transforms[i];
+    aim.target = transforms[i].cols[3] + RandomVector(3.f);
+    aim.forward = RandomAxis();
+    aim.up = RandomAxis();
+    aim.offset = i % 4 ? RandomVector(.5f) : ozz::math::simd_float4::zero();
+    aim.pole_vector = RandomAxis();
+    aim.twist_angle = i % 3 ? 0.f : Random(-1.f, 1.f);
+    static const float kWeights[] = {1.f, .5f, 0.f, 1.f, 2.f};
+    aim.weight = kWeights[i % 5];
+    aim.reached = &scalar_reached[i];
+    aim.joint_correction = &scalar_corrections[i];
+    ASSERT_TRUE(aim.Run());
+
+    // Redirects outputs for the batch job.
+    aim.reached = &batch_reached[i];
+    aim.joint_correction = &batch_corrections[i];
+  }
+
+  ozz::animation::IKAimBatchJob job;
+  job.joints = joints;
+  ASSERT_TRUE(job.Validate());
+  ASSERT_TRUE(job.Run());
+
+  for (int i = 0; i < kJoints; ++i) {
+    const ozz::math::SimdFloat4 expected = scalar_corrections[i].xyzw;
+    EXPECT_SIMDQUATERNION_EQ_TOL(
+        batch_corrections[i], ozz::math::GetX(expected),
+        ozz::math::GetY(expected), ozz::math::GetZ(expected),
+        ozz::math::GetW(expected), 2e-3f);
+    EXPECT_EQ(batch_reached[i], scalar_reached[i]);
+  }
+}
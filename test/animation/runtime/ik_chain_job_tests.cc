@@ -0,0 +1,363 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/runtime/ik_chain_job.h"
+
+#include "gtest/gtest.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/simd_quaternion.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::animation::IKChainJob;
+using ozz::animation::LocalToModelJob;
+using ozz::animation::Skeleton;
+using ozz::animation::offline::RawSkeleton;
+using ozz::animation::offline::SkeletonBuilder;
+
+namespace {
+// Builds a skeleton made of a single chain of _num_joints joints, each one
+// translated along x and slightly bent around z.
+ozz::unique_ptr<Skeleton> BuildChain(int _num_joints) {
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint* joint = &raw_skeleton.roots[0];
+  for (int i = 0; i < _num_joints; ++i) {
+    joint->name = std::to_string(i).c_str();
+    joint->transform = ozz::math::Transform::identity();
+    if (i != 0) {
+      joint->transform.translation = ozz::math::Float3(1.f, 0.f, 0.f);
+      joint->transform.rotation = ozz::math::Quaternion::FromAxisAngle(
+          ozz::math::Float3::z_axis(), .1f);
+    }
+    if (i != _num_joints - 1) {
+      joint->children.resize(1);
+      joint = &joint->children[0];
+    }
+  }
+  SkeletonBuilder builder;
+  return builder(raw_skeleton);
+}
+
+// Computes model-space matrices from local-space transforms.
+void ComputeModels(const Skeleton& _skeleton,
+                   ozz::span<const ozz::math::SoaTransform> _locals,
+                   ozz::span<ozz::math::Float4x4> _models) {
+  LocalToModelJob job;
+  job.skeleton = &_skeleton;
+  job.input = _locals;
+  job.output = _models;
+  ASSERT_TRUE(job.Run());
+}
+
+// Multiplies local-space rotation of _joint by _correction.
+void ApplyCorrection(int _joint, const ozz::math::SimdQuaternion& _correction,
+                     ozz::span<ozz::math::SoaTransform> _locals) {
+  ozz::math::SoaQuaternion& soa = _locals[_joint / 4].rotation;
+  ozz::math::SimdFloat4 aos[4];
+  ozz::math::Transpose4x4(&soa.x, aos);
+  const ozz::math::SimdQuaternion rotation = {aos[_joint % 4]};
+  aos[_joint % 4] = (rotation * _correction).xyzw;
+  ozz::math::Transpose4x4(aos, &soa.x);
+}
+
+// Fixture that solves a chain, applies corrections to the local-space
+// transforms and computes the corrected end joint position.
+struct ChainFixture {
+  explicit ChainFixture(int _num_joints)
+      : skeleton(BuildChain(_num_joints)),
+        chain(_num_joints),
+        corrections(_num_joints) {
+    const auto rest_poses = skeleton->joint_rest_poses();
+    locals.assign(rest_poses.begin(), rest_poses.end());
+    models.resize(skeleton->num_joints());
+    ComputeModels(*skeleton, make_span(locals), make_span(models));
+    for (int i = 0; i < _num_joints; ++i) {
+      chain[i] = i;
+    }
+    job.models = make_span(models);
+    job.chain = make_span(chain);
+    job.joint_corrections = make_span(corrections);
+    job.reached = &reached;
+    job.iterations = &iterations;
+    job.distance = &distance;
+  }
+
+  // Applies corrections and returns corrected end joint position.
+  ozz::math::SimdFloat4 Apply() {
+    ozz::vector<ozz::math::SoaTransform> corrected = locals;
+    for (size_t i = 0; i < chain.size(); ++i) {
+      ApplyCorrection(chain[i], corrections[i], make_span(corrected));
+    }
+    ozz::vector<ozz::math::Float4x4> corrected_models(models.size());
+    ComputeModels(*skeleton, make_span(corrected),
+                  make_span(corrected_models));
+    return corrected_models[chain.back()].cols[3];
+  }
+
+  ozz::unique_ptr<Skeleton> skeleton;
+  ozz::vector<ozz::math::SoaTransform> locals;
+  ozz::vector<ozz::math::Float4x4> models;
+  ozz::vector<int> chain;
+  ozz::vector<ozz::math::SimdQuaternion> corrections;
+  IKChainJob job;
+  bool reached = false;
+  int iterations = -1;
+  float distance = -1.f;
+};
+}  // namespace
+
+TEST(JobValidity, IKChainJob) {
+  ChainFixture fixture(4);
+
+  {  // Default is invalid
+    IKChainJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid
+    IKChainJob job = fixture.job;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Chain too short
+    IKChainJob job = fixture.job;
+    job.chain = job.chain.first(1);
+    job.joint_corrections = job.joint_corrections.first(1);
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Corrections size mismatch
+    IKChainJob job = fixture.job;
+    job.joint_corrections = job.joint_corrections.first(3);
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Weights size mismatch
+    const float weights[3] = {1.f, 1.f, 1.f};
+    IKChainJob job = fixture.job;
+    job.joint_weights = weights;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Unordered chain
+    const int chain[4] = {0, 2, 1, 3};
+    IKChainJob job = fixture.job;
+    job.chain = chain;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Chain out of models range
+    const int chain[4] = {0, 1, 2, 4};
+    IKChainJob job = fixture.job;
+    job.chain = chain;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Non direct ancestors chain
+    const int chain[2] = {0, 3};
+    IKChainJob job = fixture.job;
+    job.chain = chain;
+    job.joint_corrections = job.joint_corrections.first(2);
+    EXPECT_TRUE(job.Validate());
+  }
+
+  {  // Negative settings
+    IKChainJob job = fixture.job;
+    job.max_iterations = -1;
+    EXPECT_FALSE(job.Validate());
+    job.max_iterations = 0;
+    EXPECT_TRUE(job.Validate());
+    job.tolerance = -1.f;
+    EXPECT_FALSE(job.Validate());
+  }
+}
+
+TEST(Reach, IKChainJob) {
+  const IKChainJob::Solver solvers[] = {IKChainJob::kCCD, IKChainJob::kFABRIK};
+  for (const IKChainJob::Solver solver : solvers) {
+    ChainFixture fixture(6);
+    fixture.job.solver = solver;
+    fixture.job.max_iterations = 50;
+
+    const ozz::math::SimdFloat4 targets[] = {
+        ozz::math::simd_float4::Load(2.f, 3.f, 0.f, 0.f),
+        ozz::math::simd_float4::Load(-1.f, 2.f, 1.f, 0.f),
+        ozz::math::simd_float4::Load(1.f, -1.f, -2.f, 0.f),
+        ozz::math::simd_float4::Load(0.f, 0.f, 4.f, 0.f)};
+    for (const ozz::math::SimdFloat4& target : targets) {
+      fixture.job.target = target;
+      ASSERT_TRUE(fixture.job.Run());
+      EXPECT_TRUE(fixture.reached);
+      EXPECT_GT(fixture.iterations, 0);
+      EXPECT_LE(fixture.iterations, fixture.job.max_iterations);
+      EXPECT_LE(fixture.distance, fixture.job.tolerance);
+
+      // End joint is the only one with no correction.
+      EXPECT_SIMDQUATERNION_EQ(fixture.corrections.back(), 0.f, 0.f, 0.f,
+                               1.f);
+
+      // Corrections applied to local-space transforms reach the target.
+      const ozz::math::SimdFloat4 end = fixture.Apply();
+      EXPECT_SIMDFLOAT3_EQ_TOL(end, ozz::math::GetX(target),
+                               ozz::math::GetY(target),
+                               ozz::math::GetZ(target), 2e-3f);
+    }
+  }
+}
+
+TEST(Unreachable, IKChainJob) {
+  const IKChainJob::Solver solvers[] = {IKChainJob::kCCD, IKChainJob::kFABRIK};
+  for (const IKChainJob::Solver solver : solvers) {
+    ChainFixture fixture(4);
+    fixture.job.solver = solver;
+    fixture.job.max_iterations = 50;
+    fixture.job.target = ozz::math::simd_float4::Load(0.f, 10.f, 0.f, 0.f);
+    ASSERT_TRUE(fixture.job.Run());
+    EXPECT_FALSE(fixture.reached);
+    EXPECT_NEAR(fixture.distance, 7.f, 2e-2f);
+
+    // Chain is stretched toward the target.
+    const ozz::math::SimdFloat4 end = fixture.Apply();
+    EXPECT_SIMDFLOAT3_EQ_TOL(end, 0.f, 3.f, 0.f, 2e-2f);
+  }
+}
+
+TEST(Iterations, IKChainJob) {
+  ChainFixture fixture(8);
+  fixture.job.target = ozz::math::simd_float4::Load(1.f, 4.f, 2.f, 0.f);
+
+  // Already at target.
+  fixture.job.target = fixture.models[7].cols[3];
+  ASSERT_TRUE(fixture.job.Run());
+  EXPECT_TRUE(fixture.reached);
+  EXPECT_EQ(fixture.iterations, 0);
+  for (const ozz::math::SimdQuaternion& correction : fixture.corrections) {
+    EXPECT_SIMDQUATERNION_EQ_TOL(correction, 0.f, 0.f, 0.f, 1.f, 1e-5f);
+  }
+
+  // No iteration allowed.
+  fixture.job.target = ozz::math::simd_float4::Load(1.f, 4.f, 2.f, 0.f);
+  fixture.job.max_iterations = 0;
+  ASSERT_TRUE(fixture.job.Run());
+  EXPECT_FALSE(fixture.reached);
+  EXPECT_EQ(fixture.iterations, 0);
+
+  // Iterations are bounded, and more iterations improve accuracy.
+  const IKChainJob::Solver solvers[] = {IKChainJob::kCCD, IKChainJob::kFABRIK};
+  for (const IKChainJob::Solver solver : solvers) {
+    fixture.job.solver = solver;
+    fixture.job.tolerance = 0.f;
+    float previous = 1e9f;
+    for (int i = 1; i < 4; ++i) {
+      fixture.job.max_iterations = i;
+      ASSERT_TRUE(fixture.job.Run());
+      EXPECT_EQ(fixture.iterations, i);
+      EXPECT_LE(fixture.distance, previous);
+      previous = fixture.distance;
+    }
+  }
+}
+
+TEST(Weight, IKChainJob) {
+  ChainFixture fixture(5);
+  const ozz::math::SimdFloat4 target =
+      ozz::math::simd_float4::Load(1.f, 2.f, 1.f, 0.f);
+  fixture.job.target = target;
+  fixture.job.max_iterations = 50;
+
+  // Null weight.
+  fixture.job.weight = 0.f;
+  ASSERT_TRUE(fixture.job.Run());
+  EXPECT_FALSE(fixture.reached);
+  for (const ozz::math::SimdQuaternion& correction : fixture.corrections) {
+    EXPECT_SIMDQUATERNION_EQ(correction, 0.f, 0.f, 0.f, 1.f);
+  }
+
+  // Partial weight.
+  fixture.job.weight = .5f;
+  ASSERT_TRUE(fixture.job.Run());
+  EXPECT_FALSE(fixture.reached);
+  EXPECT_GT(fixture.distance, .1f);
+
+  // Full weight.
+  fixture.job.weight = 1.f;
+  ASSERT_TRUE(fixture.job.Run());
+  EXPECT_TRUE(fixture.reached);
+
+  // Root joint weight is 0 with CCD, it's not rotated but target is still
+  // reached.
+  const float weights[5] = {0.f, 1.f, .5f, 1.f, 1.f};
+  fixture.job.joint_weights = weights;
+  ASSERT_TRUE(fixture.job.Run());
+  EXPECT_TRUE(fixture.reached);
+  EXPECT_SIMDQUATERNION_EQ_TOL(fixture.corrections[0], 0.f, 0.f, 0.f, 1.f,
+                               1e-5f);
+  const ozz::math::SimdFloat4 end = fixture.Apply();
+  EXPECT_SIMDFLOAT3_EQ_TOL(end, ozz::math::GetX(target),
+                           ozz::math::GetY(target), ozz::math::GetZ(target),
+                           2e-3f);
+
+  // With FABRIK, root joint weight is applied to corrections, using an
+  // estimated normalization.
+  fixture.job.solver = IKChainJob::kFABRIK;
+  ASSERT_TRUE(fixture.job.Run());
+  EXPECT_SIMDQUATERNION_EQ_TOL(fixture.corrections[0], 0.f, 0.f, 0.f, 1.f,
+                               1e-3f);
+}
+
+TEST(ZeroScale, IKChainJob) {
+  const ozz::math::Float4x4 models[3] = {
+      ozz::math::Float4x4::Scaling(ozz::math::simd_float4::zero()),
+      ozz::math::Float4x4::Scaling(ozz::math::simd_float4::zero()),
+      ozz::math::Float4x4::Scaling(ozz::math::simd_float4::zero())};
+  const int chain[3] = {0, 1, 2};
+  ozz::math::SimdQuaternion corrections[3];
+
+  const IKChainJob::Solver solvers[] = {IKChainJob::kCCD, IKChainJob::kFABRIK};
+  for (const IKChainJob::Solver solver : solvers) {
+    IKChainJob job;
+    job.solver = solver;
+    job.target = ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f);
+    job.models = models;
+    job.chain = chain;
+    job.joint_corrections = corrections;
+    ASSERT_TRUE(job.Run());
+    for (const ozz::math::SimdQuaternion& correction : corrections) {
+      EXPECT_SIMDQUATERNION_EQ_TOL(correction, 0.f, 0.f, 0.f, 1.f, 1e-5f);
+    }
+  }
+}
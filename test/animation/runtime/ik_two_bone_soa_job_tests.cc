@@ -0,0 +1,255 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/animation/runtime/ik_two_bone_soa_job.h"
+
+#include <cstdlib>
+
+#include "gtest/gtest.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/simd_quaternion.h"
+#include "ozz/base/maths/soa_float4x4.h"
+#include "ozz/base/maths/soa_quaternion.h"
+
+namespace {
+float Random(float _min, float _max) {
+  return _min + (_max - _min) * static_cast<float>(rand()) / RAND_MAX;
+}
+
+ozz::math::SimdFloat4 RandomVector(float _range) {
+  return ozz::math::simd_float4::Load(Random(-_range, _range),
+                                      Random(-_range, _range),
+                                      Random(-_range, _range), 0.f);
+}
+
+ozz::math::SimdFloat4 RandomAxis() {
+  return ozz::math::NormalizeSafe3(RandomVector(1.f),
+                                   ozz::math::simd_float4::z_axis());
+}
+
+ozz::math::Float4x4 RandomTransform(float _range) {
+  const ozz::math::SimdQuaternion rotation = ozz::math::SimdQuaternion::
+      FromAxisAngle(RandomAxis(), ozz::math::simd_float4::Load1(
+                                      Random(-3.14f, 3.14f)));
+  return ozz::math::Float4x4::FromAffine(
+      RandomVector(_range), rotation.xyzw,
+      ozz::math::simd_float4::Load1(Random(.5f, 2.f)));
+}
+}  // namespace
+
+TEST(JobValidity, IKTwoBoneSoaJob) {
+  const ozz::math::SoaFloat4x4 start = ozz::math::SoaFloat4x4::identity();
+  const ozz::math::SoaFloat4x4 mid = start;
+  const ozz::math::SoaFloat4x4 end = start;
+
+  {  // Default is invalid
+    ozz::animation::IKTwoBoneSoaJob job;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Missing start joint matrix
+    ozz::animation::IKTwoBoneSoaJob job;
+    job.mid_joint = &mid;
+    job.end_joint = &end;
+    ozz::math::SoaQuaternion quat;
+    job.start_joint_correction = &quat;
+    job.mid_joint_correction = &quat;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Missing output
+    ozz::animation::IKTwoBoneSoaJob job;
+    job.start_joint = &start;
+    job.mid_joint = &mid;
+    job.end_joint = &end;
+    ozz::math::SoaQuaternion quat;
+    job.start_joint_correction = &quat;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Unnormalized mid axis lane
+    ozz::animation::IKTwoBoneSoaJob job;
+    job.start_joint = &start;
+    job.mid_joint = &mid;
+    job.end_joint = &end;
+    ozz::math::SoaQuaternion quat;
+    job.start_joint_correction = &quat;
+    job.mid_joint_correction = &quat;
+    job.mid_axis.z = ozz::math::simd_float4::Load(1.f, 1.f, 2.f, 1.f);
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Valid
+    ozz::animation::IKTwoBoneSoaJob job;
+    job.start_joint = &start;
+    job.mid_joint = &mid;
+    job.end_joint = &end;
+    ozz::math::SoaQuaternion quat;
+    job.start_joint_correction = &quat;
+    job.mid_joint_correction = &quat;
+    EXPECT_TRUE(job.Validate());
+  }
+}
+
+TEST(JobValidity, IKTwoBoneBatchJob) {
+  const ozz::math::Float4x4 start = ozz::math::Float4x4::identity();
+  ozz::math::SimdQuaternion quat;
+
+  ozz::animation::IKTwoBoneJob chains[2];
+  for (ozz::animation::IKTwoBoneJob& chain : chains) {
+    chain.start_joint = &start;
+    chain.mid_joint = &start;
+    chain.end_joint = &start;
+    chain.start_joint_correction = &quat;
+    chain.mid_joint_correction = &quat;
+  }
+
+  {  // Empty is valid
+    ozz::animation::IKTwoBoneBatchJob job;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Valid
+    ozz::animation::IKTwoBoneBatchJob job;
+    job.chains = chains;
+    EXPECT_TRUE(job.Validate());
+  }
+
+  {  // One invalid chain
+    chains[1].mid_joint_correction = nullptr;
+    ozz::animation::IKTwoBoneBatchJob job;
+    job.chains = chains;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+}
+
+TEST(Identity, IKTwoBoneSoaJob) {
+  // Setup 4 chains, with end joints already at target position.
+  const ozz::math::SimdFloat4 zero = ozz::math::simd_float4::zero();
+  const ozz::math::SimdFloat4 lanes =
+      ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 4.f);
+  const ozz::math::SoaFloat4x4 start = ozz::math::SoaFloat4x4::identity();
+  const ozz::math::SoaFloat4x4 mid = ozz::math::SoaFloat4x4::FromAffine(
+      ozz::math::SoaFloat3::Load(zero, lanes, zero),
+      ozz::math::SoaQuaternion::identity(), ozz::math::SoaFloat3::one());
+  const ozz::math::SoaFloat4x4 end = ozz::math::SoaFloat4x4::FromAffine(
+      ozz::math::SoaFloat3::Load(lanes, lanes, zero),
+      ozz::math::SoaQuaternion::identity(), ozz::math::SoaFloat3::one());
+
+  ozz::animation::IKTwoBoneSoaJob job;
+  job.start_joint = &start;
+  job.mid_joint = &mid;
+  job.end_joint = &end;
+  job.target = ozz::math::SoaFloat3::Load(lanes, lanes, zero);
+  job.pole_vector = ozz::math::SoaFloat3::y_axis();
+  job.mid_axis = ozz::math::SoaFloat3::z_axis();
+  ozz::math::SoaQuaternion qstart;
+  job.start_joint_correction = &qstart;
+  ozz::math::SoaQuaternion qmid;
+  job.mid_joint_correction = &qmid;
+  ozz::math::SimdInt4 reached;
+  job.reached = &reached;
+
+  // Last lane has a null weight.
+  job.weight = ozz::math::simd_float4::Load(1.f, 1.f, 1.f, 0.f);
+  ASSERT_TRUE(job.Run());
+
+  EXPECT_SOAQUATERNION_EQ_EST(qstart, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+                              0.f, 0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f);
+  EXPECT_SOAQUATERNION_EQ_EST(qmid, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+                              0.f, 0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f);
+  EXPECT_SIMDINT_EQ(reached, -1, -1, -1, 0);
+
+  // All null weights.
+  job.weight = zero;
+  ASSERT_TRUE(job.Run());
+  EXPECT_SIMDINT_EQ(reached, 0, 0, 0, 0);
+}
+
+TEST(MatchScalar, IKTwoBoneBatchJob) {
+  srand(0);
+
+  // Number of chains isn't a multiple of 4, to test batch padding.
+  const int kChains = 43;
+  ozz::math::Float4x4 joints[kChains][3];
+  ozz::animation::IKTwoBoneJob chains[kChains];
+  ozz::math::SimdQuaternion scalar_corrections[kChains][2];
+  ozz::math::SimdQuaternion batch_corrections[kChains][2];
+  bool scalar_reached[kChains];
+  bool batch_reached[kChains];
+
+  for (int i = 0; i < kChains; ++i) {
+    joints[i][0] = RandomTransform(10.f);
+    joints[i][1] = joints[i][0] * RandomTransform(1.f);
+    joints[i][2] = joints[i][1] * RandomTransform(1.f);
+    if (i == 7) {  // Zero scale chain
+      joints[i][0] = joints[i][1] = joints[i][2] =
+          ozz::math::Float4x4::Scaling(ozz::math::simd_float4::zero());
+    }
+
+    ozz::animation::IKTwoBoneJob& chain = chains[i];
+    chain.start_joint = &joints[i][0];
+    chain.mid_joint = &joints[i][1];
+    chain.end_joint = &joints[i][2];
+    chain.target = joints[i][0].cols[3] + RandomVector(3.f);
+    chain.mid_axis = RandomAxis();
+    chain.pole_vector = RandomAxis();
+    chain.twist_angle = i % 3 ? 0.f : Random(-1.f, 1.f);
+    chain.soften = Random(.5f, 1.f);
+    static const float kWeights[] = {1.f, .5f, 0.f, 1.f, 2.f};
+    chain.weight = kWeights[i % 5];
+    chain.reached = &scalar_reached[i];
+    chain.start_joint_correction = &scalar_corrections[i][0];
+    chain.mid_joint_correction = &scalar_corrections[i][1];
+    ASSERT_TRUE(chain.Run());
+
+    // Redirects outputs for the batch job.
+    chain.reached = &batch_reached[i];
+    chain.start_joint_correction = &batch_corrections[i][0];
+    chain.mid_joint_correction = &batch_corrections[i][1];
+  }
+
+  ozz::animation::IKTwoBoneBatchJob job;
+  job.chains = chains;
+  ASSERT_TRUE(job.Validate());
+  ASSERT_TRUE(job.Run());
+
+  for (int i = 0; i < kChains; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      const ozz::math::SimdFloat4 expected = scalar_corrections[i][j].xyzw;
+      EXPECT_SIMDQUATERNION_EQ_TOL(
+          batch_corrections[i][j], ozz::math::GetX(expected),
+          ozz::math::GetY(expected), ozz::math::GetZ(expected),
+          ozz::math::GetW(expected), 2e-3f);
+    }
+    EXPECT_EQ(batch_reached[i], scalar_reached[i]);
+  }
+}
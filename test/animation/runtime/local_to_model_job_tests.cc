@@ -30,9 +30,11 @@
 #include "ozz/animation/offline/skeleton_builder.h"
 #include "ozz/animation/runtime/local_to_model_job.h"
 #include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/containers/vector.h"
 #include "ozz/base/maths/gtest_math_helper.h"
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/memory/unique_ptr.h"
+#include "ozz/base/scheduler.h"
 
 using ozz::animation::LocalToModelJob;
 using ozz::animation::Skeleton;
@@ -198,6 +200,46 @@ TEST(JobValidity, LocalToModel) {
     EXPECT_TRUE(job.Validate());
     EXPECT_TRUE(job.Run());
   }
+  // Valid job with affine output only.
+  {
+    ozz::math::Float3x4 output_affine[2];
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.output_affine = output_affine;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+
+    // Invalid matrix output range: too small.
+    job.output = {output, output + 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+
+    job.output = output;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+  // Invalid affine output range: too small.
+  {
+    ozz::math::Float3x4 output_affine[1];
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.output = output;
+    job.output_affine = output_affine;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  // Invalid grain size.
+  {
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.output = output;
+    job.grain_size = 0;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
 }
 
 TEST(Transformation, LocalToModel) {
@@ -1026,3 +1068,364 @@ TEST(Empty, LocalToModel) {
     EXPECT_TRUE(job.Run());
   }
 }
+
+namespace {
+// Adds _depth levels of _breadth children to _joint, with a chain of _chain
+// joints between each level.
+void AddChildren(RawSkeleton::Joint* _joint, int _depth, int _breadth,
+                 int _chain) {
+  if (_depth == 0) {
+    return;
+  }
+  RawSkeleton::Joint* joint = _joint;
+  for (int i = 0; i < _chain; ++i) {
+    joint->children.resize(1);
+    joint = &joint->children[0];
+  }
+  joint->children.resize(_breadth);
+  for (RawSkeleton::Joint& child : joint->children) {
+    AddChildren(&child, _depth - 1, _breadth, _chain);
+  }
+}
+
+// Builds a hierarchy with multiple roots, chains and branches.
+ozz::unique_ptr<Skeleton> BuildHierarchy(
+    SkeletonBuilder::JointOrder _order = SkeletonBuilder::kDepthFirst,
+    ozz::vector<int16_t>* _remap = nullptr) {
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(3);
+  AddChildren(&raw_skeleton.roots[0], 4, 3, 1);
+  AddChildren(&raw_skeleton.roots[1], 2, 5, 0);
+  AddChildren(&raw_skeleton.roots[2], 3, 2, 3);
+  SkeletonBuilder builder;
+  builder.joint_order = _order;
+  ozz::vector<int16_t> remap;
+  return builder(raw_skeleton, _remap ? _remap : &remap);
+}
+
+// Initializes joints local transforms with varying values.
+void InitializeTransforms(ozz::span<ozz::math::SoaTransform> _transforms) {
+  for (size_t i = 0; i < _transforms.size(); ++i) {
+    const float f = static_cast<float>(i);
+    _transforms[i].translation = ozz::math::SoaFloat3::Load(
+        ozz::math::simd_float4::Load(.1f, -.2f, .3f, f * .1f),
+        ozz::math::simd_float4::Load(.5f, .1f, -.1f, .2f),
+        ozz::math::simd_float4::Load(-.3f, .2f, f * .05f, .1f));
+    _transforms[i].rotation = ozz::math::SoaQuaternion::Load(
+        ozz::math::simd_float4::Load(.70710677f, 0.f, 0.f, .6f),
+        ozz::math::simd_float4::Load(0.f, .70710677f, 0.f, 0.f),
+        ozz::math::simd_float4::Load(0.f, 0.f, .70710677f, 0.f),
+        ozz::math::simd_float4::Load(.70710677f, .70710677f, .70710677f, .8f));
+    _transforms[i].scale = ozz::math::SoaFloat3::Load(
+        ozz::math::simd_float4::Load(1.f, 1.1f, .9f, 1.f),
+        ozz::math::simd_float4::Load(1.f, 1.f, 1.2f, .8f),
+        ozz::math::simd_float4::Load(1.f, .9f, 1.f, 1.f));
+  }
+}
+}  // namespace
+
+TEST(TransformationAffine, LocalToModel) {
+  ozz::unique_ptr<Skeleton> skeleton = BuildHierarchy();
+  ASSERT_TRUE(skeleton);
+  const int num_joints = skeleton->num_joints();
+
+  ozz::vector<ozz::math::SoaTransform> input(skeleton->num_soa_joints());
+  InitializeTransforms(ozz::make_span(input));
+
+  const ozz::math::Float4x4 root =
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f)) *
+      ozz::math::Float4x4::FromEuler(
+          ozz::math::simd_float4::Load(.5f, .2f, -.1f, 0.f));
+
+  ozz::vector<ozz::math::Float4x4> expected(num_joints);
+  LocalToModelJob job;
+  job.skeleton = skeleton.get();
+  job.root = &root;
+  job.input = ozz::make_span(input);
+  job.output = ozz::make_span(expected);
+  ASSERT_TRUE(job.Run());
+
+  // Affine output only, and both outputs.
+  for (int both = 0; both < 2; ++both) {
+    ozz::vector<ozz::math::Float4x4> output(num_joints);
+    ozz::vector<ozz::math::Float3x4> output_affine(num_joints);
+    job.output = both ? ozz::make_span(output) : ozz::span<ozz::math::Float4x4>();
+    job.output_affine = ozz::make_span(output_affine);
+    ASSERT_TRUE(job.Run());
+
+    for (int i = 0; i < num_joints; ++i) {
+      const ozz::math::Float4x4 m = ToFloat4x4(output_affine[i]);
+      for (int c = 0; c < 4; ++c) {
+        EXPECT_SIMDFLOAT_EQ(
+            m.cols[c], ozz::math::GetX(expected[i].cols[c]),
+            ozz::math::GetY(expected[i].cols[c]),
+            ozz::math::GetZ(expected[i].cols[c]),
+            ozz::math::GetW(expected[i].cols[c]));
+        if (both) {
+          EXPECT_SIMDFLOAT_EQ(
+              output[i].cols[c], ozz::math::GetX(expected[i].cols[c]),
+              ozz::math::GetY(expected[i].cols[c]),
+              ozz::math::GetZ(expected[i].cols[c]),
+              ozz::math::GetW(expected[i].cols[c]));
+        }
+      }
+    }
+  }
+}
+
+TEST(TransformationScheduler, LocalToModel) {
+  ozz::unique_ptr<Skeleton> skeleton = BuildHierarchy();
+  ASSERT_TRUE(skeleton);
+  const int num_joints = skeleton->num_joints();
+
+  ozz::vector<ozz::math::SoaTransform> input(skeleton->num_soa_joints());
+  InitializeTransforms(ozz::make_span(input));
+
+  ozz::ThreadPoolScheduler scheduler(3);
+
+  struct {
+    int from;
+    int to;
+    bool from_excluded;
+  } ranges[] = {{Skeleton::kNoParent, Skeleton::kMaxJoints, false},
+                {0, Skeleton::kMaxJoints, false},
+                {0, Skeleton::kMaxJoints, true},
+                {2, Skeleton::kMaxJoints, true},
+                {Skeleton::kNoParent, num_joints / 2, false},
+                {num_joints - 20, Skeleton::kMaxJoints, false}};
+  const int grain_sizes[] = {1, 3, 16, 1000};
+
+  for (const auto& range : ranges) {
+    // Initializes outputs with the same values, as "from" parent isn't updated.
+    ozz::vector<ozz::math::Float4x4> expected(
+        num_joints, ozz::math::Float4x4::Scaling(
+                        ozz::math::simd_float4::Load(2.f, 2.f, 2.f, 0.f)));
+
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = ozz::make_span(input);
+    job.from = range.from;
+    job.to = range.to;
+    job.from_excluded = range.from_excluded;
+    job.output = ozz::make_span(expected);
+    ASSERT_TRUE(job.Run());
+
+    for (const int grain_size : grain_sizes) {
+      ozz::vector<ozz::math::Float4x4> output(
+          num_joints, ozz::math::Float4x4::Scaling(
+                          ozz::math::simd_float4::Load(2.f, 2.f, 2.f, 0.f)));
+      job.output = ozz::make_span(output);
+      job.scheduler = &scheduler;
+      job.grain_size = grain_size;
+      ASSERT_TRUE(job.Run());
+
+      for (int i = 0; i < num_joints; ++i) {
+        for (int c = 0; c < 4; ++c) {
+          EXPECT_SIMDFLOAT_EQ(output[i].cols[c],
+                              ozz::math::GetX(expected[i].cols[c]),
+                              ozz::math::GetY(expected[i].cols[c]),
+                              ozz::math::GetZ(expected[i].cols[c]),
+                              ozz::math::GetW(expected[i].cols[c]));
+        }
+      }
+    }
+  }
+}
+
+TEST(TransformationSchedulerWide, LocalToModel) {
+  // A wide and shallow hierarchy: a root with many small child chains, and a
+  // longer one. Small sibling sub-hierarchies end up merged into the same
+  // ranges, which must be split at their roots rather than as a single chain.
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  raw_skeleton.roots[0].children.resize(100);
+  for (size_t i = 0; i < raw_skeleton.roots[0].children.size(); ++i) {
+    RawSkeleton::Joint* joint = &raw_skeleton.roots[0].children[i];
+    for (int j = i == 50 ? 99 : 7; j > 0; --j) {
+      joint->children.resize(1);
+      joint = &joint->children[0];
+    }
+  }
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> skeleton = builder(raw_skeleton);
+  ASSERT_TRUE(skeleton);
+  const int num_joints = skeleton->num_joints();
+  ASSERT_EQ(num_joints, 893);
+
+  ozz::vector<ozz::math::SoaTransform> input(skeleton->num_soa_joints());
+  InitializeTransforms(ozz::make_span(input));
+
+  ozz::vector<ozz::math::Float4x4> expected(num_joints);
+  LocalToModelJob job;
+  job.skeleton = skeleton.get();
+  job.input = ozz::make_span(input);
+  job.output = ozz::make_span(expected);
+  ASSERT_TRUE(job.Run());
+
+  ozz::ThreadPoolScheduler scheduler(3);
+  const int grain_sizes[] = {1, 16, 64};
+  for (const int grain_size : grain_sizes) {
+    ozz::vector<ozz::math::Float4x4> output(num_joints);
+    job.output = ozz::make_span(output);
+    job.scheduler = &scheduler;
+    job.grain_size = grain_size;
+    ASSERT_TRUE(job.Run());
+
+    for (int i = 0; i < num_joints; ++i) {
+      for (int c = 0; c < 4; ++c) {
+        EXPECT_SIMDFLOAT_EQ(output[i].cols[c],
+                            ozz::math::GetX(expected[i].cols[c]),
+                            ozz::math::GetY(expected[i].cols[c]),
+                            ozz::math::GetZ(expected[i].cols[c]),
+                            ozz::math::GetW(expected[i].cols[c]));
+      }
+    }
+  }
+}
+
+TEST(TransformationBreadthFirst, LocalToModel) {
+  ozz::unique_ptr<Skeleton> df_skeleton = BuildHierarchy();
+  ASSERT_TRUE(df_skeleton);
+  ozz::vector<int16_t> remap;
+  ozz::unique_ptr<Skeleton> bf_skeleton =
+      BuildHierarchy(SkeletonBuilder::kBreadthFirst, &remap);
+  ASSERT_TRUE(bf_skeleton);
+  const int num_joints = df_skeleton->num_joints();
+  ASSERT_EQ(bf_skeleton->num_joints(), num_joints);
+
+  // Initializes depth-first local transforms, and remaps them to breadth-first
+  // order. A SoaTransform is made of 10 SimdFloat4 of 4 joints.
+  ozz::vector<ozz::math::SoaTransform> df_input(df_skeleton->num_soa_joints());
+  InitializeTransforms(ozz::make_span(df_input));
+  ozz::vector<ozz::math::SoaTransform> bf_input(
+      bf_skeleton->num_soa_joints(), ozz::math::SoaTransform::identity());
+  for (int i = 0; i < num_joints; ++i) {
+    const int r = remap[i];
+    const float* src = reinterpret_cast<const float*>(&df_input[i / 4]);
+    float* dest = reinterpret_cast<float*>(&bf_input[r / 4]);
+    for (int c = 0; c < 10; ++c) {
+      dest[c * 4 + (r & 3)] = src[c * 4 + (i & 3)];
+    }
+  }
+
+  ozz::vector<ozz::math::Float4x4> expected(num_joints);
+  LocalToModelJob df_job;
+  df_job.skeleton = df_skeleton.get();
+  df_job.input = ozz::make_span(df_input);
+  df_job.output = ozz::make_span(expected);
+  ASSERT_TRUE(df_job.Run());
+
+  // Breadth-first skeletons can't be split, scheduler is ignored.
+  ozz::ThreadPoolScheduler scheduler(3);
+  for (int use_scheduler = 0; use_scheduler < 2; ++use_scheduler) {
+    ozz::vector<ozz::math::Float4x4> output(num_joints);
+    LocalToModelJob bf_job;
+    bf_job.skeleton = bf_skeleton.get();
+    bf_job.input = ozz::make_span(bf_input);
+    bf_job.output = ozz::make_span(output);
+    bf_job.scheduler = use_scheduler ? &scheduler : nullptr;
+    bf_job.grain_size = 1;
+    ASSERT_TRUE(bf_job.Run());
+
+    for (int i = 0; i < num_joints; ++i) {
+      const ozz::math::Float4x4& m = output[remap[i]];
+      for (int c = 0; c < 4; ++c) {
+        EXPECT_SIMDFLOAT_EQ(m.cols[c], ozz::math::GetX(expected[i].cols[c]),
+                            ozz::math::GetY(expected[i].cols[c]),
+                            ozz::math::GetZ(expected[i].cols[c]),
+                            ozz::math::GetW(expected[i].cols[c]));
+      }
+    }
+  }
+}
+
+TEST(TransformationDirty, LocalToModel) {
+  ozz::unique_ptr<Skeleton> skeleton = BuildHierarchy();
+  ASSERT_TRUE(skeleton);
+  const int num_joints = skeleton->num_joints();
+  const ozz::span<const int16_t> parents = skeleton->joint_parents();
+
+  ozz::vector<ozz::math::SoaTransform> input(skeleton->num_soa_joints());
+  InitializeTransforms(ozz::make_span(input));
+
+  // Invalid dirty set: too small.
+  {
+    ozz::vector<ozz::math::Float4x4> output(num_joints);
+    ozz::vector<ozz::byte> dirty((num_joints + 7) / 8 - 1, 0);
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = ozz::make_span(input);
+    job.output = ozz::make_span(output);
+    job.dirty = ozz::make_span(dirty);
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  ozz::ThreadPoolScheduler scheduler(3);
+  const int dirty_joints[] = {0, 5, 17, num_joints - 1};
+  for (int use_scheduler = 0; use_scheduler < 2; ++use_scheduler) {
+    for (const int dirty_joint : dirty_joints) {
+      // Computes initial model-space matrices.
+      ozz::vector<ozz::math::SoaTransform> local = input;
+      ozz::vector<ozz::math::Float4x4> output(num_joints);
+      LocalToModelJob job;
+      job.skeleton = skeleton.get();
+      job.input = ozz::make_span(local);
+      job.output = ozz::make_span(output);
+      job.scheduler = use_scheduler ? &scheduler : nullptr;
+      job.grain_size = 4;
+      ASSERT_TRUE(job.Run());
+
+      // Changes dirty joint local transform only.
+      float offset[4] = {0.f, 0.f, 0.f, 0.f};
+      offset[dirty_joint & 3] = 1.f;
+      ozz::math::SoaTransform& soa = local[dirty_joint / 4];
+      soa.translation.x =
+          soa.translation.x + ozz::math::simd_float4::LoadPtrU(offset);
+
+      // Flags dirty joint and its descendants, as they should be updated.
+      ozz::vector<ozz::byte> dirty((num_joints + 7) / 8, 0);
+      dirty[dirty_joint / 8] |= 1 << (dirty_joint & 7);
+      ozz::vector<bool> updated(num_joints);
+      for (int i = 0; i < num_joints; ++i) {
+        updated[i] = i == dirty_joint ||
+                     (parents[i] != Skeleton::kNoParent && updated[parents[i]]);
+      }
+
+      // Expected matrices with a full update.
+      ozz::vector<ozz::math::Float4x4> expected(num_joints);
+      job.output = ozz::make_span(expected);
+      ASSERT_TRUE(job.Run());
+
+      // Overwrites matrices that shouldn't be updated, but dirty joint parent
+      // one which is used for the update.
+      const ozz::math::Float4x4 sentinel = ozz::math::Float4x4::Scaling(
+          ozz::math::simd_float4::Load(46.f, 46.f, 46.f, 0.f));
+      for (int i = 0; i < num_joints; ++i) {
+        if (!updated[i] && i != parents[dirty_joint]) {
+          output[i] = sentinel;
+        }
+      }
+
+      job.output = ozz::make_span(output);
+      job.dirty = ozz::make_span(dirty);
+      ASSERT_TRUE(job.Run());
+
+      for (int i = 0; i < num_joints; ++i) {
+        if (updated[i]) {
+          for (int c = 0; c < 4; ++c) {
+            EXPECT_SIMDFLOAT_EQ(output[i].cols[c],
+                                ozz::math::GetX(expected[i].cols[c]),
+                                ozz::math::GetY(expected[i].cols[c]),
+                                ozz::math::GetZ(expected[i].cols[c]),
+                                ozz::math::GetW(expected[i].cols[c]));
+          }
+        } else if (i != parents[dirty_joint]) {
+          EXPECT_FLOAT4x4_EQ(output[i], 46.f, 0.f, 0.f, 0.f, 0.f, 46.f, 0.f,
+                             0.f, 0.f, 0.f, 46.f, 0.f, 0.f, 0.f, 0.f, 1.f);
+        }
+      }
+    }
+  }
+}
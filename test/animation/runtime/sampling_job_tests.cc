@@ -655,3 +655,220 @@ TEST(CacheResize, SamplingJob) {
   context.Resize(1);
   EXPECT_FALSE(job.Validate());
 }
+
+TEST(SamplingConstant, SamplingJob) {
+  RawAnimation raw_animation;
+  raw_animation.duration = 1.f;
+  raw_animation.tracks.resize(36);
+
+  // Track 1 is constant, all other tracks of the first soa entry have no key.
+  const RawAnimation::TranslationKey tkey10 = {
+      .3f, ozz::math::Float3(1.f, 2.f, 4.f)};
+  raw_animation.tracks[1].translations.push_back(tkey10);
+
+  // Track 5 is animated between .2 and .6, and holds its value otherwise.
+  const RawAnimation::RotationKey rkey50 = {
+      .2f, ozz::math::Quaternion::identity()};
+  raw_animation.tracks[5].rotations.push_back(rkey50);
+  const RawAnimation::RotationKey rkey51 = {
+      .6f, ozz::math::Quaternion(0.f, 1.f, 0.f, 0.f)};
+  raw_animation.tracks[5].rotations.push_back(rkey51);
+
+  AnimationBuilder builder;
+  ozz::unique_ptr<Animation> animation(builder(raw_animation));
+  ASSERT_TRUE(animation);
+
+  SamplingJob::Context context(36);
+  ozz::math::SoaTransform output[9];
+  ozz::byte constant[2];
+
+  SamplingJob job;
+  job.animation = animation.get();
+  job.context = &context;
+  job.output = output;
+
+  // Too small constant flags.
+  job.constant = {constant, 1};
+  EXPECT_FALSE(job.Validate());
+
+  job.constant = constant;
+  EXPECT_TRUE(job.Validate());
+
+  // Before first animated key.
+  job.ratio = .1f;
+  memset(constant, 0xde, sizeof(constant));
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(constant[0], 0xff);
+  EXPECT_EQ(constant[1], 0x01);
+
+  // Animated interval.
+  job.ratio = .4f;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(constant[0], 0xfd);
+  EXPECT_EQ(constant[1], 0x01);
+
+  // Only the first soa track is sampled.
+  job.output = {output, 1};
+  constant[1] = 0xde;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(constant[0], 0x01);
+  EXPECT_EQ(constant[1], 0xde);
+  job.output = output;
+
+  // After last animated key.
+  job.ratio = .9f;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(constant[0], 0xff);
+  EXPECT_EQ(constant[1], 0x01);
+  EXPECT_SOAQUATERNION_EQ_EST(output[1].rotation, 0.f, 0.f, 0.f, 0.f, 0.f, 1.f,
+                              0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 1.f, 1.f);
+
+  // Rewinding updates flags too.
+  job.ratio = .5f;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(constant[0], 0xfd);
+  EXPECT_EQ(constant[1], 0x01);
+}
+
+TEST(SamplingChanged, SamplingJob) {
+  RawAnimation raw_animation;
+  raw_animation.duration = 1.f;
+  raw_animation.tracks.resize(36);
+
+  // Track 1 is constant, all other tracks of the first soa entry have no key.
+  const RawAnimation::TranslationKey tkey10 = {
+      .3f, ozz::math::Float3(1.f, 2.f, 4.f)};
+  raw_animation.tracks[1].translations.push_back(tkey10);
+
+  // Track 5 is animated between .2 and .6, and holds its value otherwise.
+  const RawAnimation::RotationKey rkey50 = {
+      .2f, ozz::math::Quaternion::identity()};
+  raw_animation.tracks[5].rotations.push_back(rkey50);
+  const RawAnimation::RotationKey rkey51 = {
+      .6f, ozz::math::Quaternion(0.f, 1.f, 0.f, 0.f)};
+  raw_animation.tracks[5].rotations.push_back(rkey51);
+
+  AnimationBuilder builder;
+  ozz::unique_ptr<Animation> animation(builder(raw_animation));
+  ASSERT_TRUE(animation);
+
+  SamplingJob::Context context(36);
+  ozz::math::SoaTransform output[9];
+  ozz::byte changed[2];
+
+  SamplingJob job;
+  job.animation = animation.get();
+  job.context = &context;
+  job.output = output;
+
+  // Too small changed flags.
+  job.changed = {changed, 1};
+  EXPECT_FALSE(job.Validate());
+
+  job.changed = changed;
+  EXPECT_TRUE(job.Validate());
+
+  // Everything changes the first time.
+  job.ratio = .1f;
+  memset(changed, 0xde, sizeof(changed));
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(changed[0], 0xff);
+  EXPECT_EQ(changed[1], 0x01);
+
+  // Same ratio.
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(changed[0], 0x00);
+  EXPECT_EQ(changed[1], 0x00);
+
+  // Held value, before first animated key.
+  job.ratio = .15f;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(changed[0], 0x00);
+  EXPECT_EQ(changed[1], 0x00);
+
+  // Animated interval, entered then sampled again.
+  job.ratio = .4f;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(changed[0], 0x02);
+  EXPECT_EQ(changed[1], 0x00);
+  job.ratio = .45f;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(changed[0], 0x02);
+  EXPECT_EQ(changed[1], 0x00);
+
+  // Only the first soa track is sampled.
+  job.output = {output, 1};
+  changed[1] = 0xde;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(changed[0], 0x00);
+  EXPECT_EQ(changed[1], 0xde);
+  job.output = output;
+
+  // After last animated key, interval changes then holds.
+  job.ratio = .9f;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(changed[0], 0x02);
+  EXPECT_EQ(changed[1], 0x00);
+  job.ratio = .95f;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(changed[0], 0x00);
+  EXPECT_EQ(changed[1], 0x00);
+
+  // Invalidated context.
+  context.Invalidate();
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(changed[0], 0xff);
+  EXPECT_EQ(changed[1], 0x01);
+}
+
+TEST(SamplingConstantTracks, SamplingJob) {
+  // Builds 2 animations, with constant soa tracks ordered differently.
+  RawAnimation raw_animation;
+  raw_animation.duration = 1.f;
+  raw_animation.tracks.resize(8);
+  const RawAnimation::TranslationKey tkey0 = {
+      .5f, ozz::math::Float3(1.f, 2.f, 4.f)};
+  raw_animation.tracks[0].translations.push_back(tkey0);
+  const RawAnimation::TranslationKey tkey40 = {
+      0.f, ozz::math::Float3(0.f, 0.f, 0.f)};
+  raw_animation.tracks[4].translations.push_back(tkey40);
+  const RawAnimation::TranslationKey tkey41 = {
+      1.f, ozz::math::Float3(8.f, 0.f, 0.f)};
+  raw_animation.tracks[4].translations.push_back(tkey41);
+
+  AnimationBuilder builder;
+  ozz::unique_ptr<Animation> animation0(builder(raw_animation));
+  ASSERT_TRUE(animation0);
+  EXPECT_EQ(animation0->translations_constants().size(), 4u);
+
+  std::swap(raw_animation.tracks[0], raw_animation.tracks[4]);
+  ozz::unique_ptr<Animation> animation1(builder(raw_animation));
+  ASSERT_TRUE(animation1);
+  EXPECT_EQ(animation1->translations_constants().size(), 4u);
+
+  // Both animations share the same context, which must be updated with
+  // constants of each animation.
+  SamplingJob::Context context(8);
+  ozz::math::SoaTransform output[2];
+
+  SamplingJob job;
+  job.context = &context;
+  job.output = output;
+  job.ratio = .5f;
+
+  for (int i = 0; i < 2; ++i) {
+    job.animation = animation0.get();
+    ASSERT_TRUE(job.Run());
+    EXPECT_SOAFLOAT3_EQ_EST(output[0].translation, 1.f, 0.f, 0.f, 0.f, 2.f,
+                            0.f, 0.f, 0.f, 4.f, 0.f, 0.f, 0.f);
+    EXPECT_SOAFLOAT3_EQ_EST(output[1].translation, 4.f, 0.f, 0.f, 0.f, 0.f,
+                            0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+
+    job.animation = animation1.get();
+    ASSERT_TRUE(job.Run());
+    EXPECT_SOAFLOAT3_EQ_EST(output[0].translation, 4.f, 0.f, 0.f, 0.f, 0.f,
+                            0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+    EXPECT_SOAFLOAT3_EQ_EST(output[1].translation, 1.f, 0.f, 0.f, 0.f, 2.f,
+                            0.f, 0.f, 0.f, 4.f, 0.f, 0.f, 0.f);
+  }
+}
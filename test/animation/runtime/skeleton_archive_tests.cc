@@ -25,12 +25,15 @@
 //                                                                            //
 //----------------------------------------------------------------------------//
 
+#include <cstring>
+
 #include "gtest/gtest.h"
 #include "ozz/animation/offline/raw_skeleton.h"
 #include "ozz/animation/offline/skeleton_builder.h"
 #include "ozz/animation/runtime/skeleton.h"
 #include "ozz/base/io/archive.h"
 #include "ozz/base/io/stream.h"
+#include "ozz/base/containers/vector.h"
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/memory/unique_ptr.h"
 
@@ -171,3 +174,144 @@ TEST(AlreadyInitialized, SkeletonSerialize) {
     EXPECT_STREQ(i_skeleton.joint_names()[1], o_skeleton[1]->joint_names()[1]);
   }
 }
+
+namespace {
+// Builds a skeleton with 5 joints, so that the last soa rest pose is partial.
+ozz::unique_ptr<Skeleton> BuildImageSkeleton() {
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint& root = raw_skeleton.roots[0];
+  root.name = "root";
+  root.transform.translation = ozz::math::Float3(1.f, 2.f, 3.f);
+  root.children.resize(3);
+  root.children[0].name = "j0";
+  root.children[0].transform.scale = ozz::math::Float3(2.f, 3.f, 4.f);
+  root.children[1].name = "";
+  root.children[2].name = "joint_2";
+  root.children[2].children.resize(1);
+  root.children[2].children[0].name = "j3";
+  root.children[2].children[0].transform.rotation =
+      ozz::math::Quaternion::FromAxisAngle(ozz::math::Float3::y_axis(), .5f);
+
+  SkeletonBuilder builder;
+  return builder(raw_skeleton);
+}
+
+// Copies _skeleton image to an _buffer aligned to SoaTransform.
+ozz::span<const ozz::byte> CopyImage(
+    const Skeleton& _skeleton, ozz::vector<ozz::math::SoaTransform>* _buffer) {
+  ozz::io::MemoryStream stream;
+  EXPECT_TRUE(_skeleton.SaveImage(stream));
+  const size_t size = stream.Size();
+  _buffer->resize(size / sizeof(ozz::math::SoaTransform) + 2);
+  stream.Seek(0, ozz::io::Stream::kSet);
+  EXPECT_EQ(stream.Read(_buffer->data(), size), size);
+  return ozz::as_bytes(make_span(*_buffer)).first(size);
+}
+
+void ExpectSameSkeleton(const Skeleton& _expected, const Skeleton& _skeleton) {
+  ASSERT_EQ(_skeleton.num_joints(), _expected.num_joints());
+  for (int i = 0; i < _skeleton.num_joints(); ++i) {
+    EXPECT_EQ(_skeleton.joint_parents()[i], _expected.joint_parents()[i]);
+    EXPECT_STREQ(_skeleton.joint_names()[i], _expected.joint_names()[i]);
+  }
+  for (int i = 0; i < _skeleton.num_soa_joints(); ++i) {
+    EXPECT_TRUE(
+        ozz::math::AreAllTrue(_skeleton.joint_rest_poses()[i].translation ==
+                              _expected.joint_rest_poses()[i].translation));
+    EXPECT_TRUE(
+        ozz::math::AreAllTrue(_skeleton.joint_rest_poses()[i].rotation ==
+                              _expected.joint_rest_poses()[i].rotation));
+    EXPECT_TRUE(
+        ozz::math::AreAllTrue(_skeleton.joint_rest_poses()[i].scale ==
+                              _expected.joint_rest_poses()[i].scale));
+  }
+}
+}  // namespace
+
+TEST(Empty, SkeletonImage) {
+  Skeleton o_skeleton;
+  ozz::vector<ozz::math::SoaTransform> buffer;
+  const ozz::span<const ozz::byte> image = CopyImage(o_skeleton, &buffer);
+
+  Skeleton i_skeleton;
+  EXPECT_TRUE(i_skeleton.MapImage(image));
+  EXPECT_EQ(i_skeleton.num_joints(), 0);
+  EXPECT_TRUE(i_skeleton.joint_names().empty());
+}
+
+TEST(Filled, SkeletonImage) {
+  const ozz::unique_ptr<Skeleton> o_skeleton = BuildImageSkeleton();
+  ASSERT_TRUE(o_skeleton);
+  ASSERT_EQ(o_skeleton->num_joints(), 5);
+
+  {
+    ozz::io::File file("test_skeleton.img", "wb");
+    ASSERT_TRUE(file.opened());
+    EXPECT_TRUE(o_skeleton->SaveImage(file));
+  }
+
+  ozz::io::MappedFile file("test_skeleton.img");
+  ASSERT_TRUE(file.opened());
+
+  Skeleton i_skeleton;
+  ASSERT_TRUE(i_skeleton.MapImage(file.data()));
+  ExpectSameSkeleton(*o_skeleton, i_skeleton);
+
+  // Mapped skeleton data and names point to file memory.
+  const ozz::byte* begin = file.data().data();
+  const ozz::byte* end = begin + file.data().size();
+  const ozz::byte* rest_poses =
+      reinterpret_cast<const ozz::byte*>(i_skeleton.joint_rest_poses().data());
+  EXPECT_TRUE(rest_poses >= begin && rest_poses < end);
+  for (const char* name : i_skeleton.joint_names()) {
+    const ozz::byte* address = reinterpret_cast<const ozz::byte*>(name);
+    EXPECT_TRUE(address >= begin && address < end);
+  }
+
+  // Skeleton can be moved.
+  Skeleton m_skeleton = std::move(i_skeleton);
+  ExpectSameSkeleton(*o_skeleton, m_skeleton);
+
+  // Skeleton can be reused.
+  ASSERT_TRUE(m_skeleton.MapImage(file.data()));
+  ExpectSameSkeleton(*o_skeleton, m_skeleton);
+}
+
+TEST(Invalid, SkeletonImage) {
+  const ozz::unique_ptr<Skeleton> o_skeleton = BuildImageSkeleton();
+  ASSERT_TRUE(o_skeleton);
+
+  ozz::vector<ozz::math::SoaTransform> buffer;
+  const ozz::span<const ozz::byte> image = CopyImage(*o_skeleton, &buffer);
+  const size_t size = image.size();
+
+  Skeleton skeleton;
+  ASSERT_TRUE(skeleton.MapImage(image));
+  EXPECT_EQ(skeleton.num_joints(), 5);
+
+  // Empty image.
+  EXPECT_FALSE(skeleton.MapImage({}));
+  EXPECT_EQ(skeleton.num_joints(), 0);
+
+  // Truncated image.
+  EXPECT_FALSE(skeleton.MapImage(image.first(size - 1)));
+  EXPECT_EQ(skeleton.num_joints(), 0);
+
+  // Unaligned image.
+  ozz::byte* bytes = reinterpret_cast<ozz::byte*>(buffer.data());
+  std::memmove(bytes + 4, bytes, size);
+  EXPECT_FALSE(skeleton.MapImage({bytes + 4, size}));
+  std::memmove(bytes, bytes + 4, size);
+  ASSERT_TRUE(skeleton.MapImage(image));
+
+  // Joint names aren't null terminated.
+  bytes[size - 1] = 'a';
+  EXPECT_FALSE(skeleton.MapImage(image));
+  EXPECT_EQ(skeleton.num_joints(), 0);
+  bytes[size - 1] = 0;
+
+  // Corrupted tag.
+  std::memset(bytes, 0, size);
+  EXPECT_FALSE(skeleton.MapImage(image));
+}
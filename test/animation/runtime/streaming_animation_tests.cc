@@ -0,0 +1,251 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/streaming_animation.h"
+
+#include "gtest/gtest.h"
+#include "ozz/animation/offline/animation_builder.h"
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/streaming_animation_builder.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::animation::Animation;
+using ozz::animation::SamplingJob;
+using ozz::animation::StreamingAnimation;
+using ozz::animation::offline::AnimationBuilder;
+using ozz::animation::offline::RawAnimation;
+using ozz::animation::offline::StreamingAnimationBuilder;
+
+namespace {
+// Builds a 5s raw animation with 6 tracks.
+RawAnimation BuildRawAnimation() {
+  RawAnimation raw_animation;
+  raw_animation.duration = 5.f;
+  raw_animation.tracks.resize(6);
+  for (size_t i = 0; i < raw_animation.tracks.size(); ++i) {
+    RawAnimation::JointTrack& track = raw_animation.tracks[i];
+    const size_t num_keys = i * 4 + 2;
+    for (size_t k = 0; k < num_keys; ++k) {
+      const float time = raw_animation.duration * k / (num_keys - 1);
+      const float value = static_cast<float>(i * 10 + k) * .1f;
+      const RawAnimation::TranslationKey tkey = {
+          time, ozz::math::Float3(value, -value, value * .5f)};
+      track.translations.push_back(tkey);
+      const RawAnimation::RotationKey rkey = {
+          time, ozz::math::Quaternion::FromAxisAngle(
+                    ozz::math::Float3::y_axis(), value * .1f)};
+      track.rotations.push_back(rkey);
+    }
+  }
+  return raw_animation;
+}
+
+// Samples _streaming at _ratio, and compares with _reference. Chunk boundary
+// keys are quantized independently, hence the tolerance.
+void ExpectSameSampling(StreamingAnimation* _streaming,
+                        const Animation& _reference, float _ratio) {
+  ozz::math::SoaTransform expected[2];
+  ozz::math::SoaTransform output[2];
+  SamplingJob::Context context(_reference.num_tracks());
+
+  SamplingJob job;
+  job.animation = &_reference;
+  job.context = &context;
+  job.ratio = _ratio;
+  job.output = expected;
+  ASSERT_TRUE(job.Run());
+
+  float chunk_ratio;
+  job.animation = _streaming->Acquire(_ratio, &chunk_ratio);
+  ASSERT_TRUE(job.animation);
+  job.ratio = chunk_ratio;
+  job.output = output;
+  ASSERT_TRUE(job.Run());
+
+  for (int i = 0; i < 2; ++i) {
+    float e[4], o[4];
+    ozz::math::StorePtrU(expected[i].translation.x, e);
+    ozz::math::StorePtrU(output[i].translation.x, o);
+    for (int l = 0; l < 4; ++l) {
+      EXPECT_NEAR(e[l], o[l], 5e-3f);
+    }
+    ozz::math::StorePtrU(expected[i].rotation.y, e);
+    ozz::math::StorePtrU(output[i].rotation.y, o);
+    for (int l = 0; l < 4; ++l) {
+      EXPECT_NEAR(e[l], o[l], 5e-3f);
+    }
+  }
+}
+}  // namespace
+
+TEST(Build, StreamingAnimation) {
+  StreamingAnimationBuilder builder;
+
+  {  // Invalid raw animation.
+    RawAnimation raw_animation;
+    raw_animation.duration = -1.f;
+    EXPECT_FALSE(builder(raw_animation));
+  }
+
+  {  // Invalid chunk duration.
+    StreamingAnimationBuilder invalid;
+    invalid.chunk_duration = 0.f;
+    EXPECT_FALSE(invalid(BuildRawAnimation()));
+  }
+
+  {  // Empty.
+    RawAnimation raw_animation;
+    const ozz::unique_ptr<StreamingAnimation> animation =
+        builder(raw_animation);
+    ASSERT_TRUE(animation);
+    EXPECT_EQ(animation->num_tracks(), 0);
+    EXPECT_EQ(animation->num_chunks(), 1);
+    float chunk_ratio;
+    EXPECT_TRUE(animation->Acquire(.5f, &chunk_ratio));
+  }
+
+  {  // Chunks.
+    builder.chunk_duration = 2.f;
+    const ozz::unique_ptr<StreamingAnimation> animation =
+        builder(BuildRawAnimation());
+    ASSERT_TRUE(animation);
+    EXPECT_FLOAT_EQ(animation->duration(), 5.f);
+    EXPECT_FLOAT_EQ(animation->chunk_duration(), 2.f);
+    EXPECT_EQ(animation->num_tracks(), 6);
+    EXPECT_EQ(animation->num_soa_tracks(), 2);
+    EXPECT_EQ(animation->num_chunks(), 3);
+    EXPECT_EQ(animation->num_resident_chunks(), 3);
+    EXPECT_EQ(animation->chunk_index(-1.f), 0);
+    EXPECT_EQ(animation->chunk_index(.39f), 0);
+    EXPECT_EQ(animation->chunk_index(.41f), 1);
+    EXPECT_EQ(animation->chunk_index(.81f), 2);
+    EXPECT_EQ(animation->chunk_index(1.f), 2);
+    EXPECT_EQ(animation->chunk_index(2.f), 2);
+
+    float chunk_ratio;
+    const Animation* chunk = animation->Acquire(.9f, &chunk_ratio);
+    ASSERT_TRUE(chunk);
+    EXPECT_FLOAT_EQ(chunk->duration(), 1.f);
+    EXPECT_FLOAT_EQ(chunk_ratio, .5f);
+  }
+}
+
+TEST(Sampling, StreamingAnimation) {
+  const RawAnimation raw_animation = BuildRawAnimation();
+  const ozz::unique_ptr<Animation> reference =
+      AnimationBuilder()(raw_animation);
+  ASSERT_TRUE(reference);
+
+  StreamingAnimationBuilder builder;
+  builder.chunk_duration = 1.5f;
+  const ozz::unique_ptr<StreamingAnimation> animation = builder(raw_animation);
+  ASSERT_TRUE(animation);
+
+  for (float ratio = 0.f; ratio <= 1.f; ratio += .01f) {
+    ExpectSameSampling(animation.get(), *reference, ratio);
+  }
+  ExpectSameSampling(animation.get(), *reference, 1.f);
+  for (float ratio = 1.f; ratio >= 0.f; ratio -= .03f) {
+    ExpectSameSampling(animation.get(), *reference, ratio);
+  }
+}
+
+TEST(Streaming, StreamingAnimation) {
+  const RawAnimation raw_animation = BuildRawAnimation();
+  const ozz::unique_ptr<Animation> reference =
+      AnimationBuilder()(raw_animation);
+  ASSERT_TRUE(reference);
+
+  StreamingAnimationBuilder builder;
+  builder.chunk_duration = 1.f;
+  const ozz::unique_ptr<StreamingAnimation> built = builder(raw_animation);
+  ASSERT_TRUE(built);
+
+  ozz::io::MemoryStream stream;
+  {
+    ozz::io::OArchive o(&stream, ozz::GetNativeEndianness());
+    o << *built;
+    o << 46;  // Something stored after the animation.
+  }
+
+  stream.Seek(0, ozz::io::Stream::kSet);
+  ozz::io::IArchive i(&stream);
+  ASSERT_TRUE(i.TestTag<StreamingAnimation>());
+  StreamingAnimation animation;
+  i >> animation;
+
+  // Only the header was read.
+  int after;
+  i >> after;
+  EXPECT_EQ(after, 46);
+  EXPECT_FLOAT_EQ(animation.duration(), 5.f);
+  EXPECT_EQ(animation.num_tracks(), 6);
+  EXPECT_EQ(animation.num_chunks(), 5);
+  EXPECT_EQ(animation.num_resident_chunks(), 0);
+  EXPECT_EQ(animation.max_resident_chunks(), 2);
+
+  // Chunks are loaded on demand, within budget.
+  for (float ratio = 0.f; ratio <= 1.f; ratio += .01f) {
+    ExpectSameSampling(&animation, *reference, ratio);
+    EXPECT_LE(animation.num_resident_chunks(), 2);
+    EXPECT_TRUE(animation.resident(animation.chunk_index(ratio)));
+  }
+
+  // Prefetching.
+  float chunk_ratio;
+  EXPECT_TRUE(animation.Acquire(0.f, &chunk_ratio));
+  EXPECT_TRUE(animation.Load(1));
+  EXPECT_TRUE(animation.resident(0));
+  EXPECT_TRUE(animation.resident(1));
+  EXPECT_EQ(animation.num_resident_chunks(), 2);
+
+  // Least recently used chunk is evicted.
+  EXPECT_TRUE(animation.Load(2));
+  EXPECT_FALSE(animation.resident(0));
+  EXPECT_TRUE(animation.resident(1));
+  EXPECT_TRUE(animation.resident(2));
+
+  // Reducing budget.
+  animation.set_max_resident_chunks(1);
+  EXPECT_EQ(animation.num_resident_chunks(), 1);
+  EXPECT_TRUE(animation.resident(2));
+  animation.set_max_resident_chunks(0);
+  EXPECT_EQ(animation.max_resident_chunks(), 1);
+
+  for (float ratio = 1.f; ratio >= 0.f; ratio -= .02f) {
+    ExpectSameSampling(&animation, *reference, ratio);
+    EXPECT_EQ(animation.num_resident_chunks(), 1);
+  }
+
+  // Stream position isn't affected by loading.
+  EXPECT_EQ(stream.Tell(), static_cast<int>(stream.Size()));
+}
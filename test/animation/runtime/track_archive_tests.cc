@@ -34,6 +34,7 @@
 #include "ozz/base/io/stream.h"
 #include "ozz/base/memory/unique_ptr.h"
 
+#include "ozz/animation/runtime/track_event_index.h"
 #include "ozz/animation/runtime/track_sampling_job.h"
 
 #include "ozz/animation/offline/raw_track.h"
@@ -452,3 +453,62 @@ TEST(AlreadyInitialized, TrackSerialize) {
     ASSERT_TRUE(i_track.size() > size);
   }
 }
+
+TEST(EventIndex, TrackSerialize) {
+  ozz::io::MemoryStream stream;
+
+  TrackBuilder builder;
+  RawFloatTrack raw_tracks[3];
+  const RawFloatTrack::Keyframe keys[] = {
+      {RawTrackInterpolation::kLinear, 0.f, 0.f},
+      {RawTrackInterpolation::kStep, .5f, 2.f},
+      {RawTrackInterpolation::kLinear, .7f, 0.f}};
+  raw_tracks[0].keyframes.assign(std::begin(keys), std::end(keys));
+  raw_tracks[2].keyframes.assign(std::begin(keys) + 1, std::end(keys));
+
+  ozz::unique_ptr<ozz::animation::TrackEventIndex> o_index(
+      builder(ozz::make_span(raw_tracks), 1.f));
+  ASSERT_TRUE(o_index);
+
+  // Streams out.
+  {
+    ozz::io::OArchive o(&stream, ozz::GetNativeEndianness());
+    o << *o_index;
+  }
+
+  // Streams in.
+  stream.Seek(0, ozz::io::Stream::kSet);
+  ozz::io::IArchive i(&stream);
+
+  ozz::animation::TrackEventIndex i_index;
+  i >> i_index;
+
+  EXPECT_EQ(o_index->size(), i_index.size());
+  EXPECT_EQ(o_index->num_tracks(), i_index.num_tracks());
+  EXPECT_FLOAT_EQ(o_index->threshold(), i_index.threshold());
+  ASSERT_EQ(o_index->offsets().size(), i_index.offsets().size());
+  for (size_t j = 0; j < o_index->offsets().size(); ++j) {
+    EXPECT_EQ(o_index->offsets()[j], i_index.offsets()[j]);
+  }
+  ASSERT_EQ(o_index->ratios().size(), i_index.ratios().size());
+  for (size_t j = 0; j < o_index->ratios().size(); ++j) {
+    EXPECT_FLOAT_EQ(o_index->ratios()[j], i_index.ratios()[j]);
+  }
+  ASSERT_EQ(o_index->rising().size(), i_index.rising().size());
+  for (size_t j = 0; j < o_index->rising().size(); ++j) {
+    EXPECT_EQ(o_index->rising()[j], i_index.rising()[j]);
+  }
+
+  // Empty index.
+  {
+    ozz::animation::TrackEventIndex o_empty;
+    stream.Seek(0, ozz::io::Stream::kSet);
+    ozz::io::OArchive o(&stream, ozz::GetNativeEndianness());
+    o << o_empty;
+  }
+  stream.Seek(0, ozz::io::Stream::kSet);
+  ozz::io::IArchive i_empty_archive(&stream);
+  i_empty_archive >> i_index;
+  EXPECT_EQ(i_index.num_tracks(), 0);
+  EXPECT_EQ(i_index.ratios().size(), 0u);
+}
@@ -484,3 +484,251 @@ TEST(Quaternion, TrackSamplingJob) {
   ASSERT_TRUE(sampling.Run());
   EXPECT_QUATERNION_EQ(result, 0.f, 0.f, 0.f, 1.f);
 }
+
+namespace {
+float RandomValue(float*) { return static_cast<float>(rand()) / RAND_MAX; }
+ozz::math::Float3 RandomValue(ozz::math::Float3*) {
+  return ozz::math::Float3(RandomValue(static_cast<float*>(nullptr)),
+                           RandomValue(static_cast<float*>(nullptr)),
+                           RandomValue(static_cast<float*>(nullptr)));
+}
+
+// Builds a track with _num_keys random and randomly stepped keys.
+template <typename _RawTrack>
+void BuildRandomRawTrack(int _num_keys, _RawTrack* _raw_track) {
+  typedef typename _RawTrack::ValueType ValueType;
+  for (int i = 0; i < _num_keys; ++i) {
+    const typename _RawTrack::Keyframe key = {
+        rand() % 4 == 0 ? RawTrackInterpolation::kStep
+                        : RawTrackInterpolation::kLinear,
+        static_cast<float>(i) / _num_keys,
+        RandomValue(static_cast<ValueType*>(nullptr))};
+    _raw_track->keyframes.push_back(key);
+  }
+}
+}  // namespace
+
+TEST(Context, TrackSamplingJob) {
+  TrackBuilder builder;
+  RawFloatTrack raw_track0;
+  BuildRandomRawTrack(64, &raw_track0);
+  RawFloatTrack raw_track1;
+  BuildRandomRawTrack(5, &raw_track1);
+  const ozz::unique_ptr<FloatTrack> tracks[] = {builder(raw_track0),
+                                                builder(raw_track1)};
+  ASSERT_TRUE(tracks[0] && tracks[1]);
+
+  ozz::animation::TrackSamplingContext context;
+  float expected, result;
+  FloatTrackSamplingJob reference;
+  reference.result = &expected;
+  FloatTrackSamplingJob sampling;
+  sampling.result = &result;
+  sampling.context = &context;
+
+  // Forward, backward and random sampling, alternating tracks.
+  const float steps[] = {.001f, .01f, .05f, .3f, -.001f, -.1f};
+  for (const ozz::unique_ptr<FloatTrack>& track : tracks) {
+    reference.track = sampling.track = track.get();
+    for (const float step : steps) {
+      float ratio = step > 0.f ? -.1f : 1.1f;
+      for (int i = 0; i < 2000 && ratio >= -.1f && ratio <= 1.1f; ++i) {
+        reference.ratio = sampling.ratio = ratio;
+        ASSERT_TRUE(reference.Run());
+        ASSERT_TRUE(sampling.Run());
+        EXPECT_FLOAT_EQ(result, expected);
+        ratio += step;
+      }
+    }
+    for (int i = 0; i < 1000; ++i) {
+      reference.ratio = sampling.ratio = static_cast<float>(rand()) / RAND_MAX;
+      ASSERT_TRUE(reference.Run());
+      ASSERT_TRUE(sampling.Run());
+      EXPECT_FLOAT_EQ(result, expected);
+    }
+  }
+
+  // Switches track without invalidating the context.
+  for (int i = 0; i < 100; ++i) {
+    reference.track = sampling.track = tracks[i & 1].get();
+    reference.ratio = sampling.ratio = static_cast<float>(rand()) / RAND_MAX;
+    ASSERT_TRUE(reference.Run());
+    ASSERT_TRUE(sampling.Run());
+    EXPECT_FLOAT_EQ(result, expected);
+  }
+
+  // Invalidated context.
+  context.Invalidate();
+  reference.ratio = sampling.ratio = .5f;
+  ASSERT_TRUE(reference.Run());
+  ASSERT_TRUE(sampling.Run());
+  EXPECT_FLOAT_EQ(result, expected);
+}
+
+TEST(JobValidity, TrackBatchSamplingJob) {
+  FloatTrack track;
+  const FloatTrack* tracks[5] = {&track, &track, &track, &track, &track};
+  const float ratios[5] = {0.f, .1f, .2f, .3f, .4f};
+  ozz::animation::TrackSamplingContext contexts[5];
+  ozz::math::SimdFloat4 results[2];
+
+  {  // Empty/default job has nothing to sample.
+    ozz::animation::FloatTrackBatchSamplingJob job;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Missing ratios
+    ozz::animation::FloatTrackBatchSamplingJob job;
+    job.tracks = tracks;
+    job.results = results;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid
+    ozz::animation::FloatTrackBatchSamplingJob job;
+    job.tracks = tracks;
+    job.ratios = ratios;
+    job.results = results;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+
+    // Shared ratio.
+    job.ratios = ozz::make_span(ratios).first(1);
+    EXPECT_TRUE(job.Validate());
+
+    // Invalid ratios size.
+    job.ratios = ozz::make_span(ratios).first(2);
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Contexts
+    ozz::animation::FloatTrackBatchSamplingJob job;
+    job.tracks = tracks;
+    job.ratios = ratios;
+    job.results = results;
+    job.contexts = contexts;
+    EXPECT_TRUE(job.Validate());
+    job.contexts = ozz::make_span(contexts).first(4);
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Results too small
+    ozz::animation::FloatTrackBatchSamplingJob job;
+    job.tracks = tracks;
+    job.ratios = ratios;
+    job.results = ozz::make_span(results).first(1);
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Null track
+    const FloatTrack* null_tracks[2] = {&track, nullptr};
+    ozz::animation::FloatTrackBatchSamplingJob job;
+    job.tracks = null_tracks;
+    job.ratios = ratios;
+    job.results = results;
+    EXPECT_FALSE(job.Validate());
+  }
+}
+
+TEST(Batch, TrackBatchSamplingJob) {
+  TrackBuilder builder;
+
+  // 6 tracks, including a default and a single key one.
+  ozz::unique_ptr<FloatTrack> float_tracks[6];
+  ozz::unique_ptr<Float3Track> float3_tracks[6];
+  const int num_keys[6] = {8, 0, 1, 64, 3, 17};
+  for (int i = 0; i < 6; ++i) {
+    if (num_keys[i] == 0) {
+      float_tracks[i] = ozz::make_unique<FloatTrack>();
+      float3_tracks[i] = ozz::make_unique<Float3Track>();
+      continue;
+    }
+    RawFloatTrack raw_float_track;
+    BuildRandomRawTrack(num_keys[i], &raw_float_track);
+    float_tracks[i] = builder(raw_float_track);
+    ozz::animation::offline::RawFloat3Track raw_float3_track;
+    BuildRandomRawTrack(num_keys[i], &raw_float3_track);
+    float3_tracks[i] = builder(raw_float3_track);
+    ASSERT_TRUE(float_tracks[i] && float3_tracks[i]);
+  }
+  const FloatTrack* float_track_ptrs[6];
+  const Float3Track* float3_track_ptrs[6];
+  for (int i = 0; i < 6; ++i) {
+    float_track_ptrs[i] = float_tracks[i].get();
+    float3_track_ptrs[i] = float3_tracks[i].get();
+  }
+
+  ozz::animation::TrackSamplingContext float_contexts[6];
+  ozz::animation::TrackSamplingContext float3_contexts[6];
+  ozz::math::SimdFloat4 float_results[2];
+  ozz::math::SoaFloat3 float3_results[2];
+
+  ozz::animation::FloatTrackBatchSamplingJob float_job;
+  float_job.tracks = float_track_ptrs;
+  float_job.results = float_results;
+  ozz::animation::Float3TrackBatchSamplingJob float3_job;
+  float3_job.tracks = float3_track_ptrs;
+  float3_job.results = float3_results;
+
+  float ratios[6] = {};
+  for (int i = 0; i < 200; ++i) {
+    // Alternates per track and shared ratios, with or without contexts.
+    const bool shared = i % 3 == 0;
+    for (float& ratio : ratios) {
+      ratio = -.1f + static_cast<float>(rand()) / RAND_MAX * 1.2f;
+    }
+    float_job.ratios = ozz::make_span(ratios).first(shared ? 1 : 6);
+    float3_job.ratios = float_job.ratios;
+    float_job.contexts = ozz::span<ozz::animation::TrackSamplingContext>();
+    float3_job.contexts = ozz::span<ozz::animation::TrackSamplingContext>();
+    if (i & 1) {
+      float_job.contexts = float_contexts;
+      float3_job.contexts = float3_contexts;
+    }
+    ASSERT_TRUE(float_job.Run());
+    ASSERT_TRUE(float3_job.Run());
+
+    // Compares with scalar sampling.
+    float float_lanes[8];
+    ozz::math::StorePtrU(float_results[0], float_lanes);
+    ozz::math::StorePtrU(float_results[1], float_lanes + 4);
+    float float3_lanes[3][8];
+    ozz::math::StorePtrU(float3_results[0].x, float3_lanes[0]);
+    ozz::math::StorePtrU(float3_results[1].x, float3_lanes[0] + 4);
+    ozz::math::StorePtrU(float3_results[0].y, float3_lanes[1]);
+    ozz::math::StorePtrU(float3_results[1].y, float3_lanes[1] + 4);
+    ozz::math::StorePtrU(float3_results[0].z, float3_lanes[2]);
+    ozz::math::StorePtrU(float3_results[1].z, float3_lanes[2] + 4);
+    for (int t = 0; t < 6; ++t) {
+      const float ratio = shared ? ratios[0] : ratios[t];
+
+      float expected;
+      FloatTrackSamplingJob float_sampling;
+      float_sampling.track = float_tracks[t].get();
+      float_sampling.ratio = ratio;
+      float_sampling.result = &expected;
+      ASSERT_TRUE(float_sampling.Run());
+      EXPECT_NEAR(float_lanes[t], expected, 1e-6f);
+
+      ozz::math::Float3 expected3;
+      ozz::animation::Float3TrackSamplingJob float3_sampling;
+      float3_sampling.track = float3_tracks[t].get();
+      float3_sampling.ratio = ratio;
+      float3_sampling.result = &expected3;
+      ASSERT_TRUE(float3_sampling.Run());
+      EXPECT_NEAR(float3_lanes[0][t], expected3.x, 1e-6f);
+      EXPECT_NEAR(float3_lanes[1][t], expected3.y, 1e-6f);
+      EXPECT_NEAR(float3_lanes[2][t], expected3.z, 1e-6f);
+    }
+
+    // Remaining lanes are set to 0.
+    for (int t = 6; t < 8; ++t) {
+      EXPECT_FLOAT_EQ(float_lanes[t], 0.f);
+      EXPECT_FLOAT_EQ(float3_lanes[0][t], 0.f);
+      EXPECT_FLOAT_EQ(float3_lanes[1][t], 0.f);
+      EXPECT_FLOAT_EQ(float3_lanes[2][t], 0.f);
+    }
+  }
+}
@@ -28,6 +28,7 @@
 #include "ozz/base/io/stream.h"
 
 #include <stdint.h>
+#include <cstring>
 #include <limits>
 
 #include "gtest/gtest.h"
@@ -185,3 +186,66 @@ TEST(MemoryStream, Stream) {
     TestTooBigStream(&stream);
   }
 }
+
+TEST(MappedFile, Stream) {
+  {
+    ozz::io::MappedFile file("unexisting.file");
+    EXPECT_FALSE(file.opened());
+    EXPECT_TRUE(file.data().empty());
+  }
+  {  // Empty file.
+    { ozz::io::File file("test_mapped_empty.bin", "wb"); }
+    ozz::io::MappedFile file("test_mapped_empty.bin");
+    EXPECT_TRUE(file.opened());
+    EXPECT_EQ(file.Size(), 0u);
+    EXPECT_TRUE(file.data().empty());
+    int to_read = 0;
+    EXPECT_EQ(file.Read(&to_read, sizeof(to_read)), 0u);
+  }
+  {
+    const int to_write[] = {46, 93, 99};
+    {
+      ozz::io::File file("test_mapped.bin", "wb");
+      ASSERT_TRUE(file.opened());
+      EXPECT_EQ(file.Write(to_write, sizeof(to_write)), sizeof(to_write));
+    }
+
+    ozz::io::MappedFile file("test_mapped.bin");
+    ASSERT_TRUE(file.opened());
+    EXPECT_EQ(file.Size(), sizeof(to_write));
+    EXPECT_EQ(file.Tell(), 0);
+
+    // Direct access.
+    ASSERT_EQ(file.data().size(), sizeof(to_write));
+    EXPECT_EQ(std::memcmp(file.data().data(), to_write, sizeof(to_write)), 0);
+
+    // Stream access.
+    int to_read = 0;
+    EXPECT_EQ(file.Read(&to_read, sizeof(to_read)), sizeof(to_read));
+    EXPECT_EQ(to_read, 46);
+    EXPECT_EQ(file.Tell(), static_cast<int>(sizeof(to_read)));
+
+    // Read-only.
+    EXPECT_EQ(file.Write(&to_read, sizeof(to_read)), 0u);
+    EXPECT_EQ(file.Size(), sizeof(to_write));
+
+    // Seeks.
+    EXPECT_EQ(file.Seek(-4, ozz::io::Stream::kEnd), 0);
+    EXPECT_EQ(file.Read(&to_read, sizeof(to_read)), sizeof(to_read));
+    EXPECT_EQ(to_read, 99);
+    EXPECT_NE(file.Seek(-1, ozz::io::Stream::kSet), 0);
+    EXPECT_EQ(file.Seek(46, ozz::io::Stream::Origin(27)), -1);
+
+    // Reads beyond the end.
+    EXPECT_EQ(file.Seek(8, ozz::io::Stream::kSet), 0);
+    int to_read2[2] = {0, 0};
+    EXPECT_EQ(file.Read(to_read2, sizeof(to_read2)), sizeof(int));
+    EXPECT_EQ(to_read2[0], 99);
+    EXPECT_EQ(file.Seek(46, ozz::io::Stream::kEnd), 0);
+    EXPECT_EQ(file.Read(to_read2, sizeof(to_read2)), 0u);
+
+    file.Close();
+    EXPECT_FALSE(file.opened());
+    EXPECT_TRUE(file.data().empty());
+  }
+}
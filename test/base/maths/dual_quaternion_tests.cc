@@ -0,0 +1,63 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/base/maths/dual_quaternion.h"
+
+#include "gtest/gtest.h"
+#include "ozz/base/gtest_helper.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/math_constant.h"
+
+using ozz::math::DualQuaternion;
+using ozz::math::Float3;
+using ozz::math::Quaternion;
+
+TEST(DualQuaternionConstant, ozz_math) {
+  const DualQuaternion identity = DualQuaternion::identity();
+  EXPECT_QUATERNION_EQ(identity.real, 0.f, 0.f, 0.f, 1.f);
+  EXPECT_QUATERNION_EQ(identity.dual, 0.f, 0.f, 0.f, 0.f);
+  EXPECT_FLOAT3_EQ(ToTranslation(identity), 0.f, 0.f, 0.f);
+}
+
+TEST(DualQuaternionAffine, ozz_math) {
+  EXPECT_ASSERTION(DualQuaternion::FromAffine(Float3::zero(),
+                                              Quaternion(0.f, 0.f, 0.f, 2.f)),
+                   "IsNormalized");
+
+  const Quaternion rotation =
+      Quaternion::FromAxisAngle(Float3::y_axis(), ozz::math::kPi_2);
+  const DualQuaternion dq =
+      DualQuaternion::FromAffine(Float3(1.f, 2.f, 3.f), rotation);
+  EXPECT_QUATERNION_EQ(dq.real, rotation.x, rotation.y, rotation.z,
+                       rotation.w);
+  EXPECT_FLOAT3_EQ(ToTranslation(dq), 1.f, 2.f, 3.f);
+
+  // Rotation applies first, then translation.
+  EXPECT_FLOAT3_EQ(TransformPoint(dq, Float3(1.f, 0.f, 0.f)), 1.f, 2.f, 2.f);
+  EXPECT_FLOAT3_EQ(TransformVector(dq, Float3(1.f, 0.f, 0.f)), 0.f, 0.f,
+                   -1.f);
+}
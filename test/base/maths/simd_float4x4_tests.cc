@@ -577,3 +577,18 @@ TEST(Float4x4ToAffine, ozz_simd_math) {
   EXPECT_SIMDFLOAT_EQ(rotate, 0.f, 0.f, 0.f, 1.f);
   EXPECT_SIMDFLOAT_EQ(scale, .000907520065f, .000959928846f, .0159599986f, 1.f);
 }
+
+TEST(Float3x4, ozz_simd_math) {
+  const Float4x4 m0 = {{ozz::math::simd_float4::Load(0.f, 1.f, 2.f, 0.f),
+                        ozz::math::simd_float4::Load(4.f, 5.f, 6.f, 0.f),
+                        ozz::math::simd_float4::Load(8.f, 9.f, 10.f, 0.f),
+                        ozz::math::simd_float4::Load(12.f, 13.f, 14.f, 1.f)}};
+  const ozz::math::Float3x4 affine = ozz::math::Float3x4::FromFloat4x4(m0);
+  EXPECT_SIMDFLOAT_EQ(affine.rows[0], 0.f, 4.f, 8.f, 12.f);
+  EXPECT_SIMDFLOAT_EQ(affine.rows[1], 1.f, 5.f, 9.f, 13.f);
+  EXPECT_SIMDFLOAT_EQ(affine.rows[2], 2.f, 6.f, 10.f, 14.f);
+
+  const Float4x4 m1 = ToFloat4x4(affine);
+  EXPECT_FLOAT4x4_EQ(m1, 0.f, 1.f, 2.f, 0.f, 4.f, 5.f, 6.f, 0.f, 8.f, 9.f, 10.f,
+                     0.f, 12.f, 13.f, 14.f, 1.f);
+}
@@ -0,0 +1,181 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/base/maths/simd_float8.h"
+
+#include <cstdio>
+
+#include "gtest/gtest.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+
+#if defined(OZZ_SIMD_AVX2) || defined(OZZ_SIMD_AVX2_DISPATCH)
+
+using ozz::math::Soa8Float3;
+using ozz::math::Soa8Quaternion;
+using ozz::math::SoaFloat3;
+using ozz::math::SoaQuaternion;
+
+namespace {
+// 8 lanes functions can only be called from functions compiled for AVX2 (see
+// OZZ_SIMD_AVX2_DISPATCH), hence these helpers.
+OZZ_SIMD_AVX2_TARGET void LoadStore(ozz::math::_SimdFloat4 _lo,
+                                    ozz::math::_SimdFloat4 _hi,
+                                    ozz::math::SimdFloat4* _out_lo,
+                                    ozz::math::SimdFloat4* _out_hi) {
+  ozz::math::simd_float8::Store(ozz::math::simd_float8::Load(_lo, _hi),
+                                _out_lo, _out_hi);
+}
+
+OZZ_SIMD_AVX2_TARGET void Load1Store(float _x, ozz::math::SimdFloat4* _lo,
+                                     ozz::math::SimdFloat4* _hi) {
+  ozz::math::simd_float8::Store(ozz::math::simd_float8::Load1(_x), _lo, _hi);
+}
+
+OZZ_SIMD_AVX2_TARGET void Lerp8(const SoaFloat3 _a[2], const SoaFloat3 _b[2],
+                                const ozz::math::SimdFloat4 _f[2],
+                                SoaFloat3 _r[2]) {
+  Lerp(Soa8Float3::Load(_a[0], _a[1]), Soa8Float3::Load(_b[0], _b[1]),
+       ozz::math::simd_float8::Load(_f[0], _f[1]))
+      .Store(&_r[0], &_r[1]);
+}
+
+OZZ_SIMD_AVX2_TARGET void NLerpEst8(const SoaQuaternion _a[2],
+                                    const SoaQuaternion _b[2],
+                                    const ozz::math::SimdFloat4 _f[2],
+                                    SoaQuaternion _r[2]) {
+  NLerpEst(Soa8Quaternion::Load(_a[0], _a[1]),
+           Soa8Quaternion::Load(_b[0], _b[1]),
+           ozz::math::simd_float8::Load(_f[0], _f[1]))
+      .Store(&_r[0], &_r[1]);
+}
+}  // namespace
+
+TEST(SupportsAvx2, ozz_soa_math) {
+#ifdef OZZ_SIMD_AVX2
+  EXPECT_TRUE(ozz::math::SupportsAvx2());
+#endif  // OZZ_SIMD_AVX2
+  std::printf("AVX2 code paths are %s.\n",
+              ozz::math::SupportsAvx2() ? "enabled" : "disabled");
+}
+
+TEST(SimdFloat8LoadStore, ozz_soa_math) {
+  if (!ozz::math::SupportsAvx2()) {
+    return;
+  }
+
+  ozz::math::SimdFloat4 lo, hi;
+  LoadStore(ozz::math::simd_float4::Load(0.f, 1.f, 2.f, 3.f),
+            ozz::math::simd_float4::Load(4.f, 5.f, 6.f, 7.f), &lo, &hi);
+  EXPECT_SIMDFLOAT_EQ(lo, 0.f, 1.f, 2.f, 3.f);
+  EXPECT_SIMDFLOAT_EQ(hi, 4.f, 5.f, 6.f, 7.f);
+
+  Load1Store(46.f, &lo, &hi);
+  EXPECT_SIMDFLOAT_EQ(lo, 46.f, 46.f, 46.f, 46.f);
+  EXPECT_SIMDFLOAT_EQ(hi, 46.f, 46.f, 46.f, 46.f);
+}
+
+TEST(Soa8Float3Lerp, ozz_soa_math) {
+  if (!ozz::math::SupportsAvx2()) {
+    return;
+  }
+
+  const SoaFloat3 a[2] = {
+      SoaFloat3::Load(ozz::math::simd_float4::Load(0.f, 1.f, 2.f, 3.f),
+                      ozz::math::simd_float4::Load(4.f, 5.f, 6.f, 7.f),
+                      ozz::math::simd_float4::Load(8.f, 9.f, 10.f, 11.f)),
+      SoaFloat3::Load(ozz::math::simd_float4::Load(-1.f, -2.f, -3.f, -4.f),
+                      ozz::math::simd_float4::Load(12.f, 13.f, 14.f, 15.f),
+                      ozz::math::simd_float4::Load(.5f, .25f, .125f, 0.f))};
+  const SoaFloat3 b[2] = {
+      SoaFloat3::Load(ozz::math::simd_float4::Load(4.f, 3.f, 2.f, 1.f),
+                      ozz::math::simd_float4::Load(-4.f, -5.f, 6.f, 70.f),
+                      ozz::math::simd_float4::Load(0.f, 0.f, 1.f, 1.f)),
+      SoaFloat3::Load(ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 4.f),
+                      ozz::math::simd_float4::Load(0.f, 0.f, 0.f, 0.f),
+                      ozz::math::simd_float4::Load(5.f, 2.5f, 1.25f, 8.f))};
+  const ozz::math::SimdFloat4 f[2] = {
+      ozz::math::simd_float4::Load(0.f, .5f, 1.f, .25f),
+      ozz::math::simd_float4::Load(.75f, 2.f, -1.f, .1f)};
+
+  SoaFloat3 r[2];
+  Lerp8(a, b, f, r);
+  for (int i = 0; i < 2; ++i) {
+    const SoaFloat3 expected = Lerp(a[i], b[i], f[i]);
+    EXPECT_SIMDFLOAT_EQ(r[i].x, ozz::math::GetX(expected.x),
+                        ozz::math::GetY(expected.x),
+                        ozz::math::GetZ(expected.x),
+                        ozz::math::GetW(expected.x));
+    EXPECT_SIMDFLOAT_EQ(r[i].y, ozz::math::GetX(expected.y),
+                        ozz::math::GetY(expected.y),
+                        ozz::math::GetZ(expected.y),
+                        ozz::math::GetW(expected.y));
+    EXPECT_SIMDFLOAT_EQ(r[i].z, ozz::math::GetX(expected.z),
+                        ozz::math::GetY(expected.z),
+                        ozz::math::GetZ(expected.z),
+                        ozz::math::GetW(expected.z));
+  }
+}
+
+TEST(Soa8QuaternionNLerpEst, ozz_soa_math) {
+  if (!ozz::math::SupportsAvx2()) {
+    return;
+  }
+
+  const SoaQuaternion a[2] = {
+      SoaQuaternion::Load(
+          ozz::math::simd_float4::Load(.70710677f, 0.f, 0.f, .382683432f),
+          ozz::math::simd_float4::Load(0.f, 0.f, .70710677f, 0.f),
+          ozz::math::simd_float4::Load(0.f, 0.f, 0.f, 0.f),
+          ozz::math::simd_float4::Load(.70710677f, 1.f, .70710677f,
+                                       .9238795f)),
+      SoaQuaternion::identity()};
+  const SoaQuaternion b[2] = {
+      SoaQuaternion::Load(
+          ozz::math::simd_float4::Load(0.f, .70710677f, 0.f, -.382683432f),
+          ozz::math::simd_float4::Load(0.f, 0.f, .70710677f, 0.f),
+          ozz::math::simd_float4::Load(0.f, 0.f, 0.f, 0.f),
+          ozz::math::simd_float4::Load(1.f, .70710677f, .70710677f,
+                                       .9238795f)),
+      a[0]};
+  const ozz::math::SimdFloat4 f[2] = {
+      ozz::math::simd_float4::Load(.5f, .1f, .7f, 1.f),
+      ozz::math::simd_float4::Load(0.f, .3f, .5f, .9f)};
+
+  SoaQuaternion r[2];
+  NLerpEst8(a, b, f, r);
+  for (int i = 0; i < 2; ++i) {
+    const SoaQuaternion e = NLerpEst(a[i], b[i], f[i]);
+    EXPECT_SOAQUATERNION_EQ_EST(
+        r[i], ozz::math::GetX(e.x), ozz::math::GetY(e.x), ozz::math::GetZ(e.x),
+        ozz::math::GetW(e.x), ozz::math::GetX(e.y), ozz::math::GetY(e.y),
+        ozz::math::GetZ(e.y), ozz::math::GetW(e.y), ozz::math::GetX(e.z),
+        ozz::math::GetY(e.z), ozz::math::GetZ(e.z), ozz::math::GetW(e.z),
+        ozz::math::GetX(e.w), ozz::math::GetY(e.w), ozz::math::GetZ(e.w),
+        ozz::math::GetW(e.w));
+  }
+}
+#endif  // OZZ_SIMD_AVX2 || OZZ_SIMD_AVX2_DISPATCH
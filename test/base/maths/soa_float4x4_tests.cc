@@ -304,3 +304,25 @@ TEST(SoaFloat4x4Affine, ozz_soa_math) {
       .0707106f, 0.f, 0.f, -1.f, .0707106f, 0.f, 0.f, 0.f, 0.f, 0.f, 46.f, 7.f,
       -12.f, 0.f, 12.f, 7.f, -46.f, 0.f, 0.f, 7.f, 46.f, 1.f, 1.f, 1.f, 1.f);
 }
+
+TEST(SoaFloat4x4Transform, ozz_soa_math) {
+  const SoaFloat3 translation =
+      SoaFloat3::Load(ozz::math::simd_float4::Load(0.f, 46.f, 7.f, -12.f),
+                      ozz::math::simd_float4::Load(0.f, 12.f, 7.f, -46.f),
+                      ozz::math::simd_float4::Load(0.f, 0.f, 7.f, 46.f));
+  const SoaFloat3 scale =
+      SoaFloat3::Load(ozz::math::simd_float4::Load(1.f, 1.f, -1.f, 2.f),
+                      ozz::math::simd_float4::Load(1.f, 2.f, -1.f, 2.f),
+                      ozz::math::simd_float4::Load(1.f, 3.f, -1.f, 2.f));
+  const SoaFloat4x4 matrix = SoaFloat4x4::FromAffine(
+      translation, SoaQuaternion::identity(), scale);
+
+  const SoaFloat3 v =
+      SoaFloat3::Load(ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 4.f),
+                      ozz::math::simd_float4::Load(-1.f, -2.f, -3.f, -4.f),
+                      ozz::math::simd_float4::Load(0.f, 1.f, 0.f, -1.f));
+  EXPECT_SOAFLOAT3_EQ(ozz::math::TransformPoint(matrix, v), 1.f, 48.f, 4.f,
+                      -4.f, -1.f, 8.f, 10.f, -54.f, 0.f, 3.f, 7.f, 44.f);
+  EXPECT_SOAFLOAT3_EQ(ozz::math::TransformVector(matrix, v), 1.f, 2.f, -3.f,
+                      8.f, -1.f, -4.f, 3.f, -8.f, 0.f, 3.f, 0.f, -2.f);
+}
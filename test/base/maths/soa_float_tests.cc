@@ -411,6 +411,11 @@ TEST(SoaFloatComparison4, ozz_soa_math) {
                        ozz::math::simd_float4::Load(1.f, 58.f, 16.f, 78.f),
                        ozz::math::simd_float4::Load(2.5f, 9.f, 111.f, 22.f),
                        ozz::math::simd_float4::Load(8.f, 23.f, 41.f, 18.f)};
+  const ozz::math::SimdInt4 mask =
+      ozz::math::simd_int4::Load(-1, 0, -1, 0);
+  EXPECT_SOAFLOAT4_EQ(Select(mask, a, b), .5f, 3.f, 2.f, 3.f, 1.f, -5.f, 6.f,
+                      5.f, 2.f, 9.f, 10.f, 2.f, 3.f, -8.f, 14.f, 5.f);
+
   const SoaFloat4 min = Min(a, b);
   EXPECT_SOAFLOAT4_EQ(min, .5f, 1.f, 2.f, 3.f, 1.f, -5.f, 6.f, 5.f, -6.f, 9.f,
                       -10.f, 2.f, 3.f, -8.f, 1.f, 5.f);
@@ -452,6 +457,11 @@ TEST(SoaFloatComparison3, ozz_soa_math) {
   const SoaFloat3 c = {ozz::math::simd_float4::Load(7.5f, 12.f, 46.f, 31.f),
                        ozz::math::simd_float4::Load(1.f, 58.f, 16.f, 78.f),
                        ozz::math::simd_float4::Load(2.5f, 9.f, 111.f, 22.f)};
+  const ozz::math::SimdInt4 mask =
+      ozz::math::simd_int4::Load(-1, 0, -1, 0);
+  EXPECT_SOAFLOAT3_EQ(Select(mask, a, b), .5f, 3.f, 2.f, 3.f, 1.f, -5.f, 6.f,
+                      5.f, 2.f, 9.f, 10.f, 2.f);
+
   const SoaFloat3 min = Min(a, b);
   EXPECT_SOAFLOAT3_EQ(min, .5f, 1.f, 2.f, 3.f, 1.f, -5.f, 6.f, 5.f, -6.f, 9.f,
                       -10.f, 2.f);
@@ -488,6 +498,11 @@ TEST(SoaFloatComparison2, ozz_soa_math) {
                        ozz::math::simd_float4::Load(2.f, -5.f, 6.f, 5.f)};
   const SoaFloat2 c = {ozz::math::simd_float4::Load(7.5f, 12.f, 46.f, 31.f),
                        ozz::math::simd_float4::Load(1.f, 58.f, 16.f, 78.f)};
+  const ozz::math::SimdInt4 mask =
+      ozz::math::simd_int4::Load(-1, 0, -1, 0);
+  EXPECT_SOAFLOAT2_EQ(Select(mask, a, b), .5f, 3.f, 2.f, 3.f, 1.f, -5.f, 6.f,
+                      5.f);
+
   const SoaFloat2 min = Min(a, b);
   EXPECT_SOAFLOAT2_EQ(min, .5f, 1.f, 2.f, 3.f, 1.f, -5.f, 6.f, 5.f);
 
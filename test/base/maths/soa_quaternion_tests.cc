@@ -180,3 +180,61 @@ TEST(SoaQuaternionArithmetic, ozz_soa_math) {
   const SimdInt4 same_ab = Compare(a, b, ozz::math::simd_float4::Load1(.99f));
   EXPECT_SIMDINT_EQ(same_ab, 0, 0, 0xffffffff, 0);
 }
+
+TEST(SoaQuaternionAxisAngle, ozz_soa_math) {
+  const SoaFloat3 axis =
+      SoaFloat3::Load(ozz::math::simd_float4::Load(1.f, 0.f, 0.f, 0.f),
+                      ozz::math::simd_float4::Load(0.f, 1.f, 0.f, 0.f),
+                      ozz::math::simd_float4::Load(0.f, 0.f, 1.f, 1.f));
+
+  const SoaQuaternion q0 = SoaQuaternion::FromAxisAngle(
+      axis, ozz::math::simd_float4::Load(1.57079632f, 3.14159265f, 0.f,
+                                         -1.57079632f));
+  EXPECT_SOAQUATERNION_EQ(q0, .70710677f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f,
+                          0.f, 0.f, 0.f, -.70710677f, .70710677f, 0.f, 1.f,
+                          .70710677f);
+
+  const SoaQuaternion q1 = SoaQuaternion::FromAxisCosAngle(
+      axis, ozz::math::simd_float4::Load(0.f, -1.f, 1.f, 0.f));
+  EXPECT_SOAQUATERNION_EQ(q1, .70710677f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f,
+                          0.f, 0.f, 0.f, .70710677f, .70710677f, 0.f, 1.f,
+                          .70710677f);
+
+  // Transforms x axis.
+  const SoaFloat3 v = ozz::math::TransformVector(q0, SoaFloat3::x_axis());
+  EXPECT_SOAFLOAT3_EQ(v, 1.f, -1.f, 1.f, 0.f, 0.f, 0.f, 0.f, -1.f, 0.f, 0.f,
+                      0.f, 0.f);
+}
+
+TEST(SoaQuaternionFromVectors, ozz_soa_math) {
+  const ozz::math::SimdFloat4 zero = ozz::math::simd_float4::zero();
+
+  // Lanes are: x to y, x to x, x to -x (opposite) and null vector.
+  const SoaFloat3 from = SoaFloat3::Load(
+      ozz::math::simd_float4::Load(1.f, 1.f, 1.f, 0.f), zero, zero);
+  const SoaFloat3 to =
+      SoaFloat3::Load(ozz::math::simd_float4::Load(0.f, 2.f, -1.f, 1.f),
+                      ozz::math::simd_float4::Load(1.f, 0.f, 0.f, 0.f), zero);
+  const SoaQuaternion q = SoaQuaternion::FromVectors(from, to);
+  EXPECT_SOAQUATERNION_EQ(q, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f,
+                          .70710677f, 0.f, 0.f, 0.f, .70710677f, 1.f, 0.f,
+                          1.f);
+}
+
+TEST(SoaQuaternionSelect, ozz_soa_math) {
+  const SoaQuaternion a = SoaQuaternion::Load(
+      ozz::math::simd_float4::Load(.70710677f, 0.f, 0.f, .382683432f),
+      ozz::math::simd_float4::Load(0.f, 0.f, .70710677f, 0.f),
+      ozz::math::simd_float4::Load(0.f, 0.f, 0.f, 0.f),
+      ozz::math::simd_float4::Load(.70710677f, 1.f, .70710677f, .9238795f));
+  const SoaQuaternion b = SoaQuaternion::Load(
+      ozz::math::simd_float4::Load(0.f, .70710677f, 0.f, -.382683432f),
+      ozz::math::simd_float4::Load(0.f, 0.f, .70710677f, 0.f),
+      ozz::math::simd_float4::Load(0.f, 0.f, 0.f, 0.f),
+      ozz::math::simd_float4::Load(1.f, .70710677f, .70710677f, .9238795f));
+  const SoaQuaternion q =
+      Select(ozz::math::simd_int4::Load(-1, 0, -1, 0), a, b);
+  EXPECT_SOAQUATERNION_EQ(q, .70710677f, .70710677f, 0.f, -.382683432f, 0.f,
+                          0.f, .70710677f, 0.f, 0.f, 0.f, 0.f, 0.f, .70710677f,
+                          .70710677f, .70710677f, .9238795f);
+}
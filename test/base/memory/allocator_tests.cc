@@ -25,7 +25,10 @@
 //                                                                            //
 //----------------------------------------------------------------------------//
 
+#include <thread>
+
 #include "gtest/gtest.h"
+#include "ozz/base/containers/vector.h"
 #include "ozz/base/maths/math_ex.h"
 #include "ozz/base/memory/allocator.h"
 
@@ -152,3 +155,94 @@ TEST(AllocatorOverride, Memory) {
 
   EXPECT_EQ(ozz::memory::SetDefaulAllocator(previous), current);
 }
+
+// Counts allocations and deallocations, forwarding them to the heap.
+class CountingAllocator : public ozz::memory::Allocator {
+ public:
+  int allocations = 0;
+  int deallocations = 0;
+
+ private:
+  virtual void* Allocate(size_t _size, size_t _alignment) {
+    ++allocations;
+    return backing_->Allocate(_size, _alignment);
+  }
+  virtual void Deallocate(void* _block) {
+    ++deallocations;
+    backing_->Deallocate(_block);
+  }
+
+  ozz::memory::Allocator* backing_ = ozz::memory::default_allocator();
+};
+
+TEST(ScopedAllocator, Memory) {
+  CountingAllocator scoped_allocator;
+  CountingAllocator nested_allocator;
+  ozz::memory::Allocator* global = ozz::memory::default_allocator();
+  {
+    ozz::memory::ScopedAllocator scope(&scoped_allocator);
+    EXPECT_NE(ozz::memory::default_allocator(), global);
+    {
+      ozz::memory::ScopedAllocator nested(&nested_allocator);
+
+      // Other threads aren't affected.
+      ozz::memory::Allocator* other = nullptr;
+      std::thread thread(
+          [&other]() { other = ozz::memory::default_allocator(); });
+      thread.join();
+      EXPECT_EQ(other, global);
+
+      // Allocation uses the innermost scoped allocator.
+      int* i = ozz::New<int>(46);
+      EXPECT_EQ(*i, 46);
+      EXPECT_EQ(nested_allocator.allocations, 1);
+      EXPECT_EQ(scoped_allocator.allocations, 0);
+
+      // Deallocation goes to the allocator the block comes from.
+      {
+        ozz::memory::ScopedAllocator inner(&scoped_allocator);
+        ozz::Delete(i);
+      }
+      EXPECT_EQ(nested_allocator.deallocations, 1);
+      EXPECT_EQ(scoped_allocator.deallocations, 0);
+    }
+    int* i = ozz::New<int>(46);
+    EXPECT_EQ(scoped_allocator.allocations, 1);
+    ozz::Delete(i);
+    EXPECT_EQ(scoped_allocator.deallocations, 1);
+  }
+  EXPECT_EQ(ozz::memory::default_allocator(), global);
+}
+
+TEST(ScopedAllocatorLifetime, Memory) {
+  CountingAllocator scoped_allocator;
+
+  // Block allocated before the scope, released within it.
+  int* before = ozz::New<int>(46);
+
+  // Container resized within the scope, destroyed after it.
+  ozz::vector<int> container;
+  {
+    ozz::memory::ScopedAllocator scope(&scoped_allocator);
+    ozz::Delete(before);
+    EXPECT_EQ(scoped_allocator.deallocations, 0);
+
+    container.resize(1000, 46);
+    EXPECT_EQ(scoped_allocator.allocations, 1);
+  }
+  container.clear();
+  container.shrink_to_fit();
+  EXPECT_EQ(scoped_allocator.deallocations, 1);
+}
+
+TEST(HeapStats, Memory) {
+  const ozz::memory::Stats before = ozz::memory::heap_stats();
+  void* p = ozz::memory::default_allocator()->Allocate(46, 16);
+  ozz::memory::default_allocator()->Deallocate(p);
+  ozz::memory::default_allocator()->Deallocate(nullptr);
+  const ozz::memory::Stats after = ozz::memory::heap_stats();
+  EXPECT_EQ(after.allocations - before.allocations, 1u);
+  EXPECT_EQ(after.deallocations - before.deallocations, 1u);
+  EXPECT_EQ(after.backing_allocations - before.backing_allocations, 1u);
+  EXPECT_EQ(after.allocated_bytes - before.allocated_bytes, 46u);
+}
@@ -0,0 +1,120 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/base/memory/arena_allocator.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+TEST(Allocate, ArenaAllocator) {
+  ozz::memory::ArenaAllocator arena(1024);
+  EXPECT_EQ(arena.used(), 0u);
+
+  void* p0 = arena.Allocate(10, 1);
+  ASSERT_TRUE(p0 != nullptr);
+  void* p1 = arena.Allocate(100, 64);
+  ASSERT_TRUE(p1 != nullptr);
+  EXPECT_TRUE(ozz::IsAligned(p1, 64));
+  EXPECT_NE(p0, p1);
+  std::memset(p0, 0xaa, 10);
+  std::memset(p1, 0xbb, 100);
+  EXPECT_EQ(static_cast<unsigned char*>(p0)[9], 0xaa);
+
+  // Both allocations come from the same chunk.
+  EXPECT_EQ(arena.stats().allocations, 2u);
+  EXPECT_EQ(arena.stats().backing_allocations, 1u);
+  EXPECT_EQ(arena.stats().allocated_bytes, 110u);
+
+  // Deallocation does nothing.
+  arena.Deallocate(p0);
+  arena.Deallocate(nullptr);
+  EXPECT_EQ(arena.stats().deallocations, 1u);
+  EXPECT_EQ(arena.stats().backing_deallocations, 0u);
+
+  // Allocation bigger than a chunk.
+  void* big = arena.Allocate(4096, 16);
+  ASSERT_TRUE(big != nullptr);
+  std::memset(big, 0, 4096);
+  EXPECT_EQ(arena.stats().backing_allocations, 2u);
+  EXPECT_GE(arena.used(), 4096u + 110u);
+
+  // Reset keeps the first chunk only.
+  arena.Reset();
+  EXPECT_EQ(arena.used(), 0u);
+  EXPECT_EQ(arena.stats().backing_deallocations, 1u);
+  void* p2 = arena.Allocate(10, 1);
+  EXPECT_EQ(p2, p0);
+  EXPECT_EQ(arena.stats().backing_allocations, 2u);
+}
+
+TEST(Scoped, ArenaAllocator) {
+  ozz::memory::Allocator* heap = ozz::memory::default_allocator();
+  void* foreign = heap->Allocate(16, 16);
+
+  ozz::memory::ArenaAllocator arena;
+  ozz::vector<int> container;
+  {
+    ozz::memory::ScopedAllocator scope(&arena);
+
+    // Objects allocated and released in the scope use the arena.
+    int* i = ozz::New<int>(46);
+    EXPECT_EQ(*i, 46);
+    ozz::Delete(i);
+    EXPECT_EQ(arena.stats().allocations, 1u);
+    EXPECT_EQ(arena.stats().deallocations, 1u);
+
+    // Blocks allocated before the scope are released to the heap.
+    ozz::memory::default_allocator()->Deallocate(foreign);
+    EXPECT_EQ(arena.stats().deallocations, 1u);
+
+    container.resize(100);
+    EXPECT_EQ(arena.stats().allocations, 2u);
+  }
+
+  // Blocks allocated in the scope are released to the arena.
+  container.clear();
+  container.shrink_to_fit();
+  EXPECT_EQ(arena.stats().deallocations, 2u);
+}
+
+TEST(ResetOversized, ArenaAllocator) {
+  ozz::memory::ArenaAllocator arena(64);
+
+  // First chunk is bigger than nominal size, and is kept by Reset.
+  void* big = arena.Allocate(1000, 16);
+  ASSERT_TRUE(big != nullptr);
+  std::memset(big, 0, 1000);
+  arena.Reset();
+  void* p0 = arena.Allocate(500, 16);
+  ASSERT_TRUE(p0 != nullptr);
+  std::memset(p0, 0, 500);
+  EXPECT_EQ(arena.stats().backing_allocations, 1u);
+  EXPECT_EQ(arena.stats().backing_deallocations, 0u);
+}
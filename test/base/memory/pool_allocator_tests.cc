@@ -0,0 +1,103 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/base/memory/pool_allocator.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+TEST(Allocate, PoolAllocator) {
+  ozz::memory::PoolAllocator pool(20, 4);
+  EXPECT_EQ(pool.block_size(), 32u);
+
+  void* blocks[5];
+  for (int i = 0; i < 5; ++i) {
+    blocks[i] = pool.Allocate(20, 8);
+    ASSERT_TRUE(blocks[i] != nullptr);
+    EXPECT_TRUE(ozz::IsAligned(blocks[i], 16));
+    std::memset(blocks[i], i, 20);
+  }
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(static_cast<unsigned char*>(blocks[i])[19], i);
+  }
+
+  // 2 slabs of 4 blocks.
+  EXPECT_EQ(pool.stats().allocations, 5u);
+  EXPECT_EQ(pool.stats().backing_allocations, 2u);
+
+  // Deallocated blocks are recycled.
+  pool.Deallocate(blocks[2]);
+  pool.Deallocate(nullptr);
+  EXPECT_EQ(pool.Allocate(16, 16), blocks[2]);
+  EXPECT_EQ(pool.stats().deallocations, 1u);
+  EXPECT_EQ(pool.stats().backing_deallocations, 0u);
+  EXPECT_EQ(pool.stats().backing_allocations, 2u);
+
+  for (int i = 0; i < 5; ++i) {
+    pool.Deallocate(blocks[i]);
+  }
+  EXPECT_EQ(pool.stats().backing_deallocations, 0u);
+}
+
+TEST(Forward, PoolAllocator) {
+  ozz::memory::PoolAllocator pool(16);
+
+  // Too big.
+  void* big = pool.Allocate(17, 4);
+  ASSERT_TRUE(big != nullptr);
+  std::memset(big, 0, 17);
+
+  // Too aligned.
+  void* aligned = pool.Allocate(8, 64);
+  ASSERT_TRUE(aligned != nullptr);
+  EXPECT_TRUE(ozz::IsAligned(aligned, 64));
+
+  EXPECT_EQ(pool.stats().backing_allocations, 2u);
+
+  pool.Deallocate(big);
+  pool.Deallocate(aligned);
+  EXPECT_EQ(pool.stats().backing_deallocations, 2u);
+}
+
+TEST(Scoped, PoolAllocator) {
+  // Scope header (2 pointers) is included in the requested size.
+  ozz::memory::PoolAllocator pool(sizeof(int) + 2 * sizeof(void*));
+  int* i = nullptr;
+  {
+    ozz::memory::ScopedAllocator scope(&pool);
+    i = ozz::New<int>(46);
+    EXPECT_EQ(*i, 46);
+    EXPECT_EQ(pool.stats().allocations, 1u);
+    EXPECT_EQ(pool.stats().backing_allocations, 1u);
+  }
+
+  // Released to the pool after the scope.
+  ozz::Delete(i);
+  EXPECT_EQ(pool.stats().deallocations, 1u);
+  EXPECT_EQ(pool.stats().backing_deallocations, 0u);
+}
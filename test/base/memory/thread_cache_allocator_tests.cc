@@ -0,0 +1,155 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/base/memory/thread_cache_allocator.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(Allocate, ThreadCacheAllocator) {
+  ozz::memory::ThreadCacheAllocator cache(2);
+
+  void* p0 = cache.Allocate(10, 4);
+  ASSERT_TRUE(p0 != nullptr);
+  EXPECT_TRUE(ozz::IsAligned(p0, 16));
+  std::memset(p0, 0, 16);  // Size class is 16.
+
+  // Same size class reuses cached block.
+  cache.Deallocate(p0);
+  void* p1 = cache.Allocate(16, 16);
+  EXPECT_EQ(p1, p0);
+  EXPECT_EQ(cache.stats().backing_allocations, 1u);
+
+  // Different size class doesn't.
+  void* p2 = cache.Allocate(17, 4);
+  EXPECT_NE(p2, p0);
+  std::memset(p2, 0, 32);
+  EXPECT_EQ(cache.stats().backing_allocations, 2u);
+
+  // Big and over aligned blocks aren't cached.
+  void* big = cache.Allocate(5000, 16);
+  ASSERT_TRUE(big != nullptr);
+  std::memset(big, 0, 5000);
+  void* aligned = cache.Allocate(8, 256);
+  ASSERT_TRUE(aligned != nullptr);
+  EXPECT_TRUE(ozz::IsAligned(aligned, 256));
+  cache.Deallocate(big);
+  cache.Deallocate(aligned);
+  EXPECT_EQ(cache.stats().backing_deallocations, 2u);
+
+  cache.Deallocate(p1);
+  cache.Deallocate(p2);
+  cache.Deallocate(nullptr);
+  EXPECT_EQ(cache.stats().allocations, 5u);
+  EXPECT_EQ(cache.stats().deallocations, 5u);
+  EXPECT_EQ(cache.stats().backing_deallocations, 2u);
+
+  // Flush releases cached blocks.
+  cache.Flush();
+  EXPECT_EQ(cache.stats().backing_deallocations, 4u);
+}
+
+TEST(MaxCachedBlocks, ThreadCacheAllocator) {
+  ozz::memory::ThreadCacheAllocator cache(2);
+  void* blocks[3];
+  for (void*& block : blocks) {
+    block = cache.Allocate(64, 16);
+  }
+  for (void* block : blocks) {
+    cache.Deallocate(block);
+  }
+  // Only 2 blocks are cached.
+  EXPECT_EQ(cache.stats().backing_deallocations, 1u);
+  cache.Flush();
+}
+
+TEST(Threads, ThreadCacheAllocator) {
+  ozz::memory::ThreadCacheAllocator cache;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, t]() {
+      for (int i = 0; i < 1000; ++i) {
+        const size_t size = 16 + (i % 7) * 100;
+        char* p = static_cast<char*>(cache.Allocate(size, 16));
+        std::memset(p, t, size);
+        EXPECT_EQ(p[size - 1], t);
+        cache.Deallocate(p);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  // Blocks are mostly reused.
+  const ozz::memory::Stats stats = cache.stats();
+  EXPECT_EQ(stats.allocations, 4000u);
+  EXPECT_EQ(stats.deallocations, 4000u);
+  EXPECT_LE(stats.backing_allocations, 4u * 7u);
+}
+
+TEST(Instances, ThreadCacheAllocator) {
+  ozz::memory::ThreadCacheAllocator cache0;
+  ozz::memory::ThreadCacheAllocator cache1;
+
+  // Each instance has its own cache, even from the same thread.
+  void* p0 = cache0.Allocate(16, 16);
+  void* p1 = cache1.Allocate(16, 16);
+  cache0.Deallocate(p0);
+  cache1.Deallocate(p1);
+  EXPECT_EQ(cache1.Allocate(16, 16), p1);
+  EXPECT_EQ(cache0.Allocate(16, 16), p0);
+  EXPECT_EQ(cache0.stats().backing_allocations, 1u);
+  EXPECT_EQ(cache1.stats().backing_allocations, 1u);
+
+  cache0.Deallocate(p0);
+  cache1.Deallocate(p1);
+}
+
+TEST(Scoped, ThreadCacheAllocator) {
+  ozz::memory::Allocator* heap = ozz::memory::default_allocator();
+  void* foreign = heap->Allocate(16, 16);
+
+  ozz::memory::ThreadCacheAllocator cache;
+  {
+    ozz::memory::ScopedAllocator scope(&cache);
+
+    // Blocks allocated before the scope are released to the heap.
+    ozz::memory::default_allocator()->Deallocate(foreign);
+    EXPECT_EQ(cache.stats().deallocations, 0u);
+
+    int* i = ozz::New<int>(46);
+    EXPECT_EQ(*i, 46);
+    ozz::Delete(i);
+    EXPECT_EQ(cache.stats().allocations, 1u);
+    EXPECT_EQ(cache.stats().deallocations, 1u);
+    EXPECT_EQ(cache.stats().backing_allocations, 1u);
+  }
+}
@@ -0,0 +1,150 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/base/scheduler.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+// Runs a loop and checks that every index is processed once, by valid and
+// exclusive workers.
+void TestLoop(ozz::Scheduler* _scheduler, int _count, int _grain_size) {
+  const int num_workers = _scheduler ? _scheduler->num_workers() : 1;
+  std::vector<std::atomic_int> processed(_count);
+  std::vector<std::atomic_int> busy(num_workers);
+  std::atomic_int errors(0);
+  ozz::ParallelFor(_scheduler, _count, _grain_size,
+                   [&](int _begin, int _end, int _worker) {
+                     if (_worker < 0 || _worker >= num_workers ||
+                         _begin >= _end) {
+                       ++errors;
+                       return;
+                     }
+                     // Worker must not be used concurrently.
+                     if (busy[_worker]++ != 0) {
+                       ++errors;
+                     }
+                     for (int i = _begin; i < _end; ++i) {
+                       ++processed[i];
+                     }
+                     std::this_thread::yield();
+                     --busy[_worker];
+                   });
+  EXPECT_EQ(errors.load(), 0);
+  for (int i = 0; i < _count; ++i) {
+    EXPECT_EQ(processed[i].load(), 1) << "index " << i;
+  }
+}
+}  // namespace
+
+TEST(Workers, Scheduler) {
+  {
+    ozz::ThreadPoolScheduler scheduler(0);
+    EXPECT_EQ(scheduler.num_workers(), 1);
+  }
+  {
+    ozz::ThreadPoolScheduler scheduler(3);
+    EXPECT_EQ(scheduler.num_workers(), 4);
+  }
+  {
+    ozz::ThreadPoolScheduler scheduler;
+    EXPECT_GE(scheduler.num_workers(), 1);
+  }
+}
+
+TEST(ParallelFor, Scheduler) {
+  // No scheduler.
+  TestLoop(nullptr, 0, 1);
+  TestLoop(nullptr, 37, 1);
+
+  const int threads[] = {0, 1, 3, 7};
+  const int counts[] = {0, 1, 5, 64, 1001};
+  const int grains[] = {0, 1, 3, 32, 2000};
+  for (const int num_threads : threads) {
+    ozz::ThreadPoolScheduler scheduler(num_threads);
+    for (const int count : counts) {
+      for (const int grain : grains) {
+        TestLoop(&scheduler, count, grain);
+      }
+    }
+  }
+}
+
+TEST(GrainSize, Scheduler) {
+  ozz::ThreadPoolScheduler scheduler(3);
+  std::atomic_int errors(0);
+  const int kCount = 1000;
+  const int kGrain = 16;
+  ozz::ParallelFor(&scheduler, kCount, kGrain,
+                   [&](int _begin, int _end, int) {
+                     // Ranges never exceed grain size.
+                     if (_end - _begin > kGrain) {
+                       ++errors;
+                     }
+                   });
+  EXPECT_EQ(errors.load(), 0);
+}
+
+TEST(Nested, Scheduler) {
+  ozz::ThreadPoolScheduler scheduler(3);
+  std::atomic_int total(0);
+  std::atomic_int errors(0);
+  ozz::ParallelFor(&scheduler, 16, 1, [&](int _begin, int _end, int _worker) {
+    for (int i = _begin; i < _end; ++i) {
+      // Nested loops run on the same worker, in a single range.
+      ozz::ParallelFor(&scheduler, 10, 1,
+                       [&](int _nbegin, int _nend, int _nworker) {
+                         if (_nworker != _worker || _nbegin != 0 ||
+                             _nend != 10) {
+                           ++errors;
+                         }
+                         total += _nend - _nbegin;
+                       });
+    }
+  });
+  EXPECT_EQ(errors.load(), 0);
+  EXPECT_EQ(total.load(), 160);
+}
+
+TEST(Concurrent, Scheduler) {
+  ozz::ThreadPoolScheduler scheduler(2);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&scheduler]() {
+      for (int i = 0; i < 20; ++i) {
+        TestLoop(&scheduler, 257, 4);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
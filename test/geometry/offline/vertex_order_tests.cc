@@ -0,0 +1,134 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/geometry/offline/vertex_order.h"
+
+#include <algorithm>
+
+#include "gtest/gtest.h"
+#include "ozz/base/containers/vector.h"
+
+using ozz::geometry::offline::ComputeJointSetOrder;
+
+TEST(Error, ComputeJointSetOrder) {
+  const uint16_t indices[6] = {0, 1, 2, 3, 4, 5};
+  uint32_t order[3];
+
+  // Invalid influences count.
+  EXPECT_FALSE(ComputeJointSetOrder(indices, 0, order));
+  EXPECT_FALSE(ComputeJointSetOrder(indices, -1, order));
+
+  // Mismatching sizes.
+  EXPECT_FALSE(ComputeJointSetOrder(indices, 1, order));
+  EXPECT_FALSE(ComputeJointSetOrder(indices, 3, order));
+  EXPECT_FALSE(ComputeJointSetOrder({indices, 5}, 2, order));
+
+  // Valid.
+  EXPECT_TRUE(ComputeJointSetOrder(indices, 2, order));
+  EXPECT_TRUE(ComputeJointSetOrder(indices, 6, {order, 1}));
+
+  // Empty is valid.
+  EXPECT_TRUE(ComputeJointSetOrder({}, 2, {}));
+}
+
+TEST(Order, ComputeJointSetOrder) {
+  {  // 1 influence.
+    const uint16_t indices[] = {3, 1, 3, 0, 1, 3};
+    uint32_t order[6];
+    ASSERT_TRUE(ComputeJointSetOrder(indices, 1, order));
+    const uint32_t expected[] = {3, 1, 4, 0, 2, 5};
+    for (size_t i = 0; i < OZZ_ARRAY_SIZE(expected); ++i) {
+      EXPECT_EQ(order[i], expected[i]);
+    }
+  }
+
+  {  // 3 influences, joint sets are compared regardless of indices order.
+    const uint16_t indices[] = {
+        2, 1, 0,  // 0: {0,1,2}
+        4, 0, 1,  // 1: {0,1,4}
+        0, 2, 1,  // 2: {0,1,2}
+        1, 1, 1,  // 3: {1,1,1}
+        1, 0, 4,  // 4: {0,1,4}
+        0, 0, 9,  // 5: {0,0,9}
+        2, 0, 1,  // 6: {0,1,2}
+    };
+    uint32_t order[7];
+    ASSERT_TRUE(ComputeJointSetOrder(indices, 3, order));
+    const uint32_t expected[] = {5, 0, 2, 6, 1, 4, 3};
+    for (size_t i = 0; i < OZZ_ARRAY_SIZE(expected); ++i) {
+      EXPECT_EQ(order[i], expected[i]);
+    }
+  }
+}
+
+TEST(Grouping, ComputeJointSetOrder) {
+  const int vertex_count = 1000;
+  const int influences = 4;
+
+  // Generates vertices influenced by a few joint sets, interleaved.
+  ozz::vector<uint16_t> indices(vertex_count * influences);
+  for (int i = 0; i < vertex_count; ++i) {
+    const int set = (i * 7) % 13;
+    for (int j = 0; j < influences; ++j) {
+      indices[i * influences + j] =
+          static_cast<uint16_t>((set + j * (i % 3 + 1)) % 20);
+    }
+  }
+
+  ozz::vector<uint32_t> order(vertex_count);
+  ASSERT_TRUE(
+      ComputeJointSetOrder(make_span(indices), influences, make_span(order)));
+
+  // Order is a permutation.
+  ozz::vector<bool> found(vertex_count, false);
+  for (const uint32_t index : order) {
+    ASSERT_LT(index, static_cast<uint32_t>(vertex_count));
+    EXPECT_FALSE(found[index]);
+    found[index] = true;
+  }
+
+  // Each joint set is contiguous, and vertices that share a joint set keep
+  // their original order.
+  auto joint_set = [&indices](uint32_t _vertex) {
+    ozz::vector<uint16_t> set(indices.begin() + _vertex * influences,
+                              indices.begin() + (_vertex + 1) * influences);
+    std::sort(set.begin(), set.end());
+    return set;
+  };
+  int changes = 0;
+  for (int i = 1; i < vertex_count; ++i) {
+    const ozz::vector<uint16_t> previous = joint_set(order[i - 1]);
+    const ozz::vector<uint16_t> current = joint_set(order[i]);
+    EXPECT_FALSE(current < previous);
+    if (current == previous) {
+      EXPECT_LT(order[i - 1], order[i]);
+    } else {
+      ++changes;
+    }
+  }
+  EXPECT_LT(changes, 13 * 3);
+}
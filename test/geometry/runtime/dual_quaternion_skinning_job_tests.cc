@@ -0,0 +1,285 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/geometry/runtime/dual_quaternion_skinning_job.h"
+
+#include "gtest/gtest.h"
+#include "ozz/base/maths/dual_quaternion.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/geometry/runtime/skinning_job.h"
+
+using ozz::geometry::DualQuaternionSkinningJob;
+using ozz::geometry::SkinningJob;
+using ozz::math::DualQuaternion;
+
+TEST(JobValidity, DualQuaternionSkinningJob) {
+  DualQuaternion dqs[2];
+  uint16_t joint_indices[4] = {};
+  float joint_weights[2] = {};
+  float in_positions[6] = {};
+  float in_normals[6] = {};
+  float out_positions[6];
+  float out_normals[6];
+
+  DualQuaternionSkinningJob base_job;
+  base_job.vertex_count = 2;
+  base_job.influences_count = 2;
+  base_job.joint_dual_quaternions = dqs;
+  base_job.joint_indices = joint_indices;
+  base_job.joint_indices_stride = sizeof(uint16_t) * 2;
+  base_job.joint_weights = joint_weights;
+  base_job.joint_weights_stride = sizeof(float);
+  base_job.in_positions = in_positions;
+  base_job.in_positions_stride = sizeof(float) * 3;
+  base_job.out_positions = out_positions;
+  base_job.out_positions_stride = sizeof(float) * 3;
+  for (DualQuaternion& dq : dqs) {
+    dq = DualQuaternion::identity();
+  }
+
+  {  // Default is invalid.
+    DualQuaternionSkinningJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  {  // Valid job.
+    DualQuaternionSkinningJob job = base_job;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+  {  // Valid job with 0 vertex.
+    DualQuaternionSkinningJob job = base_job;
+    job.vertex_count = 0;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+  {  // Invalid job with 0 influence.
+    DualQuaternionSkinningJob job = base_job;
+    job.influences_count = 0;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  {  // Invalid job without dual quaternions.
+    DualQuaternionSkinningJob job = base_job;
+    job.joint_dual_quaternions = {};
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Invalid job with too small weights.
+    DualQuaternionSkinningJob job = base_job;
+    job.joint_weights_stride = sizeof(float) * 2;
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Valid job with 1 influence doesn't need weights.
+    DualQuaternionSkinningJob job = base_job;
+    job.influences_count = 1;
+    job.joint_weights = {};
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+  {  // Invalid job without output positions.
+    DualQuaternionSkinningJob job = base_job;
+    job.out_positions = {};
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Invalid job with normals but no output normals.
+    DualQuaternionSkinningJob job = base_job;
+    job.in_normals = in_normals;
+    job.in_normals_stride = sizeof(float) * 3;
+    EXPECT_FALSE(job.Validate());
+
+    job.out_normals = out_normals;
+    job.out_normals_stride = sizeof(float) * 3;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+  {  // Invalid job with tangents but no normals.
+    DualQuaternionSkinningJob job = base_job;
+    job.in_tangents = in_normals;
+    job.in_tangents_stride = sizeof(float) * 3;
+    EXPECT_FALSE(job.Validate());
+  }
+}
+
+TEST(ToDualQuaternions, DualQuaternionSkinningJob) {
+  const ozz::math::Float4x4 matrices[3] = {
+      ozz::math::Float4x4::identity(),
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f)) *
+          ozz::math::Float4x4::FromEuler(
+              ozz::math::simd_float4::Load(.5f, .2f, -.1f, 0.f)),
+      ozz::math::Float4x4::Scaling(ozz::math::simd_float4::zero())};
+  DualQuaternion dqs[3];
+
+  EXPECT_FALSE(ozz::geometry::ToDualQuaternions(
+      matrices, ozz::make_span(dqs).first(2)));
+  EXPECT_TRUE(ozz::geometry::ToDualQuaternions(matrices, dqs));
+
+  EXPECT_QUATERNION_EQ(dqs[0].real, 0.f, 0.f, 0.f, 1.f);
+  EXPECT_FLOAT3_EQ(ToTranslation(dqs[0]), 0.f, 0.f, 0.f);
+
+  EXPECT_FLOAT3_EQ(ToTranslation(dqs[1]), 1.f, 2.f, 3.f);
+  const ozz::math::Float3 p(.3f, -.7f, 1.1f);
+  ozz::math::Float3 transformed;
+  ozz::math::Store3PtrU(
+      ozz::math::TransformPoint(matrices[1],
+                                ozz::math::simd_float4::Load3PtrU(&p.x)),
+      &transformed.x);
+  EXPECT_FLOAT3_EQ(TransformPoint(dqs[1], p), transformed.x, transformed.y,
+                   transformed.z);
+
+  // Matrix can't be decomposed.
+  EXPECT_QUATERNION_EQ(dqs[2].real, 0.f, 0.f, 0.f, 1.f);
+  EXPECT_QUATERNION_EQ(dqs[2].dual, 0.f, 0.f, 0.f, 0.f);
+}
+
+TEST(JobResult, DualQuaternionSkinningJob) {
+  // Rigid matrices only, as dual quaternions don't support scale.
+  const ozz::math::Float4x4 matrices[4] = {
+      {{ozz::math::simd_float4::Load(-1.f, 0.f, 0.f, 0.f),
+        ozz::math::simd_float4::Load(0.f, 1.f, 0.f, 0.f),
+        ozz::math::simd_float4::Load(0.f, 0.f, -1.f, 0.f),
+        ozz::math::simd_float4::Load(0.f, 0.f, 0.f, 1.f)}},
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f)),
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(-4.f, 0.f, 2.f, 0.f)),
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(0.f, 1.f, 0.f, 0.f)) *
+          ozz::math::Float4x4::FromEuler(
+              ozz::math::simd_float4::Load(.5f, .2f, -.1f, 0.f))};
+  DualQuaternion dqs[4];
+  ASSERT_TRUE(ozz::geometry::ToDualQuaternions(matrices, dqs));
+
+  const int kVertexCount = 4;
+  const float in_positions[kVertexCount * 3] = {
+      1.f, 2.f, 3.f, -1.f, .5f, 0.f, 0.f, 0.f, 0.f, .2f, -3.f, 1.f};
+  const float in_normals[kVertexCount * 3] = {
+      1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, .6f, .8f, 0.f};
+  float out_positions[kVertexCount * 3];
+  float out_normals[kVertexCount * 3];
+  float out_tangents[kVertexCount * 3];
+  float expected_positions[kVertexCount * 3];
+  float expected_normals[kVertexCount * 3];
+
+  DualQuaternionSkinningJob job;
+  job.vertex_count = kVertexCount;
+  job.joint_dual_quaternions = dqs;
+  job.in_positions = in_positions;
+  job.in_positions_stride = sizeof(float) * 3;
+  job.in_normals = in_normals;
+  job.in_normals_stride = sizeof(float) * 3;
+  job.in_tangents = in_normals;
+  job.in_tangents_stride = sizeof(float) * 3;
+  job.out_positions = out_positions;
+  job.out_positions_stride = sizeof(float) * 3;
+  job.out_normals = out_normals;
+  job.out_normals_stride = sizeof(float) * 3;
+  job.out_tangents = out_tangents;
+  job.out_tangents_stride = sizeof(float) * 3;
+
+  SkinningJob lbs;
+  lbs.vertex_count = kVertexCount;
+  lbs.joint_matrices = matrices;
+  lbs.in_positions = in_positions;
+  lbs.in_positions_stride = sizeof(float) * 3;
+  lbs.in_normals = in_normals;
+  lbs.in_normals_stride = sizeof(float) * 3;
+  lbs.out_positions = expected_positions;
+  lbs.out_positions_stride = sizeof(float) * 3;
+  lbs.out_normals = expected_normals;
+  lbs.out_normals_stride = sizeof(float) * 3;
+
+  {  // 1 influence matches linear blend skinning of rigid matrices.
+    const uint16_t indices[kVertexCount] = {0, 1, 2, 3};
+    job.influences_count = 1;
+    job.joint_indices = indices;
+    job.joint_indices_stride = sizeof(uint16_t);
+    lbs.influences_count = 1;
+    lbs.joint_indices = indices;
+    lbs.joint_indices_stride = sizeof(uint16_t);
+    ASSERT_TRUE(job.Run());
+    ASSERT_TRUE(lbs.Run());
+    for (int i = 0; i < kVertexCount * 3; ++i) {
+      EXPECT_NEAR(out_positions[i], expected_positions[i], 1e-5f);
+      EXPECT_NEAR(out_normals[i], expected_normals[i], 1e-5f);
+      EXPECT_NEAR(out_tangents[i], expected_normals[i], 1e-5f);
+    }
+  }
+
+  {  // Blending translations matches linear blend skinning.
+    const uint16_t indices[kVertexCount * 3] = {1, 2, 1, 2, 1, 2,
+                                                1, 2, 2, 1, 2, 1};
+    const float weights[kVertexCount * 2] = {.2f, .3f, 1.f, 0.f,
+                                             .5f, .5f, 0.f, .1f};
+    job.influences_count = 3;
+    job.joint_indices = indices;
+    job.joint_indices_stride = sizeof(uint16_t) * 3;
+    job.joint_weights = weights;
+    job.joint_weights_stride = sizeof(float) * 2;
+    lbs.influences_count = 3;
+    lbs.joint_indices = indices;
+    lbs.joint_indices_stride = sizeof(uint16_t) * 3;
+    lbs.joint_weights = weights;
+    lbs.joint_weights_stride = sizeof(float) * 2;
+    ASSERT_TRUE(job.Run());
+    ASSERT_TRUE(lbs.Run());
+    for (int i = 0; i < kVertexCount * 3; ++i) {
+      EXPECT_NEAR(out_positions[i], expected_positions[i], 1e-5f);
+      EXPECT_NEAR(out_normals[i], expected_normals[i], 1e-5f);
+    }
+  }
+
+  {  // Antipodal dual quaternions represent the same transformation.
+    DualQuaternion antipodal[2] = {dqs[3], dqs[3]};
+    antipodal[1].real = -antipodal[1].real;
+    antipodal[1].dual = -antipodal[1].dual;
+
+    const uint16_t indices[kVertexCount * 2] = {0, 1, 1, 0, 0, 1, 1, 1};
+    const float weights[kVertexCount] = {.5f, .3f, .9f, .4f};
+    job.joint_dual_quaternions = antipodal;
+    job.influences_count = 2;
+    job.joint_indices = indices;
+    job.joint_indices_stride = sizeof(uint16_t) * 2;
+    job.joint_weights = weights;
+    job.joint_weights_stride = sizeof(float);
+    lbs.influences_count = 2;
+    lbs.joint_indices = indices;
+    lbs.joint_indices_stride = sizeof(uint16_t) * 2;
+    lbs.joint_weights = weights;
+    lbs.joint_weights_stride = sizeof(float);
+    lbs.joint_matrices = ozz::span<const ozz::math::Float4x4>(&matrices[3], 1);
+    const uint16_t lbs_indices[kVertexCount * 2] = {};
+    lbs.joint_indices = lbs_indices;
+    ASSERT_TRUE(job.Run());
+    ASSERT_TRUE(lbs.Run());
+    for (int i = 0; i < kVertexCount * 3; ++i) {
+      EXPECT_NEAR(out_positions[i], expected_positions[i], 1e-5f);
+      EXPECT_NEAR(out_normals[i], expected_normals[i], 1e-5f);
+    }
+  }
+}
@@ -0,0 +1,476 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/geometry/runtime/quantized_skinning_job.h"
+
+#include <cstddef>
+
+#include "gtest/gtest.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/geometry/runtime/skinning_job.h"
+
+using ozz::geometry::QuantizedSkinningJob;
+using ozz::geometry::SkinningJob;
+
+TEST(JobValidity, QuantizedSkinningJob) {
+  ozz::math::Float4x4 matrices[2];
+  uint16_t joint_indices[8] = {};
+  uint8_t joint_weights[6] = {};
+  uint16_t in_positions[8] = {};
+  uint16_t in_normals[6] = {};
+  float out_positions[6];
+  float out_normals[6];
+
+  QuantizedSkinningJob base_job;
+  base_job.vertex_count = 2;
+  base_job.influences_count = 2;
+  base_job.joint_matrices = matrices;
+  base_job.joint_indices = ozz::as_bytes(ozz::make_span(joint_indices));
+  base_job.joint_indices_stride = sizeof(uint16_t) * 2;
+  base_job.joint_indices_format = QuantizedSkinningJob::kIndexUInt16;
+  base_job.joint_weights = ozz::as_bytes(ozz::make_span(joint_weights));
+  base_job.joint_weights_stride = sizeof(uint8_t) * 1;
+  base_job.joint_weights_format = QuantizedSkinningJob::kWeightUNorm8;
+  base_job.in_positions = ozz::as_bytes(ozz::make_span(in_positions));
+  base_job.in_positions_stride = sizeof(uint16_t) * 4;
+  base_job.in_positions_format = QuantizedSkinningJob::kAttributeHalf;
+  base_job.out_positions = out_positions;
+  base_job.out_positions_stride = sizeof(float) * 3;
+
+  {  // Default is invalid.
+    QuantizedSkinningJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  {  // Valid job.
+    QuantizedSkinningJob job = base_job;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+  {  // Valid job with 0 vertex.
+    QuantizedSkinningJob job = base_job;
+    job.vertex_count = 0;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+  {  // Invalid job with 0 influence.
+    QuantizedSkinningJob job = base_job;
+    job.influences_count = 0;
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Invalid job with too many influences.
+    QuantizedSkinningJob job = base_job;
+    job.influences_count = QuantizedSkinningJob::kMaxInfluences + 1;
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Invalid job without positions.
+    QuantizedSkinningJob job = base_job;
+    job.in_positions = {};
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Invalid job with positions too small for float format.
+    QuantizedSkinningJob job = base_job;
+    job.in_positions_format = QuantizedSkinningJob::kAttributeFloat;
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Valid job with 8 bits indices, 4 influences.
+    QuantizedSkinningJob job = base_job;
+    job.influences_count = 4;
+    job.joint_indices_format = QuantizedSkinningJob::kIndexUInt8;
+    job.joint_indices_stride = sizeof(uint8_t) * 4;
+    job.joint_weights_stride = sizeof(uint8_t) * 3;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+  {  // Invalid job with weights too small for 16 bits format.
+    QuantizedSkinningJob job = base_job;
+    job.influences_count = 4;
+    job.joint_indices_format = QuantizedSkinningJob::kIndexUInt8;
+    job.joint_indices_stride = sizeof(uint8_t) * 4;
+    job.joint_weights_stride = sizeof(uint16_t) * 3;
+    job.joint_weights_format = QuantizedSkinningJob::kWeightUNorm16;
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Invalid job with misaligned stride.
+    QuantizedSkinningJob job = base_job;
+    job.in_positions_stride = 7;
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Invalid job with misaligned buffer.
+    QuantizedSkinningJob job = base_job;
+    job.in_positions = job.in_positions.subspan(1, job.in_positions.size() - 1);
+    job.in_positions_stride = sizeof(uint16_t) * 3;
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Invalid job with normals but no output normals.
+    QuantizedSkinningJob job = base_job;
+    job.in_normals = ozz::as_bytes(ozz::make_span(in_normals));
+    job.in_normals_stride = sizeof(uint16_t) * 3;
+    job.in_normals_format = QuantizedSkinningJob::kAttributeSNorm16;
+    EXPECT_FALSE(job.Validate());
+
+    job.out_normals = out_normals;
+    job.out_normals_stride = sizeof(float) * 3;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+  {  // Invalid job with tangents but no normals.
+    QuantizedSkinningJob job = base_job;
+    job.in_tangents = ozz::as_bytes(ozz::make_span(in_normals));
+    job.in_tangents_stride = sizeof(uint16_t) * 3;
+    EXPECT_FALSE(job.Validate());
+  }
+}
+
+namespace {
+
+// Appends _value bytes to _encoded.
+template <typename _Ty>
+void Append(const _Ty& _value, ozz::vector<ozz::byte>* _encoded) {
+  const ozz::byte* bytes = reinterpret_cast<const ozz::byte*>(&_value);
+  _encoded->insert(_encoded->end(), bytes, bytes + sizeof(_Ty));
+}
+
+// Encodes _values to _format, and outputs in _decoded the values that the job
+// is expected to decode.
+void Encode(const float* _values, size_t _count,
+            QuantizedSkinningJob::AttributeFormat _format,
+            ozz::vector<ozz::byte>* _encoded, ozz::vector<float>* _decoded) {
+  _decoded->resize(_count);
+  _encoded->clear();
+  for (size_t i = 0; i < _count; ++i) {
+    switch (_format) {
+      case QuantizedSkinningJob::kAttributeHalf: {
+        const uint16_t h = ozz::math::FloatToHalf(_values[i]);
+        (*_decoded)[i] = ozz::math::HalfToFloat(h);
+        Append(h, _encoded);
+        break;
+      }
+      case QuantizedSkinningJob::kAttributeSNorm16: {
+        const int16_t s = static_cast<int16_t>(_values[i] * 32767.f);
+        (*_decoded)[i] = s / 32767.f;
+        Append(s, _encoded);
+        break;
+      }
+      default: {
+        (*_decoded)[i] = _values[i];
+        Append(_values[i], _encoded);
+        break;
+      }
+    }
+  }
+}
+
+void Encode(const float* _weights, size_t _count,
+            QuantizedSkinningJob::WeightFormat _format,
+            ozz::vector<ozz::byte>* _encoded, ozz::vector<float>* _decoded) {
+  _decoded->resize(_count);
+  _encoded->clear();
+  for (size_t i = 0; i < _count; ++i) {
+    switch (_format) {
+      case QuantizedSkinningJob::kWeightUNorm8: {
+        const uint8_t u = static_cast<uint8_t>(_weights[i] * 255.f + .5f);
+        (*_decoded)[i] = u / 255.f;
+        Append(u, _encoded);
+        break;
+      }
+      case QuantizedSkinningJob::kWeightUNorm16: {
+        const uint16_t u = static_cast<uint16_t>(_weights[i] * 65535.f + .5f);
+        (*_decoded)[i] = u / 65535.f;
+        Append(u, _encoded);
+        break;
+      }
+      default: {
+        (*_decoded)[i] = _weights[i];
+        Append(_weights[i], _encoded);
+        break;
+      }
+    }
+  }
+}
+}  // namespace
+
+TEST(JobResult, QuantizedSkinningJob) {
+  const ozz::math::Float4x4 matrices[4] = {
+      {{ozz::math::simd_float4::Load(-1.f, 0.f, 0.f, 0.f),
+        ozz::math::simd_float4::Load(0.f, 1.f, 0.f, 0.f),
+        ozz::math::simd_float4::Load(0.f, 0.f, -1.f, 0.f),
+        ozz::math::simd_float4::Load(0.f, 0.f, 0.f, 1.f)}},
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f)),
+      ozz::math::Float4x4::Scaling(
+          ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f)),
+      ozz::math::Float4x4::FromEuler(
+          ozz::math::simd_float4::Load(.5f, .2f, -.1f, 0.f))};
+  // This isn't the inverse transpose of matrices array, but no mind.
+  const ozz::math::Float4x4 it_matrices[4] = {
+      ozz::math::Float4x4::identity(), matrices[3], matrices[0],
+      matrices[2]};
+
+  // Vertex count is big enough to be processed in multiple blocks.
+  const int kVertexCount = 150;
+  const int kMaxInfluences = 6;
+  float positions[kVertexCount * 3];
+  float normals[kVertexCount * 3];
+  for (int i = 0; i < kVertexCount * 3; ++i) {
+    positions[i] = ((i * 37) % 200 - 100) / 100.f;
+    normals[i] = ((i * 53) % 180 - 90) / 100.f;
+  }
+
+  uint16_t indices16[kVertexCount * kMaxInfluences];
+  uint8_t indices8[kVertexCount * kMaxInfluences];
+  for (int i = 0; i < kVertexCount * kMaxInfluences; ++i) {
+    indices16[i] = static_cast<uint16_t>((i * 7 + i / 3) % 4);
+    indices8[i] = static_cast<uint8_t>(indices16[i]);
+  }
+  float weights[kVertexCount * (kMaxInfluences - 1)];
+  for (int i = 0; i < kVertexCount * (kMaxInfluences - 1); ++i) {
+    weights[i] = .05f + .03f * (i % 5);
+  }
+
+  const QuantizedSkinningJob::AttributeFormat attribute_formats[] = {
+      QuantizedSkinningJob::kAttributeHalf,
+      QuantizedSkinningJob::kAttributeSNorm16,
+      QuantizedSkinningJob::kAttributeFloat};
+  const QuantizedSkinningJob::WeightFormat weight_formats[] = {
+      QuantizedSkinningJob::kWeightUNorm8, QuantizedSkinningJob::kWeightUNorm16,
+      QuantizedSkinningJob::kWeightFloat};
+
+  // Positions are scaled and offset, to test normalized formats.
+  const ozz::math::Float3 scale(2.f, 3.f, 4.f);
+  const ozz::math::Float3 offset(-1.f, 1.f, 5.f);
+
+  for (int influences = 1; influences <= kMaxInfluences; ++influences) {
+    for (const auto attribute_format : attribute_formats) {
+      for (const auto weight_format : weight_formats) {
+        for (int uint8_indices = 0; uint8_indices < 2; ++uint8_indices) {
+          for (int it = 0; it < 2; ++it) {
+            // Prepares inputs.
+            ozz::vector<ozz::byte> q_positions, q_normals, q_tangents,
+                q_weights;
+            ozz::vector<float> f_positions, f_normals, f_tangents, f_weights;
+            Encode(positions, kVertexCount * 3, attribute_format,
+                   &q_positions, &f_positions);
+            Encode(normals, kVertexCount * 3, attribute_format, &q_normals,
+                   &f_normals);
+            Encode(normals + 3, kVertexCount * 3 - 3, attribute_format,
+                   &q_tangents, &f_tangents);
+            Encode(weights, kVertexCount * (influences - 1), weight_format,
+                   &q_weights, &f_weights);
+            for (int i = 0; i < kVertexCount * 3; i += 3) {
+              f_positions[i + 0] = f_positions[i + 0] * scale.x + offset.x;
+              f_positions[i + 1] = f_positions[i + 1] * scale.y + offset.y;
+              f_positions[i + 2] = f_positions[i + 2] * scale.z + offset.z;
+            }
+
+            // Skins reference.
+            float ref_positions[kVertexCount * 3];
+            float ref_normals[kVertexCount * 3];
+            float ref_tangents[kVertexCount * 3];
+            SkinningJob ref_job;
+            ref_job.vertex_count = kVertexCount - 1;
+            ref_job.influences_count = influences;
+            ref_job.joint_matrices = matrices;
+            if (it) {
+              ref_job.joint_inverse_transpose_matrices = it_matrices;
+            }
+            ref_job.joint_indices = indices16;
+            ref_job.joint_indices_stride = sizeof(uint16_t) * influences;
+            ref_job.joint_weights = make_span(f_weights);
+            ref_job.joint_weights_stride = sizeof(float) * (influences - 1);
+            ref_job.in_positions = make_span(f_positions);
+            ref_job.in_positions_stride = sizeof(float) * 3;
+            ref_job.in_normals = make_span(f_normals);
+            ref_job.in_normals_stride = sizeof(float) * 3;
+            ref_job.in_tangents = make_span(f_tangents);
+            ref_job.in_tangents_stride = sizeof(float) * 3;
+            ref_job.out_positions = ref_positions;
+            ref_job.out_positions_stride = sizeof(float) * 3;
+            ref_job.out_normals = ref_normals;
+            ref_job.out_normals_stride = sizeof(float) * 3;
+            ref_job.out_tangents = ref_tangents;
+            ref_job.out_tangents_stride = sizeof(float) * 3;
+            ASSERT_TRUE(ref_job.Run());
+
+            // Skins quantized.
+            const size_t attribute_size =
+                q_positions.size() / (kVertexCount * 3);
+            float out_positions[kVertexCount * 3];
+            float out_normals[kVertexCount * 3];
+            float out_tangents[kVertexCount * 3];
+            QuantizedSkinningJob job;
+            job.vertex_count = kVertexCount - 1;
+            job.influences_count = influences;
+            job.joint_matrices = matrices;
+            if (it) {
+              job.joint_inverse_transpose_matrices = it_matrices;
+            }
+            if (uint8_indices) {
+              job.joint_indices = ozz::as_bytes(ozz::make_span(indices8));
+              job.joint_indices_stride = sizeof(uint8_t) * influences;
+              job.joint_indices_format = QuantizedSkinningJob::kIndexUInt8;
+            } else {
+              job.joint_indices = ozz::as_bytes(ozz::make_span(indices16));
+              job.joint_indices_stride = sizeof(uint16_t) * influences;
+              job.joint_indices_format = QuantizedSkinningJob::kIndexUInt16;
+            }
+            job.joint_weights = make_span(q_weights);
+            job.joint_weights_stride =
+                influences > 1 ? q_weights.size() / kVertexCount : 0;
+            job.joint_weights_format = weight_format;
+            job.in_positions = make_span(q_positions);
+            job.in_positions_stride = attribute_size * 3;
+            job.in_positions_format = attribute_format;
+            job.in_positions_scale = scale;
+            job.in_positions_offset = offset;
+            job.in_normals = make_span(q_normals);
+            job.in_normals_stride = attribute_size * 3;
+            job.in_normals_format = attribute_format;
+            job.in_tangents = make_span(q_tangents);
+            job.in_tangents_stride = attribute_size * 3;
+            job.in_tangents_format = attribute_format;
+            job.out_positions = out_positions;
+            job.out_positions_stride = sizeof(float) * 3;
+            job.out_normals = out_normals;
+            job.out_normals_stride = sizeof(float) * 3;
+            job.out_tangents = out_tangents;
+            job.out_tangents_stride = sizeof(float) * 3;
+            ASSERT_TRUE(job.Run());
+
+            for (int i = 0; i < (kVertexCount - 1) * 3; ++i) {
+              EXPECT_NEAR(ref_positions[i], out_positions[i], 1e-5f);
+              EXPECT_NEAR(ref_normals[i], out_normals[i], 1e-5f);
+              EXPECT_NEAR(ref_tangents[i], out_tangents[i], 1e-5f);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(JobResultInterleaved, QuantizedSkinningJob) {
+  const ozz::math::Float4x4 matrices[3] = {
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f)),
+      ozz::math::Float4x4::Scaling(
+          ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f)),
+      ozz::math::Float4x4::FromEuler(
+          ozz::math::simd_float4::Load(.5f, .2f, -.1f, 0.f))};
+
+  // Compressed vertex, with interleaved attributes.
+  struct Vertex {
+    uint16_t position[3];
+    int16_t normal[3];
+    uint8_t indices[3];
+    uint8_t weights[2];
+    uint8_t padding;
+  };
+  const int kVertexCount = 100;
+  Vertex vertices[kVertexCount];
+  uint16_t ref_indices[kVertexCount * 3];
+  float ref_weights[kVertexCount * 2];
+  float ref_positions[kVertexCount * 3];
+  float ref_normals[kVertexCount * 3];
+  for (int i = 0; i < kVertexCount; ++i) {
+    Vertex& vertex = vertices[i];
+    for (int j = 0; j < 3; ++j) {
+      const float p = ((i * 3 + j) * 37 % 200 - 100) / 50.f;
+      vertex.position[j] = ozz::math::FloatToHalf(p);
+      ref_positions[i * 3 + j] = ozz::math::HalfToFloat(vertex.position[j]);
+      vertex.normal[j] = static_cast<int16_t>((i * 3 + j) * 1234 % 65535 -
+                                              32767);
+      ref_normals[i * 3 + j] = vertex.normal[j] / 32767.f;
+      vertex.indices[j] = static_cast<uint8_t>((i + j) % 3);
+      ref_indices[i * 3 + j] = vertex.indices[j];
+    }
+    for (int j = 0; j < 2; ++j) {
+      vertex.weights[j] = static_cast<uint8_t>((i * 2 + j) * 13 % 128);
+      ref_weights[i * 2 + j] = vertex.weights[j] / 255.f;
+    }
+    vertex.padding = 0;
+  }
+
+  float expected_positions[kVertexCount * 3];
+  float expected_normals[kVertexCount * 3];
+  SkinningJob ref_job;
+  ref_job.vertex_count = kVertexCount;
+  ref_job.influences_count = 3;
+  ref_job.joint_matrices = matrices;
+  ref_job.joint_indices = ref_indices;
+  ref_job.joint_indices_stride = sizeof(uint16_t) * 3;
+  ref_job.joint_weights = ref_weights;
+  ref_job.joint_weights_stride = sizeof(float) * 2;
+  ref_job.in_positions = ref_positions;
+  ref_job.in_positions_stride = sizeof(float) * 3;
+  ref_job.in_normals = ref_normals;
+  ref_job.in_normals_stride = sizeof(float) * 3;
+  ref_job.out_positions = expected_positions;
+  ref_job.out_positions_stride = sizeof(float) * 3;
+  ref_job.out_normals = expected_normals;
+  ref_job.out_normals_stride = sizeof(float) * 3;
+  ASSERT_TRUE(ref_job.Run());
+
+  // Outputs are interleaved too.
+  float out[kVertexCount * 6];
+  const ozz::span<const ozz::byte> data =
+      ozz::as_bytes(ozz::make_span(vertices));
+  QuantizedSkinningJob job;
+  job.vertex_count = kVertexCount;
+  job.influences_count = 3;
+  job.joint_matrices = matrices;
+  job.joint_indices =
+      data.subspan(offsetof(Vertex, indices),
+                   data.size() - offsetof(Vertex, indices));
+  job.joint_indices_stride = sizeof(Vertex);
+  job.joint_indices_format = QuantizedSkinningJob::kIndexUInt8;
+  job.joint_weights =
+      data.subspan(offsetof(Vertex, weights),
+                   data.size() - offsetof(Vertex, weights));
+  job.joint_weights_stride = sizeof(Vertex);
+  job.joint_weights_format = QuantizedSkinningJob::kWeightUNorm8;
+  job.in_positions = data;
+  job.in_positions_stride = sizeof(Vertex);
+  job.in_positions_format = QuantizedSkinningJob::kAttributeHalf;
+  job.in_normals = data.subspan(offsetof(Vertex, normal),
+                                data.size() - offsetof(Vertex, normal));
+  job.in_normals_stride = sizeof(Vertex);
+  job.in_normals_format = QuantizedSkinningJob::kAttributeSNorm16;
+  job.out_positions = out;
+  job.out_positions_stride = sizeof(float) * 6;
+  job.out_normals = ozz::make_span(out).subspan(3, kVertexCount * 6 - 3);
+  job.out_normals_stride = sizeof(float) * 6;
+  ASSERT_TRUE(job.Run());
+
+  for (int i = 0; i < kVertexCount; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_NEAR(expected_positions[i * 3 + j], out[i * 6 + j], 1e-5f);
+      EXPECT_NEAR(expected_normals[i * 3 + j], out[i * 6 + 3 + j], 1e-5f);
+    }
+  }
+}
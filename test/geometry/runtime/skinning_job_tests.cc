@@ -25,11 +25,14 @@
 //                                                                            //
 //----------------------------------------------------------------------------//
 
+#include <algorithm>
+
 #include "gtest/gtest.h"
 #include "ozz/base/containers/vector.h"
 #include "ozz/base/log.h"
 #include "ozz/base/maths/gtest_math_helper.h"
 #include "ozz/base/maths/simd_math.h"
+#include "ozz/base/scheduler.h"
 #include "ozz/geometry/runtime/skinning_job.h"
 
 using ozz::geometry::SkinningJob;
@@ -77,6 +80,20 @@ TEST(JobValidity, SkinningJob) {
     job.out_positions_stride = sizeof(float) * 3;
     EXPECT_FALSE(job.Validate());
   }
+  {  // Invalid job with 0 grain size
+    SkinningJob job;
+    job.vertex_count = 0;
+    job.influences_count = 1;
+    job.joint_matrices = matrices;
+    job.joint_indices = {joint_indices, 1};
+    job.joint_indices_stride = sizeof(uint16_t) * 1;
+    job.in_positions = in_positions;
+    job.in_positions_stride = sizeof(float) * 3;
+    job.out_positions = out_positions;
+    job.out_positions_stride = sizeof(float) * 3;
+    job.grain_size = 0;
+    EXPECT_FALSE(job.Validate());
+  }
   {  // Valid job with 1 influence
     SkinningJob job;
     job.vertex_count = 2;
@@ -1087,6 +1104,83 @@ TEST(JobResult, SkinningJob) {
   }
 }
 
+TEST(JobResultScheduler, SkinningJob) {
+  const int vertex_count = 1001;
+  const int joint_count = 7;
+  const int max_influences = 5;
+
+  ozz::vector<ozz::math::Float4x4> matrices(joint_count);
+  for (int i = 0; i < joint_count; ++i) {
+    const float f = static_cast<float>(i);
+    matrices[i] =
+        ozz::math::Float4x4::Translation(
+            ozz::math::simd_float4::Load(f, -f, 2.f * f, 1.f)) *
+        ozz::math::Float4x4::FromAxisAngle(
+            ozz::math::simd_float4::y_axis(),
+            ozz::math::simd_float4::Load1(f * .3f));
+  }
+
+  // Packs vertices as struct-of-arrays.
+  ozz::vector<uint16_t> indices(vertex_count * max_influences);
+  for (size_t i = 0; i < indices.size(); ++i) {
+    indices[i] = static_cast<uint16_t>((i * 3 + i / 7) % joint_count);
+  }
+  ozz::vector<float> weights(vertex_count * (max_influences - 1));
+  for (size_t i = 0; i < weights.size(); ++i) {
+    weights[i] = .05f * (i % 4);
+  }
+  ozz::vector<float> in_vertices(vertex_count * 3);
+  for (size_t i = 0; i < in_vertices.size(); ++i) {
+    in_vertices[i] = static_cast<float>(i % 11) - 5.f;
+  }
+  ozz::vector<float> expected(vertex_count * 3 * 3);
+  ozz::vector<float> out(vertex_count * 3 * 3);
+
+  ozz::ThreadPoolScheduler scheduler(3);
+
+  for (int influences = 1; influences <= max_influences; ++influences) {
+    SkinningJob job;
+    job.vertex_count = vertex_count;
+    job.influences_count = influences;
+    job.joint_matrices = make_span(matrices);
+    job.joint_inverse_transpose_matrices = make_span(matrices);
+    job.joint_indices = make_span(indices);
+    job.joint_indices_stride = sizeof(uint16_t) * influences;
+    job.joint_weights = make_span(weights);
+    job.joint_weights_stride = sizeof(float) * (influences - 1);
+    job.in_positions = make_span(in_vertices);
+    job.in_positions_stride = sizeof(float) * 3;
+    job.in_normals = make_span(in_vertices);
+    job.in_normals_stride = sizeof(float) * 3;
+    job.in_tangents = make_span(in_vertices);
+    job.in_tangents_stride = sizeof(float) * 3;
+
+    // Positions, normals and tangents are interleaved in output.
+    job.out_positions = {expected.data(), expected.size()};
+    job.out_positions_stride = sizeof(float) * 9;
+    job.out_normals = {expected.data() + 3, expected.size() - 3};
+    job.out_normals_stride = sizeof(float) * 9;
+    job.out_tangents = {expected.data() + 6, expected.size() - 6};
+    job.out_tangents_stride = sizeof(float) * 9;
+    ASSERT_TRUE(job.Run());
+
+    job.out_positions = {out.data(), out.size()};
+    job.out_normals = {out.data() + 3, out.size() - 3};
+    job.out_tangents = {out.data() + 6, out.size() - 6};
+    job.scheduler = &scheduler;
+
+    const int grain_sizes[] = {1, 64, 100, vertex_count, 2 * vertex_count};
+    for (const int grain_size : grain_sizes) {
+      std::fill(out.begin(), out.end(), 0.f);
+      job.grain_size = grain_size;
+      ASSERT_TRUE(job.Run());
+      for (size_t i = 0; i < out.size(); ++i) {
+        ASSERT_FLOAT_EQ(out[i], expected[i]);
+      }
+    }
+  }
+}
+
 struct BenchVertexIn {
   float pos[3];
   float normals[3];